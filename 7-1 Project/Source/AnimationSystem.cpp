@@ -0,0 +1,378 @@
+///////////////////////////////////////////////////////////////////////////////
+// animationsystem.cpp
+// ============
+// animate entity transforms, colors, materials and lights with keyframe tracks
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "AnimationSystem.h"
+#include "SimdSupport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+// declaration of global variables and defines
+namespace
+{
+	// get the time in milliseconds, for timing the updates
+	double GetMilliseconds()
+	{
+		return(std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+}
+
+/***********************************************************
+ *  AnimationSystem()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+AnimationSystem::AnimationSystem()
+{
+	m_stats.tracks = 0;
+	m_stats.keys = 0;
+	m_stats.targets = 0;
+	m_stats.searchedTracks = 0;
+	m_stats.changedTargets = 0;
+	m_stats.changedLights = 0;
+	m_stats.changedMaterials = 0;
+	m_stats.milliseconds = 0.0;
+}
+
+/***********************************************************
+ *  AddEntityTarget()
+ *
+ *  This method is used for adding an entity that tracks can
+ *  animate.  The passed in transform and color are kept for
+ *  the channels that no track animates, since an entity's
+ *  transform is always set as a whole.
+ ***********************************************************/
+int AnimationSystem::AddEntityTarget(
+	SceneEntities::ENTITY_ID entity,
+	const glm::vec3& position,
+	const glm::vec3& rotation,
+	const glm::vec3& scale,
+	const glm::vec4& color)
+{
+	ENTITY_TARGET target;
+	target.entity = entity;
+	target.position = position;
+	target.rotation = rotation;
+	target.scale = scale;
+	target.color = color;
+	target.bTransformChanged = false;
+	target.bColorChanged = false;
+	m_targets.push_back(target);
+
+	m_stats.targets++;
+	return((int)m_targets.size() - 1);
+}
+
+/***********************************************************
+ *  AddTrack()
+ *
+ *  This method is used for adding a track of keys, which must
+ *  be ordered by time.  A track of one key holds its value,
+ *  so the key is stored twice to give every track a pair of
+ *  keys to blend between.
+ ***********************************************************/
+bool AnimationSystem::AddTrack(TRACK_CHANNEL channel, int target, const std::vector<ANIMATION_KEY>& keys, bool bLoop)
+{
+	bool bEntity = (channel < CHANNEL_LIGHT_POSITION);
+	if ((keys.empty() == true) || (target < 0) ||
+		((bEntity == true) && (target >= (int)m_targets.size())))
+	{
+		return(false);
+	}
+	for (size_t i = 1; i < keys.size(); i++)
+	{
+		if (keys[i].time < keys[i - 1].time)
+		{
+			return(false);
+		}
+	}
+
+	ANIMATION_TRACK track;
+	track.channel = channel;
+	track.target = target;
+	track.firstKey = (int)m_keyTimes.size();
+	track.keyCount = std::max((int)keys.size(), 2);
+	track.bLoop = bLoop;
+	track.cursor = 0;
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		m_keyTimes.push_back(keys[i].time);
+		m_keyValues.push_back(keys[i].value);
+	}
+	if (keys.size() == 1)
+	{
+		m_keyTimes.push_back(keys[0].time);
+		m_keyValues.push_back(keys[0].value);
+	}
+	m_tracks.push_back(track);
+
+	// no value has been written yet, so the first update
+	// writes every track
+	m_trackKeys.push_back(track.firstKey);
+	m_trackBlends.push_back(0.0f);
+	m_trackValues.push_back(glm::vec4(std::numeric_limits<float>::quiet_NaN()));
+
+	m_stats.tracks++;
+	m_stats.keys += track.keyCount;
+	return(true);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing every track and target.
+ ***********************************************************/
+void AnimationSystem::Clear()
+{
+	m_targets.clear();
+	m_tracks.clear();
+	m_keyTimes.clear();
+	m_keyValues.clear();
+	m_trackKeys.clear();
+	m_trackBlends.clear();
+	m_trackValues.clear();
+
+	m_stats.tracks = 0;
+	m_stats.keys = 0;
+	m_stats.targets = 0;
+}
+
+/***********************************************************
+ *  GetTrackCount()
+ *
+ *  This method is used for getting the number of tracks.
+ ***********************************************************/
+int AnimationSystem::GetTrackCount() const
+{
+	return((int)m_tracks.size());
+}
+
+/***********************************************************
+ *  FindKey()
+ *
+ *  This method is used for finding the first key of the pair
+ *  around a time.  The pair found by the last update, and
+ *  the pair after it, are tried before the times are
+ *  searched, so playing forward seldom searches at all.
+ *  Times before the first key or after the last one use the
+ *  first or last pair.
+ ***********************************************************/
+int AnimationSystem::FindKey(ANIMATION_TRACK& track, float time)
+{
+	const float* times = &m_keyTimes[track.firstKey];
+	int lastPair = track.keyCount - 2;
+	int cursor = track.cursor;
+
+	if (((times[cursor] <= time) || (cursor == 0)) &&
+		((cursor == lastPair) || (time < times[cursor + 1])))
+	{
+		return(cursor);
+	}
+	if ((cursor < lastPair) && (times[cursor + 1] <= time) &&
+		((cursor + 1 == lastPair) || (time < times[cursor + 2])))
+	{
+		track.cursor = cursor + 1;
+		return(track.cursor);
+	}
+
+	m_stats.searchedTracks++;
+	int key = (int)(std::upper_bound(times, times + track.keyCount, time) - times) - 1;
+	track.cursor = std::min(std::max(key, 0), lastPair);
+	return(track.cursor);
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for sampling every track at a time in
+ *  seconds.  The keys around the time are found for all
+ *  tracks first, and then every track is blended between its
+ *  keys.  A track whose value did not change since the last
+ *  update is skipped, and each entity with a changed track
+ *  has its transform or color set once, which marks only its
+ *  chunk for the transform system.  Materials are written in
+ *  place, since every draw reads its material each frame.
+ ***********************************************************/
+bool AnimationSystem::Update(
+	float time,
+	SceneEntities* pEntities,
+	std::vector<SceneManager::LIGHT_SOURCE>& lights,
+	std::vector<SceneManager::OBJECT_MATERIAL>& materials)
+{
+	double start = GetMilliseconds();
+	m_stats.searchedTracks = 0;
+	m_stats.changedTargets = 0;
+	m_stats.changedLights = 0;
+	m_stats.changedMaterials = 0;
+
+	int trackCount = (int)m_tracks.size();
+	for (int i = 0; i < trackCount; i++)
+	{
+		ANIMATION_TRACK& track = m_tracks[i];
+		float first = m_keyTimes[track.firstKey];
+		float last = m_keyTimes[track.firstKey + track.keyCount - 1];
+		float trackTime = time;
+		if ((track.bLoop == true) && (last > first))
+		{
+			trackTime = first + std::fmod(time - first, last - first);
+			if (trackTime < first)
+			{
+				trackTime += last - first;
+			}
+		}
+
+		int key = track.firstKey + FindKey(track, trackTime);
+		float span = m_keyTimes[key + 1] - m_keyTimes[key];
+		float blend = (span > 0.0f) ? (trackTime - m_keyTimes[key]) / span : 0.0f;
+		m_trackKeys[i] = key;
+		m_trackBlends[i] = std::min(std::max(blend, 0.0f), 1.0f);
+	}
+
+	std::vector<int> changedTargets;
+	bool bLightsChanged = false;
+	for (int i = 0; i < trackCount; i++)
+	{
+		const float* pKeys = &m_keyValues[m_trackKeys[i]][0];
+		float* pValue = &m_trackValues[i][0];
+#ifdef SCENE_SIMD_SSE2
+		__m128 from = _mm_loadu_ps(pKeys);
+		__m128 to = _mm_loadu_ps(pKeys + 4);
+		__m128 value = _mm_add_ps(from, _mm_mul_ps(_mm_sub_ps(to, from), _mm_set1_ps(m_trackBlends[i])));
+		if (_mm_movemask_ps(_mm_cmpneq_ps(value, _mm_loadu_ps(pValue))) == 0)
+		{
+			continue;
+		}
+		_mm_storeu_ps(pValue, value);
+#else
+		bool bChanged = false;
+		for (int part = 0; part < 4; part++)
+		{
+			float value = pKeys[part] + (pKeys[part + 4] - pKeys[part]) * m_trackBlends[i];
+			bChanged = bChanged || !(value == pValue[part]);
+			pValue[part] = value;
+		}
+		if (bChanged == false)
+		{
+			continue;
+		}
+#endif
+
+		const ANIMATION_TRACK& track = m_tracks[i];
+		const glm::vec4& trackValue = m_trackValues[i];
+		if (track.channel >= CHANNEL_MATERIAL_AMBIENT)
+		{
+			if (track.target >= (int)materials.size())
+			{
+				continue;
+			}
+			SceneManager::OBJECT_MATERIAL& material = materials[track.target];
+			if (track.channel == CHANNEL_MATERIAL_AMBIENT)
+			{
+				material.ambientColor = glm::vec3(trackValue);
+				material.ambientStrength = trackValue.w;
+			}
+			else if (track.channel == CHANNEL_MATERIAL_DIFFUSE)
+			{
+				material.diffuseColor = glm::vec3(trackValue);
+			}
+			else
+			{
+				material.specularColor = glm::vec3(trackValue);
+				material.shininess = trackValue.w;
+			}
+			m_stats.changedMaterials++;
+			continue;
+		}
+		if (track.channel >= CHANNEL_LIGHT_POSITION)
+		{
+			if (track.target >= (int)lights.size())
+			{
+				continue;
+			}
+			SceneManager::LIGHT_SOURCE& light = lights[track.target];
+			if (track.channel == CHANNEL_LIGHT_POSITION)
+			{
+				light.position = glm::vec3(trackValue);
+			}
+			else if (track.channel == CHANNEL_LIGHT_DIFFUSE)
+			{
+				light.diffuseColor = glm::vec3(trackValue);
+			}
+			else
+			{
+				light.focalStrength = trackValue.x;
+				light.specularIntensity = trackValue.y;
+			}
+			bLightsChanged = true;
+			m_stats.changedLights++;
+			continue;
+		}
+
+		ENTITY_TARGET& target = m_targets[track.target];
+		if ((target.bTransformChanged == false) && (target.bColorChanged == false))
+		{
+			changedTargets.push_back(track.target);
+		}
+		switch (track.channel)
+		{
+		case CHANNEL_POSITION:
+			target.position = glm::vec3(trackValue);
+			target.bTransformChanged = true;
+			break;
+		case CHANNEL_ROTATION:
+			target.rotation = glm::vec3(trackValue);
+			target.bTransformChanged = true;
+			break;
+		case CHANNEL_SCALE:
+			target.scale = glm::vec3(trackValue);
+			target.bTransformChanged = true;
+			break;
+		default:
+			target.color = trackValue;
+			target.bColorChanged = true;
+			break;
+		}
+	}
+
+	for (size_t i = 0; i < changedTargets.size(); i++)
+	{
+		ENTITY_TARGET& target = m_targets[changedTargets[i]];
+		if (NULL != pEntities)
+		{
+			if (target.bTransformChanged == true)
+			{
+				pEntities->SetTransform(target.entity, target.position, target.rotation, target.scale);
+			}
+			if (target.bColorChanged == true)
+			{
+				pEntities->SetColor(target.entity, target.color);
+			}
+		}
+		target.bTransformChanged = false;
+		target.bColorChanged = false;
+	}
+
+	m_stats.changedTargets = (int)changedTargets.size();
+	m_stats.milliseconds = GetMilliseconds() - start;
+	return(bLightsChanged);
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the work of the last
+ *  update.
+ ***********************************************************/
+const AnimationSystem::ANIMATION_STATS& AnimationSystem::GetStats() const
+{
+	return(m_stats);
+}
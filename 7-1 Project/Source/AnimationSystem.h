@@ -0,0 +1,156 @@
+///////////////////////////////////////////////////////////////////////////////
+// animationsystem.h
+// ============
+// animate entity transforms, colors, materials and lights with keyframe tracks
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneEntities.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  AnimationSystem
+ *
+ *  This class moves the scene with keyframe tracks.  Each
+ *  track animates one channel of an entity, such as its
+ *  position, rotation or color, one channel of a light source
+ *  or one color of an object material, from keys that are
+ *  interpolated linearly.  The key
+ *  times of all tracks are kept apart from their values, so
+ *  finding the keys around a time only walks the times, and
+ *  each track remembers the keys it used last, so a time that
+ *  moves forward a little finds them again without a search.
+ *  The values of all tracks are interpolated together, four
+ *  channels at a time with SSE2, and only the entities whose
+ *  tracks changed are written back, so their chunks alone
+ *  have their world matrices recomputed.
+ ***********************************************************/
+class AnimationSystem
+{
+public:
+	// constructor
+	AnimationSystem();
+
+	// the values a track can animate, where the entity
+	// rotation is in degrees around the X, Y and Z axes, and
+	// the material channels keep the ambient strength and the
+	// shininess in the fourth part of the value
+	enum TRACK_CHANNEL
+	{
+		CHANNEL_POSITION,
+		CHANNEL_ROTATION,
+		CHANNEL_SCALE,
+		CHANNEL_COLOR,
+		CHANNEL_LIGHT_POSITION,
+		CHANNEL_LIGHT_DIFFUSE,
+		// the focal strength and specular intensity
+		CHANNEL_LIGHT_HIGHLIGHT,
+		CHANNEL_MATERIAL_AMBIENT,
+		CHANNEL_MATERIAL_DIFFUSE,
+		CHANNEL_MATERIAL_SPECULAR
+	};
+
+	// properties for one key of a track, where unused parts of
+	// the value are ignored
+	struct ANIMATION_KEY
+	{
+		float time;
+		glm::vec4 value;
+	};
+
+	// properties for the work of the last update
+	struct ANIMATION_STATS
+	{
+		int tracks;
+		int keys;
+		int targets;
+		// tracks whose keys had to be searched for
+		int searchedTracks;
+		int changedTargets;
+		int changedLights;
+		int changedMaterials;
+		double milliseconds;
+	};
+
+private:
+	// properties for an animated entity and the transform and
+	// color its tracks leave unchanged
+	struct ENTITY_TARGET
+	{
+		SceneEntities::ENTITY_ID entity;
+		glm::vec3 position;
+		glm::vec3 rotation;
+		glm::vec3 scale;
+		glm::vec4 color;
+		bool bTransformChanged;
+		bool bColorChanged;
+	};
+
+	// properties for a track, whose keys are kept together in
+	// the shared key columns
+	struct ANIMATION_TRACK
+	{
+		TRACK_CHANNEL channel;
+		// entity target, light source or material the track
+		// animates
+		int target;
+		int firstKey;
+		int keyCount;
+		// repeat the keys instead of holding the last one
+		bool bLoop;
+		// first key of the pair used by the last update
+		int cursor;
+	};
+
+	std::vector<ENTITY_TARGET> m_targets;
+	std::vector<ANIMATION_TRACK> m_tracks;
+	// key times and values of every track
+	std::vector<float> m_keyTimes;
+	std::vector<glm::vec4> m_keyValues;
+	// key pair and blend of each track for the current time
+	std::vector<int> m_trackKeys;
+	std::vector<float> m_trackBlends;
+	// value of each track written by the last update
+	std::vector<glm::vec4> m_trackValues;
+	ANIMATION_STATS m_stats;
+
+	// find the first key of the pair around a time, starting
+	// from the pair found last
+	int FindKey(ANIMATION_TRACK& track, float time);
+
+public:
+	// add an entity that tracks can animate, with its current
+	// transform and color, returning its target index
+	int AddEntityTarget(
+		SceneEntities::ENTITY_ID entity,
+		const glm::vec3& position,
+		const glm::vec3& rotation,
+		const glm::vec3& scale,
+		const glm::vec4& color);
+	// add a track of keys ordered by time, for an entity target
+	// or the index of a light source or material, returning
+	// whether it was added
+	bool AddTrack(TRACK_CHANNEL channel, int target, const std::vector<ANIMATION_KEY>& keys, bool bLoop);
+	// remove every track and target
+	void Clear();
+	// get the number of tracks
+	int GetTrackCount() const;
+
+	// sample every track at a time in seconds and write the
+	// changed values into the entities, lights and materials,
+	// returning whether the lights changed
+	bool Update(
+		float time,
+		SceneEntities* pEntities,
+		std::vector<SceneManager::LIGHT_SOURCE>& lights,
+		std::vector<SceneManager::OBJECT_MATERIAL>& materials);
+	// get the work of the last update
+	const ANIMATION_STATS& GetStats() const;
+};
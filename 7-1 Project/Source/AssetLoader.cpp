@@ -0,0 +1,562 @@
+///////////////////////////////////////////////////////////////////////////////
+// assetloader.cpp
+// ============
+// batch the reading of asset files from disk into memory
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "AssetLoader.h"
+
+#include <atomic>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+#if defined(__linux__) && defined(USE_IO_URING)
+#include <liburing.h>
+#endif
+
+// declaration of global variables and defines
+namespace
+{
+	// every file slice in the arena starts on this boundary
+	const size_t g_ArenaAlignment = 4096;
+	// number of reads kept in flight in the io_uring queue
+	const unsigned int g_QueueDepth = 64;
+
+	size_t AlignSize(size_t value)
+	{
+		return (value + g_ArenaAlignment - 1) & ~(g_ArenaAlignment - 1);
+	}
+}
+
+/***********************************************************
+ *  AssetLoader()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+AssetLoader::AssetLoader()
+{
+	m_pArena = NULL;
+	m_arenaSize = 0;
+
+	// default to one reader per hardware thread
+	m_workerThreads = (int)std::thread::hardware_concurrency();
+	if (m_workerThreads <= 0)
+	{
+		m_workerThreads = 4;
+	}
+	m_bMemoryMapped = false;
+}
+
+/***********************************************************
+ *  ~AssetLoader()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+AssetLoader::~AssetLoader()
+{
+	ReleaseAssets();
+}
+
+/***********************************************************
+ *  QueueRead()
+ *
+ *  This method is used for adding a file to the next batch
+ *  of reads.  Nothing is read until SubmitReads() is called.
+ ***********************************************************/
+void AssetLoader::QueueRead(const char* filename, std::string tag)
+{
+	ASSET_FILE asset;
+	asset.filename = filename;
+	asset.tag = tag;
+	asset.data = NULL;
+	asset.size = 0;
+	asset.offset = 0;
+	asset.bLoaded = false;
+	asset.bMapped = false;
+
+	m_assetFiles.push_back(asset);
+}
+
+/***********************************************************
+ *  AllocateArena()
+ *
+ *  This method is used for getting the size of every queued
+ *  file and allocating one block of memory that holds all of
+ *  them, so the reads can land directly in their final place.
+ ***********************************************************/
+bool AssetLoader::AllocateArena()
+{
+	size_t arenaSize = 0;
+
+	for (size_t i = 0; i < m_assetFiles.size(); i++)
+	{
+		struct stat fileInfo;
+		if (stat(m_assetFiles[i].filename.c_str(), &fileInfo) != 0)
+		{
+			std::cout << "Could not open asset file:" << m_assetFiles[i].filename << std::endl;
+			m_assetFiles[i].size = 0;
+			continue;
+		}
+
+		m_assetFiles[i].size = (size_t)fileInfo.st_size;
+		m_assetFiles[i].offset = arenaSize;
+		arenaSize += AlignSize(m_assetFiles[i].size);
+	}
+
+	if (arenaSize == 0)
+	{
+		return(false);
+	}
+
+	m_pArena = new unsigned char[arenaSize + g_ArenaAlignment];
+	m_arenaSize = arenaSize;
+
+	// hand out the aligned slices of the arena to the files
+	unsigned char* pAligned = (unsigned char*)AlignSize((size_t)m_pArena);
+	for (size_t i = 0; i < m_assetFiles.size(); i++)
+	{
+		if (m_assetFiles[i].size > 0)
+		{
+			m_assetFiles[i].data = pAligned + m_assetFiles[i].offset;
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  ReadWholeFile()
+ *
+ *  This method is used for reading one file completely into
+ *  the memory slice that was reserved for it.
+ ***********************************************************/
+bool AssetLoader::ReadWholeFile(ASSET_FILE& asset)
+{
+	if ((asset.data == NULL) || (asset.size == 0))
+	{
+		return(false);
+	}
+
+#ifndef _WIN32
+	int fileDescriptor = open(asset.filename.c_str(), O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		return(false);
+	}
+
+	// positional reads do not share a file offset, so short
+	// reads are simply continued from where they stopped
+	size_t bytesRead = 0;
+	while (bytesRead < asset.size)
+	{
+		ssize_t result = pread(
+			fileDescriptor,
+			asset.data + bytesRead,
+			asset.size - bytesRead,
+			(off_t)bytesRead);
+		if (result <= 0)
+		{
+			break;
+		}
+		bytesRead += (size_t)result;
+	}
+	close(fileDescriptor);
+
+	asset.bLoaded = (bytesRead == asset.size);
+#else
+	std::ifstream file(asset.filename.c_str(), std::ios::in | std::ios::binary);
+	if (!file)
+	{
+		return(false);
+	}
+
+	file.read((char*)asset.data, (std::streamsize)asset.size);
+	asset.bLoaded = ((size_t)file.gcount() == asset.size);
+#endif
+
+	return(asset.bLoaded);
+}
+
+/***********************************************************
+ *  MapWholeFile()
+ *
+ *  This method is used for mapping one file into memory as a
+ *  read-only view.  Nothing is copied, and the pages are only
+ *  read from disk when they are first touched, so processes
+ *  mapping the same file share a single copy of it.
+ ***********************************************************/
+bool AssetLoader::MapWholeFile(ASSET_FILE& asset)
+{
+	struct stat fileInfo;
+	if ((stat(asset.filename.c_str(), &fileInfo) != 0) || (fileInfo.st_size <= 0))
+	{
+		std::cout << "Could not open asset file:" << asset.filename << std::endl;
+		return(false);
+	}
+	asset.size = (size_t)fileInfo.st_size;
+
+#ifndef _WIN32
+	int fileDescriptor = open(asset.filename.c_str(), O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		return(false);
+	}
+
+	// the mapping stays valid after the descriptor is closed
+	void* pView = mmap(NULL, asset.size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+	close(fileDescriptor);
+	if (MAP_FAILED == pView)
+	{
+		return(false);
+	}
+#else
+	HANDLE file = CreateFileA(
+		asset.filename.c_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		NULL,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		NULL);
+	if (INVALID_HANDLE_VALUE == file)
+	{
+		return(false);
+	}
+
+	// the view keeps the mapping alive once the handles are closed
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	void* pView = NULL;
+	if (NULL != mapping)
+	{
+		pView = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+	}
+	CloseHandle(file);
+	if (NULL == pView)
+	{
+		return(false);
+	}
+#endif
+
+	asset.data = (unsigned char*)pView;
+	asset.bMapped = true;
+	asset.bLoaded = true;
+	return(true);
+}
+
+/***********************************************************
+ *  UnmapFile()
+ *
+ *  This method is used for releasing the mapped view of a
+ *  file from MapWholeFile().
+ ***********************************************************/
+void AssetLoader::UnmapFile(ASSET_FILE& asset)
+{
+	if (asset.bMapped == false)
+	{
+		return;
+	}
+
+#ifndef _WIN32
+	munmap(asset.data, asset.size);
+#else
+	UnmapViewOfFile(asset.data);
+#endif
+	asset.data = NULL;
+	asset.bMapped = false;
+}
+
+/***********************************************************
+ *  SubmitReadsIoUring()
+ *
+ *  This method is used for reading all of the queued files
+ *  through io_uring.  The whole arena is registered once as a
+ *  fixed buffer and the reads are kept in flight up to the
+ *  queue depth, so the drive always has a batch to work on.
+ ***********************************************************/
+bool AssetLoader::SubmitReadsIoUring()
+{
+#if defined(__linux__) && defined(USE_IO_URING)
+	struct io_uring ring;
+	if (io_uring_queue_init(g_QueueDepth, &ring, 0) < 0)
+	{
+		return(false);
+	}
+
+	// registering the arena lets the kernel skip pinning the
+	// pages on every read - fall back to plain reads if the
+	// memory lock limit does not allow it
+	struct iovec arenaVector;
+	arenaVector.iov_base = (void*)AlignSize((size_t)m_pArena);
+	arenaVector.iov_len = m_arenaSize;
+	bool bFixedBuffers = (io_uring_register_buffers(&ring, &arenaVector, 1) == 0);
+
+	std::vector<int> fileDescriptors(m_assetFiles.size(), -1);
+	std::vector<size_t> bytesRead(m_assetFiles.size(), 0);
+	std::deque<size_t> pendingReads;
+
+	for (size_t i = 0; i < m_assetFiles.size(); i++)
+	{
+		if (m_assetFiles[i].size == 0)
+		{
+			continue;
+		}
+
+		fileDescriptors[i] = open(m_assetFiles[i].filename.c_str(), O_RDONLY);
+		if (fileDescriptors[i] >= 0)
+		{
+			pendingReads.push_back(i);
+		}
+	}
+
+	unsigned int inFlight = 0;
+	while ((pendingReads.empty() == false) || (inFlight > 0))
+	{
+		// fill the submission queue with the waiting reads
+		while ((pendingReads.empty() == false) && (inFlight < g_QueueDepth))
+		{
+			struct io_uring_sqe* pEntry = io_uring_get_sqe(&ring);
+			if (pEntry == NULL)
+			{
+				break;
+			}
+
+			size_t index = pendingReads.front();
+			pendingReads.pop_front();
+
+			ASSET_FILE& asset = m_assetFiles[index];
+			unsigned char* pTarget = asset.data + bytesRead[index];
+			unsigned int length = (unsigned int)(asset.size - bytesRead[index]);
+
+			if (bFixedBuffers)
+			{
+				io_uring_prep_read_fixed(pEntry, fileDescriptors[index], pTarget, length, bytesRead[index], 0);
+			}
+			else
+			{
+				io_uring_prep_read(pEntry, fileDescriptors[index], pTarget, length, bytesRead[index]);
+			}
+			io_uring_sqe_set_data(pEntry, (void*)index);
+			inFlight++;
+		}
+
+		if (io_uring_submit_and_wait(&ring, 1) < 0)
+		{
+			break;
+		}
+
+		// collect every completion that is ready
+		struct io_uring_cqe* pCompletion = NULL;
+		while (io_uring_peek_cqe(&ring, &pCompletion) == 0)
+		{
+			size_t index = (size_t)io_uring_cqe_get_data(pCompletion);
+			int result = pCompletion->res;
+			io_uring_cqe_seen(&ring, pCompletion);
+			inFlight--;
+
+			if (result <= 0)
+			{
+				std::cout << "Could not read asset file:" << m_assetFiles[index].filename << std::endl;
+				continue;
+			}
+
+			bytesRead[index] += (size_t)result;
+			if (bytesRead[index] < m_assetFiles[index].size)
+			{
+				// a short read - queue the remainder of the file
+				pendingReads.push_back(index);
+			}
+			else
+			{
+				m_assetFiles[index].bLoaded = true;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < fileDescriptors.size(); i++)
+	{
+		if (fileDescriptors[i] >= 0)
+		{
+			close(fileDescriptors[i]);
+		}
+	}
+	if (bFixedBuffers)
+	{
+		io_uring_unregister_buffers(&ring);
+	}
+	io_uring_queue_exit(&ring);
+
+	return(true);
+#else
+	return(false);
+#endif
+}
+
+/***********************************************************
+ *  SubmitReadsThreadPool()
+ *
+ *  This method is used for reading all of the queued files
+ *  with a pool of worker threads, each one taking the next
+ *  unread file until the queue is empty.
+ ***********************************************************/
+bool AssetLoader::SubmitReadsThreadPool()
+{
+	std::atomic<size_t> nextFile(0);
+	std::vector<std::thread> workers;
+
+	int workerCount = m_workerThreads;
+	if (workerCount > (int)m_assetFiles.size())
+	{
+		workerCount = (int)m_assetFiles.size();
+	}
+
+	for (int i = 0; i < workerCount; i++)
+	{
+		workers.push_back(std::thread([this, &nextFile]()
+		{
+			size_t index = nextFile.fetch_add(1);
+			while (index < m_assetFiles.size())
+			{
+				ReadWholeFile(m_assetFiles[index]);
+				index = nextFile.fetch_add(1);
+			}
+		}));
+	}
+
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  SubmitReads()
+ *
+ *  This method is used for reading every queued file into
+ *  memory as one batch.  It returns once all of the reads
+ *  have finished, and returns false if any file failed.
+ ***********************************************************/
+bool AssetLoader::SubmitReads()
+{
+	if (m_assetFiles.size() == 0)
+	{
+		return(true);
+	}
+
+	if (m_bMemoryMapped == true)
+	{
+		for (size_t i = 0; i < m_assetFiles.size(); i++)
+		{
+			MapWholeFile(m_assetFiles[i]);
+		}
+	}
+	else
+	{
+		if (AllocateArena() == false)
+		{
+			return(false);
+		}
+
+		if (SubmitReadsIoUring() == false)
+		{
+			SubmitReadsThreadPool();
+		}
+	}
+
+	bool bAllLoaded = true;
+	for (size_t i = 0; i < m_assetFiles.size(); i++)
+	{
+		if (m_assetFiles[i].bLoaded == false)
+		{
+			bAllLoaded = false;
+		}
+	}
+
+	return(bAllLoaded);
+}
+
+/***********************************************************
+ *  FindAsset()
+ *
+ *  This method is used for getting the loaded file data that
+ *  is associated with the passed in tag.
+ ***********************************************************/
+const AssetLoader::ASSET_FILE* AssetLoader::FindAsset(std::string tag) const
+{
+	for (size_t i = 0; i < m_assetFiles.size(); i++)
+	{
+		if ((m_assetFiles[i].tag.compare(tag) == 0) &&
+			(m_assetFiles[i].bLoaded == true))
+		{
+			return(&m_assetFiles[i]);
+		}
+	}
+
+	return(NULL);
+}
+
+/***********************************************************
+ *  ReleaseAssets()
+ *
+ *  This method is used for freeing the memory arena and the
+ *  mapped files, and clearing the queued files.
+ ***********************************************************/
+void AssetLoader::ReleaseAssets()
+{
+	for (size_t i = 0; i < m_assetFiles.size(); i++)
+	{
+		UnmapFile(m_assetFiles[i]);
+	}
+	if (NULL != m_pArena)
+	{
+		delete[] m_pArena;
+		m_pArena = NULL;
+	}
+	m_arenaSize = 0;
+	m_assetFiles.clear();
+}
+
+/***********************************************************
+ *  SetWorkerThreads()
+ *
+ *  This method is used for setting how many threads are used
+ *  when io_uring is not available.
+ ***********************************************************/
+void AssetLoader::SetWorkerThreads(int workerThreads)
+{
+	if (workerThreads > 0)
+	{
+		m_workerThreads = workerThreads;
+	}
+}
+
+/***********************************************************
+ *  SetMemoryMapped()
+ *
+ *  This method is used for mapping the files of the next
+ *  batches into memory read-only instead of reading them
+ *  into the arena.
+ ***********************************************************/
+void AssetLoader::SetMemoryMapped(bool bMemoryMapped)
+{
+	m_bMemoryMapped = bMemoryMapped;
+}
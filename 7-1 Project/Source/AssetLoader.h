@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////////////////////////////////
+// assetloader.h
+// ============
+// batch the reading of asset files from disk into memory
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  AssetLoader
+ *
+ *  This class collects the asset files that are needed by
+ *  the 3D scene and reads all of them in a single batch.
+ *  On Linux builds with USE_IO_URING defined, the reads are
+ *  submitted together through io_uring into one registered
+ *  buffer arena.  Everywhere else a pool of worker threads
+ *  reads the files in parallel into the same arena.  The
+ *  files can instead be mapped into memory read-only, so
+ *  that several processes loading the same assets share one
+ *  copy of them in the operating system's page cache.
+ ***********************************************************/
+class AssetLoader
+{
+public:
+	// constructor
+	AssetLoader();
+	// destructor
+	~AssetLoader();
+
+	// properties for a queued asset file
+	struct ASSET_FILE
+	{
+		std::string filename;
+		std::string tag;
+		unsigned char* data;
+		size_t size;
+		size_t offset;
+		bool bLoaded;
+		// the data is a read-only view of the mapped file
+		bool bMapped;
+	};
+
+private:
+	// queued and loaded asset files
+	std::vector<ASSET_FILE> m_assetFiles;
+	// single memory block holding the data for every file
+	unsigned char* m_pArena;
+	// size of the memory block in bytes
+	size_t m_arenaSize;
+	// number of worker threads for the fallback reader
+	int m_workerThreads;
+	// map the files into memory instead of reading them
+	bool m_bMemoryMapped;
+
+	// size the queued files and allocate the memory arena
+	bool AllocateArena();
+	// read the queued files through io_uring
+	bool SubmitReadsIoUring();
+	// read the queued files with a pool of worker threads
+	bool SubmitReadsThreadPool();
+	// read one whole file into its arena slice
+	static bool ReadWholeFile(ASSET_FILE& asset);
+	// map one whole file into memory read-only
+	static bool MapWholeFile(ASSET_FILE& asset);
+	// release the mapped view of one file
+	static void UnmapFile(ASSET_FILE& asset);
+
+public:
+	// add a file to the next batch of reads
+	void QueueRead(const char* filename, std::string tag);
+	// read every queued file and wait for the batch to finish
+	bool SubmitReads();
+	// find a loaded file by tag
+	const ASSET_FILE* FindAsset(std::string tag) const;
+	// free the loaded file data and clear the queue
+	void ReleaseAssets();
+
+	// set the number of threads used by the fallback reader
+	void SetWorkerThreads(int workerThreads);
+	// map the files read-only instead of reading them
+	void SetMemoryMapped(bool bMemoryMapped);
+};
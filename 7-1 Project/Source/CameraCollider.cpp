@@ -0,0 +1,494 @@
+///////////////////////////////////////////////////////////////////////////////
+// cameracollider.cpp
+// ============
+// keep the moving camera out of the scene geometry and inside its bounds
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "CameraCollider.h"
+#include "PrimitiveGeometry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <utility>
+
+// declaration of global variables and defines
+namespace
+{
+	// most cells a box may cover before it is tested by every
+	// move instead of being added to each of its cells
+	const int g_MaxBoxCells = 64;
+	// most times a move slides along a face before the rest of
+	// it is dropped
+	const int g_SlideIterations = 4;
+	// most pieces a long move is split into
+	const int g_MaxMovePieces = 16;
+	// gap kept between the camera and the faces it touches
+	const float g_Skin = 0.001f;
+	// margin around the scene for bounds taken from the scene
+	const float g_SceneMargin = 10.0f;
+	// offset of the grid positions packed into a cell key
+	const int g_CellOffset = 1 << 20;
+
+	// get the time in milliseconds, for timing the builds
+	double GetMilliseconds()
+	{
+		return(std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// get the grid position of the cell holding a coordinate
+	int GetCell(float value, float cellSize)
+	{
+		return((int)std::floor(value / cellSize));
+	}
+}
+
+/***********************************************************
+ *  CameraCollider()
+ *
+ *  The constructor for the class.  The mesh bounds are taken
+ *  from the same geometry the renderers draw.
+ ***********************************************************/
+CameraCollider::CameraCollider()
+{
+	PrimitiveGeometry geometry;
+	for (int mesh = 0; mesh < SceneManager::MESH_TYPE_COUNT; mesh++)
+	{
+		geometry.GetMeshBounds((SceneManager::MESH_TYPE)mesh, m_meshMinimum[mesh], m_meshMaximum[mesh]);
+	}
+
+	m_settings.radius = 0.3f;
+	m_settings.boundsMin = glm::vec3(1.0f);
+	m_settings.boundsMax = glm::vec3(-1.0f);
+	m_settings.cellSize = 2.0f;
+	m_boundsMin = glm::vec3(-1.0e30f);
+	m_boundsMax = glm::vec3(1.0e30f);
+	m_stamp = 0;
+
+	m_stats.boxes = 0;
+	m_stats.cells = 0;
+	m_stats.largeBoxes = 0;
+	m_stats.boxesTested = 0;
+	m_stats.contacts = 0;
+	m_stats.buildMilliseconds = 0.0;
+}
+
+/***********************************************************
+ *  SetSettings()
+ *
+ *  This method is used for setting the size of the camera and
+ *  the space it may move in.  Build() must be called again
+ *  for the changes to take effect.
+ ***********************************************************/
+void CameraCollider::SetSettings(const COLLIDER_SETTINGS& settings)
+{
+	m_settings = settings;
+	m_settings.radius = std::max(m_settings.radius, 0.0f);
+	// cells smaller than the camera would only make each move
+	// visit more of them
+	m_settings.cellSize = std::max(m_settings.cellSize, std::max(2.0f * m_settings.radius, 0.01f));
+}
+
+/***********************************************************
+ *  GetSettings()
+ *
+ *  This method is used for getting the size of the camera
+ *  and the space it may move in.
+ ***********************************************************/
+const CameraCollider::COLLIDER_SETTINGS& CameraCollider::GetSettings() const
+{
+	return(m_settings);
+}
+
+/***********************************************************
+ *  GetCellKey()
+ *
+ *  This method is used for packing the grid position of a
+ *  cell into the key it is found by.
+ ***********************************************************/
+uint64_t CameraCollider::GetCellKey(int x, int y, int z)
+{
+	uint64_t key = (uint64_t)(x + g_CellOffset) & 0x1FFFFF;
+	key |= ((uint64_t)(y + g_CellOffset) & 0x1FFFFF) << 21;
+	key |= ((uint64_t)(z + g_CellOffset) & 0x1FFFFF) << 42;
+	return(key);
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for building the grid from the world
+ *  boxes of the drawn meshes.  Each box is listed in every
+ *  cell it touches, by sorting the cells and boxes as pairs
+ *  so the boxes of a cell end up side by side in one list.
+ *  Boxes covering many cells, like the floor, are kept apart
+ *  and tested by every move instead.
+ ***********************************************************/
+void CameraCollider::Build(const std::vector<SceneManager::DRAW_COMMAND>& draws)
+{
+	double startTime = GetMilliseconds();
+
+	m_boxes.clear();
+	m_cells.clear();
+	m_cellBoxes.clear();
+	m_largeBoxes.clear();
+
+	glm::vec3 sceneMin(1.0e30f);
+	glm::vec3 sceneMax(-1.0e30f);
+	for (size_t i = 0; i < draws.size(); i++)
+	{
+		// the world box holds the eight transformed corners of
+		// the mesh box
+		const glm::vec3& meshMin = m_meshMinimum[draws[i].mesh];
+		const glm::vec3& meshMax = m_meshMaximum[draws[i].mesh];
+		COLLIDER_BOX box;
+		box.minimum = glm::vec3(1.0e30f);
+		box.maximum = glm::vec3(-1.0e30f);
+		for (int corner = 0; corner < 8; corner++)
+		{
+			glm::vec3 point(
+				(corner & 1) ? meshMax.x : meshMin.x,
+				(corner & 2) ? meshMax.y : meshMin.y,
+				(corner & 4) ? meshMax.z : meshMin.z);
+			glm::vec3 world = glm::vec3(draws[i].model * glm::vec4(point, 1.0f));
+			box.minimum = glm::min(box.minimum, world);
+			box.maximum = glm::max(box.maximum, world);
+		}
+		m_boxes.push_back(box);
+		sceneMin = glm::min(sceneMin, box.minimum);
+		sceneMax = glm::max(sceneMax, box.maximum);
+	}
+
+	// pair each box with the keys of the cells it touches
+	float cellSize = m_settings.cellSize;
+	std::vector<std::pair<uint64_t, int> > pairs;
+	for (int i = 0; i < (int)m_boxes.size(); i++)
+	{
+		int minX = GetCell(m_boxes[i].minimum.x, cellSize);
+		int minY = GetCell(m_boxes[i].minimum.y, cellSize);
+		int minZ = GetCell(m_boxes[i].minimum.z, cellSize);
+		int maxX = GetCell(m_boxes[i].maximum.x, cellSize);
+		int maxY = GetCell(m_boxes[i].maximum.y, cellSize);
+		int maxZ = GetCell(m_boxes[i].maximum.z, cellSize);
+		long long cellCount = (long long)(maxX - minX + 1) * (maxY - minY + 1) * (maxZ - minZ + 1);
+		if (cellCount > g_MaxBoxCells)
+		{
+			m_largeBoxes.push_back(i);
+			continue;
+		}
+		for (int z = minZ; z <= maxZ; z++)
+		{
+			for (int y = minY; y <= maxY; y++)
+			{
+				for (int x = minX; x <= maxX; x++)
+				{
+					pairs.push_back(std::make_pair(GetCellKey(x, y, z), i));
+				}
+			}
+		}
+	}
+	std::sort(pairs.begin(), pairs.end());
+
+	m_cellBoxes.resize(pairs.size());
+	m_cells.reserve(pairs.size());
+	for (size_t i = 0; i < pairs.size(); i++)
+	{
+		m_cellBoxes[i] = pairs[i].second;
+		if ((i == 0) || (pairs[i].first != pairs[i - 1].first))
+		{
+			CELL_RANGE range;
+			range.first = (int)i;
+			range.count = 0;
+			m_cells[pairs[i].first] = range;
+		}
+		m_cells[pairs[i].first].count++;
+	}
+
+	m_boxStamps.assign(m_boxes.size(), 0);
+	m_stamp = 0;
+
+	// bounds with a minimum above the maximum are taken from
+	// the scene, and an empty scene leaves the camera free
+	const glm::vec3& boundsMin = m_settings.boundsMin;
+	const glm::vec3& boundsMax = m_settings.boundsMax;
+	if ((boundsMin.x <= boundsMax.x) && (boundsMin.y <= boundsMax.y) && (boundsMin.z <= boundsMax.z))
+	{
+		m_boundsMin = boundsMin;
+		m_boundsMax = boundsMax;
+	}
+	else if (m_boxes.empty() == false)
+	{
+		m_boundsMin = sceneMin - glm::vec3(g_SceneMargin);
+		m_boundsMax = sceneMax + glm::vec3(g_SceneMargin);
+	}
+	else
+	{
+		m_boundsMin = glm::vec3(-1.0e30f);
+		m_boundsMax = glm::vec3(1.0e30f);
+	}
+
+	m_stats.boxes = (int)m_boxes.size();
+	m_stats.cells = (int)m_cells.size();
+	m_stats.largeBoxes = (int)m_largeBoxes.size();
+	m_stats.buildMilliseconds = GetMilliseconds() - startTime;
+}
+
+/***********************************************************
+ *  GatherBoxes()
+ *
+ *  This method is used for gathering the boxes of the cells
+ *  a box touches, along with the large boxes, into the list
+ *  of candidates.  Boxes listed in more than one of the cells
+ *  are only gathered once.
+ ***********************************************************/
+void CameraCollider::GatherBoxes(const glm::vec3& minimum, const glm::vec3& maximum)
+{
+	m_candidates.assign(m_largeBoxes.begin(), m_largeBoxes.end());
+	if (m_cells.empty() == true)
+	{
+		return;
+	}
+
+	// a new stamp marks the boxes already gathered, starting
+	// over before the counter wraps
+	m_stamp++;
+	if (m_stamp == 0x7FFFFFFF)
+	{
+		std::fill(m_boxStamps.begin(), m_boxStamps.end(), 0);
+		m_stamp = 1;
+	}
+
+	float cellSize = m_settings.cellSize;
+	int minX = GetCell(minimum.x, cellSize);
+	int minY = GetCell(minimum.y, cellSize);
+	int minZ = GetCell(minimum.z, cellSize);
+	int maxX = GetCell(maximum.x, cellSize);
+	int maxY = GetCell(maximum.y, cellSize);
+	int maxZ = GetCell(maximum.z, cellSize);
+	for (int z = minZ; z <= maxZ; z++)
+	{
+		for (int y = minY; y <= maxY; y++)
+		{
+			for (int x = minX; x <= maxX; x++)
+			{
+				std::unordered_map<uint64_t, CELL_RANGE>::const_iterator cell = m_cells.find(GetCellKey(x, y, z));
+				if (cell == m_cells.end())
+				{
+					continue;
+				}
+				for (int i = 0; i < cell->second.count; i++)
+				{
+					int box = m_cellBoxes[cell->second.first + i];
+					if (m_boxStamps[box] != m_stamp)
+					{
+						m_boxStamps[box] = m_stamp;
+						m_candidates.push_back(box);
+					}
+				}
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  PushOut()
+ *
+ *  This method is used for pushing a sphere out of the boxes
+ *  it starts inside, such as when the scene moved onto the
+ *  camera.  Each box grown by the radius pushes the center
+ *  out through its nearest face.
+ ***********************************************************/
+glm::vec3 CameraCollider::PushOut(const glm::vec3& position)
+{
+	float radius = m_settings.radius;
+	glm::vec3 result = position;
+	GatherBoxes(position - glm::vec3(radius), position + glm::vec3(radius));
+	m_stats.boxesTested += (int)m_candidates.size();
+	for (size_t i = 0; i < m_candidates.size(); i++)
+	{
+		const COLLIDER_BOX& box = m_boxes[m_candidates[i]];
+		glm::vec3 minimum = box.minimum - glm::vec3(radius);
+		glm::vec3 maximum = box.maximum + glm::vec3(radius);
+		if ((result.x <= minimum.x) || (result.x >= maximum.x) ||
+			(result.y <= minimum.y) || (result.y >= maximum.y) ||
+			(result.z <= minimum.z) || (result.z >= maximum.z))
+		{
+			continue;
+		}
+
+		// the face the center is closest to
+		int bestAxis = 0;
+		float bestDepth = 1.0e30f;
+		float bestSide = 1.0f;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			float below = result[axis] - minimum[axis];
+			float above = maximum[axis] - result[axis];
+			if (below < bestDepth)
+			{
+				bestAxis = axis;
+				bestDepth = below;
+				bestSide = -1.0f;
+			}
+			if (above < bestDepth)
+			{
+				bestAxis = axis;
+				bestDepth = above;
+				bestSide = 1.0f;
+			}
+		}
+		result[bestAxis] += bestSide * (bestDepth + g_Skin);
+		m_stats.contacts++;
+	}
+	return(result);
+}
+
+/***********************************************************
+ *  SweepSphere()
+ *
+ *  This method is used for sweeping a sphere along a move
+ *  against the boxes around it.  The sphere touching a box
+ *  is the same as its center entering the box grown by the
+ *  radius, which the slab method finds along with the face
+ *  it enters through.  The share of the move made before the
+ *  first touch and the normal of that face are returned.
+ ***********************************************************/
+bool CameraCollider::SweepSphere(const glm::vec3& position, const glm::vec3& move, float& time, glm::vec3& normal)
+{
+	float radius = m_settings.radius;
+	glm::vec3 end = position + move;
+	GatherBoxes(glm::min(position, end) - glm::vec3(radius), glm::max(position, end) + glm::vec3(radius));
+	m_stats.boxesTested += (int)m_candidates.size();
+
+	bool bHit = false;
+	time = 1.0f;
+	for (size_t i = 0; i < m_candidates.size(); i++)
+	{
+		const COLLIDER_BOX& box = m_boxes[m_candidates[i]];
+		glm::vec3 minimum = box.minimum - glm::vec3(radius);
+		glm::vec3 maximum = box.maximum + glm::vec3(radius);
+
+		float enter = -1.0e30f;
+		float leave = 1.0e30f;
+		int enterAxis = -1;
+		bool bMissed = false;
+		for (int axis = 0; (axis < 3) && (bMissed == false); axis++)
+		{
+			if (std::fabs(move[axis]) < 1.0e-8f)
+			{
+				// moving along the slab only touches it from
+				// inside
+				bMissed = (position[axis] <= minimum[axis]) || (position[axis] >= maximum[axis]);
+				continue;
+			}
+			float t1 = (minimum[axis] - position[axis]) / move[axis];
+			float t2 = (maximum[axis] - position[axis]) / move[axis];
+			if (t1 > t2)
+			{
+				std::swap(t1, t2);
+			}
+			if (t1 > enter)
+			{
+				enter = t1;
+				enterAxis = axis;
+			}
+			leave = std::min(leave, t2);
+			bMissed = (enter >= leave);
+		}
+
+		// starting inside a box is left to PushOut(), so only
+		// boxes entered during this move block it
+		if ((bMissed == true) || (enterAxis < 0) || (enter < 0.0f) || (enter >= time))
+		{
+			continue;
+		}
+		time = enter;
+		normal = glm::vec3(0.0f);
+		normal[enterAxis] = (move[enterAxis] > 0.0f) ? -1.0f : 1.0f;
+		bHit = true;
+	}
+	return(bHit);
+}
+
+/***********************************************************
+ *  MoveSphere()
+ *
+ *  This method is used for moving the camera from one
+ *  position towards another.  Long moves are split into
+ *  pieces no longer than a cell, so each sweep only gathers
+ *  the few cells around it.  A piece that touches a box stops
+ *  just short of it and slides what is left along the face,
+ *  and the result is held inside the bounds shrunk by the
+ *  radius.
+ ***********************************************************/
+glm::vec3 CameraCollider::MoveSphere(const glm::vec3& from, const glm::vec3& to)
+{
+	m_stats.boxesTested = 0;
+	m_stats.contacts = 0;
+
+	glm::vec3 position = PushOut(from);
+	glm::vec3 path = to - position;
+	float length = glm::length(path);
+	int pieces = std::min(std::max((int)std::ceil(length / m_settings.cellSize), 1), g_MaxMovePieces);
+	glm::vec3 pieceMove = path / (float)pieces;
+
+	for (int piece = 0; piece < pieces; piece++)
+	{
+		glm::vec3 move = pieceMove;
+		for (int iteration = 0; iteration < g_SlideIterations; iteration++)
+		{
+			if (glm::dot(move, move) < 1.0e-12f)
+			{
+				break;
+			}
+			float time = 1.0f;
+			glm::vec3 normal(0.0f);
+			if (SweepSphere(position, move, time, normal) == false)
+			{
+				position += move;
+				break;
+			}
+
+			// stop at the face and keep a small gap from it,
+			// then slide along it with what is left of the move
+			m_stats.contacts++;
+			position += move * time + normal * g_Skin;
+			glm::vec3 remaining = move * (1.0f - time);
+			move = remaining - normal * glm::dot(remaining, normal);
+		}
+	}
+
+	// hold the center inside the bounds shrunk by the radius,
+	// or in their middle when they are too small for it
+	glm::vec3 radius(m_settings.radius);
+	glm::vec3 lower = m_boundsMin + radius;
+	glm::vec3 upper = m_boundsMax - radius;
+	glm::vec3 middle = (m_boundsMin + m_boundsMax) * 0.5f;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		if (lower[axis] > upper[axis])
+		{
+			position[axis] = middle[axis];
+		}
+		else
+		{
+			position[axis] = std::min(std::max(position[axis], lower[axis]), upper[axis]);
+		}
+	}
+	return(position);
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the size of the grid and
+ *  the work of the last move.
+ ***********************************************************/
+const CameraCollider::COLLIDER_STATS& CameraCollider::GetStats() const
+{
+	return(m_stats);
+}
@@ -0,0 +1,122 @@
+///////////////////////////////////////////////////////////////////////////////
+// cameracollider.h
+// ============
+// keep the moving camera out of the scene geometry and inside its bounds
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  CameraCollider
+ *
+ *  This class moves the camera as a sphere that cannot pass
+ *  through the scene.  The world boxes of the drawn meshes
+ *  are kept in a grid of cells found by hashing, so a move
+ *  only looks at the few cells around it, however large the
+ *  scene is.  Each move sweeps the sphere against the boxes
+ *  grown by its radius, stops it where it first touches one,
+ *  and slides the rest of the move along that face, a few
+ *  times over so it can follow into a corner.  Finally the
+ *  camera is held inside the bounds of the walkthrough.
+ ***********************************************************/
+class CameraCollider
+{
+public:
+	// constructor
+	CameraCollider();
+
+	// properties for the size of the camera and the space it
+	// may move in
+	struct COLLIDER_SETTINGS
+	{
+		float radius;
+		// box the camera stays inside, where a minimum above
+		// the maximum uses the scene grown by a margin
+		glm::vec3 boundsMin;
+		glm::vec3 boundsMax;
+		// width of the cells of the grid
+		float cellSize;
+	};
+
+	// properties for the size of the grid and the work of the
+	// last move
+	struct COLLIDER_STATS
+	{
+		int boxes;
+		int cells;
+		// boxes too large for the cells, tested by every move
+		int largeBoxes;
+		int boxesTested;
+		int contacts;
+		double buildMilliseconds;
+	};
+
+private:
+	// properties for the world box of one drawn mesh
+	struct COLLIDER_BOX
+	{
+		glm::vec3 minimum;
+		glm::vec3 maximum;
+	};
+
+	// properties for the boxes of one cell, a range of the
+	// shared list of cell boxes
+	struct CELL_RANGE
+	{
+		int first;
+		int count;
+	};
+
+	COLLIDER_SETTINGS m_settings;
+	// bounds the camera stays inside, from the settings or the
+	// scene
+	glm::vec3 m_boundsMin;
+	glm::vec3 m_boundsMax;
+	std::vector<COLLIDER_BOX> m_boxes;
+	std::unordered_map<uint64_t, CELL_RANGE> m_cells;
+	std::vector<int> m_cellBoxes;
+	std::vector<int> m_largeBoxes;
+	// the move that last gathered each box, so a box in many
+	// cells is only tested once a move
+	std::vector<int> m_boxStamps;
+	int m_stamp;
+	std::vector<int> m_candidates;
+	// bounds of the basic shape meshes before their transforms
+	glm::vec3 m_meshMinimum[SceneManager::MESH_TYPE_COUNT];
+	glm::vec3 m_meshMaximum[SceneManager::MESH_TYPE_COUNT];
+	COLLIDER_STATS m_stats;
+
+	// get the key of the cell at a grid position
+	static uint64_t GetCellKey(int x, int y, int z);
+	// gather the boxes of the cells a box touches
+	void GatherBoxes(const glm::vec3& minimum, const glm::vec3& maximum);
+	// push a sphere out of the grown boxes it starts inside
+	glm::vec3 PushOut(const glm::vec3& position);
+	// sweep a sphere along a move, giving the share of the move
+	// made before it touches a box and the face it touches
+	bool SweepSphere(const glm::vec3& position, const glm::vec3& move, float& time, glm::vec3& normal);
+
+public:
+	// set the size of the camera and the space it may move in
+	void SetSettings(const COLLIDER_SETTINGS& settings);
+	// get the size of the camera and the space it may move in
+	const COLLIDER_SETTINGS& GetSettings() const;
+	// build the grid from the boxes of the drawn meshes
+	void Build(const std::vector<SceneManager::DRAW_COMMAND>& draws);
+	// move the camera from one position towards another,
+	// returning where it could go
+	glm::vec3 MoveSphere(const glm::vec3& from, const glm::vec3& to);
+	// get the size of the grid and the work of the last move
+	const COLLIDER_STATS& GetStats() const;
+};
@@ -0,0 +1,240 @@
+///////////////////////////////////////////////////////////////////////////////
+// camerapath.cpp
+// ============
+// move the camera along keyframes read from a camera path file
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "CameraPath.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// declaration of global variables and defines
+namespace
+{
+	// field of view of keys that do not give one, matching
+	// the starting zoom of the interactive camera
+	const float g_DefaultFov = 80.0f;
+	// near and far planes of the scene projection
+	const float g_NearPlane = 0.1f;
+	const float g_FarPlane = 100.0f;
+
+	// blend four points on a uniform Catmull-Rom spline
+	glm::vec3 CatmullRom(
+		const glm::vec3& p0,
+		const glm::vec3& p1,
+		const glm::vec3& p2,
+		const glm::vec3& p3,
+		float t)
+	{
+		float t2 = t * t;
+		float t3 = t2 * t;
+		return(0.5f * ((2.0f * p1) +
+			(p2 - p0) * t +
+			(2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+			(3.0f * p1 - p0 - 3.0f * p2 + p3) * t3));
+	}
+
+	bool CompareKeyFrames(const CameraPath::CAMERA_KEY& a, const CameraPath::CAMERA_KEY& b)
+	{
+		return(a.frame < b.frame);
+	}
+}
+
+/***********************************************************
+ *  CameraPath()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+CameraPath::CameraPath()
+{
+}
+
+/***********************************************************
+ *  LoadFile()
+ *
+ *  This method is used for reading the keyframes of a camera
+ *  path file.  Lines that cannot be read are reported and
+ *  skipped, and keys are sorted by their frame numbers.
+ ***********************************************************/
+bool CameraPath::LoadFile(const char* filename)
+{
+	std::ifstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not open camera path:" << filename << std::endl;
+		return(false);
+	}
+
+	m_keys.clear();
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line))
+	{
+		lineNumber++;
+		size_t start = line.find_first_not_of(" \t\r");
+		if ((start == std::string::npos) || (line[start] == '#'))
+		{
+			continue;
+		}
+
+		std::istringstream fields(line);
+		CAMERA_KEY key;
+		fields >> key.frame
+			>> key.position.x >> key.position.y >> key.position.z
+			>> key.target.x >> key.target.y >> key.target.z;
+		if (fields.fail())
+		{
+			std::cout << "Skipped camera path line " << lineNumber << " of " << filename << std::endl;
+			continue;
+		}
+		if (!(fields >> key.fov) || (key.fov <= 0.0f) || (key.fov >= 180.0f))
+		{
+			key.fov = g_DefaultFov;
+		}
+
+		m_keys.push_back(key);
+	}
+
+	std::stable_sort(m_keys.begin(), m_keys.end(), CompareKeyFrames);
+
+	if (m_keys.empty() == true)
+	{
+		std::cout << "Camera path has no keys:" << filename << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetKeyCount()
+ *
+ *  This method is used for getting the number of keyframes.
+ ***********************************************************/
+int CameraPath::GetKeyCount() const
+{
+	return((int)m_keys.size());
+}
+
+/***********************************************************
+ *  GetFirstFrame()
+ *
+ *  This method is used for getting the frame of the first
+ *  key, or 0 when there are none.
+ ***********************************************************/
+int CameraPath::GetFirstFrame() const
+{
+	return(m_keys.empty() ? 0 : m_keys.front().frame);
+}
+
+/***********************************************************
+ *  GetLastFrame()
+ *
+ *  This method is used for getting the frame of the last
+ *  key, or 0 when there are none.
+ ***********************************************************/
+int CameraPath::GetLastFrame() const
+{
+	return(m_keys.empty() ? 0 : m_keys.back().frame);
+}
+
+/***********************************************************
+ *  GetCamera()
+ *
+ *  This method is used for getting the camera position,
+ *  target and field of view for a frame.  Frames before the
+ *  first key or after the last one hold that key's camera.
+ ***********************************************************/
+void CameraPath::GetCamera(int frame, glm::vec3& position, glm::vec3& target, float& fov) const
+{
+	if (m_keys.empty() == true)
+	{
+		position = glm::vec3(0.0f, 0.0f, 5.0f);
+		target = glm::vec3(0.0f);
+		fov = g_DefaultFov;
+		return;
+	}
+
+	// find the last key at or before the frame
+	int count = (int)m_keys.size();
+	int index = 0;
+	while ((index + 1 < count) && (m_keys[index + 1].frame <= frame))
+	{
+		index++;
+	}
+
+	const CAMERA_KEY& key1 = m_keys[index];
+	if ((index + 1 >= count) || (frame <= key1.frame))
+	{
+		position = key1.position;
+		target = key1.target;
+		fov = key1.fov;
+		return;
+	}
+
+	// the keys on either side of the span shape its curve, and
+	// the end keys stand in for the missing neighbours
+	const CAMERA_KEY& key0 = m_keys[std::max(index - 1, 0)];
+	const CAMERA_KEY& key2 = m_keys[index + 1];
+	const CAMERA_KEY& key3 = m_keys[std::min(index + 2, count - 1)];
+	float t = (float)(frame - key1.frame) / (float)(key2.frame - key1.frame);
+
+	position = CatmullRom(key0.position, key1.position, key2.position, key3.position, t);
+	target = CatmullRom(key0.target, key1.target, key2.target, key3.target, t);
+	fov = key1.fov + (key2.fov - key1.fov) * t;
+}
+
+/***********************************************************
+ *  GetSceneView()
+ *
+ *  This method is used for getting the view matrix, the
+ *  perspective projection and the camera position of a frame
+ *  for an image of the passed in size.
+ ***********************************************************/
+void CameraPath::GetSceneView(
+	int frame,
+	int width,
+	int height,
+	glm::mat4& view,
+	glm::mat4& projection,
+	glm::vec3& viewPosition) const
+{
+	glm::vec3 target;
+	float fov = g_DefaultFov;
+	GetCamera(frame, viewPosition, target, fov);
+	GetCameraView(viewPosition, target, fov, width, height, view, projection);
+}
+
+/***********************************************************
+ *  GetCameraView()
+ *
+ *  This method is used for getting the view matrix and the
+ *  perspective projection of a camera at a position looking
+ *  at a target with the world up direction, using the same
+ *  near and far planes as the interactive camera.
+ ***********************************************************/
+void CameraPath::GetCameraView(
+	const glm::vec3& position,
+	const glm::vec3& target,
+	float fov,
+	int width,
+	int height,
+	glm::mat4& view,
+	glm::mat4& projection)
+{
+	view = glm::lookAt(position, target, glm::vec3(0.0f, 1.0f, 0.0f));
+	projection = glm::perspective(
+		glm::radians(fov),
+		(float)width / (float)height,
+		g_NearPlane,
+		g_FarPlane);
+}
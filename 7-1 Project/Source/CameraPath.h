@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////
+// camerapath.h
+// ============
+// move the camera along keyframes read from a camera path file
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  CameraPath
+ *
+ *  This class holds camera keyframes for rendering a scene
+ *  frame by frame, such as a turntable.  Each line of a path
+ *  file is one key:
+ *
+ *      frame  posX posY posZ  targetX targetY targetZ  fov
+ *
+ *  where the field of view in degrees may be left out, and
+ *  lines starting with # are comments.  The camera moves
+ *  through the keys on a Catmull-Rom spline, so a path of a
+ *  few keys around the scene gives a smooth orbit.
+ ***********************************************************/
+class CameraPath
+{
+public:
+	// constructor
+	CameraPath();
+
+	// properties for one camera keyframe
+	struct CAMERA_KEY
+	{
+		int frame;
+		glm::vec3 position;
+		glm::vec3 target;
+		float fov;
+	};
+
+private:
+	// keyframes ordered by frame number
+	std::vector<CAMERA_KEY> m_keys;
+
+public:
+	// read the keyframes from a camera path file
+	bool LoadFile(const char* filename);
+	// get the number of keyframes
+	int GetKeyCount() const;
+	// get the frame numbers of the first and last keys
+	int GetFirstFrame() const;
+	int GetLastFrame() const;
+
+	// get the camera for a frame between the keys
+	void GetCamera(int frame, glm::vec3& position, glm::vec3& target, float& fov) const;
+	// get the view and projection for a frame and image size
+	void GetSceneView(
+		int frame,
+		int width,
+		int height,
+		glm::mat4& view,
+		glm::mat4& projection,
+		glm::vec3& viewPosition) const;
+
+	// get the view and projection of a camera looking from a
+	// position at a target, for an image size
+	static void GetCameraView(
+		const glm::vec3& position,
+		const glm::vec3& target,
+		float fov,
+		int width,
+		int height,
+		glm::mat4& view,
+		glm::mat4& projection);
+};
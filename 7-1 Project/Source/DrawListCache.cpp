@@ -0,0 +1,239 @@
+///////////////////////////////////////////////////////////////////////////////
+// drawlistcache.cpp
+// ============
+// keep culled and sorted draw lists for fixed preset cameras
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "DrawListCache.h"
+#include "PrimitiveGeometry.h"
+
+#include <algorithm>
+#include <cmath>
+
+// declaration of global variables and defines
+namespace
+{
+	// largest difference between matrix values of one camera
+	const float g_MatchTolerance = 0.0001f;
+
+	// check whether two matrices are the same within the tolerance
+	bool IsSameMatrix(const glm::mat4& a, const glm::mat4& b)
+	{
+		for (int column = 0; column < 4; column++)
+		{
+			for (int row = 0; row < 4; row++)
+			{
+				if (std::fabs(a[column][row] - b[column][row]) > g_MatchTolerance)
+				{
+					return(false);
+				}
+			}
+		}
+		return(true);
+	}
+
+	// check whether a draw is blended over what is behind it
+	bool IsTransparent(const SceneManager::DRAW_COMMAND& draw)
+	{
+		return((draw.bUseTexture == false) && (draw.color.a < 1.0f));
+	}
+}
+
+/***********************************************************
+ *  DrawListCache()
+ *
+ *  The constructor for the class.  The mesh bounds are taken
+ *  from the same geometry the other renderers draw.
+ ***********************************************************/
+DrawListCache::DrawListCache()
+{
+	PrimitiveGeometry geometry;
+	for (int mesh = 0; mesh < SceneManager::MESH_TYPE_COUNT; mesh++)
+	{
+		geometry.GetMeshBounds((SceneManager::MESH_TYPE)mesh, m_meshMinimum[mesh], m_meshMaximum[mesh]);
+	}
+
+	m_stats.hits = 0;
+	m_stats.rebuilds = 0;
+	m_stats.culledDraws = 0;
+}
+
+/***********************************************************
+ *  RegisterView()
+ *
+ *  This method is used for registering a camera that never
+ *  moves, so its draw list can be kept between frames.  A
+ *  camera that was already registered keeps its index.
+ ***********************************************************/
+int DrawListCache::RegisterView(const glm::mat4& view, const glm::mat4& projection)
+{
+	int index = FindView(view, projection);
+	if (index >= 0)
+	{
+		return(index);
+	}
+
+	CACHED_VIEW cachedView;
+	cachedView.view = view;
+	cachedView.projection = projection;
+	cachedView.revision = -1;
+	m_views.push_back(cachedView);
+	return((int)m_views.size() - 1);
+}
+
+/***********************************************************
+ *  FindView()
+ *
+ *  This method is used for finding the registered camera
+ *  with the passed in view and projection.
+ ***********************************************************/
+int DrawListCache::FindView(const glm::mat4& view, const glm::mat4& projection) const
+{
+	for (size_t i = 0; i < m_views.size(); i++)
+	{
+		if ((IsSameMatrix(m_views[i].view, view) == true) &&
+			(IsSameMatrix(m_views[i].projection, projection) == true))
+		{
+			return((int)i);
+		}
+	}
+	return(-1);
+}
+
+/***********************************************************
+ *  GetDrawList()
+ *
+ *  This method is used for getting the kept draw list of a
+ *  camera when it was made for the current scene revision.
+ ***********************************************************/
+const std::vector<SceneManager::DRAW_COMMAND>* DrawListCache::GetDrawList(int index, int revision)
+{
+	if ((index < 0) || (index >= (int)m_views.size()) ||
+		(m_views[index].revision != revision))
+	{
+		return(NULL);
+	}
+
+	m_stats.hits++;
+	return(&m_views[index].draws);
+}
+
+/***********************************************************
+ *  StoreDrawList()
+ *
+ *  This method is used for keeping the draws of a full draw
+ *  list that a camera can see.  Opaque draws are sorted by
+ *  texture, material and mesh so the render devices skip
+ *  most state changes, while transparent draws are kept in
+ *  their order after them so they still blend correctly.
+ ***********************************************************/
+const std::vector<SceneManager::DRAW_COMMAND>& DrawListCache::StoreDrawList(
+	int index,
+	int revision,
+	const std::vector<SceneManager::DRAW_COMMAND>& draws)
+{
+	CACHED_VIEW& cachedView = m_views[index];
+	glm::mat4 viewProjection = cachedView.projection * cachedView.view;
+
+	std::vector<SceneManager::DRAW_COMMAND> transparentDraws;
+	cachedView.draws.clear();
+	for (size_t i = 0; i < draws.size(); i++)
+	{
+		if (IsVisible(draws[i], viewProjection) == false)
+		{
+			m_stats.culledDraws++;
+			continue;
+		}
+
+		// an untextured draw keeps no texture slot, so a stale
+		// slot cannot group it with the textured draws
+		SceneManager::DRAW_COMMAND draw = draws[i];
+		if (draw.bUseTexture == false)
+		{
+			draw.textureSlot = -1;
+		}
+
+		if (IsTransparent(draw) == true)
+		{
+			transparentDraws.push_back(draw);
+		}
+		else
+		{
+			cachedView.draws.push_back(draw);
+		}
+	}
+
+	std::stable_sort(cachedView.draws.begin(), cachedView.draws.end(),
+		[](const SceneManager::DRAW_COMMAND& a, const SceneManager::DRAW_COMMAND& b)
+		{
+			if (a.textureSlot != b.textureSlot)
+			{
+				return(a.textureSlot < b.textureSlot);
+			}
+			if (a.materialIndex != b.materialIndex)
+			{
+				return(a.materialIndex < b.materialIndex);
+			}
+			return(a.mesh < b.mesh);
+		});
+	cachedView.draws.insert(cachedView.draws.end(), transparentDraws.begin(), transparentDraws.end());
+
+	cachedView.revision = revision;
+	m_stats.rebuilds++;
+	return(cachedView.draws);
+}
+
+/***********************************************************
+ *  IsVisible()
+ *
+ *  This method is used for checking whether any part of the
+ *  box around a draw's mesh is inside the view volume.  The
+ *  draw is only culled when all eight corners are outside
+ *  the same clip plane, so nothing visible is ever dropped.
+ ***********************************************************/
+bool DrawListCache::IsVisible(const SceneManager::DRAW_COMMAND& draw, const glm::mat4& viewProjection) const
+{
+	glm::mat4 transform = viewProjection * draw.model;
+	const glm::vec3& minimum = m_meshMinimum[draw.mesh];
+	const glm::vec3& maximum = m_meshMaximum[draw.mesh];
+
+	// count the corners outside each of the six clip planes
+	int outside[6] = { 0, 0, 0, 0, 0, 0 };
+	for (int corner = 0; corner < 8; corner++)
+	{
+		glm::vec4 position = transform * glm::vec4(
+			((corner & 1) != 0) ? maximum.x : minimum.x,
+			((corner & 2) != 0) ? maximum.y : minimum.y,
+			((corner & 4) != 0) ? maximum.z : minimum.z,
+			1.0f);
+		outside[0] += (position.x < -position.w) ? 1 : 0;
+		outside[1] += (position.x > position.w) ? 1 : 0;
+		outside[2] += (position.y < -position.w) ? 1 : 0;
+		outside[3] += (position.y > position.w) ? 1 : 0;
+		outside[4] += (position.z < -position.w) ? 1 : 0;
+		outside[5] += (position.z > position.w) ? 1 : 0;
+	}
+
+	for (int plane = 0; plane < 6; plane++)
+	{
+		if (outside[plane] == 8)
+		{
+			return(false);
+		}
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting how often the kept draw
+ *  lists were reused and rebuilt.
+ ***********************************************************/
+const DrawListCache::CACHE_STATS& DrawListCache::GetStats() const
+{
+	return(m_stats);
+}
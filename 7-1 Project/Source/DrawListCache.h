@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////
+// drawlistcache.h
+// ============
+// keep culled and sorted draw lists for fixed preset cameras
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  DrawListCache
+ *
+ *  This class keeps a draw list for each registered camera
+ *  that never moves, such as the front, side and top views.
+ *  The list is culled against the camera's view volume and
+ *  sorted so draws sharing a texture and material follow one
+ *  another, and it is reused as long as the scene revision it
+ *  was made for is current, so switching to one of these
+ *  views skips building the draw list.  Transparent draws
+ *  keep their order and stay after the opaque ones.
+ ***********************************************************/
+class DrawListCache
+{
+public:
+	// constructor
+	DrawListCache();
+
+	// properties for how often the kept lists were used
+	struct CACHE_STATS
+	{
+		int hits;
+		int rebuilds;
+		int culledDraws;
+	};
+
+private:
+	// properties for one registered camera and its draw list
+	struct CACHED_VIEW
+	{
+		glm::mat4 view;
+		glm::mat4 projection;
+		// scene revision the list was made for, or -1 for none
+		int revision;
+		std::vector<SceneManager::DRAW_COMMAND> draws;
+	};
+
+	// corners of the box around each shape mesh
+	glm::vec3 m_meshMinimum[SceneManager::MESH_TYPE_COUNT];
+	glm::vec3 m_meshMaximum[SceneManager::MESH_TYPE_COUNT];
+	std::vector<CACHED_VIEW> m_views;
+	CACHE_STATS m_stats;
+
+	// check whether a draw can be seen through a camera
+	bool IsVisible(const SceneManager::DRAW_COMMAND& draw, const glm::mat4& viewProjection) const;
+
+public:
+	// register a camera that never moves, returning its index
+	int RegisterView(const glm::mat4& view, const glm::mat4& projection);
+	// find the registered camera matching a view, or -1
+	int FindView(const glm::mat4& view, const glm::mat4& projection) const;
+	// get the kept draw list of a camera, or NULL when it was
+	// made for another scene revision
+	const std::vector<SceneManager::DRAW_COMMAND>* GetDrawList(int index, int revision);
+	// cull and sort a full draw list and keep it for a camera
+	const std::vector<SceneManager::DRAW_COMMAND>& StoreDrawList(
+		int index,
+		int revision,
+		const std::vector<SceneManager::DRAW_COMMAND>& draws);
+	// get how often the kept lists were used
+	const CACHE_STATS& GetStats() const;
+};
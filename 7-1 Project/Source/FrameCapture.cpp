@@ -0,0 +1,488 @@
+///////////////////////////////////////////////////////////////////////////////
+// framecapture.cpp
+// ============
+// record the rendered frames without stalling the OpenGL pipeline
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameCapture.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables and defines
+namespace
+{
+	// number of pixel pack buffers when none is given, enough
+	// for the GPU to run a couple of frames ahead of the reads
+	const int g_DefaultRingSize = 3;
+	// time to wait on a fence before checking it again
+	const GLuint64 g_FenceWaitNanoseconds = 1000000;
+	// size of the work groups of the conversion shader
+	const int g_ConvertGroupSize = 8;
+
+	// compute shader that converts the frame to Y, U and V
+	// planes with the integer math of the CPU conversion.
+	// Each invocation takes a block of 8x2 pixels, so it
+	// writes whole words of every plane.
+	const char* g_ConvertShader =
+		"#version 430\n"
+		"layout(local_size_x = 8, local_size_y = 8) in;\n"
+		"layout(binding = 0) uniform sampler2D frame;\n"
+		"layout(std430, binding = 0) writeonly buffer Planes { uint data[]; };\n"
+		"ivec3 GetPixel(ivec2 size, int x, int y)\n"
+		"{\n"
+		"	return ivec3(round(texelFetch(frame, ivec2(x, size.y - 1 - y), 0).rgb * 255.0));\n"
+		"}\n"
+		"void main()\n"
+		"{\n"
+		"	ivec2 size = textureSize(frame, 0);\n"
+		"	int x0 = int(gl_GlobalInvocationID.x) * 8;\n"
+		"	int y0 = int(gl_GlobalInvocationID.y) * 2;\n"
+		"	if ((x0 >= size.x) || (y0 >= size.y)) return;\n"
+		"	for (int row = 0; row < 2; row++)\n"
+		"	{\n"
+		"		for (int word = 0; word < 2; word++)\n"
+		"		{\n"
+		"			uint luma = 0u;\n"
+		"			for (int i = 0; i < 4; i++)\n"
+		"			{\n"
+		"				ivec3 c = GetPixel(size, x0 + word * 4 + i, y0 + row);\n"
+		"				luma |= uint(((66 * c.r + 129 * c.g + 25 * c.b + 128) >> 8) + 16) << (8 * i);\n"
+		"			}\n"
+		"			data[((y0 + row) * size.x + x0) / 4 + word] = luma;\n"
+		"		}\n"
+		"	}\n"
+		"	uint u = 0u;\n"
+		"	uint v = 0u;\n"
+		"	for (int i = 0; i < 4; i++)\n"
+		"	{\n"
+		"		int x = x0 + i * 2;\n"
+		"		ivec3 c = (GetPixel(size, x, y0) + GetPixel(size, x + 1, y0) +\n"
+		"			GetPixel(size, x, y0 + 1) + GetPixel(size, x + 1, y0 + 1) + 2) >> 2;\n"
+		"		u |= uint(((-38 * c.r - 74 * c.g + 112 * c.b + 128) >> 8) + 128) << (8 * i);\n"
+		"		v |= uint(((112 * c.r - 94 * c.g - 18 * c.b + 128) >> 8) + 128) << (8 * i);\n"
+		"	}\n"
+		"	int chromaWidth = size.x / 2;\n"
+		"	int chromaWords = chromaWidth * (size.y / 2) / 4;\n"
+		"	int chromaIndex = ((y0 / 2) * chromaWidth + x0 / 2) / 4;\n"
+		"	int uBase = size.x * size.y / 4;\n"
+		"	data[uBase + chromaIndex] = u;\n"
+		"	data[uBase + chromaWords + chromaIndex] = v;\n"
+		"}\n";
+
+	// get the time from a steady clock in milliseconds
+	double GetMilliseconds()
+	{
+		return(std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+}
+
+/***********************************************************
+ *  FrameCapture()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameCapture::FrameCapture()
+{
+	m_width = 0;
+	m_height = 0;
+	m_frameSize = 0;
+	m_nextSlot = 0;
+	m_frame = 0;
+	m_pStream = NULL;
+	m_convertProgram = 0;
+	m_frameTexture = 0;
+
+	m_stats.frames = 0;
+	m_stats.ringStalls = 0;
+	m_stats.readbackMilliseconds = 0.0;
+}
+
+/***********************************************************
+ *  ~FrameCapture()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameCapture::~FrameCapture()
+{
+	Stop();
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used for creating the pixel pack buffers
+ *  for frames of the passed in size and starting the encoder
+ *  threads that write them with the file name pattern.
+ ***********************************************************/
+bool FrameCapture::Start(const char* pattern, int width, int height, int ringSize, int encoderThreads)
+{
+	Stop();
+
+	if ((width <= 0) || (height <= 0))
+	{
+		return(false);
+	}
+	if (ringSize <= 1)
+	{
+		ringSize = g_DefaultRingSize;
+	}
+
+	if (m_encoder.Start(pattern, encoderThreads, 0) == false)
+	{
+		return(false);
+	}
+
+	CreateRing(width, height, ringSize, (size_t)width * height * 4);
+	return(true);
+}
+
+/***********************************************************
+ *  StartStream()
+ *
+ *  This method is used for creating the readback ring for
+ *  writing the frames to a video stream.  Y4M frames are
+ *  converted on the GPU when compute shaders are supported
+ *  and the width is a multiple of 8 and the height of 2, and
+ *  on the CPU by the stream otherwise.
+ ***********************************************************/
+bool FrameCapture::StartStream(VideoStream* pStream, int width, int height, int ringSize)
+{
+	Stop();
+
+	if ((NULL == pStream) || (pStream->IsOpen() == false) || (width <= 0) || (height <= 0))
+	{
+		return(false);
+	}
+	if (ringSize <= 1)
+	{
+		ringSize = g_DefaultRingSize;
+	}
+
+	m_pStream = pStream;
+	size_t frameSize = (size_t)width * height * 4;
+	if ((pStream->GetFormat() == VideoStream::FORMAT_Y4M) &&
+		(width % 8 == 0) && (height % 2 == 0) &&
+		(GLEW_ARB_compute_shader) && (GLEW_ARB_shader_storage_buffer_object) &&
+		(CreateConverter() == true))
+	{
+		glGenTextures(1, &m_frameTexture);
+		glBindTexture(GL_TEXTURE_2D, m_frameTexture);
+		glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		frameSize = VideoStream::GetPlanesSize(width, height);
+	}
+
+	CreateRing(width, height, ringSize, frameSize);
+	return(true);
+}
+
+/***********************************************************
+ *  IsConvertingOnGPU()
+ *
+ *  This method is used for checking whether the frames are
+ *  converted to Y4M by the compute shader.
+ ***********************************************************/
+bool FrameCapture::IsConvertingOnGPU() const
+{
+	return(m_convertProgram != 0);
+}
+
+/***********************************************************
+ *  CreateRing()
+ *
+ *  This method is used for creating the pixel pack buffers
+ *  of the readback ring, each holding one read frame.
+ ***********************************************************/
+void FrameCapture::CreateRing(int width, int height, int ringSize, size_t frameSize)
+{
+	m_width = width;
+	m_height = height;
+	m_frameSize = frameSize;
+	m_nextSlot = 0;
+	m_frame = 0;
+	m_stats.frames = 0;
+	m_stats.ringStalls = 0;
+	m_stats.readbackMilliseconds = 0.0;
+
+	m_slots.resize(ringSize);
+	for (int i = 0; i < ringSize; i++)
+	{
+		glGenBuffers(1, &m_slots[i].buffer);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, m_slots[i].buffer);
+		glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)frameSize, NULL, GL_STREAM_READ);
+		m_slots[i].fence = NULL;
+		m_slots[i].frame = 0;
+		m_slots[i].bPending = false;
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+/***********************************************************
+ *  CreateConverter()
+ *
+ *  This method is used for compiling and linking the compute
+ *  shader that converts frames to Y, U and V planes.
+ ***********************************************************/
+bool FrameCapture::CreateConverter()
+{
+	GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+	glShaderSource(shader, 1, &g_ConvertShader, NULL);
+	glCompileShader(shader);
+
+	GLint status = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+	if (status == GL_FALSE)
+	{
+		char log[1024];
+		glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+		std::cout << "Could not compile the video conversion shader:" << log << std::endl;
+		glDeleteShader(shader);
+		return(false);
+	}
+
+	m_convertProgram = glCreateProgram();
+	glAttachShader(m_convertProgram, shader);
+	glLinkProgram(m_convertProgram);
+	glDeleteShader(shader);
+
+	glGetProgramiv(m_convertProgram, GL_LINK_STATUS, &status);
+	if (status == GL_FALSE)
+	{
+		std::cout << "Could not link the video conversion shader" << std::endl;
+		glDeleteProgram(m_convertProgram);
+		m_convertProgram = 0;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  ConvertFrame()
+ *
+ *  This method is used for copying the frame just drawn into
+ *  a texture and running the conversion shader over it, with
+ *  the Y, U and V planes written straight into a readback
+ *  buffer.  The program and texture that were bound for the
+ *  scene are put back afterwards.
+ ***********************************************************/
+void FrameCapture::ConvertFrame(GLuint buffer)
+{
+	GLint previousProgram = 0;
+	GLint previousTexture = 0;
+	GLint previousUnit = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+	glGetIntegerv(GL_ACTIVE_TEXTURE, &previousUnit);
+	glActiveTexture(GL_TEXTURE0);
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+
+	glBindTexture(GL_TEXTURE_2D, m_frameTexture);
+	glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, m_width, m_height);
+
+	glUseProgram(m_convertProgram);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffer);
+	int blocksX = m_width / 8;
+	int blocksY = m_height / 2;
+	glDispatchCompute(
+		(blocksX + g_ConvertGroupSize - 1) / g_ConvertGroupSize,
+		(blocksY + g_ConvertGroupSize - 1) / g_ConvertGroupSize,
+		1);
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+
+	glUseProgram((GLuint)previousProgram);
+	glBindTexture(GL_TEXTURE_2D, (GLuint)previousTexture);
+	glActiveTexture((GLenum)previousUnit);
+}
+
+/***********************************************************
+ *  CaptureFrame()
+ *
+ *  This method is used for reading the frame just drawn into
+ *  the next buffer of the ring, and then passing every
+ *  earlier frame whose copy has finished to the encoder, in
+ *  the order they were drawn.  It is called after the scene
+ *  is rendered and before the buffers are swapped.
+ ***********************************************************/
+void FrameCapture::CaptureFrame()
+{
+	if (m_slots.empty() == true)
+	{
+		return;
+	}
+
+	double start = GetMilliseconds();
+
+	// the ring is full when the next buffer is still in use
+	READBACK_SLOT& slot = m_slots[m_nextSlot];
+	if (slot.bPending == true)
+	{
+		m_stats.ringStalls++;
+		CollectSlot(slot, true);
+	}
+
+	// the copy into the buffer happens on the GPU, so this
+	// returns without waiting for the frame to finish
+	if (m_convertProgram != 0)
+	{
+		ConvertFrame(slot.buffer);
+	}
+	else
+	{
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+		glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+	slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	slot.frame = m_frame++;
+	slot.bPending = true;
+
+	int ringSize = (int)m_slots.size();
+	m_nextSlot = (m_nextSlot + 1) % ringSize;
+
+	// the oldest readback follows the one just queued
+	for (int i = 0; i < ringSize - 1; i++)
+	{
+		READBACK_SLOT& older = m_slots[(m_nextSlot + i) % ringSize];
+		if ((older.bPending == true) && (CollectSlot(older, false) == false))
+		{
+			break;
+		}
+	}
+
+	m_stats.frames++;
+	m_stats.readbackMilliseconds += GetMilliseconds() - start;
+}
+
+/***********************************************************
+ *  CollectSlot()
+ *
+ *  This method is used for mapping a buffer whose fence has
+ *  passed and copying its rows, flipped to put the top row
+ *  first, into a frame for the encoder.  A video stream
+ *  writes straight from the mapped buffer instead.
+ ***********************************************************/
+bool FrameCapture::CollectSlot(READBACK_SLOT& slot, bool bWait)
+{
+	GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, bWait ? g_FenceWaitNanoseconds : 0);
+	while ((bWait == true) && (status == GL_TIMEOUT_EXPIRED))
+	{
+		status = glClientWaitSync(slot.fence, 0, g_FenceWaitNanoseconds);
+	}
+	if (status == GL_TIMEOUT_EXPIRED)
+	{
+		return(false);
+	}
+
+	glDeleteSync(slot.fence);
+	slot.fence = NULL;
+	slot.bPending = false;
+	if (status == GL_WAIT_FAILED)
+	{
+		std::cout << "Dropped captured frame " << slot.frame << std::endl;
+		return(true);
+	}
+
+	size_t rowSize = (size_t)m_width * 4;
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+	const unsigned char* mapped = (const unsigned char*)glMapBufferRange(
+		GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)m_frameSize, GL_MAP_READ_BIT);
+	if ((NULL != mapped) && (NULL != m_pStream))
+	{
+		bool bWritten = (m_convertProgram != 0) ?
+			m_pStream->WritePlanes(mapped, m_width, m_height) :
+			m_pStream->WriteFrame(mapped, m_width, m_height, true);
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		if (bWritten == false)
+		{
+			std::cout << "Could not write video frame " << slot.frame << std::endl;
+		}
+	}
+	else if (NULL != mapped)
+	{
+		std::vector<unsigned char> pixels;
+		m_encoder.GetFrameBuffer(pixels, rowSize * m_height);
+		for (int y = 0; y < m_height; y++)
+		{
+			memcpy(&pixels[rowSize * y], mapped + rowSize * (m_height - 1 - y), rowSize);
+		}
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+
+		m_encoder.SubmitFrame(slot.frame, m_width, m_height, pixels);
+	}
+	else
+	{
+		std::cout << "Dropped captured frame " << slot.frame << std::endl;
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Stop()
+ *
+ *  This method is used for waiting for the readbacks still
+ *  in the ring, letting the encoder write every frame and
+ *  then freeing the buffers.
+ ***********************************************************/
+void FrameCapture::Stop()
+{
+	if (m_slots.empty() == true)
+	{
+		return;
+	}
+
+	int ringSize = (int)m_slots.size();
+	for (int i = 0; i < ringSize; i++)
+	{
+		READBACK_SLOT& slot = m_slots[(m_nextSlot + i) % ringSize];
+		if (slot.bPending == true)
+		{
+			CollectSlot(slot, true);
+		}
+		glDeleteBuffers(1, &slot.buffer);
+	}
+	m_slots.clear();
+
+	if (m_convertProgram != 0)
+	{
+		glDeleteProgram(m_convertProgram);
+		m_convertProgram = 0;
+	}
+	if (m_frameTexture != 0)
+	{
+		glDeleteTextures(1, &m_frameTexture);
+		m_frameTexture = 0;
+	}
+	m_pStream = NULL;
+	m_encoder.Stop();
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting how much capturing has
+ *  cost the render loop.
+ ***********************************************************/
+const FrameCapture::CAPTURE_STATS& FrameCapture::GetStats() const
+{
+	return(m_stats);
+}
+
+/***********************************************************
+ *  GetEncoderStats()
+ *
+ *  This method is used for getting how many frames have been
+ *  encoded and how long the render loop waited on encoders.
+ ***********************************************************/
+FrameEncoder::ENCODER_STATS FrameCapture::GetEncoderStats()
+{
+	return(m_encoder.GetStats());
+}
@@ -0,0 +1,105 @@
+///////////////////////////////////////////////////////////////////////////////
+// framecapture.h
+// ============
+// record the rendered frames without stalling the OpenGL pipeline
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FrameEncoder.h"
+#include "VideoStream.h"
+
+#include <GL/glew.h>
+
+#include <vector>
+
+/***********************************************************
+ *  FrameCapture
+ *
+ *  This class records the frames drawn into the window.
+ *  Each frame is read into the next of a ring of pixel pack
+ *  buffers, which only queues a copy on the GPU, and a fence
+ *  marks when the copy is done.  On later frames the buffers
+ *  whose fences have passed are mapped and handed to the
+ *  frame encoder, so the render loop only waits on the GPU
+ *  when every buffer in the ring is still being filled.
+ *  Frames can instead be written in order to a video
+ *  stream, and for a Y4M stream a compute shader converts
+ *  them to Y, U and V planes before the readback, which
+ *  moves less than half the bytes of RGBA.
+ ***********************************************************/
+class FrameCapture
+{
+public:
+	// constructor
+	FrameCapture();
+	// destructor
+	~FrameCapture();
+
+	// properties for the cost of capturing to the render loop
+	struct CAPTURE_STATS
+	{
+		int frames;
+		// frames that had to wait for the oldest readback
+		int ringStalls;
+		double readbackMilliseconds;
+	};
+
+private:
+	// properties for one buffer of the readback ring
+	struct READBACK_SLOT
+	{
+		GLuint buffer;
+		GLsync fence;
+		int frame;
+		bool bPending;
+	};
+
+	// size of the captured framebuffer and of one read frame
+	int m_width;
+	int m_height;
+	size_t m_frameSize;
+	// ring of pixel pack buffers and the next one to fill
+	std::vector<READBACK_SLOT> m_slots;
+	int m_nextSlot;
+	// number of the next captured frame
+	int m_frame;
+	// encoder threads that write the frames
+	FrameEncoder m_encoder;
+	// video stream that takes the frames instead, if any
+	VideoStream* m_pStream;
+	// compute shader and frame copy for converting to Y4M
+	GLuint m_convertProgram;
+	GLuint m_frameTexture;
+	CAPTURE_STATS m_stats;
+
+	// create the readback ring for frames of a size
+	void CreateRing(int width, int height, int ringSize, size_t frameSize);
+	// create the compute shader that converts frames to Y4M
+	bool CreateConverter();
+	// convert the frame just drawn into a readback buffer
+	void ConvertFrame(GLuint buffer);
+	// hand a finished readback to the encoder, returning false
+	// when its copy is not done and waiting was not asked for
+	bool CollectSlot(READBACK_SLOT& slot, bool bWait);
+
+public:
+	// create the readback ring and start the encoder threads
+	bool Start(const char* pattern, int width, int height, int ringSize, int encoderThreads);
+	// create the readback ring for writing to a video stream
+	bool StartStream(VideoStream* pStream, int width, int height, int ringSize);
+	// check whether frames are converted to Y4M on the GPU
+	bool IsConvertingOnGPU() const;
+	// queue the readback of the frame just drawn
+	void CaptureFrame();
+	// write the frames still in flight and free the ring
+	void Stop();
+
+	// get the cost of capturing to the render loop
+	const CAPTURE_STATS& GetStats() const;
+	// get the progress of the encoder threads
+	FrameEncoder::ENCODER_STATS GetEncoderStats();
+};
@@ -0,0 +1,532 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameencoder.cpp
+// ============
+// encode captured frames to image files on a pool of worker threads
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameEncoder.h"
+#include "RenderFarm.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables and defines
+namespace
+{
+	// largest run of repeated pixels in one QOI run chunk
+	const int g_QOIMaxRun = 62;
+	// largest block of a stored deflate stream
+	const size_t g_StoredBlockSize = 65535;
+
+	// get the time from a steady clock in milliseconds
+	double GetMilliseconds()
+	{
+		return(std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// append a 32 bit value with the most significant byte first
+	void AppendBigEndian(std::vector<unsigned char>& output, unsigned int value)
+	{
+		output.push_back((unsigned char)(value >> 24));
+		output.push_back((unsigned char)(value >> 16));
+		output.push_back((unsigned char)(value >> 8));
+		output.push_back((unsigned char)value);
+	}
+
+	// lookup table for the CRC-32 of PNG chunks
+	struct CRC_TABLE
+	{
+		unsigned int values[256];
+
+		CRC_TABLE()
+		{
+			for (unsigned int n = 0; n < 256; n++)
+			{
+				unsigned int c = n;
+				for (int k = 0; k < 8; k++)
+				{
+					c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+				}
+				values[n] = c;
+			}
+		}
+	};
+
+	// get the CRC-32 of a range of bytes, as used by PNG chunks
+	unsigned int GetCRC32(const unsigned char* data, size_t size)
+	{
+		// built once, even when several encoders get here first
+		static const CRC_TABLE table;
+
+		unsigned int crc = 0xFFFFFFFFu;
+		for (size_t i = 0; i < size; i++)
+		{
+			crc = table.values[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+		}
+		return(crc ^ 0xFFFFFFFFu);
+	}
+
+	// append a PNG chunk with its length, type and CRC
+	void AppendPNGChunk(std::vector<unsigned char>& output, const char* type, const unsigned char* data, size_t size)
+	{
+		AppendBigEndian(output, (unsigned int)size);
+		size_t start = output.size();
+		output.insert(output.end(), type, type + 4);
+		if (size > 0)
+		{
+			output.insert(output.end(), data, data + size);
+		}
+		AppendBigEndian(output, GetCRC32(&output[start], output.size() - start));
+	}
+}
+
+/***********************************************************
+ *  FrameEncoder()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameEncoder::FrameEncoder()
+{
+	m_format = FORMAT_QOI;
+	m_maxQueued = 0;
+	m_bStopping = false;
+
+	m_stats.submittedFrames = 0;
+	m_stats.encodedFrames = 0;
+	m_stats.failedFrames = 0;
+	m_stats.stalls = 0;
+	m_stats.stallMilliseconds = 0.0;
+	m_stats.encodeMilliseconds = 0.0;
+}
+
+/***********************************************************
+ *  ~FrameEncoder()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameEncoder::~FrameEncoder()
+{
+	Stop();
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used for starting the encoder threads.  The
+ *  pattern names the images the same way as the render farm,
+ *  and its extension picks QOI or PNG.  Using 0 threads or 0
+ *  queued frames picks defaults from the hardware threads.
+ ***********************************************************/
+bool FrameEncoder::Start(const char* pattern, int encoderThreads, int maxQueued)
+{
+	Stop();
+
+	if (NULL == pattern)
+	{
+		return(false);
+	}
+
+	if (encoderThreads <= 0)
+	{
+		// leave a thread for the render loop
+		encoderThreads = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+	}
+	if (maxQueued <= 0)
+	{
+		maxQueued = encoderThreads * 2;
+	}
+
+	m_pattern = pattern;
+	m_format = GetFormat(m_pattern);
+	m_maxQueued = maxQueued;
+	m_bStopping = false;
+	m_stats.submittedFrames = 0;
+	m_stats.encodedFrames = 0;
+	m_stats.failedFrames = 0;
+	m_stats.stalls = 0;
+	m_stats.stallMilliseconds = 0.0;
+	m_stats.encodeMilliseconds = 0.0;
+
+	for (int i = 0; i < encoderThreads; i++)
+	{
+		m_workers.push_back(std::thread(&FrameEncoder::EncodeFrames, this));
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Stop()
+ *
+ *  This method is used for letting the encoder threads
+ *  finish the frames already queued and then stopping them.
+ ***********************************************************/
+void FrameEncoder::Stop()
+{
+	if (m_workers.empty() == true)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStopping = true;
+	}
+	m_workReady.notify_all();
+
+	for (size_t i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i].join();
+	}
+	m_workers.clear();
+	m_freeBuffers.clear();
+}
+
+/***********************************************************
+ *  IsRunning()
+ *
+ *  This method is used for checking whether the encoder
+ *  threads have been started.
+ ***********************************************************/
+bool FrameEncoder::IsRunning() const
+{
+	return(m_workers.empty() == false);
+}
+
+/***********************************************************
+ *  GetFrameBuffer()
+ *
+ *  This method is used for getting a buffer for the next
+ *  frame, reusing one already encoded when there is one.
+ ***********************************************************/
+void FrameEncoder::GetFrameBuffer(std::vector<unsigned char>& pixels, size_t size)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_freeBuffers.empty() == false)
+		{
+			pixels.swap(m_freeBuffers.back());
+			m_freeBuffers.pop_back();
+		}
+	}
+	pixels.resize(size);
+}
+
+/***********************************************************
+ *  SubmitFrame()
+ *
+ *  This method is used for queueing a frame to be encoded.
+ *  The pixels are moved into the queue, leaving the passed
+ *  in buffer empty, and the call waits while the queue is
+ *  full so that the encoders can catch up.
+ ***********************************************************/
+void FrameEncoder::SubmitFrame(int frame, int width, int height, std::vector<unsigned char>& pixels)
+{
+	if (m_workers.empty() == true)
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if ((int)m_queue.size() >= m_maxQueued)
+	{
+		double start = GetMilliseconds();
+		m_spaceReady.wait(lock, [this]() { return((int)m_queue.size() < m_maxQueued); });
+		m_stats.stalls++;
+		m_stats.stallMilliseconds += GetMilliseconds() - start;
+	}
+
+	ENCODE_JOB job;
+	job.frame = frame;
+	job.width = width;
+	job.height = height;
+	job.pixels.swap(pixels);
+	m_queue.push_back(std::move(job));
+	m_stats.submittedFrames++;
+
+	lock.unlock();
+	m_workReady.notify_one();
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the progress of the
+ *  recording so far.
+ ***********************************************************/
+FrameEncoder::ENCODER_STATS FrameEncoder::GetStats()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return(m_stats);
+}
+
+/***********************************************************
+ *  EncodeFrames()
+ *
+ *  This method is used by each encoder thread for taking the
+ *  oldest queued frame, encoding it and writing its file,
+ *  until the encoder is stopped and the queue is empty.
+ ***********************************************************/
+void FrameEncoder::EncodeFrames()
+{
+	std::vector<unsigned char> output;
+	while (true)
+	{
+		ENCODE_JOB job;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_workReady.wait(lock, [this]() { return((m_queue.empty() == false) || (m_bStopping == true)); });
+			if (m_queue.empty() == true)
+			{
+				return;
+			}
+			job = std::move(m_queue.front());
+			m_queue.pop_front();
+		}
+		m_spaceReady.notify_one();
+
+		double start = GetMilliseconds();
+		if (m_format == FORMAT_PNG)
+		{
+			EncodePNG(&job.pixels[0], job.width, job.height, output);
+		}
+		else
+		{
+			EncodeQOI(&job.pixels[0], job.width, job.height, output);
+		}
+
+		std::string filename = RenderFarm::GetFrameFilename(m_pattern, job.frame);
+		bool bWritten = false;
+		FILE* pFile = fopen(filename.c_str(), "wb");
+		if (NULL != pFile)
+		{
+			bWritten = (fwrite(&output[0], 1, output.size(), pFile) == output.size());
+			bWritten = (fclose(pFile) == 0) && bWritten;
+		}
+		if (bWritten == false)
+		{
+			std::cout << "Could not write captured frame:" << filename << std::endl;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stats.encodeMilliseconds += GetMilliseconds() - start;
+		if (bWritten == true)
+		{
+			m_stats.encodedFrames++;
+		}
+		else
+		{
+			m_stats.failedFrames++;
+		}
+		m_freeBuffers.push_back(std::vector<unsigned char>());
+		m_freeBuffers.back().swap(job.pixels);
+	}
+}
+
+/***********************************************************
+ *  GetFormat()
+ *
+ *  This method is used for getting the image format of a
+ *  file name, which is PNG for a .png extension and QOI for
+ *  anything else.
+ ***********************************************************/
+FrameEncoder::IMAGE_FORMAT FrameEncoder::GetFormat(const std::string& filename)
+{
+	size_t extension = filename.find_last_of('.');
+	if (extension != std::string::npos)
+	{
+		std::string suffix = filename.substr(extension);
+		std::transform(suffix.begin(), suffix.end(), suffix.begin(), ::tolower);
+		if (suffix == ".png")
+		{
+			return(FORMAT_PNG);
+		}
+	}
+	return(FORMAT_QOI);
+}
+
+/***********************************************************
+ *  EncodeQOI()
+ *
+ *  This method is used for encoding a frame in the QOI
+ *  format, which compresses runs, recently seen colors and
+ *  small color changes in a single fast pass.
+ ***********************************************************/
+void FrameEncoder::EncodeQOI(const unsigned char* pixels, int width, int height, std::vector<unsigned char>& output)
+{
+	output.clear();
+	output.reserve((size_t)width * height + 22);
+
+	// header with three channels in the sRGB color space
+	output.push_back('q');
+	output.push_back('o');
+	output.push_back('i');
+	output.push_back('f');
+	AppendBigEndian(output, (unsigned int)width);
+	AppendBigEndian(output, (unsigned int)height);
+	output.push_back(3);
+	output.push_back(0);
+
+	// every pixel is opaque, so alpha stays 255 throughout
+	unsigned char seen[64][3];
+	memset(seen, 0, sizeof(seen));
+	unsigned char previous[3] = { 0, 0, 0 };
+	int run = 0;
+
+	size_t pixelCount = (size_t)width * height;
+	for (size_t i = 0; i < pixelCount; i++)
+	{
+		const unsigned char* pixel = pixels + i * 4;
+		if ((pixel[0] == previous[0]) && (pixel[1] == previous[1]) && (pixel[2] == previous[2]))
+		{
+			run++;
+			if ((run == g_QOIMaxRun) || (i + 1 == pixelCount))
+			{
+				output.push_back((unsigned char)(0xC0 | (run - 1)));
+				run = 0;
+			}
+			continue;
+		}
+
+		if (run > 0)
+		{
+			output.push_back((unsigned char)(0xC0 | (run - 1)));
+			run = 0;
+		}
+
+		int hash = (pixel[0] * 3 + pixel[1] * 5 + pixel[2] * 7 + 255 * 11) % 64;
+		if ((seen[hash][0] == pixel[0]) && (seen[hash][1] == pixel[1]) && (seen[hash][2] == pixel[2]))
+		{
+			output.push_back((unsigned char)hash);
+		}
+		else
+		{
+			seen[hash][0] = pixel[0];
+			seen[hash][1] = pixel[1];
+			seen[hash][2] = pixel[2];
+
+			int dr = (signed char)(pixel[0] - previous[0]);
+			int dg = (signed char)(pixel[1] - previous[1]);
+			int db = (signed char)(pixel[2] - previous[2]);
+			int drg = dr - dg;
+			int dbg = db - dg;
+
+			if ((dr >= -2) && (dr <= 1) && (dg >= -2) && (dg <= 1) && (db >= -2) && (db <= 1))
+			{
+				output.push_back((unsigned char)(0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2)));
+			}
+			else if ((drg >= -8) && (drg <= 7) && (dg >= -32) && (dg <= 31) && (dbg >= -8) && (dbg <= 7))
+			{
+				output.push_back((unsigned char)(0x80 | (dg + 32)));
+				output.push_back((unsigned char)(((drg + 8) << 4) | (dbg + 8)));
+			}
+			else
+			{
+				output.push_back(0xFE);
+				output.push_back(pixel[0]);
+				output.push_back(pixel[1]);
+				output.push_back(pixel[2]);
+			}
+		}
+
+		previous[0] = pixel[0];
+		previous[1] = pixel[1];
+		previous[2] = pixel[2];
+	}
+
+	// end marker of seven zero bytes and a one
+	for (int i = 0; i < 7; i++)
+	{
+		output.push_back(0);
+	}
+	output.push_back(1);
+}
+
+/***********************************************************
+ *  EncodePNG()
+ *
+ *  This method is used for encoding a frame as a PNG file.
+ *  The image data is kept in stored deflate blocks, so the
+ *  file is as large as the pixels but needs no compression
+ *  library and costs little more than a copy to write.
+ ***********************************************************/
+void FrameEncoder::EncodePNG(const unsigned char* pixels, int width, int height, std::vector<unsigned char>& output)
+{
+	static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	output.assign(signature, signature + 8);
+
+	// 8 bit RGB, no interlacing
+	std::vector<unsigned char> header;
+	AppendBigEndian(header, (unsigned int)width);
+	AppendBigEndian(header, (unsigned int)height);
+	header.push_back(8);
+	header.push_back(2);
+	header.push_back(0);
+	header.push_back(0);
+	header.push_back(0);
+	AppendPNGChunk(output, "IHDR", &header[0], header.size());
+
+	// each row is a filter type of none followed by the pixels
+	size_t rowSize = (size_t)width * 3 + 1;
+	size_t rawSize = rowSize * height;
+	std::vector<unsigned char> raw(rawSize);
+	for (int y = 0; y < height; y++)
+	{
+		unsigned char* row = &raw[rowSize * y];
+		const unsigned char* source = pixels + (size_t)y * width * 4;
+		row[0] = 0;
+		for (int x = 0; x < width; x++)
+		{
+			row[1 + x * 3] = source[x * 4];
+			row[2 + x * 3] = source[x * 4 + 1];
+			row[3 + x * 3] = source[x * 4 + 2];
+		}
+	}
+
+	// a zlib stream of stored blocks followed by the Adler-32
+	std::vector<unsigned char> data;
+	data.reserve(rawSize + (rawSize / g_StoredBlockSize + 1) * 5 + 6);
+	data.push_back(0x78);
+	data.push_back(0x01);
+	size_t offset = 0;
+	do
+	{
+		size_t blockSize = std::min(g_StoredBlockSize, rawSize - offset);
+		bool bFinal = (offset + blockSize == rawSize);
+		data.push_back(bFinal ? 1 : 0);
+		data.push_back((unsigned char)(blockSize & 0xFF));
+		data.push_back((unsigned char)(blockSize >> 8));
+		data.push_back((unsigned char)(~blockSize & 0xFF));
+		data.push_back((unsigned char)((~blockSize >> 8) & 0xFF));
+		data.insert(data.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+		offset += blockSize;
+	} while (offset < rawSize);
+
+	// the sums cannot overflow within 5552 bytes, so the
+	// modulo is only taken once per span
+	unsigned int a = 1;
+	unsigned int b = 0;
+	for (size_t start = 0; start < rawSize; start += 5552)
+	{
+		size_t end = std::min(start + 5552, rawSize);
+		for (size_t i = start; i < end; i++)
+		{
+			a += raw[i];
+			b += a;
+		}
+		a %= 65521;
+		b %= 65521;
+	}
+	AppendBigEndian(data, (b << 16) | a);
+
+	AppendPNGChunk(output, "IDAT", &data[0], data.size());
+	AppendPNGChunk(output, "IEND", NULL, 0);
+}
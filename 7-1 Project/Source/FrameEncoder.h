@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameencoder.h
+// ============
+// encode captured frames to image files on a pool of worker threads
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  FrameEncoder
+ *
+ *  This class takes finished frames from the render loop and
+ *  encodes them to numbered QOI or PNG files on a pool of
+ *  worker threads that stays running while recording.  The
+ *  queue of frames waiting to be encoded is bounded, and a
+ *  frame submitted while it is full waits for an encoder to
+ *  take one, so recording slows the frame rate down instead
+ *  of using up memory when the encoders fall behind.  Pixel
+ *  buffers are recycled between frames.
+ ***********************************************************/
+class FrameEncoder
+{
+public:
+	// constructor
+	FrameEncoder();
+	// destructor
+	~FrameEncoder();
+
+	// the image formats the frames can be written in
+	enum IMAGE_FORMAT
+	{
+		FORMAT_QOI,
+		FORMAT_PNG
+	};
+
+	// properties for the progress of a recording
+	struct ENCODER_STATS
+	{
+		int submittedFrames;
+		int encodedFrames;
+		int failedFrames;
+		// times the render loop waited for a free queue entry
+		int stalls;
+		double stallMilliseconds;
+		double encodeMilliseconds;
+	};
+
+private:
+	// properties for a frame waiting to be encoded
+	struct ENCODE_JOB
+	{
+		int frame;
+		int width;
+		int height;
+		std::vector<unsigned char> pixels;
+	};
+
+	// file name pattern of the numbered images
+	std::string m_pattern;
+	IMAGE_FORMAT m_format;
+	// most frames that may wait in the queue
+	int m_maxQueued;
+	// encoder threads and the frames waiting for them
+	std::vector<std::thread> m_workers;
+	std::deque<ENCODE_JOB> m_queue;
+	std::vector<std::vector<unsigned char> > m_freeBuffers;
+	std::mutex m_mutex;
+	std::condition_variable m_workReady;
+	std::condition_variable m_spaceReady;
+	bool m_bStopping;
+	ENCODER_STATS m_stats;
+
+	// take frames from the queue until the encoder is stopped
+	void EncodeFrames();
+
+public:
+	// start the encoder threads for a numbered file pattern
+	bool Start(const char* pattern, int encoderThreads, int maxQueued);
+	// encode the frames left in the queue and stop the threads
+	void Stop();
+	// check whether the encoder threads are running
+	bool IsRunning() const;
+
+	// get a recycled buffer of the passed in size for a frame
+	void GetFrameBuffer(std::vector<unsigned char>& pixels, size_t size);
+	// queue the RGBA pixels of a frame, top row first, taking
+	// the contents of the buffer and waiting while it is full
+	void SubmitFrame(int frame, int width, int height, std::vector<unsigned char>& pixels);
+	// get the progress of the recording
+	ENCODER_STATS GetStats();
+
+	// get the format written for a file name extension
+	static IMAGE_FORMAT GetFormat(const std::string& filename);
+	// encode RGBA pixels, top row first, as an RGB image
+	static void EncodeQOI(const unsigned char* pixels, int width, int height, std::vector<unsigned char>& output);
+	static void EncodePNG(const unsigned char* pixels, int width, int height, std::vector<unsigned char>& output);
+};
@@ -0,0 +1,270 @@
+///////////////////////////////////////////////////////////////////////////////
+// glrenderdevice.cpp
+// ============
+// issue the scene draw list through OpenGL and the shader manager
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GLRenderDevice.h"
+
+#include <string>
+
+// declaration of global variables and defines
+namespace
+{
+	const char* g_ModelName = "model";
+	const char* g_ViewName = "view";
+	const char* g_ProjectionName = "projection";
+	const char* g_ColorValueName = "objectColor";
+	const char* g_TextureValueName = "objectTexture";
+	const char* g_UseTextureName = "bUseTexture";
+	const char* g_UseLightingName = "bUseLighting";
+}
+
+/***********************************************************
+ *  GLRenderDevice()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+GLRenderDevice::GLRenderDevice(
+	ShaderManager* pShaderManager,
+	ShapeMeshes* pShapeMeshes,
+	TextureSamplers* pTextureSamplers)
+{
+	m_pShaderManager = pShaderManager;
+	m_pShapeMeshes = pShapeMeshes;
+	m_pTextureSamplers = pTextureSamplers;
+}
+
+/***********************************************************
+ *  GetName()
+ *
+ *  This method is used for getting the name of the backend.
+ ***********************************************************/
+const char* GLRenderDevice::GetName() const
+{
+	return("OpenGL");
+}
+
+/***********************************************************
+ *  LoadScene()
+ *
+ *  This method is used for loading the basic shape meshes.
+ *  Only one instance of a particular mesh needs to be loaded
+ *  in memory no matter how many times it is drawn.  The scene
+ *  manager has already bound its textures to the OpenGL
+ *  texture units, so only a scene to load is checked for.
+ ***********************************************************/
+bool GLRenderDevice::LoadScene(const SceneManager* pSceneManager)
+{
+	if ((NULL == m_pShapeMeshes) || (NULL == pSceneManager))
+	{
+		return(false);
+	}
+
+	m_pShapeMeshes->LoadBoxMesh();
+	m_pShapeMeshes->LoadPlaneMesh();
+	m_pShapeMeshes->LoadCylinderMesh();
+	m_pShapeMeshes->LoadConeMesh();
+	m_pShapeMeshes->LoadPrismMesh();
+	m_pShapeMeshes->LoadPyramid4Mesh();
+	m_pShapeMeshes->LoadSphereMesh();
+	m_pShapeMeshes->LoadTaperedCylinderMesh();
+	m_pShapeMeshes->LoadTorusMesh();
+
+	return(true);
+}
+
+/***********************************************************
+ *  SetView()
+ *
+ *  This method is used for setting the view and projection
+ *  matrices and the camera position into the shader.
+ ***********************************************************/
+void GLRenderDevice::SetView(
+	const glm::mat4& view,
+	const glm::mat4& projection,
+	const glm::vec3& viewPosition)
+{
+	m_views.clear();
+	SetShaderView(view, projection, viewPosition);
+}
+
+/***********************************************************
+ *  SetViews()
+ *
+ *  This method is used for keeping several cameras, which
+ *  are set into the shader one at a time as the draw list
+ *  is issued for each of them.
+ ***********************************************************/
+void GLRenderDevice::SetViews(const std::vector<VIEWPORT_VIEW>& views)
+{
+	m_views = views;
+}
+
+/***********************************************************
+ *  SetShaderView()
+ *
+ *  This method is used for setting the values of one camera
+ *  into the shader.
+ ***********************************************************/
+void GLRenderDevice::SetShaderView(
+	const glm::mat4& view,
+	const glm::mat4& projection,
+	const glm::vec3& viewPosition)
+{
+	m_pShaderManager->setMat4Value(g_ViewName, view);
+	m_pShaderManager->setMat4Value(g_ProjectionName, projection);
+	m_pShaderManager->setVec3Value("viewPosition", viewPosition);
+}
+
+/***********************************************************
+ *  SetLights()
+ *
+ *  This method is used for passing the light sources into
+ *  the shader.
+ ***********************************************************/
+void GLRenderDevice::SetLights(const std::vector<SceneManager::LIGHT_SOURCE>& lights)
+{
+	// this line of code is NEEDED for telling the shaders to render
+	// the 3D scene with custom lighting - to use the default rendered
+	// lighting then comment out the following line
+	m_pShaderManager->setBoolValue(g_UseLightingName, true);
+
+	for (size_t i = 0; i < lights.size(); i++)
+	{
+		std::string name = "lightSources[" + std::to_string(i) + "].";
+		m_pShaderManager->setVec3Value(name + "position", lights[i].position);
+		m_pShaderManager->setVec3Value(name + "ambientColor", lights[i].ambientColor);
+		m_pShaderManager->setVec3Value(name + "diffuseColor", lights[i].diffuseColor);
+		m_pShaderManager->setVec3Value(name + "specularColor", lights[i].specularColor);
+		m_pShaderManager->setFloatValue(name + "focalStrength", lights[i].focalStrength);
+		m_pShaderManager->setFloatValue(name + "specularIntensity", lights[i].specularIntensity);
+	}
+}
+
+/***********************************************************
+ *  SubmitDraws()
+ *
+ *  This method is used for issuing the recorded draw list to
+ *  OpenGL, once for each camera set by SetViews() with the
+ *  viewport moved to the rectangle of the camera.  The draw
+ *  list itself is only built once for all of them.
+ ***********************************************************/
+void GLRenderDevice::SubmitDraws(
+	const std::vector<SceneManager::DRAW_COMMAND>& draws,
+	const std::vector<SceneManager::OBJECT_MATERIAL>& materials)
+{
+	if (m_views.empty() == true)
+	{
+		SubmitDrawPass(draws, materials);
+		return;
+	}
+
+	// the rectangles are measured from the top of the
+	// current viewport, which is put back afterward
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	for (size_t i = 0; i < m_views.size(); i++)
+	{
+		const VIEWPORT_VIEW& view = m_views[i];
+		glViewport(
+			viewport[0] + view.x,
+			viewport[1] + viewport[3] - view.y - view.height,
+			view.width,
+			view.height);
+		SetShaderView(view.view, view.projection, view.viewPosition);
+		SubmitDrawPass(draws, materials);
+	}
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+/***********************************************************
+ *  SubmitDrawPass()
+ *
+ *  This method is used for issuing the draw list once with
+ *  the camera in the shader.  Shader values are only set when
+ *  they differ from those of the previous draw.
+ ***********************************************************/
+void GLRenderDevice::SubmitDrawPass(
+	const std::vector<SceneManager::DRAW_COMMAND>& draws,
+	const std::vector<SceneManager::OBJECT_MATERIAL>& materials)
+{
+	const SceneManager::DRAW_COMMAND* pPrevious = NULL;
+	// the sampler slot last sent to the shader, since untextured
+	// draws in between do not change the sampler uniform
+	int samplerSlot = -1;
+	for (size_t i = 0; i < draws.size(); i++)
+	{
+		const SceneManager::DRAW_COMMAND& draw = draws[i];
+
+		m_pShaderManager->setMat4Value(g_ModelName, draw.model);
+
+		if ((NULL == pPrevious) || (pPrevious->color != draw.color))
+		{
+			m_pShaderManager->setVec4Value(g_ColorValueName, draw.color);
+		}
+		if ((NULL == pPrevious) || (pPrevious->bUseTexture != draw.bUseTexture))
+		{
+			m_pShaderManager->setIntValue(g_UseTextureName, draw.bUseTexture);
+		}
+		if ((draw.bUseTexture == true) && (samplerSlot != draw.textureSlot))
+		{
+			m_pShaderManager->setSampler2DValue(g_TextureValueName, draw.textureSlot);
+			samplerSlot = draw.textureSlot;
+		}
+		if ((NULL == pPrevious) || (pPrevious->uvScale != draw.uvScale))
+		{
+			m_pShaderManager->setVec2Value("UVscale", draw.uvScale);
+		}
+		if ((draw.materialIndex >= 0) &&
+			((NULL == pPrevious) || (pPrevious->materialIndex != draw.materialIndex)))
+		{
+			const SceneManager::OBJECT_MATERIAL& material = materials[draw.materialIndex];
+			m_pShaderManager->setVec3Value("material.ambientColor", material.ambientColor);
+			m_pShaderManager->setFloatValue("material.ambientStrength", material.ambientStrength);
+			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
+			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
+			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
+		}
+		if ((draw.bUseTexture == true) && (draw.textureSlot >= 0) && (NULL != m_pTextureSamplers))
+		{
+			glBindSampler(draw.textureSlot, m_pTextureSamplers->GetSampler(
+				draw.samplerFilter,
+				draw.samplerWrap));
+		}
+
+		DrawMesh(draw.mesh, draw.parts);
+		pPrevious = &draw;
+	}
+}
+
+/***********************************************************
+ *  DrawMesh()
+ *
+ *  This method is used for drawing the passed in parts of a
+ *  loaded shape mesh with OpenGL.
+ ***********************************************************/
+void GLRenderDevice::DrawMesh(SceneManager::MESH_TYPE mesh, unsigned int parts)
+{
+	bool bTop = (parts & SceneManager::PART_TOP) != 0;
+	bool bBottom = (parts & SceneManager::PART_BOTTOM) != 0;
+	bool bSides = (parts & SceneManager::PART_SIDES) != 0;
+
+	switch (mesh)
+	{
+	case SceneManager::MESH_BOX: m_pShapeMeshes->DrawBoxMesh(); break;
+	case SceneManager::MESH_PLANE: m_pShapeMeshes->DrawPlaneMesh(); break;
+	case SceneManager::MESH_CYLINDER: m_pShapeMeshes->DrawCylinderMesh(bTop, bBottom, bSides); break;
+	case SceneManager::MESH_CONE: m_pShapeMeshes->DrawConeMesh(bBottom); break;
+	case SceneManager::MESH_PRISM: m_pShapeMeshes->DrawPrismMesh(); break;
+	case SceneManager::MESH_PYRAMID4: m_pShapeMeshes->DrawPyramid4Mesh(); break;
+	case SceneManager::MESH_SPHERE: m_pShapeMeshes->DrawSphereMesh(); break;
+	case SceneManager::MESH_HALF_SPHERE: m_pShapeMeshes->DrawHalfSphereMesh(); break;
+	case SceneManager::MESH_TAPERED_CYLINDER: m_pShapeMeshes->DrawTaperedCylinderMesh(bTop, bBottom, bSides); break;
+	case SceneManager::MESH_TORUS: m_pShapeMeshes->DrawTorusMesh(); break;
+	default: break;
+	}
+}
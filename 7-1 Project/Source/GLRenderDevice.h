@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////
+// glrenderdevice.h
+// ============
+// issue the scene draw list through OpenGL and the shader manager
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RenderDevice.h"
+#include "ShaderManager.h"
+#include "ShapeMeshes.h"
+#include "TextureSamplers.h"
+
+/***********************************************************
+ *  GLRenderDevice
+ *
+ *  This class is the OpenGL backend of the render device.
+ *  Every draw sets its shader values through the shader
+ *  manager, skipping the ones that match the previous draw,
+ *  and then draws one of the basic shape meshes.  The scene
+ *  manager still uploads the OpenGL textures itself, since
+ *  they are bound to fixed texture units for every frame.
+ *  With several views, the draw list is issued once per
+ *  view into its own viewport, since the shaders are not
+ *  part of the device and cannot pick the viewport per
+ *  vertex.
+ ***********************************************************/
+class GLRenderDevice : public RenderDevice
+{
+public:
+	// constructor
+	GLRenderDevice(
+		ShaderManager* pShaderManager,
+		ShapeMeshes* pShapeMeshes,
+		TextureSamplers* pTextureSamplers);
+
+private:
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// pointer to basic shapes object
+	ShapeMeshes* m_pShapeMeshes;
+	// pointer to the shared texture sampler objects
+	TextureSamplers* m_pTextureSamplers;
+	// cameras set by SetViews(), or empty for a single camera
+	std::vector<VIEWPORT_VIEW> m_views;
+
+	// set the camera values into the shader
+	void SetShaderView(
+		const glm::mat4& view,
+		const glm::mat4& projection,
+		const glm::vec3& viewPosition);
+	// issue the draw list once with the current camera
+	void SubmitDrawPass(
+		const std::vector<SceneManager::DRAW_COMMAND>& draws,
+		const std::vector<SceneManager::OBJECT_MATERIAL>& materials);
+
+	// issue one shape mesh draw to OpenGL
+	void DrawMesh(SceneManager::MESH_TYPE mesh, unsigned int parts);
+
+public:
+	const char* GetName() const;
+	bool LoadScene(const SceneManager* pSceneManager);
+	void SetView(
+		const glm::mat4& view,
+		const glm::mat4& projection,
+		const glm::vec3& viewPosition);
+	void SetViews(const std::vector<VIEWPORT_VIEW>& views);
+	void SetLights(const std::vector<SceneManager::LIGHT_SOURCE>& lights);
+	void SubmitDraws(
+		const std::vector<SceneManager::DRAW_COMMAND>& draws,
+		const std::vector<SceneManager::OBJECT_MATERIAL>& materials);
+};
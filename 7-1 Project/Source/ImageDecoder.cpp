@@ -0,0 +1,438 @@
+///////////////////////////////////////////////////////////////////////////////
+// imagedecoder.cpp
+// ============
+// decode texture image files through interchangeable decoder backends
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ImageDecoder.h"
+
+#ifndef STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#endif
+
+#ifdef USE_LIBJPEG_TURBO
+#include <turbojpeg.h>
+#endif
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+// declaration of global variables and defines
+namespace
+{
+	// first bytes of a file in the texture cache format, which
+	// changed when the source file stamp was added
+	const char g_RawImageMagic[4] = { 'R', 'I', 'M', '2' };
+
+	// largest width or height read from a texture cache file
+	const unsigned int g_RawImageMaxDimension = 32768;
+
+	// properties stored at the start of a texture cache file
+	struct RAW_IMAGE_HEADER
+	{
+		char magic[4];
+		unsigned int width;
+		unsigned int height;
+		unsigned int channels;
+		// size and modification time of the image file the cache
+		// was made from, to tell when it has been edited
+		uint64_t sourceSize;
+		int64_t sourceTime;
+	};
+
+	// get the size and modification time of a file
+	bool GetFileStamp(const char* filename, uint64_t& size, int64_t& time)
+	{
+		struct stat status;
+		if (stat(filename, &status) != 0)
+		{
+			return(false);
+		}
+
+		size = (uint64_t)status.st_size;
+		time = (int64_t)status.st_mtime;
+		return(true);
+	}
+}
+
+/***********************************************************
+ *  StbImageDecoder
+ ***********************************************************/
+const char* StbImageDecoder::GetName() const
+{
+	return("stb_image");
+}
+
+bool StbImageDecoder::CanDecode(const unsigned char* data, size_t size) const
+{
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	return(stbi_info_from_memory(data, (int)size, &width, &height, &channels) != 0);
+}
+
+bool StbImageDecoder::Decode(const unsigned char* data, size_t size, DECODED_IMAGE& image)
+{
+	// the rows stay top-down and are reordered while the texture
+	// is being prepared for upload, which copies them anyway
+	stbi_set_flip_vertically_on_load(false);
+
+	image.pixels = stbi_load_from_memory(
+		data,
+		(int)size,
+		&image.width,
+		&image.height,
+		&image.channels,
+		0);
+	image.bBottomUp = false;
+	image.bOwned = true;
+
+	return(NULL != image.pixels);
+}
+
+void StbImageDecoder::Free(DECODED_IMAGE& image)
+{
+	if ((NULL != image.pixels) && (image.bOwned == true))
+	{
+		stbi_image_free(image.pixels);
+	}
+	image.pixels = NULL;
+}
+
+#ifdef USE_LIBJPEG_TURBO
+/***********************************************************
+ *  TurboJpegDecoder
+ ***********************************************************/
+TurboJpegDecoder::TurboJpegDecoder()
+{
+	m_pHandle = tjInitDecompress();
+}
+
+TurboJpegDecoder::~TurboJpegDecoder()
+{
+	if (NULL != m_pHandle)
+	{
+		tjDestroy((tjhandle)m_pHandle);
+		m_pHandle = NULL;
+	}
+}
+
+const char* TurboJpegDecoder::GetName() const
+{
+	return("libjpeg-turbo");
+}
+
+bool TurboJpegDecoder::CanDecode(const unsigned char* data, size_t size) const
+{
+	// every JPEG file starts with the start of image marker
+	return((NULL != m_pHandle) && (size > 2) && (data[0] == 0xFF) && (data[1] == 0xD8));
+}
+
+bool TurboJpegDecoder::Decode(const unsigned char* data, size_t size, DECODED_IMAGE& image)
+{
+	int subsampling = 0;
+	int colorspace = 0;
+
+	image.pixels = NULL;
+	if (tjDecompressHeader3(
+		(tjhandle)m_pHandle,
+		data,
+		(unsigned long)size,
+		&image.width,
+		&image.height,
+		&subsampling,
+		&colorspace) != 0)
+	{
+		return(false);
+	}
+
+	// grayscale images stay single channel for the compact formats
+	int pixelFormat = TJPF_RGB;
+	image.channels = 3;
+	if (colorspace == TJCS_GRAY)
+	{
+		pixelFormat = TJPF_GRAY;
+		image.channels = 1;
+	}
+
+	image.pixels = new unsigned char[(size_t)image.width * image.height * image.channels];
+	image.bBottomUp = true;
+	image.bOwned = true;
+
+	if (tjDecompress2(
+		(tjhandle)m_pHandle,
+		data,
+		(unsigned long)size,
+		image.pixels,
+		image.width,
+		0,
+		image.height,
+		pixelFormat,
+		TJFLAG_BOTTOMUP) != 0)
+	{
+		Free(image);
+		return(false);
+	}
+
+	return(true);
+}
+
+void TurboJpegDecoder::Free(DECODED_IMAGE& image)
+{
+	if ((NULL != image.pixels) && (image.bOwned == true))
+	{
+		delete[] image.pixels;
+	}
+	image.pixels = NULL;
+}
+#endif
+
+/***********************************************************
+ *  RawImageDecoder
+ ***********************************************************/
+const char* RawImageDecoder::GetName() const
+{
+	return("raw cache");
+}
+
+bool RawImageDecoder::CanDecode(const unsigned char* data, size_t size) const
+{
+	return((size >= sizeof(RAW_IMAGE_HEADER)) &&
+		(memcmp(data, g_RawImageMagic, sizeof(g_RawImageMagic)) == 0));
+}
+
+bool RawImageDecoder::Decode(const unsigned char* data, size_t size, DECODED_IMAGE& image)
+{
+	if ((NULL == data) || (size < sizeof(RAW_IMAGE_HEADER)))
+	{
+		return(false);
+	}
+
+	RAW_IMAGE_HEADER header;
+	memcpy(&header, data, sizeof(header));
+
+	// the header comes from a file, so nothing is sized from it
+	// until it is known to fit in the file data
+	if ((header.width == 0) || (header.width > g_RawImageMaxDimension) ||
+		(header.height == 0) || (header.height > g_RawImageMaxDimension) ||
+		(header.channels < 1) || (header.channels > 4))
+	{
+		return(false);
+	}
+
+	size_t rowBytes = (size_t)header.width * header.channels;
+	if (header.height > (size - sizeof(header)) / rowBytes)
+	{
+		return(false);
+	}
+
+	// the pixels are used in place from the file data
+	image.pixels = (unsigned char*)(data + sizeof(header));
+	image.width = (int)header.width;
+	image.height = (int)header.height;
+	image.channels = (int)header.channels;
+	image.bBottomUp = true;
+	image.bOwned = false;
+
+	return(true);
+}
+
+void RawImageDecoder::Free(DECODED_IMAGE& image)
+{
+	image.pixels = NULL;
+}
+
+/***********************************************************
+ *  WriteRawImage()
+ *
+ *  This method is used for writing a decoded image to a file
+ *  in the texture cache format, with the rows bottom-up.  The
+ *  size and modification time of the image file it was
+ *  decoded from are kept with it.
+ ***********************************************************/
+bool RawImageDecoder::WriteRawImage(const char* filename, const DECODED_IMAGE& image, const char* sourceFilename)
+{
+	RAW_IMAGE_HEADER header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, g_RawImageMagic, sizeof(g_RawImageMagic));
+	header.width = (unsigned int)image.width;
+	header.height = (unsigned int)image.height;
+	header.channels = (unsigned int)image.channels;
+	if (GetFileStamp(sourceFilename, header.sourceSize, header.sourceTime) == false)
+	{
+		return(false);
+	}
+
+	std::ofstream file(filename, std::ios::out | std::ios::binary);
+	if (!file)
+	{
+		return(false);
+	}
+	file.write((const char*)&header, sizeof(header));
+
+	size_t rowBytes = (size_t)image.width * image.channels;
+	for (int row = 0; row < image.height; row++)
+	{
+		int sourceRow = image.bBottomUp ? row : (image.height - 1 - row);
+		file.write((const char*)(image.pixels + sourceRow * rowBytes), (std::streamsize)rowBytes);
+	}
+
+	return(file.good());
+}
+
+/***********************************************************
+ *  IsCacheCurrent()
+ *
+ *  This method is used for checking whether a texture cache
+ *  file exists and was made from the image file as it is
+ *  now, by comparing the size and modification time kept in
+ *  its header.  An edited image needs its cache made again.
+ ***********************************************************/
+bool RawImageDecoder::IsCacheCurrent(const char* filename, const char* sourceFilename)
+{
+	std::ifstream file(filename, std::ios::in | std::ios::binary);
+	if (!file)
+	{
+		return(false);
+	}
+
+	RAW_IMAGE_HEADER header;
+	file.read((char*)&header, sizeof(header));
+	if ((file.gcount() != (std::streamsize)sizeof(header)) ||
+		(memcmp(header.magic, g_RawImageMagic, sizeof(g_RawImageMagic)) != 0))
+	{
+		return(false);
+	}
+
+	uint64_t sourceSize = 0;
+	int64_t sourceTime = 0;
+	if (GetFileStamp(sourceFilename, sourceSize, sourceTime) == false)
+	{
+		return(false);
+	}
+
+	return((header.sourceSize == sourceSize) && (header.sourceTime == sourceTime));
+}
+
+/***********************************************************
+ *  ImageDecoderRegistry()
+ *
+ *  The constructor for the class - the raw cache comes first
+ *  since it needs no decoding, then the SIMD JPEG backend
+ *  when it was built in, then stb_image for everything else.
+ ***********************************************************/
+ImageDecoderRegistry::ImageDecoderRegistry()
+{
+	m_decoders.push_back(new RawImageDecoder());
+#ifdef USE_LIBJPEG_TURBO
+	m_decoders.push_back(new TurboJpegDecoder());
+#endif
+	m_decoders.push_back(new StbImageDecoder());
+}
+
+/***********************************************************
+ *  ~ImageDecoderRegistry()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ImageDecoderRegistry::~ImageDecoderRegistry()
+{
+	for (size_t i = 0; i < m_decoders.size(); i++)
+	{
+		delete m_decoders[i];
+	}
+	m_decoders.clear();
+}
+
+/***********************************************************
+ *  Decode()
+ *
+ *  This method is used for decoding the file data with the
+ *  first backend that can read it.  The backend is returned
+ *  so the caller can free the pixels with it.
+ ***********************************************************/
+ImageDecoder* ImageDecoderRegistry::Decode(const unsigned char* data, size_t size, DECODED_IMAGE& image)
+{
+	image.pixels = NULL;
+	image.width = 0;
+	image.height = 0;
+	image.channels = 0;
+	image.bBottomUp = false;
+	image.bOwned = false;
+
+	if ((NULL == data) || (size == 0))
+	{
+		return(NULL);
+	}
+
+	for (size_t i = 0; i < m_decoders.size(); i++)
+	{
+		if (m_decoders[i]->CanDecode(data, size) &&
+			m_decoders[i]->Decode(data, size, image))
+		{
+			return(m_decoders[i]);
+		}
+	}
+
+	return(NULL);
+}
+
+/***********************************************************
+ *  GetDecoderCount()
+ *
+ *  This method is used for getting the number of backends.
+ ***********************************************************/
+int ImageDecoderRegistry::GetDecoderCount() const
+{
+	return((int)m_decoders.size());
+}
+
+/***********************************************************
+ *  GetDecoder()
+ *
+ *  This method is used for getting a backend by its index.
+ ***********************************************************/
+ImageDecoder* ImageDecoderRegistry::GetDecoder(int index) const
+{
+	if ((index < 0) || (index >= (int)m_decoders.size()))
+	{
+		return(NULL);
+	}
+
+	return(m_decoders[index]);
+}
+
+/***********************************************************
+ *  ReadFile()
+ *
+ *  This method is used for reading a whole file into memory
+ *  when it was not part of a batched asset read.
+ ***********************************************************/
+bool ImageDecoderRegistry::ReadFile(const char* filename, std::vector<unsigned char>& data)
+{
+	std::ifstream file(filename, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		return(false);
+	}
+
+	std::streamsize size = file.tellg();
+	if (size <= 0)
+	{
+		return(false);
+	}
+
+	data.resize((size_t)size);
+	file.seekg(0, std::ios::beg);
+	file.read((char*)&data[0], size);
+
+	return(file.gcount() == size);
+}
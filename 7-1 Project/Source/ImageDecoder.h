@@ -0,0 +1,148 @@
+///////////////////////////////////////////////////////////////////////////////
+// imagedecoder.h
+// ============
+// decode texture image files through interchangeable decoder backends
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// properties for a decoded image
+struct DECODED_IMAGE
+{
+	// pixel rows, tightly packed
+	unsigned char* pixels;
+	int width;
+	int height;
+	int channels;
+	// true when the first row is the bottom of the image, which
+	// is the row order OpenGL expects for texture uploads
+	bool bBottomUp;
+	// true when the pixels were allocated by the decoder and
+	// must be returned to it with Free()
+	bool bOwned;
+};
+
+/***********************************************************
+ *  ImageDecoder
+ *
+ *  This is the interface for one image decoding backend.  A
+ *  backend reports which files it can decode from their first
+ *  bytes and decodes them from memory.
+ ***********************************************************/
+class ImageDecoder
+{
+public:
+	virtual ~ImageDecoder() {}
+
+	// get the display name of the backend
+	virtual const char* GetName() const = 0;
+	// check whether the file data is in a format the backend reads
+	virtual bool CanDecode(const unsigned char* data, size_t size) const = 0;
+	// decode the file data into pixels
+	virtual bool Decode(const unsigned char* data, size_t size, DECODED_IMAGE& image) = 0;
+	// free the pixels of a decoded image
+	virtual void Free(DECODED_IMAGE& image) = 0;
+};
+
+/***********************************************************
+ *  StbImageDecoder
+ *
+ *  This backend decodes any format stb_image supports.  The
+ *  rows are left top-down so no extra flip pass is made.
+ ***********************************************************/
+class StbImageDecoder : public ImageDecoder
+{
+public:
+	const char* GetName() const;
+	bool CanDecode(const unsigned char* data, size_t size) const;
+	bool Decode(const unsigned char* data, size_t size, DECODED_IMAGE& image);
+	void Free(DECODED_IMAGE& image);
+};
+
+#ifdef USE_LIBJPEG_TURBO
+/***********************************************************
+ *  TurboJpegDecoder
+ *
+ *  This backend decodes JPEG files with libjpeg-turbo, which
+ *  uses SIMD for the inverse DCT, upsampling and YCbCr to RGB
+ *  color conversion, and writes the rows bottom-up directly.
+ ***********************************************************/
+class TurboJpegDecoder : public ImageDecoder
+{
+public:
+	TurboJpegDecoder();
+	~TurboJpegDecoder();
+
+	const char* GetName() const;
+	bool CanDecode(const unsigned char* data, size_t size) const;
+	bool Decode(const unsigned char* data, size_t size, DECODED_IMAGE& image);
+	void Free(DECODED_IMAGE& image);
+
+private:
+	// handle to the libjpeg-turbo decompressor
+	void* m_pHandle;
+};
+#endif
+
+/***********************************************************
+ *  RawImageDecoder
+ *
+ *  This backend reads the uncompressed texture cache format.
+ *  The pixels are stored bottom-up after a small header, so
+ *  decoding only points into the file data without copying.
+ *  The header also keeps the size and modification time of
+ *  the image file, so a stale cache can be found.
+ ***********************************************************/
+class RawImageDecoder : public ImageDecoder
+{
+public:
+	const char* GetName() const;
+	bool CanDecode(const unsigned char* data, size_t size) const;
+	bool Decode(const unsigned char* data, size_t size, DECODED_IMAGE& image);
+	void Free(DECODED_IMAGE& image);
+
+	// write a decoded image to a file in the cache format,
+	// stamped with the image file it was decoded from
+	static bool WriteRawImage(const char* filename, const DECODED_IMAGE& image, const char* sourceFilename);
+	// check whether a cache file was made from the image file
+	// as it is now
+	static bool IsCacheCurrent(const char* filename, const char* sourceFilename);
+};
+
+/***********************************************************
+ *  ImageDecoderRegistry
+ *
+ *  This class holds the available decoder backends in order
+ *  of preference and passes each file to the first backend
+ *  that can decode it.
+ ***********************************************************/
+class ImageDecoderRegistry
+{
+public:
+	// constructor
+	ImageDecoderRegistry();
+	// destructor
+	~ImageDecoderRegistry();
+
+private:
+	// the registered backends, most preferred first
+	std::vector<ImageDecoder*> m_decoders;
+
+public:
+	// decode the file data with the first backend that reads it
+	ImageDecoder* Decode(const unsigned char* data, size_t size, DECODED_IMAGE& image);
+	// get the number of registered backends
+	int GetDecoderCount() const;
+	// get a registered backend by index
+	ImageDecoder* GetDecoder(int index) const;
+
+	// read a whole file into memory
+	static bool ReadFile(const char* filename, std::vector<unsigned char>& data);
+};
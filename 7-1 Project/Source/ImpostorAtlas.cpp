@@ -0,0 +1,429 @@
+///////////////////////////////////////////////////////////////////////////////
+// impostoratlas.cpp
+// ============
+// pre-render prefabs from many directions for drawing far instances as quads
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ImpostorAtlas.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+const unsigned char ImpostorAtlas::NO_MATERIAL;
+const unsigned char ImpostorAtlas::TEXTURED_TEXEL;
+
+// declaration of global variables and defines
+namespace
+{
+	// texture slots the scene can bind
+	const int g_TextureSlots = 16;
+
+	// get the time in milliseconds, for timing the bakes
+	double GetMilliseconds()
+	{
+		return(std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// get the signed area of the parallelogram of a triangle
+	// edge and a point, positive on the left of the edge
+	float EdgeFunction(const glm::vec2& a, const glm::vec2& b, const glm::vec2& point)
+	{
+		return((b.x - a.x) * (point.y - a.y) - (b.y - a.y) * (point.x - a.x));
+	}
+}
+
+/***********************************************************
+ *  ImpostorAtlas()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ImpostorAtlas::ImpostorAtlas()
+{
+	m_settings.views = 8;
+	m_settings.resolution = 64;
+	m_settings.distance = 30.0f;
+	m_settings.minParts = 2;
+
+	m_stats.prefabs = 0;
+	m_stats.bakedViews = 0;
+	m_stats.atlasBytes = 0;
+	m_stats.bakeMilliseconds = 0.0;
+}
+
+/***********************************************************
+ *  SetSettings()
+ *
+ *  This method is used for setting the size of the atlases
+ *  and the distance they take over at.  The atlases already
+ *  baked are thrown away, so the next Bake() makes them all
+ *  again at the new size.
+ ***********************************************************/
+void ImpostorAtlas::SetSettings(const IMPOSTOR_SETTINGS& settings)
+{
+	m_settings = settings;
+	m_settings.views = std::max(m_settings.views, 1);
+	m_settings.resolution = std::max(m_settings.resolution, 4);
+	m_settings.distance = std::max(m_settings.distance, 0.0f);
+	m_impostors.clear();
+}
+
+/***********************************************************
+ *  GetSettings()
+ *
+ *  This method is used for getting the size of the atlases
+ *  and the distance they take over at.
+ ***********************************************************/
+const ImpostorAtlas::IMPOSTOR_SETTINGS& ImpostorAtlas::GetSettings() const
+{
+	return(m_settings);
+}
+
+/***********************************************************
+ *  Bake()
+ *
+ *  This method is used for baking the prefabs of the scene
+ *  entities that have enough parts but no atlas yet, or
+ *  whose parts changed since theirs was baked.  Textured
+ *  parts take the average color of their texture, which is
+ *  what the smallest mipmap level shows from afar anyway.
+ ***********************************************************/
+bool ImpostorAtlas::Bake(const SceneManager* pSceneManager)
+{
+	const SceneEntities* pEntities = (NULL != pSceneManager) ? pSceneManager->GetSceneEntities() : NULL;
+	if (NULL == pEntities)
+	{
+		return(false);
+	}
+
+	double startTime = GetMilliseconds();
+	bool bBaked = false;
+	std::vector<glm::vec3> textureColors;
+	std::vector<SceneEntities::PREFAB_PART> parts;
+
+	PREFAB_IMPOSTOR empty;
+	empty.bBaked = false;
+	empty.minimum = glm::vec3(0.0f);
+	empty.maximum = glm::vec3(0.0f);
+	empty.partCount = 0;
+	empty.center = glm::vec3(0.0f);
+	empty.radius = 0.0f;
+	empty.size = 0;
+
+	int prefabCount = pEntities->GetPrefabCount();
+	m_impostors.resize(prefabCount, empty);
+	for (int prefab = 0; prefab < prefabCount; prefab++)
+	{
+		PREFAB_IMPOSTOR& impostor = m_impostors[prefab];
+		glm::vec3 minimum;
+		glm::vec3 maximum;
+		pEntities->GetPrefabParts(prefab, parts);
+		pEntities->GetPrefabBounds(prefab, minimum, maximum);
+		if ((int)parts.size() < m_settings.minParts)
+		{
+			impostor.bBaked = false;
+			continue;
+		}
+		if ((impostor.bBaked == true) && (impostor.partCount == (int)parts.size()) &&
+			(impostor.minimum == minimum) && (impostor.maximum == maximum))
+		{
+			continue;
+		}
+
+		// the average colors are only needed once something is
+		// baked
+		if (textureColors.empty() == true)
+		{
+			textureColors.resize(g_TextureSlots, glm::vec3(1.0f));
+			for (int slot = 0; slot < g_TextureSlots; slot++)
+			{
+				const SceneManager::TEXTURE_IMAGE* pImage = pSceneManager->GetTextureImage(slot);
+				if ((NULL == pImage) || (pImage->pixels.empty() == true))
+				{
+					continue;
+				}
+				double sum[3] = { 0.0, 0.0, 0.0 };
+				size_t pixelCount = pImage->pixels.size() / 4;
+				for (size_t i = 0; i < pixelCount; i++)
+				{
+					sum[0] += pImage->pixels[i * 4];
+					sum[1] += pImage->pixels[i * 4 + 1];
+					sum[2] += pImage->pixels[i * 4 + 2];
+				}
+				textureColors[slot] = glm::vec3(
+					(float)(sum[0] / (pixelCount * 255.0)),
+					(float)(sum[1] / (pixelCount * 255.0)),
+					(float)(sum[2] / (pixelCount * 255.0)));
+			}
+		}
+
+		impostor.minimum = minimum;
+		impostor.maximum = maximum;
+		impostor.partCount = (int)parts.size();
+		BakePrefab(parts, textureColors, impostor);
+		impostor.bBaked = true;
+		bBaked = true;
+	}
+
+	if (bBaked == true)
+	{
+		m_stats.prefabs = 0;
+		m_stats.bakedViews = 0;
+		m_stats.atlasBytes = 0;
+		for (size_t i = 0; i < m_impostors.size(); i++)
+		{
+			const PREFAB_IMPOSTOR& impostor = m_impostors[i];
+			if (impostor.bBaked == false)
+			{
+				continue;
+			}
+			m_stats.prefabs++;
+			m_stats.bakedViews += m_settings.views * m_settings.views;
+			m_stats.atlasBytes += impostor.colors.size() + impostor.normals.size() +
+				impostor.depths.size() * sizeof(uint16_t) + impostor.materials.size();
+		}
+		m_stats.bakeMilliseconds = GetMilliseconds() - startTime;
+	}
+	return(bBaked);
+}
+
+/***********************************************************
+ *  BakePrefab()
+ *
+ *  This method is used for rendering the parts of a prefab
+ *  into each view of its atlases.  A view looks at the
+ *  sphere around the parts from its direction with an
+ *  orthographic camera just wide enough for the sphere, and
+ *  each texel keeps the surface closest to the viewer.
+ ***********************************************************/
+void ImpostorAtlas::BakePrefab(
+	const std::vector<SceneEntities::PREFAB_PART>& parts,
+	const std::vector<glm::vec3>& textureColors,
+	PREFAB_IMPOSTOR& impostor)
+{
+	const int views = m_settings.views;
+	const int resolution = m_settings.resolution;
+	impostor.center = (impostor.minimum + impostor.maximum) * 0.5f;
+	impostor.radius = std::max(glm::length(impostor.maximum - impostor.minimum) * 0.5f, 1.0e-4f);
+	impostor.size = views * resolution;
+
+	size_t texelCount = (size_t)impostor.size * impostor.size;
+	impostor.colors.assign(texelCount * 4, 0);
+	impostor.normals.assign(texelCount * 4, 0);
+	impostor.depths.assign(texelCount, 0);
+	impostor.materials.assign(texelCount, NO_MATERIAL);
+
+	const float invRadius = 1.0f / impostor.radius;
+	std::vector<float> viewDepths((size_t)resolution * resolution);
+
+	for (int viewY = 0; viewY < views; viewY++)
+	{
+		for (int viewX = 0; viewX < views; viewX++)
+		{
+			glm::vec3 direction = GetViewDirection(viewX, viewY);
+			glm::vec3 right;
+			glm::vec3 up;
+			GetViewAxes(direction, right, up);
+			std::fill(viewDepths.begin(), viewDepths.end(), -1.0e30f);
+
+			for (size_t i = 0; i < parts.size(); i++)
+			{
+				const SceneEntities::PREFAB_PART& part = parts[i];
+				glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(part.local)));
+
+				// the color a part is drawn with, as the renderers
+				// choose it
+				bool bTextured = (part.bUseTexture == true) && (part.textureSlot >= 0) &&
+					(part.textureSlot < (int)textureColors.size());
+				glm::vec4 color = part.color;
+				if (bTextured == true)
+				{
+					color = glm::vec4(textureColors[part.textureSlot], 1.0f);
+				}
+				unsigned char material = NO_MATERIAL;
+				if ((part.materialIndex >= 0) && (part.materialIndex < NO_MATERIAL))
+				{
+					material = (unsigned char)part.materialIndex;
+				}
+
+				for (int p = 0; p < PrimitiveGeometry::PART_INDEX_COUNT; p++)
+				{
+					PrimitiveGeometry::PART_INDEX partIndex = (PrimitiveGeometry::PART_INDEX)p;
+					if (PrimitiveGeometry::IsPartDrawn(part.mesh, partIndex, part.parts) == false)
+					{
+						continue;
+					}
+					const PrimitiveGeometry::MESH_DATA& mesh = m_geometry.GetMeshPart(part.mesh, partIndex);
+					for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3)
+					{
+						// the corners in texels of the view, with their
+						// depth towards the viewer in radii
+						glm::vec2 screen[3];
+						float depth[3];
+						glm::vec3 normal[3];
+						for (int k = 0; k < 3; k++)
+						{
+							const PrimitiveGeometry::MESH_VERTEX& vertex = mesh.vertices[mesh.indices[t + k]];
+							glm::vec3 offset = glm::vec3(part.local * glm::vec4(vertex.position, 1.0f)) - impostor.center;
+							screen[k].x = (glm::dot(offset, right) * invRadius * 0.5f + 0.5f) * resolution;
+							screen[k].y = (0.5f - glm::dot(offset, up) * invRadius * 0.5f) * resolution;
+							depth[k] = glm::dot(offset, direction) * invRadius;
+							normal[k] = normalMatrix * vertex.normal;
+						}
+
+						float area = EdgeFunction(screen[0], screen[1], screen[2]);
+						if (std::fabs(area) < 1.0e-12f)
+						{
+							continue;
+						}
+						float invArea = 1.0f / area;
+						int minX = std::max(0, (int)std::floor(std::min(std::min(screen[0].x, screen[1].x), screen[2].x)));
+						int minY = std::max(0, (int)std::floor(std::min(std::min(screen[0].y, screen[1].y), screen[2].y)));
+						int maxX = std::min(resolution - 1, (int)std::floor(std::max(std::max(screen[0].x, screen[1].x), screen[2].x)));
+						int maxY = std::min(resolution - 1, (int)std::floor(std::max(std::max(screen[0].y, screen[1].y), screen[2].y)));
+
+						for (int y = minY; y <= maxY; y++)
+						{
+							for (int x = minX; x <= maxX; x++)
+							{
+								// dividing by the area makes the weights of
+								// either winding positive inside
+								glm::vec2 center((float)x + 0.5f, (float)y + 0.5f);
+								float w0 = EdgeFunction(screen[1], screen[2], center) * invArea;
+								float w1 = EdgeFunction(screen[2], screen[0], center) * invArea;
+								float w2 = 1.0f - w0 - w1;
+								if ((w0 < 0.0f) || (w1 < 0.0f) || (w2 < 0.0f))
+								{
+									continue;
+								}
+								float texelDepth = depth[0] * w0 + depth[1] * w1 + depth[2] * w2;
+								float& closest = viewDepths[(size_t)y * resolution + x];
+								if (texelDepth <= closest)
+								{
+									continue;
+								}
+								closest = texelDepth;
+
+								size_t texel = ((size_t)viewY * resolution + y) * impostor.size + (size_t)viewX * resolution + x;
+								glm::vec3 texelNormal = glm::normalize(normal[0] * w0 + normal[1] * w1 + normal[2] * w2);
+								for (int c = 0; c < 4; c++)
+								{
+									impostor.colors[texel * 4 + c] = (unsigned char)(glm::clamp(color[c], 0.0f, 1.0f) * 255.0f + 0.5f);
+								}
+								for (int c = 0; c < 3; c++)
+								{
+									impostor.normals[texel * 4 + c] = (unsigned char)((texelNormal[c] * 0.5f + 0.5f) * 255.0f + 0.5f);
+								}
+								impostor.normals[texel * 4 + 3] = (bTextured == true) ? TEXTURED_TEXEL : 0;
+								impostor.depths[texel] = (uint16_t)(glm::clamp(texelDepth * 0.5f + 0.5f, 0.0f, 1.0f) * 65535.0f + 0.5f);
+								impostor.materials[texel] = material;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  HasImpostor()
+ *
+ *  This method is used for checking whether a prefab has a
+ *  baked impostor.
+ ***********************************************************/
+bool ImpostorAtlas::HasImpostor(int prefab) const
+{
+	return(NULL != GetImpostor(prefab));
+}
+
+/***********************************************************
+ *  GetImpostor()
+ *
+ *  This method is used for getting the atlases of a prefab,
+ *  or NULL when it has too few parts or is not yet baked.
+ ***********************************************************/
+const ImpostorAtlas::PREFAB_IMPOSTOR* ImpostorAtlas::GetImpostor(int prefab) const
+{
+	if ((prefab < 0) || (prefab >= (int)m_impostors.size()) || (m_impostors[prefab].bBaked == false))
+	{
+		return(NULL);
+	}
+	return(&m_impostors[prefab]);
+}
+
+/***********************************************************
+ *  GetViewDirection()
+ *
+ *  This method is used for getting the direction of a view
+ *  of the atlas.  The views cover a square that the upper
+ *  half of the octahedral mapping turns into directions of
+ *  the hemisphere above the prefab, with the top view in the
+ *  middle and the horizon around the edges.
+ ***********************************************************/
+glm::vec3 ImpostorAtlas::GetViewDirection(int viewX, int viewY) const
+{
+	float u = ((float)viewX + 0.5f) / m_settings.views * 2.0f - 1.0f;
+	float v = ((float)viewY + 0.5f) / m_settings.views * 2.0f - 1.0f;
+	float x = (u + v) * 0.5f;
+	float z = (u - v) * 0.5f;
+	return(glm::normalize(glm::vec3(x, 1.0f - std::fabs(x) - std::fabs(z), z)));
+}
+
+/***********************************************************
+ *  FindView()
+ *
+ *  This method is used for finding the view of the atlas
+ *  closest to a direction, the inverse of the mapping in
+ *  GetViewDirection().  Directions from below are taken from
+ *  the horizon, since the views only cover the hemisphere.
+ ***********************************************************/
+void ImpostorAtlas::FindView(const glm::vec3& direction, int& viewX, int& viewY) const
+{
+	glm::vec3 upper(direction.x, std::max(direction.y, 0.0f), direction.z);
+	float sum = std::fabs(upper.x) + upper.y + std::fabs(upper.z);
+	if (sum <= 0.0f)
+	{
+		upper = glm::vec3(0.0f, 1.0f, 0.0f);
+		sum = 1.0f;
+	}
+	float x = upper.x / sum;
+	float z = upper.z / sum;
+	float u = x + z;
+	float v = x - z;
+	viewX = glm::clamp((int)((u * 0.5f + 0.5f) * m_settings.views), 0, m_settings.views - 1);
+	viewY = glm::clamp((int)((v * 0.5f + 0.5f) * m_settings.views), 0, m_settings.views - 1);
+}
+
+/***********************************************************
+ *  GetViewAxes()
+ *
+ *  This method is used for getting the axes across and up
+ *  the texels of a view, which keep up towards the sky
+ *  except when looking straight down.
+ ***********************************************************/
+void ImpostorAtlas::GetViewAxes(const glm::vec3& direction, glm::vec3& right, glm::vec3& up)
+{
+	glm::vec3 reference(0.0f, 1.0f, 0.0f);
+	if (std::fabs(direction.y) > 0.999f)
+	{
+		reference = glm::vec3(0.0f, 0.0f, -1.0f);
+	}
+	right = glm::normalize(glm::cross(reference, direction));
+	up = glm::cross(direction, right);
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the size of the atlases
+ *  and the work of baking them.
+ ***********************************************************/
+const ImpostorAtlas::IMPOSTOR_STATS& ImpostorAtlas::GetStats() const
+{
+	return(m_stats);
+}
@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////////////
+// impostoratlas.h
+// ============
+// pre-render prefabs from many directions for drawing far instances as quads
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+#include "SceneEntities.h"
+#include "PrimitiveGeometry.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  ImpostorAtlas
+ *
+ *  This class keeps an impostor for each prefab made of
+ *  several parts.  The prefab is rendered from a hemisphere
+ *  of view directions laid out in a square by the octahedral
+ *  mapping, one cell of the atlas for each direction.  Every
+ *  texel keeps the surface color, normal, material and depth
+ *  instead of a finished image, so a far instance drawn as a
+ *  single quad is lit by the lights of the scene like the
+ *  parts it stands in for.
+ ***********************************************************/
+class ImpostorAtlas
+{
+public:
+	// constructor
+	ImpostorAtlas();
+
+	// properties for the size of the atlases and the distance
+	// they take over at
+	struct IMPOSTOR_SETTINGS
+	{
+		// view directions across each side of an atlas
+		int views;
+		// texels across each side of a view
+		int resolution;
+		// distance from the camera beyond which instances are
+		// drawn as impostors
+		float distance;
+		// fewest parts a prefab needs to get an impostor
+		int minParts;
+	};
+
+	// properties for the atlases of one prefab, with the views
+	// of the directions side by side and rows top first
+	struct PREFAB_IMPOSTOR
+	{
+		bool bBaked;
+		// box around the parts when baked, to tell when the
+		// prefab was replaced
+		glm::vec3 minimum;
+		glm::vec3 maximum;
+		int partCount;
+		// sphere around the parts in the prefab's local space
+		glm::vec3 center;
+		float radius;
+		// texels across each side of the whole atlas
+		int size;
+		// surface color and coverage of each texel
+		std::vector<unsigned char> colors;
+		// local space normal of each texel, mapped to 0 to 255,
+		// with whether the color came from a texture
+		std::vector<unsigned char> normals;
+		// distance of each texel towards the view from the
+		// center, in radii mapped to 0 to 65535
+		std::vector<uint16_t> depths;
+		// material of each texel, or NO_MATERIAL
+		std::vector<unsigned char> materials;
+	};
+
+	// properties for the size of the atlases and the work of
+	// baking them
+	struct IMPOSTOR_STATS
+	{
+		int prefabs;
+		int bakedViews;
+		size_t atlasBytes;
+		double bakeMilliseconds;
+	};
+
+	// material of texels that have none
+	static const unsigned char NO_MATERIAL = 255;
+	// normal flag of texels whose color came from a texture
+	static const unsigned char TEXTURED_TEXEL = 255;
+
+private:
+	IMPOSTOR_SETTINGS m_settings;
+	std::vector<PREFAB_IMPOSTOR> m_impostors;
+	// CPU copies of the basic shape meshes
+	PrimitiveGeometry m_geometry;
+	IMPOSTOR_STATS m_stats;
+
+	// render the parts of a prefab into its atlases
+	void BakePrefab(
+		const std::vector<SceneEntities::PREFAB_PART>& parts,
+		const std::vector<glm::vec3>& textureColors,
+		PREFAB_IMPOSTOR& impostor);
+
+public:
+	// set the size of the atlases and the distance they take
+	// over at, baking them all again
+	void SetSettings(const IMPOSTOR_SETTINGS& settings);
+	// get the size of the atlases and the distance they take
+	// over at
+	const IMPOSTOR_SETTINGS& GetSettings() const;
+	// bake the prefabs of a scene that have no atlas yet, or
+	// changed since they were baked, returning whether any were
+	bool Bake(const SceneManager* pSceneManager);
+	// check whether a prefab has a baked impostor
+	bool HasImpostor(int prefab) const;
+	// get the impostor of a prefab, or NULL when it has none
+	const PREFAB_IMPOSTOR* GetImpostor(int prefab) const;
+
+	// get the direction of a view of the atlas, pointing from
+	// the prefab towards the viewer
+	glm::vec3 GetViewDirection(int viewX, int viewY) const;
+	// get the view of the atlas closest to a direction
+	void FindView(const glm::vec3& direction, int& viewX, int& viewY) const;
+	// get the axes a view is rendered along, in local space
+	static void GetViewAxes(const glm::vec3& direction, glm::vec3& right, glm::vec3& up);
+
+	// get the size of the atlases and the work of baking them
+	const IMPOSTOR_STATS& GetStats() const;
+};
@@ -1,5 +1,10 @@
 #include <iostream>         // error handling and output
 #include <cstdlib>          // EXIT_FAILURE
+#include <cstring>          // command line option parsing
+#include <algorithm>        // std::max
+#include <string>           // render farm image names
+#include <thread>           // render farm worker threads
+#include <chrono>           // video stream frame rate
 
 #include <GL/glew.h>        // GLEW library
 #include "GLFW/glfw3.h"     // GLFW library
@@ -13,6 +18,24 @@
 #include "ViewManager.h"
 #include "ShapeMeshes.h"
 #include "ShaderManager.h"
+#include "RenderBenchmark.h"
+#include "SoftwareRasterizer.h"
+#include "PathTracer.h"
+#include "CameraPath.h"
+#include "RenderFarm.h"
+#include "TiledRenderer.h"
+#include "FrameCapture.h"
+#include "VideoStream.h"
+#include "RenderServer.h"
+#include "DrawListCache.h"
+#include "AnimationSystem.h"
+#include "ParticleSystem.h"
+#include "SceneEntities.h"
+#include "SceneQuery.h"
+#include "CameraCollider.h"
+#ifdef USE_VULKAN
+#include "VulkanRenderDevice.h"
+#endif
 
 // Namespace for declaring global variables
 namespace
@@ -35,6 +58,39 @@ namespace
 // need to be pre-declared at the beginning of the source code.
 bool InitializeGLFW();
 bool InitializeGLEW();
+void ProcessSceneOptions(SceneManager* pSceneManager, int argc, char* argv[]);
+void GetHeadlessOptions(int argc, char* argv[], int& width, int& height, int& threads);
+void CreateHeadlessScene(int argc, char* argv[], RenderDevice* pRenderDevice = NULL);
+void DestroyHeadlessScene();
+const char* GetCaptureOptions(int argc, char* argv[], int& encoderThreads);
+bool OpenVideoStream(int argc, char* argv[], VideoStream& stream);
+const char* GetCameraPathFile(int argc, char* argv[]);
+const char* GetRenderServerOptions(int argc, char* argv[], int& batchSize);
+bool GetStressSettings(int argc, char* argv[], StressSceneGenerator::STRESS_SETTINGS& settings);
+const char* GetStressSweepOptions(int argc, char* argv[], int& maxObjects);
+bool GetWorldSettings(int argc, char* argv[], WorldStreamer::WORLD_SETTINGS& settings);
+void PrintWorldStreamingStats();
+double GetAnimationTime(int argc, char* argv[]);
+void PrintAnimationStats();
+void PrintParticleStats();
+int RunWriteWorld(int argc, char* argv[]);
+int RunTransformReport(int argc, char* argv[]);
+void GetPixelRay(const glm::mat4& view, const glm::mat4& projection, float x, float y, int width, int height, glm::vec3& origin, glm::vec3& direction);
+int RunPick(int argc, char* argv[]);
+int RunCameraWalk(int argc, char* argv[]);
+int GetTileSize(int argc, char* argv[]);
+int RunSoftwareRender(int argc, char* argv[]);
+int RunSoftwareTiledRender(int argc, char* argv[], const char* outputFile, int tileSize);
+int RunSoftwareVideo(int argc, char* argv[], VideoStream& stream);
+int RunSoftwareRenderServer(int argc, char* argv[], const char* socketPath, int batchSize);
+int RunSoftwareStressSweep(int argc, char* argv[], const char* csvFile, int maxObjects, int frames);
+int RunPathTrace(int argc, char* argv[]);
+bool GetRenderFarmOptions(int argc, char* argv[], CameraPath& path, int& firstFrame, int& lastFrame, int& workers, const char*& outputPattern);
+int RunRenderFarm(int argc, char* argv[]);
+int RunFarmWorker(int argc, char* argv[]);
+#ifdef USE_VULKAN
+int RunVulkanRender(int argc, char* argv[]);
+#endif
 
 
 /***********************************************************
@@ -45,12 +101,88 @@ bool InitializeGLEW();
  ***********************************************************/
 int main(int argc, char* argv[])
 {
+	// render with the CPU rasterizer, the path tracer or the
+	// Vulkan device when requested, which need no window or
+	// OpenGL context at all
+	for (int i = 1; i < argc; i++)
+	{
+		// a render farm worker is started with the options of
+		// the farm, so it has to be found before them
+		if (strcmp(argv[i], "--farm-worker") == 0)
+		{
+			return(RunFarmWorker(argc, argv));
+		}
+	}
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--software-render") == 0)
+		{
+			return(RunSoftwareRender(argc, argv));
+		}
+		if (strcmp(argv[i], "--path-trace") == 0)
+		{
+			return(RunPathTrace(argc, argv));
+		}
+		if (strcmp(argv[i], "--render-farm") == 0)
+		{
+			return(RunRenderFarm(argc, argv));
+		}
+		if (strcmp(argv[i], "--write-world") == 0)
+		{
+			return(RunWriteWorld(argc, argv));
+		}
+		if (strcmp(argv[i], "--transform-report") == 0)
+		{
+			return(RunTransformReport(argc, argv));
+		}
+		if (strcmp(argv[i], "--pick") == 0)
+		{
+			return(RunPick(argc, argv));
+		}
+		if (strcmp(argv[i], "--camera-walk") == 0)
+		{
+			return(RunCameraWalk(argc, argv));
+		}
+#ifdef USE_VULKAN
+		if (strcmp(argv[i], "--vulkan") == 0)
+		{
+			return(RunVulkanRender(argc, argv));
+		}
+#endif
+	}
+
+	// the video stream is opened before anything is printed,
+	// since it may take over the standard output
+	VideoStream videoStream;
+	if (OpenVideoStream(argc, argv, videoStream) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
 	// if GLFW fails initialization, then terminate the application
 	if (InitializeGLFW() == false)
 	{
 		return(EXIT_FAILURE);
 	}
 
+	// a render server draws only into its own framebuffers,
+	// so its window is never shown
+	int serverBatchSize = 0;
+	const char* serverSocket = GetRenderServerOptions(argc, argv, serverBatchSize);
+	if (NULL != serverSocket)
+	{
+		glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+	}
+
+	// sRGB textures need a window that can write sRGB colors
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--texture-srgb") == 0)
+		{
+			glfwWindowHint(GLFW_SRGB_CAPABLE, GL_TRUE);
+		}
+	}
+
 	// try to create a new shader manager object
 	g_ShaderManager = new ShaderManager();
 	// try to create a new view manager object
@@ -74,8 +206,151 @@ int main(int argc, char* argv[])
 
 	// try to create a new scene manager object and prepare the 3D scene
 	g_SceneManager = new SceneManager(g_ShaderManager);
+	// the view is set through the same render device as the scene
+	g_ViewManager->SetRenderDevice(g_SceneManager->GetRenderDevice());
+	g_ViewManager->SetSceneManager(g_SceneManager);
+
+	// process the command line options for the scene
+	ProcessSceneOptions(g_SceneManager, argc, argv);
+	bool bSamplerBenchmark = false;
+	bool bDecoderBenchmark = false;
+	int stressMaxObjects = 0;
+	const char* stressSweepFile = GetStressSweepOptions(argc, argv, stressMaxObjects);
+	const char* tiledImageFile = NULL;
+	int encoderThreads = 0;
+	const char* capturePattern = GetCaptureOptions(argc, argv, encoderThreads);
+	for (int i = 1; i < argc; i++)
+	{
+		// compare the texture sampler presets and then exit
+		if (strcmp(argv[i], "--benchmark-samplers") == 0)
+		{
+			bSamplerBenchmark = true;
+		}
+		// compare the image decoder backends and then exit
+		else if (strcmp(argv[i], "--benchmark-decoders") == 0)
+		{
+			bDecoderBenchmark = true;
+		}
+		// render a still larger than the window and then exit
+		else if (strcmp(argv[i], "--tiled-render") == 0)
+		{
+			tiledImageFile = "tiled.ppm";
+			if ((i + 1 < argc) && (strncmp(argv[i + 1], "--", 2) != 0))
+			{
+				tiledImageFile = argv[++i];
+			}
+		}
+		// start with the four preset views shown at once
+		else if (strcmp(argv[i], "--quad-view") == 0)
+		{
+			g_ViewManager->SetQuadView(true);
+		}
+	}
+
 	g_SceneManager->PrepareScene();
 
+	// run the requested benchmarks instead of the interactive loop
+	if (bSamplerBenchmark == true)
+	{
+		RenderBenchmark* pBenchmark = new RenderBenchmark(
+			g_SceneManager,
+			g_ViewManager,
+			g_Window);
+		pBenchmark->RunSamplerBenchmark();
+		delete pBenchmark;
+
+		glfwSetWindowShouldClose(g_Window, true);
+	}
+	if (bDecoderBenchmark == true)
+	{
+		std::vector<std::string> textureFiles;
+		SceneManager::GetSceneTextureFiles(textureFiles);
+		RenderBenchmark::RunDecoderBenchmark(textureFiles);
+
+		glfwSetWindowShouldClose(g_Window, true);
+	}
+	if (NULL != stressSweepFile)
+	{
+		StressSceneGenerator::STRESS_SETTINGS stressSettings;
+		GetStressSettings(argc, argv, stressSettings);
+		RenderBenchmark* pBenchmark = new RenderBenchmark(
+			g_SceneManager,
+			g_ViewManager,
+			g_Window);
+		pBenchmark->RunStressSweep(stressSettings, stressMaxObjects, stressSweepFile);
+		delete pBenchmark;
+
+		glfwSetWindowShouldClose(g_Window, true);
+	}
+	if (NULL != tiledImageFile)
+	{
+		int width = 0;
+		int height = 0;
+		int threads = 0;
+		GetHeadlessOptions(argc, argv, width, height, threads);
+		int tileSize = GetTileSize(argc, argv);
+		if (g_ViewManager->SaveTiledImage(g_SceneManager, tiledImageFile, width, height, tileSize) == true)
+		{
+			std::cout << "INFO: wrote " << tiledImageFile << " at " << width << "x" << height << std::endl;
+		}
+		else
+		{
+			std::cout << "ERROR: could not write " << tiledImageFile << std::endl;
+		}
+
+		glfwSetWindowShouldClose(g_Window, true);
+	}
+	if (NULL != serverSocket)
+	{
+		RenderServer server(g_SceneManager, NULL);
+		server.SetMaxBatchSize(serverBatchSize);
+		if (server.Run(serverSocket) == false)
+		{
+			std::cout << "ERROR: could not run the render server on " << serverSocket << std::endl;
+		}
+
+		glfwSetWindowShouldClose(g_Window, true);
+	}
+
+	// play back a camera path instead of the interactive camera
+	CameraPath cameraPath;
+	const char* cameraPathFile = GetCameraPathFile(argc, argv);
+	if ((NULL != cameraPathFile) && (cameraPath.LoadFile(cameraPathFile) == true))
+	{
+		g_ViewManager->SetCameraPath(&cameraPath);
+	}
+
+	// record every frame drawn into the window, either to a
+	// video stream or to numbered image files
+	FrameCapture* pCapture = NULL;
+	if ((videoStream.IsOpen() == true) || (NULL != capturePattern))
+	{
+		int framebufferWidth = 0;
+		int framebufferHeight = 0;
+		glfwGetFramebufferSize(g_Window, &framebufferWidth, &framebufferHeight);
+		pCapture = new FrameCapture();
+
+		bool bStarted = false;
+		if (videoStream.IsOpen() == true)
+		{
+			bStarted = pCapture->StartStream(&videoStream, framebufferWidth, framebufferHeight, 0);
+			if (pCapture->IsConvertingOnGPU() == true)
+			{
+				std::cout << "INFO: converting video frames to Y4M on the GPU" << std::endl;
+			}
+		}
+		else
+		{
+			bStarted = pCapture->Start(capturePattern, framebufferWidth, framebufferHeight, 0, encoderThreads);
+		}
+		if (bStarted == false)
+		{
+			std::cout << "ERROR: could not start capturing frames" << std::endl;
+			delete pCapture;
+			pCapture = NULL;
+		}
+	}
+
 	std::cout << "\n*** KEY FUNCTIONS: ***\n";
 	std::cout << "ESC - close the window and exit\n";
 	std::cout << "W - zoom in\t" << "S - zoom out\n";
@@ -85,6 +360,7 @@ int main(int argc, char* argv[])
 	std::cout << "2 - side view (ortho)\n";
 	std::cout << "3 - top view (ortho)\n";
 	std::cout << "4 - perspective view\n";
+	std::cout << "5 - all four views\n";
 
 	// loop will keep running until the application is closed 
 	// or until an error has occurred
@@ -103,6 +379,17 @@ int main(int argc, char* argv[])
 		// refresh the 3D scene
 		g_SceneManager->RenderScene();
 
+		// queue the frame for recording before it is shown
+		if (NULL != pCapture)
+		{
+			pCapture->CaptureFrame();
+		}
+
+		// a recorded camera path ends with its last frame
+		if (g_ViewManager->IsCameraPathFinished() == true)
+		{
+			glfwSetWindowShouldClose(g_Window, true);
+		}
 
 		// Flips the the back buffer with the front buffer every frame.
 		glfwSwapBuffers(g_Window);
@@ -111,6 +398,35 @@ int main(int argc, char* argv[])
 		glfwPollEvents();
 	}
 
+	// write the frames still being recorded
+	if (NULL != pCapture)
+	{
+		pCapture->Stop();
+		const FrameCapture::CAPTURE_STATS& captureStats = pCapture->GetStats();
+		FrameEncoder::ENCODER_STATS encoderStats = pCapture->GetEncoderStats();
+		std::cout << "INFO: captured " << encoderStats.encodedFrames << "/" << captureStats.frames
+			<< " frames, " << captureStats.readbackMilliseconds / std::max(captureStats.frames, 1)
+			<< " ms per frame in the render loop, " << captureStats.ringStalls << " readback stalls, "
+			<< encoderStats.stalls << " encoder stalls" << std::endl;
+		if (videoStream.IsOpen() == true)
+		{
+			std::cout << "INFO: streamed " << videoStream.GetFrameCount() << " video frames" << std::endl;
+		}
+		delete pCapture;
+		pCapture = NULL;
+	}
+	videoStream.Close();
+	g_ViewManager->SetCameraPath(NULL);
+
+	// report how often the preset views reused their draw lists
+	const DrawListCache::CACHE_STATS& drawListStats = g_SceneManager->GetDrawListCache()->GetStats();
+	if (drawListStats.rebuilds > 0)
+	{
+		std::cout << "INFO: preset view draw lists reused in " << drawListStats.hits
+			<< " frames, built " << drawListStats.rebuilds << " times, "
+			<< drawListStats.culledDraws << " draws culled" << std::endl;
+	}
+
 	// clear the allocated manager objects from memory
 	if (NULL != g_SceneManager)
 	{
@@ -184,4 +500,1769 @@ bool InitializeGLEW()
 	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
 
 	return(true);
-}
\ No newline at end of file
+}
+
+/***********************************************************
+ *	ProcessSceneOptions()
+ *
+ *  This function is used to apply the command line options
+ *  that change how the scene is prepared.
+ ***********************************************************/
+void ProcessSceneOptions(SceneManager* pSceneManager, int argc, char* argv[])
+{
+	bool bCameraCollision = false;
+	float cameraRadius = 0.3f;
+	glm::vec3 cameraBoundsMin(1.0f);
+	glm::vec3 cameraBoundsMax(-1.0f);
+	float impostorDistance = -1.0f;
+	int impostorViews = 0;
+	int impostorResolution = 0;
+	int textureCap = 0;
+	bool bTextureSRGB = false;
+	bool bCompactFormats = true;
+	for (int i = 1; i < argc; i++)
+	{
+		// generate the wood, cheese and metal textures in code,
+		// optionally followed by the texture resolution
+		if (strcmp(argv[i], "--procedural-textures") == 0)
+		{
+			int resolution = 0;
+			if ((i + 1 < argc) && (atoi(argv[i + 1]) > 0))
+			{
+				resolution = atoi(argv[++i]);
+			}
+			pSceneManager->SetProceduralTextures(true, resolution);
+		}
+		// keep uncompressed copies of the decoded textures on disk
+		else if (strcmp(argv[i], "--texture-cache") == 0)
+		{
+			pSceneManager->SetRawTextureCache(true);
+		}
+		// upload no texture wider or taller than this, within
+		// the cap of the device
+		else if ((strcmp(argv[i], "--texture-cap") == 0) && (i + 1 < argc))
+		{
+			textureCap = atoi(argv[++i]);
+		}
+		// upload the color textures in the sRGB color space
+		else if (strcmp(argv[i], "--texture-srgb") == 0)
+		{
+			bTextureSRGB = true;
+		}
+		// keep every texture in its RGB or RGBA format instead of
+		// repacking grayscale and opaque images
+		else if (strcmp(argv[i], "--texture-full-formats") == 0)
+		{
+			bCompactFormats = false;
+		}
+		// map the asset files read-only instead of reading them
+		else if (strcmp(argv[i], "--map-assets") == 0)
+		{
+			pSceneManager->SetMappedAssets(true);
+		}
+		// draw the scene objects from entities kept between frames
+		else if (strcmp(argv[i], "--entity-scene") == 0)
+		{
+			pSceneManager->SetEntityScene(true);
+		}
+		// place another book, wine glass or wine bottle, as
+		// <name> <x> <y> <z> optionally followed by the yaw in
+		// degrees, the scale and the tag of a material to use
+		else if ((strcmp(argv[i], "--place-prefab") == 0) && (i + 4 < argc))
+		{
+			SceneManager::PREFAB_PLACEMENT placement;
+			placement.prefab = argv[i + 1];
+			placement.position = glm::vec3(atof(argv[i + 2]), atof(argv[i + 3]), atof(argv[i + 4]));
+			placement.yawDegrees = 0.0f;
+			placement.scale = 1.0f;
+			i += 4;
+			if ((i + 1 < argc) && (strncmp(argv[i + 1], "--", 2) != 0))
+			{
+				placement.yawDegrees = (float)atof(argv[++i]);
+			}
+			if ((i + 1 < argc) && (strncmp(argv[i + 1], "--", 2) != 0))
+			{
+				placement.scale = (float)atof(argv[++i]);
+			}
+			if ((i + 1 < argc) && (strncmp(argv[i + 1], "--", 2) != 0))
+			{
+				placement.materialTag = argv[++i];
+			}
+			pSceneManager->PlacePrefab(placement);
+		}
+		// keep the entity transforms packed into 16 bytes each,
+		// optionally followed by the size of the position cells
+		else if (strcmp(argv[i], "--compact-transforms") == 0)
+		{
+			float cellSize = 0.0f;
+			if ((i + 1 < argc) && (atof(argv[i + 1]) > 0.0))
+			{
+				cellSize = (float)atof(argv[++i]);
+			}
+			pSceneManager->SetCompactTransforms(true, cellSize);
+		}
+		// move the entities and lights with keyframe tracks
+		else if (strcmp(argv[i], "--animate") == 0)
+		{
+			pSceneManager->SetSceneAnimation(true);
+		}
+		// add the pour, steam and dust particle effects,
+		// optionally followed by the most dust particles
+		else if (strcmp(argv[i], "--particles") == 0)
+		{
+			int dustBudget = 100000;
+			if ((i + 1 < argc) && (atoi(argv[i + 1]) > 0))
+			{
+				dustBudget = atoi(argv[++i]);
+			}
+			pSceneManager->SetParticleEffects(dustBudget);
+		}
+		// picking searches the entities, so the scene objects
+		// are drawn from entities as well
+		else if (strcmp(argv[i], "--pick") == 0)
+		{
+			pSceneManager->SetEntityScene(true);
+		}
+		// keep the camera out of the scene, optionally followed
+		// by the radius of the camera
+		else if (strcmp(argv[i], "--camera-collision") == 0)
+		{
+			bCameraCollision = true;
+			if ((i + 1 < argc) && (atof(argv[i + 1]) > 0.0))
+			{
+				cameraRadius = (float)atof(argv[++i]);
+			}
+		}
+		// keep the camera inside a box, as <minX> <minY> <minZ>
+		// <maxX> <maxY> <maxZ>, instead of the scene grown by a
+		// margin
+		else if ((strcmp(argv[i], "--camera-bounds") == 0) && (i + 6 < argc))
+		{
+			bCameraCollision = true;
+			cameraBoundsMin = glm::vec3(atof(argv[i + 1]), atof(argv[i + 2]), atof(argv[i + 3]));
+			cameraBoundsMax = glm::vec3(atof(argv[i + 4]), atof(argv[i + 5]), atof(argv[i + 6]));
+			i += 6;
+		}
+		// walking the camera tests its collision with the scene
+		else if (strcmp(argv[i], "--camera-walk") == 0)
+		{
+			bCameraCollision = true;
+		}
+		// draw far prefab instances as impostors, optionally
+		// followed by the distance they take over at
+		else if (strcmp(argv[i], "--impostors") == 0)
+		{
+			impostorDistance = 30.0f;
+			if ((i + 1 < argc) && (atof(argv[i + 1]) > 0.0))
+			{
+				impostorDistance = (float)atof(argv[++i]);
+			}
+		}
+		// bake the impostors as <views> <texels>, the views
+		// across each atlas and the texels across each view
+		else if ((strcmp(argv[i], "--impostor-atlas") == 0) && (i + 2 < argc))
+		{
+			impostorViews = atoi(argv[i + 1]);
+			impostorResolution = atoi(argv[i + 2]);
+			i += 2;
+		}
+	}
+
+	pSceneManager->SetTextureFormats(textureCap, bTextureSRGB, bCompactFormats);
+	if (bCameraCollision == true)
+	{
+		pSceneManager->SetCameraCollision(cameraRadius, cameraBoundsMin, cameraBoundsMax);
+	}
+	if (impostorDistance >= 0.0f)
+	{
+		pSceneManager->SetImpostors(impostorDistance, impostorViews, impostorResolution);
+	}
+
+	// replace the scene objects with a generated scene
+	StressSceneGenerator::STRESS_SETTINGS stressSettings;
+	if (GetStressSettings(argc, argv, stressSettings) == true)
+	{
+		pSceneManager->SetStressScene(stressSettings);
+	}
+
+	// stream a world of tables around the camera instead
+	WorldStreamer::WORLD_SETTINGS worldSettings;
+	if (GetWorldSettings(argc, argv, worldSettings) == true)
+	{
+		pSceneManager->SetStreamWorld(worldSettings);
+	}
+}
+
+/***********************************************************
+ *	GetHeadlessOptions()
+ *
+ *  This function is used to get the image size and thread
+ *  count shared by the CPU renderers, from the options
+ *  --resolution <width> <height> and --threads <count>.
+ ***********************************************************/
+void GetHeadlessOptions(int argc, char* argv[], int& width, int& height, int& threads)
+{
+	width = 1000;
+	height = 800;
+	threads = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--resolution") == 0) && (i + 2 < argc))
+		{
+			width = atoi(argv[++i]);
+			height = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--threads") == 0) && (i + 1 < argc))
+		{
+			threads = atoi(argv[++i]);
+		}
+	}
+}
+
+/***********************************************************
+ *	CreateHeadlessScene()
+ *
+ *  This function is used to prepare the scene without a
+ *  shader manager, so it keeps its draws and textures in
+ *  memory instead of sending them to OpenGL.  A passed in
+ *  render device is given to the scene manager, which takes
+ *  ownership of it, before the scene is prepared.  An
+ *  animated scene starts at the time of --animation-time.
+ ***********************************************************/
+void CreateHeadlessScene(int argc, char* argv[], RenderDevice* pRenderDevice)
+{
+	g_ViewManager = new ViewManager(NULL);
+	g_SceneManager = new SceneManager(NULL);
+	if (NULL != pRenderDevice)
+	{
+		g_SceneManager->SetRenderDevice(pRenderDevice);
+	}
+	ProcessSceneOptions(g_SceneManager, argc, argv);
+	g_SceneManager->PrepareScene();
+	g_SceneManager->UpdateAnimation(GetAnimationTime(argc, argv));
+}
+
+/***********************************************************
+ *	DestroyHeadlessScene()
+ *
+ *  This function is used to free the headless scene.
+ ***********************************************************/
+void DestroyHeadlessScene()
+{
+	delete g_SceneManager;
+	g_SceneManager = NULL;
+	delete g_ViewManager;
+	g_ViewManager = NULL;
+}
+
+/***********************************************************
+ *	GetCaptureOptions()
+ *
+ *  This function is used to get the file name pattern that
+ *  recorded frames are written with, from the option
+ *  --capture [pattern], along with --capture-threads <count>
+ *  for the number of encoder threads.  A .png pattern writes
+ *  PNG files and anything else QOI, and NULL is returned when
+ *  frames are not being recorded.
+ ***********************************************************/
+const char* GetCaptureOptions(int argc, char* argv[], int& encoderThreads)
+{
+	const char* pattern = NULL;
+	encoderThreads = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--capture") == 0)
+		{
+			pattern = "capture_####.qoi";
+			if ((i + 1 < argc) && (strncmp(argv[i + 1], "--", 2) != 0))
+			{
+				pattern = argv[++i];
+			}
+		}
+		else if ((strcmp(argv[i], "--capture-threads") == 0) && (i + 1 < argc))
+		{
+			encoderThreads = atoi(argv[++i]);
+		}
+	}
+	return(pattern);
+}
+
+/***********************************************************
+ *	OpenVideoStream()
+ *
+ *  This function is used to open the video stream given by
+ *  --video <file, pipe or - for standard output>, along with
+ *  --video-format <y4m or rgba> and --fps <rate>.  It returns
+ *  false only when a stream was asked for and not opened.
+ ***********************************************************/
+bool OpenVideoStream(int argc, char* argv[], VideoStream& stream)
+{
+	const char* target = NULL;
+	VideoStream::STREAM_FORMAT format = VideoStream::FORMAT_Y4M;
+	int framesPerSecond = 30;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--video") == 0) && (i + 1 < argc))
+		{
+			target = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--video-format") == 0) && (i + 1 < argc))
+		{
+			if (VideoStream::GetFormat(argv[++i], format) == false)
+			{
+				std::cerr << "ERROR: unknown video format " << argv[i] << std::endl;
+				return(false);
+			}
+		}
+		else if ((strcmp(argv[i], "--fps") == 0) && (i + 1 < argc))
+		{
+			framesPerSecond = atoi(argv[++i]);
+		}
+	}
+
+	if (NULL == target)
+	{
+		return(true);
+	}
+	if (stream.Open(target, format, framesPerSecond) == false)
+	{
+		std::cerr << "ERROR: could not open video stream " << target << std::endl;
+		return(false);
+	}
+	return(true);
+}
+
+/***********************************************************
+ *	GetCameraPathFile()
+ *
+ *  This function is used to get the camera path file to
+ *  play back, from the option --camera-path <file>.
+ ***********************************************************/
+const char* GetCameraPathFile(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--camera-path") == 0) && (i + 1 < argc))
+		{
+			return(argv[i + 1]);
+		}
+	}
+	return(NULL);
+}
+
+/***********************************************************
+ *	GetRenderServerOptions()
+ *
+ *  This function is used to get the socket path that the
+ *  render server listens on, from the option
+ *  --render-server <socket>, along with --batch-size <count>
+ *  for the most requests rendered together.  NULL is returned
+ *  when the program is not serving renders.
+ ***********************************************************/
+const char* GetRenderServerOptions(int argc, char* argv[], int& batchSize)
+{
+	const char* socketPath = NULL;
+	batchSize = 64;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--render-server") == 0) && (i + 1 < argc))
+		{
+			socketPath = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--batch-size") == 0) && (i + 1 < argc))
+		{
+			batchSize = atoi(argv[++i]);
+		}
+	}
+	return(socketPath);
+}
+
+/***********************************************************
+ *	GetStressSettings()
+ *
+ *  This function is used to get the settings of a generated
+ *  scene, which replaces the scene objects when the option
+ *  --stress-scene <count> is given.  The scene is changed by
+ *  --stress-seed <number>, --stress-layout <uniform|clustered
+ *  |grid>, --stress-extent <size>, --stress-materials <count>,
+ *  --stress-textures <count>, --stress-textured <ratio> and
+ *  --stress-transparent <ratio>.
+ ***********************************************************/
+bool GetStressSettings(int argc, char* argv[], StressSceneGenerator::STRESS_SETTINGS& settings)
+{
+	bool bStressScene = false;
+	StressSceneGenerator::GetDefaultSettings(settings);
+
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--stress-scene") == 0) && (i + 1 < argc))
+		{
+			settings.objectCount = atoi(argv[++i]);
+			bStressScene = true;
+		}
+		else if ((strcmp(argv[i], "--stress-seed") == 0) && (i + 1 < argc))
+		{
+			settings.seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+		}
+		else if ((strcmp(argv[i], "--stress-layout") == 0) && (i + 1 < argc))
+		{
+			if (StressSceneGenerator::GetLayout(argv[++i], settings.layout) == false)
+			{
+				std::cout << "ERROR: unknown stress layout " << argv[i] << std::endl;
+			}
+		}
+		else if ((strcmp(argv[i], "--stress-extent") == 0) && (i + 1 < argc))
+		{
+			settings.extent = (float)atof(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--stress-materials") == 0) && (i + 1 < argc))
+		{
+			settings.materialVariety = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--stress-textures") == 0) && (i + 1 < argc))
+		{
+			settings.textureVariety = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--stress-textured") == 0) && (i + 1 < argc))
+		{
+			settings.texturedRatio = (float)atof(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--stress-transparent") == 0) && (i + 1 < argc))
+		{
+			settings.transparentRatio = (float)atof(argv[++i]);
+		}
+	}
+	return(bStressScene);
+}
+
+/***********************************************************
+ *	GetStressSweepOptions()
+ *
+ *  This function is used to get the CSV file that a stress
+ *  sweep writes, from the option --benchmark-stress, which
+ *  defaults to stress.csv, along with --stress-max <count>
+ *  for the largest generated scene.  NULL is returned when
+ *  no sweep is run.
+ ***********************************************************/
+const char* GetStressSweepOptions(int argc, char* argv[], int& maxObjects)
+{
+	const char* csvFile = NULL;
+	maxObjects = 1000000;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--benchmark-stress") == 0)
+		{
+			csvFile = "stress.csv";
+			if ((i + 1 < argc) && (strncmp(argv[i + 1], "--", 2) != 0))
+			{
+				csvFile = argv[++i];
+			}
+		}
+		else if ((strcmp(argv[i], "--stress-max") == 0) && (i + 1 < argc))
+		{
+			maxObjects = atoi(argv[++i]);
+		}
+	}
+	return(csvFile);
+}
+
+/***********************************************************
+ *	GetWorldSettings()
+ *
+ *  This function is used to get the settings of a streamed
+ *  world, which replaces the scene objects when the option
+ *  --stream-world <directory> is given.  The streaming is
+ *  changed by --stream-radius <cells>, --stream-threads
+ *  <count> and --stream-budget <milliseconds per frame>.
+ ***********************************************************/
+bool GetWorldSettings(int argc, char* argv[], WorldStreamer::WORLD_SETTINGS& settings)
+{
+	bool bStreamWorld = false;
+	settings.loadRadius = 2;
+	settings.loaderThreads = 2;
+	settings.uploadMilliseconds = 2.0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--stream-world") == 0) && (i + 1 < argc))
+		{
+			settings.directory = argv[++i];
+			bStreamWorld = true;
+		}
+		else if ((strcmp(argv[i], "--stream-radius") == 0) && (i + 1 < argc))
+		{
+			settings.loadRadius = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--stream-threads") == 0) && (i + 1 < argc))
+		{
+			settings.loaderThreads = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--stream-budget") == 0) && (i + 1 < argc))
+		{
+			settings.uploadMilliseconds = atof(argv[++i]);
+		}
+	}
+	return(bStreamWorld);
+}
+
+/***********************************************************
+ *	PrintWorldStreamingStats()
+ *
+ *  This function is used to print how much of the streamed
+ *  world was kept in the scene, when there is one.
+ ***********************************************************/
+void PrintWorldStreamingStats()
+{
+	WorldStreamer* pWorldStreamer = g_SceneManager->GetWorldStreamer();
+	if (NULL == pWorldStreamer)
+	{
+		return;
+	}
+
+	WorldStreamer::STREAMING_STATS stats = pWorldStreamer->GetStats();
+	std::cout << "INFO: world cells resident " << stats.residentCells << " (peak "
+		<< stats.peakResidentCells << ", " << stats.peakResidentEntities << " entities), "
+		<< stats.loadedCells << " loaded, " << stats.unloadedCells << " unloaded, "
+		<< stats.failedCells << " missing" << std::endl;
+}
+
+/***********************************************************
+ *	GetAnimationTime()
+ *
+ *  This function is used to get the time in seconds that the
+ *  animated scene of a CPU render starts at, from the option
+ *  --animation-time <seconds>, which defaults to 0.
+ ***********************************************************/
+double GetAnimationTime(int argc, char* argv[])
+{
+	double seconds = 0.0;
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--animation-time") == 0) && (i + 1 < argc))
+		{
+			seconds = atof(argv[++i]);
+		}
+	}
+	return(seconds);
+}
+
+/***********************************************************
+ *	PrintAnimationStats()
+ *
+ *  This function is used to print the work of the last
+ *  animation update, when the scene is animated.
+ ***********************************************************/
+void PrintAnimationStats()
+{
+	const AnimationSystem* pAnimation = g_SceneManager->GetAnimationSystem();
+	if (NULL == pAnimation)
+	{
+		return;
+	}
+
+	const AnimationSystem::ANIMATION_STATS& stats = pAnimation->GetStats();
+	std::cout << "INFO: animation updated " << stats.changedTargets << " of " << stats.targets
+		<< " entities, " << stats.changedLights << " light tracks and " << stats.changedMaterials
+		<< " material tracks from " << stats.tracks
+		<< " tracks in " << stats.milliseconds << " ms, " << stats.searchedTracks
+		<< " key searches" << std::endl;
+}
+
+/***********************************************************
+ *	PrintParticleStats()
+ *
+ *  This function is used to print the work of the last
+ *  particle update and billboard build, when the scene has
+ *  particle effects.
+ ***********************************************************/
+void PrintParticleStats()
+{
+	const ParticleSystem* pParticles = g_SceneManager->GetParticleSystem();
+	if (NULL == pParticles)
+	{
+		return;
+	}
+
+	const ParticleSystem::PARTICLE_STATS& stats = pParticles->GetStats();
+	std::cout << "INFO: " << stats.particles << " particles from " << stats.emitters
+		<< " emitters, " << stats.spawned << " spawned, " << stats.expired << " expired and "
+		<< stats.overBudget << " over budget in the last step of " << stats.updateMilliseconds
+		<< " ms, " << stats.sortedBillboards << " billboards sorted in " << stats.buildMilliseconds
+		<< " ms" << std::endl;
+}
+
+/***********************************************************
+ *	RunWriteWorld()
+ *
+ *  This function is used to write a showroom world for
+ *  --stream-world, from the option --write-world <directory>
+ *  <columns> <rows>.
+ ***********************************************************/
+int RunWriteWorld(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--write-world") == 0) && (i + 3 < argc))
+		{
+			bool bWritten = SceneManager::WriteShowroomWorld(argv[i + 1], atoi(argv[i + 2]), atoi(argv[i + 3]));
+			return(bWritten ? EXIT_SUCCESS : EXIT_FAILURE);
+		}
+	}
+
+	std::cout << "ERROR: --write-world needs a directory, columns and rows" << std::endl;
+	return(EXIT_FAILURE);
+}
+
+/***********************************************************
+ *	RunTransformReport()
+ *
+ *  This function is used to print the precision and packing
+ *  time of compact transforms for the scene, from the option
+ *  --transform-report optionally followed by the size of the
+ *  position cells, which defaults to 64.
+ ***********************************************************/
+int RunTransformReport(int argc, char* argv[])
+{
+	float cellSize = 64.0f;
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--transform-report") == 0) && (i + 1 < argc) && (atof(argv[i + 1]) > 0.0))
+		{
+			cellSize = (float)atof(argv[++i]);
+		}
+	}
+
+	CreateHeadlessScene(argc, argv);
+	g_SceneManager->ReportTransformPrecision(cellSize);
+	DestroyHeadlessScene();
+	return(EXIT_SUCCESS);
+}
+
+/***********************************************************
+ *	GetPixelRay()
+ *
+ *  This function is used to get the ray from the near plane
+ *  through a pixel of an image, for a camera's view and
+ *  projection.
+ ***********************************************************/
+void GetPixelRay(
+	const glm::mat4& view,
+	const glm::mat4& projection,
+	float x,
+	float y,
+	int width,
+	int height,
+	glm::vec3& origin,
+	glm::vec3& direction)
+{
+	glm::mat4 inverseViewProjection = glm::inverse(projection * view);
+	float ndcX = (x + 0.5f) / width * 2.0f - 1.0f;
+	float ndcY = 1.0f - (y + 0.5f) / height * 2.0f;
+	glm::vec4 nearPoint = inverseViewProjection * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+	glm::vec4 farPoint = inverseViewProjection * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+	origin = glm::vec3(nearPoint) / nearPoint.w;
+	direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - origin);
+}
+
+/***********************************************************
+ *	RunPick()
+ *
+ *  This function is used to pick the entity under a pixel of
+ *  the camera's view and time picks spread over the image,
+ *  from the option --pick <x> <y>, with the image size of
+ *  --resolution <width> <height>.  The middle of the image
+ *  is picked when no pixel is given.  An animated scene is
+ *  stepped once more to time refitting the hierarchy.
+ ***********************************************************/
+int RunPick(int argc, char* argv[])
+{
+	int width = 0;
+	int height = 0;
+	int threads = 0;
+	GetHeadlessOptions(argc, argv, width, height, threads);
+	float pickX = width * 0.5f;
+	float pickY = height * 0.5f;
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--pick") == 0) && (i + 2 < argc) && (strncmp(argv[i + 1], "--", 2) != 0))
+		{
+			pickX = (float)atof(argv[i + 1]);
+			pickY = (float)atof(argv[i + 2]);
+		}
+	}
+
+	CreateHeadlessScene(argc, argv);
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::vec3 viewPosition;
+	g_ViewManager->GetSceneView(width, height, view, projection, viewPosition);
+	g_SceneManager->UpdateWorldStreaming(viewPosition, true);
+
+	// the first query builds the hierarchy
+	const SceneQuery* pSceneQuery = g_SceneManager->UpdateSceneQuery();
+	if ((NULL == pSceneQuery) || (pSceneQuery->GetEntityCount() == 0))
+	{
+		std::cout << "ERROR: the scene has no entities to pick" << std::endl;
+		DestroyHeadlessScene();
+		return(EXIT_FAILURE);
+	}
+	const SceneQuery::QUERY_STATS& queryStats = pSceneQuery->GetStats();
+	std::cout << "INFO: built a hierarchy of " << queryStats.nodes << " nodes and "
+		<< queryStats.leaves << " leaves over " << queryStats.entities << " entities in "
+		<< queryStats.buildMilliseconds << " ms" << std::endl;
+
+	glm::vec3 origin;
+	glm::vec3 direction;
+	uint32_t entity = SceneEntities::INVALID_ENTITY;
+	float distance = 0.0f;
+	GetPixelRay(view, projection, pickX, pickY, width, height, origin, direction);
+	if (g_SceneManager->PickEntity(origin, direction, entity, distance) == true)
+	{
+		std::string name = g_SceneManager->GetSceneEntities()->GetPrefabName(entity);
+		std::cout << "INFO: pixel " << pickX << ", " << pickY << " is over "
+			<< (name.empty() ? "entity" : name.c_str()) << " " << entity
+			<< " at a distance of " << distance << std::endl;
+
+		std::vector<SceneEntities::ENTITY_ID> nearby;
+		pSceneQuery->QuerySphere(origin + direction * distance, 1.0f, nearby);
+		std::cout << "INFO: " << nearby.size() << " entities within 1 unit of the picked point" << std::endl;
+	}
+	else
+	{
+		std::cout << "INFO: pixel " << pickX << ", " << pickY << " is over nothing" << std::endl;
+	}
+
+	// time picks through a grid of pixels over the whole image
+	const int gridSize = 100;
+	int hits = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int y = 0; y < gridSize; y++)
+	{
+		for (int x = 0; x < gridSize; x++)
+		{
+			GetPixelRay(view, projection, (x + 0.5f) * width / gridSize, (y + 0.5f) * height / gridSize,
+				width, height, origin, direction);
+			if (g_SceneManager->PickEntity(origin, direction, entity, distance) == true)
+			{
+				hits++;
+			}
+		}
+	}
+	double microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "INFO: " << gridSize * gridSize << " picks hit " << hits << " entities, "
+		<< microseconds / (gridSize * gridSize) << " us per pick" << std::endl;
+
+	// moving the animated entities refits the hierarchy
+	if (NULL != g_SceneManager->GetAnimationSystem())
+	{
+		g_SceneManager->UpdateAnimation(GetAnimationTime(argc, argv) + 1.0 / 30.0);
+		pSceneQuery = g_SceneManager->UpdateSceneQuery();
+		std::cout << "INFO: refit the hierarchy to the moved entities in "
+			<< pSceneQuery->GetStats().refitMilliseconds << " ms, search cost "
+			<< pSceneQuery->GetStats().costGrowth << " times that when built, "
+			<< pSceneQuery->GetStats().builds << " builds" << std::endl;
+	}
+
+	DestroyHeadlessScene();
+	return(EXIT_SUCCESS);
+}
+
+/***********************************************************
+ *	RunCameraWalk()
+ *
+ *  This function is used to walk the camera from its view
+ *  position towards a point in small steps, as the keyboard
+ *  moves it, from the option --camera-walk <x> <y> <z>.  The
+ *  place the camera stopped at and the time of each step are
+ *  printed, which stays the same however large the scene is.
+ ***********************************************************/
+int RunCameraWalk(int argc, char* argv[])
+{
+	glm::vec3 target(0.0f);
+	bool bTarget = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--camera-walk") == 0) && (i + 3 < argc))
+		{
+			target = glm::vec3(atof(argv[i + 1]), atof(argv[i + 2]), atof(argv[i + 3]));
+			bTarget = true;
+		}
+	}
+	if (bTarget == false)
+	{
+		std::cout << "ERROR: --camera-walk needs the <x> <y> <z> to walk to" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	int width = 0;
+	int height = 0;
+	int threads = 0;
+	GetHeadlessOptions(argc, argv, width, height, threads);
+	CreateHeadlessScene(argc, argv);
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::vec3 viewPosition;
+	g_ViewManager->GetSceneView(width, height, view, projection, viewPosition);
+	g_SceneManager->UpdateWorldStreaming(viewPosition, true);
+
+	// the first move builds the grid
+	glm::vec3 position = g_SceneManager->MoveCamera(viewPosition, viewPosition);
+	const CameraCollider::COLLIDER_STATS& colliderStats = g_SceneManager->GetCameraCollider()->GetStats();
+	std::cout << "INFO: built a grid of " << colliderStats.cells << " cells over "
+		<< colliderStats.boxes << " boxes, " << colliderStats.largeBoxes << " too large for the cells, in "
+		<< colliderStats.buildMilliseconds << " ms" << std::endl;
+
+	// steps of the default camera speed at 60 frames a second
+	const float stepLength = 2.5f / 60.0f;
+	const int maxSteps = 100000;
+	int steps = 0;
+	int blockedSteps = 0;
+	long long boxesTested = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	while ((steps < maxSteps) && (glm::length(target - position) > stepLength))
+	{
+		glm::vec3 next = position + glm::normalize(target - position) * stepLength;
+		glm::vec3 moved = g_SceneManager->MoveCamera(position, next);
+		boxesTested += colliderStats.boxesTested;
+		steps++;
+		if (colliderStats.contacts > 0)
+		{
+			blockedSteps++;
+		}
+		// a camera held in place, or sliding without getting
+		// closer, gets no further by walking on
+		float progress = glm::length(target - position) - glm::length(target - moved);
+		position = moved;
+		if (progress < stepLength * 0.01f)
+		{
+			break;
+		}
+	}
+	double microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << "INFO: walked from " << viewPosition.x << ", " << viewPosition.y << ", " << viewPosition.z
+		<< " towards " << target.x << ", " << target.y << ", " << target.z
+		<< " and stopped at " << position.x << ", " << position.y << ", " << position.z << std::endl;
+	std::cout << "INFO: " << steps << " steps, " << blockedSteps << " touching the scene, "
+		<< (steps > 0 ? microseconds / steps : 0.0) << " us and "
+		<< (steps > 0 ? (double)boxesTested / steps : 0.0) << " boxes tested per step" << std::endl;
+
+	DestroyHeadlessScene();
+	return(EXIT_SUCCESS);
+}
+
+/***********************************************************
+ *	GetTileSize()
+ *
+ *  This function is used to get the size of the square tiles
+ *  that large stills are rendered in, from the option
+ *  --tile-size <pixels>, which defaults to 1024.
+ ***********************************************************/
+int GetTileSize(int argc, char* argv[])
+{
+	int tileSize = 1024;
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--tile-size") == 0) && (i + 1 < argc) && (atoi(argv[i + 1]) > 0))
+		{
+			tileSize = atoi(argv[++i]);
+		}
+	}
+	return(tileSize);
+}
+
+/***********************************************************
+ *	RunSoftwareRender()
+ *
+ *  This function is used to render the scene with the CPU
+ *  rasterizer and write the last frame to an image file.
+ *  The options are --software-render [image.ppm],
+ *  --resolution <width> <height>, --frames <count>,
+ *  --threads <count> and --capture [pattern].  Instead,
+ *  --tile-size <pixels> renders one still in tiles,
+ *  --video <target> streams a camera path as video,
+ *  --render-server <socket> serves renders to clients, and
+ *  --benchmark-stress [file.csv] times generated scenes.
+ ***********************************************************/
+int RunSoftwareRender(int argc, char* argv[])
+{
+	const char* outputFile = "scene.ppm";
+	int width = 0;
+	int height = 0;
+	int frames = 1;
+	int threads = 0;
+	bool bTiled = false;
+	GetHeadlessOptions(argc, argv, width, height, threads);
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--software-render") == 0)
+		{
+			if ((i + 1 < argc) && (strncmp(argv[i + 1], "--", 2) != 0))
+			{
+				outputFile = argv[++i];
+			}
+		}
+		else if ((strcmp(argv[i], "--frames") == 0) && (i + 1 < argc))
+		{
+			frames = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--tile-size") == 0)
+		{
+			bTiled = true;
+		}
+	}
+
+	// large stills are rendered a tile at a time
+	if (bTiled == true)
+	{
+		return(RunSoftwareTiledRender(argc, argv, outputFile, GetTileSize(argc, argv)));
+	}
+
+	// a render server keeps the scene loaded for its clients
+	int serverBatchSize = 0;
+	const char* serverSocket = GetRenderServerOptions(argc, argv, serverBatchSize);
+	if (NULL != serverSocket)
+	{
+		return(RunSoftwareRenderServer(argc, argv, serverSocket, serverBatchSize));
+	}
+
+	// a stress sweep renders generated scenes of growing size
+	int stressMaxObjects = 0;
+	const char* stressSweepFile = GetStressSweepOptions(argc, argv, stressMaxObjects);
+	if (NULL != stressSweepFile)
+	{
+		return(RunSoftwareStressSweep(argc, argv, stressSweepFile, stressMaxObjects, frames));
+	}
+
+	// a video stream takes the frames instead of an image file
+	VideoStream videoStream;
+	if (OpenVideoStream(argc, argv, videoStream) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+	if (videoStream.IsOpen() == true)
+	{
+		return(RunSoftwareVideo(argc, argv, videoStream));
+	}
+
+	if ((width <= 0) || (height <= 0) || (frames <= 0))
+	{
+		std::cout << "ERROR: invalid software render resolution or frame count" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	CreateHeadlessScene(argc, argv);
+
+	SoftwareRasterizer* pRasterizer = new SoftwareRasterizer();
+	pRasterizer->SetResolution(width, height);
+	pRasterizer->SetWorkerThreads(threads);
+
+	// every frame can be recorded while the next is rendered
+	FrameEncoder encoder;
+	int encoderThreads = 0;
+	const char* capturePattern = GetCaptureOptions(argc, argv, encoderThreads);
+	if ((NULL != capturePattern) && (encoder.Start(capturePattern, encoderThreads, 0) == false))
+	{
+		std::cout << "ERROR: could not start capturing " << capturePattern << std::endl;
+	}
+
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::vec3 viewPosition;
+	g_ViewManager->GetSceneView(width, height, view, projection, viewPosition);
+	g_SceneManager->UpdateWorldStreaming(viewPosition, true);
+
+	// an animated scene moves on by a 30 frames per second
+	// step between the frames
+	double animationTime = GetAnimationTime(argc, argv);
+	double totalSetup = 0.0;
+	double totalRaster = 0.0;
+	for (int frame = 0; frame < frames; frame++)
+	{
+		g_SceneManager->UpdateAnimation(animationTime + frame / 30.0);
+		pRasterizer->RenderScene(g_SceneManager, view, projection, viewPosition);
+		totalSetup += pRasterizer->GetFrameStats().setupMilliseconds;
+		totalRaster += pRasterizer->GetFrameStats().rasterMilliseconds;
+
+		if (encoder.IsRunning() == true)
+		{
+			std::vector<unsigned char> pixels;
+			size_t size = (size_t)width * height * 4;
+			encoder.GetFrameBuffer(pixels, size);
+			memcpy(&pixels[0], pRasterizer->GetPixels(), size);
+			encoder.SubmitFrame(frame, width, height, pixels);
+		}
+	}
+
+	if (encoder.IsRunning() == true)
+	{
+		encoder.Stop();
+		FrameEncoder::ENCODER_STATS encoderStats = encoder.GetStats();
+		std::cout << "INFO: captured " << encoderStats.encodedFrames << "/" << frames << " frames, "
+			<< encoderStats.encodeMilliseconds / std::max(encoderStats.encodedFrames, 1) << " ms per encode, "
+			<< encoderStats.stalls << " encoder stalls ("
+			<< encoderStats.stallMilliseconds << " ms)" << std::endl;
+	}
+
+	const SoftwareRasterizer::FRAME_STATS& stats = pRasterizer->GetFrameStats();
+	std::cout << "INFO: software rendered " << frames << " frames at "
+		<< width << "x" << height << "\n";
+	std::cout << "INFO: " << stats.triangles << " triangles, "
+		<< stats.binnedTriangles << " tile bin entries, " << stats.sprites << " particle sprites, "
+		<< stats.impostors << " impostors\n";
+	std::cout << "INFO: " << (totalSetup + totalRaster) / frames << " ms per frame ("
+		<< totalSetup / frames << " ms setup, "
+		<< totalRaster / frames << " ms raster)" << std::endl;
+	PrintWorldStreamingStats();
+	PrintAnimationStats();
+	PrintParticleStats();
+
+	int result = EXIT_SUCCESS;
+	if (pRasterizer->SaveImage(outputFile) == true)
+	{
+		std::cout << "INFO: wrote " << outputFile << std::endl;
+	}
+	else
+	{
+		std::cout << "ERROR: could not write " << outputFile << std::endl;
+		result = EXIT_FAILURE;
+	}
+
+	delete pRasterizer;
+	DestroyHeadlessScene();
+
+	return(result);
+}
+
+/***********************************************************
+ *	RunSoftwareTiledRender()
+ *
+ *  This function is used to render one still of any size
+ *  with the CPU rasterizer, a tile at a time, writing each
+ *  tile to the image file as soon as it is done so that the
+ *  memory used depends only on the tile size.
+ ***********************************************************/
+int RunSoftwareTiledRender(int argc, char* argv[], const char* outputFile, int tileSize)
+{
+	int width = 0;
+	int height = 0;
+	int threads = 0;
+	GetHeadlessOptions(argc, argv, width, height, threads);
+	if ((width <= 0) || (height <= 0))
+	{
+		std::cout << "ERROR: invalid software render resolution" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	TiledRenderer tiledRenderer;
+	if (tiledRenderer.Begin(outputFile, width, height, tileSize) == false)
+	{
+		std::cout << "ERROR: could not write " << outputFile << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	CreateHeadlessScene(argc, argv);
+
+	SoftwareRasterizer* pRasterizer = new SoftwareRasterizer();
+	pRasterizer->SetWorkerThreads(threads);
+
+	// the camera is framed for the whole image
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::vec3 viewPosition;
+	g_ViewManager->GetSceneView(width, height, view, projection, viewPosition);
+	g_SceneManager->UpdateWorldStreaming(viewPosition, true);
+
+	int result = EXIT_SUCCESS;
+	double totalMilliseconds = 0.0;
+	for (int i = 0; i < tiledRenderer.GetTileCount(); i++)
+	{
+		TiledRenderer::IMAGE_TILE tile = tiledRenderer.GetTile(i);
+		pRasterizer->SetResolution(tile.width, tile.height);
+		pRasterizer->RenderScene(
+			g_SceneManager,
+			view,
+			tiledRenderer.GetTileProjection(projection, tile),
+			viewPosition);
+		totalMilliseconds += pRasterizer->GetFrameStats().setupMilliseconds +
+			pRasterizer->GetFrameStats().rasterMilliseconds;
+
+		if (tiledRenderer.WriteTile(tile, pRasterizer->GetPixels(), false) == false)
+		{
+			result = EXIT_FAILURE;
+			break;
+		}
+	}
+
+	if ((tiledRenderer.End() == true) && (result == EXIT_SUCCESS))
+	{
+		std::cout << "INFO: software rendered " << tiledRenderer.GetTileCount() << " tiles of "
+			<< tileSize << "x" << tileSize << " at " << width << "x" << height
+			<< " in " << totalMilliseconds << " ms\n";
+		std::cout << "INFO: wrote " << outputFile << std::endl;
+	}
+	else
+	{
+		std::cout << "ERROR: could not write " << outputFile << std::endl;
+		result = EXIT_FAILURE;
+	}
+
+	delete pRasterizer;
+	DestroyHeadlessScene();
+
+	return(result);
+}
+
+/***********************************************************
+ *	RunSoftwareVideo()
+ *
+ *  This function is used to render the frames of a camera
+ *  path with the CPU rasterizer into a video stream, one
+ *  path frame per video frame.  Without --camera-path the
+ *  current camera is streamed for --frames frames.
+ ***********************************************************/
+int RunSoftwareVideo(int argc, char* argv[], VideoStream& stream)
+{
+	int width = 0;
+	int height = 0;
+	int threads = 0;
+	int firstFrame = 0;
+	int lastFrame = 0;
+	GetHeadlessOptions(argc, argv, width, height, threads);
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--frames") == 0) && (i + 1 < argc))
+		{
+			lastFrame = atoi(argv[++i]) - 1;
+		}
+	}
+
+	CameraPath cameraPath;
+	const char* cameraPathFile = GetCameraPathFile(argc, argv);
+	if (NULL != cameraPathFile)
+	{
+		if (cameraPath.LoadFile(cameraPathFile) == false)
+		{
+			return(EXIT_FAILURE);
+		}
+		firstFrame = cameraPath.GetFirstFrame();
+		lastFrame = cameraPath.GetLastFrame();
+	}
+
+	if ((width <= 0) || (height <= 0) || (lastFrame < firstFrame))
+	{
+		std::cout << "ERROR: invalid video resolution or frame count" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	CreateHeadlessScene(argc, argv);
+
+	SoftwareRasterizer* pRasterizer = new SoftwareRasterizer();
+	pRasterizer->SetResolution(width, height);
+	pRasterizer->SetWorkerThreads(threads);
+
+	int result = EXIT_SUCCESS;
+	double renderMilliseconds = 0.0;
+	double animationTime = GetAnimationTime(argc, argv);
+	int framesPerSecond = std::max(stream.GetFramesPerSecond(), 1);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int frame = firstFrame; frame <= lastFrame; frame++)
+	{
+		glm::mat4 view;
+		glm::mat4 projection;
+		glm::vec3 viewPosition;
+		if (NULL != cameraPathFile)
+		{
+			cameraPath.GetSceneView(frame, width, height, view, projection, viewPosition);
+		}
+		else
+		{
+			g_ViewManager->GetSceneView(width, height, view, projection, viewPosition);
+		}
+		// every cell in range is waited for, so the video does
+		// not depend on how fast the cells are read
+		g_SceneManager->UpdateWorldStreaming(viewPosition, true);
+		g_SceneManager->UpdateAnimation(animationTime + (double)frame / framesPerSecond);
+
+		pRasterizer->RenderScene(g_SceneManager, view, projection, viewPosition);
+		renderMilliseconds += pRasterizer->GetFrameStats().setupMilliseconds +
+			pRasterizer->GetFrameStats().rasterMilliseconds;
+
+		if (stream.WriteFrame(pRasterizer->GetPixels(), width, height, false) == false)
+		{
+			std::cout << "ERROR: the video stream was closed at frame " << frame << std::endl;
+			result = EXIT_FAILURE;
+			break;
+		}
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << "INFO: streamed " << stream.GetFrameCount() << " video frames at "
+		<< width << "x" << height << ", " << renderMilliseconds / std::max(stream.GetFrameCount(), 1)
+		<< " ms render per frame, " << stream.GetFrameCount() / std::max(seconds, 0.001)
+		<< " frames per second" << std::endl;
+	PrintWorldStreamingStats();
+	PrintAnimationStats();
+	PrintParticleStats();
+
+	stream.Close();
+	delete pRasterizer;
+	DestroyHeadlessScene();
+
+	return(result);
+}
+
+/***********************************************************
+ *	RunSoftwareRenderServer()
+ *
+ *  This function is used to serve renders made with the CPU
+ *  rasterizer to the clients of a local socket, until one of
+ *  them asks the server to shut down.
+ ***********************************************************/
+int RunSoftwareRenderServer(int argc, char* argv[], const char* socketPath, int batchSize)
+{
+	int width = 0;
+	int height = 0;
+	int threads = 0;
+	GetHeadlessOptions(argc, argv, width, height, threads);
+
+	CreateHeadlessScene(argc, argv);
+
+	SoftwareRasterizer* pRasterizer = new SoftwareRasterizer();
+	pRasterizer->SetWorkerThreads(threads);
+
+	int result = EXIT_SUCCESS;
+	RenderServer* pServer = new RenderServer(g_SceneManager, pRasterizer);
+	pServer->SetMaxBatchSize(batchSize);
+	if (pServer->Run(socketPath) == false)
+	{
+		std::cout << "ERROR: could not run the render server on " << socketPath << std::endl;
+		result = EXIT_FAILURE;
+	}
+
+	delete pServer;
+	delete pRasterizer;
+	DestroyHeadlessScene();
+
+	return(result);
+}
+
+/***********************************************************
+ *	RunSoftwareStressSweep()
+ *
+ *  This function is used to render generated scenes of
+ *  growing size with the CPU rasterizer, from the default
+ *  camera, and write the draw list and setup time and the
+ *  raster time of each size to a CSV file.
+ ***********************************************************/
+int RunSoftwareStressSweep(int argc, char* argv[], const char* csvFile, int maxObjects, int frames)
+{
+	int width = 0;
+	int height = 0;
+	int threads = 0;
+	GetHeadlessOptions(argc, argv, width, height, threads);
+	if ((width <= 0) || (height <= 0) || (frames <= 0))
+	{
+		std::cout << "ERROR: invalid software render resolution or frame count" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	CreateHeadlessScene(argc, argv);
+
+	SoftwareRasterizer* pRasterizer = new SoftwareRasterizer();
+	pRasterizer->SetResolution(width, height);
+	pRasterizer->SetWorkerThreads(threads);
+
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::vec3 viewPosition;
+	g_ViewManager->GetSceneView(width, height, view, projection, viewPosition);
+
+	StressSceneGenerator::STRESS_SETTINGS settings;
+	GetStressSettings(argc, argv, settings);
+	std::vector<int> sizes;
+	RenderBenchmark::GetSweepSizes(maxObjects, sizes);
+
+	std::vector<RenderBenchmark::SWEEP_RESULT> results;
+	for (size_t i = 0; i < sizes.size(); i++)
+	{
+		settings.objectCount = sizes[i];
+		g_SceneManager->GenerateStressScene(settings);
+
+		RenderBenchmark::SWEEP_RESULT result;
+		result.objects = sizes[i];
+		result.cpuMilliseconds = 0.0;
+		result.renderMilliseconds = 0.0;
+		for (int frame = 0; frame < frames; frame++)
+		{
+			pRasterizer->RenderScene(g_SceneManager, view, projection, viewPosition);
+			result.cpuMilliseconds += pRasterizer->GetFrameStats().setupMilliseconds / frames;
+			result.renderMilliseconds += pRasterizer->GetFrameStats().rasterMilliseconds / frames;
+		}
+		result.draws = (int)g_SceneManager->GetDrawList().size();
+		results.push_back(result);
+	}
+
+	int result = EXIT_SUCCESS;
+	if (RenderBenchmark::WriteSweepResults(csvFile, "software", results) == false)
+	{
+		result = EXIT_FAILURE;
+	}
+
+	delete pRasterizer;
+	DestroyHeadlessScene();
+
+	return(result);
+}
+
+/***********************************************************
+ *	RunPathTrace()
+ *
+ *  This function is used to render a reference image of the
+ *  scene with the CPU path tracer.  The options are
+ *  --path-trace [image.ppm], --samples <count>,
+ *  --bounces <count>, --checkpoint <file> and
+ *  --checkpoint-interval <passes>, along with the shared
+ *  resolution and thread options.  An existing checkpoint
+ *  is resumed, and the image and checkpoint are saved every
+ *  interval so the render can be watched and stopped.
+ ***********************************************************/
+int RunPathTrace(int argc, char* argv[])
+{
+	const char* outputFile = "reference.ppm";
+	const char* checkpointFile = NULL;
+	int samples = 64;
+	int bounces = -1;
+	int checkpointInterval = 16;
+	int width = 0;
+	int height = 0;
+	int threads = 0;
+	GetHeadlessOptions(argc, argv, width, height, threads);
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--path-trace") == 0)
+		{
+			if ((i + 1 < argc) && (strncmp(argv[i + 1], "--", 2) != 0))
+			{
+				outputFile = argv[++i];
+			}
+		}
+		else if ((strcmp(argv[i], "--samples") == 0) && (i + 1 < argc))
+		{
+			samples = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--bounces") == 0) && (i + 1 < argc))
+		{
+			bounces = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--checkpoint") == 0) && (i + 1 < argc))
+		{
+			checkpointFile = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--checkpoint-interval") == 0) && (i + 1 < argc))
+		{
+			checkpointInterval = atoi(argv[++i]);
+		}
+	}
+
+	if ((width <= 0) || (height <= 0) || (samples <= 0) || (checkpointInterval <= 0))
+	{
+		std::cout << "ERROR: invalid path trace resolution, sample count or checkpoint interval" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	CreateHeadlessScene(argc, argv);
+
+	PathTracer* pPathTracer = new PathTracer();
+	pPathTracer->SetResolution(width, height);
+	pPathTracer->SetWorkerThreads(threads);
+	pPathTracer->SetMaxBounces(bounces);
+
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::vec3 viewPosition;
+	g_ViewManager->GetSceneView(width, height, view, projection, viewPosition);
+	g_SceneManager->UpdateWorldStreaming(viewPosition, true);
+
+	int result = EXIT_SUCCESS;
+	if (pPathTracer->LoadScene(g_SceneManager, view, projection) == false)
+	{
+		std::cout << "ERROR: the scene has nothing to path trace" << std::endl;
+		result = EXIT_FAILURE;
+	}
+	else
+	{
+		if ((NULL != checkpointFile) && (pPathTracer->LoadCheckpoint(checkpointFile) == true))
+		{
+			std::cout << "INFO: resumed " << checkpointFile << " at "
+				<< pPathTracer->GetPassCount() << " samples" << std::endl;
+		}
+
+		while (pPathTracer->GetPassCount() < samples)
+		{
+			pPathTracer->RenderPass();
+
+			const PathTracer::PASS_STATS& stats = pPathTracer->GetPassStats();
+			std::cout << "INFO: sample " << pPathTracer->GetPassCount() << "/" << samples
+				<< " took " << stats.milliseconds << " ms, "
+				<< (stats.rays / std::max(stats.milliseconds, 0.001)) / 1000.0 << " million rays per second" << std::endl;
+
+			// save the progress so far at every interval
+			if ((pPathTracer->GetPassCount() % checkpointInterval == 0) ||
+				(pPathTracer->GetPassCount() == samples))
+			{
+				pPathTracer->SaveImage(outputFile);
+				if ((NULL != checkpointFile) && (pPathTracer->SaveCheckpoint(checkpointFile) == false))
+				{
+					std::cout << "ERROR: could not write " << checkpointFile << std::endl;
+				}
+			}
+		}
+
+		if (pPathTracer->SaveImage(outputFile) == true)
+		{
+			std::cout << "INFO: wrote " << outputFile << std::endl;
+		}
+		else
+		{
+			std::cout << "ERROR: could not write " << outputFile << std::endl;
+			result = EXIT_FAILURE;
+		}
+	}
+
+	delete pPathTracer;
+	DestroyHeadlessScene();
+
+	return(result);
+}
+
+/***********************************************************
+ *	GetRenderFarmOptions()
+ *
+ *  This function is used to get the options shared by the
+ *  render farm and its workers, which are
+ *  --render-farm <path file>, --frame-range <first> <last>,
+ *  --workers <count> and --output <pattern>.  The frame range
+ *  defaults to the keys of the camera path, and the output
+ *  pattern to frame_####.ppm, where the #### may also be a
+ *  printf field such as %04d.
+ ***********************************************************/
+bool GetRenderFarmOptions(int argc, char* argv[], CameraPath& path, int& firstFrame, int& lastFrame, int& workers, const char*& outputPattern)
+{
+	const char* pathFile = NULL;
+	bool bFrameRange = false;
+	workers = 0;
+	outputPattern = "frame_####.ppm";
+
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--render-farm") == 0) && (i + 1 < argc))
+		{
+			pathFile = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--frame-range") == 0) && (i + 2 < argc))
+		{
+			firstFrame = atoi(argv[++i]);
+			lastFrame = atoi(argv[++i]);
+			bFrameRange = true;
+		}
+		else if ((strcmp(argv[i], "--workers") == 0) && (i + 1 < argc))
+		{
+			workers = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--output") == 0) && (i + 1 < argc))
+		{
+			outputPattern = argv[++i];
+		}
+	}
+
+	if (NULL == pathFile)
+	{
+		std::cout << "ERROR: the render farm needs a camera path file" << std::endl;
+		return(false);
+	}
+	if (path.LoadFile(pathFile) == false)
+	{
+		return(false);
+	}
+
+	if (bFrameRange == false)
+	{
+		firstFrame = path.GetFirstFrame();
+		lastFrame = path.GetLastFrame();
+	}
+	if (lastFrame < firstFrame)
+	{
+		std::cout << "ERROR: invalid render farm frame range" << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *	RunRenderFarm()
+ *
+ *  This function is used to render the frames of a camera
+ *  path with several worker processes, each writing its own
+ *  numbered images, and to report the frames per second of
+ *  the whole farm.
+ ***********************************************************/
+int RunRenderFarm(int argc, char* argv[])
+{
+	CameraPath path;
+	int firstFrame = 0;
+	int lastFrame = 0;
+	int workers = 0;
+	const char* outputPattern = NULL;
+	if (GetRenderFarmOptions(argc, argv, path, firstFrame, lastFrame, workers, outputPattern) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// fill the texture cache once, so the workers only read it
+	// instead of all writing the same files at the same time
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--texture-cache") == 0)
+		{
+			CreateHeadlessScene(argc, argv);
+			DestroyHeadlessScene();
+			break;
+		}
+	}
+
+	RenderFarm farm;
+	farm.SetWorkerCount(workers);
+	farm.SetFrameRange(firstFrame, lastFrame);
+	if (farm.Run(argc, argv) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	return(EXIT_SUCCESS);
+}
+
+/***********************************************************
+ *	RunFarmWorker()
+ *
+ *  This function is used to render the share of the render
+ *  farm frames given by --farm-worker <index> <count> with
+ *  the CPU rasterizer.  Unless --threads is passed, the
+ *  hardware threads are divided between the workers.  An
+ *  animated scene is posed for each frame at --fps frames
+ *  per second, 30 by default, from --animation-time.
+ ***********************************************************/
+int RunFarmWorker(int argc, char* argv[])
+{
+	int workerIndex = 0;
+	int workerCount = 1;
+	int framesPerSecond = 30;
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "--farm-worker") == 0) && (i + 2 < argc))
+		{
+			workerIndex = atoi(argv[++i]);
+			workerCount = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--fps") == 0) && (i + 1 < argc))
+		{
+			framesPerSecond = std::max(atoi(argv[++i]), 1);
+		}
+	}
+
+	CameraPath path;
+	int firstFrame = 0;
+	int lastFrame = 0;
+	int workers = 0;
+	const char* outputPattern = NULL;
+	if ((GetRenderFarmOptions(argc, argv, path, firstFrame, lastFrame, workers, outputPattern) == false) ||
+		(workerCount <= 0) || (workerIndex < 0) || (workerIndex >= workerCount))
+	{
+		return(EXIT_FAILURE);
+	}
+
+	int width = 0;
+	int height = 0;
+	int threads = 0;
+	GetHeadlessOptions(argc, argv, width, height, threads);
+	if ((width <= 0) || (height <= 0))
+	{
+		std::cout << "ERROR: invalid render farm resolution" << std::endl;
+		return(EXIT_FAILURE);
+	}
+	if (threads <= 0)
+	{
+		threads = std::max(1, (int)std::thread::hardware_concurrency() / workerCount);
+	}
+
+	CreateHeadlessScene(argc, argv);
+
+	SoftwareRasterizer* pRasterizer = new SoftwareRasterizer();
+	pRasterizer->SetResolution(width, height);
+	pRasterizer->SetWorkerThreads(threads);
+
+	int result = EXIT_SUCCESS;
+	int frames = 0;
+	double totalMilliseconds = 0.0;
+	double animationTime = GetAnimationTime(argc, argv);
+	for (int frame = firstFrame; frame <= lastFrame; frame++)
+	{
+		if (RenderFarm::IsWorkerFrame(frame, workerIndex, workerCount) == false)
+		{
+			continue;
+		}
+
+		glm::mat4 view;
+		glm::mat4 projection;
+		glm::vec3 viewPosition;
+		path.GetSceneView(frame, width, height, view, projection, viewPosition);
+		// every cell in range is waited for, so each frame is
+		// the same whichever worker renders it
+		g_SceneManager->UpdateWorldStreaming(viewPosition, true);
+		// the pose only depends on the frame number, so frames
+		// skipped for the other workers change nothing
+		g_SceneManager->UpdateAnimation(animationTime + (double)frame / framesPerSecond);
+		pRasterizer->RenderScene(g_SceneManager, view, projection, viewPosition);
+		totalMilliseconds += pRasterizer->GetFrameStats().setupMilliseconds +
+			pRasterizer->GetFrameStats().rasterMilliseconds;
+
+		std::string outputFile = RenderFarm::GetFrameFilename(outputPattern, frame);
+		if (pRasterizer->SaveImage(outputFile.c_str()) == false)
+		{
+			std::cout << "ERROR: could not write " << outputFile << std::endl;
+			result = EXIT_FAILURE;
+			break;
+		}
+		frames++;
+	}
+
+	std::cout << "INFO: render worker " << workerIndex << " rendered " << frames << " frames, "
+		<< totalMilliseconds / std::max(frames, 1) << " ms per frame" << std::endl;
+
+	delete pRasterizer;
+	DestroyHeadlessScene();
+
+	return(result);
+}
+
+#ifdef USE_VULKAN
+/***********************************************************
+ *	RunVulkanRender()
+ *
+ *  This function is used to render the scene offscreen with
+ *  the Vulkan render device and write the last frame to an
+ *  image file, which also runs on CPU drivers like lavapipe.
+ *  The options are --vulkan [image.ppm], --frames <count>,
+ *  --resolution <width> <height> and --quad-view, which
+ *  draws the four preset views in one pass.
+ ***********************************************************/
+int RunVulkanRender(int argc, char* argv[])
+{
+	const char* outputFile = "vulkan.ppm";
+	int width = 0;
+	int height = 0;
+	int frames = 1;
+	int threads = 0;
+	bool bQuadView = false;
+	GetHeadlessOptions(argc, argv, width, height, threads);
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--vulkan") == 0)
+		{
+			if ((i + 1 < argc) && (strncmp(argv[i + 1], "--", 2) != 0))
+			{
+				outputFile = argv[++i];
+			}
+		}
+		else if ((strcmp(argv[i], "--frames") == 0) && (i + 1 < argc))
+		{
+			frames = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--quad-view") == 0)
+		{
+			bQuadView = true;
+		}
+	}
+
+	if ((width <= 0) || (height <= 0) || (frames <= 0))
+	{
+		std::cout << "ERROR: invalid Vulkan render resolution or frame count" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	VulkanRenderDevice* pDevice = new VulkanRenderDevice(width, height);
+	if (pDevice->Initialize() == false)
+	{
+		delete pDevice;
+		return(EXIT_FAILURE);
+	}
+	CreateHeadlessScene(argc, argv, pDevice);
+
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::vec3 viewPosition;
+	std::vector<RenderDevice::VIEWPORT_VIEW> quadViews;
+	g_ViewManager->GetSceneView(width, height, view, projection, viewPosition);
+	g_SceneManager->UpdateWorldStreaming(viewPosition, true);
+	if (bQuadView == true)
+	{
+		g_ViewManager->GetQuadViews(width, height, quadViews);
+	}
+
+	double totalRecord = 0.0;
+	double totalGPU = 0.0;
+	int recordedFrames = 0;
+	for (int frame = 0; frame < frames; frame++)
+	{
+		if (bQuadView == true)
+		{
+			pDevice->SetViews(quadViews);
+		}
+		else
+		{
+			pDevice->SetView(view, projection, viewPosition);
+		}
+		g_SceneManager->RenderScene();
+
+		const VulkanRenderDevice::FRAME_STATS& stats = pDevice->GetFrameStats();
+		totalRecord += stats.recordMilliseconds;
+		totalGPU += stats.gpuMilliseconds;
+		if (stats.bRecorded == true)
+		{
+			recordedFrames++;
+		}
+	}
+
+	std::cout << "INFO: Vulkan rendered " << frames << " frames of "
+		<< pDevice->GetFrameStats().draws << " draws at " << width << "x" << height << "\n";
+	std::cout << "INFO: " << (totalRecord + totalGPU) / frames << " ms per frame ("
+		<< totalRecord / frames << " ms update, "
+		<< totalGPU / frames << " ms GPU), command buffers recorded in "
+		<< recordedFrames << " frames" << std::endl;
+
+	int result = EXIT_SUCCESS;
+	if (pDevice->SaveImage(outputFile) == true)
+	{
+		std::cout << "INFO: wrote " << outputFile << std::endl;
+	}
+	else
+	{
+		std::cout << "ERROR: could not write " << outputFile << std::endl;
+		result = EXIT_FAILURE;
+	}
+
+	// the scene manager owns the render device
+	DestroyHeadlessScene();
+
+	return(result);
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,368 @@
+///////////////////////////////////////////////////////////////////////////////
+// particlesystem.cpp
+// ============
+// simulate pouring, steam and dust particles in packed columns
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ParticleSystem.h"
+#include "SimdSupport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// declaration of global variables and defines
+namespace
+{
+	// get the time in milliseconds, for timing the updates
+	double GetMilliseconds()
+	{
+		return(std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// properties for sorting the billboards of blended emitters
+	struct SORT_ENTRY
+	{
+		float distance;
+		int index;
+	};
+
+	bool IsFarther(const SORT_ENTRY& a, const SORT_ENTRY& b)
+	{
+		return(a.distance > b.distance);
+	}
+}
+
+/***********************************************************
+ *  ParticleSystem()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ParticleSystem::ParticleSystem()
+{
+	m_stats.emitters = 0;
+	m_stats.particles = 0;
+	m_stats.spawned = 0;
+	m_stats.expired = 0;
+	m_stats.overBudget = 0;
+	m_stats.sortedBillboards = 0;
+	m_stats.updateMilliseconds = 0.0;
+	m_stats.buildMilliseconds = 0.0;
+}
+
+/***********************************************************
+ *  AddEmitter()
+ *
+ *  This method is used for adding an emitter.  The columns
+ *  of its pool are allocated for its whole budget up front,
+ *  so spawning never allocates.
+ ***********************************************************/
+int ParticleSystem::AddEmitter(const EMITTER_SETTINGS& settings)
+{
+	m_pools.push_back(PARTICLE_POOL());
+	PARTICLE_POOL& pool = m_pools.back();
+	pool.settings = settings;
+	pool.settings.budget = std::max(settings.budget, 0);
+	pool.count = 0;
+	pool.spawnCarry = 0.0f;
+	// a seed of 0 would keep the sequence at 0
+	pool.randomState = (settings.seed != 0) ? settings.seed : 1;
+
+	size_t budget = (size_t)pool.settings.budget;
+	pool.positionX.resize(budget);
+	pool.positionY.resize(budget);
+	pool.positionZ.resize(budget);
+	pool.velocityX.resize(budget);
+	pool.velocityY.resize(budget);
+	pool.velocityZ.resize(budget);
+	pool.age.resize(budget);
+	pool.lifetime.resize(budget);
+
+	m_stats.emitters++;
+	return((int)m_pools.size() - 1);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing every emitter and its
+ *  particles.
+ ***********************************************************/
+void ParticleSystem::Clear()
+{
+	m_pools.clear();
+	m_stats.emitters = 0;
+	m_stats.particles = 0;
+}
+
+/***********************************************************
+ *  GetParticleCount()
+ *
+ *  This method is used for getting the number of particles
+ *  alive in every pool.
+ ***********************************************************/
+int ParticleSystem::GetParticleCount() const
+{
+	int particles = 0;
+	for (size_t i = 0; i < m_pools.size(); i++)
+	{
+		particles += m_pools[i].count;
+	}
+	return(particles);
+}
+
+/***********************************************************
+ *  NextRandom()
+ *
+ *  This method is used for getting a random number from -1
+ *  up to 1, from the top 24 bits of the next number of the
+ *  pool's xorshift sequence.
+ ***********************************************************/
+float ParticleSystem::NextRandom(PARTICLE_POOL& pool)
+{
+	pool.randomState ^= pool.randomState << 13;
+	pool.randomState ^= pool.randomState >> 17;
+	pool.randomState ^= pool.randomState << 5;
+	return((float)(pool.randomState >> 8) * (2.0f / 16777216.0f) - 1.0f);
+}
+
+/***********************************************************
+ *  SpawnParticles()
+ *
+ *  This method is used for spawning the particles a pool
+ *  gains over a time step.  Parts of a particle are carried
+ *  to the next step so low rates still spawn, and particles
+ *  that do not fit in the budget are counted and dropped.
+ ***********************************************************/
+void ParticleSystem::SpawnParticles(PARTICLE_POOL& pool, float deltaSeconds)
+{
+	const EMITTER_SETTINGS& settings = pool.settings;
+	float wanted = settings.spawnRate * deltaSeconds + pool.spawnCarry;
+	int spawn = (int)wanted;
+	pool.spawnCarry = wanted - (float)spawn;
+
+	int room = settings.budget - pool.count;
+	if (spawn > room)
+	{
+		m_stats.overBudget += spawn - room;
+		spawn = room;
+	}
+
+	for (int i = 0; i < spawn; i++)
+	{
+		int row = pool.count++;
+		pool.positionX[row] = settings.origin.x + NextRandom(pool) * settings.extent.x;
+		pool.positionY[row] = settings.origin.y + NextRandom(pool) * settings.extent.y;
+		pool.positionZ[row] = settings.origin.z + NextRandom(pool) * settings.extent.z;
+		pool.velocityX[row] = settings.velocity.x + NextRandom(pool) * settings.velocityJitter.x;
+		pool.velocityY[row] = settings.velocity.y + NextRandom(pool) * settings.velocityJitter.y;
+		pool.velocityZ[row] = settings.velocity.z + NextRandom(pool) * settings.velocityJitter.z;
+		pool.age[row] = 0.0f;
+		pool.lifetime[row] = std::max(settings.lifetime + NextRandom(pool) * settings.lifetimeJitter, 0.01f);
+	}
+	m_stats.spawned += spawn;
+}
+
+/***********************************************************
+ *  IntegratePool()
+ *
+ *  This method is used for moving the particles of a pool
+ *  over a time step and removing the ones that expired.  The
+ *  velocities lose their drag and gain the acceleration, the
+ *  positions move by the velocities, and a particle expires
+ *  when it outlives its lifetime or falls below the minimum
+ *  height.  The expired rows are found while moving, and are
+ *  filled from the end of the pool afterwards.
+ ***********************************************************/
+void ParticleSystem::IntegratePool(PARTICLE_POOL& pool, float deltaSeconds)
+{
+	const EMITTER_SETTINGS& settings = pool.settings;
+	float keep = std::max(1.0f - settings.drag * deltaSeconds, 0.0f);
+	glm::vec3 gain = settings.acceleration * deltaSeconds;
+
+	float* positionX = pool.positionX.data();
+	float* positionY = pool.positionY.data();
+	float* positionZ = pool.positionZ.data();
+	float* velocityX = pool.velocityX.data();
+	float* velocityY = pool.velocityY.data();
+	float* velocityZ = pool.velocityZ.data();
+	float* age = pool.age.data();
+	const float* lifetime = pool.lifetime.data();
+
+	m_expiredRows.clear();
+	int row = 0;
+#ifdef SCENE_SIMD_SSE2
+	__m128 keep4 = _mm_set1_ps(keep);
+	__m128 delta4 = _mm_set1_ps(deltaSeconds);
+	__m128 gainX = _mm_set1_ps(gain.x);
+	__m128 gainY = _mm_set1_ps(gain.y);
+	__m128 gainZ = _mm_set1_ps(gain.z);
+	__m128 minimumHeight = _mm_set1_ps(settings.minimumHeight);
+	for (; row + 4 <= pool.count; row += 4)
+	{
+		__m128 vx = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(velocityX + row), keep4), gainX);
+		__m128 vy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(velocityY + row), keep4), gainY);
+		__m128 vz = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(velocityZ + row), keep4), gainZ);
+		__m128 py = _mm_add_ps(_mm_loadu_ps(positionY + row), _mm_mul_ps(vy, delta4));
+		__m128 ages = _mm_add_ps(_mm_loadu_ps(age + row), delta4);
+		_mm_storeu_ps(velocityX + row, vx);
+		_mm_storeu_ps(velocityY + row, vy);
+		_mm_storeu_ps(velocityZ + row, vz);
+		_mm_storeu_ps(positionX + row, _mm_add_ps(_mm_loadu_ps(positionX + row), _mm_mul_ps(vx, delta4)));
+		_mm_storeu_ps(positionY + row, py);
+		_mm_storeu_ps(positionZ + row, _mm_add_ps(_mm_loadu_ps(positionZ + row), _mm_mul_ps(vz, delta4)));
+		_mm_storeu_ps(age + row, ages);
+
+		int expired = _mm_movemask_ps(_mm_or_ps(
+			_mm_cmpge_ps(ages, _mm_loadu_ps(lifetime + row)),
+			_mm_cmplt_ps(py, minimumHeight)));
+		for (int lane = 0; expired != 0; lane++, expired >>= 1)
+		{
+			if ((expired & 1) != 0)
+			{
+				m_expiredRows.push_back(row + lane);
+			}
+		}
+	}
+#endif
+	for (; row < pool.count; row++)
+	{
+		velocityX[row] = velocityX[row] * keep + gain.x;
+		velocityY[row] = velocityY[row] * keep + gain.y;
+		velocityZ[row] = velocityZ[row] * keep + gain.z;
+		positionX[row] += velocityX[row] * deltaSeconds;
+		positionY[row] += velocityY[row] * deltaSeconds;
+		positionZ[row] += velocityZ[row] * deltaSeconds;
+		age[row] += deltaSeconds;
+		if ((age[row] >= lifetime[row]) || (positionY[row] < settings.minimumHeight))
+		{
+			m_expiredRows.push_back(row);
+		}
+	}
+
+	// the rows are filled from the last one down, so the row
+	// moved into an expired one is always a live particle
+	for (int i = (int)m_expiredRows.size() - 1; i >= 0; i--)
+	{
+		int expiredRow = m_expiredRows[i];
+		int last = --pool.count;
+		positionX[expiredRow] = positionX[last];
+		positionY[expiredRow] = positionY[last];
+		positionZ[expiredRow] = positionZ[last];
+		velocityX[expiredRow] = velocityX[last];
+		velocityY[expiredRow] = velocityY[last];
+		velocityZ[expiredRow] = velocityZ[last];
+		age[expiredRow] = age[last];
+		pool.lifetime[expiredRow] = lifetime[last];
+	}
+	m_stats.expired += (int)m_expiredRows.size();
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for spawning, moving and expiring the
+ *  particles of every emitter over a time step in seconds.
+ ***********************************************************/
+void ParticleSystem::Update(float deltaSeconds)
+{
+	double start = GetMilliseconds();
+	m_stats.spawned = 0;
+	m_stats.expired = 0;
+	m_stats.overBudget = 0;
+
+	if (deltaSeconds > 0.0f)
+	{
+		for (size_t i = 0; i < m_pools.size(); i++)
+		{
+			IntegratePool(m_pools[i], deltaSeconds);
+			SpawnParticles(m_pools[i], deltaSeconds);
+		}
+	}
+
+	m_stats.particles = GetParticleCount();
+	m_stats.updateMilliseconds = GetMilliseconds() - start;
+}
+
+/***********************************************************
+ *  BuildBillboards()
+ *
+ *  This method is used for appending a billboard for every
+ *  particle, with its size and color blended from the start
+ *  to the end of its life.  The emitters that are not blended
+ *  come first in any order, and the billboards of blended
+ *  emitters follow sorted back to front from the viewer, so
+ *  only they pay for sorting.
+ ***********************************************************/
+void ParticleSystem::BuildBillboards(const glm::vec3& viewPosition, std::vector<PARTICLE_BILLBOARD>& billboards)
+{
+	double start = GetMilliseconds();
+	billboards.reserve(billboards.size() + GetParticleCount());
+
+	size_t firstBlended = billboards.size();
+	for (int pass = 0; pass < 2; pass++)
+	{
+		bool bBlended = (pass == 1);
+		if (bBlended == true)
+		{
+			firstBlended = billboards.size();
+		}
+		for (size_t i = 0; i < m_pools.size(); i++)
+		{
+			const PARTICLE_POOL& pool = m_pools[i];
+			const EMITTER_SETTINGS& settings = pool.settings;
+			if (settings.bBlended != bBlended)
+			{
+				continue;
+			}
+
+			PARTICLE_BILLBOARD billboard;
+			for (int row = 0; row < pool.count; row++)
+			{
+				float life = std::min(pool.age[row] / pool.lifetime[row], 1.0f);
+				billboard.position = glm::vec3(pool.positionX[row], pool.positionY[row], pool.positionZ[row]);
+				billboard.size = settings.startSize + (settings.endSize - settings.startSize) * life;
+				billboard.color = settings.startColor + (settings.endColor - settings.startColor) * life;
+				billboards.push_back(billboard);
+			}
+		}
+	}
+
+	int blendedCount = (int)(billboards.size() - firstBlended);
+	if (blendedCount > 1)
+	{
+		std::vector<SORT_ENTRY> order(blendedCount);
+		for (int i = 0; i < blendedCount; i++)
+		{
+			glm::vec3 offset = billboards[firstBlended + i].position - viewPosition;
+			order[i].distance = glm::dot(offset, offset);
+			order[i].index = (int)firstBlended + i;
+		}
+		std::sort(order.begin(), order.end(), IsFarther);
+
+		std::vector<PARTICLE_BILLBOARD> sorted(blendedCount);
+		for (int i = 0; i < blendedCount; i++)
+		{
+			sorted[i] = billboards[order[i].index];
+		}
+		std::copy(sorted.begin(), sorted.end(), billboards.begin() + firstBlended);
+	}
+
+	m_stats.sortedBillboards = blendedCount;
+	m_stats.buildMilliseconds = GetMilliseconds() - start;
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the work of the last
+ *  update and billboard build.
+ ***********************************************************/
+const ParticleSystem::PARTICLE_STATS& ParticleSystem::GetStats() const
+{
+	return(m_stats);
+}
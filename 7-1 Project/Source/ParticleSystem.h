@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////////////
+// particlesystem.h
+// ============
+// simulate pouring, steam and dust particles in packed columns
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  ParticleSystem
+ *
+ *  This class simulates the particles of effects such as a
+ *  wine pour, steam and floating dust.  Each emitter keeps
+ *  its particles in its own pool of tightly packed columns,
+ *  one per value, sized by the emitter's budget, so one
+ *  effect can never starve another.  The update walks the
+ *  columns four particles at a time with SSE2, and expired
+ *  particles are replaced by the last one of the pool so the
+ *  columns stay packed.  Every frame the particles are turned
+ *  into billboards, the per-instance data of one instanced
+ *  draw, where only the billboards of blended emitters are
+ *  sorted back to front.
+ ***********************************************************/
+class ParticleSystem
+{
+public:
+	// constructor
+	ParticleSystem();
+
+	// properties for an emitter and the particles it spawns
+	struct EMITTER_SETTINGS
+	{
+		// center and half size of the box particles start in
+		glm::vec3 origin;
+		glm::vec3 extent;
+		// starting velocity and the most it varies on each axis
+		glm::vec3 velocity;
+		glm::vec3 velocityJitter;
+		// acceleration, such as gravity or the lift of steam
+		glm::vec3 acceleration;
+		// share of the velocity lost each second
+		float drag;
+		// particles spawned each second
+		float spawnRate;
+		// seconds a particle lives and the most it varies
+		float lifetime;
+		float lifetimeJitter;
+		// size and color at the start and end of a life
+		float startSize;
+		float endSize;
+		glm::vec4 startColor;
+		glm::vec4 endColor;
+		// particles that fall below this height expire
+		float minimumHeight;
+		// most particles the emitter may have alive
+		int budget;
+		// blend the billboards over the scene back to front
+		// instead of drawing them in any order
+		bool bBlended;
+		uint32_t seed;
+	};
+
+	// properties for one billboard, which always faces the
+	// camera
+	struct PARTICLE_BILLBOARD
+	{
+		glm::vec3 position;
+		float size;
+		glm::vec4 color;
+	};
+
+	// properties for the work of the last update and build
+	struct PARTICLE_STATS
+	{
+		int emitters;
+		int particles;
+		int spawned;
+		int expired;
+		// particles not spawned because a pool was full
+		int overBudget;
+		int sortedBillboards;
+		double updateMilliseconds;
+		double buildMilliseconds;
+	};
+
+private:
+	// properties for the particles of one emitter
+	struct PARTICLE_POOL
+	{
+		EMITTER_SETTINGS settings;
+		int count;
+		// part of a particle left over from the last spawn
+		float spawnCarry;
+		uint32_t randomState;
+		std::vector<float> positionX;
+		std::vector<float> positionY;
+		std::vector<float> positionZ;
+		std::vector<float> velocityX;
+		std::vector<float> velocityY;
+		std::vector<float> velocityZ;
+		std::vector<float> age;
+		std::vector<float> lifetime;
+	};
+
+	std::vector<PARTICLE_POOL> m_pools;
+	// rows of the particles that expired during an update
+	std::vector<int> m_expiredRows;
+	PARTICLE_STATS m_stats;
+
+	// get a random number from -1 up to 1 from a pool's
+	// xorshift sequence
+	static float NextRandom(PARTICLE_POOL& pool);
+	// spawn the particles a pool gains over a time step
+	void SpawnParticles(PARTICLE_POOL& pool, float deltaSeconds);
+	// move the particles of a pool and remove expired ones
+	void IntegratePool(PARTICLE_POOL& pool, float deltaSeconds);
+
+public:
+	// add an emitter, returning its index
+	int AddEmitter(const EMITTER_SETTINGS& settings);
+	// remove every emitter and particle
+	void Clear();
+	// get the number of live particles
+	int GetParticleCount() const;
+
+	// spawn, move and expire the particles over a time step
+	void Update(float deltaSeconds);
+	// append a billboard for every particle, those of blended
+	// emitters last and sorted back to front from a viewer
+	void BuildBillboards(const glm::vec3& viewPosition, std::vector<PARTICLE_BILLBOARD>& billboards);
+	// get the work of the last update and build
+	const PARTICLE_STATS& GetStats() const;
+};
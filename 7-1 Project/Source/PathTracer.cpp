@@ -0,0 +1,1312 @@
+///////////////////////////////////////////////////////////////////////////////
+// pathtracer.cpp
+// ============
+// render reference images of the scene with a progressive CPU path tracer
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "PathTracer.h"
+#include "SimdSupport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// declaration of global variables and defines
+namespace
+{
+	const float g_Pi = 3.14159265358979f;
+
+	// width and height of the tiles handed out to the threads
+	const int g_TileSize = 16;
+	// number of candidate split positions along each axis
+	const int g_SplitBins = 12;
+	// most triangles kept in a leaf without checking for a split
+	const int g_MinLeafTriangles = 2;
+	// cost of visiting a node relative to testing a triangle
+	const float g_TraversalCost = 1.0f;
+	// distance kept from a surface when a ray leaves it
+	const float g_RayOffset = 0.0005f;
+	// distance given to rays that have not hit anything yet
+	const float g_NoHit = 1.0e30f;
+	// most times one path passes through translucent surfaces
+	const int g_MaxTransmissions = 8;
+	// bounces always traced before a path may be ended early
+	const int g_MinBounces = 2;
+
+	// first bytes of a path tracer checkpoint file
+	const char g_CheckpointMagic[4] = { 'P', 'T', 'C', 'K' };
+
+	// properties stored at the start of a checkpoint file
+	struct CHECKPOINT_HEADER
+	{
+		char magic[4];
+		int width;
+		int height;
+		int passes;
+	};
+
+	// get the time from a steady clock in milliseconds
+	double GetMilliseconds()
+	{
+		return(std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// scramble the bits of a value, used to seed each pixel
+	// from its position and pass so the image does not depend
+	// on which thread rendered it
+	unsigned int Hash(unsigned int value)
+	{
+		value ^= value >> 16;
+		value *= 0x7feb352du;
+		value ^= value >> 15;
+		value *= 0x846ca68bu;
+		value ^= value >> 16;
+		return(value);
+	}
+
+	// get the next random number from 0 up to but not including 1
+	float Random(unsigned int& state)
+	{
+		state = state * 747796405u + 2891336453u;
+		return((float)(Hash(state) >> 8) * (1.0f / 16777216.0f));
+	}
+
+	float Luminance(const glm::vec3& color)
+	{
+		return(0.2126f * color.r + 0.7152f * color.g + 0.0722f * color.b);
+	}
+
+	// get a direction around an axis, where cosTheta is the
+	// cosine of the angle between them
+	glm::vec3 DirectionAround(const glm::vec3& axis, float cosTheta, float phi)
+	{
+		glm::vec3 tangent = (std::fabs(axis.x) > 0.9f) ?
+			glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+		tangent = glm::normalize(glm::cross(axis, tangent));
+		glm::vec3 bitangent = glm::cross(axis, tangent);
+		float sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
+		return(glm::normalize(
+			tangent * (std::cos(phi) * sinTheta) +
+			bitangent * (std::sin(phi) * sinTheta) +
+			axis * cosTheta));
+	}
+
+	float SurfaceArea(const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+	{
+		glm::vec3 size = glm::max(boundsMax - boundsMin, glm::vec3(0.0f));
+		return(2.0f * (size.x * size.y + size.y * size.z + size.z * size.x));
+	}
+}
+
+/***********************************************************
+ *  PathTracer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+PathTracer::PathTracer()
+{
+	m_width = 0;
+	m_height = 0;
+	m_maxBounces = 4;
+	m_environmentColor = glm::vec3(0.0f);
+	m_passes = 0;
+	m_rayCount = 0;
+	m_stats.milliseconds = 0.0;
+	m_stats.rays = 0;
+
+	// default to one worker per hardware thread
+	m_workerThreads = (int)std::thread::hardware_concurrency();
+	if (m_workerThreads < 1)
+	{
+		m_workerThreads = 1;
+	}
+
+	SetResolution(1000, 800);
+}
+
+/***********************************************************
+ *  SetResolution()
+ *
+ *  This method is used for setting the width and height of
+ *  the rendered image, which restarts the accumulation.
+ ***********************************************************/
+void PathTracer::SetResolution(int width, int height)
+{
+	if ((width <= 0) || (height <= 0))
+	{
+		return;
+	}
+
+	m_width = width;
+	m_height = height;
+	m_accumulation.assign((size_t)width * height * 3, 0.0f);
+	m_passes = 0;
+}
+
+/***********************************************************
+ *  SetWorkerThreads()
+ *
+ *  This method is used for setting how many threads render
+ *  the tiles of each pass.
+ ***********************************************************/
+void PathTracer::SetWorkerThreads(int workerThreads)
+{
+	if (workerThreads > 0)
+	{
+		m_workerThreads = workerThreads;
+	}
+}
+
+/***********************************************************
+ *  SetMaxBounces()
+ *
+ *  This method is used for setting how many times a path can
+ *  bounce off surfaces after leaving the camera.
+ ***********************************************************/
+void PathTracer::SetMaxBounces(int maxBounces)
+{
+	if (maxBounces >= 0)
+	{
+		m_maxBounces = maxBounces;
+	}
+}
+
+/***********************************************************
+ *  SetEnvironmentColor()
+ *
+ *  This method is used for setting the radiance that paths
+ *  pick up when they leave the scene without hitting it.
+ ***********************************************************/
+void PathTracer::SetEnvironmentColor(glm::vec3 color)
+{
+	m_environmentColor = color;
+}
+
+/***********************************************************
+ *  LoadScene()
+ *
+ *  This method is used for copying the draws, materials,
+ *  lights and textures of the scene, gathering the triangles
+ *  of the draws in world space and building the hierarchy
+ *  over them.  The accumulated image is restarted.
+ ***********************************************************/
+bool PathTracer::LoadScene(
+	SceneManager* pSceneManager,
+	const glm::mat4& view,
+	const glm::mat4& projection)
+{
+	if (NULL == pSceneManager)
+	{
+		return(false);
+	}
+
+	pSceneManager->BuildDrawList();
+	m_draws = pSceneManager->GetDrawList();
+	m_materials = pSceneManager->GetObjectMaterials();
+	m_lights = pSceneManager->GetLightSources();
+	m_inverseViewProjection = glm::inverse(projection * view);
+
+	m_textures.clear();
+	m_textures.resize(16);
+	for (int slot = 0; slot < 16; slot++)
+	{
+		const SceneManager::TEXTURE_IMAGE* pImage = pSceneManager->GetTextureImage(slot);
+		if (NULL != pImage)
+		{
+			m_textures[slot].pixels = pImage->pixels;
+			m_textures[slot].width = pImage->width;
+			m_textures[slot].height = pImage->height;
+		}
+	}
+
+	GatherTriangles();
+	if (m_triangles.empty() == true)
+	{
+		return(false);
+	}
+
+	// the root starts with every triangle and is split from there
+	std::vector<glm::vec3> centers(m_triangles.size());
+	for (size_t i = 0; i < m_triangles.size(); i++)
+	{
+		const TRACE_TRIANGLE& triangle = m_triangles[i];
+		centers[i] = triangle.vertex0 + (triangle.edge1 + triangle.edge2) * (1.0f / 3.0f);
+	}
+
+	m_nodes.clear();
+	m_nodes.reserve(m_triangles.size() * 2);
+	BVH_NODE root;
+	root.firstIndex = 0;
+	root.triangleCount = (int)m_triangles.size();
+	m_nodes.push_back(root);
+	SubdivideNode(0, centers);
+
+	std::cout << "INFO: path tracer scene has " << m_triangles.size()
+		<< " triangles in " << m_nodes.size() << " hierarchy nodes" << std::endl;
+
+	m_accumulation.assign((size_t)m_width * m_height * 3, 0.0f);
+	m_passes = 0;
+
+	return(true);
+}
+
+/***********************************************************
+ *  GatherTriangles()
+ *
+ *  This method is used for transforming the triangles of the
+ *  drawn mesh parts into world space.
+ ***********************************************************/
+void PathTracer::GatherTriangles()
+{
+	m_triangles.clear();
+
+	for (size_t drawIndex = 0; drawIndex < m_draws.size(); drawIndex++)
+	{
+		const SceneManager::DRAW_COMMAND& draw = m_draws[drawIndex];
+		glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(draw.model)));
+
+		for (int part = 0; part < PrimitiveGeometry::PART_INDEX_COUNT; part++)
+		{
+			if (PrimitiveGeometry::IsPartDrawn(draw.mesh, (PrimitiveGeometry::PART_INDEX)part, draw.parts) == false)
+			{
+				continue;
+			}
+
+			const PrimitiveGeometry::MESH_DATA& mesh =
+				m_geometry.GetMeshPart(draw.mesh, (PrimitiveGeometry::PART_INDEX)part);
+
+			for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+			{
+				TRACE_TRIANGLE triangle;
+				glm::vec3 positions[3];
+				for (int corner = 0; corner < 3; corner++)
+				{
+					const PrimitiveGeometry::MESH_VERTEX& vertex = mesh.vertices[mesh.indices[i + corner]];
+					positions[corner] = glm::vec3(draw.model * glm::vec4(vertex.position, 1.0f));
+					triangle.normal[corner] = glm::normalize(normalMatrix * vertex.normal);
+					triangle.uv[corner] = vertex.uv * draw.uvScale;
+				}
+				triangle.vertex0 = positions[0];
+				triangle.edge1 = positions[1] - positions[0];
+				triangle.edge2 = positions[2] - positions[0];
+				triangle.drawIndex = (int)drawIndex;
+
+				// flattened triangles can never be hit
+				if (glm::length(glm::cross(triangle.edge1, triangle.edge2)) > 0.0f)
+				{
+					m_triangles.push_back(triangle);
+				}
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  SubdivideNode()
+ *
+ *  This method is used for splitting the triangles of a node
+ *  between two children where the surface area heuristic
+ *  says the split is cheaper to trace than the leaf.  The
+ *  split positions are chosen from evenly spaced bins along
+ *  each axis of the triangle centers.
+ ***********************************************************/
+void PathTracer::SubdivideNode(int nodeIndex, std::vector<glm::vec3>& centers)
+{
+	int first = m_nodes[nodeIndex].firstIndex;
+	int count = m_nodes[nodeIndex].triangleCount;
+
+	glm::vec3 boundsMin(g_NoHit);
+	glm::vec3 boundsMax(-g_NoHit);
+	glm::vec3 centerMin(g_NoHit);
+	glm::vec3 centerMax(-g_NoHit);
+	for (int i = first; i < first + count; i++)
+	{
+		const TRACE_TRIANGLE& triangle = m_triangles[i];
+		glm::vec3 corners[3] = {
+			triangle.vertex0, triangle.vertex0 + triangle.edge1, triangle.vertex0 + triangle.edge2 };
+		for (int corner = 0; corner < 3; corner++)
+		{
+			boundsMin = glm::min(boundsMin, corners[corner]);
+			boundsMax = glm::max(boundsMax, corners[corner]);
+		}
+		centerMin = glm::min(centerMin, centers[i]);
+		centerMax = glm::max(centerMax, centers[i]);
+	}
+	m_nodes[nodeIndex].boundsMin = boundsMin;
+	m_nodes[nodeIndex].boundsMax = boundsMax;
+
+	if (count <= g_MinLeafTriangles)
+	{
+		return;
+	}
+
+	float bestCost = (float)count;
+	int bestAxis = -1;
+	float bestSplit = 0.0f;
+	float invArea = 1.0f / std::max(SurfaceArea(boundsMin, boundsMax), 1.0e-12f);
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float extent = centerMax[axis] - centerMin[axis];
+		if (extent <= 0.0f)
+		{
+			continue;
+		}
+
+		int binCounts[g_SplitBins] = { 0 };
+		glm::vec3 binMin[g_SplitBins];
+		glm::vec3 binMax[g_SplitBins];
+		for (int bin = 0; bin < g_SplitBins; bin++)
+		{
+			binMin[bin] = glm::vec3(g_NoHit);
+			binMax[bin] = glm::vec3(-g_NoHit);
+		}
+
+		float binScale = (float)g_SplitBins / extent;
+		for (int i = first; i < first + count; i++)
+		{
+			const TRACE_TRIANGLE& triangle = m_triangles[i];
+			int bin = std::min(g_SplitBins - 1, (int)((centers[i][axis] - centerMin[axis]) * binScale));
+			binCounts[bin]++;
+			glm::vec3 corners[3] = {
+				triangle.vertex0, triangle.vertex0 + triangle.edge1, triangle.vertex0 + triangle.edge2 };
+			for (int corner = 0; corner < 3; corner++)
+			{
+				binMin[bin] = glm::min(binMin[bin], corners[corner]);
+				binMax[bin] = glm::max(binMax[bin], corners[corner]);
+			}
+		}
+
+		// sweep from the right to get the cost of every right side
+		float rightCosts[g_SplitBins];
+		glm::vec3 sweepMin(g_NoHit);
+		glm::vec3 sweepMax(-g_NoHit);
+		int sweepCount = 0;
+		for (int bin = g_SplitBins - 1; bin > 0; bin--)
+		{
+			sweepMin = glm::min(sweepMin, binMin[bin]);
+			sweepMax = glm::max(sweepMax, binMax[bin]);
+			sweepCount += binCounts[bin];
+			rightCosts[bin] = (sweepCount > 0) ? SurfaceArea(sweepMin, sweepMax) * sweepCount : 0.0f;
+		}
+
+		sweepMin = glm::vec3(g_NoHit);
+		sweepMax = glm::vec3(-g_NoHit);
+		sweepCount = 0;
+		for (int bin = 0; bin < g_SplitBins - 1; bin++)
+		{
+			sweepMin = glm::min(sweepMin, binMin[bin]);
+			sweepMax = glm::max(sweepMax, binMax[bin]);
+			sweepCount += binCounts[bin];
+			if ((sweepCount == 0) || (sweepCount == count))
+			{
+				continue;
+			}
+
+			float cost = g_TraversalCost +
+				(SurfaceArea(sweepMin, sweepMax) * sweepCount + rightCosts[bin + 1]) * invArea;
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = centerMin[axis] + (float)(bin + 1) / binScale;
+			}
+		}
+	}
+
+	// keep the node as a leaf when no split is cheaper
+	if (bestAxis < 0)
+	{
+		return;
+	}
+
+	int middle = first;
+	for (int i = first; i < first + count; i++)
+	{
+		if (centers[i][bestAxis] < bestSplit)
+		{
+			std::swap(m_triangles[i], m_triangles[middle]);
+			std::swap(centers[i], centers[middle]);
+			middle++;
+		}
+	}
+	if ((middle == first) || (middle == first + count))
+	{
+		return;
+	}
+
+	int leftIndex = (int)m_nodes.size();
+	BVH_NODE child;
+	child.firstIndex = first;
+	child.triangleCount = middle - first;
+	m_nodes.push_back(child);
+	child.firstIndex = middle;
+	child.triangleCount = first + count - middle;
+	m_nodes.push_back(child);
+
+	m_nodes[nodeIndex].firstIndex = leftIndex;
+	m_nodes[nodeIndex].triangleCount = 0;
+
+	SubdivideNode(leftIndex, centers);
+	SubdivideNode(leftIndex + 1, centers);
+}
+
+/***********************************************************
+ *  TracePacket()
+ *
+ *  This method is used for finding the closest triangle hit
+ *  by each active ray of a packet.  The packet walks the
+ *  hierarchy together, entering a node when any of its rays
+ *  hits the node bounds, and each triangle is tested against
+ *  all four rays at once.
+ ***********************************************************/
+void PathTracer::TracePacket(const RAY_PACKET& rays, HIT_PACKET& hits) const
+{
+	float inverseX[4];
+	float inverseY[4];
+	float inverseZ[4];
+	int firstLane = 0;
+	for (int lane = 0; lane < 4; lane++)
+	{
+		hits.distance[lane] = rays.maxDistance[lane];
+		hits.triangle[lane] = -1;
+		hits.u[lane] = 0.0f;
+		hits.v[lane] = 0.0f;
+		inverseX[lane] = 1.0f / rays.directionX[lane];
+		inverseY[lane] = 1.0f / rays.directionY[lane];
+		inverseZ[lane] = 1.0f / rays.directionZ[lane];
+		if ((rays.activeMask & (1 << lane)) && !(rays.activeMask & (1 << firstLane)))
+		{
+			firstLane = lane;
+		}
+	}
+	if (rays.activeMask == 0)
+	{
+		return;
+	}
+
+	// visit the children nearer to the first active ray first
+	const bool bNegative[3] = {
+		rays.directionX[firstLane] < 0.0f,
+		rays.directionY[firstLane] < 0.0f,
+		rays.directionZ[firstLane] < 0.0f };
+
+#ifdef SCENE_SIMD_SSE2
+	const __m128 originX = _mm_loadu_ps(rays.originX);
+	const __m128 originY = _mm_loadu_ps(rays.originY);
+	const __m128 originZ = _mm_loadu_ps(rays.originZ);
+	const __m128 directionX = _mm_loadu_ps(rays.directionX);
+	const __m128 directionY = _mm_loadu_ps(rays.directionY);
+	const __m128 directionZ = _mm_loadu_ps(rays.directionZ);
+	const __m128 invX = _mm_loadu_ps(inverseX);
+	const __m128 invY = _mm_loadu_ps(inverseY);
+	const __m128 invZ = _mm_loadu_ps(inverseZ);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 epsilon = _mm_set1_ps(g_RayOffset * 0.1f);
+	const __m128 active = _mm_castsi128_ps(_mm_setr_epi32(
+		(rays.activeMask & 1) ? -1 : 0, (rays.activeMask & 2) ? -1 : 0,
+		(rays.activeMask & 4) ? -1 : 0, (rays.activeMask & 8) ? -1 : 0));
+	__m128 closest = _mm_loadu_ps(hits.distance);
+	__m128 closestU = zero;
+	__m128 closestV = zero;
+	__m128i closestTriangle = _mm_set1_epi32(-1);
+#endif
+
+	int stack[64];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const BVH_NODE& node = m_nodes[stack[--stackSize]];
+
+#ifdef SCENE_SIMD_SSE2
+		// slab test of the node bounds against all four rays
+		__m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMin.x), originX), invX);
+		__m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMax.x), originX), invX);
+		__m128 nearest = _mm_min_ps(t0, t1);
+		__m128 farthest = _mm_max_ps(t0, t1);
+		t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMin.y), originY), invY);
+		t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMax.y), originY), invY);
+		nearest = _mm_max_ps(nearest, _mm_min_ps(t0, t1));
+		farthest = _mm_min_ps(farthest, _mm_max_ps(t0, t1));
+		t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMin.z), originZ), invZ);
+		t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMax.z), originZ), invZ);
+		nearest = _mm_max_ps(nearest, _mm_min_ps(t0, t1));
+		farthest = _mm_min_ps(farthest, _mm_max_ps(t0, t1));
+		__m128 boxHit = _mm_and_ps(active, _mm_and_ps(
+			_mm_cmpge_ps(farthest, _mm_max_ps(nearest, zero)),
+			_mm_cmplt_ps(nearest, closest)));
+		if (_mm_movemask_ps(boxHit) == 0)
+		{
+			continue;
+		}
+#else
+		bool bBoxHit = false;
+		for (int lane = 0; (lane < 4) && (bBoxHit == false); lane++)
+		{
+			if ((rays.activeMask & (1 << lane)) == 0)
+			{
+				continue;
+			}
+			const float origin[3] = { rays.originX[lane], rays.originY[lane], rays.originZ[lane] };
+			const float inverse[3] = { inverseX[lane], inverseY[lane], inverseZ[lane] };
+			float nearest = 0.0f;
+			float farthest = hits.distance[lane];
+			for (int axis = 0; axis < 3; axis++)
+			{
+				float t0 = (node.boundsMin[axis] - origin[axis]) * inverse[axis];
+				float t1 = (node.boundsMax[axis] - origin[axis]) * inverse[axis];
+				nearest = std::max(nearest, std::min(t0, t1));
+				farthest = std::min(farthest, std::max(t0, t1));
+			}
+			bBoxHit = (nearest <= farthest);
+		}
+		if (bBoxHit == false)
+		{
+			continue;
+		}
+#endif
+
+		if (node.triangleCount == 0)
+		{
+			// the near child is pushed last so it is visited first
+			const BVH_NODE& left = m_nodes[node.firstIndex];
+			const BVH_NODE& right = m_nodes[node.firstIndex + 1];
+			glm::vec3 delta = (right.boundsMin + right.boundsMax) - (left.boundsMin + left.boundsMax);
+			int axis = 0;
+			if (std::fabs(delta.y) > std::fabs(delta[axis])) axis = 1;
+			if (std::fabs(delta.z) > std::fabs(delta[axis])) axis = 2;
+			bool bRightFirst = (delta[axis] < 0.0f) != bNegative[axis];
+			if (stackSize + 2 <= 64)
+			{
+				stack[stackSize++] = bRightFirst ? node.firstIndex : node.firstIndex + 1;
+				stack[stackSize++] = bRightFirst ? node.firstIndex + 1 : node.firstIndex;
+			}
+			continue;
+		}
+
+		for (int index = node.firstIndex; index < node.firstIndex + node.triangleCount; index++)
+		{
+			const TRACE_TRIANGLE& triangle = m_triangles[index];
+
+#ifdef SCENE_SIMD_SSE2
+			// Moller-Trumbore intersection for all four rays
+			const __m128 edge1X = _mm_set1_ps(triangle.edge1.x);
+			const __m128 edge1Y = _mm_set1_ps(triangle.edge1.y);
+			const __m128 edge1Z = _mm_set1_ps(triangle.edge1.z);
+			const __m128 edge2X = _mm_set1_ps(triangle.edge2.x);
+			const __m128 edge2Y = _mm_set1_ps(triangle.edge2.y);
+			const __m128 edge2Z = _mm_set1_ps(triangle.edge2.z);
+
+			__m128 pX = _mm_sub_ps(_mm_mul_ps(directionY, edge2Z), _mm_mul_ps(directionZ, edge2Y));
+			__m128 pY = _mm_sub_ps(_mm_mul_ps(directionZ, edge2X), _mm_mul_ps(directionX, edge2Z));
+			__m128 pZ = _mm_sub_ps(_mm_mul_ps(directionX, edge2Y), _mm_mul_ps(directionY, edge2X));
+			__m128 determinant = _mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(edge1X, pX), _mm_mul_ps(edge1Y, pY)), _mm_mul_ps(edge1Z, pZ));
+			__m128 inverseDeterminant = _mm_div_ps(one, determinant);
+
+			__m128 sX = _mm_sub_ps(originX, _mm_set1_ps(triangle.vertex0.x));
+			__m128 sY = _mm_sub_ps(originY, _mm_set1_ps(triangle.vertex0.y));
+			__m128 sZ = _mm_sub_ps(originZ, _mm_set1_ps(triangle.vertex0.z));
+			__m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(sX, pX), _mm_mul_ps(sY, pY)), _mm_mul_ps(sZ, pZ)), inverseDeterminant);
+
+			__m128 qX = _mm_sub_ps(_mm_mul_ps(sY, edge1Z), _mm_mul_ps(sZ, edge1Y));
+			__m128 qY = _mm_sub_ps(_mm_mul_ps(sZ, edge1X), _mm_mul_ps(sX, edge1Z));
+			__m128 qZ = _mm_sub_ps(_mm_mul_ps(sX, edge1Y), _mm_mul_ps(sY, edge1X));
+			__m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(directionX, qX), _mm_mul_ps(directionY, qY)), _mm_mul_ps(directionZ, qZ)), inverseDeterminant);
+			__m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(edge2X, qX), _mm_mul_ps(edge2Y, qY)), _mm_mul_ps(edge2Z, qZ)), inverseDeterminant);
+
+			__m128 hit = _mm_and_ps(active, _mm_cmpneq_ps(determinant, zero));
+			hit = _mm_and_ps(hit, _mm_cmpge_ps(u, zero));
+			hit = _mm_and_ps(hit, _mm_cmpge_ps(v, zero));
+			hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), one));
+			hit = _mm_and_ps(hit, _mm_cmpgt_ps(t, epsilon));
+			hit = _mm_and_ps(hit, _mm_cmplt_ps(t, closest));
+			if (_mm_movemask_ps(hit) == 0)
+			{
+				continue;
+			}
+
+			// keep the nearer hits without branching per ray
+			closest = _mm_or_ps(_mm_and_ps(hit, t), _mm_andnot_ps(hit, closest));
+			closestU = _mm_or_ps(_mm_and_ps(hit, u), _mm_andnot_ps(hit, closestU));
+			closestV = _mm_or_ps(_mm_and_ps(hit, v), _mm_andnot_ps(hit, closestV));
+			__m128i hitInteger = _mm_castps_si128(hit);
+			closestTriangle = _mm_or_si128(
+				_mm_and_si128(hitInteger, _mm_set1_epi32(index)),
+				_mm_andnot_si128(hitInteger, closestTriangle));
+#else
+			for (int lane = 0; lane < 4; lane++)
+			{
+				if ((rays.activeMask & (1 << lane)) == 0)
+				{
+					continue;
+				}
+				glm::vec3 origin(rays.originX[lane], rays.originY[lane], rays.originZ[lane]);
+				glm::vec3 direction(rays.directionX[lane], rays.directionY[lane], rays.directionZ[lane]);
+				glm::vec3 p = glm::cross(direction, triangle.edge2);
+				float determinant = glm::dot(triangle.edge1, p);
+				if (determinant == 0.0f)
+				{
+					continue;
+				}
+				float inverseDeterminant = 1.0f / determinant;
+				glm::vec3 s = origin - triangle.vertex0;
+				float u = glm::dot(s, p) * inverseDeterminant;
+				glm::vec3 q = glm::cross(s, triangle.edge1);
+				float v = glm::dot(direction, q) * inverseDeterminant;
+				float t = glm::dot(triangle.edge2, q) * inverseDeterminant;
+				if ((u >= 0.0f) && (v >= 0.0f) && (u + v <= 1.0f) &&
+					(t > g_RayOffset * 0.1f) && (t < hits.distance[lane]))
+				{
+					hits.distance[lane] = t;
+					hits.u[lane] = u;
+					hits.v[lane] = v;
+					hits.triangle[lane] = index;
+				}
+			}
+#endif
+		}
+	}
+
+#ifdef SCENE_SIMD_SSE2
+	_mm_storeu_ps(hits.distance, closest);
+	_mm_storeu_ps(hits.u, closestU);
+	_mm_storeu_ps(hits.v, closestV);
+	_mm_storeu_si128((__m128i*)hits.triangle, closestTriangle);
+#endif
+}
+
+/***********************************************************
+ *  TraceQuad()
+ *
+ *  This method is used for tracing one path through each
+ *  pixel of a 2x2 block.  The four paths stay together as a
+ *  packet for every bounce, and the shadow rays toward each
+ *  light are traced as packets as well.  The point lights
+ *  have no falloff and are scaled by pi so a white diffuse
+ *  surface facing a light gets the same direct light as in
+ *  the scene shader, while shadows, bounced light and
+ *  translucency come from tracing instead of the ambient
+ *  approximation.
+ ***********************************************************/
+void PathTracer::TraceQuad(int x, int y, unsigned int seed, glm::vec3 radiance[4], long long& rays) const
+{
+	RAY_PACKET packet;
+	packet.activeMask = 0;
+	unsigned int random[4];
+	glm::vec3 throughput[4];
+	int bounces[4];
+	int transmissions[4];
+
+	for (int lane = 0; lane < 4; lane++)
+	{
+		radiance[lane] = glm::vec3(0.0f);
+		throughput[lane] = glm::vec3(1.0f);
+		bounces[lane] = 0;
+		transmissions[lane] = 0;
+		random[lane] = Hash(seed + (unsigned int)lane * 0x9e3779b9u);
+
+		int pixelX = x + (lane & 1);
+		int pixelY = y + (lane >> 1);
+		packet.maxDistance[lane] = g_NoHit;
+		packet.originX[lane] = packet.originY[lane] = packet.originZ[lane] = 0.0f;
+		packet.directionX[lane] = packet.directionY[lane] = packet.directionZ[lane] = 1.0f;
+		if ((pixelX >= m_width) || (pixelY >= m_height))
+		{
+			continue;
+		}
+
+		// jitter the ray inside the pixel for antialiasing
+		float ndcX = ((float)pixelX + Random(random[lane])) / (float)m_width * 2.0f - 1.0f;
+		float ndcY = 1.0f - ((float)pixelY + Random(random[lane])) / (float)m_height * 2.0f;
+		glm::vec4 nearPoint = m_inverseViewProjection * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+		glm::vec4 farPoint = m_inverseViewProjection * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+		glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+		glm::vec3 direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - origin);
+
+		packet.originX[lane] = origin.x;
+		packet.originY[lane] = origin.y;
+		packet.originZ[lane] = origin.z;
+		packet.directionX[lane] = direction.x;
+		packet.directionY[lane] = direction.y;
+		packet.directionZ[lane] = direction.z;
+		packet.activeMask |= 1 << lane;
+	}
+
+	HIT_PACKET hits;
+	while (packet.activeMask != 0)
+	{
+		TracePacket(packet, hits);
+		for (int lane = 0; lane < 4; lane++)
+		{
+			rays += (packet.activeMask >> lane) & 1;
+		}
+
+		// shading inputs of each lane kept for the shadow rays
+		glm::vec3 position[4];
+		glm::vec3 normal[4];
+		glm::vec3 viewDirection[4];
+		glm::vec3 diffuse[4];
+		glm::vec3 specular[4];
+		float shininess[4];
+		int shadeMask = 0;
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			if ((packet.activeMask & (1 << lane)) == 0)
+			{
+				continue;
+			}
+
+			glm::vec3 origin(packet.originX[lane], packet.originY[lane], packet.originZ[lane]);
+			glm::vec3 direction(packet.directionX[lane], packet.directionY[lane], packet.directionZ[lane]);
+
+			if (hits.triangle[lane] < 0)
+			{
+				radiance[lane] += throughput[lane] * m_environmentColor;
+				packet.activeMask &= ~(1 << lane);
+				continue;
+			}
+
+			const TRACE_TRIANGLE& triangle = m_triangles[hits.triangle[lane]];
+			const SceneManager::DRAW_COMMAND& draw = m_draws[triangle.drawIndex];
+			float w = 1.0f - hits.u[lane] - hits.v[lane];
+			glm::vec3 hitPosition = origin + direction * hits.distance[lane];
+
+			// surfaces are two sided, as the scene draws without culling
+			glm::vec3 geometricNormal = glm::normalize(glm::cross(triangle.edge1, triangle.edge2));
+			glm::vec3 shadingNormal = glm::normalize(
+				triangle.normal[0] * w + triangle.normal[1] * hits.u[lane] + triangle.normal[2] * hits.v[lane]);
+			if (glm::dot(geometricNormal, direction) > 0.0f)
+			{
+				geometricNormal = -geometricNormal;
+			}
+			if (glm::dot(shadingNormal, geometricNormal) < 0.0f)
+			{
+				shadingNormal = -shadingNormal;
+			}
+
+			glm::vec3 baseColor(draw.color);
+			float alpha = draw.color.a;
+			if ((draw.bUseTexture == true) && (draw.textureSlot >= 0) &&
+				(draw.textureSlot < (int)m_textures.size()) &&
+				(m_textures[draw.textureSlot].pixels.empty() == false))
+			{
+				glm::vec2 uv = triangle.uv[0] * w + triangle.uv[1] * hits.u[lane] + triangle.uv[2] * hits.v[lane];
+				baseColor = SampleTexture(draw.textureSlot, uv);
+				alpha = 1.0f;
+			}
+
+			// translucent surfaces let part of the paths through
+			if ((alpha < 1.0f) && (Random(random[lane]) >= alpha) &&
+				(transmissions[lane] < g_MaxTransmissions))
+			{
+				transmissions[lane]++;
+				glm::vec3 next = hitPosition + direction * g_RayOffset;
+				packet.originX[lane] = next.x;
+				packet.originY[lane] = next.y;
+				packet.originZ[lane] = next.z;
+				continue;
+			}
+
+			if (draw.materialIndex < 0)
+			{
+				packet.activeMask &= ~(1 << lane);
+				continue;
+			}
+
+			const SceneManager::OBJECT_MATERIAL& material = m_materials[draw.materialIndex];
+			position[lane] = hitPosition + geometricNormal * g_RayOffset;
+			normal[lane] = shadingNormal;
+			viewDirection[lane] = -direction;
+			diffuse[lane] = baseColor * material.diffuseColor;
+			specular[lane] = material.specularColor;
+			shininess[lane] = std::max(material.shininess, 1.0f);
+			shadeMask |= 1 << lane;
+		}
+
+		// direct light from each light, with one shadow packet per light
+		for (size_t light = 0; (light < m_lights.size()) && (shadeMask != 0); light++)
+		{
+			RAY_PACKET shadow;
+			glm::vec3 transmittance[4];
+			shadow.activeMask = 0;
+			for (int lane = 0; lane < 4; lane++)
+			{
+				transmittance[lane] = glm::vec3(0.0f);
+				shadow.originX[lane] = shadow.originY[lane] = shadow.originZ[lane] = 0.0f;
+				shadow.directionX[lane] = shadow.directionY[lane] = shadow.directionZ[lane] = 1.0f;
+				shadow.maxDistance[lane] = 0.0f;
+				if ((shadeMask & (1 << lane)) == 0)
+				{
+					continue;
+				}
+
+				glm::vec3 toLight = m_lights[light].position - position[lane];
+				float distance = glm::length(toLight);
+				glm::vec3 lightDirection = toLight / distance;
+				if (glm::dot(lightDirection, normal[lane]) <= 0.0f)
+				{
+					continue;
+				}
+
+				shadow.originX[lane] = position[lane].x;
+				shadow.originY[lane] = position[lane].y;
+				shadow.originZ[lane] = position[lane].z;
+				shadow.directionX[lane] = lightDirection.x;
+				shadow.directionY[lane] = lightDirection.y;
+				shadow.directionZ[lane] = lightDirection.z;
+				shadow.maxDistance[lane] = distance;
+				transmittance[lane] = glm::vec3(1.0f);
+				shadow.activeMask |= 1 << lane;
+			}
+
+			// translucent surfaces dim the light instead of blocking it
+			HIT_PACKET shadowHits;
+			int visibleMask = shadow.activeMask;
+			for (int step = 0; (step < g_MaxTransmissions) && (shadow.activeMask != 0); step++)
+			{
+				TracePacket(shadow, shadowHits);
+				for (int lane = 0; lane < 4; lane++)
+				{
+					if ((shadow.activeMask & (1 << lane)) == 0)
+					{
+						continue;
+					}
+					rays++;
+					if (shadowHits.triangle[lane] < 0)
+					{
+						shadow.activeMask &= ~(1 << lane);
+						continue;
+					}
+
+					const SceneManager::DRAW_COMMAND& blocker = m_draws[m_triangles[shadowHits.triangle[lane]].drawIndex];
+					if ((blocker.bUseTexture == true) || (blocker.color.a >= 1.0f))
+					{
+						visibleMask &= ~(1 << lane);
+						shadow.activeMask &= ~(1 << lane);
+						continue;
+					}
+
+					transmittance[lane] *= 1.0f - blocker.color.a;
+					float travelled = shadowHits.distance[lane] + g_RayOffset;
+					shadow.originX[lane] += shadow.directionX[lane] * travelled;
+					shadow.originY[lane] += shadow.directionY[lane] * travelled;
+					shadow.originZ[lane] += shadow.directionZ[lane] * travelled;
+					shadow.maxDistance[lane] -= travelled;
+				}
+			}
+			visibleMask &= ~shadow.activeMask;
+
+			for (int lane = 0; lane < 4; lane++)
+			{
+				if ((visibleMask & (1 << lane)) == 0)
+				{
+					continue;
+				}
+
+				const SceneManager::LIGHT_SOURCE& source = m_lights[light];
+				glm::vec3 lightDirection(shadow.directionX[lane], shadow.directionY[lane], shadow.directionZ[lane]);
+				float cosine = glm::dot(normal[lane], lightDirection);
+				glm::vec3 reflected = glm::reflect(-lightDirection, normal[lane]);
+				float lobe = std::pow(std::max(glm::dot(reflected, viewDirection[lane]), 0.0f), shininess[lane]);
+
+				// normalized Phong BRDF times the light scaled by pi
+				glm::vec3 brdf = diffuse[lane] +
+					specular[lane] * ((shininess[lane] + 2.0f) * 0.5f * lobe);
+				radiance[lane] += throughput[lane] * transmittance[lane] * source.diffuseColor * brdf * cosine;
+			}
+		}
+
+		// choose the next bounce of each shaded path
+		for (int lane = 0; lane < 4; lane++)
+		{
+			if ((shadeMask & (1 << lane)) == 0)
+			{
+				continue;
+			}
+
+			float diffuseWeight = Luminance(diffuse[lane]);
+			float specularWeight = Luminance(specular[lane]);
+			if ((bounces[lane] >= m_maxBounces) || (diffuseWeight + specularWeight <= 0.0f))
+			{
+				packet.activeMask &= ~(1 << lane);
+				continue;
+			}
+			bounces[lane]++;
+
+			float diffuseChance = diffuseWeight / (diffuseWeight + specularWeight);
+			glm::vec3 direction;
+			if (Random(random[lane]) < diffuseChance)
+			{
+				// cosine weighted directions cancel the diffuse BRDF
+				float cosTheta = std::sqrt(Random(random[lane]));
+				direction = DirectionAround(normal[lane], cosTheta, 2.0f * g_Pi * Random(random[lane]));
+				throughput[lane] *= diffuse[lane] / diffuseChance;
+			}
+			else
+			{
+				glm::vec3 reflected = glm::reflect(-viewDirection[lane], normal[lane]);
+				float cosTheta = std::pow(Random(random[lane]), 1.0f / (shininess[lane] + 1.0f));
+				direction = DirectionAround(reflected, cosTheta, 2.0f * g_Pi * Random(random[lane]));
+				float cosine = glm::dot(direction, normal[lane]);
+				if (cosine <= 0.0f)
+				{
+					packet.activeMask &= ~(1 << lane);
+					continue;
+				}
+				throughput[lane] *= specular[lane] *
+					((shininess[lane] + 2.0f) / (shininess[lane] + 1.0f) * cosine / (1.0f - diffuseChance));
+			}
+
+			// end dim paths early, keeping the average unbiased
+			if (bounces[lane] > g_MinBounces)
+			{
+				float survival = std::min(std::max(throughput[lane].r,
+					std::max(throughput[lane].g, throughput[lane].b)), 0.95f);
+				if (Random(random[lane]) >= survival)
+				{
+					packet.activeMask &= ~(1 << lane);
+					continue;
+				}
+				throughput[lane] /= survival;
+			}
+
+			packet.originX[lane] = position[lane].x;
+			packet.originY[lane] = position[lane].y;
+			packet.originZ[lane] = position[lane].z;
+			packet.directionX[lane] = direction.x;
+			packet.directionY[lane] = direction.y;
+			packet.directionZ[lane] = direction.z;
+		}
+	}
+}
+
+/***********************************************************
+ *  SampleTexture()
+ *
+ *  This method is used for sampling a texture slot with
+ *  bilinear filtering and repeating coordinates.  Filtering
+ *  across mipmap levels is not needed since every pixel
+ *  averages many jittered samples.
+ ***********************************************************/
+glm::vec3 PathTracer::SampleTexture(int textureSlot, glm::vec2 uv) const
+{
+	const TRACE_TEXTURE& texture = m_textures[textureSlot];
+	float x = uv.x * texture.width - 0.5f;
+	float y = uv.y * texture.height - 0.5f;
+	float floorX = std::floor(x);
+	float floorY = std::floor(y);
+	float fx = x - floorX;
+	float fy = y - floorY;
+
+	int x0 = ((int)floorX % texture.width + texture.width) % texture.width;
+	int y0 = ((int)floorY % texture.height + texture.height) % texture.height;
+	int x1 = (x0 + 1) % texture.width;
+	int y1 = (y0 + 1) % texture.height;
+
+	const unsigned char* p00 = &texture.pixels[((size_t)y0 * texture.width + x0) * 4];
+	const unsigned char* p10 = &texture.pixels[((size_t)y0 * texture.width + x1) * 4];
+	const unsigned char* p01 = &texture.pixels[((size_t)y1 * texture.width + x0) * 4];
+	const unsigned char* p11 = &texture.pixels[((size_t)y1 * texture.width + x1) * 4];
+
+	glm::vec3 color;
+	for (int c = 0; c < 3; c++)
+	{
+		float top = p00[c] + (p10[c] - p00[c]) * fx;
+		float bottom = p01[c] + (p11[c] - p01[c]) * fx;
+		color[c] = (top + (bottom - top) * fy) * (1.0f / 255.0f);
+	}
+	return(color);
+}
+
+/***********************************************************
+ *  NextTile()
+ *
+ *  This method is used for getting the next tile for a
+ *  thread.  Each thread starts with an equal share of the
+ *  tiles, and once its own share is done it steals the
+ *  remaining tiles of the other threads, so slow tiles at
+ *  the end of one share do not leave the others idle.
+ ***********************************************************/
+bool PathTracer::NextTile(int threadIndex, int& tileIndex)
+{
+	int threadCount = (int)m_tileEnd.size();
+	for (int offset = 0; offset < threadCount; offset++)
+	{
+		int victim = (threadIndex + offset) % threadCount;
+		if (m_tileNext[victim].load() >= m_tileEnd[victim])
+		{
+			continue;
+		}
+
+		int tile = m_tileNext[victim].fetch_add(1);
+		if (tile < m_tileEnd[victim])
+		{
+			tileIndex = tile;
+			return(true);
+		}
+	}
+	return(false);
+}
+
+/***********************************************************
+ *  RenderTile()
+ *
+ *  This method is used for adding one sample to every pixel
+ *  of a tile.  Only one thread renders a tile in each pass,
+ *  so the pixel totals are updated without locking.
+ ***********************************************************/
+void PathTracer::RenderTile(int tileIndex, long long& rays)
+{
+	int tilesX = (m_width + g_TileSize - 1) / g_TileSize;
+	int tileX0 = (tileIndex % tilesX) * g_TileSize;
+	int tileY0 = (tileIndex / tilesX) * g_TileSize;
+	int tileX1 = std::min(tileX0 + g_TileSize, m_width);
+	int tileY1 = std::min(tileY0 + g_TileSize, m_height);
+	unsigned int passSeed = Hash((unsigned int)m_passes * 0x68e31da4u + 1u);
+
+	for (int y = tileY0; y < tileY1; y += 2)
+	{
+		for (int x = tileX0; x < tileX1; x += 2)
+		{
+			glm::vec3 radiance[4];
+			TraceQuad(x, y, Hash((unsigned int)(y * m_width + x)) ^ passSeed, radiance, rays);
+
+			for (int lane = 0; lane < 4; lane++)
+			{
+				int pixelX = x + (lane & 1);
+				int pixelY = y + (lane >> 1);
+				if ((pixelX >= tileX1) || (pixelY >= tileY1))
+				{
+					continue;
+				}
+
+				// a degenerate normal can turn a sample into NaN,
+				// which would spoil the pixel for every later pass
+				glm::vec3 sample = radiance[lane];
+				if (!(sample.r == sample.r) || !(sample.g == sample.g) || !(sample.b == sample.b))
+				{
+					sample = glm::vec3(0.0f);
+				}
+
+				float* total = &m_accumulation[((size_t)pixelY * m_width + pixelX) * 3];
+				total[0] += sample.r;
+				total[1] += sample.g;
+				total[2] += sample.b;
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  RenderPass()
+ *
+ *  This method is used for adding one more sample to every
+ *  pixel, with the tiles of the image shared between the
+ *  worker threads.
+ ***********************************************************/
+void PathTracer::RenderPass()
+{
+	if (m_nodes.empty() == true)
+	{
+		return;
+	}
+
+	double start = GetMilliseconds();
+
+	int tilesX = (m_width + g_TileSize - 1) / g_TileSize;
+	int tilesY = (m_height + g_TileSize - 1) / g_TileSize;
+	int tileCount = tilesX * tilesY;
+	int threadCount = std::max(1, std::min(m_workerThreads, tileCount));
+
+	m_tileNext = std::vector<std::atomic<int> >(threadCount);
+	m_tileEnd.resize(threadCount);
+	for (int thread = 0; thread < threadCount; thread++)
+	{
+		m_tileNext[thread] = (int)((long long)tileCount * thread / threadCount);
+		m_tileEnd[thread] = (int)((long long)tileCount * (thread + 1) / threadCount);
+	}
+	m_rayCount = 0;
+
+	std::vector<std::thread> workers;
+	for (int thread = 0; thread < threadCount; thread++)
+	{
+		auto work = [this, thread]()
+		{
+			long long rays = 0;
+			int tile;
+			while (NextTile(thread, tile) == true)
+			{
+				RenderTile(tile, rays);
+			}
+			m_rayCount += rays;
+		};
+
+		// the calling thread renders the first share itself
+		if (thread + 1 < threadCount)
+		{
+			workers.push_back(std::thread(work));
+		}
+		else
+		{
+			work();
+		}
+	}
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+
+	m_passes++;
+	m_stats.milliseconds = GetMilliseconds() - start;
+	m_stats.rays = m_rayCount;
+}
+
+/***********************************************************
+ *  GetPassCount()
+ *
+ *  This method is used for getting the number of samples
+ *  summed into every pixel so far.
+ ***********************************************************/
+int PathTracer::GetPassCount() const
+{
+	return(m_passes);
+}
+
+/***********************************************************
+ *  GetPassStats()
+ *
+ *  This method is used for getting the time taken and the
+ *  number of rays traced by the last pass.
+ ***********************************************************/
+const PathTracer::PASS_STATS& PathTracer::GetPassStats() const
+{
+	return(m_stats);
+}
+
+/***********************************************************
+ *  SaveImage()
+ *
+ *  This method is used for writing the average of the passes
+ *  so far to a binary PPM file, clamped like the scene
+ *  shader output.
+ ***********************************************************/
+bool PathTracer::SaveImage(const char* filename) const
+{
+	FILE* pFile = fopen(filename, "wb");
+	if (NULL == pFile)
+	{
+		return(false);
+	}
+
+	fprintf(pFile, "P6\n%d %d\n255\n", m_width, m_height);
+
+	float scale = (m_passes > 0) ? 1.0f / (float)m_passes : 0.0f;
+	std::vector<unsigned char> row((size_t)m_width * 3);
+	bool bReturn = true;
+	for (int y = 0; (y < m_height) && bReturn; y++)
+	{
+		const float* source = &m_accumulation[(size_t)y * m_width * 3];
+		for (int i = 0; i < m_width * 3; i++)
+		{
+			float value = std::min(std::max(source[i] * scale, 0.0f), 1.0f);
+			row[i] = (unsigned char)(value * 255.0f + 0.5f);
+		}
+		bReturn = (fwrite(&row[0], 1, row.size(), pFile) == row.size());
+	}
+
+	fclose(pFile);
+	return(bReturn);
+}
+
+/***********************************************************
+ *  SaveCheckpoint()
+ *
+ *  This method is used for saving the pixel totals and the
+ *  pass count, so a long render can be stopped and resumed.
+ *  The file is written under a temporary name first so an
+ *  interrupted save never replaces a good checkpoint.
+ ***********************************************************/
+bool PathTracer::SaveCheckpoint(const char* filename) const
+{
+	std::string temporaryName = std::string(filename) + ".tmp";
+	FILE* pFile = fopen(temporaryName.c_str(), "wb");
+	if (NULL == pFile)
+	{
+		return(false);
+	}
+
+	CHECKPOINT_HEADER header;
+	memcpy(header.magic, g_CheckpointMagic, sizeof(g_CheckpointMagic));
+	header.width = m_width;
+	header.height = m_height;
+	header.passes = m_passes;
+
+	bool bReturn =
+		(fwrite(&header, sizeof(header), 1, pFile) == 1) &&
+		(fwrite(&m_accumulation[0], sizeof(float), m_accumulation.size(), pFile) == m_accumulation.size());
+	bReturn = (fclose(pFile) == 0) && bReturn;
+
+	if (bReturn == true)
+	{
+		remove(filename);
+		bReturn = (rename(temporaryName.c_str(), filename) == 0);
+	}
+	return(bReturn);
+}
+
+/***********************************************************
+ *  LoadCheckpoint()
+ *
+ *  This method is used for resuming from saved pixel totals,
+ *  which must match the current image size.  Later passes
+ *  use their own random numbers, so a resumed render gives
+ *  the same image as one that was never stopped.
+ ***********************************************************/
+bool PathTracer::LoadCheckpoint(const char* filename)
+{
+	FILE* pFile = fopen(filename, "rb");
+	if (NULL == pFile)
+	{
+		return(false);
+	}
+
+	CHECKPOINT_HEADER header;
+	bool bReturn = (fread(&header, sizeof(header), 1, pFile) == 1) &&
+		(memcmp(header.magic, g_CheckpointMagic, sizeof(g_CheckpointMagic)) == 0) &&
+		(header.width == m_width) && (header.height == m_height) && (header.passes >= 0);
+
+	if (bReturn == true)
+	{
+		std::vector<float> accumulation(m_accumulation.size());
+		bReturn = (fread(&accumulation[0], sizeof(float), accumulation.size(), pFile) == accumulation.size());
+		if (bReturn == true)
+		{
+			m_accumulation.swap(accumulation);
+			m_passes = header.passes;
+		}
+	}
+	else
+	{
+		std::cout << "ERROR: checkpoint " << filename << " does not match the image size" << std::endl;
+	}
+
+	fclose(pFile);
+	return(bReturn);
+}
@@ -0,0 +1,174 @@
+///////////////////////////////////////////////////////////////////////////////
+// pathtracer.h
+// ============
+// render reference images of the scene with a progressive CPU path tracer
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+#include "PrimitiveGeometry.h"
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <vector>
+
+/***********************************************************
+ *  PathTracer
+ *
+ *  This class renders ground truth images of the draw list
+ *  recorded by the scene manager.  The triangles of every
+ *  draw are gathered into one bounding volume hierarchy
+ *  built with the surface area heuristic, and rays are
+ *  traced four at a time through it, one packet for each
+ *  2x2 block of pixels.  Each pass adds one sample to every
+ *  pixel, so the image improves for as long as passes are
+ *  rendered, and the running totals can be saved and later
+ *  resumed from a checkpoint file.
+ ***********************************************************/
+class PathTracer
+{
+public:
+	// constructor
+	PathTracer();
+
+	// properties for the timing and size of the last pass
+	struct PASS_STATS
+	{
+		double milliseconds;
+		long long rays;
+	};
+
+private:
+	// properties for one triangle of the scene in world space
+	struct TRACE_TRIANGLE
+	{
+		glm::vec3 vertex0;
+		glm::vec3 edge1;
+		glm::vec3 edge2;
+		glm::vec3 normal[3];
+		glm::vec2 uv[3];
+		int drawIndex;
+	};
+
+	// properties for one node of the bounding volume hierarchy,
+	// where leaves have a triangle count and inner nodes keep
+	// their first child, with the second one right after it
+	struct BVH_NODE
+	{
+		glm::vec3 boundsMin;
+		glm::vec3 boundsMax;
+		int firstIndex;
+		int triangleCount;
+	};
+
+	// properties for four rays traced together, stored by
+	// component so each one fills a SIMD register
+	struct RAY_PACKET
+	{
+		float originX[4];
+		float originY[4];
+		float originZ[4];
+		float directionX[4];
+		float directionY[4];
+		float directionZ[4];
+		float maxDistance[4];
+		// which of the four rays are still being traced
+		int activeMask;
+	};
+
+	// properties for the closest hits of a ray packet
+	struct HIT_PACKET
+	{
+		float distance[4];
+		float u[4];
+		float v[4];
+		int triangle[4];
+	};
+
+	// properties for a texture image used in shading
+	struct TRACE_TEXTURE
+	{
+		std::vector<unsigned char> pixels;
+		int width;
+		int height;
+	};
+
+	// width and height of the rendered image
+	int m_width;
+	int m_height;
+	// number of threads used to render a pass
+	int m_workerThreads;
+	// number of bounces traced after the camera ray
+	int m_maxBounces;
+	// radiance of the rays that leave the scene
+	glm::vec3 m_environmentColor;
+	// CPU copies of the basic shape meshes
+	PrimitiveGeometry m_geometry;
+	// scene triangles, ordered by the leaves that hold them
+	std::vector<TRACE_TRIANGLE> m_triangles;
+	std::vector<BVH_NODE> m_nodes;
+	// draws, materials, lights and textures of the scene
+	std::vector<SceneManager::DRAW_COMMAND> m_draws;
+	std::vector<SceneManager::OBJECT_MATERIAL> m_materials;
+	std::vector<SceneManager::LIGHT_SOURCE> m_lights;
+	std::vector<TRACE_TEXTURE> m_textures;
+	// camera rays are built from the inverse view projection
+	glm::mat4 m_inverseViewProjection;
+	// summed radiance of every pixel and the number of passes
+	std::vector<float> m_accumulation;
+	int m_passes;
+	// next tile and end tile of each thread's share of a pass
+	std::vector<std::atomic<int> > m_tileNext;
+	std::vector<int> m_tileEnd;
+	std::atomic<long long> m_rayCount;
+	// timing of the last pass
+	PASS_STATS m_stats;
+
+	// gather the world space triangles of every draw
+	void GatherTriangles();
+	// split a node of the hierarchy until its leaves are small
+	void SubdivideNode(int nodeIndex, std::vector<glm::vec3>& centers);
+	// find the closest hits of a packet of rays
+	void TracePacket(const RAY_PACKET& rays, HIT_PACKET& hits) const;
+	// render one tile for the current pass
+	void RenderTile(int tileIndex, long long& rays);
+	// take the next tile of a thread, or steal one from another
+	bool NextTile(int threadIndex, int& tileIndex);
+	// trace the paths of a 2x2 block of pixels
+	void TraceQuad(int x, int y, unsigned int seed, glm::vec3 radiance[4], long long& rays) const;
+	// sample a texture with bilinear filtering
+	glm::vec3 SampleTexture(int textureSlot, glm::vec2 uv) const;
+
+public:
+	// set the size of the rendered image
+	void SetResolution(int width, int height);
+	// set the number of threads used to render a pass
+	void SetWorkerThreads(int workerThreads);
+	// set the number of bounces traced after the camera ray
+	void SetMaxBounces(int maxBounces);
+	// set the radiance of the rays that leave the scene
+	void SetEnvironmentColor(glm::vec3 color);
+
+	// gather the scene and build the hierarchy for a view
+	bool LoadScene(
+		SceneManager* pSceneManager,
+		const glm::mat4& view,
+		const glm::mat4& projection);
+	// add one sample to every pixel of the image
+	void RenderPass();
+
+	// get the number of passes summed into the image
+	int GetPassCount() const;
+	// get the timing of the last pass
+	const PASS_STATS& GetPassStats() const;
+	// write the averaged image to a binary PPM file
+	bool SaveImage(const char* filename) const;
+	// save or resume the running totals of the image
+	bool SaveCheckpoint(const char* filename) const;
+	bool LoadCheckpoint(const char* filename);
+};
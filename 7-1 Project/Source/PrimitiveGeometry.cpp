@@ -0,0 +1,476 @@
+///////////////////////////////////////////////////////////////////////////////
+// primitivegeometry.cpp
+// ============
+// build CPU-side triangle meshes matching the basic shape meshes
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "PrimitiveGeometry.h"
+
+#include <cmath>
+
+// declaration of global variables and defines
+namespace
+{
+	const float g_Pi = 3.14159265358979f;
+
+	// number of segments around the round meshes
+	const int g_RoundSlices = 36;
+	// number of segments from pole to pole of the sphere
+	const int g_SphereStacks = 18;
+	// number of segments around the tube of the torus
+	const int g_TorusTubeSlices = 18;
+
+	// radius of the ring and of the tube of the torus
+	const float g_TorusMainRadius = 1.0f;
+	const float g_TorusTubeRadius = 0.1f;
+	// radius of the top of the tapered cylinder
+	const float g_TaperedTopRadius = 0.5f;
+
+	// fill in one vertex
+	PrimitiveGeometry::MESH_VERTEX MakeVertex(glm::vec3 position, glm::vec3 normal, glm::vec2 uv)
+	{
+		PrimitiveGeometry::MESH_VERTEX vertex;
+		vertex.position = position;
+		vertex.normal = normal;
+		vertex.uv = uv;
+		return(vertex);
+	}
+}
+
+/***********************************************************
+ *  PrimitiveGeometry()
+ *
+ *  The constructor for the class - all of the meshes are
+ *  built up front since they only total a few thousand
+ *  triangles.
+ ***********************************************************/
+PrimitiveGeometry::PrimitiveGeometry()
+{
+	BuildBox();
+	BuildPlane();
+	BuildPrism();
+	BuildPyramid4();
+	BuildTorus();
+
+	// the round meshes stand on the origin with a height of one
+	AddSides(m_meshes[SceneManager::MESH_CYLINDER][PART_INDEX_SIDES], 1.0f, 1.0f);
+	AddDisk(m_meshes[SceneManager::MESH_CYLINDER][PART_INDEX_TOP], 1.0f, 1.0f, true);
+	AddDisk(m_meshes[SceneManager::MESH_CYLINDER][PART_INDEX_BOTTOM], 0.0f, 1.0f, false);
+
+	AddSides(m_meshes[SceneManager::MESH_TAPERED_CYLINDER][PART_INDEX_SIDES], 1.0f, g_TaperedTopRadius);
+	AddDisk(m_meshes[SceneManager::MESH_TAPERED_CYLINDER][PART_INDEX_TOP], 1.0f, g_TaperedTopRadius, true);
+	AddDisk(m_meshes[SceneManager::MESH_TAPERED_CYLINDER][PART_INDEX_BOTTOM], 0.0f, 1.0f, false);
+
+	AddSides(m_meshes[SceneManager::MESH_CONE][PART_INDEX_SIDES], 1.0f, 0.0f);
+	AddDisk(m_meshes[SceneManager::MESH_CONE][PART_INDEX_BOTTOM], 0.0f, 1.0f, false);
+
+	AddSphere(m_meshes[SceneManager::MESH_SPHERE][PART_INDEX_SIDES], -0.5f * g_Pi, 0.5f * g_Pi);
+	AddSphere(m_meshes[SceneManager::MESH_HALF_SPHERE][PART_INDEX_SIDES], 0.0f, 0.5f * g_Pi);
+	AddDisk(m_meshes[SceneManager::MESH_HALF_SPHERE][PART_INDEX_SIDES], 0.0f, 1.0f, false);
+}
+
+/***********************************************************
+ *  AddQuad()
+ *
+ *  This method is used for adding a flat quad, given by its
+ *  corners in counter-clockwise order, as two triangles.
+ ***********************************************************/
+void PrimitiveGeometry::AddQuad(MESH_DATA& mesh, const MESH_VERTEX corners[4])
+{
+	unsigned int first = (unsigned int)mesh.vertices.size();
+	for (int i = 0; i < 4; i++)
+	{
+		mesh.vertices.push_back(corners[i]);
+	}
+
+	mesh.indices.push_back(first);
+	mesh.indices.push_back(first + 1);
+	mesh.indices.push_back(first + 2);
+	mesh.indices.push_back(first);
+	mesh.indices.push_back(first + 2);
+	mesh.indices.push_back(first + 3);
+}
+
+/***********************************************************
+ *  AddDisk()
+ *
+ *  This method is used for adding a flat round cap at the
+ *  passed in height, as a fan of triangles around its center.
+ ***********************************************************/
+void PrimitiveGeometry::AddDisk(MESH_DATA& mesh, float y, float radius, bool bFacingUp)
+{
+	glm::vec3 normal(0.0f, bFacingUp ? 1.0f : -1.0f, 0.0f);
+	unsigned int center = (unsigned int)mesh.vertices.size();
+
+	mesh.vertices.push_back(MakeVertex(glm::vec3(0.0f, y, 0.0f), normal, glm::vec2(0.5f, 0.5f)));
+	for (int slice = 0; slice <= g_RoundSlices; slice++)
+	{
+		float angle = 2.0f * g_Pi * slice / g_RoundSlices;
+		float x = std::cos(angle);
+		float z = std::sin(angle);
+		mesh.vertices.push_back(MakeVertex(
+			glm::vec3(x * radius, y, z * radius),
+			normal,
+			glm::vec2(0.5f + 0.5f * x, 0.5f - 0.5f * z)));
+	}
+
+	for (int slice = 0; slice < g_RoundSlices; slice++)
+	{
+		unsigned int edge = center + 1 + slice;
+		mesh.indices.push_back(center);
+		mesh.indices.push_back(bFacingUp ? edge + 1 : edge);
+		mesh.indices.push_back(bFacingUp ? edge : edge + 1);
+	}
+}
+
+/***********************************************************
+ *  AddSides()
+ *
+ *  This method is used for adding the curved side between a
+ *  bottom ring at height zero and a top ring at height one.
+ *  A top radius of zero makes the side of a cone.
+ ***********************************************************/
+void PrimitiveGeometry::AddSides(MESH_DATA& mesh, float bottomRadius, float topRadius)
+{
+	unsigned int first = (unsigned int)mesh.vertices.size();
+
+	for (int slice = 0; slice <= g_RoundSlices; slice++)
+	{
+		float angle = 2.0f * g_Pi * slice / g_RoundSlices;
+		float x = std::cos(angle);
+		float z = std::sin(angle);
+		glm::vec3 normal = glm::normalize(glm::vec3(x, bottomRadius - topRadius, z));
+		float u = (float)slice / g_RoundSlices;
+
+		mesh.vertices.push_back(MakeVertex(glm::vec3(x * bottomRadius, 0.0f, z * bottomRadius), normal, glm::vec2(u, 0.0f)));
+		mesh.vertices.push_back(MakeVertex(glm::vec3(x * topRadius, 1.0f, z * topRadius), normal, glm::vec2(u, 1.0f)));
+	}
+
+	for (int slice = 0; slice < g_RoundSlices; slice++)
+	{
+		unsigned int bottom = first + slice * 2;
+		mesh.indices.push_back(bottom);
+		mesh.indices.push_back(bottom + 1);
+		mesh.indices.push_back(bottom + 3);
+		mesh.indices.push_back(bottom);
+		mesh.indices.push_back(bottom + 3);
+		mesh.indices.push_back(bottom + 2);
+	}
+}
+
+/***********************************************************
+ *  AddSphere()
+ *
+ *  This method is used for adding the band of a unit sphere
+ *  between the passed in latitudes, in radians.
+ ***********************************************************/
+void PrimitiveGeometry::AddSphere(MESH_DATA& mesh, float startLatitude, float endLatitude)
+{
+	unsigned int first = (unsigned int)mesh.vertices.size();
+	int stacks = (int)(g_SphereStacks * (endLatitude - startLatitude) / g_Pi + 0.5f);
+	if (stacks < 1)
+	{
+		stacks = 1;
+	}
+
+	for (int stack = 0; stack <= stacks; stack++)
+	{
+		float latitude = startLatitude + (endLatitude - startLatitude) * stack / stacks;
+		float ringRadius = std::cos(latitude);
+		float y = std::sin(latitude);
+		float v = 0.5f + latitude / g_Pi;
+
+		for (int slice = 0; slice <= g_RoundSlices; slice++)
+		{
+			float angle = 2.0f * g_Pi * slice / g_RoundSlices;
+			glm::vec3 position(std::cos(angle) * ringRadius, y, std::sin(angle) * ringRadius);
+			mesh.vertices.push_back(MakeVertex(position, position, glm::vec2((float)slice / g_RoundSlices, v)));
+		}
+	}
+
+	for (int stack = 0; stack < stacks; stack++)
+	{
+		for (int slice = 0; slice < g_RoundSlices; slice++)
+		{
+			unsigned int lower = first + stack * (g_RoundSlices + 1) + slice;
+			unsigned int upper = lower + g_RoundSlices + 1;
+			mesh.indices.push_back(lower);
+			mesh.indices.push_back(upper);
+			mesh.indices.push_back(upper + 1);
+			mesh.indices.push_back(lower);
+			mesh.indices.push_back(upper + 1);
+			mesh.indices.push_back(lower + 1);
+		}
+	}
+}
+
+/***********************************************************
+ *  BuildBox()
+ *
+ *  This method is used for building the unit cube centered on
+ *  the origin, with the whole texture mapped onto each face.
+ ***********************************************************/
+void PrimitiveGeometry::BuildBox()
+{
+	MESH_DATA& mesh = m_meshes[SceneManager::MESH_BOX][PART_INDEX_SIDES];
+
+	// the outward axis of each face and the two axes across it
+	const glm::vec3 normals[6] = {
+		glm::vec3(0, 0, 1), glm::vec3(0, 0, -1), glm::vec3(1, 0, 0),
+		glm::vec3(-1, 0, 0), glm::vec3(0, 1, 0), glm::vec3(0, -1, 0) };
+	const glm::vec3 rights[6] = {
+		glm::vec3(1, 0, 0), glm::vec3(-1, 0, 0), glm::vec3(0, 0, -1),
+		glm::vec3(0, 0, 1), glm::vec3(1, 0, 0), glm::vec3(1, 0, 0) };
+
+	for (int face = 0; face < 6; face++)
+	{
+		glm::vec3 normal = normals[face];
+		glm::vec3 right = rights[face];
+		glm::vec3 up = glm::cross(normal, right);
+		glm::vec3 center = normal * 0.5f;
+
+		MESH_VERTEX corners[4];
+		corners[0] = MakeVertex(center - right * 0.5f - up * 0.5f, normal, glm::vec2(0.0f, 0.0f));
+		corners[1] = MakeVertex(center + right * 0.5f - up * 0.5f, normal, glm::vec2(1.0f, 0.0f));
+		corners[2] = MakeVertex(center + right * 0.5f + up * 0.5f, normal, glm::vec2(1.0f, 1.0f));
+		corners[3] = MakeVertex(center - right * 0.5f + up * 0.5f, normal, glm::vec2(0.0f, 1.0f));
+		AddQuad(mesh, corners);
+	}
+}
+
+/***********************************************************
+ *  BuildPlane()
+ *
+ *  This method is used for building the plane, which spans
+ *  from -1 to 1 on the X and Z axes and faces up.
+ ***********************************************************/
+void PrimitiveGeometry::BuildPlane()
+{
+	MESH_DATA& mesh = m_meshes[SceneManager::MESH_PLANE][PART_INDEX_SIDES];
+	glm::vec3 normal(0.0f, 1.0f, 0.0f);
+
+	MESH_VERTEX corners[4];
+	corners[0] = MakeVertex(glm::vec3(-1.0f, 0.0f, 1.0f), normal, glm::vec2(0.0f, 0.0f));
+	corners[1] = MakeVertex(glm::vec3(1.0f, 0.0f, 1.0f), normal, glm::vec2(1.0f, 0.0f));
+	corners[2] = MakeVertex(glm::vec3(1.0f, 0.0f, -1.0f), normal, glm::vec2(1.0f, 1.0f));
+	corners[3] = MakeVertex(glm::vec3(-1.0f, 0.0f, -1.0f), normal, glm::vec2(0.0f, 1.0f));
+	AddQuad(mesh, corners);
+}
+
+/***********************************************************
+ *  BuildPrism()
+ *
+ *  This method is used for building the triangular prism,
+ *  which fits in the unit cube centered on the origin.
+ ***********************************************************/
+void PrimitiveGeometry::BuildPrism()
+{
+	MESH_DATA& mesh = m_meshes[SceneManager::MESH_PRISM][PART_INDEX_SIDES];
+	const glm::vec3 corners[3] = {
+		glm::vec3(-0.5f, 0.0f, 0.5f), glm::vec3(0.5f, 0.0f, 0.5f), glm::vec3(0.0f, 0.0f, -0.5f) };
+
+	for (int side = 0; side < 3; side++)
+	{
+		glm::vec3 a = corners[side];
+		glm::vec3 b = corners[(side + 1) % 3];
+		glm::vec3 normal = glm::normalize(glm::cross(b - a, glm::vec3(0.0f, 1.0f, 0.0f)));
+
+		MESH_VERTEX quad[4];
+		quad[0] = MakeVertex(a + glm::vec3(0.0f, -0.5f, 0.0f), normal, glm::vec2(0.0f, 0.0f));
+		quad[1] = MakeVertex(b + glm::vec3(0.0f, -0.5f, 0.0f), normal, glm::vec2(1.0f, 0.0f));
+		quad[2] = MakeVertex(b + glm::vec3(0.0f, 0.5f, 0.0f), normal, glm::vec2(1.0f, 1.0f));
+		quad[3] = MakeVertex(a + glm::vec3(0.0f, 0.5f, 0.0f), normal, glm::vec2(0.0f, 1.0f));
+		AddQuad(mesh, quad);
+	}
+
+	for (int cap = 0; cap < 2; cap++)
+	{
+		float y = (cap == 0) ? 0.5f : -0.5f;
+		glm::vec3 normal(0.0f, (cap == 0) ? 1.0f : -1.0f, 0.0f);
+		unsigned int first = (unsigned int)mesh.vertices.size();
+		for (int i = 0; i < 3; i++)
+		{
+			glm::vec3 position = corners[i] + glm::vec3(0.0f, y, 0.0f);
+			mesh.vertices.push_back(MakeVertex(position, normal, glm::vec2(position.x + 0.5f, 0.5f - position.z)));
+		}
+		mesh.indices.push_back(first);
+		mesh.indices.push_back((cap == 0) ? first + 1 : first + 2);
+		mesh.indices.push_back((cap == 0) ? first + 2 : first + 1);
+	}
+}
+
+/***********************************************************
+ *  BuildPyramid4()
+ *
+ *  This method is used for building the four sided pyramid,
+ *  which fits in the unit cube centered on the origin.
+ ***********************************************************/
+void PrimitiveGeometry::BuildPyramid4()
+{
+	MESH_DATA& mesh = m_meshes[SceneManager::MESH_PYRAMID4][PART_INDEX_SIDES];
+	const glm::vec3 apex(0.0f, 0.5f, 0.0f);
+	const glm::vec3 corners[4] = {
+		glm::vec3(-0.5f, -0.5f, 0.5f), glm::vec3(0.5f, -0.5f, 0.5f),
+		glm::vec3(0.5f, -0.5f, -0.5f), glm::vec3(-0.5f, -0.5f, -0.5f) };
+
+	for (int side = 0; side < 4; side++)
+	{
+		glm::vec3 a = corners[side];
+		glm::vec3 b = corners[(side + 1) % 4];
+		glm::vec3 normal = glm::normalize(glm::cross(b - a, apex - a));
+		unsigned int first = (unsigned int)mesh.vertices.size();
+
+		mesh.vertices.push_back(MakeVertex(a, normal, glm::vec2(0.0f, 0.0f)));
+		mesh.vertices.push_back(MakeVertex(b, normal, glm::vec2(1.0f, 0.0f)));
+		mesh.vertices.push_back(MakeVertex(apex, normal, glm::vec2(0.5f, 1.0f)));
+		mesh.indices.push_back(first);
+		mesh.indices.push_back(first + 1);
+		mesh.indices.push_back(first + 2);
+	}
+
+	glm::vec3 down(0.0f, -1.0f, 0.0f);
+	MESH_VERTEX base[4];
+	base[0] = MakeVertex(corners[3], down, glm::vec2(0.0f, 0.0f));
+	base[1] = MakeVertex(corners[2], down, glm::vec2(1.0f, 0.0f));
+	base[2] = MakeVertex(corners[1], down, glm::vec2(1.0f, 1.0f));
+	base[3] = MakeVertex(corners[0], down, glm::vec2(0.0f, 1.0f));
+	AddQuad(mesh, base);
+}
+
+/***********************************************************
+ *  BuildTorus()
+ *
+ *  This method is used for building the torus, whose ring
+ *  lies in the XY plane around the Z axis.
+ ***********************************************************/
+void PrimitiveGeometry::BuildTorus()
+{
+	MESH_DATA& mesh = m_meshes[SceneManager::MESH_TORUS][PART_INDEX_SIDES];
+
+	for (int ring = 0; ring <= g_RoundSlices; ring++)
+	{
+		float theta = 2.0f * g_Pi * ring / g_RoundSlices;
+		for (int tube = 0; tube <= g_TorusTubeSlices; tube++)
+		{
+			float phi = 2.0f * g_Pi * tube / g_TorusTubeSlices;
+			glm::vec3 normal(
+				std::cos(phi) * std::cos(theta),
+				std::cos(phi) * std::sin(theta),
+				std::sin(phi));
+			glm::vec3 position(
+				(g_TorusMainRadius + g_TorusTubeRadius * std::cos(phi)) * std::cos(theta),
+				(g_TorusMainRadius + g_TorusTubeRadius * std::cos(phi)) * std::sin(theta),
+				g_TorusTubeRadius * std::sin(phi));
+			mesh.vertices.push_back(MakeVertex(
+				position,
+				normal,
+				glm::vec2((float)ring / g_RoundSlices, (float)tube / g_TorusTubeSlices)));
+		}
+	}
+
+	for (int ring = 0; ring < g_RoundSlices; ring++)
+	{
+		for (int tube = 0; tube < g_TorusTubeSlices; tube++)
+		{
+			unsigned int a = ring * (g_TorusTubeSlices + 1) + tube;
+			unsigned int b = a + g_TorusTubeSlices + 1;
+			mesh.indices.push_back(a);
+			mesh.indices.push_back(b);
+			mesh.indices.push_back(b + 1);
+			mesh.indices.push_back(a);
+			mesh.indices.push_back(b + 1);
+			mesh.indices.push_back(a + 1);
+		}
+	}
+}
+
+/***********************************************************
+ *  GetMeshPart()
+ *
+ *  This method is used for getting one part of a mesh.  The
+ *  part is empty when the mesh does not have it.
+ ***********************************************************/
+const PrimitiveGeometry::MESH_DATA& PrimitiveGeometry::GetMeshPart(
+	SceneManager::MESH_TYPE mesh,
+	PART_INDEX part) const
+{
+	return(m_meshes[mesh][part]);
+}
+
+/***********************************************************
+ *  IsPartDrawn()
+ *
+ *  This method is used for checking whether a mesh part is
+ *  drawn for the passed in part flags.  Only the cylinders
+ *  choose their sides, and only they and the cone choose
+ *  their caps, like the OpenGL mesh draw methods.
+ ***********************************************************/
+bool PrimitiveGeometry::IsPartDrawn(
+	SceneManager::MESH_TYPE mesh,
+	PART_INDEX part,
+	unsigned int parts)
+{
+	bool bCylinder = (mesh == SceneManager::MESH_CYLINDER) ||
+		(mesh == SceneManager::MESH_TAPERED_CYLINDER);
+
+	switch (part)
+	{
+	case PART_INDEX_TOP: return(bCylinder && ((parts & SceneManager::PART_TOP) != 0));
+	case PART_INDEX_BOTTOM:
+		return((bCylinder || (mesh == SceneManager::MESH_CONE)) &&
+			((parts & SceneManager::PART_BOTTOM) != 0));
+	case PART_INDEX_SIDES: return(!bCylinder || ((parts & SceneManager::PART_SIDES) != 0));
+	default: break;
+	}
+	return(false);
+}
+
+/***********************************************************
+ *  GetMeshBounds()
+ *
+ *  This method is used for getting the smallest box around
+ *  the vertices of all of the parts of a mesh.
+ ***********************************************************/
+void PrimitiveGeometry::GetMeshBounds(SceneManager::MESH_TYPE mesh, glm::vec3& minimum, glm::vec3& maximum) const
+{
+	minimum = glm::vec3(0.0f);
+	maximum = glm::vec3(0.0f);
+	bool bFirst = true;
+	for (int part = 0; part < PART_INDEX_COUNT; part++)
+	{
+		const std::vector<MESH_VERTEX>& vertices = m_meshes[mesh][part].vertices;
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			if (bFirst == true)
+			{
+				minimum = vertices[i].position;
+				maximum = vertices[i].position;
+				bFirst = false;
+			}
+			minimum = glm::min(minimum, vertices[i].position);
+			maximum = glm::max(maximum, vertices[i].position);
+		}
+	}
+}
+
+/***********************************************************
+ *  GetTriangleCount()
+ *
+ *  This method is used for getting the number of triangles in
+ *  the drawn parts of a mesh.
+ ***********************************************************/
+int PrimitiveGeometry::GetTriangleCount(SceneManager::MESH_TYPE mesh, unsigned int parts) const
+{
+	int triangles = 0;
+	for (int part = 0; part < PART_INDEX_COUNT; part++)
+	{
+		if (IsPartDrawn(mesh, (PART_INDEX)part, parts))
+		{
+			triangles += (int)m_meshes[mesh][part].indices.size() / 3;
+		}
+	}
+	return(triangles);
+}
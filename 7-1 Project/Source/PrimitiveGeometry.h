@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////
+// primitivegeometry.h
+// ============
+// build CPU-side triangle meshes matching the basic shape meshes
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  PrimitiveGeometry
+ *
+ *  This class generates the triangles of the basic shape
+ *  meshes in memory, with the same size, placement and
+ *  texture mapping as the OpenGL meshes, for renderers that
+ *  do not draw through OpenGL.  The end caps and sides of a
+ *  mesh are kept apart so a draw can select its parts.
+ ***********************************************************/
+class PrimitiveGeometry
+{
+public:
+	// properties for one mesh vertex
+	struct MESH_VERTEX
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 uv;
+	};
+
+	// properties for the triangles of one mesh part
+	struct MESH_DATA
+	{
+		std::vector<MESH_VERTEX> vertices;
+		std::vector<unsigned int> indices;
+	};
+
+	// the separately drawn parts of each mesh
+	enum PART_INDEX
+	{
+		PART_INDEX_TOP,
+		PART_INDEX_BOTTOM,
+		PART_INDEX_SIDES,
+		PART_INDEX_COUNT
+	};
+
+	// constructor
+	PrimitiveGeometry();
+
+private:
+	// the mesh parts, where meshes without caps use the sides
+	MESH_DATA m_meshes[SceneManager::MESH_TYPE_COUNT][PART_INDEX_COUNT];
+
+	// add a quad made of two triangles
+	static void AddQuad(MESH_DATA& mesh, const MESH_VERTEX corners[4]);
+	// add a flat disk facing up or down
+	static void AddDisk(MESH_DATA& mesh, float y, float radius, bool bFacingUp);
+	// add the curved side of a cylinder or cone
+	static void AddSides(MESH_DATA& mesh, float bottomRadius, float topRadius);
+	// add a part of a sphere between two latitudes
+	static void AddSphere(MESH_DATA& mesh, float startLatitude, float endLatitude);
+
+	void BuildBox();
+	void BuildPlane();
+	void BuildPrism();
+	void BuildPyramid4();
+	void BuildTorus();
+
+public:
+	// get one part of a mesh
+	const MESH_DATA& GetMeshPart(SceneManager::MESH_TYPE mesh, PART_INDEX part) const;
+	// get the corners of the box around every part of a mesh
+	void GetMeshBounds(SceneManager::MESH_TYPE mesh, glm::vec3& minimum, glm::vec3& maximum) const;
+	// get the total number of triangles drawn for a mesh and parts
+	int GetTriangleCount(SceneManager::MESH_TYPE mesh, unsigned int parts) const;
+	// check whether a part is drawn for the passed in part flags
+	static bool IsPartDrawn(SceneManager::MESH_TYPE mesh, PART_INDEX part, unsigned int parts);
+};
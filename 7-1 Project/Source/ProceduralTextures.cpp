@@ -0,0 +1,390 @@
+///////////////////////////////////////////////////////////////////////////////
+// proceduraltextures.cpp
+// ============
+// generate surface textures from noise instead of image files
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ProceduralTextures.h"
+#include "SimdSupport.h"
+
+#include <cmath>
+#include <functional>
+#include <thread>
+
+// declaration of global variables and defines
+namespace
+{
+	// constants for the integer hash used by the value noise
+	const unsigned int g_HashPrimeX = 0x27d4eb2dU;
+	const unsigned int g_HashPrimeY = 0x165667b1U;
+	const unsigned int g_HashMix = 0x2c1b3c6dU;
+
+	/*******************************************************
+	 *  Four-lane float and integer values.  The patterns are
+	 *  written once against these helpers, which map to SSE2
+	 *  registers when available and to plain arrays otherwise,
+	 *  so both builds generate the same images.
+	 *******************************************************/
+#ifdef SCENE_SIMD_SSE2
+	struct Float4 { __m128 v; };
+	struct Int4 { __m128i v; };
+
+	inline Float4 Set(float a) { Float4 r; r.v = _mm_set1_ps(a); return r; }
+	inline Float4 Set(float a, float b, float c, float d) { Float4 r; r.v = _mm_setr_ps(a, b, c, d); return r; }
+	inline Float4 operator+(Float4 a, Float4 b) { Float4 r; r.v = _mm_add_ps(a.v, b.v); return r; }
+	inline Float4 operator-(Float4 a, Float4 b) { Float4 r; r.v = _mm_sub_ps(a.v, b.v); return r; }
+	inline Float4 operator*(Float4 a, Float4 b) { Float4 r; r.v = _mm_mul_ps(a.v, b.v); return r; }
+	inline Float4 Min(Float4 a, Float4 b) { Float4 r; r.v = _mm_min_ps(a.v, b.v); return r; }
+	inline Float4 Max(Float4 a, Float4 b) { Float4 r; r.v = _mm_max_ps(a.v, b.v); return r; }
+	inline Float4 Sqrt(Float4 a) { Float4 r; r.v = _mm_sqrt_ps(a.v); return r; }
+	inline void Store(Float4 a, float* out) { _mm_storeu_ps(out, a.v); }
+
+	inline Float4 Floor(Float4 a)
+	{
+		// truncation rounds negative values up, so step those down
+		__m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+		__m128 adjust = _mm_and_ps(_mm_cmpgt_ps(truncated, a.v), _mm_set1_ps(1.0f));
+		Float4 r; r.v = _mm_sub_ps(truncated, adjust); return r;
+	}
+
+	inline Int4 ToInt(Float4 a) { Int4 r; r.v = _mm_cvttps_epi32(a.v); return r; }
+	inline Int4 operator+(Int4 a, int b) { Int4 r; r.v = _mm_add_epi32(a.v, _mm_set1_epi32(b)); return r; }
+	inline Int4 operator^(Int4 a, Int4 b) { Int4 r; r.v = _mm_xor_si128(a.v, b.v); return r; }
+	inline Int4 ShiftRight(Int4 a, int bits) { Int4 r; r.v = _mm_srl_epi32(a.v, _mm_cvtsi32_si128(bits)); return r; }
+
+	inline Int4 Multiply(Int4 a, unsigned int b)
+	{
+		// SSE2 only multiplies the even lanes, so the odd lanes
+		// are shifted down, multiplied and interleaved back
+		__m128i factor = _mm_set1_epi32((int)b);
+		__m128i even = _mm_mul_epu32(a.v, factor);
+		__m128i odd = _mm_mul_epu32(_mm_srli_si128(a.v, 4), factor);
+		Int4 r;
+		r.v = _mm_unpacklo_epi32(
+			_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+			_mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+		return r;
+	}
+
+	inline Float4 UnitFloat(Int4 a)
+	{
+		// keep 24 bits so the conversion to float is exact
+		__m128i bits = _mm_and_si128(a.v, _mm_set1_epi32(0x00ffffff));
+		Float4 r; r.v = _mm_mul_ps(_mm_cvtepi32_ps(bits), _mm_set1_ps(1.0f / 16777216.0f)); return r;
+	}
+#else
+	struct Float4 { float v[4]; };
+	struct Int4 { unsigned int v[4]; };
+
+	inline Float4 Set(float a) { Float4 r; for (int i = 0; i < 4; i++) r.v[i] = a; return r; }
+	inline Float4 Set(float a, float b, float c, float d) { Float4 r; r.v[0] = a; r.v[1] = b; r.v[2] = c; r.v[3] = d; return r; }
+	inline Float4 operator+(Float4 a, Float4 b) { for (int i = 0; i < 4; i++) a.v[i] += b.v[i]; return a; }
+	inline Float4 operator-(Float4 a, Float4 b) { for (int i = 0; i < 4; i++) a.v[i] -= b.v[i]; return a; }
+	inline Float4 operator*(Float4 a, Float4 b) { for (int i = 0; i < 4; i++) a.v[i] *= b.v[i]; return a; }
+	inline Float4 Min(Float4 a, Float4 b) { for (int i = 0; i < 4; i++) a.v[i] = (a.v[i] < b.v[i]) ? a.v[i] : b.v[i]; return a; }
+	inline Float4 Max(Float4 a, Float4 b) { for (int i = 0; i < 4; i++) a.v[i] = (a.v[i] > b.v[i]) ? a.v[i] : b.v[i]; return a; }
+	inline Float4 Sqrt(Float4 a) { for (int i = 0; i < 4; i++) a.v[i] = std::sqrt(a.v[i]); return a; }
+	inline void Store(Float4 a, float* out) { for (int i = 0; i < 4; i++) out[i] = a.v[i]; }
+	inline Float4 Floor(Float4 a) { for (int i = 0; i < 4; i++) a.v[i] = std::floor(a.v[i]); return a; }
+
+	inline Int4 ToInt(Float4 a) { Int4 r; for (int i = 0; i < 4; i++) r.v[i] = (unsigned int)(int)a.v[i]; return r; }
+	inline Int4 operator+(Int4 a, int b) { for (int i = 0; i < 4; i++) a.v[i] += (unsigned int)b; return a; }
+	inline Int4 operator^(Int4 a, Int4 b) { for (int i = 0; i < 4; i++) a.v[i] ^= b.v[i]; return a; }
+	inline Int4 ShiftRight(Int4 a, int bits) { for (int i = 0; i < 4; i++) a.v[i] >>= bits; return a; }
+	inline Int4 Multiply(Int4 a, unsigned int b) { for (int i = 0; i < 4; i++) a.v[i] *= b; return a; }
+	inline Float4 UnitFloat(Int4 a) { Float4 r; for (int i = 0; i < 4; i++) r.v[i] = (float)(a.v[i] & 0x00ffffff) * (1.0f / 16777216.0f); return r; }
+#endif
+
+	inline Float4 Fract(Float4 a) { return(a - Floor(a)); }
+	inline Float4 Clamp01(Float4 a) { return(Min(Max(a, Set(0.0f)), Set(1.0f))); }
+	inline Float4 Mix(Float4 a, Float4 b, Float4 t) { return(a + (b - a) * t); }
+	inline Float4 Abs(Float4 a) { return(Max(a, Set(0.0f) - a)); }
+
+	inline Float4 SmoothStep(float edge0, float edge1, Float4 x)
+	{
+		Float4 t = Clamp01((x - Set(edge0)) * Set(1.0f / (edge1 - edge0)));
+		return(t * t * (Set(3.0f) - Set(2.0f) * t));
+	}
+
+	// hash a lattice point to a value between 0 and 1
+	inline Float4 Hash(Int4 x, Int4 y, unsigned int seed)
+	{
+		Int4 seedBits = ToInt(Set(0.0f)) + (int)seed;
+		Int4 h = Multiply(x, g_HashPrimeX) ^ Multiply(y, g_HashPrimeY) ^ seedBits;
+		h = h ^ ShiftRight(h, 15);
+		h = Multiply(h, g_HashMix);
+		h = h ^ ShiftRight(h, 12);
+		return(UnitFloat(h));
+	}
+
+	// get the whole number of lattice cells a noise is scaled
+	// to across the texture, so the noise repeats at its edges
+	inline float Period(float scale)
+	{
+		return((scale < 1.0f) ? 1.0f : std::floor(scale + 0.5f));
+	}
+
+	// wrap whole lattice coordinates into 0 to the period, where
+	// a period of 0 leaves them as they are
+	inline Float4 Wrap(Float4 cell, float period)
+	{
+		if (period <= 0.0f)
+		{
+			return(cell);
+		}
+		// half a cell keeps the division clear of rounding at
+		// the multiples of the period
+		Float4 turns = Floor((cell + Set(0.5f)) * Set(1.0f / period));
+		return(cell - turns * Set(period));
+	}
+
+	// smoothly interpolated noise between random lattice values,
+	// repeating every period cells along each axis
+	Float4 ValueNoise(Float4 x, Float4 y, float periodX, float periodY, unsigned int seed)
+	{
+		Float4 cellX = Floor(x);
+		Float4 cellY = Floor(y);
+		Float4 fx = x - cellX;
+		Float4 fy = y - cellY;
+		fx = fx * fx * (Set(3.0f) - Set(2.0f) * fx);
+		fy = fy * fy * (Set(3.0f) - Set(2.0f) * fy);
+
+		Int4 ix0 = ToInt(Wrap(cellX, periodX));
+		Int4 iy0 = ToInt(Wrap(cellY, periodY));
+		Int4 ix1 = ToInt(Wrap(cellX + Set(1.0f), periodX));
+		Int4 iy1 = ToInt(Wrap(cellY + Set(1.0f), periodY));
+		Float4 v00 = Hash(ix0, iy0, seed);
+		Float4 v10 = Hash(ix1, iy0, seed);
+		Float4 v01 = Hash(ix0, iy1, seed);
+		Float4 v11 = Hash(ix1, iy1, seed);
+
+		return(Mix(Mix(v00, v10, fx), Mix(v01, v11, fx), fy));
+	}
+
+	// sum of noise octaves, each at twice the frequency and
+	// twice the period
+	Float4 FractalNoise(Float4 x, Float4 y, float periodX, float periodY, int octaves, unsigned int seed)
+	{
+		Float4 sum = Set(0.0f);
+		float amplitude = 0.5f;
+		float total = 0.0f;
+		for (int i = 0; i < octaves; i++)
+		{
+			sum = sum + ValueNoise(x, y, periodX, periodY, seed + (unsigned int)i) * Set(amplitude);
+			total += amplitude;
+			x = x * Set(2.0f);
+			y = y * Set(2.0f);
+			periodX *= 2.0f;
+			periodY *= 2.0f;
+			amplitude *= 0.5f;
+		}
+		return(sum * Set(1.0f / total));
+	}
+
+	// noise of the texture coordinates scaled to whole numbers
+	// of cells, so it tiles across the texture edges
+	inline Float4 TiledNoise(Float4 u, Float4 v, float scaleU, float scaleV, unsigned int seed)
+	{
+		float periodU = Period(scaleU);
+		float periodV = Period(scaleV);
+		return(ValueNoise(u * Set(periodU), v * Set(periodV), periodU, periodV, seed));
+	}
+
+	// noise octaves of the texture coordinates that tile across
+	// the texture edges
+	inline Float4 TiledFractalNoise(Float4 u, Float4 v, float scaleU, float scaleV, int octaves, unsigned int seed)
+	{
+		float periodU = Period(scaleU);
+		float periodV = Period(scaleV);
+		return(FractalNoise(u * Set(periodU), v * Set(periodV), periodU, periodV, octaves, seed));
+	}
+
+	// get the amount of accent color for four texels of a pattern
+	Float4 PatternAmount(const ProceduralTextures::PATTERN_SETTINGS& settings, Float4 u, Float4 v)
+	{
+		Float4 amount;
+
+		switch (settings.pattern)
+		{
+		case ProceduralTextures::PATTERN_WOOD:
+		{
+			// growth rings run along the planks and are bent by
+			// low frequency noise, with long fibers on top
+			Float4 bend = TiledFractalNoise(u, v, 4.0f, 2.0f, 4, settings.seed);
+			Float4 rings = Fract(v * Set(Period(settings.frequency)) + bend * Set(settings.turbulence));
+			Float4 ring = Abs(rings * Set(2.0f) - Set(1.0f));
+			Float4 fibers = TiledNoise(u, v, 256.0f, settings.frequency * 6.0f, settings.seed + 17);
+			amount = ring * Set(1.0f - settings.detail) + fibers * Set(settings.detail);
+			break;
+		}
+		case ProceduralTextures::PATTERN_CHEESE:
+		{
+			// small round holes scattered over a mottled body
+			Float4 body = TiledFractalNoise(u, v, 8.0f, 8.0f, 3, settings.seed);
+			Float4 holeNoise = TiledNoise(u, v, settings.frequency, settings.frequency, settings.seed + 31);
+			Float4 holes = SmoothStep(0.8f, 0.84f, holeNoise + body * Set(settings.turbulence));
+			amount = Max(holes, body * Set(settings.detail));
+			break;
+		}
+		case ProceduralTextures::PATTERN_BRUSHED_METAL:
+		{
+			// streaks that are long in u and thin in v
+			Float4 streaks = TiledFractalNoise(u, v, 2.0f, settings.frequency, 3, settings.seed);
+			Float4 grain = TiledNoise(u, v, 64.0f, settings.frequency * 4.0f, settings.seed + 7);
+			amount = streaks * Set(1.0f - settings.detail) + grain * Set(settings.detail);
+			break;
+		}
+		default:
+		{
+			// concentric brushing around the center of the texture,
+			// which is drawn whole rather than tiled, so the rings
+			// are noise along the radius that does not repeat
+			Float4 du = u - Set(0.5f);
+			Float4 dv = v - Set(0.5f);
+			Float4 radius = Sqrt(du * du + dv * dv);
+			Float4 wobble = TiledNoise(u, v, 6.0f, 6.0f, settings.seed + 3);
+			Float4 rings = FractalNoise(radius * Set(settings.frequency) + wobble * Set(settings.turbulence), Set(0.5f), 0.0f, 0.0f, 3, settings.seed);
+			Float4 grain = TiledNoise(u, v, 128.0f, 128.0f, settings.seed + 11);
+			amount = rings * Set(1.0f - settings.detail) + grain * Set(settings.detail);
+			break;
+		}
+		}
+
+		return(Clamp01(amount));
+	}
+}
+
+/***********************************************************
+ *  ProceduralTextures()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ProceduralTextures::ProceduralTextures()
+{
+	m_workerThreads = (int)std::thread::hardware_concurrency();
+	if (m_workerThreads <= 0)
+	{
+		m_workerThreads = 4;
+	}
+}
+
+/***********************************************************
+ *  GenerateRows()
+ *
+ *  This method is used for generating one band of rows of
+ *  the image, four pixels at a time.
+ ***********************************************************/
+void ProceduralTextures::GenerateRows(
+	const PATTERN_SETTINGS& settings,
+	int width,
+	int height,
+	int firstRow,
+	int lastRow,
+	unsigned char* pixels)
+{
+	Float4 baseR = Set(settings.baseColor.r);
+	Float4 baseG = Set(settings.baseColor.g);
+	Float4 baseB = Set(settings.baseColor.b);
+	Float4 accentR = Set(settings.accentColor.r);
+	Float4 accentG = Set(settings.accentColor.g);
+	Float4 accentB = Set(settings.accentColor.b);
+
+	float texelWidth = 1.0f / (float)width;
+	float red[4];
+	float green[4];
+	float blue[4];
+
+	for (int y = firstRow; y < lastRow; y++)
+	{
+		Float4 v = Set(((float)y + 0.5f) / (float)height);
+		unsigned char* row = pixels + (size_t)y * width * 3;
+
+		for (int x = 0; x < width; x += 4)
+		{
+			float u0 = ((float)x + 0.5f) * texelWidth;
+			Float4 u = Set(u0, u0 + texelWidth, u0 + 2.0f * texelWidth, u0 + 3.0f * texelWidth);
+
+			Float4 amount = PatternAmount(settings, u, v);
+			Store(Clamp01(Mix(baseR, accentR, amount)), red);
+			Store(Clamp01(Mix(baseG, accentG, amount)), green);
+			Store(Clamp01(Mix(baseB, accentB, amount)), blue);
+
+			int count = (width - x < 4) ? width - x : 4;
+			for (int i = 0; i < count; i++)
+			{
+				row[(x + i) * 3 + 0] = (unsigned char)(red[i] * 255.0f + 0.5f);
+				row[(x + i) * 3 + 1] = (unsigned char)(green[i] * 255.0f + 0.5f);
+				row[(x + i) * 3 + 2] = (unsigned char)(blue[i] * 255.0f + 0.5f);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  Generate()
+ *
+ *  This method is used for generating an RGB image of the
+ *  requested size for the passed in pattern settings.  The
+ *  rows are split into one band for each worker thread.
+ ***********************************************************/
+void ProceduralTextures::Generate(
+	const PATTERN_SETTINGS& settings,
+	int width,
+	int height,
+	std::vector<unsigned char>& pixels)
+{
+	pixels.resize((size_t)width * height * 3);
+	if ((width <= 0) || (height <= 0))
+	{
+		return;
+	}
+
+	int workerCount = m_workerThreads;
+	if (workerCount > height)
+	{
+		workerCount = height;
+	}
+
+	std::vector<std::thread> workers;
+	int rowsPerWorker = (height + workerCount - 1) / workerCount;
+	for (int i = 0; i < workerCount; i++)
+	{
+		int firstRow = i * rowsPerWorker;
+		int lastRow = (firstRow + rowsPerWorker < height) ? firstRow + rowsPerWorker : height;
+		if (firstRow >= lastRow)
+		{
+			break;
+		}
+
+		workers.push_back(std::thread(
+			&ProceduralTextures::GenerateRows,
+			std::cref(settings),
+			width,
+			height,
+			firstRow,
+			lastRow,
+			&pixels[0]));
+	}
+
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+}
+
+/***********************************************************
+ *  SetWorkerThreads()
+ *
+ *  This method is used for setting how many threads are used
+ *  to generate an image.
+ ***********************************************************/
+void ProceduralTextures::SetWorkerThreads(int workerThreads)
+{
+	if (workerThreads > 0)
+	{
+		m_workerThreads = workerThreads;
+	}
+}
@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+// proceduraltextures.h
+// ============
+// generate surface textures from noise instead of image files
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  ProceduralTextures
+ *
+ *  This class synthesizes the wood, cheese and metal surface
+ *  textures of the scene at any resolution.  Each pattern is
+ *  built from value noise that is evaluated four pixels at a
+ *  time, and the rows of the image are split across threads.
+ *  The noise lattice wraps at the texture edges, so repeated
+ *  textures show no seams.
+ ***********************************************************/
+class ProceduralTextures
+{
+public:
+	// the surface patterns that can be generated
+	enum PATTERN_TYPE
+	{
+		PATTERN_WOOD,
+		PATTERN_CHEESE,
+		PATTERN_BRUSHED_METAL,
+		PATTERN_CIRCULAR_METAL
+	};
+
+	// properties for a generated surface material
+	struct PATTERN_SETTINGS
+	{
+		PATTERN_TYPE pattern;
+		// main color of the surface
+		glm::vec3 baseColor;
+		// color of the rings, holes or streaks
+		glm::vec3 accentColor;
+		// number of rings, holes or streaks across the texture,
+		// rounded to a whole number so the texture tiles
+		float frequency;
+		// amount the pattern is distorted by noise
+		float turbulence;
+		// strength of the fine surface detail
+		float detail;
+		// seed so the same settings always give the same image
+		unsigned int seed;
+	};
+
+	// constructor
+	ProceduralTextures();
+
+private:
+	// number of threads used to generate an image
+	int m_workerThreads;
+
+	// generate a band of rows of the image
+	static void GenerateRows(
+		const PATTERN_SETTINGS& settings,
+		int width,
+		int height,
+		int firstRow,
+		int lastRow,
+		unsigned char* pixels);
+
+public:
+	// generate an RGB image for the passed in pattern settings
+	void Generate(
+		const PATTERN_SETTINGS& settings,
+		int width,
+		int height,
+		std::vector<unsigned char>& pixels);
+
+	// set the number of threads used to generate an image
+	void SetWorkerThreads(int workerThreads);
+};
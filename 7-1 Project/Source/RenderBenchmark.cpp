@@ -0,0 +1,373 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderbenchmark.cpp
+// ============
+// measure the rendering cost of the 3D scene under different settings
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderBenchmark.h"
+#include "ImageDecoder.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+// declaration of global variables and defines
+namespace
+{
+	// frames rendered for each measurement by default
+	const int g_DefaultFramesPerTest = 300;
+	// frames rendered before measuring to settle the driver
+	const int g_WarmupFrames = 20;
+	// times each image is decoded by each backend
+	const int g_DecodeRepetitions = 10;
+	// frames rendered for each scene size of a sweep, which
+	// are few because the largest scenes are slow
+	const int g_SweepFrames = 10;
+	const int g_SweepWarmupFrames = 2;
+	// smallest scene of a sweep
+	const int g_SweepFirstSize = 1000;
+}
+
+/***********************************************************
+ *  RenderBenchmark()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderBenchmark::RenderBenchmark(
+	SceneManager* pSceneManager,
+	ViewManager* pViewManager,
+	GLFWwindow* pWindow)
+{
+	m_pSceneManager = pSceneManager;
+	m_pViewManager = pViewManager;
+	m_pWindow = pWindow;
+	m_framesPerTest = g_DefaultFramesPerTest;
+
+	m_timerQuery = 0;
+	glGenQueries(1, &m_timerQuery);
+}
+
+/***********************************************************
+ *  ~RenderBenchmark()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+RenderBenchmark::~RenderBenchmark()
+{
+	if (m_timerQuery != 0)
+	{
+		glDeleteQueries(1, &m_timerQuery);
+		m_timerQuery = 0;
+	}
+	m_pSceneManager = NULL;
+	m_pViewManager = NULL;
+	m_pWindow = NULL;
+}
+
+/***********************************************************
+ *  RenderFrames()
+ *
+ *  This method is used for rendering the passed in number of
+ *  frames and getting the average GPU and CPU time of the
+ *  scene rendering in each frame.
+ ***********************************************************/
+RenderBenchmark::FRAME_TIMING RenderBenchmark::RenderFrames(int frameCount)
+{
+	FRAME_TIMING timing;
+	timing.gpuMilliseconds = 0.0;
+	timing.cpuMilliseconds = 0.0;
+
+	GLuint64 totalNanoseconds = 0;
+	double totalCpuSeconds = 0.0;
+
+	for (int frame = 0; frame < frameCount; frame++)
+	{
+		glEnable(GL_DEPTH_TEST);
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		m_pViewManager->PrepareSceneView();
+
+		double cpuStart = glfwGetTime();
+		glBeginQuery(GL_TIME_ELAPSED, m_timerQuery);
+		m_pSceneManager->RenderScene();
+		glEndQuery(GL_TIME_ELAPSED);
+		totalCpuSeconds += glfwGetTime() - cpuStart;
+
+		glfwSwapBuffers(m_pWindow);
+		glfwPollEvents();
+
+		// waiting on the result keeps the frames from overlapping,
+		// so every frame measures only its own GPU work
+		GLuint64 elapsedNanoseconds = 0;
+		glGetQueryObjectui64v(m_timerQuery, GL_QUERY_RESULT, &elapsedNanoseconds);
+		totalNanoseconds += elapsedNanoseconds;
+	}
+
+	if (frameCount > 0)
+	{
+		timing.gpuMilliseconds = (double)totalNanoseconds / 1000000.0 / frameCount;
+		timing.cpuMilliseconds = totalCpuSeconds * 1000.0 / frameCount;
+	}
+
+	return(timing);
+}
+
+/***********************************************************
+ *  RunSamplerBenchmark()
+ *
+ *  This method is used for rendering the scene with every
+ *  texture forced to each filtering preset in turn.  Texture
+ *  fetch bandwidth is not exposed by OpenGL, so the GPU time
+ *  of the frame is reported as its measure, relative to the
+ *  trilinear preset.
+ ***********************************************************/
+void RenderBenchmark::RunSamplerBenchmark()
+{
+	FRAME_TIMING timings[TextureSamplers::FILTER_COUNT];
+
+	// do not let the display refresh rate limit the frames
+	glfwSwapInterval(0);
+
+	std::cout << "\n*** SAMPLER BENCHMARK (" << m_framesPerTest << " frames each) ***\n";
+
+	for (int filter = 0; filter < TextureSamplers::FILTER_COUNT; filter++)
+	{
+		m_pSceneManager->SetSamplerOverride(filter);
+		RenderFrames(g_WarmupFrames);
+		timings[filter] = RenderFrames(m_framesPerTest);
+	}
+
+	// return to the presets of the textures and materials
+	m_pSceneManager->SetSamplerOverride(-1);
+	glfwSwapInterval(1);
+
+	double baseline = timings[TextureSamplers::FILTER_TRILINEAR].gpuMilliseconds;
+	for (int filter = 0; filter < TextureSamplers::FILTER_COUNT; filter++)
+	{
+		std::cout << std::left << std::setw(18)
+			<< TextureSamplers::GetFilterName((TextureSamplers::SAMPLER_FILTER)filter)
+			<< std::fixed << std::setprecision(3)
+			<< " GPU: " << timings[filter].gpuMilliseconds << " ms"
+			<< "  CPU: " << timings[filter].cpuMilliseconds << " ms";
+		if (baseline > 0.0)
+		{
+			std::cout << "  (" << std::setprecision(2)
+				<< (timings[filter].gpuMilliseconds / baseline) << "x trilinear)";
+		}
+		std::cout << "\n";
+	}
+	std::cout << std::endl;
+}
+
+/***********************************************************
+ *  RunDecoderBenchmark()
+ *
+ *  This method is used for decoding each of the passed in
+ *  image files repeatedly with every backend that can read
+ *  it, and reporting the throughput in megapixels and input
+ *  megabytes per second.  When a raw cache file exists next
+ *  to an image, the raw backend is measured with it.  Since
+ *  the raw backend only checks the header and points into
+ *  the data, its time includes reading the cache file.
+ ***********************************************************/
+void RenderBenchmark::RunDecoderBenchmark(const std::vector<std::string>& filenames)
+{
+	ImageDecoderRegistry decoders;
+
+	std::cout << "\n*** DECODER BENCHMARK (" << g_DecodeRepetitions << " decodes each) ***\n";
+
+	for (size_t file = 0; file < filenames.size(); file++)
+	{
+		std::vector<unsigned char> sourceData;
+		std::vector<unsigned char> cacheData;
+		if (ImageDecoderRegistry::ReadFile(filenames[file].c_str(), sourceData) == false)
+		{
+			std::cout << "Could not read image:" << filenames[file] << "\n";
+			continue;
+		}
+		ImageDecoderRegistry::ReadFile((filenames[file] + ".rimg").c_str(), cacheData);
+
+		std::cout << filenames[file] << "\n";
+
+		for (int index = 0; index < decoders.GetDecoderCount(); index++)
+		{
+			ImageDecoder* pDecoder = decoders.GetDecoder(index);
+
+			// each backend reads either the source file or the cache
+			std::vector<unsigned char>* pData = &sourceData;
+			if (pDecoder->CanDecode(&sourceData[0], sourceData.size()) == false)
+			{
+				pData = &cacheData;
+				if ((pData->empty() == true) ||
+					(pDecoder->CanDecode(&(*pData)[0], pData->size()) == false))
+				{
+					continue;
+				}
+			}
+
+			// the cache is read from disk every time, which is the
+			// work it stands in for next to a real decode
+			bool bReadsFile = (pData == &cacheData);
+			std::string cacheFile = filenames[file] + ".rimg";
+
+			double pixels = 0.0;
+			double start = glfwGetTime();
+			for (int repetition = 0; repetition < g_DecodeRepetitions; repetition++)
+			{
+				if ((bReadsFile == true) &&
+					(ImageDecoderRegistry::ReadFile(cacheFile.c_str(), cacheData) == false))
+				{
+					break;
+				}
+
+				DECODED_IMAGE image;
+				if (pDecoder->Decode(&(*pData)[0], pData->size(), image) == false)
+				{
+					break;
+				}
+				pixels += (double)image.width * image.height;
+				pDecoder->Free(image);
+			}
+			double seconds = glfwGetTime() - start;
+
+			if ((seconds > 0.0) && (pixels > 0.0))
+			{
+				double inputMegabytes = (double)pData->size() * g_DecodeRepetitions / (1024.0 * 1024.0);
+				std::string name = pDecoder->GetName();
+				if (bReadsFile == true)
+				{
+					name += " + read";
+				}
+				std::cout << "  " << std::left << std::setw(20) << name
+					<< std::fixed << std::setprecision(1)
+					<< (pixels / 1000000.0 / seconds) << " Mpixel/s  "
+					<< (inputMegabytes / seconds) << " MB/s input\n";
+			}
+		}
+	}
+	std::cout << std::endl;
+}
+
+/***********************************************************
+ *  RunStressSweep()
+ *
+ *  This method is used for rendering generated scenes of
+ *  1000 objects and up by factors of ten, all made from the
+ *  same settings and seed, and writing the CPU and GPU time
+ *  of their frames against the number of objects.
+ ***********************************************************/
+void RenderBenchmark::RunStressSweep(
+	const StressSceneGenerator::STRESS_SETTINGS& settings,
+	int maxObjects,
+	const char* csvFile)
+{
+	std::vector<int> sizes;
+	GetSweepSizes(maxObjects, sizes);
+
+	// do not let the display refresh rate limit the frames
+	glfwSwapInterval(0);
+
+	std::vector<SWEEP_RESULT> results;
+	for (size_t i = 0; i < sizes.size(); i++)
+	{
+		StressSceneGenerator::STRESS_SETTINGS sizeSettings = settings;
+		sizeSettings.objectCount = sizes[i];
+		m_pSceneManager->GenerateStressScene(sizeSettings);
+
+		RenderFrames(g_SweepWarmupFrames);
+		FRAME_TIMING timing = RenderFrames(g_SweepFrames);
+
+		SWEEP_RESULT result;
+		result.objects = sizes[i];
+		result.draws = (int)m_pSceneManager->GetDrawList().size();
+		result.cpuMilliseconds = timing.cpuMilliseconds;
+		result.renderMilliseconds = timing.gpuMilliseconds;
+		results.push_back(result);
+	}
+
+	glfwSwapInterval(1);
+	WriteSweepResults(csvFile, "OpenGL", results);
+}
+
+/***********************************************************
+ *  GetSweepSizes()
+ *
+ *  This method is used for getting the scene sizes of a
+ *  sweep, which grow by factors of ten from 1000 objects and
+ *  end with the passed in most.
+ ***********************************************************/
+void RenderBenchmark::GetSweepSizes(int maxObjects, std::vector<int>& sizes)
+{
+	sizes.clear();
+	for (int size = g_SweepFirstSize; size < maxObjects; size *= 10)
+	{
+		sizes.push_back(size);
+	}
+	if (maxObjects > 0)
+	{
+		sizes.push_back(maxObjects);
+	}
+}
+
+/***********************************************************
+ *  WriteSweepResults()
+ *
+ *  This method is used for printing the timing of each scene
+ *  size of a sweep and writing it to a CSV file, ready to be
+ *  plotted as frame time against the number of objects.
+ ***********************************************************/
+bool RenderBenchmark::WriteSweepResults(
+	const char* csvFile,
+	const char* renderer,
+	const std::vector<SWEEP_RESULT>& results)
+{
+	std::cout << "\n*** STRESS SWEEP (" << renderer << ") ***\n";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const SWEEP_RESULT& result = results[i];
+		std::cout << std::right << std::setw(9) << result.objects << " objects "
+			<< std::setw(9) << result.draws << " draws"
+			<< std::fixed << std::setprecision(3)
+			<< "  CPU: " << result.cpuMilliseconds << " ms"
+			<< "  render: " << result.renderMilliseconds << " ms\n";
+	}
+	std::cout << std::endl;
+
+	std::ofstream file(csvFile);
+	if (!file)
+	{
+		std::cout << "ERROR: could not write " << csvFile << std::endl;
+		return(false);
+	}
+
+	file << "renderer,objects,draws,cpu_ms,render_ms,frame_ms\n";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const SWEEP_RESULT& result = results[i];
+		file << renderer << "," << result.objects << "," << result.draws << ","
+			<< std::fixed << std::setprecision(4)
+			<< result.cpuMilliseconds << "," << result.renderMilliseconds << ","
+			<< (result.cpuMilliseconds + result.renderMilliseconds) << "\n";
+	}
+
+	std::cout << "INFO: wrote " << csvFile << std::endl;
+	return(true);
+}
+
+/***********************************************************
+ *  SetFramesPerTest()
+ *
+ *  This method is used for setting how many frames are
+ *  rendered for each measurement.
+ ***********************************************************/
+void RenderBenchmark::SetFramesPerTest(int framesPerTest)
+{
+	if (framesPerTest > 0)
+	{
+		m_framesPerTest = framesPerTest;
+	}
+}
@@ -0,0 +1,90 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderbenchmark.h
+// ============
+// measure the rendering cost of the 3D scene under different settings
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+
+/***********************************************************
+ *  RenderBenchmark
+ *
+ *  This class renders the 3D scene for a fixed number of
+ *  frames under each setting being compared and reports the
+ *  GPU time measured with timer queries, along with the CPU
+ *  time spent submitting each frame.
+ ***********************************************************/
+class RenderBenchmark
+{
+public:
+	// constructor
+	RenderBenchmark(
+		SceneManager* pSceneManager,
+		ViewManager* pViewManager,
+		GLFWwindow* pWindow);
+	// destructor
+	~RenderBenchmark();
+
+	// properties for the timing of one benchmark run
+	struct FRAME_TIMING
+	{
+		double gpuMilliseconds;
+		double cpuMilliseconds;
+	};
+
+	// properties for the timing of one generated scene size
+	struct SWEEP_RESULT
+	{
+		int objects;
+		int draws;
+		// time spent preparing and submitting the draws
+		double cpuMilliseconds;
+		// time spent drawing them on the GPU or rasterizer
+		double renderMilliseconds;
+	};
+
+private:
+	// pointer to the scene manager object
+	SceneManager* m_pSceneManager;
+	// pointer to the view manager object
+	ViewManager* m_pViewManager;
+	// window that the benchmark frames are drawn into
+	GLFWwindow* m_pWindow;
+	// OpenGL query object for timing the GPU work
+	GLuint m_timerQuery;
+	// number of frames rendered for each measurement
+	int m_framesPerTest;
+
+	// render frames and get their average timing
+	FRAME_TIMING RenderFrames(int frameCount);
+
+public:
+	// compare the GPU cost of the texture sampler presets
+	void RunSamplerBenchmark();
+	// compare the throughput of the image decoder backends
+	static void RunDecoderBenchmark(const std::vector<std::string>& filenames);
+	// time generated scenes of growing size and write the
+	// results to a CSV file
+	void RunStressSweep(
+		const StressSceneGenerator::STRESS_SETTINGS& settings,
+		int maxObjects,
+		const char* csvFile);
+
+	// get the scene sizes of a sweep, from 1000 objects up by
+	// factors of ten to the passed in most
+	static void GetSweepSizes(int maxObjects, std::vector<int>& sizes);
+	// print the results of a sweep and write them to a CSV file
+	static bool WriteSweepResults(
+		const char* csvFile,
+		const char* renderer,
+		const std::vector<SWEEP_RESULT>& results);
+
+	// set the number of frames rendered for each measurement
+	void SetFramesPerTest(int framesPerTest);
+};
@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderdevice.h
+// ============
+// the rendering interface shared by the graphics API backends
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  RenderDevice
+ *
+ *  This interface is what the scene and view managers draw
+ *  through, so the same draw list can be issued by OpenGL or
+ *  by another graphics API.  A backend creates its own copies
+ *  of the scene meshes and textures, and then receives the
+ *  camera, the lights and the recorded draws of every frame.
+ ***********************************************************/
+class RenderDevice
+{
+public:
+	// destructor
+	virtual ~RenderDevice() {}
+
+	// properties for one camera drawn into a rectangle of the
+	// image, with x and y measured from the top left corner
+	struct VIEWPORT_VIEW
+	{
+		glm::mat4 view;
+		glm::mat4 projection;
+		glm::vec3 viewPosition;
+		int x;
+		int y;
+		int width;
+		int height;
+	};
+
+	// get the display name of the backend
+	virtual const char* GetName() const = 0;
+
+	// create the meshes and textures that the scene draws with
+	virtual bool LoadScene(const SceneManager* pSceneManager) = 0;
+	// set the camera used by the following draws
+	virtual void SetView(
+		const glm::mat4& view,
+		const glm::mat4& projection,
+		const glm::vec3& viewPosition) = 0;
+	// set several cameras, each drawing the following draws
+	// into its own rectangle, until SetView() is called again
+	virtual void SetViews(const std::vector<VIEWPORT_VIEW>& views) = 0;
+	// set the light sources used by the following draws
+	virtual void SetLights(const std::vector<SceneManager::LIGHT_SOURCE>& lights) = 0;
+	// issue the recorded draws of one frame, in order
+	virtual void SubmitDraws(
+		const std::vector<SceneManager::DRAW_COMMAND>& draws,
+		const std::vector<SceneManager::OBJECT_MATERIAL>& materials) = 0;
+};
@@ -0,0 +1,402 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderfarm.cpp
+// ============
+// shard the frames of a camera path across worker processes
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderFarm.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#else
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+// declaration of global variables and defines
+namespace
+{
+	// option that marks a process as a worker of the farm
+	const char* g_WorkerOption = "--farm-worker";
+	// option that makes the workers share the asset files
+	const char* g_MappedAssetsOption = "--map-assets";
+
+	// get the time from a steady clock in milliseconds
+	double GetMilliseconds()
+	{
+		return(std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+}
+
+/***********************************************************
+ *  RenderFarm()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderFarm::RenderFarm()
+{
+	// default to one worker per hardware thread
+	m_workerCount = std::max(1, (int)std::thread::hardware_concurrency());
+	m_firstFrame = 0;
+	m_lastFrame = 0;
+
+	m_stats.frames = 0;
+	m_stats.failedWorkers = 0;
+	m_stats.seconds = 0.0;
+}
+
+/***********************************************************
+ *  SetWorkerCount()
+ *
+ *  This method is used for setting how many worker processes
+ *  are started, where 0 or less keeps the default of one per
+ *  hardware thread.
+ ***********************************************************/
+void RenderFarm::SetWorkerCount(int workerCount)
+{
+	if (workerCount > 0)
+	{
+		m_workerCount = workerCount;
+	}
+}
+
+/***********************************************************
+ *  SetFrameRange()
+ *
+ *  This method is used for setting the first and last frame
+ *  rendered by the farm.
+ ***********************************************************/
+void RenderFarm::SetFrameRange(int firstFrame, int lastFrame)
+{
+	m_firstFrame = std::min(firstFrame, lastFrame);
+	m_lastFrame = std::max(firstFrame, lastFrame);
+}
+
+/***********************************************************
+ *  IsWorkerFrame()
+ *
+ *  This method is used for checking whether a frame belongs
+ *  to a worker.  The frames are dealt out in turn, so every
+ *  worker gets frames from the whole length of the path.
+ ***********************************************************/
+bool RenderFarm::IsWorkerFrame(int frame, int workerIndex, int workerCount)
+{
+	if (workerCount <= 1)
+	{
+		return(true);
+	}
+
+	int remainder = frame % workerCount;
+	if (remainder < 0)
+	{
+		remainder += workerCount;
+	}
+	return(remainder == workerIndex);
+}
+
+/***********************************************************
+ *  GetFrameFilename()
+ *
+ *  This method is used for getting the image file of a frame.
+ *  The last run of # characters in the pattern is replaced
+ *  with the frame number padded to as many digits.  Without
+ *  any, a printf frame field such as %04d is filled in, and
+ *  a pattern with neither gets _#### added before its
+ *  extension.
+ ***********************************************************/
+std::string RenderFarm::GetFrameFilename(const std::string& pattern, int frame)
+{
+	std::string filename = pattern;
+	size_t end = filename.find_last_of('#');
+
+	// the field is read here rather than passing the pattern
+	// to printf, so no other % in a file name is taken as one
+	if (end == std::string::npos)
+	{
+		for (size_t i = 0; i + 1 < filename.size(); i++)
+		{
+			if (filename[i] != '%')
+			{
+				continue;
+			}
+			// a doubled % is not a field
+			if (filename[i + 1] == '%')
+			{
+				i++;
+				continue;
+			}
+
+			size_t field = i + 1;
+			bool bZeroPad = (filename[field] == '0');
+			if (bZeroPad == true)
+			{
+				field++;
+			}
+			int width = 0;
+			while ((field < filename.size()) && (filename[field] >= '0') && (filename[field] <= '9') && (width < 100))
+			{
+				width = width * 10 + (filename[field] - '0');
+				field++;
+			}
+			if ((field < filename.size()) && (filename[field] == 'd'))
+			{
+				char number[128];
+				snprintf(number, sizeof(number), bZeroPad ? "%0*d" : "%*d", width, frame);
+				filename.replace(i, field - i + 1, number);
+				return(filename);
+			}
+		}
+	}
+
+	if (end == std::string::npos)
+	{
+		size_t extension = filename.find_last_of('.');
+		size_t separator = filename.find_last_of("/\\");
+		if ((extension == std::string::npos) ||
+			((separator != std::string::npos) && (extension < separator)))
+		{
+			extension = filename.size();
+		}
+		filename.insert(extension, "_####");
+		end = filename.find_last_of('#');
+	}
+
+	size_t start = end;
+	while ((start > 0) && (filename[start - 1] == '#'))
+	{
+		start--;
+	}
+
+	char number[32];
+	snprintf(number, sizeof(number), "%0*d", (int)(end - start + 1), frame);
+	filename.replace(start, end - start + 1, number);
+	return(filename);
+}
+
+/***********************************************************
+ *  LaunchWorker()
+ *
+ *  This method is used for starting a copy of the program
+ *  with the passed in command line.
+ ***********************************************************/
+bool RenderFarm::LaunchWorker(const std::vector<std::string>& arguments, WORKER_PROCESS& worker)
+{
+#ifndef _WIN32
+	// the argument list is built before forking, so the child
+	// only has to replace itself with the new program
+	std::vector<char*> argumentList;
+	for (size_t i = 0; i < arguments.size(); i++)
+	{
+		argumentList.push_back(const_cast<char*>(arguments[i].c_str()));
+	}
+	argumentList.push_back(NULL);
+
+	pid_t processID = fork();
+	if (processID < 0)
+	{
+		return(false);
+	}
+	if (processID == 0)
+	{
+		execvp(argumentList[0], &argumentList[0]);
+		_exit(127);
+	}
+
+	worker.processID = (int)processID;
+	return(true);
+#else
+	// quote every argument, since paths may hold spaces.  As the
+	// child splits the line with the CommandLineToArgvW rules,
+	// backslashes are only doubled when they come before a quote
+	std::string commandLine;
+	for (size_t i = 0; i < arguments.size(); i++)
+	{
+		if (i > 0)
+		{
+			commandLine += " ";
+		}
+		commandLine += "\"";
+		size_t backslashes = 0;
+		for (size_t c = 0; c < arguments[i].size(); c++)
+		{
+			if (arguments[i][c] == '\\')
+			{
+				backslashes++;
+				continue;
+			}
+			if (arguments[i][c] == '"')
+			{
+				commandLine.append(backslashes * 2 + 1, '\\');
+			}
+			else
+			{
+				commandLine.append(backslashes, '\\');
+			}
+			commandLine += arguments[i][c];
+			backslashes = 0;
+		}
+		commandLine.append(backslashes * 2, '\\');
+		commandLine += "\"";
+	}
+
+	// the program is started from its own path, not the search path
+	char programPath[MAX_PATH];
+	DWORD length = GetModuleFileNameA(NULL, programPath, MAX_PATH);
+	if ((length == 0) || (length >= MAX_PATH))
+	{
+		return(false);
+	}
+
+	STARTUPINFOA startupInfo;
+	PROCESS_INFORMATION processInfo;
+	ZeroMemory(&startupInfo, sizeof(startupInfo));
+	startupInfo.cb = sizeof(startupInfo);
+	ZeroMemory(&processInfo, sizeof(processInfo));
+
+	std::vector<char> commandBuffer(commandLine.begin(), commandLine.end());
+	commandBuffer.push_back('\0');
+	if (CreateProcessA(programPath, &commandBuffer[0], NULL, NULL, FALSE, 0, NULL, NULL, &startupInfo, &processInfo) == FALSE)
+	{
+		return(false);
+	}
+
+	CloseHandle(processInfo.hThread);
+	worker.processHandle = processInfo.hProcess;
+	return(true);
+#endif
+}
+
+/***********************************************************
+ *  WaitForWorker()
+ *
+ *  This method is used for waiting until a worker process
+ *  exits, and returns true when it reported success.
+ ***********************************************************/
+bool RenderFarm::WaitForWorker(WORKER_PROCESS& worker)
+{
+#ifndef _WIN32
+	int status = 0;
+	if (waitpid((pid_t)worker.processID, &status, 0) < 0)
+	{
+		return(false);
+	}
+	return(WIFEXITED(status) && (WEXITSTATUS(status) == 0));
+#else
+	WaitForSingleObject((HANDLE)worker.processHandle, INFINITE);
+	DWORD exitCode = 1;
+	GetExitCodeProcess((HANDLE)worker.processHandle, &exitCode);
+	CloseHandle((HANDLE)worker.processHandle);
+	return(exitCode == 0);
+#endif
+}
+
+/***********************************************************
+ *  Run()
+ *
+ *  This method is used for starting one worker process for
+ *  each share of the frame range and waiting for all of them
+ *  to finish.  The frames of workers that failed are not
+ *  counted in the frames per second.
+ ***********************************************************/
+bool RenderFarm::Run(int argc, char* argv[])
+{
+	m_stats.frames = 0;
+	m_stats.failedWorkers = 0;
+	m_stats.seconds = 0.0;
+
+	int frameCount = m_lastFrame - m_firstFrame + 1;
+	int workerCount = std::min(m_workerCount, frameCount);
+
+	// the workers get the same options, so they load the same
+	// scene and camera path as this process
+	std::vector<std::string> arguments;
+	bool bMappedAssets = false;
+	for (int i = 0; i < argc; i++)
+	{
+		arguments.push_back(argv[i]);
+		if (strcmp(argv[i], g_MappedAssetsOption) == 0)
+		{
+			bMappedAssets = true;
+		}
+	}
+	if (bMappedAssets == false)
+	{
+		arguments.push_back(g_MappedAssetsOption);
+	}
+	arguments.push_back(g_WorkerOption);
+	arguments.push_back("");
+	arguments.push_back(std::to_string(workerCount));
+
+	std::cout << "INFO: rendering frames " << m_firstFrame << " to " << m_lastFrame
+		<< " with " << workerCount << " worker processes" << std::endl;
+
+	double start = GetMilliseconds();
+	std::vector<WORKER_PROCESS> workers;
+	for (int i = 0; i < workerCount; i++)
+	{
+		WORKER_PROCESS worker;
+		worker.workerIndex = i;
+		worker.frames = 0;
+		for (int frame = m_firstFrame; frame <= m_lastFrame; frame++)
+		{
+			if (IsWorkerFrame(frame, i, workerCount) == true)
+			{
+				worker.frames++;
+			}
+		}
+
+		arguments[arguments.size() - 2] = std::to_string(i);
+		if (LaunchWorker(arguments, worker) == false)
+		{
+			std::cout << "ERROR: could not start render worker " << i << std::endl;
+			m_stats.failedWorkers++;
+			continue;
+		}
+		workers.push_back(worker);
+	}
+
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		if (WaitForWorker(workers[i]) == true)
+		{
+			m_stats.frames += workers[i].frames;
+		}
+		else
+		{
+			std::cout << "ERROR: render worker " << workers[i].workerIndex << " failed" << std::endl;
+			m_stats.failedWorkers++;
+		}
+	}
+	m_stats.seconds = (GetMilliseconds() - start) / 1000.0;
+
+	std::cout << "INFO: render farm finished " << m_stats.frames << "/" << frameCount
+		<< " frames in " << m_stats.seconds << " s, "
+		<< m_stats.frames / std::max(m_stats.seconds, 0.001) << " frames per second" << std::endl;
+
+	return(m_stats.failedWorkers == 0);
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the result of the last
+ *  run of the farm.
+ ***********************************************************/
+const RenderFarm::FARM_STATS& RenderFarm::GetStats() const
+{
+	return(m_stats);
+}
@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderfarm.h
+// ============
+// shard the frames of a camera path across worker processes
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  RenderFarm
+ *
+ *  This class renders a range of frames with several copies
+ *  of the program at once.  Each worker is started with the
+ *  same command line plus --farm-worker <index> <count>, so
+ *  it prepares its own headless scene and renders every
+ *  frame whose number modulo the count is its index, which
+ *  keeps the workers evenly loaded even when the cost of the
+ *  frames changes along the path.  The workers are asked to
+ *  map the asset files read-only, so they share one copy of
+ *  the file data instead of each reading its own.
+ ***********************************************************/
+class RenderFarm
+{
+public:
+	// constructor
+	RenderFarm();
+
+	// properties for the result of a farm run
+	struct FARM_STATS
+	{
+		int frames;
+		int failedWorkers;
+		double seconds;
+	};
+
+private:
+	// properties for a running worker process
+	struct WORKER_PROCESS
+	{
+#ifdef _WIN32
+		void* processHandle;
+#else
+		int processID;
+#endif
+		int workerIndex;
+		int frames;
+	};
+
+	// number of worker processes to start
+	int m_workerCount;
+	// inclusive range of frames to render
+	int m_firstFrame;
+	int m_lastFrame;
+	// result of the last run
+	FARM_STATS m_stats;
+
+	// start one worker with the passed in command line
+	bool LaunchWorker(const std::vector<std::string>& arguments, WORKER_PROCESS& worker);
+	// wait for a worker to exit and get whether it succeeded
+	bool WaitForWorker(WORKER_PROCESS& worker);
+
+public:
+	// set the number of worker processes
+	void SetWorkerCount(int workerCount);
+	// set the inclusive range of frames to render
+	void SetFrameRange(int firstFrame, int lastFrame);
+
+	// start the workers for the frame range and wait for them
+	bool Run(int argc, char* argv[]);
+	// get the result of the last run
+	const FARM_STATS& GetStats() const;
+
+	// check whether a frame is rendered by a worker
+	static bool IsWorkerFrame(int frame, int workerIndex, int workerCount);
+	// get the image file of a frame, replacing the last run of
+	// # characters or the printf frame field in the pattern with
+	// the number
+	static std::string GetFrameFilename(const std::string& pattern, int frame);
+};
@@ -0,0 +1,879 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderserver.cpp
+// ============
+// render batches of camera requests for clients of a local socket
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include <GL/glew.h>
+
+#include "RenderServer.h"
+#include "RenderDevice.h"
+#include "CameraPath.h"
+#include "FrameEncoder.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <afunix.h>
+#include <io.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// declaration of global variables and defines
+namespace
+{
+	// largest image a client may ask for on either side
+	const int g_MaxImageSize = 4096;
+	// number of framebuffer sizes kept between batches
+	const size_t g_MaxRenderTargets = 4;
+	// number of recent latencies used for the percentile
+	const size_t g_LatencyWindow = 1024;
+	// field of view of requests that do not give one,
+	// matching the interactive camera
+	const float g_DefaultFov = 80.0f;
+	// time to wait for new requests while the queue is empty
+	const int g_IdlePollMilliseconds = 200;
+	// longest request line a client may send, since requests
+	// are only a few numbers long
+	const size_t g_MaxLineLength = 4096;
+	// most reply bytes kept for a client that is not reading
+	const size_t g_MaxQueuedOutput = (size_t)256 << 20;
+	// time given to send the last replies after a shutdown
+	const double g_ShutdownFlushMilliseconds = 5000.0;
+
+#ifdef _WIN32
+	typedef WSAPOLLFD POLL_ENTRY;
+	const uintptr_t g_InvalidSocket = (uintptr_t)INVALID_SOCKET;
+
+	int PollSockets(POLL_ENTRY* entries, size_t count, int timeoutMilliseconds)
+	{
+		return(WSAPoll(entries, (ULONG)count, timeoutMilliseconds));
+	}
+	void CloseSocket(uintptr_t handle)
+	{
+		closesocket((SOCKET)handle);
+	}
+	void RemoveSocketFile(const char* path)
+	{
+		_unlink(path);
+	}
+	bool SetNonBlocking(uintptr_t handle)
+	{
+		u_long bEnabled = 1;
+		return(ioctlsocket((SOCKET)handle, FIONBIO, &bEnabled) == 0);
+	}
+	bool IsWouldBlock()
+	{
+		return(WSAGetLastError() == WSAEWOULDBLOCK);
+	}
+#else
+	typedef struct pollfd POLL_ENTRY;
+	const int g_InvalidSocket = -1;
+
+	int PollSockets(POLL_ENTRY* entries, size_t count, int timeoutMilliseconds)
+	{
+		return(poll(entries, (nfds_t)count, timeoutMilliseconds));
+	}
+	void CloseSocket(int handle)
+	{
+		close(handle);
+	}
+	void RemoveSocketFile(const char* path)
+	{
+		unlink(path);
+	}
+	bool SetNonBlocking(int handle)
+	{
+		int flags = fcntl(handle, F_GETFL, 0);
+		return((flags >= 0) && (fcntl(handle, F_SETFL, flags | O_NONBLOCK) == 0));
+	}
+	bool IsWouldBlock()
+	{
+		return((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR));
+	}
+#endif
+
+	// get the milliseconds between two points in time
+	double GetMilliseconds(
+		std::chrono::steady_clock::time_point start,
+		std::chrono::steady_clock::time_point end)
+	{
+		return(std::chrono::duration<double, std::milli>(end - start).count());
+	}
+}
+
+/***********************************************************
+ *  RenderServer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderServer::RenderServer(SceneManager* pSceneManager, SoftwareRasterizer* pRasterizer)
+{
+	m_pSceneManager = pSceneManager;
+	m_pRasterizer = pRasterizer;
+	m_listenHandle = g_InvalidSocket;
+	m_nextClientID = 0;
+	m_maxBatchSize = 64;
+	m_bShutdown = false;
+	m_bSocketsStarted = false;
+
+	m_stats.requests = 0;
+	m_stats.images = 0;
+	m_stats.errors = 0;
+	m_stats.batches = 0;
+	m_stats.queueDepth = 0;
+	m_stats.maxQueueDepth = 0;
+	m_stats.meanRenderMilliseconds = 0.0;
+	m_stats.meanLatencyMilliseconds = 0.0;
+	m_stats.p95LatencyMilliseconds = 0.0;
+	m_stats.maxLatencyMilliseconds = 0.0;
+	m_totalRenderMilliseconds = 0.0;
+	m_totalLatencyMilliseconds = 0.0;
+	m_nextLatency = 0;
+}
+
+/***********************************************************
+ *  ~RenderServer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+RenderServer::~RenderServer()
+{
+	Close();
+}
+
+/***********************************************************
+ *  SetMaxBatchSize()
+ *
+ *  This method is used for setting how many requests are
+ *  rendered before the server reads new ones again.
+ ***********************************************************/
+void RenderServer::SetMaxBatchSize(int maxBatchSize)
+{
+	if (maxBatchSize > 0)
+	{
+		m_maxBatchSize = maxBatchSize;
+	}
+}
+
+/***********************************************************
+ *  Run()
+ *
+ *  This method is used for listening on a socket path and
+ *  serving requests until a client asks for a shutdown.  A
+ *  batch is rendered once no more requests are waiting to
+ *  be read, so requests sent together are rendered together.
+ ***********************************************************/
+bool RenderServer::Run(const char* socketPath)
+{
+	if ((NULL == m_pSceneManager) || (NULL == socketPath))
+	{
+		return(false);
+	}
+
+#ifdef _WIN32
+	WSADATA socketData;
+	if (WSAStartup(MAKEWORD(2, 2), &socketData) != 0)
+	{
+		return(false);
+	}
+	m_bSocketsStarted = true;
+#else
+	// a client that goes away makes sends fail instead of
+	// ending the server
+	signal(SIGPIPE, SIG_IGN);
+#endif
+
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (strlen(socketPath) >= sizeof(address.sun_path))
+	{
+		std::cout << "Render server socket path is too long:" << socketPath << std::endl;
+		return(false);
+	}
+	strncpy(address.sun_path, socketPath, sizeof(address.sun_path) - 1);
+
+	// a socket file left by an earlier server is replaced
+	RemoveSocketFile(socketPath);
+	m_listenHandle = (SOCKET_HANDLE)socket(AF_UNIX, SOCK_STREAM, 0);
+	if ((m_listenHandle == g_InvalidSocket) ||
+		(bind(m_listenHandle, (struct sockaddr*)&address, sizeof(address)) != 0) ||
+		(listen(m_listenHandle, 16) != 0))
+	{
+		std::cout << "Could not listen on render server socket:" << socketPath << std::endl;
+		Close();
+		return(false);
+	}
+	m_socketPath = socketPath;
+	m_bShutdown = false;
+
+	std::cout << "INFO: render server listening on " << socketPath << std::endl;
+
+	bool bFlushing = false;
+	std::chrono::steady_clock::time_point flushStart;
+	while ((m_bShutdown == false) || (m_queue.empty() == false) || (HasPendingOutput() == true))
+	{
+		// the last replies get a short time to be read after a
+		// shutdown, so a client that stopped reading cannot keep
+		// the server running
+		if ((m_bShutdown == true) && (m_queue.empty() == true))
+		{
+			if (bFlushing == false)
+			{
+				bFlushing = true;
+				flushStart = std::chrono::steady_clock::now();
+			}
+			else if (GetMilliseconds(flushStart, std::chrono::steady_clock::now()) > g_ShutdownFlushMilliseconds)
+			{
+				break;
+			}
+		}
+
+		PollClients(m_queue.empty() ? g_IdlePollMilliseconds : 0);
+
+		// gather everything that has already arrived first
+		while ((m_bShutdown == false) && (m_queue.empty() == false) &&
+			((int)m_queue.size() < m_maxBatchSize) && (PollClients(0) == true))
+		{
+		}
+
+		if (m_queue.empty() == false)
+		{
+			RenderBatch();
+		}
+
+		// forget clients that have disconnected
+		for (size_t i = 0; i < m_clients.size();)
+		{
+			if (m_clients[i].bClosed == true)
+			{
+				CloseSocket(m_clients[i].handle);
+				m_clients.erase(m_clients.begin() + i);
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+
+	SERVER_STATS stats = GetStats();
+	std::cout << "INFO: render server answered " << stats.images << " images in "
+		<< stats.batches << " batches, " << stats.meanLatencyMilliseconds << " ms mean latency" << std::endl;
+
+	Close();
+	return(true);
+}
+
+/***********************************************************
+ *  PollClients()
+ *
+ *  This method is used for waiting up to the passed in time
+ *  for new clients and request data, handling every complete
+ *  line received, and sending queued replies to the clients
+ *  that can take them.  It returns true when anything was
+ *  accepted or read.
+ ***********************************************************/
+bool RenderServer::PollClients(int timeoutMilliseconds)
+{
+	std::vector<POLL_ENTRY> entries(m_clients.size() + 1);
+	entries[0].fd = m_listenHandle;
+	entries[0].events = POLLIN;
+	entries[0].revents = 0;
+	for (size_t i = 0; i < m_clients.size(); i++)
+	{
+		entries[i + 1].fd = m_clients[i].handle;
+		entries[i + 1].events = POLLIN;
+		if (m_clients[i].outputSent < m_clients[i].output.size())
+		{
+			entries[i + 1].events |= POLLOUT;
+		}
+		entries[i + 1].revents = 0;
+	}
+
+	if (PollSockets(&entries[0], entries.size(), timeoutMilliseconds) <= 0)
+	{
+		return(false);
+	}
+
+	bool bActivity = false;
+	size_t clientCount = m_clients.size();
+	for (size_t i = 0; i < clientCount; i++)
+	{
+		if (((entries[i + 1].revents & POLLOUT) != 0) && (m_clients[i].bClosed == false))
+		{
+			FlushClient(m_clients[i]);
+		}
+		if (((entries[i + 1].revents & (POLLIN | POLLHUP | POLLERR)) == 0) ||
+			(m_clients[i].bClosed == true))
+		{
+			continue;
+		}
+
+		char buffer[4096];
+		int received = (int)recv(m_clients[i].handle, buffer, sizeof(buffer), 0);
+		if ((received < 0) && (IsWouldBlock() == true))
+		{
+			continue;
+		}
+		if (received <= 0)
+		{
+			m_clients[i].bClosed = true;
+			continue;
+		}
+		bActivity = true;
+
+		m_clients[i].input.append(buffer, received);
+		size_t end = m_clients[i].input.find('\n');
+		while ((end != std::string::npos) && (m_clients[i].bClosed == false))
+		{
+			// a line too long to be a request is not buffered
+			if (end > g_MaxLineLength)
+			{
+				break;
+			}
+			std::string line = m_clients[i].input.substr(0, end);
+			m_clients[i].input.erase(0, end + 1);
+			if ((line.empty() == false) && (line[line.size() - 1] == '\r'))
+			{
+				line.erase(line.size() - 1);
+			}
+			HandleLine(m_clients[i].id, line);
+			end = m_clients[i].input.find('\n');
+		}
+
+		// the input only grows until a line ends, so a client
+		// whose line runs past the limit is dropped
+		if ((m_clients[i].bClosed == false) &&
+			(((end != std::string::npos) && (end > g_MaxLineLength)) ||
+			((end == std::string::npos) && (m_clients[i].input.size() > g_MaxLineLength))))
+		{
+			std::cout << "ERROR: render server dropped client " << m_clients[i].id
+				<< " for a request line over " << g_MaxLineLength << " bytes" << std::endl;
+			m_clients[i].bClosed = true;
+			m_stats.errors++;
+		}
+	}
+
+	if ((entries[0].revents & POLLIN) != 0)
+	{
+		SOCKET_HANDLE handle = (SOCKET_HANDLE)accept(m_listenHandle, NULL, NULL);
+		if ((handle != g_InvalidSocket) && (SetNonBlocking(handle) == false))
+		{
+			CloseSocket(handle);
+		}
+		else if (handle != g_InvalidSocket)
+		{
+			SERVER_CLIENT client;
+			client.id = m_nextClientID++;
+			client.handle = handle;
+			client.outputSent = 0;
+			client.bClosed = false;
+			m_clients.push_back(client);
+			bActivity = true;
+		}
+	}
+
+	return(bActivity);
+}
+
+/***********************************************************
+ *  HandleLine()
+ *
+ *  This method is used for queueing a render request or
+ *  answering a command sent by a client.
+ ***********************************************************/
+void RenderServer::HandleLine(int client, const std::string& line)
+{
+	std::istringstream fields(line);
+	std::string command;
+	fields >> command;
+
+	if (command == "render")
+	{
+		RENDER_REQUEST request;
+		request.client = client;
+		fields >> request.id >> request.width >> request.height
+			>> request.position.x >> request.position.y >> request.position.z
+			>> request.target.x >> request.target.y >> request.target.z;
+		if ((fields.fail() == true) ||
+			(request.width <= 0) || (request.width > g_MaxImageSize) ||
+			(request.height <= 0) || (request.height > g_MaxImageSize))
+		{
+			std::string reply = "error " + (request.id.empty() ? std::string("-") : request.id) + " invalid render request\n";
+			SendToClient(client, reply.c_str(), reply.size());
+			m_stats.errors++;
+			return;
+		}
+
+		// the field of view and the format may be left out
+		std::string option;
+		request.fov = g_DefaultFov;
+		request.bPNG = false;
+		while (fields >> option)
+		{
+			if (option == "png")
+			{
+				request.bPNG = true;
+			}
+			else if ((option != "qoi") && (atof(option.c_str()) > 0.0))
+			{
+				request.fov = std::min((float)atof(option.c_str()), 179.0f);
+			}
+		}
+
+		request.received = std::chrono::steady_clock::now();
+		m_queue.push_back(request);
+		m_stats.requests++;
+		m_stats.queueDepth = (int)m_queue.size();
+		m_stats.maxQueueDepth = std::max(m_stats.maxQueueDepth, m_stats.queueDepth);
+	}
+	else if (command == "stats")
+	{
+		SERVER_STATS stats = GetStats();
+		std::ostringstream reply;
+		reply << "stats requests=" << stats.requests
+			<< " images=" << stats.images
+			<< " errors=" << stats.errors
+			<< " batches=" << stats.batches
+			<< " queue=" << stats.queueDepth
+			<< " maxQueue=" << stats.maxQueueDepth
+			<< " renderMs=" << stats.meanRenderMilliseconds
+			<< " latencyMs=" << stats.meanLatencyMilliseconds
+			<< " p95LatencyMs=" << stats.p95LatencyMilliseconds
+			<< " maxLatencyMs=" << stats.maxLatencyMilliseconds << "\n";
+		SendToClient(client, reply.str().c_str(), reply.str().size());
+	}
+	else if (command == "quit")
+	{
+		SERVER_CLIENT* pClient = FindClient(client);
+		if (NULL != pClient)
+		{
+			pClient->bClosed = true;
+		}
+	}
+	else if (command == "shutdown")
+	{
+		m_bShutdown = true;
+	}
+	else if (command.empty() == false)
+	{
+		std::string reply = "error - unknown command " + command + "\n";
+		SendToClient(client, reply.c_str(), reply.size());
+		m_stats.errors++;
+	}
+}
+
+/***********************************************************
+ *  RenderBatch()
+ *
+ *  This method is used for rendering the oldest queued
+ *  requests, up to the batch size, and sending each image as
+ *  soon as it is encoded.  The batch is ordered by image size
+ *  so that every size needs its framebuffer bound only once.
+ ***********************************************************/
+void RenderServer::RenderBatch()
+{
+	size_t batchSize = std::min(m_queue.size(), (size_t)m_maxBatchSize);
+	std::vector<RENDER_REQUEST> batch(m_queue.begin(), m_queue.begin() + batchSize);
+	m_queue.erase(m_queue.begin(), m_queue.begin() + batchSize);
+	m_stats.queueDepth = (int)m_queue.size();
+	m_stats.batches++;
+
+	std::stable_sort(batch.begin(), batch.end(),
+		[](const RENDER_REQUEST& a, const RENDER_REQUEST& b)
+		{
+			return((a.width < b.width) || ((a.width == b.width) && (a.height < b.height)));
+		});
+
+	std::vector<unsigned char> pixels;
+	std::vector<unsigned char> encoded;
+	for (size_t i = 0; i < batch.size(); i++)
+	{
+		const RENDER_REQUEST& request = batch[i];
+		SERVER_CLIENT* pClient = FindClient(request.client);
+		if ((NULL == pClient) || (pClient->bClosed == true))
+		{
+			continue;
+		}
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		if (RenderImage(request, pixels) == false)
+		{
+			std::string reply = "error " + request.id + " render failed\n";
+			SendToClient(request.client, reply.c_str(), reply.size());
+			m_stats.errors++;
+			continue;
+		}
+
+		if (request.bPNG == true)
+		{
+			FrameEncoder::EncodePNG(&pixels[0], request.width, request.height, encoded);
+		}
+		else
+		{
+			FrameEncoder::EncodeQOI(&pixels[0], request.width, request.height, encoded);
+		}
+
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		double renderMilliseconds = GetMilliseconds(start, end);
+		double latencyMilliseconds = GetMilliseconds(request.received, end);
+
+		char header[256];
+		int headerSize = snprintf(header, sizeof(header), "image %s %s %u %.3f %.3f\n",
+			request.id.c_str(),
+			(request.bPNG == true) ? "png" : "qoi",
+			(unsigned int)encoded.size(),
+			renderMilliseconds,
+			latencyMilliseconds);
+		SendToClient(request.client, header, (size_t)headerSize);
+		SendToClient(request.client, (const char*)&encoded[0], encoded.size());
+
+		m_stats.images++;
+		m_totalRenderMilliseconds += renderMilliseconds;
+		AddLatency(latencyMilliseconds);
+	}
+}
+
+/***********************************************************
+ *  RenderImage()
+ *
+ *  This method is used for rendering the scene from the
+ *  camera of a request, with the CPU rasterizer or into a
+ *  framebuffer object, and getting the pixels top row first.
+ ***********************************************************/
+bool RenderServer::RenderImage(const RENDER_REQUEST& request, std::vector<unsigned char>& pixels)
+{
+	glm::mat4 view;
+	glm::mat4 projection;
+	CameraPath::GetCameraView(
+		request.position,
+		request.target,
+		request.fov,
+		request.width,
+		request.height,
+		view,
+		projection);
+
+	// the cells of a streamed world around the requested camera
+	// are waited for, so every image shows the whole world
+	m_pSceneManager->UpdateWorldStreaming(request.position, true);
+
+	size_t size = (size_t)request.width * request.height * 4;
+	pixels.resize(size);
+
+	if (NULL != m_pRasterizer)
+	{
+		m_pRasterizer->SetResolution(request.width, request.height);
+		m_pRasterizer->RenderScene(m_pSceneManager, view, projection, request.position);
+		memcpy(&pixels[0], m_pRasterizer->GetPixels(), size);
+		return(true);
+	}
+
+	RenderDevice* pRenderDevice = m_pSceneManager->GetRenderDevice();
+	RENDER_TARGET* pTarget = GetRenderTarget(request.width, request.height);
+	if ((NULL == pRenderDevice) || (NULL == pTarget))
+	{
+		return(false);
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, pTarget->framebuffer);
+	glViewport(0, 0, request.width, request.height);
+	glEnable(GL_DEPTH_TEST);
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	pRenderDevice->SetView(view, projection, request.position);
+	m_pSceneManager->RenderScene();
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, request.width, request.height, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+
+	// OpenGL reads the bottom row first
+	size_t rowSize = (size_t)request.width * 4;
+	std::vector<unsigned char> row(rowSize);
+	for (int y = 0; y < request.height / 2; y++)
+	{
+		unsigned char* top = &pixels[rowSize * y];
+		unsigned char* bottom = &pixels[rowSize * (request.height - 1 - y)];
+		memcpy(&row[0], top, rowSize);
+		memcpy(top, bottom, rowSize);
+		memcpy(bottom, &row[0], rowSize);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetRenderTarget()
+ *
+ *  This method is used for getting a framebuffer object of
+ *  the passed in size, creating it when needed and replacing
+ *  the size used longest ago once enough are kept.
+ ***********************************************************/
+RenderServer::RENDER_TARGET* RenderServer::GetRenderTarget(int width, int height)
+{
+	for (size_t i = 0; i < m_targets.size(); i++)
+	{
+		if ((m_targets[i].width == width) && (m_targets[i].height == height))
+		{
+			m_targets[i].lastBatch = m_stats.batches;
+			return(&m_targets[i]);
+		}
+	}
+
+	if (m_targets.size() >= g_MaxRenderTargets)
+	{
+		size_t oldest = 0;
+		for (size_t i = 1; i < m_targets.size(); i++)
+		{
+			if (m_targets[i].lastBatch < m_targets[oldest].lastBatch)
+			{
+				oldest = i;
+			}
+		}
+		glDeleteRenderbuffers(2, m_targets[oldest].renderbuffers);
+		glDeleteFramebuffers(1, &m_targets[oldest].framebuffer);
+		m_targets.erase(m_targets.begin() + oldest);
+	}
+
+	RENDER_TARGET target;
+	target.width = width;
+	target.height = height;
+	target.lastBatch = m_stats.batches;
+	glGenFramebuffers(1, &target.framebuffer);
+	glGenRenderbuffers(2, target.renderbuffers);
+	glBindRenderbuffer(GL_RENDERBUFFER, target.renderbuffers[0]);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, target.renderbuffers[1]);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+	glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target.renderbuffers[0]);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, target.renderbuffers[1]);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDeleteRenderbuffers(2, target.renderbuffers);
+		glDeleteFramebuffers(1, &target.framebuffer);
+		return(NULL);
+	}
+
+	m_targets.push_back(target);
+	return(&m_targets.back());
+}
+
+/***********************************************************
+ *  FindClient()
+ *
+ *  This method is used for finding a connected client by
+ *  the id it was given when it connected.
+ ***********************************************************/
+RenderServer::SERVER_CLIENT* RenderServer::FindClient(int client)
+{
+	for (size_t i = 0; i < m_clients.size(); i++)
+	{
+		if (m_clients[i].id == client)
+		{
+			return(&m_clients[i]);
+		}
+	}
+	return(NULL);
+}
+
+/***********************************************************
+ *  SendToClient()
+ *
+ *  This method is used for queueing the passed in bytes for
+ *  a client and sending as much of its queue as its socket
+ *  takes right away.  The rest is sent as the client reads,
+ *  and a client that lets too much pile up is closed.
+ ***********************************************************/
+void RenderServer::SendToClient(int client, const char* data, size_t size)
+{
+	SERVER_CLIENT* pClient = FindClient(client);
+	if ((NULL == pClient) || (pClient->bClosed == true))
+	{
+		return;
+	}
+
+	if (pClient->output.size() - pClient->outputSent + size > g_MaxQueuedOutput)
+	{
+		std::cout << "ERROR: render server dropped client " << pClient->id
+			<< " for not reading its replies" << std::endl;
+		pClient->bClosed = true;
+		m_stats.errors++;
+		return;
+	}
+
+	pClient->output.append(data, size);
+	FlushClient(*pClient);
+}
+
+/***********************************************************
+ *  FlushClient()
+ *
+ *  This method is used for sending the queued bytes of a
+ *  client until its socket would block.  The sent bytes are
+ *  only removed once they outweigh the rest of the queue, so
+ *  large replies are not moved again for every send.
+ ***********************************************************/
+void RenderServer::FlushClient(SERVER_CLIENT& client)
+{
+	while (client.outputSent < client.output.size())
+	{
+		size_t remaining = client.output.size() - client.outputSent;
+		int sent = (int)send(client.handle, client.output.data() + client.outputSent, (int)std::min(remaining, (size_t)1 << 20), 0);
+		if ((sent < 0) && (IsWouldBlock() == true))
+		{
+			// drop the sent bytes once they are most of the queue
+			if (client.outputSent > remaining)
+			{
+				client.output.erase(0, client.outputSent);
+				client.outputSent = 0;
+			}
+			return;
+		}
+		if (sent <= 0)
+		{
+			client.bClosed = true;
+			return;
+		}
+		client.outputSent += (size_t)sent;
+	}
+
+	client.output.clear();
+	client.outputSent = 0;
+}
+
+/***********************************************************
+ *  HasPendingOutput()
+ *
+ *  This method is used for checking whether any connected
+ *  client still has replies waiting to be sent.
+ ***********************************************************/
+bool RenderServer::HasPendingOutput() const
+{
+	for (size_t i = 0; i < m_clients.size(); i++)
+	{
+		if ((m_clients[i].bClosed == false) &&
+			(m_clients[i].outputSent < m_clients[i].output.size()))
+		{
+			return(true);
+		}
+	}
+	return(false);
+}
+
+/***********************************************************
+ *  AddLatency()
+ *
+ *  This method is used for recording the latency of an
+ *  answered request, keeping the most recent ones for the
+ *  95th percentile.
+ ***********************************************************/
+void RenderServer::AddLatency(double milliseconds)
+{
+	m_totalLatencyMilliseconds += milliseconds;
+	m_stats.maxLatencyMilliseconds = std::max(m_stats.maxLatencyMilliseconds, milliseconds);
+
+	if (m_recentLatencies.size() < g_LatencyWindow)
+	{
+		m_recentLatencies.push_back(milliseconds);
+	}
+	else
+	{
+		m_recentLatencies[m_nextLatency] = milliseconds;
+		m_nextLatency = (m_nextLatency + 1) % (int)g_LatencyWindow;
+	}
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the request counts, the
+ *  queue depth and the render and latency times so far.
+ ***********************************************************/
+RenderServer::SERVER_STATS RenderServer::GetStats() const
+{
+	SERVER_STATS stats = m_stats;
+	if (stats.images > 0)
+	{
+		stats.meanRenderMilliseconds = m_totalRenderMilliseconds / stats.images;
+		stats.meanLatencyMilliseconds = m_totalLatencyMilliseconds / stats.images;
+	}
+	if (m_recentLatencies.empty() == false)
+	{
+		std::vector<double> sorted = m_recentLatencies;
+		size_t index = std::min(sorted.size() - 1, (sorted.size() * 95) / 100);
+		std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+		stats.p95LatencyMilliseconds = sorted[index];
+	}
+	return(stats);
+}
+
+/***********************************************************
+ *  Close()
+ *
+ *  This method is used for closing the client and listening
+ *  sockets, removing the socket file and freeing the
+ *  framebuffer objects.
+ ***********************************************************/
+void RenderServer::Close()
+{
+	for (size_t i = 0; i < m_clients.size(); i++)
+	{
+		CloseSocket(m_clients[i].handle);
+	}
+	m_clients.clear();
+
+	if (m_listenHandle != g_InvalidSocket)
+	{
+		CloseSocket(m_listenHandle);
+		m_listenHandle = g_InvalidSocket;
+		if (m_socketPath.empty() == false)
+		{
+			RemoveSocketFile(m_socketPath.c_str());
+			m_socketPath.clear();
+		}
+	}
+
+	if (NULL == m_pRasterizer)
+	{
+		for (size_t i = 0; i < m_targets.size(); i++)
+		{
+			glDeleteRenderbuffers(2, m_targets[i].renderbuffers);
+			glDeleteFramebuffers(1, &m_targets[i].framebuffer);
+		}
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+	m_targets.clear();
+
+#ifdef _WIN32
+	if (m_bSocketsStarted == true)
+	{
+		WSACleanup();
+	}
+#endif
+	m_bSocketsStarted = false;
+}
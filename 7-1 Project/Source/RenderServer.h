@@ -0,0 +1,171 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderserver.h
+// ============
+// render batches of camera requests for clients of a local socket
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+#include "SoftwareRasterizer.h"
+
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  RenderServer
+ *
+ *  This class keeps the prepared scene loaded and renders
+ *  images for clients connected to a Unix domain socket, so
+ *  many thumbnails can be made without starting the program
+ *  for each one.  Clients send one request per line:
+ *
+ *      render <id> <width> <height> <posX> <posY> <posZ>
+ *             <targetX> <targetY> <targetZ> [fov] [qoi|png]
+ *      stats
+ *      quit
+ *      shutdown
+ *
+ *  and each image comes back as the line
+ *
+ *      image <id> <format> <bytes> <renderMs> <latencyMs>
+ *
+ *  followed by the encoded file.  Requests that arrive
+ *  together are rendered as one batch, ordered by size so
+ *  images of one size are drawn back to back into the same
+ *  framebuffer object, or with the CPU rasterizer when one
+ *  is given.  Replies are queued for each client and written
+ *  without blocking whenever its socket can take more, so a
+ *  client that reads slowly never holds up the others, and a
+ *  client sending overlong lines is dropped.
+ ***********************************************************/
+class RenderServer
+{
+public:
+	// constructor, with the CPU rasterizer or NULL for OpenGL
+	RenderServer(SceneManager* pSceneManager, SoftwareRasterizer* pRasterizer);
+	// destructor
+	~RenderServer();
+
+	// properties for the load and latency of the server
+	struct SERVER_STATS
+	{
+		int requests;
+		int images;
+		int errors;
+		int batches;
+		int queueDepth;
+		int maxQueueDepth;
+		double meanRenderMilliseconds;
+		double meanLatencyMilliseconds;
+		double p95LatencyMilliseconds;
+		double maxLatencyMilliseconds;
+	};
+
+private:
+	// properties for one requested image
+	struct RENDER_REQUEST
+	{
+		int client;
+		std::string id;
+		int width;
+		int height;
+		glm::vec3 position;
+		glm::vec3 target;
+		float fov;
+		bool bPNG;
+		std::chrono::steady_clock::time_point received;
+	};
+
+	// handle of a socket on this platform
+#ifdef _WIN32
+	typedef uintptr_t SOCKET_HANDLE;
+#else
+	typedef int SOCKET_HANDLE;
+#endif
+
+	// properties for a connected client
+	struct SERVER_CLIENT
+	{
+		int id;
+		SOCKET_HANDLE handle;
+		std::string input;
+		// replies not yet taken by the socket, from the first
+		// unsent byte on
+		std::string output;
+		size_t outputSent;
+		bool bClosed;
+	};
+
+	// properties for a reusable framebuffer object of one size
+	struct RENDER_TARGET
+	{
+		int width;
+		int height;
+		unsigned int framebuffer;
+		unsigned int renderbuffers[2];
+		int lastBatch;
+	};
+
+	// the scene kept loaded between requests
+	SceneManager* m_pSceneManager;
+	SoftwareRasterizer* m_pRasterizer;
+	// listening socket and the connected clients
+	SOCKET_HANDLE m_listenHandle;
+	std::string m_socketPath;
+	std::vector<SERVER_CLIENT> m_clients;
+	int m_nextClientID;
+	// requests waiting for the next batch
+	std::vector<RENDER_REQUEST> m_queue;
+	int m_maxBatchSize;
+	bool m_bShutdown;
+	// whether the socket library was started and must be cleaned up
+	bool m_bSocketsStarted;
+	// framebuffer objects kept for the sizes rendered recently
+	std::vector<RENDER_TARGET> m_targets;
+	// counters and recent latencies for the stats
+	SERVER_STATS m_stats;
+	double m_totalRenderMilliseconds;
+	double m_totalLatencyMilliseconds;
+	std::vector<double> m_recentLatencies;
+	int m_nextLatency;
+
+	// accept clients and read their requests
+	bool PollClients(int timeoutMilliseconds);
+	// handle one complete request line from a client
+	void HandleLine(int client, const std::string& line);
+	// render the queued requests and send the images
+	void RenderBatch();
+	// render one request into top-down RGBA pixels
+	bool RenderImage(const RENDER_REQUEST& request, std::vector<unsigned char>& pixels);
+	// get a framebuffer object of the passed in size
+	RENDER_TARGET* GetRenderTarget(int width, int height);
+	// find a connected client by its id
+	SERVER_CLIENT* FindClient(int client);
+	// queue bytes for a client and send what its socket takes
+	void SendToClient(int client, const char* data, size_t size);
+	// send queued bytes until the socket of a client is full,
+	// marking it closed on failure
+	void FlushClient(SERVER_CLIENT& client);
+	// check whether any client has replies waiting to be sent
+	bool HasPendingOutput() const;
+	// record the latency of an answered request
+	void AddLatency(double milliseconds);
+	// close the sockets and free the framebuffer objects
+	void Close();
+
+public:
+	// set the most requests rendered in one batch
+	void SetMaxBatchSize(int maxBatchSize);
+	// listen on a socket path and serve until shut down
+	bool Run(const char* socketPath);
+	// get the load and latency of the server
+	SERVER_STATS GetStats() const;
+};
@@ -0,0 +1,1355 @@
+///////////////////////////////////////////////////////////////////////////////
+// sceneentities.cpp
+// ============
+// store scene objects as entities in archetype chunks of packed columns
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneEntities.h"
+#include "PrimitiveGeometry.h"
+
+#include <algorithm>
+#include <cmath>
+
+const SceneEntities::ENTITY_ID SceneEntities::INVALID_ENTITY;
+const int SceneEntities::CHUNK_CAPACITY;
+
+// declaration of global variables and defines
+namespace
+{
+	// bits of an entity handle that hold its slot, where the
+	// rest hold the generation of the slot
+	const int g_SlotBits = 22;
+	const uint32_t g_SlotMask = (1u << g_SlotBits) - 1;
+	const uint32_t g_GenerationMask = (1u << (32 - g_SlotBits)) - 1;
+	const float g_DegreesToRadians = 3.14159265358979f / 180.0f;
+
+	// allocate a column for every entity of a chunk
+	template <typename T>
+	void AllocateColumn(std::vector<T>& column)
+	{
+		column.resize(SceneEntities::CHUNK_CAPACITY);
+	}
+
+	// copy one value of a column between rows, when the
+	// archetype has that column
+	template <typename T>
+	void CopyValue(std::vector<T>& toColumn, int toRow, const std::vector<T>& fromColumn, int fromRow)
+	{
+		if (fromColumn.empty() == false)
+		{
+			toColumn[toRow] = fromColumn[fromRow];
+		}
+	}
+}
+
+/***********************************************************
+ *  SceneEntities()
+ *
+ *  The constructor for the class.  The mesh bounds are taken
+ *  from the same geometry the renderers draw.
+ ***********************************************************/
+SceneEntities::SceneEntities()
+{
+	PrimitiveGeometry geometry;
+	for (int mesh = 0; mesh < SceneManager::MESH_TYPE_COUNT; mesh++)
+	{
+		geometry.GetMeshBounds((SceneManager::MESH_TYPE)mesh, m_meshMinimum[mesh], m_meshMaximum[mesh]);
+	}
+
+	m_bCompactTransforms = false;
+
+	m_stats.entities = 0;
+	m_stats.archetypes = 0;
+	m_stats.chunks = 0;
+	m_stats.visibleEntities = 0;
+	m_stats.updatedChunks = 0;
+	m_stats.prefabs = 0;
+	m_stats.prefabParts = 0;
+}
+
+/***********************************************************
+ *  GetArchetypeIndex()
+ *
+ *  This method is used for finding the archetype with the
+ *  passed in set of components, adding it when there is none.
+ ***********************************************************/
+int SceneEntities::GetArchetypeIndex(unsigned int components)
+{
+	for (size_t i = 0; i < m_archetypes.size(); i++)
+	{
+		if (m_archetypes[i].components == components)
+		{
+			return((int)i);
+		}
+	}
+
+	ENTITY_ARCHETYPE archetype;
+	archetype.components = components;
+	m_archetypes.push_back(archetype);
+	m_stats.archetypes++;
+	return((int)m_archetypes.size() - 1);
+}
+
+/***********************************************************
+ *  AddChunk()
+ *
+ *  This method is used for adding an empty chunk to an
+ *  archetype.  Only the columns of the archetype's components
+ *  are allocated, each one with room for a full chunk.
+ ***********************************************************/
+void SceneEntities::AddChunk(ENTITY_ARCHETYPE& archetype)
+{
+	archetype.chunks.push_back(ENTITY_CHUNK());
+	ENTITY_CHUNK& chunk = archetype.chunks.back();
+	chunk.count = 0;
+	chunk.bDirty = false;
+	AllocateColumn(chunk.entities);
+	AllocateColumn(chunk.flags);
+
+	if (((archetype.components & COMPONENT_TRANSFORM) != 0) && (m_bCompactTransforms == true))
+	{
+		AllocateColumn(chunk.packed);
+	}
+	else if ((archetype.components & COMPONENT_TRANSFORM) != 0)
+	{
+		AllocateColumn(chunk.positionX);
+		AllocateColumn(chunk.positionY);
+		AllocateColumn(chunk.positionZ);
+		AllocateColumn(chunk.rotationX);
+		AllocateColumn(chunk.rotationY);
+		AllocateColumn(chunk.rotationZ);
+		AllocateColumn(chunk.scaleX);
+		AllocateColumn(chunk.scaleY);
+		AllocateColumn(chunk.scaleZ);
+		AllocateColumn(chunk.world);
+	}
+	if ((archetype.components & COMPONENT_MESH) != 0)
+	{
+		AllocateColumn(chunk.mesh);
+		AllocateColumn(chunk.parts);
+	}
+	if ((archetype.components & COMPONENT_MATERIAL) != 0)
+	{
+		AllocateColumn(chunk.color);
+		AllocateColumn(chunk.materialIndex);
+	}
+	if ((archetype.components & COMPONENT_TEXTURE) != 0)
+	{
+		AllocateColumn(chunk.textureSlot);
+		AllocateColumn(chunk.uvScale);
+		AllocateColumn(chunk.samplerFilter);
+		AllocateColumn(chunk.samplerWrap);
+	}
+	if ((archetype.components & COMPONENT_BOUNDS) != 0)
+	{
+		AllocateColumn(chunk.minimumX);
+		AllocateColumn(chunk.minimumY);
+		AllocateColumn(chunk.minimumZ);
+		AllocateColumn(chunk.maximumX);
+		AllocateColumn(chunk.maximumY);
+		AllocateColumn(chunk.maximumZ);
+	}
+	if ((archetype.components & COMPONENT_PREFAB) != 0)
+	{
+		AllocateColumn(chunk.prefab);
+	}
+	m_stats.chunks++;
+}
+
+/***********************************************************
+ *  MoveRow()
+ *
+ *  This method is used for copying every column of an entity
+ *  from one row of an archetype to another.
+ ***********************************************************/
+void SceneEntities::MoveRow(ENTITY_ARCHETYPE& archetype, int fromChunk, int fromRow, int toChunk, int toRow)
+{
+	ENTITY_CHUNK& from = archetype.chunks[fromChunk];
+	ENTITY_CHUNK& to = archetype.chunks[toChunk];
+
+	CopyValue(to.entities, toRow, from.entities, fromRow);
+	CopyValue(to.flags, toRow, from.flags, fromRow);
+	CopyValue(to.positionX, toRow, from.positionX, fromRow);
+	CopyValue(to.positionY, toRow, from.positionY, fromRow);
+	CopyValue(to.positionZ, toRow, from.positionZ, fromRow);
+	CopyValue(to.rotationX, toRow, from.rotationX, fromRow);
+	CopyValue(to.rotationY, toRow, from.rotationY, fromRow);
+	CopyValue(to.rotationZ, toRow, from.rotationZ, fromRow);
+	CopyValue(to.scaleX, toRow, from.scaleX, fromRow);
+	CopyValue(to.scaleY, toRow, from.scaleY, fromRow);
+	CopyValue(to.scaleZ, toRow, from.scaleZ, fromRow);
+	CopyValue(to.world, toRow, from.world, fromRow);
+	CopyValue(to.packed, toRow, from.packed, fromRow);
+	CopyValue(to.mesh, toRow, from.mesh, fromRow);
+	CopyValue(to.parts, toRow, from.parts, fromRow);
+	CopyValue(to.color, toRow, from.color, fromRow);
+	CopyValue(to.materialIndex, toRow, from.materialIndex, fromRow);
+	CopyValue(to.textureSlot, toRow, from.textureSlot, fromRow);
+	CopyValue(to.uvScale, toRow, from.uvScale, fromRow);
+	CopyValue(to.samplerFilter, toRow, from.samplerFilter, fromRow);
+	CopyValue(to.samplerWrap, toRow, from.samplerWrap, fromRow);
+	CopyValue(to.minimumX, toRow, from.minimumX, fromRow);
+	CopyValue(to.minimumY, toRow, from.minimumY, fromRow);
+	CopyValue(to.minimumZ, toRow, from.minimumZ, fromRow);
+	CopyValue(to.maximumX, toRow, from.maximumX, fromRow);
+	CopyValue(to.maximumY, toRow, from.maximumY, fromRow);
+	CopyValue(to.maximumZ, toRow, from.maximumZ, fromRow);
+	CopyValue(to.prefab, toRow, from.prefab, fromRow);
+
+	// a moved entity whose transform is not updated yet keeps
+	// its new chunk out of date as well
+	to.bDirty = to.bDirty || from.bDirty;
+}
+
+/***********************************************************
+ *  FindRecord()
+ *
+ *  This method is used for getting where a live entity is
+ *  stored, or NULL when the handle is out of date.
+ ***********************************************************/
+SceneEntities::ENTITY_RECORD* SceneEntities::FindRecord(ENTITY_ID entity)
+{
+	uint32_t slot = entity & g_SlotMask;
+	if ((entity == INVALID_ENTITY) || (slot >= m_records.size()))
+	{
+		return(NULL);
+	}
+
+	ENTITY_RECORD& record = m_records[slot];
+	if ((record.bAlive == false) || (record.generation != (entity >> g_SlotBits)))
+	{
+		return(NULL);
+	}
+	return(&record);
+}
+
+const SceneEntities::ENTITY_RECORD* SceneEntities::FindRecord(ENTITY_ID entity) const
+{
+	return(const_cast<SceneEntities*>(this)->FindRecord(entity));
+}
+
+/***********************************************************
+ *  AddEntity()
+ *
+ *  This method is used for adding a row for a new entity to
+ *  the last chunk of the archetype with the passed in set of
+ *  components.  The caller fills in the component columns.
+ ***********************************************************/
+SceneEntities::ENTITY_ID SceneEntities::AddEntity(unsigned int components, ENTITY_CHUNK*& pChunk, int& row)
+{
+	// use the slot of a destroyed entity before adding one
+	uint32_t slot = 0;
+	if (m_freeSlots.empty() == false)
+	{
+		slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+	else
+	{
+		if (m_records.size() >= g_SlotMask)
+		{
+			return(INVALID_ENTITY);
+		}
+		slot = (uint32_t)m_records.size();
+		ENTITY_RECORD record;
+		record.generation = 0;
+		record.bAlive = false;
+		m_records.push_back(record);
+	}
+
+	int archetypeIndex = GetArchetypeIndex(components);
+	ENTITY_ARCHETYPE& archetype = m_archetypes[archetypeIndex];
+	if ((archetype.chunks.empty() == true) || (archetype.chunks.back().count == CHUNK_CAPACITY))
+	{
+		AddChunk(archetype);
+	}
+	pChunk = &archetype.chunks.back();
+	row = pChunk->count++;
+
+	ENTITY_RECORD& record = m_records[slot];
+	record.archetype = archetypeIndex;
+	record.chunk = (int)archetype.chunks.size() - 1;
+	record.row = row;
+	record.bAlive = true;
+	ENTITY_ID entity = (record.generation << g_SlotBits) | slot;
+
+	pChunk->entities[row] = entity;
+	pChunk->flags[row] = FLAG_VISIBLE;
+	pChunk->bDirty = true;
+	m_stats.entities++;
+	return(entity);
+}
+
+/***********************************************************
+ *  CreateEntity()
+ *
+ *  This method is used for creating an entity from the
+ *  passed in description.  Every entity has a transform,
+ *  mesh, material and bounds, while only textured ones get
+ *  the texture component, so the two kinds are kept in
+ *  separate archetypes.
+ ***********************************************************/
+SceneEntities::ENTITY_ID SceneEntities::CreateEntity(const ENTITY_DESC& desc)
+{
+	unsigned int components = COMPONENT_TRANSFORM | COMPONENT_MESH | COMPONENT_MATERIAL | COMPONENT_BOUNDS;
+	if (desc.bUseTexture == true)
+	{
+		components |= COMPONENT_TEXTURE;
+	}
+
+	ENTITY_CHUNK* pChunk = NULL;
+	int row = 0;
+	ENTITY_ID entity = AddEntity(components, pChunk, row);
+	if (INVALID_ENTITY == entity)
+	{
+		return(INVALID_ENTITY);
+	}
+
+	ENTITY_CHUNK& chunk = *pChunk;
+	if ((desc.bUseTexture == false) && (desc.color.a < 1.0f))
+	{
+		chunk.flags[row] |= FLAG_TRANSPARENT;
+	}
+	StoreTransform(chunk, row, desc.position, desc.rotation, desc.scale);
+	chunk.mesh[row] = (uint8_t)desc.mesh;
+	chunk.parts[row] = (uint8_t)desc.parts;
+	chunk.color[row] = desc.color;
+	chunk.materialIndex[row] = (int16_t)desc.materialIndex;
+	if (desc.bUseTexture == true)
+	{
+		chunk.textureSlot[row] = (int16_t)desc.textureSlot;
+		chunk.uvScale[row] = desc.uvScale;
+		chunk.samplerFilter[row] = (uint8_t)desc.samplerFilter;
+		chunk.samplerWrap[row] = (uint8_t)desc.samplerWrap;
+	}
+	return(entity);
+}
+
+/***********************************************************
+ *  DestroyEntity()
+ *
+ *  This method is used for destroying an entity.  The last
+ *  entity of the archetype is moved into its row so the
+ *  chunks stay packed, and the slot's generation changes so
+ *  old handles to it no longer match.
+ ***********************************************************/
+bool SceneEntities::DestroyEntity(ENTITY_ID entity)
+{
+	ENTITY_RECORD* pRecord = FindRecord(entity);
+	if (NULL == pRecord)
+	{
+		return(false);
+	}
+
+	ENTITY_ARCHETYPE& archetype = m_archetypes[pRecord->archetype];
+	int lastChunk = (int)archetype.chunks.size() - 1;
+	int lastRow = archetype.chunks[lastChunk].count - 1;
+	if ((pRecord->chunk != lastChunk) || (pRecord->row != lastRow))
+	{
+		MoveRow(archetype, lastChunk, lastRow, pRecord->chunk, pRecord->row);
+		ENTITY_ID moved = archetype.chunks[pRecord->chunk].entities[pRecord->row];
+		ENTITY_RECORD& movedRecord = m_records[moved & g_SlotMask];
+		movedRecord.chunk = pRecord->chunk;
+		movedRecord.row = pRecord->row;
+	}
+
+	archetype.chunks[lastChunk].count--;
+	if (archetype.chunks[lastChunk].count == 0)
+	{
+		archetype.chunks.pop_back();
+		m_stats.chunks--;
+	}
+
+	pRecord->bAlive = false;
+	pRecord->generation = (pRecord->generation + 1) & g_GenerationMask;
+	m_freeSlots.push_back(entity & g_SlotMask);
+	m_stats.entities--;
+	return(true);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for destroying every entity and the
+ *  prefabs they were placed from.  The archetypes are kept,
+ *  but their chunks are freed.
+ ***********************************************************/
+void SceneEntities::Clear()
+{
+	for (size_t i = 0; i < m_archetypes.size(); i++)
+	{
+		m_archetypes[i].chunks.clear();
+	}
+	m_freeSlots.clear();
+	for (size_t slot = 0; slot < m_records.size(); slot++)
+	{
+		if (m_records[slot].bAlive == true)
+		{
+			m_records[slot].bAlive = false;
+			m_records[slot].generation = (m_records[slot].generation + 1) & g_GenerationMask;
+		}
+		m_freeSlots.push_back((uint32_t)slot);
+	}
+
+	m_prefabs.clear();
+	m_prefabParts.clear();
+
+	// the shared scales of the removed transforms are no
+	// longer used
+	float cellSize = m_quantizer.GetCellSize();
+	m_quantizer = TransformQuantizer();
+	m_quantizer.SetCellSize(cellSize);
+
+	m_stats.entities = 0;
+	m_stats.chunks = 0;
+	m_stats.visibleEntities = 0;
+	m_stats.prefabs = 0;
+	m_stats.prefabParts = 0;
+}
+
+/***********************************************************
+ *  DefinePrefab()
+ *
+ *  This method is used for defining a prefab from parts
+ *  placed in its own local space.  The parts are stored once
+ *  and shared by every instance, and the box around them is
+ *  kept for culling the instances.
+ ***********************************************************/
+int SceneEntities::DefinePrefab(const std::string& name, const std::vector<PREFAB_PART>& parts)
+{
+	if ((parts.empty() == true) || (m_prefabs.size() >= 0xFFFF) || (FindPrefab(name) >= 0))
+	{
+		return(-1);
+	}
+
+	PREFAB_DEFINITION prefab;
+	prefab.name = name;
+	prefab.firstPart = (int)m_prefabParts.size();
+	prefab.partCount = (int)parts.size();
+	prefab.minimum = glm::vec3(1.0e30f);
+	prefab.maximum = glm::vec3(-1.0e30f);
+	prefab.bImpostor = false;
+	for (size_t i = 0; i < parts.size(); i++)
+	{
+		const glm::mat4& local = parts[i].local;
+		glm::vec3 center = (m_meshMinimum[parts[i].mesh] + m_meshMaximum[parts[i].mesh]) * 0.5f;
+		glm::vec3 extent = (m_meshMaximum[parts[i].mesh] - m_meshMinimum[parts[i].mesh]) * 0.5f;
+		glm::vec3 partCenter = glm::vec3(local * glm::vec4(center, 1.0f));
+		glm::vec3 partExtent =
+			glm::abs(glm::vec3(local[0])) * extent.x +
+			glm::abs(glm::vec3(local[1])) * extent.y +
+			glm::abs(glm::vec3(local[2])) * extent.z;
+		prefab.minimum = glm::min(prefab.minimum, partCenter - partExtent);
+		prefab.maximum = glm::max(prefab.maximum, partCenter + partExtent);
+		m_prefabParts.push_back(parts[i]);
+	}
+	m_prefabs.push_back(prefab);
+
+	m_stats.prefabs++;
+	m_stats.prefabParts += prefab.partCount;
+	return((int)m_prefabs.size() - 1);
+}
+
+/***********************************************************
+ *  FindPrefab()
+ *
+ *  This method is used for finding a prefab by its name.
+ ***********************************************************/
+int SceneEntities::FindPrefab(const std::string& name) const
+{
+	for (size_t i = 0; i < m_prefabs.size(); i++)
+	{
+		if (m_prefabs[i].name.compare(name) == 0)
+		{
+			return((int)i);
+		}
+	}
+	return(-1);
+}
+
+/***********************************************************
+ *  InstantiatePrefab()
+ *
+ *  This method is used for placing an instance of a prefab.
+ *  The instance is one entity with the root transform, and
+ *  only instances that override the material of their parts
+ *  get the material component.
+ ***********************************************************/
+SceneEntities::ENTITY_ID SceneEntities::InstantiatePrefab(int prefab, const PREFAB_INSTANCE& instance)
+{
+	if ((prefab < 0) || (prefab >= (int)m_prefabs.size()))
+	{
+		return(INVALID_ENTITY);
+	}
+
+	bool bOverride = (instance.materialOverride >= 0) || (instance.bColorOverride == true);
+	unsigned int components = COMPONENT_TRANSFORM | COMPONENT_PREFAB | COMPONENT_BOUNDS;
+	if (bOverride == true)
+	{
+		components |= COMPONENT_MATERIAL;
+	}
+
+	ENTITY_CHUNK* pChunk = NULL;
+	int row = 0;
+	ENTITY_ID entity = AddEntity(components, pChunk, row);
+	if (INVALID_ENTITY == entity)
+	{
+		return(INVALID_ENTITY);
+	}
+
+	ENTITY_CHUNK& chunk = *pChunk;
+	StoreTransform(chunk, row, instance.position, instance.rotation, instance.scale);
+	chunk.prefab[row] = (uint16_t)prefab;
+	if (bOverride == true)
+	{
+		chunk.materialIndex[row] = (int16_t)instance.materialOverride;
+		chunk.color[row] = instance.colorOverride;
+		if (instance.bColorOverride == true)
+		{
+			chunk.flags[row] |= FLAG_COLOR_OVERRIDE;
+		}
+	}
+	return(entity);
+}
+
+/***********************************************************
+ *  GetPrefabCount()
+ *
+ *  This method is used for getting the number of prefabs.
+ ***********************************************************/
+int SceneEntities::GetPrefabCount() const
+{
+	return((int)m_prefabs.size());
+}
+
+/***********************************************************
+ *  GetPrefabParts()
+ *
+ *  This method is used for getting the parts of a prefab in
+ *  its own local space, such as for baking its impostor.
+ *  The list is replaced.
+ ***********************************************************/
+bool SceneEntities::GetPrefabParts(int prefab, std::vector<PREFAB_PART>& parts) const
+{
+	parts.clear();
+	if ((prefab < 0) || (prefab >= (int)m_prefabs.size()))
+	{
+		return(false);
+	}
+
+	const PREFAB_DEFINITION& definition = m_prefabs[prefab];
+	parts.assign(
+		m_prefabParts.begin() + definition.firstPart,
+		m_prefabParts.begin() + definition.firstPart + definition.partCount);
+	return(true);
+}
+
+/***********************************************************
+ *  GetPrefabBounds()
+ *
+ *  This method is used for getting the box around the parts
+ *  of a prefab in its own local space.
+ ***********************************************************/
+bool SceneEntities::GetPrefabBounds(int prefab, glm::vec3& minimum, glm::vec3& maximum) const
+{
+	if ((prefab < 0) || (prefab >= (int)m_prefabs.size()))
+	{
+		return(false);
+	}
+
+	minimum = m_prefabs[prefab].minimum;
+	maximum = m_prefabs[prefab].maximum;
+	return(true);
+}
+
+/***********************************************************
+ *  SetPrefabImpostor()
+ *
+ *  This method is used for letting the far instances of a
+ *  prefab be drawn as an impostor, once one is baked for it.
+ ***********************************************************/
+void SceneEntities::SetPrefabImpostor(int prefab, bool bImpostor)
+{
+	if ((prefab >= 0) && (prefab < (int)m_prefabs.size()))
+	{
+		m_prefabs[prefab].bImpostor = bImpostor;
+	}
+}
+
+/***********************************************************
+ *  IsAlive()
+ *
+ *  This method is used for checking whether a handle still
+ *  names an entity that was not destroyed.
+ ***********************************************************/
+bool SceneEntities::IsAlive(ENTITY_ID entity) const
+{
+	return(NULL != FindRecord(entity));
+}
+
+/***********************************************************
+ *  SetCompactTransforms()
+ *
+ *  This method is used for choosing whether the transforms
+ *  are kept as 16 bytes of packed values instead of 100 bytes
+ *  of floats and world matrix.  Packed positions lose
+ *  precision further from the origin as the cell size grows,
+ *  and the layout can only change while the store is empty.
+ ***********************************************************/
+bool SceneEntities::SetCompactTransforms(bool bCompact, float cellSize)
+{
+	if (m_stats.entities > 0)
+	{
+		return(false);
+	}
+
+	for (size_t i = 0; i < m_archetypes.size(); i++)
+	{
+		m_archetypes[i].chunks.clear();
+	}
+	m_stats.chunks = 0;
+	m_bCompactTransforms = bCompact;
+	m_quantizer = TransformQuantizer();
+	m_quantizer.SetCellSize(cellSize);
+	return(true);
+}
+
+/***********************************************************
+ *  GetTransformSize()
+ *
+ *  This method is used for getting the bytes of the
+ *  transform columns each entity takes.
+ ***********************************************************/
+int SceneEntities::GetTransformSize() const
+{
+	if (m_bCompactTransforms == true)
+	{
+		return((int)sizeof(TransformQuantizer::PACKED_TRANSFORM));
+	}
+	return((int)(9 * sizeof(float) + sizeof(glm::mat4)));
+}
+
+/***********************************************************
+ *  StoreTransform()
+ *
+ *  This method is used for storing the position, rotation in
+ *  degrees and scale of one row, either in the float columns
+ *  or packed.
+ ***********************************************************/
+void SceneEntities::StoreTransform(ENTITY_CHUNK& chunk, int row, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale)
+{
+	if (m_bCompactTransforms == true)
+	{
+		chunk.packed[row] = m_quantizer.Encode(position, TransformQuantizer::GetEulerRotation(rotation), scale);
+		return;
+	}
+
+	chunk.positionX[row] = position.x;
+	chunk.positionY[row] = position.y;
+	chunk.positionZ[row] = position.z;
+	chunk.rotationX[row] = rotation.x;
+	chunk.rotationY[row] = rotation.y;
+	chunk.rotationZ[row] = rotation.z;
+	chunk.scaleX[row] = scale.x;
+	chunk.scaleY[row] = scale.y;
+	chunk.scaleZ[row] = scale.z;
+}
+
+/***********************************************************
+ *  GetWorldMatrix()
+ *
+ *  This method is used for getting the world matrix of one
+ *  row, unpacking it when the transforms are compact.
+ ***********************************************************/
+glm::mat4 SceneEntities::GetWorldMatrix(const ENTITY_CHUNK& chunk, int row) const
+{
+	if (m_bCompactTransforms == true)
+	{
+		return(m_quantizer.DecodeMatrix(chunk.packed[row]));
+	}
+	return(chunk.world[row]);
+}
+
+/***********************************************************
+ *  SetTransform()
+ *
+ *  This method is used for moving, turning and scaling an
+ *  entity.  Its world matrix and bounds are recomputed with
+ *  the rest of its chunk by the next UpdateTransforms().
+ ***********************************************************/
+bool SceneEntities::SetTransform(ENTITY_ID entity, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale)
+{
+	ENTITY_RECORD* pRecord = FindRecord(entity);
+	if ((NULL == pRecord) ||
+		((m_archetypes[pRecord->archetype].components & COMPONENT_TRANSFORM) == 0))
+	{
+		return(false);
+	}
+
+	ENTITY_CHUNK& chunk = m_archetypes[pRecord->archetype].chunks[pRecord->chunk];
+	StoreTransform(chunk, pRecord->row, position, rotation, scale);
+	chunk.bDirty = true;
+	return(true);
+}
+
+/***********************************************************
+ *  GetTransform()
+ *
+ *  This method is used for getting the position, rotation in
+ *  degrees and scale of an entity.  A compact transform is
+ *  unpacked and its rotation turned back into angles around
+ *  the X, Y and Z axes, so it is only as exact as the packed
+ *  values.
+ ***********************************************************/
+bool SceneEntities::GetTransform(ENTITY_ID entity, glm::vec3& position, glm::vec3& rotation, glm::vec3& scale) const
+{
+	const ENTITY_RECORD* pRecord = FindRecord(entity);
+	if ((NULL == pRecord) ||
+		((m_archetypes[pRecord->archetype].components & COMPONENT_TRANSFORM) == 0))
+	{
+		return(false);
+	}
+
+	const ENTITY_CHUNK& chunk = m_archetypes[pRecord->archetype].chunks[pRecord->chunk];
+	int row = pRecord->row;
+	if (m_bCompactTransforms == false)
+	{
+		position = glm::vec3(chunk.positionX[row], chunk.positionY[row], chunk.positionZ[row]);
+		rotation = glm::vec3(chunk.rotationX[row], chunk.rotationY[row], chunk.rotationZ[row]);
+		scale = glm::vec3(chunk.scaleX[row], chunk.scaleY[row], chunk.scaleZ[row]);
+		return(true);
+	}
+
+	// the rotation around X, then Y, then Z has sin(Y) as the
+	// first part of its Z axis, and the other two angles in
+	// the rest of that axis and the first row
+	glm::quat orientation;
+	m_quantizer.Decode(chunk.packed[row], position, orientation, scale);
+	glm::mat3 turn = glm::mat3_cast(orientation);
+	float sy = std::min(std::max(turn[2][0], -1.0f), 1.0f);
+	rotation.x = std::atan2(-turn[2][1], turn[2][2]) / g_DegreesToRadians;
+	rotation.y = std::asin(sy) / g_DegreesToRadians;
+	rotation.z = std::atan2(-turn[1][0], turn[0][0]) / g_DegreesToRadians;
+	return(true);
+}
+
+/***********************************************************
+ *  SetColor()
+ *
+ *  This method is used for setting the color of an entity
+ *  with the material component.  A mesh entity without a
+ *  texture is drawn with the transparent ones while its alpha
+ *  is below one, and a prefab instance uses the color for
+ *  all of its parts.
+ ***********************************************************/
+bool SceneEntities::SetColor(ENTITY_ID entity, const glm::vec4& color)
+{
+	ENTITY_RECORD* pRecord = FindRecord(entity);
+	if ((NULL == pRecord) ||
+		((m_archetypes[pRecord->archetype].components & COMPONENT_MATERIAL) == 0))
+	{
+		return(false);
+	}
+
+	unsigned int components = m_archetypes[pRecord->archetype].components;
+	ENTITY_CHUNK& chunk = m_archetypes[pRecord->archetype].chunks[pRecord->chunk];
+	int row = pRecord->row;
+	chunk.color[row] = color;
+	if ((components & COMPONENT_PREFAB) != 0)
+	{
+		chunk.flags[row] |= FLAG_COLOR_OVERRIDE;
+	}
+	else if ((components & COMPONENT_TEXTURE) == 0)
+	{
+		chunk.flags[row] = (uint8_t)((chunk.flags[row] & ~FLAG_TRANSPARENT) | ((color.a < 1.0f) ? FLAG_TRANSPARENT : 0));
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  GetColor()
+ *
+ *  This method is used for getting the color of an entity
+ *  with the material component.
+ ***********************************************************/
+bool SceneEntities::GetColor(ENTITY_ID entity, glm::vec4& color) const
+{
+	const ENTITY_RECORD* pRecord = FindRecord(entity);
+	if ((NULL == pRecord) ||
+		((m_archetypes[pRecord->archetype].components & COMPONENT_MATERIAL) == 0))
+	{
+		return(false);
+	}
+
+	color = m_archetypes[pRecord->archetype].chunks[pRecord->chunk].color[pRecord->row];
+	return(true);
+}
+
+/***********************************************************
+ *  GetBounds()
+ *
+ *  This method is used for getting the world box around an
+ *  entity's mesh as of the last UpdateTransforms().
+ ***********************************************************/
+bool SceneEntities::GetBounds(ENTITY_ID entity, glm::vec3& minimum, glm::vec3& maximum) const
+{
+	const ENTITY_RECORD* pRecord = FindRecord(entity);
+	if ((NULL == pRecord) ||
+		((m_archetypes[pRecord->archetype].components & COMPONENT_BOUNDS) == 0))
+	{
+		return(false);
+	}
+
+	const ENTITY_CHUNK& chunk = m_archetypes[pRecord->archetype].chunks[pRecord->chunk];
+	int row = pRecord->row;
+	minimum = glm::vec3(chunk.minimumX[row], chunk.minimumY[row], chunk.minimumZ[row]);
+	maximum = glm::vec3(chunk.maximumX[row], chunk.maximumY[row], chunk.maximumZ[row]);
+	return(true);
+}
+
+/***********************************************************
+ *  GetMeshes()
+ *
+ *  This method is used for getting the meshes an entity
+ *  draws with their world matrices, such as for testing a
+ *  ray against its triangles.  The list is replaced, and a
+ *  prefab instance gives one mesh for each of its parts.
+ ***********************************************************/
+bool SceneEntities::GetMeshes(ENTITY_ID entity, std::vector<ENTITY_MESH>& meshes) const
+{
+	meshes.clear();
+	const ENTITY_RECORD* pRecord = FindRecord(entity);
+	if (NULL == pRecord)
+	{
+		return(false);
+	}
+
+	unsigned int components = m_archetypes[pRecord->archetype].components;
+	if ((components & COMPONENT_TRANSFORM) == 0)
+	{
+		return(false);
+	}
+
+	const ENTITY_CHUNK& chunk = m_archetypes[pRecord->archetype].chunks[pRecord->chunk];
+	int row = pRecord->row;
+	ENTITY_MESH mesh;
+	if ((components & COMPONENT_MESH) != 0)
+	{
+		mesh.mesh = (SceneManager::MESH_TYPE)chunk.mesh[row];
+		mesh.parts = chunk.parts[row];
+		mesh.model = GetWorldMatrix(chunk, row);
+		meshes.push_back(mesh);
+	}
+	else if ((components & COMPONENT_PREFAB) != 0)
+	{
+		const PREFAB_DEFINITION& prefab = m_prefabs[chunk.prefab[row]];
+		glm::mat4 world = GetWorldMatrix(chunk, row);
+		for (int p = prefab.firstPart; p < prefab.firstPart + prefab.partCount; p++)
+		{
+			mesh.mesh = m_prefabParts[p].mesh;
+			mesh.parts = m_prefabParts[p].parts;
+			mesh.model = world * m_prefabParts[p].local;
+			meshes.push_back(mesh);
+		}
+	}
+	return(meshes.empty() == false);
+}
+
+/***********************************************************
+ *  GetPrefabName()
+ *
+ *  This method is used for getting the name of the prefab an
+ *  entity places, or an empty name when it is not a prefab
+ *  instance.
+ ***********************************************************/
+std::string SceneEntities::GetPrefabName(ENTITY_ID entity) const
+{
+	const ENTITY_RECORD* pRecord = FindRecord(entity);
+	if ((NULL == pRecord) ||
+		((m_archetypes[pRecord->archetype].components & COMPONENT_PREFAB) == 0))
+	{
+		return(std::string());
+	}
+
+	const ENTITY_CHUNK& chunk = m_archetypes[pRecord->archetype].chunks[pRecord->chunk];
+	return(m_prefabs[chunk.prefab[pRecord->row]].name);
+}
+
+/***********************************************************
+ *  UpdateTransforms()
+ *
+ *  This method is used for the transform system, which
+ *  recomputes the world matrices and bounds of every chunk
+ *  with a changed transform.
+ ***********************************************************/
+void SceneEntities::UpdateTransforms()
+{
+	m_stats.updatedChunks = 0;
+	for (size_t i = 0; i < m_archetypes.size(); i++)
+	{
+		ENTITY_ARCHETYPE& archetype = m_archetypes[i];
+		if ((archetype.components & COMPONENT_TRANSFORM) == 0)
+		{
+			continue;
+		}
+
+		for (size_t c = 0; c < archetype.chunks.size(); c++)
+		{
+			if (archetype.chunks[c].bDirty == true)
+			{
+				UpdateChunk(archetype.chunks[c], archetype.components);
+				m_stats.updatedChunks++;
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  UpdateChunk()
+ *
+ *  This method is used for building the world matrix of each
+ *  entity of a chunk from its columns, in the same order as
+ *  the scene manager's transformations: scale, then rotate
+ *  around Z, Y and X, then translate.  The world box around
+ *  the mesh, or around all parts of a prefab instance, is
+ *  made from the center and half size of the local box, so
+ *  no corners have to be transformed.  Compact transforms
+ *  keep no world matrix, so only their bounds are updated.
+ ***********************************************************/
+void SceneEntities::UpdateChunk(ENTITY_CHUNK& chunk, unsigned int components)
+{
+	bool bPrefab = ((components & COMPONENT_PREFAB) != 0);
+	bool bBounds = ((components & COMPONENT_BOUNDS) != 0) &&
+		(((components & COMPONENT_MESH) != 0) || (bPrefab == true));
+	for (int row = 0; row < chunk.count; row++)
+	{
+		glm::vec3 axisX;
+		glm::vec3 axisY;
+		glm::vec3 axisZ;
+		glm::vec3 position;
+		if (m_bCompactTransforms == true)
+		{
+			glm::mat4 world = m_quantizer.DecodeMatrix(chunk.packed[row]);
+			axisX = glm::vec3(world[0]);
+			axisY = glm::vec3(world[1]);
+			axisZ = glm::vec3(world[2]);
+			position = glm::vec3(world[3]);
+		}
+		else
+		{
+			float sx = std::sin(chunk.rotationX[row] * g_DegreesToRadians);
+			float cx = std::cos(chunk.rotationX[row] * g_DegreesToRadians);
+			float sy = std::sin(chunk.rotationY[row] * g_DegreesToRadians);
+			float cy = std::cos(chunk.rotationY[row] * g_DegreesToRadians);
+			float sz = std::sin(chunk.rotationZ[row] * g_DegreesToRadians);
+			float cz = std::cos(chunk.rotationZ[row] * g_DegreesToRadians);
+
+			// the columns of the rotation around X, Y and Z, each
+			// scaled by the scale on its axis
+			axisX = glm::vec3(cy * cz, cx * sz + sx * sy * cz, sx * sz - cx * sy * cz) * chunk.scaleX[row];
+			axisY = glm::vec3(-cy * sz, cx * cz - sx * sy * sz, sx * cz + cx * sy * sz) * chunk.scaleY[row];
+			axisZ = glm::vec3(sy, -sx * cy, cx * cy) * chunk.scaleZ[row];
+			position = glm::vec3(chunk.positionX[row], chunk.positionY[row], chunk.positionZ[row]);
+
+			glm::mat4& world = chunk.world[row];
+			world[0] = glm::vec4(axisX, 0.0f);
+			world[1] = glm::vec4(axisY, 0.0f);
+			world[2] = glm::vec4(axisZ, 0.0f);
+			world[3] = glm::vec4(position, 1.0f);
+		}
+
+		if (bBounds == true)
+		{
+			glm::vec3 center;
+			glm::vec3 extent;
+			if (bPrefab == true)
+			{
+				const PREFAB_DEFINITION& prefab = m_prefabs[chunk.prefab[row]];
+				center = (prefab.minimum + prefab.maximum) * 0.5f;
+				extent = (prefab.maximum - prefab.minimum) * 0.5f;
+			}
+			else
+			{
+				center = (m_meshMinimum[chunk.mesh[row]] + m_meshMaximum[chunk.mesh[row]]) * 0.5f;
+				extent = (m_meshMaximum[chunk.mesh[row]] - m_meshMinimum[chunk.mesh[row]]) * 0.5f;
+			}
+
+			glm::vec3 worldCenter = position + axisX * center.x + axisY * center.y + axisZ * center.z;
+			glm::vec3 worldExtent = glm::abs(axisX) * extent.x + glm::abs(axisY) * extent.y + glm::abs(axisZ) * extent.z;
+			chunk.minimumX[row] = worldCenter.x - worldExtent.x;
+			chunk.minimumY[row] = worldCenter.y - worldExtent.y;
+			chunk.minimumZ[row] = worldCenter.z - worldExtent.z;
+			chunk.maximumX[row] = worldCenter.x + worldExtent.x;
+			chunk.maximumY[row] = worldCenter.y + worldExtent.y;
+			chunk.maximumZ[row] = worldCenter.z + worldExtent.z;
+		}
+	}
+	chunk.bDirty = false;
+}
+
+/***********************************************************
+ *  CullEntities()
+ *
+ *  This method is used for the culling system, which marks
+ *  an entity visible unless its world box is wholly outside
+ *  one of the six planes of the camera's view volume.  The
+ *  planes are taken from the rows of the view projection
+ *  matrix, and each chunk is tested straight from its bounds
+ *  columns.  Entities without bounds are always visible.
+ ***********************************************************/
+int SceneEntities::CullEntities(const glm::mat4& viewProjection)
+{
+	glm::vec4 planes[6];
+	for (int axis = 0; axis < 3; axis++)
+	{
+		glm::vec4 row = glm::vec4(viewProjection[0][axis], viewProjection[1][axis], viewProjection[2][axis], viewProjection[3][axis]);
+		glm::vec4 rowW = glm::vec4(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+		planes[axis * 2] = rowW + row;
+		planes[axis * 2 + 1] = rowW - row;
+	}
+
+	int visibleEntities = 0;
+	for (size_t i = 0; i < m_archetypes.size(); i++)
+	{
+		ENTITY_ARCHETYPE& archetype = m_archetypes[i];
+		bool bBounds = ((archetype.components & COMPONENT_BOUNDS) != 0);
+		for (size_t c = 0; c < archetype.chunks.size(); c++)
+		{
+			ENTITY_CHUNK& chunk = archetype.chunks[c];
+			for (int row = 0; row < chunk.count; row++)
+			{
+				bool bVisible = true;
+				if (bBounds == true)
+				{
+					float centerX = (chunk.minimumX[row] + chunk.maximumX[row]) * 0.5f;
+					float centerY = (chunk.minimumY[row] + chunk.maximumY[row]) * 0.5f;
+					float centerZ = (chunk.minimumZ[row] + chunk.maximumZ[row]) * 0.5f;
+					float extentX = (chunk.maximumX[row] - chunk.minimumX[row]) * 0.5f;
+					float extentY = (chunk.maximumY[row] - chunk.minimumY[row]) * 0.5f;
+					float extentZ = (chunk.maximumZ[row] - chunk.minimumZ[row]) * 0.5f;
+					for (int plane = 0; plane < 6; plane++)
+					{
+						const glm::vec4& p = planes[plane];
+						float distance = p.x * centerX + p.y * centerY + p.z * centerZ + p.w;
+						float radius = std::fabs(p.x) * extentX + std::fabs(p.y) * extentY + std::fabs(p.z) * extentZ;
+						bVisible = bVisible && (distance + radius >= 0.0f);
+					}
+				}
+
+				chunk.flags[row] = (uint8_t)((chunk.flags[row] & ~(FLAG_VISIBLE | FLAG_IMPOSTOR)) | ((bVisible == true) ? FLAG_VISIBLE : 0));
+				visibleEntities += (bVisible == true) ? 1 : 0;
+			}
+		}
+	}
+
+	m_stats.visibleEntities = visibleEntities;
+	return(visibleEntities);
+}
+
+/***********************************************************
+ *  ShowAllEntities()
+ *
+ *  This method is used for marking every entity visible, for
+ *  when there is no single camera to cull against.
+ ***********************************************************/
+void SceneEntities::ShowAllEntities()
+{
+	for (size_t i = 0; i < m_archetypes.size(); i++)
+	{
+		for (size_t c = 0; c < m_archetypes[i].chunks.size(); c++)
+		{
+			ENTITY_CHUNK& chunk = m_archetypes[i].chunks[c];
+			for (int row = 0; row < chunk.count; row++)
+			{
+				chunk.flags[row] = (uint8_t)((chunk.flags[row] & ~FLAG_IMPOSTOR) | FLAG_VISIBLE);
+			}
+		}
+	}
+	m_stats.visibleEntities = m_stats.entities;
+}
+
+/***********************************************************
+ *  SelectImpostors()
+ *
+ *  This method is used for the impostor system, which marks
+ *  the visible instances of prefabs with impostors whose
+ *  box centers are beyond a distance from the camera.  The
+ *  marks last until the entities are next culled or shown,
+ *  so this is called after that for every frame it applies
+ *  to.
+ ***********************************************************/
+int SceneEntities::SelectImpostors(const glm::vec3& viewPosition, float distance)
+{
+	float distanceSquared = distance * distance;
+	int impostors = 0;
+	for (size_t i = 0; i < m_archetypes.size(); i++)
+	{
+		ENTITY_ARCHETYPE& archetype = m_archetypes[i];
+		unsigned int required = COMPONENT_TRANSFORM | COMPONENT_PREFAB | COMPONENT_BOUNDS;
+		if ((archetype.components & required) != required)
+		{
+			continue;
+		}
+
+		for (size_t c = 0; c < archetype.chunks.size(); c++)
+		{
+			ENTITY_CHUNK& chunk = archetype.chunks[c];
+			for (int row = 0; row < chunk.count; row++)
+			{
+				bool bImpostor = false;
+				if (((chunk.flags[row] & FLAG_VISIBLE) != 0) && (m_prefabs[chunk.prefab[row]].bImpostor == true))
+				{
+					float offsetX = (chunk.minimumX[row] + chunk.maximumX[row]) * 0.5f - viewPosition.x;
+					float offsetY = (chunk.minimumY[row] + chunk.maximumY[row]) * 0.5f - viewPosition.y;
+					float offsetZ = (chunk.minimumZ[row] + chunk.maximumZ[row]) * 0.5f - viewPosition.z;
+					bImpostor = (offsetX * offsetX + offsetY * offsetY + offsetZ * offsetZ > distanceSquared);
+				}
+
+				chunk.flags[row] = (uint8_t)((chunk.flags[row] & ~FLAG_IMPOSTOR) | ((bImpostor == true) ? FLAG_IMPOSTOR : 0));
+				impostors += (bImpostor == true) ? 1 : 0;
+			}
+		}
+	}
+	return(impostors);
+}
+
+/***********************************************************
+ *  BuildDrawList()
+ *
+ *  This method is used for the draw list system, which
+ *  appends a draw for every visible entity with a transform
+ *  and mesh, followed by the parts of the visible prefab
+ *  instances.  The opaque draws come first and the
+ *  transparent ones after them, so they blend over the rest
+ *  of the scene.  Instances marked as impostors are left to
+ *  BuildImpostorDraws().
+ ***********************************************************/
+void SceneEntities::BuildDrawList(std::vector<SceneManager::DRAW_COMMAND>& draws) const
+{
+	SceneManager::DRAW_COMMAND draw;
+	draws.reserve(draws.size() + m_stats.visibleEntities);
+
+	// gather the visible instances of each prefab, so their
+	// parts can be drawn part by part across all instances
+	std::vector<std::vector<VISIBLE_INSTANCE> > instances(m_prefabs.size());
+	for (size_t i = 0; i < m_archetypes.size(); i++)
+	{
+		const ENTITY_ARCHETYPE& archetype = m_archetypes[i];
+		unsigned int required = COMPONENT_TRANSFORM | COMPONENT_PREFAB;
+		if ((archetype.components & required) != required)
+		{
+			continue;
+		}
+
+		VISIBLE_INSTANCE instance;
+		instance.bMaterial = ((archetype.components & COMPONENT_MATERIAL) != 0);
+		for (size_t c = 0; c < archetype.chunks.size(); c++)
+		{
+			instance.pChunk = &archetype.chunks[c];
+			for (int row = 0; row < instance.pChunk->count; row++)
+			{
+				if ((instance.pChunk->flags[row] & (FLAG_VISIBLE | FLAG_IMPOSTOR)) == FLAG_VISIBLE)
+				{
+					instance.row = row;
+					instances[instance.pChunk->prefab[row]].push_back(instance);
+				}
+			}
+		}
+	}
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		uint8_t passFlags = (uint8_t)(FLAG_VISIBLE | ((pass == 1) ? FLAG_TRANSPARENT : 0));
+		for (size_t i = 0; i < m_archetypes.size(); i++)
+		{
+			const ENTITY_ARCHETYPE& archetype = m_archetypes[i];
+			unsigned int required = COMPONENT_TRANSFORM | COMPONENT_MESH;
+			if ((archetype.components & required) != required)
+			{
+				continue;
+			}
+			bool bMaterial = ((archetype.components & COMPONENT_MATERIAL) != 0);
+			bool bTexture = ((archetype.components & COMPONENT_TEXTURE) != 0);
+
+			for (size_t c = 0; c < archetype.chunks.size(); c++)
+			{
+				const ENTITY_CHUNK& chunk = archetype.chunks[c];
+				for (int row = 0; row < chunk.count; row++)
+				{
+					if ((chunk.flags[row] & (FLAG_VISIBLE | FLAG_TRANSPARENT)) != passFlags)
+					{
+						continue;
+					}
+
+					draw.mesh = (SceneManager::MESH_TYPE)chunk.mesh[row];
+					draw.parts = chunk.parts[row];
+					draw.model = GetWorldMatrix(chunk, row);
+					draw.color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+					draw.materialIndex = -1;
+					if (bMaterial == true)
+					{
+						draw.color = chunk.color[row];
+						draw.materialIndex = chunk.materialIndex[row];
+					}
+					draw.bUseTexture = bTexture;
+					draw.textureSlot = -1;
+					draw.uvScale = glm::vec2(1.0f, 1.0f);
+					draw.samplerFilter = TextureSamplers::FILTER_TRILINEAR;
+					draw.samplerWrap = TextureSamplers::WRAP_REPEAT;
+					if (bTexture == true)
+					{
+						draw.textureSlot = chunk.textureSlot[row];
+						draw.uvScale = chunk.uvScale[row];
+						draw.samplerFilter = (TextureSamplers::SAMPLER_FILTER)chunk.samplerFilter[row];
+						draw.samplerWrap = (TextureSamplers::SAMPLER_WRAP)chunk.samplerWrap[row];
+					}
+					draws.push_back(draw);
+				}
+			}
+		}
+		AppendPrefabDraws(instances, (pass == 1), draws);
+	}
+}
+
+/***********************************************************
+ *  BuildImpostorDraws()
+ *
+ *  This method is used for appending a draw for each prefab
+ *  instance marked as an impostor, holding its root transform
+ *  and any material or color override.
+ ***********************************************************/
+void SceneEntities::BuildImpostorDraws(std::vector<SceneManager::IMPOSTOR_DRAW>& draws) const
+{
+	SceneManager::IMPOSTOR_DRAW draw;
+	for (size_t i = 0; i < m_archetypes.size(); i++)
+	{
+		const ENTITY_ARCHETYPE& archetype = m_archetypes[i];
+		unsigned int required = COMPONENT_TRANSFORM | COMPONENT_PREFAB;
+		if ((archetype.components & required) != required)
+		{
+			continue;
+		}
+		bool bMaterial = ((archetype.components & COMPONENT_MATERIAL) != 0);
+
+		for (size_t c = 0; c < archetype.chunks.size(); c++)
+		{
+			const ENTITY_CHUNK& chunk = archetype.chunks[c];
+			for (int row = 0; row < chunk.count; row++)
+			{
+				if ((chunk.flags[row] & (FLAG_VISIBLE | FLAG_IMPOSTOR)) != (FLAG_VISIBLE | FLAG_IMPOSTOR))
+				{
+					continue;
+				}
+
+				draw.prefab = chunk.prefab[row];
+				draw.model = GetWorldMatrix(chunk, row);
+				draw.materialOverride = -1;
+				draw.bColorOverride = false;
+				draw.colorOverride = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+				if (bMaterial == true)
+				{
+					draw.materialOverride = chunk.materialIndex[row];
+					draw.bColorOverride = ((chunk.flags[row] & FLAG_COLOR_OVERRIDE) != 0);
+					draw.colorOverride = chunk.color[row];
+				}
+				draws.push_back(draw);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  AppendPrefabDraws()
+ *
+ *  This method is used for appending the draws of the parts
+ *  of visible prefab instances.  Each part is drawn for every
+ *  instance before the next part, so draws that share a mesh,
+ *  texture and material follow one another and the render
+ *  devices skip the state changes between them.
+ ***********************************************************/
+void SceneEntities::AppendPrefabDraws(
+	const std::vector<std::vector<VISIBLE_INSTANCE> >& instances,
+	bool bTransparent,
+	std::vector<SceneManager::DRAW_COMMAND>& draws) const
+{
+	SceneManager::DRAW_COMMAND draw;
+	for (size_t prefab = 0; prefab < instances.size(); prefab++)
+	{
+		const std::vector<VISIBLE_INSTANCE>& prefabInstances = instances[prefab];
+		int firstPart = m_prefabs[prefab].firstPart;
+		int lastPart = firstPart + m_prefabs[prefab].partCount;
+		for (int p = firstPart; (p < lastPart) && (prefabInstances.empty() == false); p++)
+		{
+			const PREFAB_PART& part = m_prefabParts[p];
+			draw.mesh = part.mesh;
+			draw.parts = part.parts;
+			draw.bUseTexture = part.bUseTexture;
+			draw.textureSlot = part.textureSlot;
+			draw.uvScale = part.uvScale;
+			draw.samplerFilter = part.samplerFilter;
+			draw.samplerWrap = part.samplerWrap;
+
+			for (size_t i = 0; i < prefabInstances.size(); i++)
+			{
+				const VISIBLE_INSTANCE& instance = prefabInstances[i];
+				const ENTITY_CHUNK& chunk = *instance.pChunk;
+				draw.color = part.color;
+				draw.materialIndex = part.materialIndex;
+				if (instance.bMaterial == true)
+				{
+					if (chunk.materialIndex[instance.row] >= 0)
+					{
+						draw.materialIndex = chunk.materialIndex[instance.row];
+					}
+					if ((chunk.flags[instance.row] & FLAG_COLOR_OVERRIDE) != 0)
+					{
+						draw.color = chunk.color[instance.row];
+					}
+				}
+
+				bool bPartTransparent = (draw.bUseTexture == false) && (draw.color.a < 1.0f);
+				if (bPartTransparent != bTransparent)
+				{
+					continue;
+				}
+				draw.model = GetWorldMatrix(chunk, instance.row) * part.local;
+				draws.push_back(draw);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  GetArchetypeCount()
+ *
+ *  This method is used for getting the number of archetypes.
+ ***********************************************************/
+int SceneEntities::GetArchetypeCount() const
+{
+	return((int)m_archetypes.size());
+}
+
+/***********************************************************
+ *  GetArchetype()
+ *
+ *  This method is used for getting an archetype, so other
+ *  systems can walk the columns of its chunks.
+ ***********************************************************/
+const SceneEntities::ENTITY_ARCHETYPE& SceneEntities::GetArchetype(int index) const
+{
+	return(m_archetypes[index]);
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the size of the store and
+ *  what the last transform and culling systems did.
+ ***********************************************************/
+const SceneEntities::ENTITY_STATS& SceneEntities::GetStats() const
+{
+	return(m_stats);
+}
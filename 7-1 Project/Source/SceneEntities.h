@@ -0,0 +1,350 @@
+///////////////////////////////////////////////////////////////////////////////
+// sceneentities.h
+// ============
+// store scene objects as entities in archetype chunks of packed columns
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+#include "TransformQuantizer.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  SceneEntities
+ *
+ *  This class keeps the objects of a scene as entities made
+ *  of components.  Entities with the same set of components
+ *  share an archetype, whose entities are stored in chunks
+ *  of fixed capacity where every component value has its own
+ *  tightly packed column.  The transform, culling and draw
+ *  list systems walk those columns chunk by chunk instead of
+ *  visiting objects one at a time, so the loops stay cache
+ *  friendly and simple enough for the compiler to vectorize
+ *  across hundreds of thousands of entities.
+ *
+ *  Prefabs are assemblies of mesh draws defined once in
+ *  their own local space.  Each placed instance is a single
+ *  entity holding only its root transform, the prefab and
+ *  any material override, while the parts are shared by all
+ *  instances and expanded when the draw list is built.
+ *
+ *  For very large scenes the transforms can instead be kept
+ *  compact, as 16 bytes of quantized values per entity that
+ *  are unpacked when the bounds and draw list are built.
+ ***********************************************************/
+class SceneEntities
+{
+public:
+	// constructor
+	SceneEntities();
+
+	// handle of an entity, holding its slot and generation
+	typedef uint32_t ENTITY_ID;
+	static const ENTITY_ID INVALID_ENTITY = 0xFFFFFFFF;
+
+	// the components an entity can be made of
+	enum ENTITY_COMPONENT
+	{
+		COMPONENT_TRANSFORM = 1,
+		COMPONENT_MESH = 2,
+		COMPONENT_MATERIAL = 4,
+		COMPONENT_TEXTURE = 8,
+		COMPONENT_BOUNDS = 16,
+		COMPONENT_PREFAB = 32
+	};
+
+	// the flags kept for every entity
+	enum ENTITY_FLAG
+	{
+		FLAG_VISIBLE = 1,
+		FLAG_TRANSPARENT = 2,
+		// the instance color replaces the color of its parts
+		FLAG_COLOR_OVERRIDE = 4,
+		// the prefab instance is far enough away to be drawn as
+		// an impostor instead of its parts
+		FLAG_IMPOSTOR = 8
+	};
+
+	// properties for creating an entity, where the components
+	// are chosen from the draw it describes
+	struct ENTITY_DESC
+	{
+		SceneManager::MESH_TYPE mesh;
+		unsigned int parts;
+		glm::vec3 position;
+		// rotation around the X, Y and Z axes in degrees
+		glm::vec3 rotation;
+		glm::vec3 scale;
+		glm::vec4 color;
+		int materialIndex;
+		bool bUseTexture;
+		int textureSlot;
+		glm::vec2 uvScale;
+		TextureSamplers::SAMPLER_FILTER samplerFilter;
+		TextureSamplers::SAMPLER_WRAP samplerWrap;
+	};
+
+	// properties for one mesh draw of a prefab, in the local
+	// space of the prefab
+	struct PREFAB_PART
+	{
+		SceneManager::MESH_TYPE mesh;
+		unsigned int parts;
+		glm::mat4 local;
+		glm::vec4 color;
+		int materialIndex;
+		bool bUseTexture;
+		int textureSlot;
+		glm::vec2 uvScale;
+		TextureSamplers::SAMPLER_FILTER samplerFilter;
+		TextureSamplers::SAMPLER_WRAP samplerWrap;
+	};
+
+	// properties for placing an instance of a prefab
+	struct PREFAB_INSTANCE
+	{
+		glm::vec3 position;
+		// rotation around the X, Y and Z axes in degrees
+		glm::vec3 rotation;
+		glm::vec3 scale;
+		// material used for every part instead of its own, or -1
+		int materialOverride;
+		// color used for every part instead of its own
+		bool bColorOverride;
+		glm::vec4 colorOverride;
+	};
+
+	// properties for the columns of up to CHUNK_CAPACITY
+	// entities of one archetype, where only the columns of the
+	// archetype's components are allocated
+	struct ENTITY_CHUNK
+	{
+		int count;
+		// the transforms changed since the last update
+		bool bDirty;
+		std::vector<ENTITY_ID> entities;
+		std::vector<uint8_t> flags;
+		// transform component
+		std::vector<float> positionX;
+		std::vector<float> positionY;
+		std::vector<float> positionZ;
+		std::vector<float> rotationX;
+		std::vector<float> rotationY;
+		std::vector<float> rotationZ;
+		std::vector<float> scaleX;
+		std::vector<float> scaleY;
+		std::vector<float> scaleZ;
+		std::vector<glm::mat4> world;
+		// transform component when the transforms are compact,
+		// used instead of the columns above
+		std::vector<TransformQuantizer::PACKED_TRANSFORM> packed;
+		// mesh component
+		std::vector<uint8_t> mesh;
+		std::vector<uint8_t> parts;
+		// material component
+		std::vector<glm::vec4> color;
+		std::vector<int16_t> materialIndex;
+		// texture component
+		std::vector<int16_t> textureSlot;
+		std::vector<glm::vec2> uvScale;
+		std::vector<uint8_t> samplerFilter;
+		std::vector<uint8_t> samplerWrap;
+		// bounds component, the world box around the mesh
+		std::vector<float> minimumX;
+		std::vector<float> minimumY;
+		std::vector<float> minimumZ;
+		std::vector<float> maximumX;
+		std::vector<float> maximumY;
+		std::vector<float> maximumZ;
+		// prefab component, the prefab an instance places
+		std::vector<uint16_t> prefab;
+	};
+
+	// properties for the entities sharing one set of components
+	struct ENTITY_ARCHETYPE
+	{
+		unsigned int components;
+		std::vector<ENTITY_CHUNK> chunks;
+	};
+
+	// properties for the size of the store and the last systems
+	struct ENTITY_STATS
+	{
+		int entities;
+		int archetypes;
+		int chunks;
+		int visibleEntities;
+		int updatedChunks;
+		int prefabs;
+		int prefabParts;
+	};
+
+	// properties for one mesh an entity draws, in world space
+	struct ENTITY_MESH
+	{
+		SceneManager::MESH_TYPE mesh;
+		unsigned int parts;
+		glm::mat4 model;
+	};
+
+	// the most entities kept in one chunk
+	static const int CHUNK_CAPACITY = 1024;
+
+private:
+	// properties for where the entity of a slot is stored
+	struct ENTITY_RECORD
+	{
+		int archetype;
+		int chunk;
+		int row;
+		uint32_t generation;
+		bool bAlive;
+	};
+
+	// properties for a prefab, whose parts are kept together in
+	// the shared part list
+	struct PREFAB_DEFINITION
+	{
+		std::string name;
+		int firstPart;
+		int partCount;
+		// box around all of the parts in local space
+		glm::vec3 minimum;
+		glm::vec3 maximum;
+		// far instances may be drawn as an impostor
+		bool bImpostor;
+	};
+
+	// properties for a visible prefab instance found while the
+	// draw list is built
+	struct VISIBLE_INSTANCE
+	{
+		const ENTITY_CHUNK* pChunk;
+		int row;
+		bool bMaterial;
+	};
+
+	std::vector<ENTITY_ARCHETYPE> m_archetypes;
+	std::vector<ENTITY_RECORD> m_records;
+	// slots of destroyed entities that can be used again
+	std::vector<uint32_t> m_freeSlots;
+	// corners of the box around each shape mesh
+	glm::vec3 m_meshMinimum[SceneManager::MESH_TYPE_COUNT];
+	glm::vec3 m_meshMaximum[SceneManager::MESH_TYPE_COUNT];
+	// prefabs and the parts all of their instances share
+	std::vector<PREFAB_DEFINITION> m_prefabs;
+	std::vector<PREFAB_PART> m_prefabParts;
+	// keep the transforms as packed values instead of columns
+	// of floats and a world matrix
+	bool m_bCompactTransforms;
+	TransformQuantizer m_quantizer;
+	ENTITY_STATS m_stats;
+
+	// find or add the archetype with a set of components
+	int GetArchetypeIndex(unsigned int components);
+	// add a row for a new entity, returning its handle
+	ENTITY_ID AddEntity(unsigned int components, ENTITY_CHUNK*& pChunk, int& row);
+	// add an empty chunk with the columns of an archetype
+	void AddChunk(ENTITY_ARCHETYPE& archetype);
+	// copy an entity from one row to another of an archetype
+	void MoveRow(ENTITY_ARCHETYPE& archetype, int fromChunk, int fromRow, int toChunk, int toRow);
+	// get the record of a live entity, or NULL
+	ENTITY_RECORD* FindRecord(ENTITY_ID entity);
+	const ENTITY_RECORD* FindRecord(ENTITY_ID entity) const;
+	// store the transform of one row
+	void StoreTransform(ENTITY_CHUNK& chunk, int row, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale);
+	// get the world matrix of one row
+	glm::mat4 GetWorldMatrix(const ENTITY_CHUNK& chunk, int row) const;
+	// recompute the world matrices and bounds of one chunk
+	void UpdateChunk(ENTITY_CHUNK& chunk, unsigned int components);
+	// append the draws of the parts of visible prefab instances
+	// that are opaque or transparent, part by part
+	void AppendPrefabDraws(
+		const std::vector<std::vector<VISIBLE_INSTANCE> >& instances,
+		bool bTransparent,
+		std::vector<SceneManager::DRAW_COMMAND>& draws) const;
+
+public:
+	// create an entity, returning its handle
+	ENTITY_ID CreateEntity(const ENTITY_DESC& desc);
+	// destroy an entity, freeing its slot for a new one
+	bool DestroyEntity(ENTITY_ID entity);
+	// destroy every entity and prefab
+	void Clear();
+	// check whether a handle names a live entity
+	bool IsAlive(ENTITY_ID entity) const;
+	// keep the transforms packed into 16 bytes, relative to a
+	// grid of cells of the passed in size, while there are no
+	// entities
+	bool SetCompactTransforms(bool bCompact, float cellSize);
+	// get the bytes each entity's transform takes
+	int GetTransformSize() const;
+
+	// move, turn and scale an entity
+	bool SetTransform(ENTITY_ID entity, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale);
+	// get the position, rotation and scale of an entity
+	bool GetTransform(ENTITY_ID entity, glm::vec3& position, glm::vec3& rotation, glm::vec3& scale) const;
+	// set the color of an entity with the material component
+	bool SetColor(ENTITY_ID entity, const glm::vec4& color);
+	// get the color of an entity with the material component
+	bool GetColor(ENTITY_ID entity, glm::vec4& color) const;
+	// define a prefab from parts in its local space, returning
+	// its index
+	int DefinePrefab(const std::string& name, const std::vector<PREFAB_PART>& parts);
+	// find a prefab by name, or -1
+	int FindPrefab(const std::string& name) const;
+	// place an instance of a prefab, returning its handle
+	ENTITY_ID InstantiatePrefab(int prefab, const PREFAB_INSTANCE& instance);
+	// get the number of prefabs
+	int GetPrefabCount() const;
+	// get the parts of a prefab in its local space
+	bool GetPrefabParts(int prefab, std::vector<PREFAB_PART>& parts) const;
+	// get the box around the parts of a prefab in its local
+	// space
+	bool GetPrefabBounds(int prefab, glm::vec3& minimum, glm::vec3& maximum) const;
+	// let far instances of a prefab be drawn as an impostor
+	void SetPrefabImpostor(int prefab, bool bImpostor);
+
+	// get the world box around an entity's mesh or prefab
+	bool GetBounds(ENTITY_ID entity, glm::vec3& minimum, glm::vec3& maximum) const;
+	// get the meshes an entity draws, its own mesh or the parts
+	// of the prefab it places
+	bool GetMeshes(ENTITY_ID entity, std::vector<ENTITY_MESH>& meshes) const;
+	// get the name of the prefab an entity places, or an empty
+	// name for other entities
+	std::string GetPrefabName(ENTITY_ID entity) const;
+
+	// recompute the world matrices and bounds that changed
+	void UpdateTransforms();
+	// mark the entities inside a camera's view volume visible,
+	// returning how many are
+	int CullEntities(const glm::mat4& viewProjection);
+	// mark every entity visible
+	void ShowAllEntities();
+	// mark the visible instances of prefabs with impostors
+	// that are beyond a distance from the camera, returning how
+	// many are
+	int SelectImpostors(const glm::vec3& viewPosition, float distance);
+	// append the draws of the visible entities, opaque first
+	// and then the transparent ones
+	void BuildDrawList(std::vector<SceneManager::DRAW_COMMAND>& draws) const;
+	// append the impostor draws of the instances marked by
+	// SelectImpostors(), which BuildDrawList() leaves out
+	void BuildImpostorDraws(std::vector<SceneManager::IMPOSTOR_DRAW>& draws) const;
+
+	// get the number of archetypes
+	int GetArchetypeCount() const;
+	// get an archetype and its chunks
+	const ENTITY_ARCHETYPE& GetArchetype(int index) const;
+	// get the size of the store and the last systems
+	const ENTITY_STATS& GetStats() const;
+};
@@ -8,42 +8,204 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "SceneManager.h"
-
-#ifndef STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-#endif
+#include "GLRenderDevice.h"
+#include "DrawListCache.h"
+#include "SceneEntities.h"
+#include "AnimationSystem.h"
+#include "ParticleSystem.h"
+#include "SceneQuery.h"
+#include "CameraCollider.h"
+#include "ImpostorAtlas.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
 
 #include <glm/gtx/transform.hpp>
 
 // declaration of global variables and defines
 namespace
 {
-	const char* g_ModelName = "model";
-	const char* g_ColorValueName = "objectColor";
-	const char* g_TextureValueName = "objectTexture";
-	const char* g_UseTextureName = "bUseTexture";
-	const char* g_UseLightingName = "bUseLighting";
+	// properties for the texture image files used in the scene
+	struct SCENE_TEXTURE
+	{
+		const char* filename;
+		const char* tag;
+	};
+
+	// texture image files that are loaded for the 3D scene
+	const SCENE_TEXTURE g_SceneTextures[] =
+	{
+		{ "../../Utilities/textures/rusticwood.jpg", "table" },
+		{ "../../Utilities/textures/cheese_wheel.jpg", "cheese_wheel_side" },
+		{ "../../Utilities/textures/cheese_top.jpg", "cheese_wheel_top" },
+		{ "../../Utilities/textures/breadcrust.jpg", "breadcrust" },
+		{ "../../Utilities/textures/backdrop.jpg", "backdrop" },
+		{ "../../Utilities/textures/knife_handle.jpg", "knifehandle" },
+		{ "../../Utilities/textures/stainless.jpg", "stainless" },
+		{ "../../Utilities/textures/cheddar.jpg", "cheddar" },
+		{ "../../Utilities/textures/circular-brushed-gold-texture.jpg", "knifescrew" }
+	};
+
+	// properties for the textures that can be generated in code
+	struct SCENE_PROCEDURAL_TEXTURE
+	{
+		const char* tag;
+		ProceduralTextures::PATTERN_SETTINGS settings;
+	};
+
+	// scene textures that are replaced when procedural textures
+	// are on, each matched to the look of its image file
+	const SCENE_PROCEDURAL_TEXTURE g_SceneProceduralTextures[] =
+	{
+		// dark planks with bent growth rings
+		{ "table", { ProceduralTextures::PATTERN_WOOD,
+			glm::vec3(0.45f, 0.28f, 0.15f), glm::vec3(0.24f, 0.13f, 0.06f), 10.0f, 2.5f, 0.25f, 1 } },
+		// waxed rind around the wheel, with few holes and a
+		// mottled surface since it repeats five times around
+		{ "cheese_wheel_side", { ProceduralTextures::PATTERN_CHEESE,
+			glm::vec3(0.9f, 0.7f, 0.3f), glm::vec3(0.74f, 0.5f, 0.16f), 20.0f, 0.15f, 0.45f, 2 } },
+		// pale cut face of the wheel with many small holes
+		{ "cheese_wheel_top", { ProceduralTextures::PATTERN_CHEESE,
+			glm::vec3(0.97f, 0.86f, 0.48f), glm::vec3(0.84f, 0.66f, 0.28f), 56.0f, 0.1f, 0.2f, 3 } },
+		// orange cheddar wedges with a dense smooth body
+		{ "cheddar", { ProceduralTextures::PATTERN_CHEESE,
+			glm::vec3(0.95f, 0.6f, 0.18f), glm::vec3(0.8f, 0.44f, 0.1f), 36.0f, 0.05f, 0.15f, 4 } },
+		// knife blade brushed along its length
+		{ "stainless", { ProceduralTextures::PATTERN_BRUSHED_METAL,
+			glm::vec3(0.78f, 0.79f, 0.81f), glm::vec3(0.52f, 0.53f, 0.55f), 400.0f, 0.0f, 0.3f, 5 } },
+		// gold knife screw brushed in circles
+		{ "knifescrew", { ProceduralTextures::PATTERN_CIRCULAR_METAL,
+			glm::vec3(0.85f, 0.7f, 0.24f), glm::vec3(0.58f, 0.45f, 0.12f), 120.0f, 0.4f, 0.2f, 6 } }
+	};
+
+	// default width and height of the generated textures
+	const int g_DefaultProceduralResolution = 1024;
+
+	// properties for a prefab placed on every showroom table
+	struct SHOWROOM_PREFAB
+	{
+		const char* name;
+		// authored place of the object, which its parts are kept
+		// relative to
+		glm::vec3 origin;
+	};
+
+	// prefabs of a showroom world, where the table and cheese
+	// wheel keep the authored places of their parts
+	const SHOWROOM_PREFAB g_ShowroomPrefabs[] =
+	{
+		{ "table", glm::vec3(0.0f, 0.0f, 0.0f) },
+		{ "cheese_wheel", glm::vec3(0.0f, 0.0f, 0.0f) },
+		{ "book", glm::vec3(-1.2f, 0.59f, 0.3f) },
+		{ "wine_glass", glm::vec3(6.0f, 0.55f, -1.5f) },
+		{ "wine_bottle", glm::vec3(4.0f, 0.9f, -2.6f) }
+	};
+
+	// width and depth of a showroom cell, which fits one table
+	// turned either way
+	const float g_ShowroomCellSize = 24.0f;
+
+	// farthest distance an entity can be picked at, which is
+	// the far plane of the camera
+	const float g_PickDistance = 100.0f;
 }
 
 /***********************************************************
  *  SceneManager()
  *
- *  The constructor for the class
+ *  The constructor for the class.  When no shader manager is
+ *  passed in, the scene is prepared without OpenGL so that
+ *  its draw list can be rendered by the software renderers.
  ***********************************************************/
 SceneManager::SceneManager(ShaderManager *pShaderManager)
 {
 	m_pShaderManager = pShaderManager;
 	// create the shape meshes object
 	m_basicMeshes = new ShapeMeshes();
+	// create the batched asset file reader
+	m_pAssetLoader = new AssetLoader();
+	// create the texture resolution and format policy
+	m_pTextureBudget = new TextureBudget();
+	// create the procedural texture generator
+	m_pProceduralTextures = new ProceduralTextures();
+	m_bProceduralTextures = false;
+	m_proceduralResolution = g_DefaultProceduralResolution;
+	// create the shared texture sampler objects
+	m_pTextureSamplers = new TextureSamplers();
+	m_samplerOverride = -1;
+	// create the image decoder backends
+	m_pImageDecoders = new ImageDecoderRegistry();
+	m_bRawTextureCache = false;
+	// draw through OpenGL when there is a shader manager
+	m_pRenderDevice = NULL;
+	if (NULL != pShaderManager)
+	{
+		m_pRenderDevice = new GLRenderDevice(pShaderManager, m_basicMeshes, m_pTextureSamplers);
+	}
 
 	// initialize the texture collection
 	for (int i = 0; i < 16; i++)
 	{
 		m_textureIDs[i].tag = "/0";
 		m_textureIDs[i].ID = -1;
+		m_textureIDs[i].filter = TextureSamplers::FILTER_TRILINEAR;
+		m_textureIDs[i].wrap = TextureSamplers::WRAP_REPEAT;
+		m_textureImages[i].width = 0;
+		m_textureImages[i].height = 0;
 	}
 	m_loadedTextures = 0;
+
+	// initialize the draw state for the first recorded draw
+	m_currentDraw.mesh = MESH_BOX;
+	m_currentDraw.parts = PART_ALL;
+	m_currentDraw.model = glm::mat4(1.0f);
+	m_currentDraw.color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+	m_currentDraw.bUseTexture = false;
+	m_currentDraw.textureSlot = -1;
+	m_currentDraw.uvScale = glm::vec2(1.0f, 1.0f);
+	m_currentDraw.materialIndex = -1;
+	m_currentDraw.samplerFilter = TextureSamplers::FILTER_TRILINEAR;
+	m_currentDraw.samplerWrap = TextureSamplers::WRAP_REPEAT;
+
+	// create the draw lists kept for the preset cameras
+	m_pDrawListCache = new DrawListCache();
+	m_sceneRevision = 0;
+	m_sceneView = glm::mat4(1.0f);
+	m_sceneProjection = glm::mat4(1.0f);
+	m_bSceneCamera = false;
+
+	// the objects record their draws every frame until the
+	// entity scene is turned on
+	m_pSceneEntities = NULL;
+	m_bEntityScene = false;
+	m_bRecordEntities = false;
+	m_currentScale = glm::vec3(1.0f, 1.0f, 1.0f);
+	m_currentRotation = glm::vec3(0.0f, 0.0f, 0.0f);
+	m_currentPosition = glm::vec3(0.0f, 0.0f, 0.0f);
+	StressSceneGenerator::GetDefaultSettings(m_stressSettings);
+	m_bStressScene = false;
+	m_pWorldStreamer = NULL;
+	m_worldSettings.loadRadius = 2;
+	m_worldSettings.loaderThreads = 2;
+	m_worldSettings.uploadMilliseconds = 2.0;
+	m_bStreamWorld = false;
+	m_bCompactTransforms = false;
+	m_compactCellSize = 64.0f;
+	m_bRecordTransforms = false;
+	m_pAnimation = NULL;
+	m_bAnimateScene = false;
+	m_pParticles = NULL;
+	m_dustBudget = 0;
+	m_particleTime = -1.0;
+	m_pSceneQuery = NULL;
+	m_sceneQueryRevision = -1;
+	m_pCameraCollider = NULL;
+	m_cameraColliderRevision = -1;
+	m_pImpostorAtlas = NULL;
+	m_impostorView = glm::vec3(0.0f);
+	m_bImpostorView = false;
 }
 
 /***********************************************************
@@ -55,11 +217,83 @@ SceneManager::~SceneManager()
 {
 	// free the allocated objects
 	m_pShaderManager = NULL;
+	if (NULL != m_pRenderDevice)
+	{
+		delete m_pRenderDevice;
+		m_pRenderDevice = NULL;
+	}
 	if (NULL != m_basicMeshes)
 	{
 		delete m_basicMeshes;
 		m_basicMeshes = NULL;
 	}
+	if (NULL != m_pAssetLoader)
+	{
+		delete m_pAssetLoader;
+		m_pAssetLoader = NULL;
+	}
+	if (NULL != m_pTextureBudget)
+	{
+		delete m_pTextureBudget;
+		m_pTextureBudget = NULL;
+	}
+	if (NULL != m_pProceduralTextures)
+	{
+		delete m_pProceduralTextures;
+		m_pProceduralTextures = NULL;
+	}
+	if (NULL != m_pTextureSamplers)
+	{
+		delete m_pTextureSamplers;
+		m_pTextureSamplers = NULL;
+	}
+	if (NULL != m_pImageDecoders)
+	{
+		delete m_pImageDecoders;
+		m_pImageDecoders = NULL;
+	}
+	if (NULL != m_pDrawListCache)
+	{
+		delete m_pDrawListCache;
+		m_pDrawListCache = NULL;
+	}
+	// the loader threads are stopped before the entities the
+	// world is placed in are freed
+	if (NULL != m_pWorldStreamer)
+	{
+		delete m_pWorldStreamer;
+		m_pWorldStreamer = NULL;
+	}
+	if (NULL != m_pAnimation)
+	{
+		delete m_pAnimation;
+		m_pAnimation = NULL;
+	}
+	if (NULL != m_pParticles)
+	{
+		delete m_pParticles;
+		m_pParticles = NULL;
+	}
+	if (NULL != m_pSceneQuery)
+	{
+		delete m_pSceneQuery;
+		m_pSceneQuery = NULL;
+	}
+	if (NULL != m_pCameraCollider)
+	{
+		delete m_pCameraCollider;
+		m_pCameraCollider = NULL;
+	}
+	if (NULL != m_pImpostorAtlas)
+	{
+		delete m_pImpostorAtlas;
+		m_pImpostorAtlas = NULL;
+	}
+	if (NULL != m_pSceneEntities)
+	{
+		delete m_pSceneEntities;
+		m_pSceneEntities = NULL;
+	}
 
 	// free the allocated OpenGL textures
 	DestroyGLTextures();
@@ -71,66 +305,66 @@ SceneManager::~SceneManager()
  *  This method is used for loading textures from image files,
  *  configuring the texture mapping parameters in OpenGL, 
  *  generating the mipmaps, and loading the read texture into
- *  the next available texture slot in memory.
+ *  the next available texture slot in memory.  If the image
+ *  file was already read by the batched asset loader, it is
+ *  decoded straight from that memory instead of from disk.
  ***********************************************************/
 bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
 {
-	int width = 0;
-	int height = 0;
-	int colorChannels = 0;
-	GLuint textureID = 0;
+	std::vector<unsigned char> fileData;
+	const unsigned char* data = NULL;
+	size_t size = 0;
+
+	// use the file data from the batched read when it is available
+	const AssetLoader::ASSET_FILE* pAsset = NULL;
+	if (NULL != m_pAssetLoader)
+	{
+		pAsset = m_pAssetLoader->FindAsset(tag);
+	}
 
-	// indicate to always flip images vertically when loaded
-	stbi_set_flip_vertically_on_load(true);
+	if (NULL != pAsset)
+	{
+		data = pAsset->data;
+		size = pAsset->size;
+	}
+	else if (((m_bRawTextureCache == true) &&
+		RawImageDecoder::IsCacheCurrent(GetTextureCachePath(filename).c_str(), filename) &&
+		ImageDecoderRegistry::ReadFile(GetTextureCachePath(filename).c_str(), fileData)) ||
+		ImageDecoderRegistry::ReadFile(filename, fileData))
+	{
+		data = &fileData[0];
+		size = fileData.size();
+	}
 
-	// try to parse the image data from the specified image file
-	unsigned char* image = stbi_load(
-		filename, 
-		&width, 
-		&height, 
-		&colorChannels, 
-		0);
+	// try to parse the image data with the first backend that reads it
+	DECODED_IMAGE image;
+	ImageDecoder* pDecoder = m_pImageDecoders->Decode(data, size, image);
 
 	// if the image was successfully read from the image file
-	if (image)
-	{
-		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
-
-		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-
-		// set the texture wrapping parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		// set texture filtering parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		// if the loaded image is in RGB format
-		if (colorChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
-		// if the loaded image is in RGBA format - it supports transparency
-		else if (colorChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		else
+	if (NULL != pDecoder)
+	{
+		std::cout << "Successfully loaded image:" << filename << ", width:" << image.width << ", height:" << image.height << ", channels:" << image.channels << ", decoder:" << pDecoder->GetName() << std::endl;
+
+		// keep an uncompressed copy so the next run skips decoding
+		if ((m_bRawTextureCache == true) && (image.bOwned == true))
 		{
-			std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
-			return false;
+			RawImageDecoder::WriteRawImage(GetTextureCachePath(filename).c_str(), image, filename);
 		}
 
-		// generate the texture mipmaps for mapping textures to lower resolutions
-		glGenerateMipmap(GL_TEXTURE_2D);
+		// OpenGL expects the bottom row first, so top-down images are
+		// flipped while the texture is prepared for uploading
+		bool bReturn = UploadGLTexture(
+			image.pixels,
+			image.width,
+			image.height,
+			image.channels,
+			!image.bBottomUp,
+			tag);
 
 		// free the image data from local memory
-		stbi_image_free(image);
-		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
-
-		// register the loaded texture and associate it with the special tag string
-		m_textureIDs[m_loadedTextures].ID = textureID;
-		m_textureIDs[m_loadedTextures].tag = tag;
-		m_loadedTextures++;
+		pDecoder->Free(image);
 
-		return true;
+		return(bReturn);
 	}
 
 	std::cout << "Could not load image:" << filename << std::endl;
@@ -139,6 +373,303 @@ bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
 	return false;
 }
 
+/***********************************************************
+ *  GetTextureCachePath()
+ *
+ *  This method is used for getting the name of the file that
+ *  holds the uncompressed cache of a texture image file.
+ ***********************************************************/
+std::string SceneManager::GetTextureCachePath(const char* filename)
+{
+	return(std::string(filename) + ".rimg");
+}
+
+/***********************************************************
+ *  SetRawTextureCache()
+ *
+ *  This method is used for turning on the uncompressed cache
+ *  of decoded texture images.  A texture with a cache file is
+ *  loaded from it, and one without gets a cache file written.
+ ***********************************************************/
+void SceneManager::SetRawTextureCache(bool bEnabled)
+{
+	m_bRawTextureCache = bEnabled;
+}
+
+/***********************************************************
+ *  SetTextureFormats()
+ *
+ *  This method is used for choosing how the textures are
+ *  uploaded: the largest width or height, or 0 for the cap
+ *  of the device, whether color textures use the sRGB
+ *  formats, and whether images are repacked to fewer
+ *  channels.  It must be called before PrepareScene().
+ ***********************************************************/
+void SceneManager::SetTextureFormats(int maxDimension, bool bUseSRGB, bool bCompactFormats)
+{
+	m_pTextureBudget->SetMaxDimension(maxDimension);
+	m_pTextureBudget->SetUseSRGB(bUseSRGB);
+	m_pTextureBudget->SetCompactFormats(bCompactFormats);
+}
+
+/***********************************************************
+ *  SetMappedAssets()
+ *
+ *  This method is used for mapping the texture image files
+ *  into memory read-only instead of reading copies of them,
+ *  so that processes loading the scene at the same time
+ *  share the file data.
+ ***********************************************************/
+void SceneManager::SetMappedAssets(bool bEnabled)
+{
+	if (NULL != m_pAssetLoader)
+	{
+		m_pAssetLoader->SetMemoryMapped(bEnabled);
+	}
+}
+
+/***********************************************************
+ *  GetSceneTextureFiles()
+ *
+ *  This method is used for getting the names of the texture
+ *  image files that are loaded for the scene.
+ ***********************************************************/
+void SceneManager::GetSceneTextureFiles(std::vector<std::string>& filenames)
+{
+	const int textureCount = sizeof(g_SceneTextures) / sizeof(g_SceneTextures[0]);
+
+	filenames.clear();
+	for (int i = 0; i < textureCount; i++)
+	{
+		filenames.push_back(g_SceneTextures[i].filename);
+	}
+}
+
+/***********************************************************
+ *  UploadGLTexture()
+ *
+ *  This method is used for fitting decoded image data to the
+ *  texture budget, configuring the texture mapping parameters
+ *  in OpenGL, generating the mipmaps, and loading the texture
+ *  into the next available texture slot in memory.
+ ***********************************************************/
+bool SceneManager::UploadGLTexture(
+	const unsigned char* image,
+	int width,
+	int height,
+	int colorChannels,
+	bool bFlipRows,
+	std::string tag)
+{
+	GLuint textureID = 0;
+	TextureBudget::PREPARED_TEXTURE prepared;
+
+	if (m_loadedTextures >= 16)
+	{
+		std::cout << "No texture slot left for:" << tag << std::endl;
+		return false;
+	}
+
+	// reduce the image to the device resolution cap and pick
+	// the most compact format that keeps its content
+	if (m_pTextureBudget->PrepareTexture(image, width, height, colorChannels, bFlipRows, prepared) == false)
+	{
+		std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
+		return false;
+	}
+	m_pTextureBudget->ReportTexture(tag, prepared);
+
+	// without an OpenGL context the pixels stay in memory
+	if (NULL == m_pShaderManager)
+	{
+		StoreTextureImage(prepared, tag);
+		return true;
+	}
+
+	glGenTextures(1, &textureID);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+
+	// set the texture wrapping parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	// set texture filtering parameters - the bound sampler object
+	// overrides these, but they match its trilinear default
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	// the compact formats are expanded back to RGBA when sampled
+	if (prepared.bSwizzle == true)
+	{
+		glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, prepared.swizzle);
+	}
+
+	// rows of one and three channel images are not 4-byte aligned
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(
+		GL_TEXTURE_2D,
+		0,
+		prepared.internalFormat,
+		prepared.width,
+		prepared.height,
+		0,
+		prepared.pixelFormat,
+		GL_UNSIGNED_BYTE,
+		&prepared.pixels[0]);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	// generate the texture mipmaps for mapping textures to lower resolutions
+	glGenerateMipmap(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
+
+	// register the loaded texture and associate it with the special tag string
+	m_textureIDs[m_loadedTextures].ID = textureID;
+	m_textureIDs[m_loadedTextures].tag = tag;
+	m_textureIDs[m_loadedTextures].filter = TextureSamplers::FILTER_TRILINEAR;
+	m_textureIDs[m_loadedTextures].wrap = TextureSamplers::WRAP_REPEAT;
+	m_loadedTextures++;
+
+	return true;
+}
+
+/***********************************************************
+ *  StoreTextureImage()
+ *
+ *  This method is used for keeping a prepared texture in the
+ *  next available texture slot as RGBA pixels in memory.  The
+ *  compact formats are expanded the same way the swizzle of
+ *  the OpenGL texture would expand them when sampled.
+ ***********************************************************/
+void SceneManager::StoreTextureImage(
+	const TextureBudget::PREPARED_TEXTURE& prepared,
+	std::string tag)
+{
+	TEXTURE_IMAGE& textureImage = m_textureImages[m_loadedTextures];
+	const int pixelCount = prepared.width * prepared.height;
+
+	textureImage.width = prepared.width;
+	textureImage.height = prepared.height;
+	textureImage.pixels.resize((size_t)pixelCount * 4);
+
+	for (int i = 0; i < pixelCount; i++)
+	{
+		const unsigned char* source = &prepared.pixels[(size_t)i * prepared.channels];
+		unsigned char* destination = &textureImage.pixels[(size_t)i * 4];
+
+		if (prepared.channels <= 2)
+		{
+			destination[0] = source[0];
+			destination[1] = source[0];
+			destination[2] = source[0];
+			destination[3] = (prepared.channels == 2) ? source[1] : 255;
+		}
+		else
+		{
+			destination[0] = source[0];
+			destination[1] = source[1];
+			destination[2] = source[2];
+			destination[3] = (prepared.channels == 4) ? source[3] : 255;
+		}
+	}
+
+	// register the texture so it is found by its tag as usual
+	m_textureIDs[m_loadedTextures].ID = 0;
+	m_textureIDs[m_loadedTextures].tag = tag;
+	m_textureIDs[m_loadedTextures].filter = TextureSamplers::FILTER_TRILINEAR;
+	m_textureIDs[m_loadedTextures].wrap = TextureSamplers::WRAP_REPEAT;
+	m_loadedTextures++;
+}
+
+/***********************************************************
+ *  GetTextureImage()
+ *
+ *  This method is used for getting the texture pixels kept in
+ *  memory for the passed in slot, or NULL when the texture
+ *  was uploaded to OpenGL instead.
+ ***********************************************************/
+const SceneManager::TEXTURE_IMAGE* SceneManager::GetTextureImage(int textureSlot) const
+{
+	if ((textureSlot < 0) || (textureSlot >= m_loadedTextures) ||
+		(m_textureImages[textureSlot].pixels.empty() == true))
+	{
+		return(NULL);
+	}
+
+	return(&m_textureImages[textureSlot]);
+}
+
+/***********************************************************
+ *  CreateProceduralTexture()
+ *
+ *  This method is used for generating a texture image from
+ *  the passed in pattern settings and loading it into the
+ *  next available texture slot in memory.
+ ***********************************************************/
+bool SceneManager::CreateProceduralTexture(
+	const ProceduralTextures::PATTERN_SETTINGS& settings,
+	std::string tag)
+{
+	std::vector<unsigned char> pixels;
+
+	m_pProceduralTextures->Generate(
+		settings,
+		m_proceduralResolution,
+		m_proceduralResolution,
+		pixels);
+
+	std::cout << "Successfully generated image:" << tag << ", width:" << m_proceduralResolution << ", height:" << m_proceduralResolution << ", channels:" << 3 << std::endl;
+
+	return(UploadGLTexture(
+		&pixels[0],
+		m_proceduralResolution,
+		m_proceduralResolution,
+		3,
+		false,
+		tag));
+}
+
+/***********************************************************
+ *  FindProceduralPattern()
+ *
+ *  This method is used for getting the index of the pattern
+ *  that replaces the texture with the passed in tag, or -1
+ *  when the texture is always loaded from its image file.
+ ***********************************************************/
+int SceneManager::FindProceduralPattern(std::string tag)
+{
+	const int patternCount = sizeof(g_SceneProceduralTextures) / sizeof(g_SceneProceduralTextures[0]);
+
+	if (m_bProceduralTextures == false)
+	{
+		return(-1);
+	}
+
+	for (int i = 0; i < patternCount; i++)
+	{
+		if (tag.compare(g_SceneProceduralTextures[i].tag) == 0)
+		{
+			return(i);
+		}
+	}
+
+	return(-1);
+}
+
+/***********************************************************
+ *  SetProceduralTextures()
+ *
+ *  This method is used for replacing the wood, cheese and
+ *  metal image files with generated textures of the passed
+ *  in resolution.  It must be called before PrepareScene().
+ ***********************************************************/
+void SceneManager::SetProceduralTextures(bool bEnabled, int resolution)
+{
+	m_bProceduralTextures = bEnabled;
+	if (resolution > 0)
+	{
+		m_proceduralResolution = resolution;
+	}
+}
+
 /***********************************************************
  *  BindGLTextures()
  *
@@ -152,6 +683,77 @@ void SceneManager::BindGLTextures()
 		// bind textures on corresponding texture units
 		glActiveTexture(GL_TEXTURE0 + i);
 		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
+		// bind the shared sampler object for the texture preset
+		glBindSampler(i, m_pTextureSamplers->GetSampler(
+			m_textureIDs[i].filter,
+			m_textureIDs[i].wrap));
+	}
+}
+
+/***********************************************************
+ *  SetTextureSampler()
+ *
+ *  This method is used for choosing the filtering preset and
+ *  wrapping mode of the loaded texture with the passed in tag.
+ ***********************************************************/
+void SceneManager::SetTextureSampler(
+	std::string tag,
+	TextureSamplers::SAMPLER_FILTER filter,
+	TextureSamplers::SAMPLER_WRAP wrap)
+{
+	int textureSlot = FindTextureSlot(tag);
+	if (textureSlot < 0)
+	{
+		return;
+	}
+
+	m_textureIDs[textureSlot].filter = filter;
+	m_textureIDs[textureSlot].wrap = wrap;
+	InvalidateDrawLists();
+	if (NULL != m_pShaderManager)
+	{
+		glBindSampler(textureSlot, m_pTextureSamplers->GetSampler(filter, wrap));
+	}
+}
+
+/***********************************************************
+ *  SetSamplerOverride()
+ *
+ *  This method is used for forcing one filtering preset onto
+ *  every texture, which is used to compare the presets.  Pass
+ *  -1 to return to the texture and material presets.
+ ***********************************************************/
+void SceneManager::SetSamplerOverride(int filter)
+{
+	m_samplerOverride = filter;
+	InvalidateDrawLists();
+}
+
+/***********************************************************
+ *  ResolveTextureSampler()
+ *
+ *  This method is used for choosing the sampler preset of a
+ *  textured draw as it is recorded, so every backend samples
+ *  it the same way.  The override preset comes first, then
+ *  the preset of the material, then that of the texture.
+ ***********************************************************/
+void SceneManager::ResolveTextureSampler(DRAW_COMMAND& draw)
+{
+	if ((draw.bUseTexture == false) || (draw.textureSlot < 0))
+	{
+		return;
+	}
+
+	const TEXTURE_INFO& texture = m_textureIDs[draw.textureSlot];
+	draw.samplerFilter = texture.filter;
+	draw.samplerWrap = texture.wrap;
+	if (m_samplerOverride >= 0)
+	{
+		draw.samplerFilter = (TextureSamplers::SAMPLER_FILTER)m_samplerOverride;
+	}
+	else if ((draw.materialIndex >= 0) && (m_objectMaterials[draw.materialIndex].samplerFilter >= 0))
+	{
+		draw.samplerFilter = (TextureSamplers::SAMPLER_FILTER)m_objectMaterials[draw.materialIndex].samplerFilter;
 	}
 }
 
@@ -165,7 +767,12 @@ void SceneManager::DestroyGLTextures()
 {
 	for (int i = 0; i < m_loadedTextures; i++)
 	{
-		glGenTextures(1, &m_textureIDs[i].ID);
+		// textures kept in memory have no OpenGL texture
+		if (m_textureIDs[i].ID != 0)
+		{
+			glDeleteTextures(1, &m_textureIDs[i].ID);
+			m_textureIDs[i].ID = 0;
+		}
 	}
 }
 
@@ -246,6 +853,7 @@ bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL &material)
 			material.diffuseColor = m_objectMaterials[index].diffuseColor;
 			material.specularColor = m_objectMaterials[index].specularColor;
 			material.shininess = m_objectMaterials[index].shininess;
+			material.samplerFilter = m_objectMaterials[index].samplerFilter;
 		}
 		else
 		{
@@ -256,11 +864,31 @@ bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL &material)
 	return(true);
 }
 
+/***********************************************************
+ *  FindMaterialIndex()
+ *
+ *  This method is used for getting the index of the defined
+ *  material associated with the passed in tag, or -1.
+ ***********************************************************/
+int SceneManager::FindMaterialIndex(std::string tag)
+{
+	for (int index = 0; index < (int)m_objectMaterials.size(); index++)
+	{
+		if (m_objectMaterials[index].tag.compare(tag) == 0)
+		{
+			return(index);
+		}
+	}
+
+	return(-1);
+}
+
 /***********************************************************
  *  SetTransformations()
  *
  *  This method is used for setting the transform buffer
- *  using the passed in transformation values.
+ *  using the passed in transformation values.  The model
+ *  matrix is recorded with the next mesh draw.
  ***********************************************************/
 void SceneManager::SetTransformations(
 	glm::vec3 scaleXYZ,
@@ -288,17 +916,17 @@ void SceneManager::SetTransformations(
 
 	modelView = translation * rotationX * rotationY * rotationZ * scale;
 
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setMat4Value(g_ModelName, modelView);
-	}
+	m_currentDraw.model = modelView;
+	m_currentScale = scaleXYZ;
+	m_currentRotation = glm::vec3(XrotationDegrees, YrotationDegrees, ZrotationDegrees);
+	m_currentPosition = positionXYZ;
 }
 
 /***********************************************************
  *  SetShaderColor()
  *
  *  This method is used for setting the passed in color
- *  into the shader for the next draw command
+ *  into the draw state for the next draw command
  ***********************************************************/
 void SceneManager::SetShaderColor(
 	float redColorValue,
@@ -314,135 +942,250 @@ void SceneManager::SetShaderColor(
 	currentColor.b = blueColorValue;
 	currentColor.a = alphaValue;
 
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, false);
-		m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
-	}
+	m_currentDraw.bUseTexture = false;
+	m_currentDraw.textureSlot = -1;
+	m_currentDraw.color = currentColor;
 }
 
 /***********************************************************
  *  SetShaderTexture()
  *
  *  This method is used for setting the texture data
- *  associated with the passed in ID into the shader.
+ *  associated with the passed in ID into the draw state.
  ***********************************************************/
 void SceneManager::SetShaderTexture(
 	std::string textureTag)
 {
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, true);
-
-		int textureID = -1;
-		textureID = FindTextureSlot(textureTag);
-		m_pShaderManager->setSampler2DValue(g_TextureValueName, textureID);
-	}
+	m_currentDraw.bUseTexture = true;
+	m_currentDraw.textureSlot = FindTextureSlot(textureTag);
 }
 
 /***********************************************************
  *  SetTextureUVScale()
  *
  *  This method is used for setting the texture UV scale
- *  values into the shader.
+ *  values into the draw state.
  ***********************************************************/
 void SceneManager::SetTextureUVScale(float u, float v)
 {
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setVec2Value("UVscale", glm::vec2(u, v));
-	}
+	m_currentDraw.uvScale = glm::vec2(u, v);
 }
 
 /***********************************************************
  *  SetShaderMaterial()
  *
  *  This method is used for passing the material values
- *  into the shader.
+ *  into the draw state.
  ***********************************************************/
 void SceneManager::SetShaderMaterial(
 	std::string materialTag)
 {
-	if (m_objectMaterials.size() > 0)
+	int materialIndex = FindMaterialIndex(materialTag);
+	if (materialIndex >= 0)
 	{
-		OBJECT_MATERIAL material;
-		bool bReturn = false;
-
-		bReturn = FindMaterial(materialTag, material);
-		if (bReturn == true)
-		{
-			m_pShaderManager->setVec3Value("material.ambientColor", material.ambientColor);
-			m_pShaderManager->setFloatValue("material.ambientStrength", material.ambientStrength);
-			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
-			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
-			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
-		}
+		m_currentDraw.materialIndex = materialIndex;
 	}
 }
 
-/**************************************************************/
-/*** The code in the methods BELOW is for preparing and     ***/
-/*** rendering the 3D replicated scenes.                    ***/
-/**************************************************************/
-
 /***********************************************************
- *  LoadSceneTextures()
+ *  DrawMesh()
  *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene
- *  rendering
+ *  This method is used for recording a draw of the passed in
+ *  shape mesh with the current transform, color, texture and
+ *  material.  The parts select the caps and sides of the
+ *  meshes that have them.
  ***********************************************************/
-void SceneManager::LoadSceneTextures()
+void SceneManager::DrawMesh(MESH_TYPE mesh, unsigned int parts)
 {
-	bool bReturn = false;
-
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/rusticwood.jpg",
-		"table");
-
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/cheese_wheel.jpg",
-		"cheese_wheel_side");
-
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/cheese_top.jpg",
-		"cheese_wheel_top");
+	m_currentDraw.mesh = mesh;
+	m_currentDraw.parts = parts;
+	ResolveTextureSampler(m_currentDraw);
+	m_drawList.push_back(m_currentDraw);
 
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/breadcrust.jpg",
-		"breadcrust");
-
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/backdrop.jpg",
-		"backdrop");
-
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/knife_handle.jpg",
-		"knifehandle");
-
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/stainless.jpg",
-		"stainless");
-
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/cheddar.jpg",
-		"cheddar");
-
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/circular-brushed-gold-texture.jpg",
-		"knifescrew");
+	if (m_bRecordTransforms == true)
+	{
+		m_recordedScales.push_back(m_currentScale);
+		m_recordedRotations.push_back(m_currentRotation);
+		m_recordedPositions.push_back(m_currentPosition);
+	}
 
-	// after the texture image data is loaded into memory, the
-	// loaded textures need to be bound to texture slots - there
-	// are a total of 16 available slots for scene textures
-	BindGLTextures();
+	if (m_bRecordEntities == true)
+	{
+		SceneEntities::ENTITY_DESC desc;
+		desc.mesh = mesh;
+		desc.parts = parts;
+		desc.position = m_currentPosition;
+		desc.rotation = m_currentRotation;
+		desc.scale = m_currentScale;
+		desc.color = m_currentDraw.color;
+		desc.materialIndex = m_currentDraw.materialIndex;
+		desc.bUseTexture = m_currentDraw.bUseTexture;
+		desc.textureSlot = m_currentDraw.textureSlot;
+		desc.uvScale = m_currentDraw.uvScale;
+		desc.samplerFilter = m_currentDraw.samplerFilter;
+		desc.samplerWrap = m_currentDraw.samplerWrap;
+		m_pSceneEntities->CreateEntity(desc);
+	}
 }
 
 /***********************************************************
- *  DefineObjectMaterials()
+ *  GetDrawList()
  *
- *  This method is used for configuring the various material
- *  settings for all of the objects within the 3D scene.
+ *  This method is used for getting the draws recorded by the
+ *  last call to BuildDrawList().
+ ***********************************************************/
+const std::vector<SceneManager::DRAW_COMMAND>& SceneManager::GetDrawList() const
+{
+	return(m_drawList);
+}
+
+/***********************************************************
+ *  GetObjectMaterials()
+ *
+ *  This method is used for getting the defined materials,
+ *  which the material index of each draw refers to.
+ ***********************************************************/
+const std::vector<SceneManager::OBJECT_MATERIAL>& SceneManager::GetObjectMaterials() const
+{
+	return(m_objectMaterials);
+}
+
+/***********************************************************
+ *  GetLightSources()
+ *
+ *  This method is used for getting the defined light sources.
+ ***********************************************************/
+const std::vector<SceneManager::LIGHT_SOURCE>& SceneManager::GetLightSources() const
+{
+	return(m_lightSources);
+}
+
+/***********************************************************
+ *  SetRenderDevice()
+ *
+ *  This method is used for drawing the scene through another
+ *  render device, which the scene manager then owns.  It is
+ *  set before PrepareScene() so the device can create the
+ *  meshes and textures of the scene.
+ ***********************************************************/
+void SceneManager::SetRenderDevice(RenderDevice* pRenderDevice)
+{
+	if (m_pRenderDevice == pRenderDevice)
+	{
+		return;
+	}
+	if (NULL != m_pRenderDevice)
+	{
+		delete m_pRenderDevice;
+	}
+	m_pRenderDevice = pRenderDevice;
+}
+
+/***********************************************************
+ *  GetRenderDevice()
+ *
+ *  This method is used for getting the device the scene is
+ *  drawn through, or NULL when there is none.
+ ***********************************************************/
+RenderDevice* SceneManager::GetRenderDevice() const
+{
+	return(m_pRenderDevice);
+}
+
+/**************************************************************/
+/*** The code in the methods BELOW is for preparing and     ***/
+/*** rendering the 3D replicated scenes.                    ***/
+/**************************************************************/
+
+/***********************************************************
+ *  LoadSceneTextures()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene
+ *  rendering
+ ***********************************************************/
+void SceneManager::LoadSceneTextures()
+{
+	const int textureCount = sizeof(g_SceneTextures) / sizeof(g_SceneTextures[0]);
+
+	// pick the texture resolution cap for this device
+	if (NULL != m_pShaderManager)
+	{
+		m_pTextureBudget->QueryDeviceLimits();
+	}
+
+	// read all of the texture image files from disk as one
+	// batch before any of them are decoded
+	for (int i = 0; i < textureCount; i++)
+	{
+		// generated textures do not need their image file
+		if (FindProceduralPattern(g_SceneTextures[i].tag) < 0)
+		{
+			// read the uncompressed cache instead when there is one
+			// made from the image file as it is now
+			std::string filename = g_SceneTextures[i].filename;
+			std::string cachePath = GetTextureCachePath(g_SceneTextures[i].filename);
+			if ((m_bRawTextureCache == true) &&
+				RawImageDecoder::IsCacheCurrent(cachePath.c_str(), g_SceneTextures[i].filename))
+			{
+				filename = cachePath;
+			}
+
+			m_pAssetLoader->QueueRead(
+				filename.c_str(),
+				g_SceneTextures[i].tag);
+		}
+	}
+	m_pAssetLoader->SubmitReads();
+
+	for (int i = 0; i < textureCount; i++)
+	{
+		int patternIndex = FindProceduralPattern(g_SceneTextures[i].tag);
+		if (patternIndex >= 0)
+		{
+			CreateProceduralTexture(
+				g_SceneProceduralTextures[patternIndex].settings,
+				g_SceneTextures[i].tag);
+		}
+		else
+		{
+			CreateGLTexture(
+				g_SceneTextures[i].filename,
+				g_SceneTextures[i].tag);
+		}
+	}
+
+	// the file data is no longer needed after decoding
+	m_pAssetLoader->ReleaseAssets();
+	m_pTextureBudget->ReportTotals();
+
+	// textures kept in memory have nothing to bind
+	if (NULL == m_pShaderManager)
+	{
+		return;
+	}
+
+	// sRGB textures are read back as linear colors, so the
+	// lit colors are turned back to sRGB when written
+	if (m_pTextureBudget->GetUseSRGB() == true)
+	{
+		glEnable(GL_FRAMEBUFFER_SRGB);
+	}
+
+	// create the shared sampler objects used by the textures
+	m_pTextureSamplers->CreateSamplers();
+
+	// after the texture image data is loaded into memory, the
+	// loaded textures need to be bound to texture slots - there
+	// are a total of 16 available slots for scene textures
+	BindGLTextures();
+}
+
+/***********************************************************
+ *  DefineObjectMaterials()
+ *
+ *  This method is used for configuring the various material
+ *  settings for all of the objects within the 3D scene.
  ***********************************************************/
 void SceneManager::DefineObjectMaterials()
 {
@@ -452,6 +1195,7 @@ void SceneManager::DefineObjectMaterials()
 	goldMaterial.diffuseColor = glm::vec3(0.2f, 0.2f, 0.2f);
 	goldMaterial.specularColor = glm::vec3(0.5f, 0.5f, 0.5f);
 	goldMaterial.shininess = 22.0;
+	goldMaterial.samplerFilter = -1;
 	goldMaterial.tag = "metal";
 
 	m_objectMaterials.push_back(goldMaterial);
@@ -462,6 +1206,8 @@ void SceneManager::DefineObjectMaterials()
 	woodMaterial.diffuseColor = glm::vec3(0.3f, 0.3f, 0.3f);
 	woodMaterial.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
 	woodMaterial.shininess = 0.3;
+	// the table top is seen at grazing angles
+	woodMaterial.samplerFilter = TextureSamplers::FILTER_ANISOTROPIC_16X;
 	woodMaterial.tag = "wood";
 
 	m_objectMaterials.push_back(woodMaterial);
@@ -472,6 +1218,7 @@ void SceneManager::DefineObjectMaterials()
 	glassMaterial.diffuseColor = glm::vec3(0.3f, 0.3f, 0.3f);
 	glassMaterial.specularColor = glm::vec3(0.6f, 0.6f, 0.6f);
 	glassMaterial.shininess = 85.0;
+	glassMaterial.samplerFilter = -1;
 	glassMaterial.tag = "glass";
 
 	m_objectMaterials.push_back(glassMaterial);
@@ -482,6 +1229,7 @@ void SceneManager::DefineObjectMaterials()
 	cheeseMaterial.diffuseColor = glm::vec3(0.5f, 0.5f, 0.5f);
 	cheeseMaterial.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
 	cheeseMaterial.shininess = 0.3;
+	cheeseMaterial.samplerFilter = -1;
 	cheeseMaterial.tag = "cheese";
 
 	m_objectMaterials.push_back(cheeseMaterial);
@@ -493,6 +1241,7 @@ void SceneManager::DefineObjectMaterials()
 	backdropMaterial.diffuseColor = glm::vec3(0.6f, 0.5f, 0.1f);
 	backdropMaterial.specularColor = glm::vec3(0.0f, 0.0f, 0.0f);
 	backdropMaterial.shininess = 0.0;
+	backdropMaterial.samplerFilter = -1;
 	backdropMaterial.tag = "backdrop";
 
 	m_objectMaterials.push_back(backdropMaterial);
@@ -502,38 +1251,45 @@ void SceneManager::DefineObjectMaterials()
 /***********************************************************
  *  SetupSceneLights()
  *
- *
+ *  This method is used for defining the light sources of the
+ *  3D scene and passing them to the render device.
  ***********************************************************/
 void SceneManager::SetupSceneLights()
 {
-	// this line of code is NEEDED for telling the shaders to render 
-	// the 3D scene with custom lighting - to use the default rendered 
-	// lighting then comment out the following line
-	m_pShaderManager->setBoolValue(g_UseLightingName, true);
+	LIGHT_SOURCE light;
+	m_lightSources.clear();
 
 	// Main key light (bright overhead light simulating sun)
-	m_pShaderManager->setVec3Value("lightSources[0].position", -2.0f, 8.0f, 6.0f);
-	m_pShaderManager->setVec3Value("lightSources[0].ambientColor", 0.4f, 0.4f, 0.4f);
-	m_pShaderManager->setVec3Value("lightSources[0].diffuseColor", 1.2f, 1.2f, 1.0f);
-	m_pShaderManager->setVec3Value("lightSources[0].specularColor", 0.8f, 0.8f, 0.8f);
-	m_pShaderManager->setFloatValue("lightSources[0].focalStrength", 16.0f);
-	m_pShaderManager->setFloatValue("lightSources[0].specularIntensity", 0.6f);
+	light.position = glm::vec3(-2.0f, 8.0f, 6.0f);
+	light.ambientColor = glm::vec3(0.4f, 0.4f, 0.4f);
+	light.diffuseColor = glm::vec3(1.2f, 1.2f, 1.0f);
+	light.specularColor = glm::vec3(0.8f, 0.8f, 0.8f);
+	light.focalStrength = 16.0f;
+	light.specularIntensity = 0.6f;
+	m_lightSources.push_back(light);
 
 	// Secondary fill light (softer light from opposite side)
-	m_pShaderManager->setVec3Value("lightSources[1].position", 4.0f, 6.0f, 8.0f);
-	m_pShaderManager->setVec3Value("lightSources[1].ambientColor", 0.3f, 0.3f, 0.3f);
-	m_pShaderManager->setVec3Value("lightSources[1].diffuseColor", 0.8f, 0.8f, 0.9f);
-	m_pShaderManager->setVec3Value("lightSources[1].specularColor", 0.5f, 0.5f, 0.6f);
-	m_pShaderManager->setFloatValue("lightSources[1].focalStrength", 20.0f);
-	m_pShaderManager->setFloatValue("lightSources[1].specularIntensity", 0.4f);
+	light.position = glm::vec3(4.0f, 6.0f, 8.0f);
+	light.ambientColor = glm::vec3(0.3f, 0.3f, 0.3f);
+	light.diffuseColor = glm::vec3(0.8f, 0.8f, 0.9f);
+	light.specularColor = glm::vec3(0.5f, 0.5f, 0.6f);
+	light.focalStrength = 20.0f;
+	light.specularIntensity = 0.4f;
+	m_lightSources.push_back(light);
 
 	// Bright ambient/background light (simulates daylight bouncing around)
-	m_pShaderManager->setVec3Value("lightSources[2].position", 0.0f, 10.0f, 15.0f);
-	m_pShaderManager->setVec3Value("lightSources[2].ambientColor", 0.8f, 0.8f, 0.8f);
-	m_pShaderManager->setVec3Value("lightSources[2].diffuseColor", 2.0f, 2.0f, 1.8f);
-	m_pShaderManager->setVec3Value("lightSources[2].specularColor", 0.3f, 0.3f, 0.3f);
-	m_pShaderManager->setFloatValue("lightSources[2].focalStrength", 8.0f);
-	m_pShaderManager->setFloatValue("lightSources[2].specularIntensity", 0.3f);
+	light.position = glm::vec3(0.0f, 10.0f, 15.0f);
+	light.ambientColor = glm::vec3(0.8f, 0.8f, 0.8f);
+	light.diffuseColor = glm::vec3(2.0f, 2.0f, 1.8f);
+	light.specularColor = glm::vec3(0.3f, 0.3f, 0.3f);
+	light.focalStrength = 8.0f;
+	light.specularIntensity = 0.3f;
+	m_lightSources.push_back(light);
+
+	if (NULL != m_pRenderDevice)
+	{
+		m_pRenderDevice->SetLights(m_lightSources);
+	}
 }
 
 /***********************************************************
@@ -554,19 +1310,33 @@ void SceneManager::PrepareScene()
 	// add and defile the light sources for the 3D scene
 	SetupSceneLights();
 
-	// only one instance of a particular mesh needs to be
-	// loaded in memory no matter how many times it is drawn
-	// in the rendered 3D scene
-
-	m_basicMeshes->LoadBoxMesh();
-	m_basicMeshes->LoadPlaneMesh();
-	m_basicMeshes->LoadCylinderMesh();
-	m_basicMeshes->LoadConeMesh();
-	m_basicMeshes->LoadPrismMesh();
-	m_basicMeshes->LoadPyramid4Mesh();
-	m_basicMeshes->LoadSphereMesh();
-	m_basicMeshes->LoadTaperedCylinderMesh();
-	m_basicMeshes->LoadTorusMesh();
+	// the render device creates its copies of the meshes and
+	// textures, while the software renderers build their own
+	if (NULL != m_pRenderDevice)
+	{
+		m_pRenderDevice->LoadScene(this);
+	}
+	if (m_bStressScene == true)
+	{
+		GenerateStressScene(m_stressSettings);
+	}
+	else if (m_bStreamWorld == true)
+	{
+		OpenStreamedWorld();
+	}
+	else if (m_bEntityScene == true)
+	{
+		CreateSceneEntities();
+	}
+	if (m_bAnimateScene == true)
+	{
+		CreateSceneAnimation();
+	}
+	if (m_dustBudget > 0)
+	{
+		CreateParticleEffects();
+	}
+	InvalidateDrawLists();
 }
 
 /***********************************************************
@@ -576,6 +1346,1147 @@ void SceneManager::PrepareScene()
  *  transforming and drawing the basic 3D shapes
  ***********************************************************/
 void SceneManager::RenderScene()
+{
+	// the entity scene culls its entities against the camera
+	// every frame instead of keeping lists for the presets
+	if (NULL != m_pSceneEntities)
+	{
+		m_pSceneEntities->UpdateTransforms();
+		if (m_bSceneCamera == true)
+		{
+			m_pSceneEntities->CullEntities(m_sceneProjection * m_sceneView);
+			m_bSceneCamera = false;
+		}
+		else
+		{
+			m_pSceneEntities->ShowAllEntities();
+		}
+		m_drawList.clear();
+		m_pSceneEntities->BuildDrawList(m_drawList);
+		for (size_t i = 0; i < m_drawList.size(); i++)
+		{
+			ResolveTextureSampler(m_drawList[i]);
+		}
+		if (NULL != m_pRenderDevice)
+		{
+			m_pRenderDevice->SubmitDraws(m_drawList, m_objectMaterials);
+		}
+		return;
+	}
+
+	// a preset camera reuses its culled and sorted draw list
+	// until the scene changes, so switching to it is cheap
+	int presetView = -1;
+	if (m_bSceneCamera == true)
+	{
+		presetView = m_pDrawListCache->FindView(m_sceneView, m_sceneProjection);
+		m_bSceneCamera = false;
+	}
+	if (presetView >= 0)
+	{
+		const std::vector<DRAW_COMMAND>* pDraws = m_pDrawListCache->GetDrawList(presetView, m_sceneRevision);
+		if (NULL == pDraws)
+		{
+			BuildDrawList();
+			pDraws = &m_pDrawListCache->StoreDrawList(presetView, m_sceneRevision, m_drawList);
+		}
+		if (NULL != m_pRenderDevice)
+		{
+			m_pRenderDevice->SubmitDraws(*pDraws, m_objectMaterials);
+		}
+		return;
+	}
+
+	BuildDrawList();
+	if (NULL != m_pRenderDevice)
+	{
+		m_pRenderDevice->SubmitDraws(m_drawList, m_objectMaterials);
+	}
+}
+
+/***********************************************************
+ *  RegisterPresetView()
+ *
+ *  This method is used for registering a camera that never
+ *  moves.  When RenderScene() draws from it, the draw list is
+ *  culled and sorted once and then reused every frame until
+ *  the scene changes.
+ ***********************************************************/
+int SceneManager::RegisterPresetView(const glm::mat4& view, const glm::mat4& projection)
+{
+	return(m_pDrawListCache->RegisterView(view, projection));
+}
+
+/***********************************************************
+ *  SetSceneCamera()
+ *
+ *  This method is used for telling the next RenderScene()
+ *  call which camera it draws from, so it can use the kept
+ *  draw list of a preset camera.  It only applies to that
+ *  one call, and other calls draw the full draw list.
+ ***********************************************************/
+void SceneManager::SetSceneCamera(const glm::mat4& view, const glm::mat4& projection)
+{
+	m_sceneView = view;
+	m_sceneProjection = projection;
+	m_bSceneCamera = true;
+}
+
+/***********************************************************
+ *  InvalidateDrawLists()
+ *
+ *  This method is used for marking the kept draw lists as
+ *  out of date after anything they were made from changes.
+ ***********************************************************/
+void SceneManager::InvalidateDrawLists()
+{
+	m_sceneRevision++;
+}
+
+/***********************************************************
+ *  GetDrawListCache()
+ *
+ *  This method is used for getting the draw lists kept for
+ *  the preset cameras, such as for their statistics.
+ ***********************************************************/
+const DrawListCache* SceneManager::GetDrawListCache() const
+{
+	return(m_pDrawListCache);
+}
+
+/***********************************************************
+ *  SetEntityScene()
+ *
+ *  This method is used for drawing the scene objects from
+ *  entities created once when the scene is prepared, instead
+ *  of recording their draws again every frame.
+ ***********************************************************/
+void SceneManager::SetEntityScene(bool bEnabled)
+{
+	m_bEntityScene = bEnabled;
+}
+
+/***********************************************************
+ *  GetSceneEntities()
+ *
+ *  This method is used for getting the entities the scene
+ *  objects are drawn from, or NULL when there are none.
+ ***********************************************************/
+SceneEntities* SceneManager::GetSceneEntities() const
+{
+	return(m_pSceneEntities);
+}
+
+/***********************************************************
+ *  PlacePrefab()
+ *
+ *  This method is used for placing another instance of one
+ *  of the scene prefabs, which turns on the entity scene.
+ ***********************************************************/
+void SceneManager::PlacePrefab(const PREFAB_PLACEMENT& placement)
+{
+	m_prefabPlacements.push_back(placement);
+	m_bEntityScene = true;
+}
+
+/***********************************************************
+ *  SetStressScene()
+ *
+ *  This method is used for preparing a generated scene of
+ *  props instead of the scene objects, for measuring how the
+ *  frame time grows with the number of objects.
+ ***********************************************************/
+void SceneManager::SetStressScene(const StressSceneGenerator::STRESS_SETTINGS& settings)
+{
+	m_stressSettings = settings;
+	m_bStressScene = true;
+	m_bEntityScene = true;
+}
+
+/***********************************************************
+ *  GenerateStressScene()
+ *
+ *  This method is used for replacing the entities with a
+ *  generated scene of props, made from the shape meshes and
+ *  the materials and textures already prepared.
+ ***********************************************************/
+void SceneManager::GenerateStressScene(const StressSceneGenerator::STRESS_SETTINGS& settings)
+{
+	CreateEntityStore();
+
+	StressSceneGenerator generator;
+	generator.Generate(settings, (int)m_objectMaterials.size(), m_loadedTextures, m_pSceneEntities);
+	m_pSceneEntities->UpdateTransforms();
+	InvalidateDrawLists();
+
+	const SceneEntities::ENTITY_STATS& stats = m_pSceneEntities->GetStats();
+	std::cout << "INFO: generated " << stats.entities << " props in "
+		<< stats.chunks << " chunks from seed " << settings.seed << ", with "
+		<< m_pSceneEntities->GetTransformSize() << " byte transforms" << std::endl;
+}
+
+/***********************************************************
+ *  CreateSceneEntities()
+ *
+ *  This method is used for creating an entity for every draw
+ *  the scene objects record, keeping the transformation
+ *  values it was made from so the entity can be moved later.
+ *  The book, wine glass and wine bottle are assemblies of
+ *  several draws, so each one becomes a prefab instead, and
+ *  is placed where it was authored along with any extra
+ *  placements.
+ ***********************************************************/
+void SceneManager::CreateSceneEntities()
+{
+	CreateEntityStore();
+	m_pSceneEntities->Clear();
+
+	m_bRecordEntities = true;
+	m_drawList.clear();
+	RenderTable();
+	RenderBackdrop();
+	RenderCheeseWheel();
+	m_bRecordEntities = false;
+
+	CreateScenePrefab(g_ShowroomPrefabs[2].name, &SceneManager::RenderBook, g_ShowroomPrefabs[2].origin);
+	CreateScenePrefab(g_ShowroomPrefabs[3].name, &SceneManager::RenderWineGlass, g_ShowroomPrefabs[3].origin);
+	CreateScenePrefab(g_ShowroomPrefabs[4].name, &SceneManager::RenderWineBottle, g_ShowroomPrefabs[4].origin);
+	m_drawList.clear();
+
+	for (size_t i = 0; i < m_prefabPlacements.size(); i++)
+	{
+		const PREFAB_PLACEMENT& placement = m_prefabPlacements[i];
+		SceneEntities::PREFAB_INSTANCE instance;
+		instance.position = placement.position;
+		instance.rotation = glm::vec3(0.0f, placement.yawDegrees, 0.0f);
+		instance.scale = glm::vec3(placement.scale);
+		instance.materialOverride = -1;
+		if (placement.materialTag.empty() == false)
+		{
+			instance.materialOverride = FindMaterialIndex(placement.materialTag);
+		}
+		instance.bColorOverride = false;
+		instance.colorOverride = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+
+		int prefab = m_pSceneEntities->FindPrefab(placement.prefab);
+		if (m_pSceneEntities->InstantiatePrefab(prefab, instance) == SceneEntities::INVALID_ENTITY)
+		{
+			std::cout << "No scene prefab named:" << placement.prefab << std::endl;
+		}
+	}
+	m_pSceneEntities->UpdateTransforms();
+
+	const SceneEntities::ENTITY_STATS& stats = m_pSceneEntities->GetStats();
+	std::cout << "INFO: created " << stats.entities << " scene entities in "
+		<< stats.archetypes << " archetypes, with " << stats.prefabs << " prefabs of "
+		<< stats.prefabParts << " shared parts" << std::endl;
+}
+
+/***********************************************************
+ *  CreateScenePrefab()
+ *
+ *  This method is used for making a prefab of one scene
+ *  object and placing one instance at the passed in origin,
+ *  so the scene looks as it was authored.
+ ***********************************************************/
+void SceneManager::CreateScenePrefab(const char* name, void (SceneManager::*renderObject)(), glm::vec3 origin)
+{
+	int prefab = DefineScenePrefab(name, renderObject, origin);
+
+	SceneEntities::PREFAB_INSTANCE instance;
+	instance.position = origin;
+	instance.rotation = glm::vec3(0.0f, 0.0f, 0.0f);
+	instance.scale = glm::vec3(1.0f, 1.0f, 1.0f);
+	instance.materialOverride = -1;
+	instance.bColorOverride = false;
+	instance.colorOverride = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+	m_pSceneEntities->InstantiatePrefab(prefab, instance);
+}
+
+/***********************************************************
+ *  DefineScenePrefab()
+ *
+ *  This method is used for recording the draws of one scene
+ *  object as the parts of a prefab.  The object's absolute
+ *  transforms are moved into the prefab's local space around
+ *  the passed in origin.
+ ***********************************************************/
+int SceneManager::DefineScenePrefab(const char* name, void (SceneManager::*renderObject)(), glm::vec3 origin)
+{
+	m_drawList.clear();
+	(this->*renderObject)();
+
+	glm::mat4 toLocal = glm::translate(-origin);
+	std::vector<SceneEntities::PREFAB_PART> parts(m_drawList.size());
+	for (size_t i = 0; i < m_drawList.size(); i++)
+	{
+		const DRAW_COMMAND& draw = m_drawList[i];
+		parts[i].mesh = draw.mesh;
+		parts[i].parts = draw.parts;
+		parts[i].local = toLocal * draw.model;
+		parts[i].color = draw.color;
+		parts[i].materialIndex = draw.materialIndex;
+		parts[i].bUseTexture = draw.bUseTexture;
+		parts[i].textureSlot = draw.textureSlot;
+		parts[i].uvScale = draw.uvScale;
+		parts[i].samplerFilter = draw.samplerFilter;
+		parts[i].samplerWrap = draw.samplerWrap;
+	}
+
+	return(m_pSceneEntities->DefinePrefab(name, parts));
+}
+
+/***********************************************************
+ *  SetStreamWorld()
+ *
+ *  This method is used for streaming a showroom world of
+ *  tables around the camera instead of the scene objects.
+ ***********************************************************/
+void SceneManager::SetStreamWorld(const WorldStreamer::WORLD_SETTINGS& settings)
+{
+	m_worldSettings = settings;
+	m_bStreamWorld = true;
+	m_bEntityScene = true;
+}
+
+/***********************************************************
+ *  OpenStreamedWorld()
+ *
+ *  This method is used for defining the prefabs that the
+ *  cells of a showroom world place, without placing any, and
+ *  opening the world.  Its cells are placed as the camera
+ *  comes near them.
+ ***********************************************************/
+void SceneManager::OpenStreamedWorld()
+{
+	CreateEntityStore();
+	m_pSceneEntities->Clear();
+
+	DefineScenePrefab(g_ShowroomPrefabs[0].name, &SceneManager::RenderTable, g_ShowroomPrefabs[0].origin);
+	DefineScenePrefab(g_ShowroomPrefabs[1].name, &SceneManager::RenderCheeseWheel, g_ShowroomPrefabs[1].origin);
+	DefineScenePrefab(g_ShowroomPrefabs[2].name, &SceneManager::RenderBook, g_ShowroomPrefabs[2].origin);
+	DefineScenePrefab(g_ShowroomPrefabs[3].name, &SceneManager::RenderWineGlass, g_ShowroomPrefabs[3].origin);
+	DefineScenePrefab(g_ShowroomPrefabs[4].name, &SceneManager::RenderWineBottle, g_ShowroomPrefabs[4].origin);
+	m_drawList.clear();
+
+	if (NULL == m_pWorldStreamer)
+	{
+		m_pWorldStreamer = new WorldStreamer();
+	}
+	m_pWorldStreamer->Open(m_worldSettings, m_pSceneEntities);
+}
+
+/***********************************************************
+ *  UpdateWorldStreaming()
+ *
+ *  This method is used once a frame for streaming the cells
+ *  of the world around the camera, marking the kept draw
+ *  lists out of date when cells were placed or removed.
+ ***********************************************************/
+bool SceneManager::UpdateWorldStreaming(const glm::vec3& cameraPosition, bool bFinishLoads)
+{
+	if ((NULL == m_pWorldStreamer) || (NULL == m_pSceneEntities))
+	{
+		return(false);
+	}
+
+	bool bChanged = m_pWorldStreamer->Update(cameraPosition, m_pSceneEntities, bFinishLoads);
+	if (bChanged == true)
+	{
+		InvalidateDrawLists();
+	}
+	return(bChanged);
+}
+
+/***********************************************************
+ *  GetWorldStreamer()
+ *
+ *  This method is used for getting the streamed world, such
+ *  as for its statistics, or NULL when there is none.
+ ***********************************************************/
+WorldStreamer* SceneManager::GetWorldStreamer() const
+{
+	return(m_pWorldStreamer);
+}
+
+/***********************************************************
+ *  WriteShowroomWorld()
+ *
+ *  This method is used for writing a world of tables set out
+ *  like the scene, centered on the origin with one table to
+ *  a cell.  Each table is turned a quarter turn at a time and
+ *  some leave off the book, wine glass or wine bottle, picked
+ *  from the cell's place so the same world is always written.
+ ***********************************************************/
+bool SceneManager::WriteShowroomWorld(const char* directory, int columns, int rows)
+{
+	const int prefabCount = sizeof(g_ShowroomPrefabs) / sizeof(g_ShowroomPrefabs[0]);
+	std::vector<std::string> prefabNames;
+	for (int i = 0; i < prefabCount; i++)
+	{
+		prefabNames.push_back(g_ShowroomPrefabs[i].name);
+	}
+
+	if ((columns <= 0) || (rows <= 0) ||
+		(WorldStreamer::WriteWorld(directory, columns, rows, g_ShowroomCellSize, prefabNames) == false))
+	{
+		std::cout << "ERROR: could not write a world to " << directory << std::endl;
+		return(false);
+	}
+
+	std::vector<WorldStreamer::CELL_INSTANCE> instances;
+	for (int row = 0; row < rows; row++)
+	{
+		for (int column = 0; column < columns; column++)
+		{
+			unsigned int hash = ((unsigned int)column * 73856093u) ^ ((unsigned int)row * 19349663u);
+			float yawDegrees = (float)((hash >> 4) % 4) * 90.0f;
+			glm::mat4 turn = glm::rotate(glm::radians(yawDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
+			glm::vec3 center = WorldStreamer::GetCellCenter(columns, rows, g_ShowroomCellSize, column, row);
+
+			instances.clear();
+			for (int i = 0; i < prefabCount; i++)
+			{
+				// the table and cheese wheel are on every table
+				if ((i >= 2) && (((hash >> (8 + 2 * i)) & 3) == 0))
+				{
+					continue;
+				}
+				WorldStreamer::CELL_INSTANCE instance;
+				instance.prefab = i;
+				instance.position = center + glm::vec3(turn * glm::vec4(g_ShowroomPrefabs[i].origin, 1.0f));
+				instance.yawDegrees = yawDegrees;
+				instance.scale = 1.0f;
+				instances.push_back(instance);
+			}
+
+			if (WorldStreamer::WriteCell(directory, column, row, instances) == false)
+			{
+				std::cout << "ERROR: could not write world cell " << column << "," << row << std::endl;
+				return(false);
+			}
+		}
+	}
+
+	std::cout << "INFO: wrote a " << columns << "x" << rows << " showroom world to " << directory << std::endl;
+	return(true);
+}
+
+/***********************************************************
+ *  CreateEntityStore()
+ *
+ *  This method is used for creating the entities of the
+ *  scene when there are none yet.
+ ***********************************************************/
+void SceneManager::CreateEntityStore()
+{
+	if (NULL == m_pSceneEntities)
+	{
+		m_pSceneEntities = new SceneEntities();
+		m_pSceneEntities->SetCompactTransforms(m_bCompactTransforms, m_compactCellSize);
+	}
+}
+
+/***********************************************************
+ *  SetCompactTransforms()
+ *
+ *  This method is used for keeping the transforms of the
+ *  entity scene packed into 16 bytes each, relative to a grid
+ *  of cells of the passed in size, so far more instances fit
+ *  in memory.  It takes effect when the entities are created.
+ ***********************************************************/
+void SceneManager::SetCompactTransforms(bool bEnabled, float cellSize)
+{
+	m_bCompactTransforms = bEnabled;
+	if (cellSize > 0.0f)
+	{
+		m_compactCellSize = cellSize;
+	}
+}
+
+/***********************************************************
+ *  ReportTransformPrecision()
+ *
+ *  This method is used for packing the transformation values
+ *  of every draw of the scene objects and comparing them
+ *  with the matrices SetTransformations() made for the same
+ *  draws.  The scene transforms are then repeated across a
+ *  large grid and packed again, both four at a time and one
+ *  at a time, to show the cost of packing many instances.
+ ***********************************************************/
+void SceneManager::ReportTransformPrecision(float cellSize)
+{
+	const int batchSize = 1000000;
+
+	m_recordedScales.clear();
+	m_recordedRotations.clear();
+	m_recordedPositions.clear();
+	m_bRecordTransforms = true;
+	m_drawList.clear();
+	RecordSceneObjects();
+	m_bRecordTransforms = false;
+
+	int count = (int)m_drawList.size();
+	if (count == 0)
+	{
+		std::cout << "ERROR: the scene recorded no draws to pack" << std::endl;
+		return;
+	}
+
+	std::vector<glm::quat> rotations(count);
+	std::vector<glm::mat4> matrices(count);
+	for (int i = 0; i < count; i++)
+	{
+		rotations[i] = TransformQuantizer::GetEulerRotation(m_recordedRotations[i]);
+		matrices[i] = m_drawList[i].model;
+	}
+	m_drawList.clear();
+
+	TransformQuantizer quantizer;
+	quantizer.SetCellSize(cellSize);
+	std::vector<TransformQuantizer::PACKED_TRANSFORM> packed(count);
+	quantizer.EncodeTransforms(count, &m_recordedPositions[0], &rotations[0], &m_recordedScales[0], &packed[0]);
+
+	TransformQuantizer::PRECISION_REPORT report;
+	quantizer.MeasurePrecision(count, &m_recordedPositions[0], &rotations[0], &m_recordedScales[0],
+		&matrices[0], &packed[0], report);
+	std::cout << "INFO: packed " << report.transforms << " scene transforms into "
+		<< sizeof(TransformQuantizer::PACKED_TRANSFORM) << " bytes each, with cells of "
+		<< quantizer.GetCellSize() << std::endl;
+	std::cout << "INFO: position error max " << report.maxPositionError << " mean " << report.meanPositionError
+		<< ", rotation error max " << report.maxRotationDegrees << " degrees, scale error max "
+		<< report.maxScaleError << ", matrix error max " << report.maxMatrixError << std::endl;
+	std::cout << "INFO: " << report.sharedScales << " shared scales, " << report.roundedScales
+		<< " rounded scales, " << report.clampedPositions << " positions outside the cells" << std::endl;
+
+	// spread copies of the scene transforms over a square grid
+	// filling the cells that can be stored
+	int side = (int)std::ceil(std::sqrt((double)batchSize));
+	float spacing = quantizer.GetCellSize() * 254.0f / side;
+	std::vector<glm::vec3> positions(batchSize);
+	std::vector<glm::quat> batchRotations(batchSize);
+	std::vector<glm::vec3> scales(batchSize);
+	for (int i = 0; i < batchSize; i++)
+	{
+		glm::vec3 offset = glm::vec3((i % side - side / 2) * spacing, 0.0f, (i / side - side / 2) * spacing);
+		positions[i] = m_recordedPositions[i % count] + offset;
+		batchRotations[i] = rotations[i % count];
+		scales[i] = m_recordedScales[i % count];
+	}
+
+	std::vector<TransformQuantizer::PACKED_TRANSFORM> batch(batchSize);
+	TransformQuantizer batchQuantizer;
+	batchQuantizer.SetCellSize(cellSize);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	batchQuantizer.EncodeTransforms(batchSize, &positions[0], &batchRotations[0], &scales[0], &batch[0]);
+	double batchMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	TransformQuantizer singleQuantizer;
+	singleQuantizer.SetCellSize(cellSize);
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < batchSize; i++)
+	{
+		batch[i] = singleQuantizer.Encode(positions[i], batchRotations[i], scales[i]);
+	}
+	double singleMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << "INFO: packed " << batchSize << " transforms in " << batchMilliseconds
+		<< " ms four at a time and " << singleMilliseconds << " ms one at a time, "
+		<< (batchSize * sizeof(TransformQuantizer::PACKED_TRANSFORM)) / (1024 * 1024) << " MB instead of "
+		<< (batchSize * sizeof(glm::mat4)) / (1024 * 1024) << " MB of matrices" << std::endl;
+}
+
+/***********************************************************
+ *  SetSceneAnimation()
+ *
+ *  This method is used for animating the scene with keyframe
+ *  tracks.  Only entities can be moved between frames, so the
+ *  scene objects are drawn from entities as well.
+ ***********************************************************/
+void SceneManager::SetSceneAnimation(bool bEnabled)
+{
+	m_bAnimateScene = bEnabled;
+	if (bEnabled == true)
+	{
+		m_bEntityScene = true;
+	}
+}
+
+/***********************************************************
+ *  CreateSceneAnimation()
+ *
+ *  This method is used for adding the tracks of the animated
+ *  scene.  The key light circles the table and the fill light
+ *  warms and cools.  The book, wine glass and wine bottle
+ *  turn in place, the metal glints as its highlight sharpens
+ *  and fades, while every prop of a generated scene spins and
+ *  bobs at its own pace and some of them pulse in color, so
+ *  large scenes have tens of thousands of animated entities.
+ *  The cells of a streamed world come and go, so only its
+ *  lights and materials are animated.
+ ***********************************************************/
+void SceneManager::CreateSceneAnimation()
+{
+	if (NULL == m_pAnimation)
+	{
+		m_pAnimation = new AnimationSystem();
+	}
+	m_pAnimation->Clear();
+
+	std::vector<AnimationSystem::ANIMATION_KEY> keys;
+	AnimationSystem::ANIMATION_KEY key;
+	if (m_lightSources.size() >= 2)
+	{
+		const float orbitSeconds = 12.0f;
+		glm::vec3 lightPosition = m_lightSources[0].position;
+		for (int step = 0; step <= 8; step++)
+		{
+			glm::mat4 turn = glm::rotate(glm::radians(step * 45.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+			key.time = step * orbitSeconds / 8.0f;
+			key.value = glm::vec4(glm::vec3(turn * glm::vec4(lightPosition, 1.0f)), 0.0f);
+			keys.push_back(key);
+		}
+		m_pAnimation->AddTrack(AnimationSystem::CHANNEL_LIGHT_POSITION, 0, keys, true);
+
+		glm::vec3 fillColor = m_lightSources[1].diffuseColor;
+		keys.clear();
+		key.time = 0.0f;
+		key.value = glm::vec4(fillColor, 0.0f);
+		keys.push_back(key);
+		key.time = 4.0f;
+		key.value = glm::vec4(fillColor * glm::vec3(1.2f, 0.9f, 0.7f), 0.0f);
+		keys.push_back(key);
+		key.time = 8.0f;
+		key.value = glm::vec4(fillColor, 0.0f);
+		keys.push_back(key);
+		m_pAnimation->AddTrack(AnimationSystem::CHANNEL_LIGHT_DIFFUSE, 1, keys, true);
+	}
+
+	int metalIndex = FindMaterialIndex("metal");
+	if (metalIndex >= 0)
+	{
+		const OBJECT_MATERIAL& metal = m_objectMaterials[metalIndex];
+		keys.clear();
+		key.time = 0.0f;
+		key.value = glm::vec4(metal.specularColor, metal.shininess);
+		keys.push_back(key);
+		key.time = 3.0f;
+		key.value = glm::vec4(metal.specularColor * 1.5f, metal.shininess * 3.0f);
+		keys.push_back(key);
+		key.time = 6.0f;
+		key.value = glm::vec4(metal.specularColor, metal.shininess);
+		keys.push_back(key);
+		m_pAnimation->AddTrack(AnimationSystem::CHANNEL_MATERIAL_SPECULAR, metalIndex, keys, true);
+	}
+
+	if ((NULL == m_pSceneEntities) || (m_bStreamWorld == true))
+	{
+		return;
+	}
+
+	int animated = 0;
+	for (int a = 0; a < m_pSceneEntities->GetArchetypeCount(); a++)
+	{
+		const SceneEntities::ENTITY_ARCHETYPE& archetype = m_pSceneEntities->GetArchetype(a);
+		bool bPrefab = ((archetype.components & SceneEntities::COMPONENT_PREFAB) != 0);
+		if (((archetype.components & SceneEntities::COMPONENT_TRANSFORM) == 0) ||
+			((m_bStressScene == false) && (bPrefab == false)))
+		{
+			continue;
+		}
+
+		for (size_t c = 0; c < archetype.chunks.size(); c++)
+		{
+			const SceneEntities::ENTITY_CHUNK& chunk = archetype.chunks[c];
+			for (int row = 0; row < chunk.count; row++)
+			{
+				SceneEntities::ENTITY_ID entity = chunk.entities[row];
+				glm::vec3 position;
+				glm::vec3 rotation;
+				glm::vec3 scale;
+				glm::vec4 color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+				bool bColor = m_pSceneEntities->GetColor(entity, color);
+				m_pSceneEntities->GetTransform(entity, position, rotation, scale);
+				int target = m_pAnimation->AddEntityTarget(entity, position, rotation, scale, color);
+
+				// each entity keeps its own period and phase, so
+				// they do not all move together
+				float period = 4.0f + (float)(animated % 7);
+				float phase = std::fmod(animated * 0.37f, period);
+				animated++;
+
+				keys.clear();
+				key.time = phase;
+				key.value = glm::vec4(rotation, 0.0f);
+				keys.push_back(key);
+				key.time = phase + period;
+				key.value = glm::vec4(rotation + glm::vec3(0.0f, 360.0f, 0.0f), 0.0f);
+				keys.push_back(key);
+				m_pAnimation->AddTrack(AnimationSystem::CHANNEL_ROTATION, target, keys, true);
+				if (m_bStressScene == false)
+				{
+					continue;
+				}
+
+				keys.clear();
+				key.time = phase;
+				key.value = glm::vec4(position, 0.0f);
+				keys.push_back(key);
+				key.time = phase + period * 0.5f;
+				key.value = glm::vec4(position + glm::vec3(0.0f, scale.y * 0.5f, 0.0f), 0.0f);
+				keys.push_back(key);
+				key.time = phase + period;
+				key.value = glm::vec4(position, 0.0f);
+				keys.push_back(key);
+				m_pAnimation->AddTrack(AnimationSystem::CHANNEL_POSITION, target, keys, true);
+
+				if ((bColor == true) && (animated % 8 == 0))
+				{
+					keys.clear();
+					key.time = phase;
+					key.value = color;
+					keys.push_back(key);
+					key.time = phase + period * 0.5f;
+					key.value = glm::vec4(glm::vec3(color) * 0.4f, color.a);
+					keys.push_back(key);
+					key.time = phase + period;
+					key.value = color;
+					keys.push_back(key);
+					m_pAnimation->AddTrack(AnimationSystem::CHANNEL_COLOR, target, keys, true);
+				}
+			}
+		}
+	}
+
+	const AnimationSystem::ANIMATION_STATS& stats = m_pAnimation->GetStats();
+	std::cout << "INFO: animating " << stats.targets << " entities, the lights and materials with "
+		<< stats.tracks << " tracks of " << stats.keys << " keys" << std::endl;
+}
+
+/***********************************************************
+ *  UpdateAnimation()
+ *
+ *  This method is used once a frame for moving the animated
+ *  entities, lights and materials to a time in seconds.  The render
+ *  device is given the lights again when they changed, and
+ *  the kept draw lists are marked out of date when entities
+ *  moved.  The particles are stepped over the time since the
+ *  last update, and a time that goes back does not step them.
+ ***********************************************************/
+void SceneManager::UpdateAnimation(double seconds)
+{
+	if (NULL != m_pParticles)
+	{
+		// the first step runs the effects for a while so the
+		// pour and dust are already flowing, and later steps
+		// are split so fast particles never jump too far, up to
+		// a second after a long stall
+		const double maxStep = 1.0 / 30.0;
+		double delta = (m_particleTime < 0.0) ? 4.0 : std::min(seconds - m_particleTime, 1.0);
+		int steps = (delta > 0.0) ? (int)std::ceil(delta / maxStep) : 0;
+		for (int i = 0; i < steps; i++)
+		{
+			m_pParticles->Update((float)(delta / steps));
+		}
+		m_particleTime = seconds;
+	}
+
+	if (NULL == m_pAnimation)
+	{
+		return;
+	}
+
+	bool bLightsChanged = m_pAnimation->Update((float)seconds, m_pSceneEntities, m_lightSources, m_objectMaterials);
+	if ((bLightsChanged == true) && (NULL != m_pRenderDevice))
+	{
+		m_pRenderDevice->SetLights(m_lightSources);
+	}
+	if (m_pAnimation->GetStats().changedTargets > 0)
+	{
+		InvalidateDrawLists();
+	}
+}
+
+/***********************************************************
+ *  GetAnimationSystem()
+ *
+ *  This method is used for getting the animation tracks, such
+ *  as for their statistics, or NULL when there are none.
+ ***********************************************************/
+const AnimationSystem* SceneManager::GetAnimationSystem() const
+{
+	return(m_pAnimation);
+}
+
+/***********************************************************
+ *  SetParticleEffects()
+ *
+ *  This method is used for adding the particle effects to the
+ *  scene, with the most dust particles that may be alive at
+ *  once.  Zero leaves the scene without particles.
+ ***********************************************************/
+void SceneManager::SetParticleEffects(int dustBudget)
+{
+	m_dustBudget = std::max(dustBudget, 0);
+}
+
+/***********************************************************
+ *  CreateParticleEffects()
+ *
+ *  This method is used for adding the emitters of the
+ *  particle effects.  Wine pours into the glass from above,
+ *  steam rises from its rim and dust drifts through the light
+ *  over the table.  Each emitter has its own budget, so the
+ *  dust can never take the particles of the pour.
+ ***********************************************************/
+void SceneManager::CreateParticleEffects()
+{
+	if (NULL == m_pParticles)
+	{
+		m_pParticles = new ParticleSystem();
+	}
+	m_pParticles->Clear();
+	m_particleTime = -1.0;
+
+	ParticleSystem::EMITTER_SETTINGS pour;
+	pour.origin = glm::vec3(6.0f, 6.5f, -1.5f);
+	pour.extent = glm::vec3(0.04f, 0.04f, 0.04f);
+	pour.velocity = glm::vec3(0.0f, -3.0f, 0.0f);
+	pour.velocityJitter = glm::vec3(0.05f, 0.1f, 0.05f);
+	pour.acceleration = glm::vec3(0.0f, -9.8f, 0.0f);
+	pour.drag = 0.0f;
+	pour.spawnRate = 6000.0f;
+	pour.lifetime = 1.5f;
+	pour.lifetimeJitter = 0.0f;
+	pour.startSize = 0.06f;
+	pour.endSize = 0.05f;
+	pour.startColor = glm::vec4(0.45f, 0.02f, 0.08f, 1.0f);
+	pour.endColor = glm::vec4(0.35f, 0.01f, 0.05f, 1.0f);
+	// the wine disappears into the wine already in the glass
+	pour.minimumHeight = 2.2f;
+	pour.budget = 20000;
+	pour.bBlended = false;
+	pour.seed = 1;
+	m_pParticles->AddEmitter(pour);
+
+	ParticleSystem::EMITTER_SETTINGS steam;
+	steam.origin = glm::vec3(6.0f, 3.6f, -1.5f);
+	steam.extent = glm::vec3(0.4f, 0.05f, 0.4f);
+	steam.velocity = glm::vec3(0.0f, 0.4f, 0.0f);
+	steam.velocityJitter = glm::vec3(0.1f, 0.1f, 0.1f);
+	steam.acceleration = glm::vec3(0.0f, 0.2f, 0.0f);
+	steam.drag = 0.3f;
+	steam.spawnRate = 400.0f;
+	steam.lifetime = 3.0f;
+	steam.lifetimeJitter = 1.0f;
+	steam.startSize = 0.15f;
+	steam.endSize = 0.6f;
+	steam.startColor = glm::vec4(0.9f, 0.9f, 0.9f, 0.25f);
+	steam.endColor = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f);
+	steam.minimumHeight = -1000.0f;
+	steam.budget = 2000;
+	steam.bBlended = true;
+	steam.seed = 2;
+	m_pParticles->AddEmitter(steam);
+
+	// the dust lives a few seconds and is spawned fast enough
+	// to keep its budget nearly full
+	ParticleSystem::EMITTER_SETTINGS dust;
+	dust.origin = glm::vec3(0.0f, 5.0f, -1.0f);
+	dust.extent = glm::vec3(14.0f, 5.0f, 7.0f);
+	dust.velocity = glm::vec3(0.0f, 0.0f, 0.0f);
+	dust.velocityJitter = glm::vec3(0.05f, 0.03f, 0.05f);
+	dust.acceleration = glm::vec3(0.0f, -0.005f, 0.0f);
+	dust.drag = 0.0f;
+	dust.lifetime = 4.0f;
+	dust.lifetimeJitter = 1.0f;
+	dust.spawnRate = (float)m_dustBudget / dust.lifetime;
+	dust.startSize = 0.02f;
+	dust.endSize = 0.02f;
+	dust.startColor = glm::vec4(1.0f, 0.95f, 0.8f, 0.6f);
+	dust.endColor = glm::vec4(1.0f, 0.95f, 0.8f, 0.0f);
+	dust.minimumHeight = 0.0f;
+	dust.budget = m_dustBudget;
+	dust.bBlended = false;
+	dust.seed = 3;
+	m_pParticles->AddEmitter(dust);
+
+	std::cout << "INFO: particle effects with budgets of " << pour.budget << " pour, "
+		<< steam.budget << " steam and " << dust.budget << " dust particles" << std::endl;
+}
+
+/***********************************************************
+ *  GetParticleSystem()
+ *
+ *  This method is used for getting the particles, such as for
+ *  building their billboards, or NULL when there are none.
+ ***********************************************************/
+ParticleSystem* SceneManager::GetParticleSystem() const
+{
+	return(m_pParticles);
+}
+
+/***********************************************************
+ *  UpdateSceneQuery()
+ *
+ *  This method is used for bringing the hierarchy over the
+ *  entity boxes up to date and getting it.  It is built the
+ *  first time, and after that it is only refit, or built
+ *  again, when the scene changed since the last query, so
+ *  many queries in a frame share one update.  Rays are
+ *  tested against the triangles they reach, for exact picks.
+ ***********************************************************/
+const SceneQuery* SceneManager::UpdateSceneQuery()
+{
+	if (NULL == m_pSceneEntities)
+	{
+		return(NULL);
+	}
+
+	if (NULL == m_pSceneQuery)
+	{
+		m_pSceneQuery = new SceneQuery();
+		m_pSceneQuery->SetExactTriangles(true);
+		m_sceneQueryRevision = m_sceneRevision - 1;
+	}
+	if (m_sceneQueryRevision != m_sceneRevision)
+	{
+		m_pSceneEntities->UpdateTransforms();
+		m_pSceneQuery->Refit(m_pSceneEntities);
+		m_sceneQueryRevision = m_sceneRevision;
+	}
+	return(m_pSceneQuery);
+}
+
+/***********************************************************
+ *  PickEntity()
+ *
+ *  This method is used for finding the closest entity along
+ *  a ray, such as the one through the cursor, within the
+ *  reach of the camera.
+ ***********************************************************/
+bool SceneManager::PickEntity(const glm::vec3& origin, const glm::vec3& direction, uint32_t& entity, float& distance)
+{
+	const SceneQuery* pSceneQuery = UpdateSceneQuery();
+	if ((NULL == pSceneQuery) || (glm::length(direction) <= 0.0f))
+	{
+		return(false);
+	}
+
+	SceneQuery::RAY_HIT hit;
+	if (pSceneQuery->Raycast(m_pSceneEntities, origin, glm::normalize(direction), g_PickDistance, hit) == false)
+	{
+		return(false);
+	}
+	entity = hit.entity;
+	distance = hit.distance;
+	return(true);
+}
+
+/***********************************************************
+ *  SetCameraCollision()
+ *
+ *  This method is used for keeping the camera out of the
+ *  scene, as a sphere of a radius inside a box.  A minimum
+ *  above the maximum takes the box from the scene, grown by
+ *  a margin, and a radius below zero turns collision off.
+ ***********************************************************/
+void SceneManager::SetCameraCollision(float radius, const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+{
+	if (radius < 0.0f)
+	{
+		if (NULL != m_pCameraCollider)
+		{
+			delete m_pCameraCollider;
+			m_pCameraCollider = NULL;
+		}
+		return;
+	}
+
+	if (NULL == m_pCameraCollider)
+	{
+		m_pCameraCollider = new CameraCollider();
+	}
+	CameraCollider::COLLIDER_SETTINGS settings = m_pCameraCollider->GetSettings();
+	settings.radius = radius;
+	settings.boundsMin = boundsMin;
+	settings.boundsMax = boundsMax;
+	m_pCameraCollider->SetSettings(settings);
+	// the grid is built again before the next move
+	m_cameraColliderRevision = m_sceneRevision - 1;
+}
+
+/***********************************************************
+ *  MoveCamera()
+ *
+ *  This method is used for moving the camera from one
+ *  position towards another, stopping and sliding along the
+ *  scene it runs into.  The grid over the scene boxes is
+ *  built again from the draw list whenever the scene has
+ *  changed since the last move.
+ ***********************************************************/
+glm::vec3 SceneManager::MoveCamera(const glm::vec3& from, const glm::vec3& to)
+{
+	if (NULL == m_pCameraCollider)
+	{
+		return(to);
+	}
+
+	if (m_cameraColliderRevision != m_sceneRevision)
+	{
+		BuildDrawList();
+		m_pCameraCollider->Build(m_drawList);
+		m_cameraColliderRevision = m_sceneRevision;
+	}
+	return(m_pCameraCollider->MoveSphere(from, to));
+}
+
+/***********************************************************
+ *  GetCameraCollider()
+ *
+ *  This method is used for getting the grid that keeps the
+ *  camera out of the scene, or NULL while camera collision
+ *  is off.
+ ***********************************************************/
+const CameraCollider* SceneManager::GetCameraCollider() const
+{
+	return(m_pCameraCollider);
+}
+
+/***********************************************************
+ *  SetImpostors()
+ *
+ *  This method is used for drawing the prefab instances
+ *  beyond a distance from the camera as impostors.  Prefabs
+ *  are only pre-rendered from a number of views across each
+ *  atlas of a number of texels across, so they are drawn as
+ *  single quads instead of all of their parts.  Impostors
+ *  need the entity scene, where the prefabs are, and a
+ *  distance below zero turns them off.
+ ***********************************************************/
+void SceneManager::SetImpostors(float distance, int views, int resolution)
+{
+	if (distance < 0.0f)
+	{
+		if (NULL != m_pImpostorAtlas)
+		{
+			delete m_pImpostorAtlas;
+			m_pImpostorAtlas = NULL;
+		}
+		return;
+	}
+
+	if (NULL == m_pImpostorAtlas)
+	{
+		m_pImpostorAtlas = new ImpostorAtlas();
+	}
+	ImpostorAtlas::IMPOSTOR_SETTINGS settings = m_pImpostorAtlas->GetSettings();
+	settings.distance = distance;
+	if (views > 0)
+	{
+		settings.views = views;
+	}
+	if (resolution > 0)
+	{
+		settings.resolution = resolution;
+	}
+	m_pImpostorAtlas->SetSettings(settings);
+	m_bEntityScene = true;
+}
+
+/***********************************************************
+ *  SetImpostorView()
+ *
+ *  This method is used for telling the next BuildDrawList()
+ *  call where the camera is, so it can draw the far prefab
+ *  instances as impostors.  It only applies to that one
+ *  call, and other calls draw every part.
+ ***********************************************************/
+void SceneManager::SetImpostorView(const glm::vec3& viewPosition)
+{
+	m_impostorView = viewPosition;
+	m_bImpostorView = true;
+}
+
+/***********************************************************
+ *  GetImpostorDraws()
+ *
+ *  This method is used for getting the impostor draws
+ *  recorded by the last call to BuildDrawList().
+ ***********************************************************/
+const std::vector<SceneManager::IMPOSTOR_DRAW>& SceneManager::GetImpostorDraws() const
+{
+	return(m_impostorDraws);
+}
+
+/***********************************************************
+ *  GetImpostorAtlas()
+ *
+ *  This method is used for getting the impostor atlases, or
+ *  NULL while impostors are off.
+ ***********************************************************/
+const ImpostorAtlas* SceneManager::GetImpostorAtlas() const
+{
+	return(m_pImpostorAtlas);
+}
+
+/***********************************************************
+ *  BuildDrawList()
+ *
+ *  This method is used for recording the draws of every
+ *  object in the 3D scene, in order, into the draw list that
+ *  the render devices and software renderers consume.  The
+ *  entity scene builds the list from its entities instead,
+ *  and when the camera position was set and impostors are
+ *  on, its far prefab instances become impostor draws.
+ ***********************************************************/
+void SceneManager::BuildDrawList()
+{
+	m_drawList.clear();
+	m_impostorDraws.clear();
+	bool bImpostorView = m_bImpostorView;
+	m_bImpostorView = false;
+
+	if (NULL != m_pSceneEntities)
+	{
+		m_pSceneEntities->UpdateTransforms();
+		m_pSceneEntities->ShowAllEntities();
+		if ((bImpostorView == true) && (NULL != m_pImpostorAtlas))
+		{
+			// prefabs defined since the last frame are baked
+			// before their instances can use them
+			if (m_pImpostorAtlas->Bake(this) == true)
+			{
+				const ImpostorAtlas::IMPOSTOR_STATS& impostorStats = m_pImpostorAtlas->GetStats();
+				std::cout << "INFO: baked impostors of " << impostorStats.prefabs << " prefabs from "
+					<< impostorStats.bakedViews << " views, " << impostorStats.atlasBytes / 1024
+					<< " KB of atlases in " << impostorStats.bakeMilliseconds << " ms" << std::endl;
+			}
+			for (int prefab = 0; prefab < m_pSceneEntities->GetPrefabCount(); prefab++)
+			{
+				m_pSceneEntities->SetPrefabImpostor(prefab, m_pImpostorAtlas->HasImpostor(prefab));
+			}
+			m_pSceneEntities->SelectImpostors(m_impostorView, m_pImpostorAtlas->GetSettings().distance);
+		}
+		m_pSceneEntities->BuildDrawList(m_drawList);
+		for (size_t i = 0; i < m_drawList.size(); i++)
+		{
+			ResolveTextureSampler(m_drawList[i]);
+		}
+		m_pSceneEntities->BuildImpostorDraws(m_impostorDraws);
+		return;
+	}
+
+	RecordSceneObjects();
+}
+
+/***********************************************************
+ *  RecordSceneObjects()
+ *
+ *  This method is used for recording the draws of the
+ *  objects in the 3D scene, in order, into the draw list.
+ ***********************************************************/
+void SceneManager::RecordSceneObjects()
 {
 	RenderTable();
 	RenderBackdrop();
@@ -583,8 +2494,6 @@ void SceneManager::RenderScene()
 	RenderBook();
 	RenderWineGlass();
 	RenderWineBottle();
-	
-	
 }
 
 
@@ -628,7 +2537,7 @@ void SceneManager::RenderBook()
 	SetShaderMaterial("wood");  // Use existing wood material
 
 	// draw the main book body
-	m_basicMeshes->DrawBoxMesh();
+	DrawMesh(MESH_BOX);
 
 	/*** Book spine (slightly thicker edge) ***/
 	// set the XYZ scale for the spine
@@ -654,7 +2563,7 @@ void SceneManager::RenderBook()
 	SetShaderMaterial("wood");
 
 	// draw the book spine
-	m_basicMeshes->DrawBoxMesh();
+	DrawMesh(MESH_BOX);
 
 	/*** Book cover details (small raised rectangle for title area) ***/
 	// set the XYZ scale for the cover detail
@@ -680,7 +2589,7 @@ void SceneManager::RenderBook()
 	SetShaderMaterial("wood");
 
 	// draw the cover detail
-	m_basicMeshes->DrawBoxMesh();
+	DrawMesh(MESH_BOX);
 }
 
 /***********************************************************
@@ -725,7 +2634,7 @@ void SceneManager::RenderTable()
 	SetShaderMaterial("wood");
 
 	// draw the mesh with transformation values - this plane is used for the base
-	m_basicMeshes->DrawBoxMesh();
+	DrawMesh(MESH_BOX);
 }
 
 /***********************************************************
@@ -767,7 +2676,7 @@ void SceneManager::RenderBackdrop()
 	SetShaderColor(0.75, 0.75f, 0.75f, 1.0f);
 
 	// draw the mesh with transformation values - this plane is used for the backdrop
-	m_basicMeshes->DrawPlaneMesh();
+	DrawMesh(MESH_PLANE);
 }
 
 /***********************************************************
@@ -812,12 +2721,12 @@ void SceneManager::RenderCheeseWheel()
 	SetShaderMaterial("cheese");
 
 	// draw the mesh with transformation values - this plane is used for the base
-	m_basicMeshes->DrawCylinderMesh(false, false, true);
+	DrawMesh(MESH_CYLINDER, PART_SIDES);
 
 	SetShaderTexture("cheese_wheel_top");
 	SetTextureUVScale(1.0, 1.0);
 
-	m_basicMeshes->DrawCylinderMesh(true, false, false);
+	DrawMesh(MESH_CYLINDER, PART_TOP);
 }
 
 
@@ -862,7 +2771,7 @@ void SceneManager::RenderWineGlass()
 	SetShaderMaterial("glass");
 
 	// draw the cylindrical glass body 
-	m_basicMeshes->DrawCylinderMesh(false, false, true);
+	DrawMesh(MESH_CYLINDER, PART_SIDES);
 
 	/*** Set needed transformations before drawing the bottom of the glass ***/
 
@@ -889,7 +2798,7 @@ void SceneManager::RenderWineGlass()
 	SetShaderMaterial("glass");
 
 	// draw the bottom of the glass
-	m_basicMeshes->DrawCylinderMesh(true, false, false);
+	DrawMesh(MESH_CYLINDER, PART_TOP);
 }
 
 /***********************************************************
@@ -932,7 +2841,7 @@ void SceneManager::RenderWineBottle()
 	SetShaderMaterial("glass");
 
 	// draw the mesh with transformation values - this plane is used for the base
-	m_basicMeshes->DrawHalfSphereMesh();
+	DrawMesh(MESH_HALF_SPHERE);
 	
 	/*** Set needed transformations before drawing the basic mesh ***/
 	
@@ -959,7 +2868,7 @@ void SceneManager::RenderWineBottle()
 	SetShaderMaterial("glass");
 
 	// draw the mesh with transformation values - this plane is used for the base
-	m_basicMeshes->DrawCylinderMesh(false, false, true);
+	DrawMesh(MESH_CYLINDER, PART_SIDES);
 	
 	/*** Set needed transformations before drawing the basic mesh ***/
 	
@@ -986,7 +2895,7 @@ void SceneManager::RenderWineBottle()
 	SetShaderMaterial("glass");
 
 	// draw the mesh with transformation values - this plane is used for the base
-	m_basicMeshes->DrawHalfSphereMesh();
+	DrawMesh(MESH_HALF_SPHERE);
 	
 	/*** Set needed transformations before drawing the basic mesh ***/
 	
@@ -1013,7 +2922,7 @@ void SceneManager::RenderWineBottle()
 	SetShaderMaterial("glass");
 
 	// draw the mesh with transformation values - this plane is used for the base
-	m_basicMeshes->DrawCylinderMesh(false, false, true);
+	DrawMesh(MESH_CYLINDER, PART_SIDES);
 	
 	/*** Set needed transformations before drawing the basic mesh ***/
 	
@@ -1040,7 +2949,7 @@ void SceneManager::RenderWineBottle()
 	SetShaderMaterial("glass");
 
 	// draw the mesh with transformation values - this plane is used for the base
-	m_basicMeshes->DrawTorusMesh();
+	DrawMesh(MESH_TORUS);
 	
 	/*** Set needed transformations before drawing the basic mesh ***/
 
@@ -1067,6 +2976,6 @@ void SceneManager::RenderWineBottle()
 	SetShaderMaterial("glass");
 
 	// draw the mesh with transformation values - this plane is used for the base
-	m_basicMeshes->DrawTorusMesh();
+	DrawMesh(MESH_TORUS);
 }
 
@@ -11,10 +11,27 @@
 
 #include "ShaderManager.h"
 #include "ShapeMeshes.h"
+#include "AssetLoader.h"
+#include "TextureBudget.h"
+#include "ProceduralTextures.h"
+#include "TextureSamplers.h"
+#include "ImageDecoder.h"
+#include "StressSceneGenerator.h"
+#include "WorldStreamer.h"
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
+class RenderDevice;
+class DrawListCache;
+class SceneEntities;
+class AnimationSystem;
+class ParticleSystem;
+class SceneQuery;
+class CameraCollider;
+class ImpostorAtlas;
+
 /***********************************************************
  *  SceneManager
  *
@@ -34,6 +51,8 @@ public:
 	{
 		std::string tag;
 		uint32_t ID;
+		TextureSamplers::SAMPLER_FILTER filter;
+		TextureSamplers::SAMPLER_WRAP wrap;
 	};
 
 	// properties for object materials
@@ -44,23 +63,233 @@ public:
 		glm::vec3 diffuseColor;
 		glm::vec3 specularColor;
 		float shininess;
+		// filtering preset for textures drawn with this material,
+		// or -1 to use the preset of the texture itself
+		int samplerFilter;
 		std::string tag;
 	};
 
+	// properties for the light sources
+	struct LIGHT_SOURCE
+	{
+		glm::vec3 position;
+		glm::vec3 ambientColor;
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float focalStrength;
+		float specularIntensity;
+	};
+
+	// the basic shape meshes that objects are built from
+	enum MESH_TYPE
+	{
+		MESH_BOX,
+		MESH_PLANE,
+		MESH_CYLINDER,
+		MESH_CONE,
+		MESH_PRISM,
+		MESH_PYRAMID4,
+		MESH_SPHERE,
+		MESH_HALF_SPHERE,
+		MESH_TAPERED_CYLINDER,
+		MESH_TORUS,
+		MESH_TYPE_COUNT
+	};
+
+	// the parts of the meshes that have end caps
+	enum MESH_PART
+	{
+		PART_TOP = 1,
+		PART_BOTTOM = 2,
+		PART_SIDES = 4,
+		PART_ALL = 7
+	};
+
+	// properties for one recorded draw of a shape mesh
+	struct DRAW_COMMAND
+	{
+		MESH_TYPE mesh;
+		// combination of the MESH_PART flags to draw
+		unsigned int parts;
+		glm::mat4 model;
+		glm::vec4 color;
+		bool bUseTexture;
+		// texture slot sampled by the draw, or -1 for none
+		int textureSlot;
+		glm::vec2 uvScale;
+		// index into the object materials, or -1 for none
+		int materialIndex;
+		// sampler preset chosen for the texture of the draw
+		TextureSamplers::SAMPLER_FILTER samplerFilter;
+		TextureSamplers::SAMPLER_WRAP samplerWrap;
+	};
+
+	// properties for a far prefab instance drawn as a quad
+	// from the prefab's impostor instead of its parts
+	struct IMPOSTOR_DRAW
+	{
+		int prefab;
+		glm::mat4 model;
+		// material used instead of the baked ones, or -1
+		int materialOverride;
+		// color used instead of the baked untextured colors
+		bool bColorOverride;
+		glm::vec4 colorOverride;
+	};
+
+	// properties for an extra instance of a scene prefab
+	struct PREFAB_PLACEMENT
+	{
+		std::string prefab;
+		glm::vec3 position;
+		float yawDegrees;
+		float scale;
+		// tag of the material used instead of the prefab's own,
+		// or empty to keep them
+		std::string materialTag;
+	};
+
+	// properties for a texture image kept in memory when the
+	// scene is prepared without OpenGL
+	struct TEXTURE_IMAGE
+	{
+		// RGBA pixels with the bottom row first, as uploaded
+		std::vector<unsigned char> pixels;
+		int width;
+		int height;
+	};
+
 private:
 	// pointer to shader manager object
 	ShaderManager* m_pShaderManager;
+	// pointer to the device the draws are issued through
+	RenderDevice* m_pRenderDevice;
 	// pointer to basic shapes object
 	ShapeMeshes *m_basicMeshes;
+	// pointer to the batched asset file reader
+	AssetLoader* m_pAssetLoader;
+	// pointer to the texture resolution and format policy
+	TextureBudget* m_pTextureBudget;
+	// pointer to the procedural texture generator
+	ProceduralTextures* m_pProceduralTextures;
+	// generate the wood, cheese and metal textures in code
+	bool m_bProceduralTextures;
+	// width and height of the generated textures
+	int m_proceduralResolution;
+	// pointer to the shared texture sampler objects
+	TextureSamplers* m_pTextureSamplers;
+	// filtering preset forced onto every texture, or -1
+	int m_samplerOverride;
+	// pointer to the image decoder backends
+	ImageDecoderRegistry* m_pImageDecoders;
+	// keep uncompressed copies of the decoded textures on disk
+	bool m_bRawTextureCache;
 	// total number of loaded textures
 	int m_loadedTextures;
 	// loaded textures info
 	TEXTURE_INFO m_textureIDs[16];
+	// texture pixels kept when there is no OpenGL context
+	TEXTURE_IMAGE m_textureImages[16];
 	// defined object materials
 	std::vector<OBJECT_MATERIAL> m_objectMaterials;
+	// defined light sources
+	std::vector<LIGHT_SOURCE> m_lightSources;
+	// draw state recorded with the next mesh draw
+	DRAW_COMMAND m_currentDraw;
+	// draws recorded by the last call to BuildDrawList()
+	std::vector<DRAW_COMMAND> m_drawList;
+	// draw lists kept for the cameras that never move
+	DrawListCache* m_pDrawListCache;
+	// changed whenever the draws of the scene change
+	int m_sceneRevision;
+	// camera of the next RenderScene() call, when it is known
+	glm::mat4 m_sceneView;
+	glm::mat4 m_sceneProjection;
+	bool m_bSceneCamera;
+	// entities the scene objects are drawn from, or NULL when
+	// the objects record their draws every frame
+	SceneEntities* m_pSceneEntities;
+	bool m_bEntityScene;
+	// create an entity with every recorded draw
+	bool m_bRecordEntities;
+	// transformation values of the next recorded draw
+	glm::vec3 m_currentScale;
+	glm::vec3 m_currentRotation;
+	glm::vec3 m_currentPosition;
+	// extra prefab instances placed in the entity scene
+	std::vector<PREFAB_PLACEMENT> m_prefabPlacements;
+	// generated scene used instead of the scene objects
+	StressSceneGenerator::STRESS_SETTINGS m_stressSettings;
+	bool m_bStressScene;
+	// world streamed in cells around the camera instead of the
+	// scene objects, or NULL when there is none
+	WorldStreamer* m_pWorldStreamer;
+	WorldStreamer::WORLD_SETTINGS m_worldSettings;
+	bool m_bStreamWorld;
+	// keep the entity transforms packed, relative to cells of
+	// the passed in size
+	bool m_bCompactTransforms;
+	float m_compactCellSize;
+	// keep the transformation values of every recorded draw,
+	// for comparing packed transforms with the drawn matrices
+	bool m_bRecordTransforms;
+	std::vector<glm::vec3> m_recordedScales;
+	std::vector<glm::vec3> m_recordedRotations;
+	std::vector<glm::vec3> m_recordedPositions;
+	// keyframe tracks moving the entities and lights, or NULL
+	// when the scene is still
+	AnimationSystem* m_pAnimation;
+	bool m_bAnimateScene;
+	// particles of the pour, steam and dust effects, or NULL
+	// when the scene has none
+	ParticleSystem* m_pParticles;
+	int m_dustBudget;
+	// time the particles were last stepped to, or below zero
+	// before the first step
+	double m_particleTime;
+	// hierarchy over the entity boxes for picking, or NULL
+	// before the first query, and the scene revision it was
+	// last brought up to date for
+	SceneQuery* m_pSceneQuery;
+	int m_sceneQueryRevision;
+	// grid over the scene boxes that keeps the camera out of
+	// them, or NULL while camera collision is off, and the
+	// scene revision it was last built for
+	CameraCollider* m_pCameraCollider;
+	int m_cameraColliderRevision;
+	// atlases far prefab instances are drawn from, or NULL
+	// while impostors are off, and the impostor draws of the
+	// last BuildDrawList()
+	ImpostorAtlas* m_pImpostorAtlas;
+	std::vector<IMPOSTOR_DRAW> m_impostorDraws;
+	// camera position of the next BuildDrawList() call, when
+	// it is known
+	glm::vec3 m_impostorView;
+	bool m_bImpostorView;
 
 	// load texture images and convert to OpenGL texture data
 	bool CreateGLTexture(const char* filename, std::string tag);
+	// fit decoded image data to the budget and upload it to OpenGL
+	bool UploadGLTexture(
+		const unsigned char* image,
+		int width,
+		int height,
+		int colorChannels,
+		bool bFlipRows,
+		std::string tag);
+	// keep the prepared texture pixels in memory for rendering
+	// without OpenGL
+	void StoreTextureImage(
+		const TextureBudget::PREPARED_TEXTURE& prepared,
+		std::string tag);
+	// get the name of the uncompressed cache file for a texture
+	std::string GetTextureCachePath(const char* filename);
+	// generate a texture image and upload it to OpenGL
+	bool CreateProceduralTexture(
+		const ProceduralTextures::PATTERN_SETTINGS& settings,
+		std::string tag);
+	// find the generated pattern that replaces a texture
+	int FindProceduralPattern(std::string tag);
 	// bind loaded OpenGL textures to slots in memory
 	void BindGLTextures();
 	// free the loaded OpenGL textures
@@ -70,6 +299,31 @@ private:
 	int FindTextureSlot(std::string tag);
 	// find a defined material by tag
 	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
+	int FindMaterialIndex(std::string tag);
+	// choose the sampler preset for a textured draw
+	void ResolveTextureSampler(DRAW_COMMAND& draw);
+
+	// record a draw of a shape mesh with the current draw state
+	void DrawMesh(MESH_TYPE mesh, unsigned int parts = PART_ALL);
+	// record the draws of the objects in the 3D scene
+	void RecordSceneObjects();
+	// create an entity for every object draw in the 3D scene
+	void CreateSceneEntities();
+	// make a prefab of the draws of one scene object, local to
+	// an origin, and place it there
+	void CreateScenePrefab(const char* name, void (SceneManager::*renderObject)(), glm::vec3 origin);
+	// make a prefab of the draws of one scene object, local to
+	// an origin, returning its index
+	int DefineScenePrefab(const char* name, void (SceneManager::*renderObject)(), glm::vec3 origin);
+	// define the prefabs of a showroom world and open it
+	void OpenStreamedWorld();
+	// create the entities when there are none, keeping the
+	// transforms compact when asked to
+	void CreateEntityStore();
+	// add the tracks that animate the entities and lights
+	void CreateSceneAnimation();
+	// add the emitters of the particle effects
+	void CreateParticleEffects();
 
 	// set the transformation values 
 	// into the transform buffer
@@ -101,10 +355,126 @@ private:
 
 public:
 
+	// generate the wood, cheese and metal textures in code
+	void SetProceduralTextures(bool bEnabled, int resolution);
+	// keep uncompressed copies of the decoded textures on disk
+	void SetRawTextureCache(bool bEnabled);
+	// set the resolution cap and formats textures are uploaded
+	// with
+	void SetTextureFormats(int maxDimension, bool bUseSRGB, bool bCompactFormats);
+	// map the texture files read-only instead of reading them
+	void SetMappedAssets(bool bEnabled);
+	// get the names of the texture image files of the scene
+	static void GetSceneTextureFiles(std::vector<std::string>& filenames);
+	// set the sampler preset used by a loaded texture
+	void SetTextureSampler(
+		std::string tag,
+		TextureSamplers::SAMPLER_FILTER filter,
+		TextureSamplers::SAMPLER_WRAP wrap);
+	// force one filtering preset onto every texture, or -1 to
+	// return to the texture and material presets
+	void SetSamplerOverride(int filter);
+	// draw the scene objects from entities kept between frames
+	void SetEntityScene(bool bEnabled);
+	// get the entities of the scene, or NULL when there are none
+	SceneEntities* GetSceneEntities() const;
+	// place another instance of the book, wine glass or wine
+	// bottle prefab in the entity scene
+	void PlacePrefab(const PREFAB_PLACEMENT& placement);
+	// prepare a generated scene of props instead of the scene
+	// objects
+	void SetStressScene(const StressSceneGenerator::STRESS_SETTINGS& settings);
+	// replace the entities with a generated scene of props
+	void GenerateStressScene(const StressSceneGenerator::STRESS_SETTINGS& settings);
+	// stream a showroom world around the camera instead of the
+	// scene objects
+	void SetStreamWorld(const WorldStreamer::WORLD_SETTINGS& settings);
+	// stream the world cells around the camera, optionally
+	// waiting for every cell in range, returning whether the
+	// scene changed
+	bool UpdateWorldStreaming(const glm::vec3& cameraPosition, bool bFinishLoads);
+	// get the streamed world, or NULL when there is none
+	WorldStreamer* GetWorldStreamer() const;
+	// write a showroom world of tables set out like the scene,
+	// one table to a cell
+	static bool WriteShowroomWorld(const char* directory, int columns, int rows);
+	// keep the entity transforms packed into 16 bytes each
+	void SetCompactTransforms(bool bEnabled, float cellSize);
+	// print the error of packing the transforms of the scene
+	// objects and the time taken to pack many of them
+	void ReportTransformPrecision(float cellSize);
+	// animate the entities and lights with keyframe tracks
+	void SetSceneAnimation(bool bEnabled);
+	// move the animated entities and lights to a time in
+	// seconds
+	void UpdateAnimation(double seconds);
+	// get the animation tracks, or NULL when there are none
+	const AnimationSystem* GetAnimationSystem() const;
+	// add the pour, steam and dust particle effects, with the
+	// most dust particles alive at once
+	void SetParticleEffects(int dustBudget);
+	// get the particles, or NULL when there are none
+	ParticleSystem* GetParticleSystem() const;
+	// bring the hierarchy over the entity boxes up to date and
+	// get it, or NULL when the scene has no entities
+	const SceneQuery* UpdateSceneQuery();
+	// find the closest entity along a ray from a point, giving
+	// its handle and distance, returning whether one was hit
+	bool PickEntity(const glm::vec3& origin, const glm::vec3& direction, uint32_t& entity, float& distance);
+	// keep the camera out of the scene, as a sphere of a radius
+	// inside a box, where a minimum above the maximum uses the
+	// scene grown by a margin and a radius below zero turns
+	// collision off
+	void SetCameraCollision(float radius, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+	// move the camera from one position towards another,
+	// returning where it could go
+	glm::vec3 MoveCamera(const glm::vec3& from, const glm::vec3& to);
+	// get the grid that keeps the camera out of the scene, or
+	// NULL while camera collision is off
+	const CameraCollider* GetCameraCollider() const;
+	// draw the prefab instances beyond a distance from the
+	// camera as impostors, baked with a number of views across
+	// each atlas of a number of texels across, where a distance
+	// below zero turns impostors off
+	void SetImpostors(float distance, int views, int resolution);
+	// set the camera position that the next BuildDrawList()
+	// chooses the impostors for
+	void SetImpostorView(const glm::vec3& viewPosition);
+	// get the impostor draws recorded by the last
+	// BuildDrawList()
+	const std::vector<IMPOSTOR_DRAW>& GetImpostorDraws() const;
+	// get the impostor atlases, or NULL while impostors are
+	// off
+	const ImpostorAtlas* GetImpostorAtlas() const;
+
 	// prepare the 3D scene for rendering
 	void PrepareScene();
 	// render the objects in the 3D scene
 	void RenderScene();
+	// record the draws of the objects in the 3D scene
+	void BuildDrawList();
+
+	// get the draws recorded by the last BuildDrawList()
+	const std::vector<DRAW_COMMAND>& GetDrawList() const;
+	// register a camera that never moves, whose culled and
+	// sorted draw list is kept until the scene changes
+	int RegisterPresetView(const glm::mat4& view, const glm::mat4& projection);
+	// set the camera that the next RenderScene() draws from
+	void SetSceneCamera(const glm::mat4& view, const glm::mat4& projection);
+	// mark the kept draw lists as out of date
+	void InvalidateDrawLists();
+	// get the draw lists kept for the preset cameras
+	const DrawListCache* GetDrawListCache() const;
+	// get the defined object materials
+	const std::vector<OBJECT_MATERIAL>& GetObjectMaterials() const;
+	// get the defined light sources
+	const std::vector<LIGHT_SOURCE>& GetLightSources() const;
+	// get the texture pixels kept for a slot, or NULL
+	const TEXTURE_IMAGE* GetTextureImage(int textureSlot) const;
+	// draw through another render device, which is then owned
+	void SetRenderDevice(RenderDevice* pRenderDevice);
+	// get the render device, or NULL when there is none
+	RenderDevice* GetRenderDevice() const;
 
 	// load all of the needed textures before rendering
 	void LoadSceneTextures();
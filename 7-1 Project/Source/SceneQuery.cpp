@@ -0,0 +1,976 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenequery.cpp
+// ============
+// find the entities along a ray or inside a sphere or box of the scene
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneQuery.h"
+#include "SimdSupport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// declaration of global variables and defines
+namespace
+{
+	// number of candidate split positions along each axis
+	const int g_SplitBins = 12;
+	// most entities kept in a leaf without checking for a split
+	const int g_MinLeafEntities = 4;
+	// cost of visiting a node relative to testing an entity box
+	const float g_TraversalCost = 1.0f;
+	// corner of the empty box of unused slots and of entities
+	// that are gone, so far away no query ever reaches it
+	const float g_FarAway = 1.0e30f;
+	// most nodes waiting to be searched by one query
+	const int g_StackSize = 256;
+	// growth of the search cost after which refitting gives way
+	// to building the hierarchy again
+	const float g_RebuildGrowth = 2.0f;
+
+	// get the time in milliseconds, for timing the builds
+	double GetMilliseconds()
+	{
+		return(std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// get the surface area of a box
+	float SurfaceArea(const glm::vec3& minimum, const glm::vec3& maximum)
+	{
+		glm::vec3 size = glm::max(maximum - minimum, glm::vec3(0.0f));
+		return(2.0f * (size.x * size.y + size.y * size.z + size.z * size.x));
+	}
+
+	// test a ray against a box with the slab method, giving the
+	// distance it enters the box
+	bool IntersectBox(
+		const glm::vec3& origin,
+		const glm::vec3& invDirection,
+		const glm::vec3& minimum,
+		const glm::vec3& maximum,
+		float maxDistance,
+		float& nearDistance)
+	{
+		glm::vec3 t1 = (minimum - origin) * invDirection;
+		glm::vec3 t2 = (maximum - origin) * invDirection;
+		glm::vec3 tMin = glm::min(t1, t2);
+		glm::vec3 tMax = glm::max(t1, t2);
+		nearDistance = std::max(std::max(tMin.x, tMin.y), std::max(tMin.z, 0.0f));
+		float farDistance = std::min(std::min(tMax.x, tMax.y), std::min(tMax.z, maxDistance));
+		return(nearDistance <= farDistance);
+	}
+
+	// check whether a sphere touches a box
+	bool SphereTouchesBox(const glm::vec3& center, float radius, const glm::vec3& minimum, const glm::vec3& maximum)
+	{
+		glm::vec3 outside = glm::max(glm::max(minimum - center, center - maximum), glm::vec3(0.0f));
+		return(glm::dot(outside, outside) <= radius * radius);
+	}
+
+	// check whether two boxes touch
+	bool BoxesTouch(const glm::vec3& minimumA, const glm::vec3& maximumA, const glm::vec3& minimumB, const glm::vec3& maximumB)
+	{
+		return((minimumA.x <= maximumB.x) && (maximumA.x >= minimumB.x) &&
+			(minimumA.y <= maximumB.y) && (maximumA.y >= minimumB.y) &&
+			(minimumA.z <= maximumB.z) && (maximumA.z >= minimumB.z));
+	}
+
+	// get the box of one child slot of a node
+	template <typename NODE>
+	void GetSlotBox(const NODE& node, int slot, glm::vec3& minimum, glm::vec3& maximum)
+	{
+		minimum = glm::vec3(node.minimumX[slot], node.minimumY[slot], node.minimumZ[slot]);
+		maximum = glm::vec3(node.maximumX[slot], node.maximumY[slot], node.maximumZ[slot]);
+	}
+
+	// set the box of one child slot of a node
+	template <typename NODE>
+	void SetSlotBox(NODE& node, int slot, const glm::vec3& minimum, const glm::vec3& maximum)
+	{
+		node.minimumX[slot] = minimum.x;
+		node.minimumY[slot] = minimum.y;
+		node.minimumZ[slot] = minimum.z;
+		node.maximumX[slot] = maximum.x;
+		node.maximumY[slot] = maximum.y;
+		node.maximumZ[slot] = maximum.z;
+	}
+}
+
+/***********************************************************
+ *  SceneQuery()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneQuery::SceneQuery()
+{
+	m_bExactTriangles = false;
+	m_buildCost = 1.0f;
+	m_builtEntities = 0;
+
+	m_stats.entities = 0;
+	m_stats.nodes = 0;
+	m_stats.leaves = 0;
+	m_stats.builds = 0;
+	m_stats.refits = 0;
+	m_stats.buildMilliseconds = 0.0;
+	m_stats.refitMilliseconds = 0.0;
+	m_stats.costGrowth = 1.0f;
+}
+
+/***********************************************************
+ *  SetExactTriangles()
+ *
+ *  This method is used for testing rays against the triangles
+ *  of the meshes whose boxes they reach, so a pick through
+ *  the empty corner of a box goes on to what is behind it.
+ ***********************************************************/
+void SceneQuery::SetExactTriangles(bool bExact)
+{
+	m_bExactTriangles = bExact;
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for building the hierarchy over the
+ *  world boxes of every entity that has them, as of the last
+ *  UpdateTransforms() of the entities.  A two way hierarchy
+ *  is split first and then collapsed into four way nodes.
+ ***********************************************************/
+bool SceneQuery::Build(const SceneEntities* pEntities)
+{
+	double start = GetMilliseconds();
+	m_items.clear();
+	m_buildNodes.clear();
+	m_nodes.clear();
+	m_stats.entities = 0;
+	m_stats.nodes = 0;
+	m_stats.leaves = 0;
+	m_stats.costGrowth = 1.0f;
+	m_buildCost = 1.0f;
+	m_builtEntities = 0;
+	if (NULL == pEntities)
+	{
+		return(false);
+	}
+
+	m_builtEntities = pEntities->GetStats().entities;
+	for (int a = 0; a < pEntities->GetArchetypeCount(); a++)
+	{
+		const SceneEntities::ENTITY_ARCHETYPE& archetype = pEntities->GetArchetype(a);
+		if ((archetype.components & SceneEntities::COMPONENT_BOUNDS) == 0)
+		{
+			continue;
+		}
+		for (size_t c = 0; c < archetype.chunks.size(); c++)
+		{
+			const SceneEntities::ENTITY_CHUNK& chunk = archetype.chunks[c];
+			for (int row = 0; row < chunk.count; row++)
+			{
+				QUERY_ITEM item;
+				item.entity = chunk.entities[row];
+				item.minimum = glm::vec3(chunk.minimumX[row], chunk.minimumY[row], chunk.minimumZ[row]);
+				item.maximum = glm::vec3(chunk.maximumX[row], chunk.maximumY[row], chunk.maximumZ[row]);
+				m_items.push_back(item);
+			}
+		}
+	}
+	if (m_items.empty() == true)
+	{
+		return(false);
+	}
+
+	// the root starts with every entity and is split from there
+	std::vector<glm::vec3> centers(m_items.size());
+	for (size_t i = 0; i < m_items.size(); i++)
+	{
+		centers[i] = (m_items[i].minimum + m_items[i].maximum) * 0.5f;
+	}
+
+	m_buildNodes.reserve(m_items.size() * 2);
+	BUILD_NODE root;
+	root.firstIndex = 0;
+	root.itemCount = (int)m_items.size();
+	m_buildNodes.push_back(root);
+	SubdivideNode(0, centers);
+
+	m_nodes.reserve(m_buildNodes.size() / 2 + 1);
+	CollapseNode(0);
+	m_buildNodes.clear();
+
+	for (size_t n = 0; n < m_nodes.size(); n++)
+	{
+		for (int slot = 0; slot < 4; slot++)
+		{
+			if (m_nodes[n].count[slot] > 0)
+			{
+				m_stats.leaves++;
+			}
+		}
+	}
+	m_buildCost = std::max(GetSearchCost(), 1.0e-6f);
+	m_stats.entities = (int)m_items.size();
+	m_stats.nodes = (int)m_nodes.size();
+	m_stats.builds++;
+	m_stats.buildMilliseconds = GetMilliseconds() - start;
+	return(true);
+}
+
+/***********************************************************
+ *  SubdivideNode()
+ *
+ *  This method is used for splitting the entities of a node
+ *  between two children where the surface area heuristic
+ *  says the split is cheaper to search than the leaf.  The
+ *  split positions are chosen from evenly spaced bins along
+ *  each axis of the box centers.
+ ***********************************************************/
+void SceneQuery::SubdivideNode(int nodeIndex, std::vector<glm::vec3>& centers)
+{
+	int first = m_buildNodes[nodeIndex].firstIndex;
+	int count = m_buildNodes[nodeIndex].itemCount;
+
+	glm::vec3 boundsMin(g_FarAway);
+	glm::vec3 boundsMax(-g_FarAway);
+	glm::vec3 centerMin(g_FarAway);
+	glm::vec3 centerMax(-g_FarAway);
+	for (int i = first; i < first + count; i++)
+	{
+		boundsMin = glm::min(boundsMin, m_items[i].minimum);
+		boundsMax = glm::max(boundsMax, m_items[i].maximum);
+		centerMin = glm::min(centerMin, centers[i]);
+		centerMax = glm::max(centerMax, centers[i]);
+	}
+	m_buildNodes[nodeIndex].minimum = boundsMin;
+	m_buildNodes[nodeIndex].maximum = boundsMax;
+
+	if (count <= g_MinLeafEntities)
+	{
+		return;
+	}
+
+	float bestCost = (float)count;
+	int bestAxis = -1;
+	float bestSplit = 0.0f;
+	float invArea = 1.0f / std::max(SurfaceArea(boundsMin, boundsMax), 1.0e-12f);
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float extent = centerMax[axis] - centerMin[axis];
+		if (extent <= 0.0f)
+		{
+			continue;
+		}
+
+		int binCounts[g_SplitBins] = { 0 };
+		glm::vec3 binMin[g_SplitBins];
+		glm::vec3 binMax[g_SplitBins];
+		for (int bin = 0; bin < g_SplitBins; bin++)
+		{
+			binMin[bin] = glm::vec3(g_FarAway);
+			binMax[bin] = glm::vec3(-g_FarAway);
+		}
+
+		float binScale = (float)g_SplitBins / extent;
+		for (int i = first; i < first + count; i++)
+		{
+			int bin = std::min(g_SplitBins - 1, (int)((centers[i][axis] - centerMin[axis]) * binScale));
+			binCounts[bin]++;
+			binMin[bin] = glm::min(binMin[bin], m_items[i].minimum);
+			binMax[bin] = glm::max(binMax[bin], m_items[i].maximum);
+		}
+
+		// sweep from the right to get the cost of every right side
+		float rightCosts[g_SplitBins];
+		glm::vec3 sweepMin(g_FarAway);
+		glm::vec3 sweepMax(-g_FarAway);
+		int sweepCount = 0;
+		for (int bin = g_SplitBins - 1; bin > 0; bin--)
+		{
+			sweepMin = glm::min(sweepMin, binMin[bin]);
+			sweepMax = glm::max(sweepMax, binMax[bin]);
+			sweepCount += binCounts[bin];
+			rightCosts[bin] = (sweepCount > 0) ? SurfaceArea(sweepMin, sweepMax) * sweepCount : 0.0f;
+		}
+
+		sweepMin = glm::vec3(g_FarAway);
+		sweepMax = glm::vec3(-g_FarAway);
+		sweepCount = 0;
+		for (int bin = 0; bin < g_SplitBins - 1; bin++)
+		{
+			sweepMin = glm::min(sweepMin, binMin[bin]);
+			sweepMax = glm::max(sweepMax, binMax[bin]);
+			sweepCount += binCounts[bin];
+			if ((sweepCount == 0) || (sweepCount == count))
+			{
+				continue;
+			}
+
+			float cost = g_TraversalCost +
+				(SurfaceArea(sweepMin, sweepMax) * sweepCount + rightCosts[bin + 1]) * invArea;
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = centerMin[axis] + (float)(bin + 1) / binScale;
+			}
+		}
+	}
+
+	// keep the node as a leaf when no split is cheaper
+	if (bestAxis < 0)
+	{
+		return;
+	}
+
+	int middle = first;
+	for (int i = first; i < first + count; i++)
+	{
+		if (centers[i][bestAxis] < bestSplit)
+		{
+			std::swap(m_items[i], m_items[middle]);
+			std::swap(centers[i], centers[middle]);
+			middle++;
+		}
+	}
+	if ((middle == first) || (middle == first + count))
+	{
+		return;
+	}
+
+	int leftIndex = (int)m_buildNodes.size();
+	BUILD_NODE child;
+	child.firstIndex = first;
+	child.itemCount = middle - first;
+	m_buildNodes.push_back(child);
+	child.firstIndex = middle;
+	child.itemCount = first + count - middle;
+	m_buildNodes.push_back(child);
+
+	m_buildNodes[nodeIndex].firstIndex = leftIndex;
+	m_buildNodes[nodeIndex].itemCount = 0;
+
+	SubdivideNode(leftIndex, centers);
+	SubdivideNode(leftIndex + 1, centers);
+}
+
+/***********************************************************
+ *  CollapseNode()
+ *
+ *  This method is used for adding the four way node for a
+ *  node of the two way hierarchy.  Its two children are
+ *  opened up, largest first, until there are four of them,
+ *  and the inner ones get four way nodes of their own after
+ *  this one, so every node comes before its children.
+ ***********************************************************/
+int SceneQuery::CollapseNode(int buildIndex)
+{
+	int nodeIndex = (int)m_nodes.size();
+	m_nodes.push_back(QUERY_NODE());
+
+	int children[4];
+	int childCount = 0;
+	const BUILD_NODE& build = m_buildNodes[buildIndex];
+	if (build.itemCount > 0)
+	{
+		children[childCount++] = buildIndex;
+	}
+	else
+	{
+		children[childCount++] = build.firstIndex;
+		children[childCount++] = build.firstIndex + 1;
+		while (childCount < 4)
+		{
+			int largest = -1;
+			float largestArea = -1.0f;
+			for (int i = 0; i < childCount; i++)
+			{
+				const BUILD_NODE& child = m_buildNodes[children[i]];
+				float area = SurfaceArea(child.minimum, child.maximum);
+				if ((child.itemCount == 0) && (area > largestArea))
+				{
+					largest = i;
+					largestArea = area;
+				}
+			}
+			if (largest < 0)
+			{
+				break;
+			}
+			int opened = m_buildNodes[children[largest]].firstIndex;
+			children[largest] = opened;
+			children[childCount++] = opened + 1;
+		}
+	}
+
+	QUERY_NODE node;
+	for (int slot = 0; slot < 4; slot++)
+	{
+		if (slot >= childCount)
+		{
+			SetSlotBox(node, slot, glm::vec3(g_FarAway), glm::vec3(g_FarAway));
+			node.child[slot] = 0;
+			node.count[slot] = -1;
+			continue;
+		}
+
+		const BUILD_NODE& child = m_buildNodes[children[slot]];
+		SetSlotBox(node, slot, child.minimum, child.maximum);
+		if (child.itemCount > 0)
+		{
+			node.child[slot] = child.firstIndex;
+			node.count[slot] = child.itemCount;
+		}
+		else
+		{
+			node.child[slot] = CollapseNode(children[slot]);
+			node.count[slot] = 0;
+		}
+	}
+	m_nodes[nodeIndex] = node;
+	return(nodeIndex);
+}
+
+/***********************************************************
+ *  GetSearchCost()
+ *
+ *  This method is used for getting the surface area cost of
+ *  searching the hierarchy, the chance of reaching each child
+ *  times the work of visiting it, relative to the root box.
+ ***********************************************************/
+float SceneQuery::GetSearchCost() const
+{
+	if (m_nodes.empty() == true)
+	{
+		return(0.0f);
+	}
+
+	glm::vec3 rootMin(g_FarAway);
+	glm::vec3 rootMax(-g_FarAway);
+	float cost = 0.0f;
+	for (size_t n = 0; n < m_nodes.size(); n++)
+	{
+		const QUERY_NODE& node = m_nodes[n];
+		for (int slot = 0; slot < 4; slot++)
+		{
+			if (node.count[slot] < 0)
+			{
+				continue;
+			}
+			glm::vec3 minimum;
+			glm::vec3 maximum;
+			GetSlotBox(node, slot, minimum, maximum);
+			float work = (node.count[slot] > 0) ? (float)node.count[slot] : g_TraversalCost;
+			cost += SurfaceArea(minimum, maximum) * work;
+			if (n == 0)
+			{
+				rootMin = glm::min(rootMin, minimum);
+				rootMax = glm::max(rootMax, maximum);
+			}
+		}
+	}
+	return(cost / std::max(SurfaceArea(rootMin, rootMax), 1.0e-12f));
+}
+
+/***********************************************************
+ *  Refit()
+ *
+ *  This method is used for moving the boxes of the hierarchy
+ *  to where the entities are as of their last
+ *  UpdateTransforms().  The nodes are walked from the last
+ *  to the first, so each child is refit before the node that
+ *  holds it.  The hierarchy is built again instead when
+ *  entities were added or removed, or when the refit boxes
+ *  have grown to make it much slower to search.
+ ***********************************************************/
+bool SceneQuery::Refit(const SceneEntities* pEntities)
+{
+	if (NULL == pEntities)
+	{
+		return(false);
+	}
+	if ((m_nodes.empty() == true) || (pEntities->GetStats().entities != m_builtEntities))
+	{
+		return(Build(pEntities));
+	}
+
+	double start = GetMilliseconds();
+	for (size_t i = 0; i < m_items.size(); i++)
+	{
+		QUERY_ITEM& item = m_items[i];
+		if (pEntities->GetBounds(item.entity, item.minimum, item.maximum) == false)
+		{
+			return(Build(pEntities));
+		}
+	}
+
+	for (int n = (int)m_nodes.size() - 1; n >= 0; n--)
+	{
+		QUERY_NODE& node = m_nodes[n];
+		for (int slot = 0; slot < 4; slot++)
+		{
+			if (node.count[slot] < 0)
+			{
+				continue;
+			}
+
+			glm::vec3 minimum(g_FarAway);
+			glm::vec3 maximum(-g_FarAway);
+			if (node.count[slot] > 0)
+			{
+				for (int i = node.child[slot]; i < node.child[slot] + node.count[slot]; i++)
+				{
+					minimum = glm::min(minimum, m_items[i].minimum);
+					maximum = glm::max(maximum, m_items[i].maximum);
+				}
+			}
+			else
+			{
+				const QUERY_NODE& child = m_nodes[node.child[slot]];
+				for (int childSlot = 0; childSlot < 4; childSlot++)
+				{
+					if (child.count[childSlot] < 0)
+					{
+						continue;
+					}
+					glm::vec3 childMin;
+					glm::vec3 childMax;
+					GetSlotBox(child, childSlot, childMin, childMax);
+					minimum = glm::min(minimum, childMin);
+					maximum = glm::max(maximum, childMax);
+				}
+			}
+			SetSlotBox(node, slot, minimum, maximum);
+		}
+	}
+
+	m_stats.refits++;
+	m_stats.refitMilliseconds = GetMilliseconds() - start;
+	m_stats.costGrowth = GetSearchCost() / m_buildCost;
+	if (m_stats.costGrowth > g_RebuildGrowth)
+	{
+		return(Build(pEntities));
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  GetEntityCount()
+ *
+ *  This method is used for getting the number of entities in
+ *  the hierarchy.
+ ***********************************************************/
+int SceneQuery::GetEntityCount() const
+{
+	return((int)m_items.size());
+}
+
+/***********************************************************
+ *  IntersectMeshes()
+ *
+ *  This method is used for testing a ray against the
+ *  triangles of an entity's meshes.  The ray is moved into
+ *  the local space of each mesh instead of moving the
+ *  triangles, and since its direction is not normalized
+ *  there, the distances stay those of the world ray.  The
+ *  distance is lowered to the closest hit closer than it.
+ ***********************************************************/
+bool SceneQuery::IntersectMeshes(
+	const SceneEntities* pEntities,
+	SceneEntities::ENTITY_ID entity,
+	const glm::vec3& origin,
+	const glm::vec3& direction,
+	float& distance) const
+{
+	std::vector<SceneEntities::ENTITY_MESH> meshes;
+	if (pEntities->GetMeshes(entity, meshes) == false)
+	{
+		return(false);
+	}
+
+	bool bHit = false;
+	for (size_t m = 0; m < meshes.size(); m++)
+	{
+		const SceneEntities::ENTITY_MESH& mesh = meshes[m];
+		glm::mat4 inverse = glm::inverse(mesh.model);
+		glm::vec3 localOrigin = glm::vec3(inverse * glm::vec4(origin, 1.0f));
+		glm::vec3 localDirection = glm::mat3(inverse) * direction;
+
+		for (int part = 0; part < PrimitiveGeometry::PART_INDEX_COUNT; part++)
+		{
+			if (PrimitiveGeometry::IsPartDrawn(mesh.mesh, (PrimitiveGeometry::PART_INDEX)part, mesh.parts) == false)
+			{
+				continue;
+			}
+
+			const PrimitiveGeometry::MESH_DATA& data =
+				m_geometry.GetMeshPart(mesh.mesh, (PrimitiveGeometry::PART_INDEX)part);
+			for (size_t i = 0; i + 2 < data.indices.size(); i += 3)
+			{
+				glm::vec3 vertex0 = data.vertices[data.indices[i]].position;
+				glm::vec3 edge1 = data.vertices[data.indices[i + 1]].position - vertex0;
+				glm::vec3 edge2 = data.vertices[data.indices[i + 2]].position - vertex0;
+
+				// Moller-Trumbore, from either side since the scene
+				// draws without face culling
+				glm::vec3 p = glm::cross(localDirection, edge2);
+				float determinant = glm::dot(edge1, p);
+				if (std::fabs(determinant) < 1.0e-12f)
+				{
+					continue;
+				}
+				float invDeterminant = 1.0f / determinant;
+				glm::vec3 s = localOrigin - vertex0;
+				float u = glm::dot(s, p) * invDeterminant;
+				if ((u < 0.0f) || (u > 1.0f))
+				{
+					continue;
+				}
+				glm::vec3 q = glm::cross(s, edge1);
+				float v = glm::dot(localDirection, q) * invDeterminant;
+				if ((v < 0.0f) || (u + v > 1.0f))
+				{
+					continue;
+				}
+				float t = glm::dot(edge2, q) * invDeterminant;
+				if ((t > 0.0f) && (t < distance))
+				{
+					distance = t;
+					bHit = true;
+				}
+			}
+		}
+	}
+	return(bHit);
+}
+
+/***********************************************************
+ *  Raycast()
+ *
+ *  This method is used for finding the closest entity along
+ *  a ray.  Each node tests the ray against its four child
+ *  boxes at once, and the children that are hit are searched
+ *  nearest first, so children beyond the closest hit so far
+ *  are skipped without being visited.  With exact triangles,
+ *  an entity only counts where the ray meets its meshes.
+ ***********************************************************/
+bool SceneQuery::Raycast(
+	const SceneEntities* pEntities,
+	const glm::vec3& origin,
+	const glm::vec3& direction,
+	float maxDistance,
+	RAY_HIT& hit) const
+{
+	hit.entity = SceneEntities::INVALID_ENTITY;
+	hit.distance = maxDistance;
+	hit.nodesVisited = 0;
+	hit.entitiesTested = 0;
+	if (m_nodes.empty() == true)
+	{
+		return(false);
+	}
+
+	bool bExact = (m_bExactTriangles == true) && (NULL != pEntities);
+	glm::vec3 invDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+	// properties for a node or leaf waiting to be searched
+	struct STACK_ENTRY
+	{
+		int index;
+		int count;
+		float distance;
+	};
+	STACK_ENTRY stack[g_StackSize];
+	int stackSize = 0;
+	stack[stackSize].index = 0;
+	stack[stackSize].count = 0;
+	stack[stackSize].distance = 0.0f;
+	stackSize++;
+
+#ifdef SCENE_SIMD_SSE2
+	__m128 originX = _mm_set1_ps(origin.x);
+	__m128 originY = _mm_set1_ps(origin.y);
+	__m128 originZ = _mm_set1_ps(origin.z);
+	__m128 invX = _mm_set1_ps(invDirection.x);
+	__m128 invY = _mm_set1_ps(invDirection.y);
+	__m128 invZ = _mm_set1_ps(invDirection.z);
+#endif
+
+	while (stackSize > 0)
+	{
+		STACK_ENTRY entry = stack[--stackSize];
+		if (entry.distance > hit.distance)
+		{
+			continue;
+		}
+
+		// a leaf tests the boxes, and then the meshes, of its
+		// entities
+		if (entry.count > 0)
+		{
+			for (int i = entry.index; i < entry.index + entry.count; i++)
+			{
+				const QUERY_ITEM& item = m_items[i];
+				float nearDistance;
+				hit.entitiesTested++;
+				if (IntersectBox(origin, invDirection, item.minimum, item.maximum, hit.distance, nearDistance) == false)
+				{
+					continue;
+				}
+				if (bExact == false)
+				{
+					hit.distance = nearDistance;
+					hit.entity = item.entity;
+				}
+				else if (IntersectMeshes(pEntities, item.entity, origin, direction, hit.distance) == true)
+				{
+					hit.entity = item.entity;
+				}
+			}
+			continue;
+		}
+
+		const QUERY_NODE& node = m_nodes[entry.index];
+		hit.nodesVisited++;
+		float nearDistances[4];
+		int mask = 0;
+#ifdef SCENE_SIMD_SSE2
+		__m128 t1X = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minimumX), originX), invX);
+		__m128 t2X = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maximumX), originX), invX);
+		__m128 t1Y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minimumY), originY), invY);
+		__m128 t2Y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maximumY), originY), invY);
+		__m128 t1Z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.minimumZ), originZ), invZ);
+		__m128 t2Z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node.maximumZ), originZ), invZ);
+		__m128 tNear = _mm_max_ps(
+			_mm_max_ps(_mm_min_ps(t1X, t2X), _mm_min_ps(t1Y, t2Y)),
+			_mm_max_ps(_mm_min_ps(t1Z, t2Z), _mm_setzero_ps()));
+		__m128 tFar = _mm_min_ps(
+			_mm_min_ps(_mm_max_ps(t1X, t2X), _mm_max_ps(t1Y, t2Y)),
+			_mm_min_ps(_mm_max_ps(t1Z, t2Z), _mm_set1_ps(hit.distance)));
+		mask = _mm_movemask_ps(_mm_cmple_ps(tNear, tFar));
+		_mm_storeu_ps(nearDistances, tNear);
+#else
+		for (int slot = 0; slot < 4; slot++)
+		{
+			glm::vec3 minimum;
+			glm::vec3 maximum;
+			GetSlotBox(node, slot, minimum, maximum);
+			if (IntersectBox(origin, invDirection, minimum, maximum, hit.distance, nearDistances[slot]) == true)
+			{
+				mask |= 1 << slot;
+			}
+		}
+#endif
+
+		// push the children that were hit farthest first, so the
+		// nearest one is searched next
+		int order[4];
+		int hits = 0;
+		for (int slot = 0; slot < 4; slot++)
+		{
+			if (((mask & (1 << slot)) == 0) || (node.count[slot] < 0))
+			{
+				continue;
+			}
+			int position = hits++;
+			while ((position > 0) && (nearDistances[order[position - 1]] < nearDistances[slot]))
+			{
+				order[position] = order[position - 1];
+				position--;
+			}
+			order[position] = slot;
+		}
+		for (int i = 0; (i < hits) && (stackSize < g_StackSize); i++)
+		{
+			stack[stackSize].index = node.child[order[i]];
+			stack[stackSize].count = node.count[order[i]];
+			stack[stackSize].distance = nearDistances[order[i]];
+			stackSize++;
+		}
+	}
+
+	return(hit.entity != SceneEntities::INVALID_ENTITY);
+}
+
+/***********************************************************
+ *  QuerySphere()
+ *
+ *  This method is used for appending every entity whose box
+ *  touches a sphere, testing the four child boxes of each
+ *  visited node at once.
+ ***********************************************************/
+int SceneQuery::QuerySphere(const glm::vec3& center, float radius, std::vector<SceneEntities::ENTITY_ID>& entities) const
+{
+	if (m_nodes.empty() == true)
+	{
+		return(0);
+	}
+
+	size_t firstFound = entities.size();
+	int stack[g_StackSize];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+
+#ifdef SCENE_SIMD_SSE2
+	__m128 centerX = _mm_set1_ps(center.x);
+	__m128 centerY = _mm_set1_ps(center.y);
+	__m128 centerZ = _mm_set1_ps(center.z);
+	__m128 radiusSquared = _mm_set1_ps(radius * radius);
+	__m128 zero = _mm_setzero_ps();
+#endif
+
+	while (stackSize > 0)
+	{
+		const QUERY_NODE& node = m_nodes[stack[--stackSize]];
+		int mask = 0;
+#ifdef SCENE_SIMD_SSE2
+		// the distance outside the box along each axis
+		__m128 outsideX = _mm_max_ps(_mm_max_ps(
+			_mm_sub_ps(_mm_loadu_ps(node.minimumX), centerX),
+			_mm_sub_ps(centerX, _mm_loadu_ps(node.maximumX))), zero);
+		__m128 outsideY = _mm_max_ps(_mm_max_ps(
+			_mm_sub_ps(_mm_loadu_ps(node.minimumY), centerY),
+			_mm_sub_ps(centerY, _mm_loadu_ps(node.maximumY))), zero);
+		__m128 outsideZ = _mm_max_ps(_mm_max_ps(
+			_mm_sub_ps(_mm_loadu_ps(node.minimumZ), centerZ),
+			_mm_sub_ps(centerZ, _mm_loadu_ps(node.maximumZ))), zero);
+		__m128 distanceSquared = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(outsideX, outsideX), _mm_mul_ps(outsideY, outsideY)),
+			_mm_mul_ps(outsideZ, outsideZ));
+		mask = _mm_movemask_ps(_mm_cmple_ps(distanceSquared, radiusSquared));
+#else
+		for (int slot = 0; slot < 4; slot++)
+		{
+			glm::vec3 minimum;
+			glm::vec3 maximum;
+			GetSlotBox(node, slot, minimum, maximum);
+			if (SphereTouchesBox(center, radius, minimum, maximum) == true)
+			{
+				mask |= 1 << slot;
+			}
+		}
+#endif
+
+		for (int slot = 0; slot < 4; slot++)
+		{
+			if (((mask & (1 << slot)) == 0) || (node.count[slot] < 0))
+			{
+				continue;
+			}
+			if (node.count[slot] == 0)
+			{
+				if (stackSize < g_StackSize)
+				{
+					stack[stackSize++] = node.child[slot];
+				}
+				continue;
+			}
+			for (int i = node.child[slot]; i < node.child[slot] + node.count[slot]; i++)
+			{
+				if (SphereTouchesBox(center, radius, m_items[i].minimum, m_items[i].maximum) == true)
+				{
+					entities.push_back(m_items[i].entity);
+				}
+			}
+		}
+	}
+	return((int)(entities.size() - firstFound));
+}
+
+/***********************************************************
+ *  QueryBox()
+ *
+ *  This method is used for appending every entity whose box
+ *  touches a box, testing the four child boxes of each
+ *  visited node at once.
+ ***********************************************************/
+int SceneQuery::QueryBox(const glm::vec3& minimum, const glm::vec3& maximum, std::vector<SceneEntities::ENTITY_ID>& entities) const
+{
+	if (m_nodes.empty() == true)
+	{
+		return(0);
+	}
+
+	size_t firstFound = entities.size();
+	int stack[g_StackSize];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+
+#ifdef SCENE_SIMD_SSE2
+	__m128 queryMinX = _mm_set1_ps(minimum.x);
+	__m128 queryMinY = _mm_set1_ps(minimum.y);
+	__m128 queryMinZ = _mm_set1_ps(minimum.z);
+	__m128 queryMaxX = _mm_set1_ps(maximum.x);
+	__m128 queryMaxY = _mm_set1_ps(maximum.y);
+	__m128 queryMaxZ = _mm_set1_ps(maximum.z);
+#endif
+
+	while (stackSize > 0)
+	{
+		const QUERY_NODE& node = m_nodes[stack[--stackSize]];
+		int mask = 0;
+#ifdef SCENE_SIMD_SSE2
+		__m128 touchX = _mm_and_ps(
+			_mm_cmple_ps(_mm_loadu_ps(node.minimumX), queryMaxX),
+			_mm_cmpge_ps(_mm_loadu_ps(node.maximumX), queryMinX));
+		__m128 touchY = _mm_and_ps(
+			_mm_cmple_ps(_mm_loadu_ps(node.minimumY), queryMaxY),
+			_mm_cmpge_ps(_mm_loadu_ps(node.maximumY), queryMinY));
+		__m128 touchZ = _mm_and_ps(
+			_mm_cmple_ps(_mm_loadu_ps(node.minimumZ), queryMaxZ),
+			_mm_cmpge_ps(_mm_loadu_ps(node.maximumZ), queryMinZ));
+		mask = _mm_movemask_ps(_mm_and_ps(_mm_and_ps(touchX, touchY), touchZ));
+#else
+		for (int slot = 0; slot < 4; slot++)
+		{
+			glm::vec3 slotMin;
+			glm::vec3 slotMax;
+			GetSlotBox(node, slot, slotMin, slotMax);
+			if (BoxesTouch(slotMin, slotMax, minimum, maximum) == true)
+			{
+				mask |= 1 << slot;
+			}
+		}
+#endif
+
+		for (int slot = 0; slot < 4; slot++)
+		{
+			if (((mask & (1 << slot)) == 0) || (node.count[slot] < 0))
+			{
+				continue;
+			}
+			if (node.count[slot] == 0)
+			{
+				if (stackSize < g_StackSize)
+				{
+					stack[stackSize++] = node.child[slot];
+				}
+				continue;
+			}
+			for (int i = node.child[slot]; i < node.child[slot] + node.count[slot]; i++)
+			{
+				if (BoxesTouch(m_items[i].minimum, m_items[i].maximum, minimum, maximum) == true)
+				{
+					entities.push_back(m_items[i].entity);
+				}
+			}
+		}
+	}
+	return((int)(entities.size() - firstFound));
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the size of the hierarchy
+ *  and the work of keeping it up to date.
+ ***********************************************************/
+const SceneQuery::QUERY_STATS& SceneQuery::GetStats() const
+{
+	return(m_stats);
+}
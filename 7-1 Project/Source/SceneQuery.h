@@ -0,0 +1,164 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenequery.h
+// ============
+// find the entities along a ray or inside a sphere or box of the scene
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneEntities.h"
+#include "PrimitiveGeometry.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  SceneQuery
+ *
+ *  This class answers spatial questions about the entities
+ *  of the scene, such as which prop is under the cursor.  The
+ *  world boxes of the entities are gathered into a bounding
+ *  volume hierarchy built with the surface area heuristic,
+ *  which is then collapsed so every node holds the boxes of
+ *  four children side by side, and each visited node tests
+ *  a ray, sphere or box against all four at once with SSE2.
+ *  When entities move the boxes are refit in place, and the
+ *  hierarchy is only built again once refitting has made it
+ *  much slower to search or the entities came and went.  A
+ *  ray can also be tested against the triangles of the
+ *  meshes it reaches, for an exact pick.
+ ***********************************************************/
+class SceneQuery
+{
+public:
+	// constructor
+	SceneQuery();
+
+	// properties for the closest entity along a ray
+	struct RAY_HIT
+	{
+		SceneEntities::ENTITY_ID entity;
+		float distance;
+		// the work of the search
+		int nodesVisited;
+		int entitiesTested;
+	};
+
+	// properties for the size of the hierarchy and the work of
+	// keeping it up to date
+	struct QUERY_STATS
+	{
+		int entities;
+		int nodes;
+		int leaves;
+		int builds;
+		int refits;
+		double buildMilliseconds;
+		double refitMilliseconds;
+		// search cost of the hierarchy since it was built,
+		// where 1 is as good as when it was built
+		float costGrowth;
+	};
+
+private:
+	// properties for an entity and its world box, ordered by
+	// the leaves that hold them
+	struct QUERY_ITEM
+	{
+		SceneEntities::ENTITY_ID entity;
+		glm::vec3 minimum;
+		glm::vec3 maximum;
+	};
+
+	// properties for a node of the two way hierarchy that is
+	// built first, where leaves have an item count and inner
+	// nodes keep their first child, with the second right
+	// after it
+	struct BUILD_NODE
+	{
+		glm::vec3 minimum;
+		glm::vec3 maximum;
+		int firstIndex;
+		int itemCount;
+	};
+
+	// properties for a node holding the boxes of four children
+	// by component, so each one fills a SIMD register
+	struct QUERY_NODE
+	{
+		float minimumX[4];
+		float minimumY[4];
+		float minimumZ[4];
+		float maximumX[4];
+		float maximumY[4];
+		float maximumZ[4];
+		// node of an inner child or first item of a leaf child
+		int child[4];
+		// items of a leaf child, 0 for an inner child or -1 for
+		// an unused slot
+		int count[4];
+	};
+
+	std::vector<QUERY_ITEM> m_items;
+	std::vector<BUILD_NODE> m_buildNodes;
+	std::vector<QUERY_NODE> m_nodes;
+	// CPU copies of the basic shape meshes for exact picks
+	PrimitiveGeometry m_geometry;
+	bool m_bExactTriangles;
+	// search cost of the hierarchy and the number of entities
+	// in the store when it was built
+	float m_buildCost;
+	int m_builtEntities;
+	QUERY_STATS m_stats;
+
+	// split a node of the two way hierarchy until its leaves
+	// are small
+	void SubdivideNode(int nodeIndex, std::vector<glm::vec3>& centers);
+	// add the four way node for a node of the two way
+	// hierarchy, returning its index
+	int CollapseNode(int buildIndex);
+	// get the search cost of the hierarchy
+	float GetSearchCost() const;
+	// test a ray against the triangles of an entity's meshes
+	bool IntersectMeshes(
+		const SceneEntities* pEntities,
+		SceneEntities::ENTITY_ID entity,
+		const glm::vec3& origin,
+		const glm::vec3& direction,
+		float& distance) const;
+
+public:
+	// test rays against the triangles of the meshes they reach
+	// instead of only the boxes around them
+	void SetExactTriangles(bool bExact);
+	// build the hierarchy over the boxes of the entities
+	bool Build(const SceneEntities* pEntities);
+	// refit the hierarchy to the moved entities, building it
+	// again when that is cheaper to search or was needed
+	bool Refit(const SceneEntities* pEntities);
+	// get the number of entities in the hierarchy
+	int GetEntityCount() const;
+
+	// find the closest entity along a ray within a distance,
+	// in lengths of the direction, returning whether one was
+	// hit
+	bool Raycast(
+		const SceneEntities* pEntities,
+		const glm::vec3& origin,
+		const glm::vec3& direction,
+		float maxDistance,
+		RAY_HIT& hit) const;
+	// append the entities whose boxes touch a sphere, returning
+	// how many were found
+	int QuerySphere(const glm::vec3& center, float radius, std::vector<SceneEntities::ENTITY_ID>& entities) const;
+	// append the entities whose boxes touch a box, returning
+	// how many were found
+	int QueryBox(const glm::vec3& minimum, const glm::vec3& maximum, std::vector<SceneEntities::ENTITY_ID>& entities) const;
+	// get the size of the hierarchy and the work of keeping it
+	// up to date
+	const QUERY_STATS& GetStats() const;
+};
@@ -0,0 +1,24 @@
+///////////////////////////////////////////////////////////////////////////////
+// simdsupport.h
+// ============
+// select the SIMD instruction sets used by the CPU-side code paths
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// SSE2 is always present on x64 and is the MSVC default for
+// 32-bit x86 builds, so only other targets use the scalar code
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define SCENE_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// AVX2 paths are only compiled when the build targets it
+// (/arch:AVX2 with MSVC or -mavx2 -mfma with GCC and Clang)
+#if defined(__AVX2__)
+#define SCENE_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
@@ -0,0 +1,1392 @@
+///////////////////////////////////////////////////////////////////////////////
+// softwarerasterizer.cpp
+// ============
+// render the scene draw list on the CPU without an OpenGL context
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SoftwareRasterizer.h"
+#include "SimdSupport.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+// declaration of global variables and defines
+namespace
+{
+	// width and height of the screen tiles in pixels, which
+	// must be a multiple of the eight pixel spans
+	const int g_TileSize = 64;
+	// number of pixels tested against the edges at a time
+	const int g_SpanWidth = 8;
+	// depth the tiles are cleared to, the far clip plane
+	const float g_ClearDepth = 1.0f;
+	// default size of the rendered image
+	const int g_DefaultWidth = 1000;
+	const int g_DefaultHeight = 800;
+
+	// get the time from a steady clock in milliseconds
+	double GetMilliseconds()
+	{
+		return(std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// blend between two clip vertices where an edge crosses a plane
+	template <typename VERTEX>
+	VERTEX LerpVertex(const VERTEX& a, const VERTEX& b, float t)
+	{
+		VERTEX result;
+		result.clip = a.clip + (b.clip - a.clip) * t;
+		result.position = a.position + (b.position - a.position) * t;
+		result.normal = a.normal + (b.normal - a.normal) * t;
+		result.uv = a.uv + (b.uv - a.uv) * t;
+		return(result);
+	}
+
+	// clip a polygon to the side of a plane where distance >= 0,
+	// where the plane is the near plane for a sign of 1 and the
+	// far plane for a sign of -1
+	template <typename VERTEX>
+	int ClipPolygon(const VERTEX* input, int count, VERTEX* output, float sign)
+	{
+		int outputCount = 0;
+		for (int i = 0; i < count; i++)
+		{
+			const VERTEX& current = input[i];
+			const VERTEX& next = input[(i + 1) % count];
+			float currentDistance = current.clip.w + sign * current.clip.z;
+			float nextDistance = next.clip.w + sign * next.clip.z;
+
+			if (currentDistance >= 0.0f)
+			{
+				output[outputCount++] = current;
+			}
+			if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+			{
+				float t = currentDistance / (currentDistance - nextDistance);
+				output[outputCount++] = LerpVertex(current, next, t);
+			}
+		}
+		return(outputCount);
+	}
+
+	// the edges that own the pixel centers lying exactly on them,
+	// so pixels on an edge shared by two triangles are drawn once
+	inline bool IsTopLeft(float a, float b)
+	{
+		return((a > 0.0f) || ((a == 0.0f) && (b > 0.0f)));
+	}
+
+	/*******************************************************
+	 *  CoverSpan()
+	 *
+	 *  Evaluate the three edge functions and the depth for a
+	 *  span of eight pixels on one row, and get a bit mask of
+	 *  the pixels that are inside the triangle, within the
+	 *  last column and nearer than the depth already stored.
+	 *  The edge values are kept for shading the pixels.
+	 *******************************************************/
+	template <typename TRIANGLE>
+	inline unsigned int CoverSpan(
+		const TRIANGLE& triangle,
+		int x,
+		const float rowEdges[3],
+		int lastColumn,
+		const float* depthRow,
+		float edges[3][8],
+		float depths[8])
+	{
+#ifdef SCENE_SIMD_AVX2
+		const __m256 zero = _mm256_setzero_ps();
+		__m256 pixelX = _mm256_add_ps(
+			_mm256_set1_ps((float)x + 0.5f),
+			_mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f));
+
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		__m256 edgeValues[3];
+		for (int i = 0; i < 3; i++)
+		{
+			edgeValues[i] = _mm256_add_ps(
+				_mm256_mul_ps(_mm256_set1_ps(triangle.edgeA[i]), pixelX),
+				_mm256_set1_ps(rowEdges[i]));
+			__m256 test = triangle.bTopLeft[i] ?
+				_mm256_cmp_ps(edgeValues[i], zero, _CMP_GE_OQ) :
+				_mm256_cmp_ps(edgeValues[i], zero, _CMP_GT_OQ);
+			inside = _mm256_and_ps(inside, test);
+			_mm256_storeu_ps(edges[i], edgeValues[i]);
+		}
+
+		// nothing else is needed when no pixel is inside
+		unsigned int mask = (unsigned int)_mm256_movemask_ps(inside);
+		if (mask == 0)
+		{
+			return(0);
+		}
+
+		__m256 depth = _mm256_add_ps(
+			_mm256_set1_ps(triangle.depth0),
+			_mm256_add_ps(
+				_mm256_mul_ps(edgeValues[1], _mm256_set1_ps(triangle.depthScale1)),
+				_mm256_mul_ps(edgeValues[2], _mm256_set1_ps(triangle.depthScale2))));
+		__m256 nearer = _mm256_cmp_ps(depth, _mm256_loadu_ps(depthRow), _CMP_LT_OQ);
+		_mm256_storeu_ps(depths, depth);
+
+		mask &= (unsigned int)_mm256_movemask_ps(nearer);
+#else
+		unsigned int mask = 0;
+		for (int lane = 0; lane < g_SpanWidth; lane++)
+		{
+			float pixelX = (float)(x + lane) + 0.5f;
+			bool bInside = true;
+			for (int i = 0; i < 3; i++)
+			{
+				edges[i][lane] = triangle.edgeA[i] * pixelX + rowEdges[i];
+				bInside = bInside && (triangle.bTopLeft[i] ?
+					(edges[i][lane] >= 0.0f) : (edges[i][lane] > 0.0f));
+			}
+			depths[lane] = triangle.depth0 +
+				(edges[1][lane] * triangle.depthScale1 + edges[2][lane] * triangle.depthScale2);
+			if (bInside && (depths[lane] < depthRow[lane]))
+			{
+				mask |= 1u << lane;
+			}
+		}
+#endif
+
+		// drop the pixels past the last column of the triangle
+		if (lastColumn - x < g_SpanWidth - 1)
+		{
+			mask &= (1u << (lastColumn - x + 1)) - 1u;
+		}
+		return(mask);
+	}
+}
+
+/***********************************************************
+ *  SoftwareRasterizer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SoftwareRasterizer::SoftwareRasterizer()
+{
+	m_width = 0;
+	m_height = 0;
+	m_tilesX = 0;
+	m_tilesY = 0;
+	m_bTexturesLoaded = false;
+	m_pSceneManager = NULL;
+	m_pDrawList = NULL;
+	m_stats.setupMilliseconds = 0.0;
+	m_stats.rasterMilliseconds = 0.0;
+	m_stats.triangles = 0;
+	m_stats.binnedTriangles = 0;
+	m_stats.sprites = 0;
+	m_stats.impostors = 0;
+
+	// default to one worker per hardware thread
+	m_workerThreads = (int)std::thread::hardware_concurrency();
+	if (m_workerThreads < 1)
+	{
+		m_workerThreads = 1;
+	}
+
+	SetResolution(g_DefaultWidth, g_DefaultHeight);
+}
+
+/***********************************************************
+ *  SetResolution()
+ *
+ *  This method is used for setting the width and height of
+ *  the rendered image.
+ ***********************************************************/
+void SoftwareRasterizer::SetResolution(int width, int height)
+{
+	if ((width <= 0) || (height <= 0))
+	{
+		return;
+	}
+
+	m_width = width;
+	m_height = height;
+	m_tilesX = (width + g_TileSize - 1) / g_TileSize;
+	m_tilesY = (height + g_TileSize - 1) / g_TileSize;
+	m_colorBuffer.assign((size_t)width * height * 4, 0);
+}
+
+/***********************************************************
+ *  SetWorkerThreads()
+ *
+ *  This method is used for setting how many threads are used
+ *  to set up and rasterize the triangles of a frame.
+ ***********************************************************/
+void SoftwareRasterizer::SetWorkerThreads(int workerThreads)
+{
+	if (workerThreads > 0)
+	{
+		m_workerThreads = workerThreads;
+	}
+}
+
+/***********************************************************
+ *  LoadTextures()
+ *
+ *  This method is used for building the mipmap levels of the
+ *  texture pixels the scene keeps in memory, with the same
+ *  2x2 box filter that OpenGL uses to generate mipmaps.
+ ***********************************************************/
+void SoftwareRasterizer::LoadTextures(const SceneManager* pSceneManager)
+{
+	m_textures.clear();
+	m_textures.resize(16);
+
+	for (int slot = 0; slot < 16; slot++)
+	{
+		const SceneManager::TEXTURE_IMAGE* pImage = pSceneManager->GetTextureImage(slot);
+		if (NULL == pImage)
+		{
+			continue;
+		}
+
+		std::vector<TEXTURE_LEVEL>& levels = m_textures[slot];
+		TEXTURE_LEVEL level;
+		level.pixels = pImage->pixels;
+		level.width = pImage->width;
+		level.height = pImage->height;
+		levels.push_back(level);
+
+		while ((levels.back().width > 1) || (levels.back().height > 1))
+		{
+			const TEXTURE_LEVEL& source = levels.back();
+			TEXTURE_LEVEL next;
+			next.width = std::max(1, source.width / 2);
+			next.height = std::max(1, source.height / 2);
+			next.pixels.resize((size_t)next.width * next.height * 4);
+
+			for (int y = 0; y < next.height; y++)
+			{
+				int y0 = std::min(y * 2, source.height - 1);
+				int y1 = std::min(y * 2 + 1, source.height - 1);
+				for (int x = 0; x < next.width; x++)
+				{
+					int x0 = std::min(x * 2, source.width - 1);
+					int x1 = std::min(x * 2 + 1, source.width - 1);
+					for (int c = 0; c < 4; c++)
+					{
+						int sum =
+							source.pixels[((size_t)y0 * source.width + x0) * 4 + c] +
+							source.pixels[((size_t)y0 * source.width + x1) * 4 + c] +
+							source.pixels[((size_t)y1 * source.width + x0) * 4 + c] +
+							source.pixels[((size_t)y1 * source.width + x1) * 4 + c];
+						next.pixels[((size_t)y * next.width + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+					}
+				}
+			}
+			levels.push_back(next);
+		}
+	}
+
+	m_bTexturesLoaded = true;
+}
+
+/***********************************************************
+ *  RenderScene()
+ *
+ *  This method is used for rendering the draw list of the
+ *  scene.  The draws are split into contiguous ranges, one
+ *  for each thread, which transform, clip and bin their
+ *  triangles into the screen tiles.  The tiles are then
+ *  rasterized in parallel, and the bins of each tile are
+ *  walked in draw order so blending matches OpenGL.
+ ***********************************************************/
+void SoftwareRasterizer::RenderScene(
+	SceneManager* pSceneManager,
+	const glm::mat4& view,
+	const glm::mat4& projection,
+	const glm::vec3& viewPosition)
+{
+	if (NULL == pSceneManager)
+	{
+		return;
+	}
+
+	double setupStart = GetMilliseconds();
+
+	// record the draws exactly as the OpenGL path would, with
+	// the far prefab instances as impostors when they are on
+	pSceneManager->SetImpostorView(viewPosition);
+	pSceneManager->BuildDrawList();
+	if (m_bTexturesLoaded == false)
+	{
+		LoadTextures(pSceneManager);
+	}
+
+	m_pSceneManager = pSceneManager;
+	m_pDrawList = &pSceneManager->GetDrawList();
+	m_viewPosition = viewPosition;
+	const std::vector<SceneManager::DRAW_COMMAND>& drawList = *m_pDrawList;
+	const int tileCount = m_tilesX * m_tilesY;
+
+	// split the draws into ranges with similar triangle counts
+	int totalTriangles = 0;
+	for (size_t i = 0; i < drawList.size(); i++)
+	{
+		totalTriangles += m_geometry.GetTriangleCount(drawList[i].mesh, drawList[i].parts);
+	}
+
+	int batchCount = std::max(1, std::min(m_workerThreads, (int)drawList.size()));
+	m_batches.resize(batchCount);
+	int drawIndex = 0;
+	int trianglesSoFar = 0;
+	for (int batch = 0; batch < batchCount; batch++)
+	{
+		m_batches[batch].firstDraw = drawIndex;
+		int target = (int)((long long)totalTriangles * (batch + 1) / batchCount);
+		while ((drawIndex < (int)drawList.size()) &&
+			((trianglesSoFar < target) || (batch == batchCount - 1)))
+		{
+			trianglesSoFar += m_geometry.GetTriangleCount(drawList[drawIndex].mesh, drawList[drawIndex].parts);
+			drawIndex++;
+		}
+		m_batches[batch].lastDraw = drawIndex;
+
+		m_batches[batch].triangles.clear();
+		m_batches[batch].tileBins.resize(tileCount);
+		for (int tile = 0; tile < tileCount; tile++)
+		{
+			m_batches[batch].tileBins[tile].clear();
+		}
+	}
+
+	glm::mat4 viewProjection = projection * view;
+	std::vector<std::thread> workers;
+	for (int batch = 1; batch < batchCount; batch++)
+	{
+		workers.push_back(std::thread(
+			&SoftwareRasterizer::SetupDraws,
+			this,
+			std::ref(m_batches[batch]),
+			std::cref(viewProjection)));
+	}
+	SetupDraws(m_batches[0], viewProjection);
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+	workers.clear();
+	SetupImpostors(viewProjection);
+	SetupSprites(pSceneManager->GetParticleSystem(), viewProjection, projection);
+
+	double rasterStart = GetMilliseconds();
+
+	// each thread takes the next tile that is not yet drawn
+	std::atomic<int> nextTile(0);
+	int rasterThreads = std::max(1, std::min(m_workerThreads, tileCount));
+	for (int i = 1; i < rasterThreads; i++)
+	{
+		workers.push_back(std::thread([this, &nextTile, tileCount]()
+		{
+			int tile;
+			while ((tile = nextTile.fetch_add(1)) < tileCount)
+			{
+				RasterizeTile(tile);
+			}
+		}));
+	}
+	int tile;
+	while ((tile = nextTile.fetch_add(1)) < tileCount)
+	{
+		RasterizeTile(tile);
+	}
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+
+	double rasterEnd = GetMilliseconds();
+
+	m_stats.setupMilliseconds = rasterStart - setupStart;
+	m_stats.rasterMilliseconds = rasterEnd - rasterStart;
+	m_stats.triangles = 0;
+	m_stats.binnedTriangles = 0;
+	for (int batch = 0; batch < batchCount; batch++)
+	{
+		m_stats.triangles += (int)m_batches[batch].triangles.size();
+		for (int t = 0; t < tileCount; t++)
+		{
+			m_stats.binnedTriangles += (int)m_batches[batch].tileBins[t].size();
+		}
+	}
+}
+
+/***********************************************************
+ *  SetupDraws()
+ *
+ *  This method is used for transforming the vertices of the
+ *  draws in a batch, clipping their triangles against the
+ *  near and far planes, and binning the visible triangles.
+ ***********************************************************/
+void SoftwareRasterizer::SetupDraws(SETUP_BATCH& batch, const glm::mat4& viewProjection)
+{
+	const std::vector<SceneManager::DRAW_COMMAND>& drawList = *m_pDrawList;
+
+	for (int drawIndex = batch.firstDraw; drawIndex < batch.lastDraw; drawIndex++)
+	{
+		const SceneManager::DRAW_COMMAND& draw = drawList[drawIndex];
+		glm::mat4 modelViewProjection = viewProjection * draw.model;
+		glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(draw.model)));
+
+		for (int part = 0; part < PrimitiveGeometry::PART_INDEX_COUNT; part++)
+		{
+			if (PrimitiveGeometry::IsPartDrawn(draw.mesh, (PrimitiveGeometry::PART_INDEX)part, draw.parts) == false)
+			{
+				continue;
+			}
+
+			const PrimitiveGeometry::MESH_DATA& mesh =
+				m_geometry.GetMeshPart(draw.mesh, (PrimitiveGeometry::PART_INDEX)part);
+
+			// transform every vertex once before the triangles use them
+			batch.vertices.resize(mesh.vertices.size());
+			for (size_t i = 0; i < mesh.vertices.size(); i++)
+			{
+				const PrimitiveGeometry::MESH_VERTEX& source = mesh.vertices[i];
+				CLIP_VERTEX& vertex = batch.vertices[i];
+				glm::vec4 position(source.position, 1.0f);
+				vertex.clip = modelViewProjection * position;
+				vertex.position = glm::vec3(draw.model * position);
+				vertex.normal = normalMatrix * source.normal;
+				vertex.uv = source.uv * draw.uvScale;
+			}
+
+			for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+			{
+				const CLIP_VERTEX& v0 = batch.vertices[mesh.indices[i]];
+				const CLIP_VERTEX& v1 = batch.vertices[mesh.indices[i + 1]];
+				const CLIP_VERTEX& v2 = batch.vertices[mesh.indices[i + 2]];
+
+				bool bNear[3] = {
+					v0.clip.z < -v0.clip.w, v1.clip.z < -v1.clip.w, v2.clip.z < -v2.clip.w };
+				bool bFar[3] = {
+					v0.clip.z > v0.clip.w, v1.clip.z > v1.clip.w, v2.clip.z > v2.clip.w };
+
+				// skip triangles entirely outside one of the planes
+				if ((bNear[0] && bNear[1] && bNear[2]) || (bFar[0] && bFar[1] && bFar[2]))
+				{
+					continue;
+				}
+
+				if (!bNear[0] && !bNear[1] && !bNear[2] && !bFar[0] && !bFar[1] && !bFar[2])
+				{
+					SetupTriangle(batch, v0, v1, v2, drawIndex);
+					continue;
+				}
+
+				// clipping a triangle by two planes gives at most five vertices
+				CLIP_VERTEX polygon[3] = { v0, v1, v2 };
+				CLIP_VERTEX nearClipped[4];
+				CLIP_VERTEX farClipped[5];
+				int count = ClipPolygon(polygon, 3, nearClipped, 1.0f);
+				count = ClipPolygon(nearClipped, count, farClipped, -1.0f);
+				for (int corner = 1; corner + 1 < count; corner++)
+				{
+					SetupTriangle(batch, farClipped[0], farClipped[corner], farClipped[corner + 1], drawIndex);
+				}
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  SetupTriangle()
+ *
+ *  This method is used for projecting a clipped triangle to
+ *  the screen, computing its edge functions, and adding it to
+ *  the bin of every tile its bounds touch.  Both windings are
+ *  kept since the scene draws without face culling.
+ ***********************************************************/
+void SoftwareRasterizer::SetupTriangle(
+	SETUP_BATCH& batch,
+	const CLIP_VERTEX& v0,
+	const CLIP_VERTEX& v1,
+	const CLIP_VERTEX& v2,
+	int drawIndex)
+{
+	const CLIP_VERTEX* vertices[3] = { &v0, &v1, &v2 };
+	RASTER_TRIANGLE triangle;
+	float screenX[3];
+	float screenY[3];
+	float depth[3];
+
+	for (int i = 0; i < 3; i++)
+	{
+		const glm::vec4& clip = vertices[i]->clip;
+		triangle.invW[i] = 1.0f / clip.w;
+		screenX[i] = (clip.x * triangle.invW[i] * 0.5f + 0.5f) * m_width;
+		screenY[i] = (0.5f - clip.y * triangle.invW[i] * 0.5f) * m_height;
+		depth[i] = clip.z * triangle.invW[i];
+		triangle.position[i] = vertices[i]->position;
+		triangle.normal[i] = vertices[i]->normal;
+		triangle.uv[i] = vertices[i]->uv;
+	}
+
+	// each edge runs between the two vertices other than its own
+	for (int i = 0; i < 3; i++)
+	{
+		int a = (i + 1) % 3;
+		int b = (i + 2) % 3;
+		triangle.edgeA[i] = screenY[a] - screenY[b];
+		triangle.edgeB[i] = screenX[b] - screenX[a];
+		triangle.edgeC[i] = screenX[a] * screenY[b] - screenY[a] * screenX[b];
+	}
+
+	float area = triangle.edgeA[0] * screenX[0] + triangle.edgeB[0] * screenY[0] + triangle.edgeC[0];
+	if (area == 0.0f)
+	{
+		return;
+	}
+
+	// flip the edges of back facing triangles so inside is positive
+	if (area < 0.0f)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			triangle.edgeA[i] = -triangle.edgeA[i];
+			triangle.edgeB[i] = -triangle.edgeB[i];
+			triangle.edgeC[i] = -triangle.edgeC[i];
+		}
+		area = -area;
+	}
+
+	for (int i = 0; i < 3; i++)
+	{
+		triangle.bTopLeft[i] = IsTopLeft(triangle.edgeA[i], triangle.edgeB[i]);
+	}
+
+	triangle.invArea = 1.0f / area;
+	triangle.depth0 = depth[0];
+	triangle.depthScale1 = (depth[1] - depth[0]) * triangle.invArea;
+	triangle.depthScale2 = (depth[2] - depth[0]) * triangle.invArea;
+	triangle.drawIndex = drawIndex;
+
+	// clamp the bounds of the pixel centers to the image
+	float minX = std::min(screenX[0], std::min(screenX[1], screenX[2]));
+	float maxX = std::max(screenX[0], std::max(screenX[1], screenX[2]));
+	float minY = std::min(screenY[0], std::min(screenY[1], screenY[2]));
+	float maxY = std::max(screenY[0], std::max(screenY[1], screenY[2]));
+	triangle.minX = std::max(0, (int)std::floor(minX - 0.5f));
+	triangle.minY = std::max(0, (int)std::floor(minY - 0.5f));
+	triangle.maxX = std::min(m_width - 1, (int)std::ceil(maxX - 0.5f));
+	triangle.maxY = std::min(m_height - 1, (int)std::ceil(maxY - 0.5f));
+	if ((triangle.minX > triangle.maxX) || (triangle.minY > triangle.maxY))
+	{
+		return;
+	}
+
+	unsigned int triangleIndex = (unsigned int)batch.triangles.size();
+	batch.triangles.push_back(triangle);
+
+	int firstTileX = triangle.minX / g_TileSize;
+	int lastTileX = triangle.maxX / g_TileSize;
+	int firstTileY = triangle.minY / g_TileSize;
+	int lastTileY = triangle.maxY / g_TileSize;
+	for (int tileY = firstTileY; tileY <= lastTileY; tileY++)
+	{
+		for (int tileX = firstTileX; tileX <= lastTileX; tileX++)
+		{
+			batch.tileBins[tileY * m_tilesX + tileX].push_back(triangleIndex);
+		}
+	}
+}
+
+/***********************************************************
+ *  RasterizeTile()
+ *
+ *  This method is used for drawing the binned triangles of one
+ *  screen tile.  The depth buffer only exists for the tile,
+ *  so it stays in the cache of the thread drawing it.
+ ***********************************************************/
+void SoftwareRasterizer::RasterizeTile(int tileIndex)
+{
+	const int tileX0 = (tileIndex % m_tilesX) * g_TileSize;
+	const int tileY0 = (tileIndex / m_tilesX) * g_TileSize;
+	const int tileX1 = std::min(tileX0 + g_TileSize, m_width) - 1;
+	const int tileY1 = std::min(tileY0 + g_TileSize, m_height) - 1;
+
+	float tileDepth[g_TileSize * g_TileSize];
+	for (int i = 0; i < g_TileSize * g_TileSize; i++)
+	{
+		tileDepth[i] = g_ClearDepth;
+	}
+
+	// clear the tile to the same black as the OpenGL window
+	for (int y = tileY0; y <= tileY1; y++)
+	{
+		unsigned char* row = &m_colorBuffer[((size_t)y * m_width + tileX0) * 4];
+		for (int x = tileX0; x <= tileX1; x++, row += 4)
+		{
+			row[0] = 0;
+			row[1] = 0;
+			row[2] = 0;
+			row[3] = 255;
+		}
+	}
+
+	float edges[3][g_SpanWidth];
+	float depths[g_SpanWidth];
+
+	for (size_t batch = 0; batch < m_batches.size(); batch++)
+	{
+		const std::vector<unsigned int>& bin = m_batches[batch].tileBins[tileIndex];
+		const std::vector<RASTER_TRIANGLE>& triangles = m_batches[batch].triangles;
+
+		for (size_t binIndex = 0; binIndex < bin.size(); binIndex++)
+		{
+			const RASTER_TRIANGLE& triangle = triangles[bin[binIndex]];
+			int minX = std::max(triangle.minX, tileX0);
+			int maxX = std::min(triangle.maxX, tileX1);
+			int minY = std::max(triangle.minY, tileY0);
+			int maxY = std::min(triangle.maxY, tileY1);
+
+			// spans start on multiples of eight within the tile so
+			// they never read past the end of a tile depth row
+			int spanStart = tileX0 + ((minX - tileX0) & ~(g_SpanWidth - 1));
+
+			for (int y = minY; y <= maxY; y++)
+			{
+				float pixelY = (float)y + 0.5f;
+				float rowEdges[3];
+				for (int i = 0; i < 3; i++)
+				{
+					rowEdges[i] = triangle.edgeB[i] * pixelY + triangle.edgeC[i];
+				}
+				float* depthRow = &tileDepth[(y - tileY0) * g_TileSize];
+
+				for (int x = spanStart; x <= maxX; x += g_SpanWidth)
+				{
+					unsigned int mask = CoverSpan(
+						triangle,
+						x,
+						rowEdges,
+						maxX,
+						depthRow + (x - tileX0),
+						edges,
+						depths);
+
+					// the span start can fall left of the triangle bounds
+					if (x < minX)
+					{
+						mask &= ~((1u << (minX - x)) - 1u);
+					}
+
+					while (mask != 0)
+					{
+						int lane = 0;
+						while ((mask & (1u << lane)) == 0)
+						{
+							lane++;
+						}
+						mask &= ~(1u << lane);
+
+						float pixelEdges[3] = { edges[0][lane], edges[1][lane], edges[2][lane] };
+						glm::vec4 color = ShadePixel(triangle, pixelEdges);
+
+						// blend like glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)
+						unsigned char* pixel = &m_colorBuffer[((size_t)y * m_width + x + lane) * 4];
+						float alpha = glm::clamp(color.a, 0.0f, 1.0f);
+						for (int c = 0; c < 3; c++)
+						{
+							float source = glm::clamp(color[c], 0.0f, 1.0f);
+							float blended = source * alpha + (pixel[c] / 255.0f) * (1.0f - alpha);
+							pixel[c] = (unsigned char)(blended * 255.0f + 0.5f);
+						}
+
+						// depth is written for blended draws too, as in OpenGL
+						depthRow[x - tileX0 + lane] = depths[lane];
+					}
+				}
+			}
+		}
+	}
+
+	DrawImpostors(tileIndex, tileDepth);
+	DrawSprites(tileIndex, tileDepth);
+}
+
+/***********************************************************
+ *  SetupImpostors()
+ *
+ *  This method is used for choosing the view of each far
+ *  prefab instance's impostor that faces the camera best,
+ *  and projecting the quad it was baked on to the screen to
+ *  bin it by tile.  The quad covers the sphere around the
+ *  prefab across the view's axes.  The points under a pixel
+ *  on the near and far planes change by a fixed step from
+ *  pixel to pixel, so they are kept in the prefab's local
+ *  space for finding each pixel's ray cheaply.
+ ***********************************************************/
+void SoftwareRasterizer::SetupImpostors(const glm::mat4& viewProjection)
+{
+	int tileCount = m_tilesX * m_tilesY;
+	m_impostorBins.resize(tileCount);
+	for (int tile = 0; tile < tileCount; tile++)
+	{
+		m_impostorBins[tile].clear();
+	}
+	m_impostors.clear();
+	m_stats.impostors = 0;
+
+	const ImpostorAtlas* pAtlas = m_pSceneManager->GetImpostorAtlas();
+	const std::vector<SceneManager::IMPOSTOR_DRAW>& draws = m_pSceneManager->GetImpostorDraws();
+	if ((NULL == pAtlas) || (draws.empty() == true))
+	{
+		return;
+	}
+
+	glm::mat4 inverseViewProjection = glm::inverse(viewProjection);
+	int resolution = pAtlas->GetSettings().resolution;
+	for (size_t i = 0; i < draws.size(); i++)
+	{
+		const SceneManager::IMPOSTOR_DRAW& draw = draws[i];
+		RASTER_IMPOSTOR impostor;
+		impostor.pImpostor = pAtlas->GetImpostor(draw.prefab);
+		if (NULL == impostor.pImpostor)
+		{
+			continue;
+		}
+
+		// the view facing the camera, found in the prefab's own
+		// space so turned and scaled instances pick correctly
+		glm::mat4 inverseModel = glm::inverse(draw.model);
+		glm::vec3 localView = glm::vec3(inverseModel * glm::vec4(m_viewPosition, 1.0f));
+		int viewX = 0;
+		int viewY = 0;
+		pAtlas->FindView(localView - impostor.pImpostor->center, viewX, viewY);
+		impostor.texelX = viewX * resolution;
+		impostor.texelY = viewY * resolution;
+		impostor.center = impostor.pImpostor->center;
+		impostor.direction = pAtlas->GetViewDirection(viewX, viewY);
+		ImpostorAtlas::GetViewAxes(impostor.direction, impostor.right, impostor.up);
+		impostor.model = draw.model;
+		impostor.clipFromLocal = viewProjection * draw.model;
+		impostor.normalMatrix = glm::transpose(glm::inverse(glm::mat3(draw.model)));
+		impostor.materialOverride = draw.materialOverride;
+		impostor.bColorOverride = draw.bColorOverride;
+		impostor.colorOverride = draw.colorOverride;
+
+		// the screen bounds of the quad, leaving out quads that
+		// reach behind the camera
+		float radius = impostor.pImpostor->radius;
+		float minX = 1.0e30f;
+		float minY = 1.0e30f;
+		float maxX = -1.0e30f;
+		float maxY = -1.0e30f;
+		bool bBehind = false;
+		for (int corner = 0; corner < 4; corner++)
+		{
+			glm::vec3 local = impostor.center +
+				impostor.right * ((corner & 1) ? radius : -radius) +
+				impostor.up * ((corner & 2) ? radius : -radius);
+			glm::vec4 clip = impostor.clipFromLocal * glm::vec4(local, 1.0f);
+			if (clip.w <= 1.0e-6f)
+			{
+				bBehind = true;
+				break;
+			}
+			float x = (clip.x / clip.w * 0.5f + 0.5f) * m_width;
+			float y = (0.5f - clip.y / clip.w * 0.5f) * m_height;
+			minX = std::min(minX, x);
+			minY = std::min(minY, y);
+			maxX = std::max(maxX, x);
+			maxY = std::max(maxY, y);
+		}
+		if (bBehind == true)
+		{
+			continue;
+		}
+		impostor.minX = std::max(0, (int)std::floor(minX));
+		impostor.minY = std::max(0, (int)std::floor(minY));
+		impostor.maxX = std::min(m_width - 1, (int)std::floor(maxX));
+		impostor.maxY = std::min(m_height - 1, (int)std::floor(maxY));
+		if ((impostor.minX > impostor.maxX) || (impostor.minY > impostor.maxY))
+		{
+			continue;
+		}
+
+		// the points under pixel corners on the near and far
+		// planes, taken back into the prefab's local space
+		glm::mat4 localFromClip = inverseModel * inverseViewProjection;
+		glm::vec3 planePoints[2][3];
+		const float offsets[3][2] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f } };
+		for (int plane = 0; plane < 2; plane++)
+		{
+			for (int sample = 0; sample < 3; sample++)
+			{
+				glm::vec4 point = localFromClip * glm::vec4(
+					offsets[sample][0] / m_width * 2.0f - 1.0f,
+					1.0f - offsets[sample][1] / m_height * 2.0f,
+					(plane == 0) ? -1.0f : 1.0f,
+					1.0f);
+				planePoints[plane][sample] = glm::vec3(point) / point.w;
+			}
+		}
+		impostor.nearOrigin = planePoints[0][0];
+		impostor.nearStepX = planePoints[0][1] - planePoints[0][0];
+		impostor.nearStepY = planePoints[0][2] - planePoints[0][0];
+		impostor.farOrigin = planePoints[1][0];
+		impostor.farStepX = planePoints[1][1] - planePoints[1][0];
+		impostor.farStepY = planePoints[1][2] - planePoints[1][0];
+
+		unsigned int impostorIndex = (unsigned int)m_impostors.size();
+		m_impostors.push_back(impostor);
+		for (int tileY = impostor.minY / g_TileSize; tileY <= impostor.maxY / g_TileSize; tileY++)
+		{
+			for (int tileX = impostor.minX / g_TileSize; tileX <= impostor.maxX / g_TileSize; tileX++)
+			{
+				m_impostorBins[tileY * m_tilesX + tileX].push_back(impostorIndex);
+			}
+		}
+	}
+	m_stats.impostors = (int)m_impostors.size();
+}
+
+/***********************************************************
+ *  DrawImpostors()
+ *
+ *  This method is used for drawing the impostors binned to a
+ *  tile over its triangles.  Each pixel's ray meets the quad
+ *  of the chosen view at the texel it shows, and the baked
+ *  depth puts the surface back where the parts would be, so
+ *  it is tested against and written to the depth of the
+ *  tile.  The baked color, normal and material are then lit
+ *  like any other surface, with the overrides of the
+ *  instance.
+ ***********************************************************/
+void SoftwareRasterizer::DrawImpostors(int tileIndex, float* tileDepth)
+{
+	const std::vector<unsigned int>& bin = m_impostorBins[tileIndex];
+	if (bin.empty() == true)
+	{
+		return;
+	}
+
+	const int tileX0 = (tileIndex % m_tilesX) * g_TileSize;
+	const int tileY0 = (tileIndex / m_tilesX) * g_TileSize;
+	const int tileX1 = std::min(tileX0 + g_TileSize, m_width) - 1;
+	const int tileY1 = std::min(tileY0 + g_TileSize, m_height) - 1;
+	const int resolution = m_pSceneManager->GetImpostorAtlas()->GetSettings().resolution;
+
+	for (size_t binIndex = 0; binIndex < bin.size(); binIndex++)
+	{
+		const RASTER_IMPOSTOR& impostor = m_impostors[bin[binIndex]];
+		const ImpostorAtlas::PREFAB_IMPOSTOR& atlas = *impostor.pImpostor;
+		float radius = atlas.radius;
+		float invRadius = 1.0f / radius;
+		int minX = std::max(impostor.minX, tileX0);
+		int maxX = std::min(impostor.maxX, tileX1);
+		int minY = std::max(impostor.minY, tileY0);
+		int maxY = std::min(impostor.maxY, tileY1);
+
+		for (int y = minY; y <= maxY; y++)
+		{
+			float pixelY = (float)y + 0.5f;
+			float* depthRow = &tileDepth[(y - tileY0) * g_TileSize];
+			for (int x = minX; x <= maxX; x++)
+			{
+				float pixelX = (float)x + 0.5f;
+				glm::vec3 nearPoint = impostor.nearOrigin + impostor.nearStepX * pixelX + impostor.nearStepY * pixelY;
+				glm::vec3 farPoint = impostor.farOrigin + impostor.farStepX * pixelX + impostor.farStepY * pixelY;
+				glm::vec3 ray = farPoint - nearPoint;
+				float facing = glm::dot(ray, impostor.direction);
+				if (std::fabs(facing) < 1.0e-12f)
+				{
+					continue;
+				}
+
+				// where the ray meets the quad, in radii across it
+				glm::vec3 offset = nearPoint + ray * (glm::dot(impostor.center - nearPoint, impostor.direction) / facing) - impostor.center;
+				float across = glm::dot(offset, impostor.right) * invRadius;
+				float down = glm::dot(offset, impostor.up) * invRadius;
+				if ((std::fabs(across) >= 1.0f) || (std::fabs(down) >= 1.0f))
+				{
+					continue;
+				}
+				int texelX = std::min((int)((across * 0.5f + 0.5f) * resolution), resolution - 1);
+				int texelY = std::min((int)((0.5f - down * 0.5f) * resolution), resolution - 1);
+				size_t texel = (size_t)(impostor.texelY + texelY) * atlas.size + impostor.texelX + texelX;
+				const unsigned char* color = &atlas.colors[texel * 4];
+				if (color[3] == 0)
+				{
+					continue;
+				}
+
+				// the baked surface behind the quad
+				float depthRadii = atlas.depths[texel] / 65535.0f * 2.0f - 1.0f;
+				glm::vec3 local = impostor.center +
+					(impostor.right * across + impostor.up * down + impostor.direction * depthRadii) * radius;
+				glm::vec4 clip = impostor.clipFromLocal * glm::vec4(local, 1.0f);
+				if (clip.w <= 0.0f)
+				{
+					continue;
+				}
+				float depth = clip.z / clip.w;
+				if (depth >= depthRow[x - tileX0])
+				{
+					continue;
+				}
+
+				const unsigned char* normal = &atlas.normals[texel * 4];
+				glm::vec3 worldNormal = glm::normalize(impostor.normalMatrix * glm::vec3(
+					normal[0] / 127.5f - 1.0f,
+					normal[1] / 127.5f - 1.0f,
+					normal[2] / 127.5f - 1.0f));
+				glm::vec4 baseColor(color[0] / 255.0f, color[1] / 255.0f, color[2] / 255.0f, color[3] / 255.0f);
+				if ((impostor.bColorOverride == true) && (normal[3] != ImpostorAtlas::TEXTURED_TEXEL))
+				{
+					baseColor = impostor.colorOverride;
+				}
+				int materialIndex = (atlas.materials[texel] == ImpostorAtlas::NO_MATERIAL) ? -1 : atlas.materials[texel];
+				if (impostor.materialOverride >= 0)
+				{
+					materialIndex = impostor.materialOverride;
+				}
+				glm::vec3 position = glm::vec3(impostor.model * glm::vec4(local, 1.0f));
+				glm::vec3 lit = ShadeSurface(position, worldNormal, glm::vec3(baseColor), materialIndex);
+
+				// blend like glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)
+				unsigned char* pixel = &m_colorBuffer[((size_t)y * m_width + x) * 4];
+				float alpha = glm::clamp(baseColor.a, 0.0f, 1.0f);
+				for (int c = 0; c < 3; c++)
+				{
+					float source = glm::clamp(lit[c], 0.0f, 1.0f);
+					float blended = source * alpha + (pixel[c] / 255.0f) * (1.0f - alpha);
+					pixel[c] = (unsigned char)(blended * 255.0f + 0.5f);
+				}
+
+				// depth is written for blended texels too, as for
+				// the triangles
+				depthRow[x - tileX0] = depth;
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  SetupSprites()
+ *
+ *  This method is used for projecting the particle billboards
+ *  to the screen as round sprites and binning them by tile.
+ *  The billboards come opaque first and blended last, sorted
+ *  back to front, so each bin keeps the order they are drawn
+ *  in.  A billboard is as wide as its size at its depth.
+ ***********************************************************/
+void SoftwareRasterizer::SetupSprites(
+	ParticleSystem* pParticles,
+	const glm::mat4& viewProjection,
+	const glm::mat4& projection)
+{
+	int tileCount = m_tilesX * m_tilesY;
+	m_spriteBins.resize(tileCount);
+	for (int tile = 0; tile < tileCount; tile++)
+	{
+		m_spriteBins[tile].clear();
+	}
+	m_sprites.clear();
+	m_billboards.clear();
+	m_stats.sprites = 0;
+	if (NULL == pParticles)
+	{
+		return;
+	}
+
+	pParticles->BuildBillboards(m_viewPosition, m_billboards);
+	size_t firstBlended = m_billboards.size() - pParticles->GetStats().sortedBillboards;
+
+	for (size_t i = 0; i < m_billboards.size(); i++)
+	{
+		const ParticleSystem::PARTICLE_BILLBOARD& billboard = m_billboards[i];
+		glm::vec4 clip = viewProjection * glm::vec4(billboard.position, 1.0f);
+		if ((clip.w <= 0.0f) || (clip.z < -clip.w) || (clip.z > clip.w))
+		{
+			continue;
+		}
+
+		float invW = 1.0f / clip.w;
+		RASTER_SPRITE sprite;
+		sprite.x = (clip.x * invW * 0.5f + 0.5f) * m_width;
+		sprite.y = (0.5f - clip.y * invW * 0.5f) * m_height;
+		sprite.radius = 0.5f * billboard.size * projection[1][1] * invW * 0.5f * m_height;
+		sprite.depth = clip.z * invW;
+		sprite.color = billboard.color;
+		sprite.bBlended = (i >= firstBlended);
+
+		// sprites under a pixel still cover the one they fall in
+		float reach = std::max(sprite.radius, 0.5f);
+		int minX = std::max(0, (int)std::floor(sprite.x - reach));
+		int minY = std::max(0, (int)std::floor(sprite.y - reach));
+		int maxX = std::min(m_width - 1, (int)std::floor(sprite.x + reach));
+		int maxY = std::min(m_height - 1, (int)std::floor(sprite.y + reach));
+		if ((minX > maxX) || (minY > maxY))
+		{
+			continue;
+		}
+
+		unsigned int spriteIndex = (unsigned int)m_sprites.size();
+		m_sprites.push_back(sprite);
+		for (int tileY = minY / g_TileSize; tileY <= maxY / g_TileSize; tileY++)
+		{
+			for (int tileX = minX / g_TileSize; tileX <= maxX / g_TileSize; tileX++)
+			{
+				m_spriteBins[tileY * m_tilesX + tileX].push_back(spriteIndex);
+			}
+		}
+	}
+	m_stats.sprites = (int)m_sprites.size();
+}
+
+/***********************************************************
+ *  DrawSprites()
+ *
+ *  This method is used for splatting the sprites binned to a
+ *  tile over its triangles.  Opaque sprites are hard discs
+ *  that write depth, while blended sprites fade out towards
+ *  their edge and leave the depth alone.  A sprite smaller
+ *  than a pixel covers the pixel it falls in, faded by the
+ *  share of the pixel it would cover.
+ ***********************************************************/
+void SoftwareRasterizer::DrawSprites(int tileIndex, float* tileDepth)
+{
+	const std::vector<unsigned int>& bin = m_spriteBins[tileIndex];
+	if (bin.empty() == true)
+	{
+		return;
+	}
+
+	const int tileX0 = (tileIndex % m_tilesX) * g_TileSize;
+	const int tileY0 = (tileIndex / m_tilesX) * g_TileSize;
+	const int tileX1 = std::min(tileX0 + g_TileSize, m_width) - 1;
+	const int tileY1 = std::min(tileY0 + g_TileSize, m_height) - 1;
+
+	for (size_t binIndex = 0; binIndex < bin.size(); binIndex++)
+	{
+		const RASTER_SPRITE& sprite = m_sprites[bin[binIndex]];
+		bool bTiny = (sprite.radius < 0.5f);
+		float reach = bTiny ? 0.5f : sprite.radius;
+		int minX = std::max(tileX0, (int)std::floor(sprite.x - reach));
+		int minY = std::max(tileY0, (int)std::floor(sprite.y - reach));
+		int maxX = std::min(tileX1, (int)std::floor(sprite.x + reach));
+		int maxY = std::min(tileY1, (int)std::floor(sprite.y + reach));
+		if (bTiny == true)
+		{
+			minX = maxX = (int)std::floor(sprite.x);
+			minY = maxY = (int)std::floor(sprite.y);
+			if ((minX < tileX0) || (minX > tileX1) || (minY < tileY0) || (minY > tileY1))
+			{
+				continue;
+			}
+		}
+
+		float invRadiusSquared = 1.0f / (reach * reach);
+		float coverage = bTiny ? (sprite.radius * sprite.radius) * 4.0f : 1.0f;
+
+		for (int y = minY; y <= maxY; y++)
+		{
+			float* depthRow = &tileDepth[(y - tileY0) * g_TileSize];
+			float offsetY = (float)y + 0.5f - sprite.y;
+			for (int x = minX; x <= maxX; x++)
+			{
+				if (sprite.depth >= depthRow[x - tileX0])
+				{
+					continue;
+				}
+
+				float alpha = sprite.color.a * coverage;
+				if (bTiny == false)
+				{
+					float offsetX = (float)x + 0.5f - sprite.x;
+					float distance = (offsetX * offsetX + offsetY * offsetY) * invRadiusSquared;
+					if (distance > 1.0f)
+					{
+						continue;
+					}
+					if (sprite.bBlended == true)
+					{
+						alpha *= 1.0f - distance;
+					}
+				}
+
+				// blend like glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)
+				unsigned char* pixel = &m_colorBuffer[((size_t)y * m_width + x) * 4];
+				alpha = glm::clamp(alpha, 0.0f, 1.0f);
+				for (int c = 0; c < 3; c++)
+				{
+					float source = glm::clamp(sprite.color[c], 0.0f, 1.0f);
+					float blended = source * alpha + (pixel[c] / 255.0f) * (1.0f - alpha);
+					pixel[c] = (unsigned char)(blended * 255.0f + 0.5f);
+				}
+				if (sprite.bBlended == false)
+				{
+					depthRow[x - tileX0] = sprite.depth;
+				}
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  ShadePixel()
+ *
+ *  This method is used for getting the color of one covered
+ *  pixel.  The attributes are interpolated with perspective
+ *  correction and lit with the ambient, diffuse and specular
+ *  terms of every light, as the scene fragment shader does.
+ ***********************************************************/
+glm::vec4 SoftwareRasterizer::ShadePixel(
+	const RASTER_TRIANGLE& triangle,
+	const float edges[3]) const
+{
+	const SceneManager::DRAW_COMMAND& draw = (*m_pDrawList)[triangle.drawIndex];
+
+	// perspective correct weights of the three vertices
+	float weights[3];
+	float weightSum = 0.0f;
+	for (int i = 0; i < 3; i++)
+	{
+		weights[i] = edges[i] * triangle.invW[i];
+		weightSum += weights[i];
+	}
+	float invWeightSum = 1.0f / weightSum;
+	for (int i = 0; i < 3; i++)
+	{
+		weights[i] *= invWeightSum;
+	}
+
+	glm::vec3 position =
+		triangle.position[0] * weights[0] +
+		triangle.position[1] * weights[1] +
+		triangle.position[2] * weights[2];
+	glm::vec3 normal = glm::normalize(
+		triangle.normal[0] * weights[0] +
+		triangle.normal[1] * weights[1] +
+		triangle.normal[2] * weights[2]);
+
+	glm::vec3 baseColor(draw.color.r, draw.color.g, draw.color.b);
+	float alpha = draw.color.a;
+
+	if ((draw.bUseTexture == true) && (draw.textureSlot >= 0) &&
+		(draw.textureSlot < (int)m_textures.size()) &&
+		(m_textures[draw.textureSlot].empty() == false))
+	{
+		// the texture coordinates one pixel right and one pixel
+		// down give the footprint used to pick the mipmap level
+		glm::vec2 uvs[3];
+		const float offsets[3][2] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f } };
+		for (int sample = 0; sample < 3; sample++)
+		{
+			float sampleWeights[3];
+			float sum = 0.0f;
+			for (int i = 0; i < 3; i++)
+			{
+				float edge = edges[i] +
+					triangle.edgeA[i] * offsets[sample][0] +
+					triangle.edgeB[i] * offsets[sample][1];
+				sampleWeights[i] = edge * triangle.invW[i];
+				sum += sampleWeights[i];
+			}
+			uvs[sample] =
+				(triangle.uv[0] * sampleWeights[0] +
+				triangle.uv[1] * sampleWeights[1] +
+				triangle.uv[2] * sampleWeights[2]) * (1.0f / sum);
+		}
+
+		const TEXTURE_LEVEL& baseLevel = m_textures[draw.textureSlot][0];
+		glm::vec2 size((float)baseLevel.width, (float)baseLevel.height);
+		float footprintX = glm::length((uvs[1] - uvs[0]) * size);
+		float footprintY = glm::length((uvs[2] - uvs[0]) * size);
+
+		baseColor = SampleTexture(draw.textureSlot, uvs[0], std::max(footprintX, footprintY));
+		alpha = 1.0f;
+	}
+
+	return(glm::vec4(ShadeSurface(position, normal, baseColor, draw.materialIndex), alpha));
+}
+
+/***********************************************************
+ *  ShadeSurface()
+ *
+ *  This method is used for lighting a point of a surface with
+ *  the ambient, diffuse and specular terms of every light,
+ *  as the scene fragment shader does.
+ ***********************************************************/
+glm::vec3 SoftwareRasterizer::ShadeSurface(
+	const glm::vec3& position,
+	const glm::vec3& normal,
+	const glm::vec3& baseColor,
+	int materialIndex) const
+{
+	// unset materials are black, as the zeroed shader values are
+	glm::vec3 ambientColor(0.0f);
+	glm::vec3 diffuseColor(0.0f);
+	glm::vec3 specularColor(0.0f);
+	float ambientStrength = 0.0f;
+	if (materialIndex >= 0)
+	{
+		const SceneManager::OBJECT_MATERIAL& material =
+			m_pSceneManager->GetObjectMaterials()[materialIndex];
+		ambientColor = material.ambientColor;
+		diffuseColor = material.diffuseColor;
+		specularColor = material.specularColor;
+		ambientStrength = material.ambientStrength;
+	}
+
+	glm::vec3 viewDirection = glm::normalize(m_viewPosition - position);
+	glm::vec3 phong(0.0f);
+	const std::vector<SceneManager::LIGHT_SOURCE>& lights = m_pSceneManager->GetLightSources();
+	for (size_t i = 0; i < lights.size(); i++)
+	{
+		const SceneManager::LIGHT_SOURCE& light = lights[i];
+
+		glm::vec3 ambient = light.ambientColor * ambientColor * ambientStrength;
+
+		glm::vec3 lightDirection = glm::normalize(light.position - position);
+		float impact = std::max(glm::dot(normal, lightDirection), 0.0f);
+		glm::vec3 diffuse = light.diffuseColor * diffuseColor * impact;
+
+		glm::vec3 reflectDirection = glm::reflect(-lightDirection, normal);
+		float specularComponent = std::pow(
+			std::max(glm::dot(viewDirection, reflectDirection), 0.0f),
+			light.focalStrength);
+		glm::vec3 specular = light.specularColor * specularColor *
+			(light.specularIntensity * specularComponent);
+
+		phong += ambient + diffuse + specular;
+	}
+
+	return(phong * baseColor);
+}
+
+/***********************************************************
+ *  SampleTexture()
+ *
+ *  This method is used for sampling a texture slot with
+ *  repeating coordinates, blending bilinear samples from the
+ *  two mipmap levels nearest to the pixel footprint.
+ ***********************************************************/
+glm::vec3 SoftwareRasterizer::SampleTexture(
+	int textureSlot,
+	glm::vec2 uv,
+	float texelsPerPixel) const
+{
+	const std::vector<TEXTURE_LEVEL>& levels = m_textures[textureSlot];
+
+	float lod = (texelsPerPixel > 1.0f) ? std::log2(texelsPerPixel) : 0.0f;
+	lod = std::min(lod, (float)(levels.size() - 1));
+	int level0 = (int)lod;
+	int level1 = std::min(level0 + 1, (int)levels.size() - 1);
+	float levelBlend = lod - (float)level0;
+
+	glm::vec3 colors[2];
+	const int sampledLevels[2] = { level0, level1 };
+	for (int i = 0; i < 2; i++)
+	{
+		const TEXTURE_LEVEL& level = levels[sampledLevels[i]];
+		float x = uv.x * level.width - 0.5f;
+		float y = uv.y * level.height - 0.5f;
+		float floorX = std::floor(x);
+		float floorY = std::floor(y);
+		float fx = x - floorX;
+		float fy = y - floorY;
+
+		// repeat the texture outside the 0 to 1 coordinates
+		int x0 = ((int)floorX % level.width + level.width) % level.width;
+		int y0 = ((int)floorY % level.height + level.height) % level.height;
+		int x1 = (x0 + 1) % level.width;
+		int y1 = (y0 + 1) % level.height;
+
+		const unsigned char* p00 = &level.pixels[((size_t)y0 * level.width + x0) * 4];
+		const unsigned char* p10 = &level.pixels[((size_t)y0 * level.width + x1) * 4];
+		const unsigned char* p01 = &level.pixels[((size_t)y1 * level.width + x0) * 4];
+		const unsigned char* p11 = &level.pixels[((size_t)y1 * level.width + x1) * 4];
+		for (int c = 0; c < 3; c++)
+		{
+			float top = p00[c] + (p10[c] - p00[c]) * fx;
+			float bottom = p01[c] + (p11[c] - p01[c]) * fx;
+			colors[i][c] = (top + (bottom - top) * fy) * (1.0f / 255.0f);
+		}
+	}
+
+	return(colors[0] + (colors[1] - colors[0]) * levelBlend);
+}
+
+/***********************************************************
+ *  GetPixels()
+ *
+ *  This method is used for getting the rendered RGBA pixels,
+ *  with the top row of the image first.
+ ***********************************************************/
+const unsigned char* SoftwareRasterizer::GetPixels() const
+{
+	return(&m_colorBuffer[0]);
+}
+
+int SoftwareRasterizer::GetWidth() const
+{
+	return(m_width);
+}
+
+int SoftwareRasterizer::GetHeight() const
+{
+	return(m_height);
+}
+
+/***********************************************************
+ *  GetFrameStats()
+ *
+ *  This method is used for getting the timing of the setup
+ *  and rasterization of the last frame and its triangle
+ *  counts, where binned triangles count each tile once.
+ ***********************************************************/
+const SoftwareRasterizer::FRAME_STATS& SoftwareRasterizer::GetFrameStats() const
+{
+	return(m_stats);
+}
+
+/***********************************************************
+ *  SaveImage()
+ *
+ *  This method is used for writing the rendered image to a
+ *  binary PPM file, which needs no image library.
+ ***********************************************************/
+bool SoftwareRasterizer::SaveImage(const char* filename) const
+{
+	FILE* pFile = fopen(filename, "wb");
+	if (NULL == pFile)
+	{
+		return(false);
+	}
+
+	fprintf(pFile, "P6\n%d %d\n255\n", m_width, m_height);
+
+	std::vector<unsigned char> row((size_t)m_width * 3);
+	bool bReturn = true;
+	for (int y = 0; (y < m_height) && bReturn; y++)
+	{
+		const unsigned char* source = &m_colorBuffer[(size_t)y * m_width * 4];
+		for (int x = 0; x < m_width; x++)
+		{
+			row[x * 3] = source[x * 4];
+			row[x * 3 + 1] = source[x * 4 + 1];
+			row[x * 3 + 2] = source[x * 4 + 2];
+		}
+		bReturn = (fwrite(&row[0], 1, row.size(), pFile) == row.size());
+	}
+
+	fclose(pFile);
+	return(bReturn);
+}
@@ -0,0 +1,255 @@
+///////////////////////////////////////////////////////////////////////////////
+// softwarerasterizer.h
+// ============
+// render the scene draw list on the CPU without an OpenGL context
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+#include "PrimitiveGeometry.h"
+#include "ParticleSystem.h"
+#include "ImpostorAtlas.h"
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  SoftwareRasterizer
+ *
+ *  This class renders the draw list recorded by the scene
+ *  manager into an image in memory.  Triangles are set up
+ *  and sorted into screen tiles by one set of threads, then
+ *  each tile is rasterized by whichever thread takes it next,
+ *  testing eight pixels at a time against the triangle edges
+ *  and shading them with the same Phong lighting, materials
+ *  and textures as the scene shader.  Far prefab instances
+ *  are drawn as quads that look up the view of their
+ *  impostor facing the camera, lighting the baked surface
+ *  with the same shading.  The billboards of the scene's
+ *  particles are then splatted into each tile as round
+ *  sprites, tested against the depth of the triangles.
+ ***********************************************************/
+class SoftwareRasterizer
+{
+public:
+	// constructor
+	SoftwareRasterizer();
+
+	// properties for the timing and size of the last frame
+	struct FRAME_STATS
+	{
+		double setupMilliseconds;
+		double rasterMilliseconds;
+		int triangles;
+		int binnedTriangles;
+		int sprites;
+		int impostors;
+	};
+
+private:
+	// properties for one level of a mipmapped texture
+	struct TEXTURE_LEVEL
+	{
+		std::vector<unsigned char> pixels;
+		int width;
+		int height;
+	};
+
+	// properties for a triangle that is ready to be rasterized
+	struct RASTER_TRIANGLE
+	{
+		// edge functions A*x + B*y + C, each one opposite the
+		// vertex with the same index and positive inside
+		float edgeA[3];
+		float edgeB[3];
+		float edgeC[3];
+		// whether pixel centers exactly on an edge are covered
+		bool bTopLeft[3];
+		// one over twice the area, turning edges into weights
+		float invArea;
+		// depth at the first vertex and its change per weight
+		float depth0;
+		float depthScale1;
+		float depthScale2;
+		// one over the clip space w of each vertex
+		float invW[3];
+		// world space attributes of each vertex
+		glm::vec3 position[3];
+		glm::vec3 normal[3];
+		glm::vec2 uv[3];
+		// screen bounds of the triangle in pixels
+		int minX;
+		int minY;
+		int maxX;
+		int maxY;
+		// index of the draw the triangle belongs to
+		int drawIndex;
+	};
+
+	// properties for a particle billboard that is ready to
+	// be splatted, in pixels
+	struct RASTER_SPRITE
+	{
+		float x;
+		float y;
+		float radius;
+		float depth;
+		glm::vec4 color;
+		// blended sprites do not write depth
+		bool bBlended;
+	};
+
+	// properties for a far prefab instance that is ready to
+	// be drawn from the view of its impostor facing the camera
+	struct RASTER_IMPOSTOR
+	{
+		const ImpostorAtlas::PREFAB_IMPOSTOR* pImpostor;
+		// first texel of the view in the atlases
+		int texelX;
+		int texelY;
+		// sphere and view axes in the prefab's local space
+		glm::vec3 center;
+		glm::vec3 right;
+		glm::vec3 up;
+		glm::vec3 direction;
+		// points on the near and far planes under pixel 0, 0 and
+		// their change for each pixel across and down, in the
+		// prefab's local space
+		glm::vec3 nearOrigin;
+		glm::vec3 nearStepX;
+		glm::vec3 nearStepY;
+		glm::vec3 farOrigin;
+		glm::vec3 farStepX;
+		glm::vec3 farStepY;
+		glm::mat4 model;
+		glm::mat4 clipFromLocal;
+		glm::mat3 normalMatrix;
+		int materialOverride;
+		bool bColorOverride;
+		glm::vec4 colorOverride;
+		// screen bounds of the quad in pixels
+		int minX;
+		int minY;
+		int maxX;
+		int maxY;
+	};
+
+	// properties for a vertex during clipping and setup
+	struct CLIP_VERTEX
+	{
+		glm::vec4 clip;
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 uv;
+	};
+
+	// triangles and tile bins built by one setup thread
+	struct SETUP_BATCH
+	{
+		std::vector<RASTER_TRIANGLE> triangles;
+		std::vector<std::vector<unsigned int> > tileBins;
+		std::vector<CLIP_VERTEX> vertices;
+		int firstDraw;
+		int lastDraw;
+	};
+
+	// width and height of the rendered image
+	int m_width;
+	int m_height;
+	// number of tiles across and down the image
+	int m_tilesX;
+	int m_tilesY;
+	// number of threads used for setup and rasterization
+	int m_workerThreads;
+	// rendered RGBA pixels, top row first
+	std::vector<unsigned char> m_colorBuffer;
+	// CPU copies of the basic shape meshes
+	PrimitiveGeometry m_geometry;
+	// mipmap levels of each scene texture slot
+	std::vector<std::vector<TEXTURE_LEVEL> > m_textures;
+	bool m_bTexturesLoaded;
+	// setup output of each thread, in draw order
+	std::vector<SETUP_BATCH> m_batches;
+	// particle billboards of the frame, as sprites binned by
+	// tile in the order they are drawn
+	std::vector<ParticleSystem::PARTICLE_BILLBOARD> m_billboards;
+	std::vector<RASTER_SPRITE> m_sprites;
+	std::vector<std::vector<unsigned int> > m_spriteBins;
+	// impostors of the frame binned by tile
+	std::vector<RASTER_IMPOSTOR> m_impostors;
+	std::vector<std::vector<unsigned int> > m_impostorBins;
+	// the frame being rendered
+	const SceneManager* m_pSceneManager;
+	const std::vector<SceneManager::DRAW_COMMAND>* m_pDrawList;
+	glm::vec3 m_viewPosition;
+	// timing and size of the last frame
+	FRAME_STATS m_stats;
+
+	// build the mipmap levels of every scene texture
+	void LoadTextures(const SceneManager* pSceneManager);
+	// transform, clip and bin the triangles of a range of draws
+	void SetupDraws(SETUP_BATCH& batch, const glm::mat4& viewProjection);
+	// set up one clipped triangle and add it to the tile bins
+	void SetupTriangle(
+		SETUP_BATCH& batch,
+		const CLIP_VERTEX& v0,
+		const CLIP_VERTEX& v1,
+		const CLIP_VERTEX& v2,
+		int drawIndex);
+	// project the particle billboards and bin their sprites
+	void SetupSprites(
+		ParticleSystem* pParticles,
+		const glm::mat4& viewProjection,
+		const glm::mat4& projection);
+	// project the impostor quads and bin them
+	void SetupImpostors(const glm::mat4& viewProjection);
+	// rasterize every binned triangle that touches a tile
+	void RasterizeTile(int tileIndex);
+	// draw the impostors binned to a tile over its triangles
+	void DrawImpostors(int tileIndex, float* tileDepth);
+	// splat the sprites binned to a tile over its triangles
+	void DrawSprites(int tileIndex, float* tileDepth);
+	// get the lit color of one covered pixel
+	glm::vec4 ShadePixel(
+		const RASTER_TRIANGLE& triangle,
+		const float edges[3]) const;
+	// light a point of a surface as the scene shader does
+	glm::vec3 ShadeSurface(
+		const glm::vec3& position,
+		const glm::vec3& normal,
+		const glm::vec3& baseColor,
+		int materialIndex) const;
+	// sample a texture slot with trilinear filtering
+	glm::vec3 SampleTexture(
+		int textureSlot,
+		glm::vec2 uv,
+		float texelsPerPixel) const;
+
+public:
+	// set the size of the rendered image
+	void SetResolution(int width, int height);
+	// set the number of threads used to render a frame
+	void SetWorkerThreads(int workerThreads);
+
+	// render the draw list of the scene from the passed in view
+	void RenderScene(
+		SceneManager* pSceneManager,
+		const glm::mat4& view,
+		const glm::mat4& projection,
+		const glm::vec3& viewPosition);
+
+	// get the rendered RGBA pixels, top row first
+	const unsigned char* GetPixels() const;
+	int GetWidth() const;
+	int GetHeight() const;
+	// get the timing and size of the last frame
+	const FRAME_STATS& GetFrameStats() const;
+	// write the rendered image to a binary PPM file
+	bool SaveImage(const char* filename) const;
+};
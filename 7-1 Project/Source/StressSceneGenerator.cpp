@@ -0,0 +1,217 @@
+///////////////////////////////////////////////////////////////////////////////
+// stressscenegenerator.cpp
+// ============
+// generate large seeded scenes of props for scaling benchmarks
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "StressSceneGenerator.h"
+#include "SceneEntities.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// declaration of global variables and defines
+namespace
+{
+	// number of clusters the clustered layout gathers props in
+	const int g_ClusterCount = 16;
+	// height of the space the props are spread through
+	const float g_SceneHeight = 6.0f;
+	// share of the space between props that each one fills
+	const float g_PropFill = 0.6f;
+	// alpha of the transparent props
+	const float g_TransparentAlpha = 0.35f;
+}
+
+/***********************************************************
+ *  StressSceneGenerator()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+StressSceneGenerator::StressSceneGenerator()
+{
+	m_randomState = 1;
+}
+
+/***********************************************************
+ *  NextRandom()
+ *
+ *  This method is used for getting the next number of the
+ *  xorshift sequence started by the seed.
+ ***********************************************************/
+uint32_t StressSceneGenerator::NextRandom()
+{
+	m_randomState ^= m_randomState << 13;
+	m_randomState ^= m_randomState >> 17;
+	m_randomState ^= m_randomState << 5;
+	return(m_randomState);
+}
+
+/***********************************************************
+ *  NextFloat()
+ *
+ *  This method is used for getting a random number from 0 up
+ *  to but not including 1, from the top 24 bits of the next
+ *  number so every value is exact in a float.
+ ***********************************************************/
+float StressSceneGenerator::NextFloat()
+{
+	return((float)(NextRandom() >> 8) * (1.0f / 16777216.0f));
+}
+
+/***********************************************************
+ *  Generate()
+ *
+ *  This method is used for clearing the entities and filling
+ *  them with the props of a generated scene.  Every prop is
+ *  one of the basic shape meshes, sized so the props fill
+ *  about the same share of the space whatever their number,
+ *  with a random turn and one of the first materials and
+ *  textures of the scene.
+ ***********************************************************/
+void StressSceneGenerator::Generate(
+	const STRESS_SETTINGS& settings,
+	int materialCount,
+	int textureCount,
+	SceneEntities* pEntities)
+{
+	if (NULL == pEntities)
+	{
+		return;
+	}
+	pEntities->Clear();
+
+	// a seed of 0 would keep the sequence at 0
+	m_randomState = (settings.seed != 0) ? settings.seed : 1;
+
+	int materials = materialCount;
+	if (settings.materialVariety > 0)
+	{
+		materials = std::min(settings.materialVariety, materialCount);
+	}
+	int textures = textureCount;
+	if (settings.textureVariety > 0)
+	{
+		textures = std::min(settings.textureVariety, textureCount);
+	}
+
+	int objectCount = std::max(settings.objectCount, 0);
+	float extent = std::max(settings.extent, 0.1f);
+	int gridSide = std::max(1, (int)std::ceil(std::sqrt((double)objectCount)));
+	float spacing = 2.0f * extent / std::max(1.0f, std::sqrt((float)objectCount));
+	float propSize = std::max(spacing * g_PropFill, 0.01f);
+
+	// the clusters are placed first so the props do not change
+	// the cluster centers of a seed
+	float clusterX[g_ClusterCount];
+	float clusterZ[g_ClusterCount];
+	for (int cluster = 0; cluster < g_ClusterCount; cluster++)
+	{
+		clusterX[cluster] = (NextFloat() * 2.0f - 1.0f) * extent * 0.8f;
+		clusterZ[cluster] = (NextFloat() * 2.0f - 1.0f) * extent * 0.8f;
+	}
+
+	SceneEntities::ENTITY_DESC desc;
+	desc.parts = SceneManager::PART_ALL;
+	desc.uvScale = glm::vec2(1.0f, 1.0f);
+	desc.samplerFilter = TextureSamplers::FILTER_TRILINEAR;
+	desc.samplerWrap = TextureSamplers::WRAP_REPEAT;
+	for (int i = 0; i < objectCount; i++)
+	{
+		switch (settings.layout)
+		{
+		case LAYOUT_CLUSTERED:
+		{
+			// the sum of three random numbers gathers the props
+			// around the center of their cluster
+			int cluster = (int)(NextRandom() % g_ClusterCount);
+			float offsetX = (NextFloat() + NextFloat() + NextFloat() - 1.5f) * extent * 0.25f;
+			float offsetZ = (NextFloat() + NextFloat() + NextFloat() - 1.5f) * extent * 0.25f;
+			desc.position = glm::vec3(clusterX[cluster] + offsetX, NextFloat() * g_SceneHeight, clusterZ[cluster] + offsetZ);
+			break;
+		}
+		case LAYOUT_GRID:
+			desc.position = glm::vec3(
+				-extent + ((i % gridSide) + 0.5f) * spacing,
+				propSize * 0.5f,
+				-extent + ((i / gridSide) + 0.5f) * spacing);
+			break;
+		default:
+			desc.position = glm::vec3(
+				(NextFloat() * 2.0f - 1.0f) * extent,
+				NextFloat() * g_SceneHeight,
+				(NextFloat() * 2.0f - 1.0f) * extent);
+			break;
+		}
+
+		desc.mesh = (SceneManager::MESH_TYPE)(NextRandom() % SceneManager::MESH_TYPE_COUNT);
+		desc.rotation = glm::vec3(0.0f, NextFloat() * 360.0f, 0.0f);
+		desc.scale = glm::vec3(propSize * (0.5f + NextFloat() * 0.5f));
+		desc.materialIndex = (materials > 0) ? (int)(NextRandom() % materials) : -1;
+		desc.color = glm::vec4(NextFloat(), NextFloat(), NextFloat(), 1.0f);
+
+		desc.bUseTexture = (textures > 0) && (NextFloat() < settings.texturedRatio);
+		desc.textureSlot = -1;
+		if (desc.bUseTexture == true)
+		{
+			desc.textureSlot = (int)(NextRandom() % textures);
+		}
+		else if (NextFloat() < settings.transparentRatio)
+		{
+			desc.color.a = g_TransparentAlpha;
+		}
+
+		pEntities->CreateEntity(desc);
+	}
+}
+
+/***********************************************************
+ *  GetDefaultSettings()
+ *
+ *  This method is used for getting the settings used when no
+ *  options are given: 10000 props spread evenly over the
+ *  table, half of them textured and a tenth of the rest
+ *  transparent.
+ ***********************************************************/
+void StressSceneGenerator::GetDefaultSettings(STRESS_SETTINGS& settings)
+{
+	settings.objectCount = 10000;
+	settings.seed = 1;
+	settings.layout = LAYOUT_UNIFORM;
+	settings.extent = 8.0f;
+	settings.materialVariety = 0;
+	settings.textureVariety = 0;
+	settings.texturedRatio = 0.5f;
+	settings.transparentRatio = 0.1f;
+}
+
+/***********************************************************
+ *  GetLayout()
+ *
+ *  This method is used for getting the layout named by a
+ *  command line option.
+ ***********************************************************/
+bool StressSceneGenerator::GetLayout(const char* name, STRESS_LAYOUT& layout)
+{
+	if (strcmp(name, "uniform") == 0)
+	{
+		layout = LAYOUT_UNIFORM;
+	}
+	else if (strcmp(name, "clustered") == 0)
+	{
+		layout = LAYOUT_CLUSTERED;
+	}
+	else if (strcmp(name, "grid") == 0)
+	{
+		layout = LAYOUT_GRID;
+	}
+	else
+	{
+		return(false);
+	}
+	return(true);
+}
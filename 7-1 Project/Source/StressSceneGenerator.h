@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+// stressscenegenerator.h
+// ============
+// generate large seeded scenes of props for scaling benchmarks
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+
+class SceneEntities;
+
+/***********************************************************
+ *  StressSceneGenerator
+ *
+ *  This class fills the scene entities with thousands to
+ *  millions of props made from the basic shape meshes and
+ *  the scene's own materials and textures, so the cost of
+ *  each part of a frame can be measured as the scene grows.
+ *  The same seed and settings always give the same scene on
+ *  every platform, because the random numbers come from the
+ *  generator's own sequence rather than the standard library
+ *  distributions.
+ ***********************************************************/
+class StressSceneGenerator
+{
+public:
+	// constructor
+	StressSceneGenerator();
+
+	// the ways the props can be spread through the scene
+	enum STRESS_LAYOUT
+	{
+		LAYOUT_UNIFORM,
+		LAYOUT_CLUSTERED,
+		LAYOUT_GRID
+	};
+
+	// properties for the generated scene
+	struct STRESS_SETTINGS
+	{
+		int objectCount;
+		uint32_t seed;
+		STRESS_LAYOUT layout;
+		// half the width of the square the props are spread over
+		float extent;
+		// number of different materials and textures used, where
+		// 0 uses all of those the scene defines
+		int materialVariety;
+		int textureVariety;
+		// share of the props that are textured and of the
+		// untextured props that are transparent
+		float texturedRatio;
+		float transparentRatio;
+	};
+
+private:
+	// state of the random number sequence
+	uint32_t m_randomState;
+
+	// get the next random number of the sequence
+	uint32_t NextRandom();
+	// get a random number from 0 up to 1
+	float NextFloat();
+
+public:
+	// fill the entities with a generated scene, using the
+	// passed in numbers of materials and texture slots
+	void Generate(
+		const STRESS_SETTINGS& settings,
+		int materialCount,
+		int textureCount,
+		SceneEntities* pEntities);
+
+	// get the settings used when no options are given
+	static void GetDefaultSettings(STRESS_SETTINGS& settings);
+	// get the layout named by an option, "uniform", "clustered"
+	// or "grid"
+	static bool GetLayout(const char* name, STRESS_LAYOUT& layout);
+};
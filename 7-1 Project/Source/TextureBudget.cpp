@@ -0,0 +1,468 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturebudget.cpp
+// ============
+// fit loaded texture images to the memory budget of the device
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureBudget.h"
+#include "SimdSupport.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables and defines
+namespace
+{
+	// resolution caps chosen from the amount of video memory
+	const int g_SmallDeviceMaxDimension = 1024;
+	const int g_MediumDeviceMaxDimension = 2048;
+	const int g_LargeDeviceMaxDimension = 4096;
+
+	// video memory sizes in KB that separate the device classes
+	const GLint g_SmallDeviceMemoryKB = 1024 * 1024;
+	const GLint g_MediumDeviceMemoryKB = 4 * 1024 * 1024;
+
+	// get the bytes used by a texture including its mipmaps,
+	// which add one third on top of the base level
+	size_t TextureBytes(int width, int height, int channels)
+	{
+		size_t baseBytes = (size_t)width * (size_t)height * (size_t)channels;
+		return(baseBytes + baseBytes / 3);
+	}
+
+	// get the name of an OpenGL internal format for the report
+	const char* FormatName(GLenum internalFormat)
+	{
+		switch (internalFormat)
+		{
+		case GL_R8: return("R8");
+		case GL_RG8: return("RG8");
+		case GL_RGB8: return("RGB8");
+		case GL_RGBA8: return("RGBA8");
+		case GL_SRGB8: return("SRGB8");
+		case GL_SRGB8_ALPHA8: return("SRGB8_ALPHA8");
+		}
+		return("unknown");
+	}
+}
+
+/***********************************************************
+ *  TextureBudget()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureBudget::TextureBudget()
+{
+	m_maxDimension = g_LargeDeviceMaxDimension;
+	m_deviceMaxDimension = g_LargeDeviceMaxDimension;
+	m_requestedMaxDimension = 0;
+	m_bUseSRGB = false;
+	m_bCompactFormats = true;
+	m_totalSourceBytes = 0;
+	m_totalFinalBytes = 0;
+}
+
+/***********************************************************
+ *  QueryDeviceLimits()
+ *
+ *  This method is used for choosing the texture resolution
+ *  cap from the video memory reported by the driver.  When
+ *  the driver does not report its memory, the largest cap is
+ *  used.  The cap never exceeds GL_MAX_TEXTURE_SIZE.  A cap
+ *  set with SetMaxDimension() lowers the device cap further.
+ ***********************************************************/
+void TextureBudget::QueryDeviceLimits()
+{
+	GLint memoryKB = 0;
+
+	// NVIDIA and AMD each report the video memory differently
+	if (GLEW_NVX_gpu_memory_info)
+	{
+		glGetIntegerv(GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX, &memoryKB);
+	}
+	else if (GLEW_ATI_meminfo)
+	{
+		GLint freeMemory[4] = { 0, 0, 0, 0 };
+		glGetIntegerv(GL_TEXTURE_FREE_MEMORY_ATI, freeMemory);
+		memoryKB = freeMemory[0];
+	}
+
+	if ((memoryKB > 0) && (memoryKB <= g_SmallDeviceMemoryKB))
+	{
+		m_maxDimension = g_SmallDeviceMaxDimension;
+	}
+	else if ((memoryKB > 0) && (memoryKB <= g_MediumDeviceMemoryKB))
+	{
+		m_maxDimension = g_MediumDeviceMaxDimension;
+	}
+	else
+	{
+		m_maxDimension = g_LargeDeviceMaxDimension;
+	}
+
+	GLint maxTextureSize = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+	if ((maxTextureSize > 0) && (maxTextureSize < m_maxDimension))
+	{
+		m_maxDimension = maxTextureSize;
+	}
+
+	m_deviceMaxDimension = m_maxDimension;
+	if ((m_requestedMaxDimension > 0) && (m_requestedMaxDimension < m_maxDimension))
+	{
+		m_maxDimension = m_requestedMaxDimension;
+	}
+
+	std::cout << "INFO: Texture resolution cap: " << m_maxDimension;
+	if (memoryKB > 0)
+	{
+		std::cout << " (" << (memoryKB / 1024) << " MB video memory)";
+	}
+	std::cout << std::endl;
+}
+
+/***********************************************************
+ *  DownsampleHalf()
+ *
+ *  This method is used for reducing an image to half of its
+ *  width and height, averaging each 2x2 block of pixels.  The
+ *  vertical average works on whole rows of bytes sixteen at
+ *  a time, and RGBA rows are also averaged horizontally four
+ *  pixels at a time.
+ ***********************************************************/
+void TextureBudget::DownsampleHalf(
+	const unsigned char* source,
+	int width,
+	int height,
+	int channels,
+	std::vector<unsigned char>& destination)
+{
+	int halfWidth = (width > 1) ? width / 2 : 1;
+	int halfHeight = (height > 1) ? height / 2 : 1;
+	int rowBytes = width * channels;
+
+	std::vector<unsigned char> rowAverage(rowBytes);
+	destination.resize((size_t)halfWidth * halfHeight * channels);
+
+	for (int y = 0; y < halfHeight; y++)
+	{
+		const unsigned char* row0 = source + (size_t)(2 * y) * rowBytes;
+		const unsigned char* row1 = row0;
+		if ((2 * y + 1) < height)
+		{
+			row1 = row0 + rowBytes;
+		}
+
+		// average the two source rows
+		int i = 0;
+#ifdef SCENE_SIMD_SSE2
+		for (; i + 16 <= rowBytes; i += 16)
+		{
+			__m128i top = _mm_loadu_si128((const __m128i*)(row0 + i));
+			__m128i bottom = _mm_loadu_si128((const __m128i*)(row1 + i));
+			_mm_storeu_si128((__m128i*)(&rowAverage[i]), _mm_avg_epu8(top, bottom));
+		}
+#endif
+		for (; i < rowBytes; i++)
+		{
+			rowAverage[i] = (unsigned char)((row0[i] + row1[i] + 1) >> 1);
+		}
+
+		// average the neighboring pixels of the averaged row
+		unsigned char* output = &destination[(size_t)y * halfWidth * channels];
+		int x = 0;
+#ifdef SCENE_SIMD_SSE2
+		if ((channels == 4) && (width > 1))
+		{
+			for (; (2 * x + 8) <= width && (x + 4) <= halfWidth; x += 4)
+			{
+				__m128 pixels0 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(&rowAverage[8 * x])));
+				__m128 pixels1 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(&rowAverage[8 * x + 16])));
+				__m128i even = _mm_castps_si128(_mm_shuffle_ps(pixels0, pixels1, _MM_SHUFFLE(2, 0, 2, 0)));
+				__m128i odd = _mm_castps_si128(_mm_shuffle_ps(pixels0, pixels1, _MM_SHUFFLE(3, 1, 3, 1)));
+				_mm_storeu_si128((__m128i*)(output + 4 * x), _mm_avg_epu8(even, odd));
+			}
+		}
+#endif
+		for (; x < halfWidth; x++)
+		{
+			int left = 2 * x;
+			int right = (left + 1 < width) ? left + 1 : left;
+			for (int c = 0; c < channels; c++)
+			{
+				output[x * channels + c] = (unsigned char)(
+					(rowAverage[left * channels + c] + rowAverage[right * channels + c] + 1) >> 1);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  IsGrayscale()
+ *
+ *  This method is used for checking whether the red, green
+ *  and blue values are equal in every pixel.
+ ***********************************************************/
+bool TextureBudget::IsGrayscale(const unsigned char* pixels, int pixelCount, int channels)
+{
+	if (channels < 3)
+	{
+		return(true);
+	}
+
+	for (int i = 0; i < pixelCount; i++)
+	{
+		const unsigned char* pixel = pixels + (size_t)i * channels;
+		if ((pixel[0] != pixel[1]) || (pixel[0] != pixel[2]))
+		{
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsOpaque()
+ *
+ *  This method is used for checking whether every pixel of
+ *  an RGBA image has a full alpha value.
+ ***********************************************************/
+bool TextureBudget::IsOpaque(const unsigned char* pixels, int pixelCount)
+{
+	for (int i = 0; i < pixelCount; i++)
+	{
+		if (pixels[(size_t)i * 4 + 3] != 255)
+		{
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  PrepareTexture()
+ *
+ *  This method is used for fitting the decoded image to the
+ *  resolution cap and choosing its upload format.  Grayscale
+ *  images are uploaded as R8 (RG8 with alpha) and swizzled
+ *  back to gray in the sampler, and RGBA images that are
+ *  fully opaque drop their alpha channel.  Top-down images
+ *  are turned bottom-up while the pixels are being copied.
+ ***********************************************************/
+bool TextureBudget::PrepareTexture(
+	const unsigned char* image,
+	int width,
+	int height,
+	int channels,
+	bool bFlipRows,
+	PREPARED_TEXTURE& prepared)
+{
+	if ((NULL == image) || (width <= 0) || (height <= 0) ||
+		(channels < 1) || (channels > 4))
+	{
+		return(false);
+	}
+
+	prepared.sourceBytes = TextureBytes(width, height, channels);
+
+	// reduce the image until it fits within the resolution cap
+	std::vector<unsigned char> reduced;
+	const unsigned char* pixels = image;
+	while ((width > m_maxDimension) || (height > m_maxDimension))
+	{
+		std::vector<unsigned char> halved;
+		DownsampleHalf(pixels, width, height, channels, halved);
+		reduced.swap(halved);
+		pixels = &reduced[0];
+		width = (width > 1) ? width / 2 : 1;
+		height = (height > 1) ? height / 2 : 1;
+	}
+
+	int pixelCount = width * height;
+	int finalChannels = channels;
+	bool bGrayscale = false;
+
+	if (m_bCompactFormats == true)
+	{
+		bGrayscale = IsGrayscale(pixels, pixelCount, channels);
+		if ((channels == 4) && IsOpaque(pixels, pixelCount))
+		{
+			finalChannels = 3;
+		}
+		if (bGrayscale && (channels >= 3))
+		{
+			finalChannels = (finalChannels == 4) ? 2 : 1;
+		}
+	}
+
+	// copy the pixels into their upload order, dropping channels
+	// and turning top-down images bottom-up in the same pass
+	prepared.pixels.resize((size_t)pixelCount * finalChannels);
+	size_t sourceRowBytes = (size_t)width * channels;
+	size_t targetRowBytes = (size_t)width * finalChannels;
+	for (int y = 0; y < height; y++)
+	{
+		int targetRow = (bFlipRows == true) ? (height - 1 - y) : y;
+		const unsigned char* sourceRow = pixels + (size_t)y * sourceRowBytes;
+		unsigned char* target = &prepared.pixels[(size_t)targetRow * targetRowBytes];
+
+		if (finalChannels == channels)
+		{
+			memcpy(target, sourceRow, sourceRowBytes);
+			continue;
+		}
+
+		for (int x = 0; x < width; x++)
+		{
+			const unsigned char* source = sourceRow + (size_t)x * channels;
+
+			if (finalChannels == 3)
+			{
+				target[0] = source[0];
+				target[1] = source[1];
+				target[2] = source[2];
+			}
+			else
+			{
+				target[0] = source[0];
+				if (finalChannels == 2)
+				{
+					target[1] = source[channels - 1];
+				}
+			}
+			target += finalChannels;
+		}
+	}
+
+	prepared.width = width;
+	prepared.height = height;
+	prepared.channels = finalChannels;
+	prepared.bSwizzle = false;
+
+	switch (finalChannels)
+	{
+	case 1:
+		// gray value fills red, green and blue with full alpha
+		prepared.internalFormat = GL_R8;
+		prepared.pixelFormat = GL_RED;
+		prepared.bSwizzle = true;
+		prepared.swizzle[0] = GL_RED;
+		prepared.swizzle[1] = GL_RED;
+		prepared.swizzle[2] = GL_RED;
+		prepared.swizzle[3] = GL_ONE;
+		break;
+	case 2:
+		// gray value fills red, green and blue with alpha in green
+		prepared.internalFormat = GL_RG8;
+		prepared.pixelFormat = GL_RG;
+		prepared.bSwizzle = true;
+		prepared.swizzle[0] = GL_RED;
+		prepared.swizzle[1] = GL_RED;
+		prepared.swizzle[2] = GL_RED;
+		prepared.swizzle[3] = GL_GREEN;
+		break;
+	case 3:
+		prepared.internalFormat = m_bUseSRGB ? GL_SRGB8 : GL_RGB8;
+		prepared.pixelFormat = GL_RGB;
+		break;
+	default:
+		prepared.internalFormat = m_bUseSRGB ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+		prepared.pixelFormat = GL_RGBA;
+		break;
+	}
+
+	prepared.finalBytes = TextureBytes(width, height, finalChannels);
+	m_totalSourceBytes += prepared.sourceBytes;
+	m_totalFinalBytes += prepared.finalBytes;
+
+	return(true);
+}
+
+/***********************************************************
+ *  ReportTexture()
+ *
+ *  This method is used for printing the upload size and the
+ *  memory that was saved for one texture.
+ ***********************************************************/
+void TextureBudget::ReportTexture(std::string tag, const PREPARED_TEXTURE& prepared)
+{
+	size_t savedBytes = 0;
+	if (prepared.sourceBytes > prepared.finalBytes)
+	{
+		savedBytes = prepared.sourceBytes - prepared.finalBytes;
+	}
+
+	std::cout << "Texture budget:" << tag
+		<< ", uploaded:" << prepared.width << "x" << prepared.height
+		<< " " << FormatName(prepared.internalFormat)
+		<< ", memory:" << (prepared.finalBytes / 1024) << " KB"
+		<< ", saved:" << (savedBytes / 1024) << " KB" << std::endl;
+}
+
+/***********************************************************
+ *  ReportTotals()
+ *
+ *  This method is used for printing the memory used by all
+ *  of the prepared textures against their source sizes.
+ ***********************************************************/
+void TextureBudget::ReportTotals()
+{
+	std::cout << "INFO: Texture memory: " << (m_totalFinalBytes / 1024) << " KB of "
+		<< (m_totalSourceBytes / 1024) << " KB at source resolution" << std::endl;
+}
+
+/***********************************************************
+ *  SetMaxDimension()
+ *
+ *  This method is used for lowering the resolution cap.  The
+ *  cap is kept when the device limits are queried later, but
+ *  never rises above the cap of the device.
+ ***********************************************************/
+void TextureBudget::SetMaxDimension(int maxDimension)
+{
+	if (maxDimension > 0)
+	{
+		m_requestedMaxDimension = maxDimension;
+		m_maxDimension = std::min(maxDimension, m_deviceMaxDimension);
+	}
+}
+
+/***********************************************************
+ *  SetUseSRGB()
+ *
+ *  This method is used for choosing the sRGB formats for
+ *  color textures.  The shaders must write to an sRGB frame
+ *  buffer for the colors to match the linear formats.
+ ***********************************************************/
+void TextureBudget::SetUseSRGB(bool bUseSRGB)
+{
+	m_bUseSRGB = bUseSRGB;
+}
+
+/***********************************************************
+ *  SetCompactFormats()
+ *
+ *  This method is used for turning the channel repacking of
+ *  grayscale and opaque images on or off.
+ ***********************************************************/
+void TextureBudget::SetCompactFormats(bool bCompactFormats)
+{
+	m_bCompactFormats = bCompactFormats;
+}
+
+/***********************************************************
+ *  GetUseSRGB()
+ *
+ *  This method is used for checking whether color textures
+ *  are uploaded with the sRGB formats.
+ ***********************************************************/
+bool TextureBudget::GetUseSRGB() const
+{
+	return(m_bUseSRGB);
+}
@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturebudget.h
+// ============
+// fit loaded texture images to the memory budget of the device
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  TextureBudget
+ *
+ *  This class decides the resolution and pixel format that
+ *  each texture is uploaded with.  Images larger than the
+ *  resolution cap for the device are reduced with a 2x2 box
+ *  filter, and the smallest OpenGL format that keeps the
+ *  image content is chosen before the upload.
+ ***********************************************************/
+class TextureBudget
+{
+public:
+	// constructor
+	TextureBudget();
+
+	// properties for a texture that is ready for upload
+	struct PREPARED_TEXTURE
+	{
+		std::vector<unsigned char> pixels;
+		int width;
+		int height;
+		int channels;
+		GLenum internalFormat;
+		GLenum pixelFormat;
+		bool bSwizzle;
+		GLint swizzle[4];
+		size_t sourceBytes;
+		size_t finalBytes;
+	};
+
+private:
+	// largest width or height a texture is uploaded with
+	int m_maxDimension;
+	// cap chosen for the device, which the cap never exceeds
+	int m_deviceMaxDimension;
+	// cap asked for on the command line, or 0 for the device cap
+	int m_requestedMaxDimension;
+	// upload color textures in the sRGB color space
+	bool m_bUseSRGB;
+	// repack grayscale and opaque images to fewer channels
+	bool m_bCompactFormats;
+	// running totals for the memory report
+	size_t m_totalSourceBytes;
+	size_t m_totalFinalBytes;
+
+	// halve the image in both directions with a box filter
+	static void DownsampleHalf(
+		const unsigned char* source,
+		int width,
+		int height,
+		int channels,
+		std::vector<unsigned char>& destination);
+	// check whether every pixel has equal color channels
+	static bool IsGrayscale(const unsigned char* pixels, int pixelCount, int channels);
+	// check whether every pixel is fully opaque
+	static bool IsOpaque(const unsigned char* pixels, int pixelCount);
+
+public:
+	// set the resolution cap from the limits of the device
+	void QueryDeviceLimits();
+	// prepare the decoded image data for uploading
+	bool PrepareTexture(
+		const unsigned char* image,
+		int width,
+		int height,
+		int channels,
+		bool bFlipRows,
+		PREPARED_TEXTURE& prepared);
+	// print the memory used and saved for one texture
+	void ReportTexture(std::string tag, const PREPARED_TEXTURE& prepared);
+	// print the memory totals for all of the textures
+	void ReportTotals();
+
+	// set the largest width or height for uploaded textures,
+	// kept within the cap of the device
+	void SetMaxDimension(int maxDimension);
+	// set whether color textures use the sRGB formats
+	void SetUseSRGB(bool bUseSRGB);
+	// set whether images are repacked to fewer channels
+	void SetCompactFormats(bool bCompactFormats);
+	// check whether color textures use the sRGB formats
+	bool GetUseSRGB() const;
+};
@@ -0,0 +1,171 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturesamplers.cpp
+// ============
+// manage the shared OpenGL sampler objects used by the scene textures
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureSamplers.h"
+
+#include <iostream>
+
+/***********************************************************
+ *  TextureSamplers()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureSamplers::TextureSamplers()
+{
+	for (int filter = 0; filter < FILTER_COUNT; filter++)
+	{
+		for (int wrap = 0; wrap < WRAP_COUNT; wrap++)
+		{
+			m_samplerIDs[filter][wrap] = 0;
+		}
+	}
+	m_maxAnisotropy = 1.0f;
+}
+
+/***********************************************************
+ *  ~TextureSamplers()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureSamplers::~TextureSamplers()
+{
+	DestroySamplers();
+}
+
+/***********************************************************
+ *  CreateSamplers()
+ *
+ *  This method is used for creating the sampler objects for
+ *  every filtering preset and wrapping mode.  All presets
+ *  except nearest sample between mipmap levels, and the
+ *  anisotropic presets are limited to what the driver allows.
+ ***********************************************************/
+void TextureSamplers::CreateSamplers()
+{
+	// anisotropic filtering is an extension before OpenGL 4.6
+	if (GLEW_EXT_texture_filter_anisotropic || GLEW_ARB_texture_filter_anisotropic)
+	{
+		glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &m_maxAnisotropy);
+	}
+
+	for (int filter = 0; filter < FILTER_COUNT; filter++)
+	{
+		for (int wrap = 0; wrap < WRAP_COUNT; wrap++)
+		{
+			GLuint samplerID = 0;
+			glGenSamplers(1, &samplerID);
+
+			// set the sampler wrapping parameters
+			GLint wrapMode = (wrap == WRAP_CLAMP) ? GL_CLAMP_TO_EDGE : GL_REPEAT;
+			glSamplerParameteri(samplerID, GL_TEXTURE_WRAP_S, wrapMode);
+			glSamplerParameteri(samplerID, GL_TEXTURE_WRAP_T, wrapMode);
+
+			// set the sampler filtering parameters
+			if (filter == FILTER_NEAREST)
+			{
+				glSamplerParameteri(samplerID, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+				glSamplerParameteri(samplerID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			}
+			else
+			{
+				glSamplerParameteri(samplerID, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+				glSamplerParameteri(samplerID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			}
+
+			float anisotropy = 1.0f;
+			if (filter == FILTER_ANISOTROPIC_4X)
+			{
+				anisotropy = 4.0f;
+			}
+			else if (filter == FILTER_ANISOTROPIC_16X)
+			{
+				anisotropy = 16.0f;
+			}
+			if (anisotropy > m_maxAnisotropy)
+			{
+				anisotropy = m_maxAnisotropy;
+			}
+			if (anisotropy > 1.0f)
+			{
+				glSamplerParameterf(samplerID, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropy);
+			}
+
+			m_samplerIDs[filter][wrap] = samplerID;
+		}
+	}
+
+	std::cout << "INFO: Texture samplers created, max anisotropy: " << m_maxAnisotropy << std::endl;
+}
+
+/***********************************************************
+ *  DestroySamplers()
+ *
+ *  This method is used for freeing the sampler objects.
+ ***********************************************************/
+void TextureSamplers::DestroySamplers()
+{
+	for (int filter = 0; filter < FILTER_COUNT; filter++)
+	{
+		for (int wrap = 0; wrap < WRAP_COUNT; wrap++)
+		{
+			if (m_samplerIDs[filter][wrap] != 0)
+			{
+				glDeleteSamplers(1, &m_samplerIDs[filter][wrap]);
+				m_samplerIDs[filter][wrap] = 0;
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  GetSampler()
+ *
+ *  This method is used for getting the shared sampler object
+ *  for the passed in filtering preset and wrapping mode.
+ ***********************************************************/
+GLuint TextureSamplers::GetSampler(SAMPLER_FILTER filter, SAMPLER_WRAP wrap) const
+{
+	if ((filter < 0) || (filter >= FILTER_COUNT) ||
+		(wrap < 0) || (wrap >= WRAP_COUNT))
+	{
+		return(0);
+	}
+
+	return(m_samplerIDs[filter][wrap]);
+}
+
+/***********************************************************
+ *  GetFilterName()
+ *
+ *  This method is used for getting the display name of a
+ *  filtering preset.
+ ***********************************************************/
+const char* TextureSamplers::GetFilterName(SAMPLER_FILTER filter)
+{
+	switch (filter)
+	{
+	case FILTER_NEAREST: return("nearest");
+	case FILTER_TRILINEAR: return("trilinear");
+	case FILTER_ANISOTROPIC_4X: return("anisotropic 4x");
+	case FILTER_ANISOTROPIC_16X: return("anisotropic 16x");
+	default: break;
+	}
+	return("unknown");
+}
+
+/***********************************************************
+ *  GetWrapName()
+ *
+ *  This method is used for getting the display name of a
+ *  wrapping mode.
+ ***********************************************************/
+const char* TextureSamplers::GetWrapName(SAMPLER_WRAP wrap)
+{
+	return((wrap == WRAP_CLAMP) ? "clamp" : "repeat");
+}
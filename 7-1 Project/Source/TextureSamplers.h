@@ -0,0 +1,66 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturesamplers.h
+// ============
+// manage the shared OpenGL sampler objects used by the scene textures
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+/***********************************************************
+ *  TextureSamplers
+ *
+ *  This class creates one OpenGL sampler object for every
+ *  combination of filtering preset and wrapping mode.  The
+ *  samplers are shared, so any number of textures can use
+ *  the same preset without repeating the texture parameters.
+ ***********************************************************/
+class TextureSamplers
+{
+public:
+	// the filtering presets for sampling textures
+	enum SAMPLER_FILTER
+	{
+		FILTER_NEAREST,
+		FILTER_TRILINEAR,
+		FILTER_ANISOTROPIC_4X,
+		FILTER_ANISOTROPIC_16X,
+		FILTER_COUNT
+	};
+
+	// the wrapping modes for texture coordinates outside 0 to 1
+	enum SAMPLER_WRAP
+	{
+		WRAP_REPEAT,
+		WRAP_CLAMP,
+		WRAP_COUNT
+	};
+
+	// constructor
+	TextureSamplers();
+	// destructor
+	~TextureSamplers();
+
+private:
+	// sampler objects for every filter and wrap combination
+	GLuint m_samplerIDs[FILTER_COUNT][WRAP_COUNT];
+	// largest anisotropy supported by the driver
+	float m_maxAnisotropy;
+
+public:
+	// create the shared sampler objects
+	void CreateSamplers();
+	// free the shared sampler objects
+	void DestroySamplers();
+	// get the sampler object for a filter and wrap combination
+	GLuint GetSampler(SAMPLER_FILTER filter, SAMPLER_WRAP wrap) const;
+
+	// get the display name of a filtering preset
+	static const char* GetFilterName(SAMPLER_FILTER filter);
+	// get the display name of a wrapping mode
+	static const char* GetWrapName(SAMPLER_WRAP wrap);
+};
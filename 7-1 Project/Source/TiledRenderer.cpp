@@ -0,0 +1,210 @@
+///////////////////////////////////////////////////////////////////////////////
+// tiledrenderer.cpp
+// ============
+// split very large still images into tiles streamed to disk
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TiledRenderer.h"
+
+#include <algorithm>
+#include <vector>
+
+// declaration of global variables and defines
+namespace
+{
+	// move to an offset in a file that may be larger than 2 GB
+	bool SeekFile(FILE* pFile, long long offset)
+	{
+#ifdef _WIN32
+		return(_fseeki64(pFile, offset, SEEK_SET) == 0);
+#else
+		return(fseeko(pFile, (off_t)offset, SEEK_SET) == 0);
+#endif
+	}
+}
+
+/***********************************************************
+ *  TiledRenderer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TiledRenderer::TiledRenderer()
+{
+	m_width = 0;
+	m_height = 0;
+	m_tileSize = 0;
+	m_tilesX = 0;
+	m_tilesY = 0;
+	m_pFile = NULL;
+	m_pixelOffset = 0;
+	m_bWriteFailed = false;
+}
+
+/***********************************************************
+ *  ~TiledRenderer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TiledRenderer::~TiledRenderer()
+{
+	if (NULL != m_pFile)
+	{
+		fclose(m_pFile);
+		m_pFile = NULL;
+	}
+}
+
+/***********************************************************
+ *  Begin()
+ *
+ *  This method is used for creating the image file and
+ *  splitting an image of the passed in size into square
+ *  tiles, where the last column and row may be smaller.
+ ***********************************************************/
+bool TiledRenderer::Begin(const char* filename, int width, int height, int tileSize)
+{
+	End();
+
+	if ((width <= 0) || (height <= 0) || (tileSize <= 0))
+	{
+		return(false);
+	}
+
+	m_pFile = fopen(filename, "wb");
+	if (NULL == m_pFile)
+	{
+		return(false);
+	}
+
+	m_width = width;
+	m_height = height;
+	m_tileSize = tileSize;
+	m_tilesX = (width + tileSize - 1) / tileSize;
+	m_tilesY = (height + tileSize - 1) / tileSize;
+	m_bWriteFailed = false;
+
+	fprintf(m_pFile, "P6\n%d %d\n255\n", m_width, m_height);
+	m_pixelOffset = (long long)ftell(m_pFile);
+
+	return(true);
+}
+
+/***********************************************************
+ *  End()
+ *
+ *  This method is used for closing the image file, and
+ *  returns false when any tile could not be written.
+ ***********************************************************/
+bool TiledRenderer::End()
+{
+	if (NULL == m_pFile)
+	{
+		return(false);
+	}
+
+	bool bReturn = (m_bWriteFailed == false);
+	if (fclose(m_pFile) != 0)
+	{
+		bReturn = false;
+	}
+	m_pFile = NULL;
+
+	return(bReturn);
+}
+
+/***********************************************************
+ *  GetTileCount()
+ *
+ *  This method is used for getting the number of tiles.
+ ***********************************************************/
+int TiledRenderer::GetTileCount() const
+{
+	return(m_tilesX * m_tilesY);
+}
+
+/***********************************************************
+ *  GetTile()
+ *
+ *  This method is used for getting where a tile lies in the
+ *  image.  Tiles are numbered across each row, top row first,
+ *  so the image file is mostly written from front to back.
+ ***********************************************************/
+TiledRenderer::IMAGE_TILE TiledRenderer::GetTile(int tileIndex) const
+{
+	IMAGE_TILE tile;
+	tile.x = (tileIndex % m_tilesX) * m_tileSize;
+	tile.y = (tileIndex / m_tilesX) * m_tileSize;
+	tile.width = std::min(m_tileSize, m_width - tile.x);
+	tile.height = std::min(m_tileSize, m_height - tile.y);
+	return(tile);
+}
+
+/***********************************************************
+ *  GetTileProjection()
+ *
+ *  This method is used for getting the off-center projection
+ *  of a tile.  The full image projection is followed by a
+ *  scale and offset in normalized device coordinates that
+ *  stretches the tile's part of the screen over the whole
+ *  -1 to 1 range, which narrows the frustum to the tile for
+ *  perspective and orthographic projections alike.  Depth is
+ *  left alone, so every tile is clipped by the same planes.
+ ***********************************************************/
+glm::mat4 TiledRenderer::GetTileProjection(const glm::mat4& projection, const IMAGE_TILE& tile) const
+{
+	// the edges of the tile in device coordinates, where the
+	// top row of the image is at +1
+	float left = 2.0f * (float)tile.x / (float)m_width - 1.0f;
+	float right = 2.0f * (float)(tile.x + tile.width) / (float)m_width - 1.0f;
+	float top = 1.0f - 2.0f * (float)tile.y / (float)m_height;
+	float bottom = 1.0f - 2.0f * (float)(tile.y + tile.height) / (float)m_height;
+
+	glm::mat4 tileMatrix(1.0f);
+	tileMatrix[0][0] = 2.0f / (right - left);
+	tileMatrix[1][1] = 2.0f / (top - bottom);
+	tileMatrix[3][0] = -(right + left) / (right - left);
+	tileMatrix[3][1] = -(top + bottom) / (top - bottom);
+
+	return(tileMatrix * projection);
+}
+
+/***********************************************************
+ *  WriteTile()
+ *
+ *  This method is used for writing the RGBA pixels of a
+ *  rendered tile into its rows of the image file.
+ ***********************************************************/
+bool TiledRenderer::WriteTile(const IMAGE_TILE& tile, const unsigned char* pixels, bool bBottomUp)
+{
+	if ((NULL == m_pFile) || (NULL == pixels))
+	{
+		return(false);
+	}
+
+	std::vector<unsigned char> row((size_t)tile.width * 3);
+	for (int y = 0; y < tile.height; y++)
+	{
+		int sourceRow = (bBottomUp == true) ? (tile.height - 1 - y) : y;
+		const unsigned char* source = pixels + (size_t)sourceRow * tile.width * 4;
+		for (int x = 0; x < tile.width; x++)
+		{
+			row[x * 3] = source[x * 4];
+			row[x * 3 + 1] = source[x * 4 + 1];
+			row[x * 3 + 2] = source[x * 4 + 2];
+		}
+
+		long long offset = m_pixelOffset +
+			((long long)(tile.y + y) * m_width + tile.x) * 3;
+		if ((SeekFile(m_pFile, offset) == false) ||
+			(fwrite(&row[0], 1, row.size(), m_pFile) != row.size()))
+		{
+			m_bWriteFailed = true;
+			return(false);
+		}
+	}
+
+	return(true);
+}
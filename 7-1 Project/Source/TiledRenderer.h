@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////
+// tiledrenderer.h
+// ============
+// split very large still images into tiles streamed to disk
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdio>
+
+/***********************************************************
+ *  TiledRenderer
+ *
+ *  This class lets a renderer produce a still image far
+ *  larger than its framebuffer.  The image is split into
+ *  tiles, each tile gets an off-center copy of the full
+ *  image projection that maps just its part of the view
+ *  onto the whole framebuffer, and the rendered tiles are
+ *  written straight into their place in a binary PPM file.
+ *  Only one tile is ever held in memory, so the memory used
+ *  does not grow with the size of the image.
+ ***********************************************************/
+class TiledRenderer
+{
+public:
+	// constructor
+	TiledRenderer();
+	// destructor
+	~TiledRenderer();
+
+	// properties for the placement of one tile in the image
+	struct IMAGE_TILE
+	{
+		int x;
+		int y;
+		int width;
+		int height;
+	};
+
+private:
+	// size of the whole image and of the largest tile
+	int m_width;
+	int m_height;
+	int m_tileSize;
+	// number of tiles across and down the image
+	int m_tilesX;
+	int m_tilesY;
+	// open image file and the offset of its first pixel
+	FILE* m_pFile;
+	long long m_pixelOffset;
+	// whether every tile so far was written
+	bool m_bWriteFailed;
+
+public:
+	// create the image file and split the image into tiles
+	bool Begin(const char* filename, int width, int height, int tileSize);
+	// close the image file, returning whether it is complete
+	bool End();
+
+	// get the number of tiles in the image
+	int GetTileCount() const;
+	// get the placement of a tile, in rows from the top left
+	IMAGE_TILE GetTile(int tileIndex) const;
+	// get the projection that renders just one tile of the image
+	glm::mat4 GetTileProjection(const glm::mat4& projection, const IMAGE_TILE& tile) const;
+
+	// write the RGBA pixels of a rendered tile into the image,
+	// with rows top first or bottom first as OpenGL reads them
+	bool WriteTile(const IMAGE_TILE& tile, const unsigned char* pixels, bool bBottomUp);
+};
@@ -0,0 +1,553 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformquantizer.cpp
+// ============
+// pack object transforms into 16 bytes of quantized values
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TransformQuantizer.h"
+#include "SimdSupport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// declaration of global variables and defines
+namespace
+{
+	// cells that can be stored on each axis
+	const float g_MinCell = -128.0f;
+	const float g_MaxCell = 127.0f;
+	// steps of the offset inside a cell
+	const float g_OffsetSteps = 65535.0f;
+	// steps of each stored quaternion part, and the factor that
+	// maps the range of the three smallest parts, which is
+	// plus or minus one over the square root of two, onto 0 to 1
+	const float g_RotationSteps = 1023.0f;
+	const float g_RotationRange = 0.70710678f;
+	// steps of the scale logarithm in each power of two, and
+	// the code of a scale of one
+	const float g_ScaleStepsPerOctave = 16.0f;
+	const int g_ScaleBias = 128;
+	const int g_MaxScaleCode = 254;
+	// first scale byte of a transform using a shared scale
+	const uint8_t g_SharedScale = 255;
+	const size_t g_MaxSharedScales = 65536;
+	// relative error of a logarithm step counted as exact
+	const float g_ScaleTolerance = 1.0e-5f;
+	const float g_RadiansToDegrees = 180.0f / 3.14159265358979f;
+
+	// get the bits of a scale, for finding it in the table
+	uint64_t GetScaleKey(const glm::vec3& scale)
+	{
+		uint32_t bits[3];
+		memcpy(bits, &scale[0], sizeof(bits));
+		return(((uint64_t)bits[0] * 0x9E3779B97F4A7C15ull) ^ ((uint64_t)bits[1] << 21) ^ (uint64_t)bits[2]);
+	}
+
+	// pack the offset inside its cell of one axis of a position,
+	// returning whether the cell had to be clamped
+	bool EncodeAxis(float position, float inverseCellSize, int8_t& cell, uint16_t& offset)
+	{
+		float scaled = position * inverseCellSize;
+		float cellIndex = std::floor(scaled);
+		float clampedCell = std::min(std::max(cellIndex, g_MinCell), g_MaxCell);
+		float fraction = std::min(std::max(scaled - clampedCell, 0.0f), 1.0f);
+
+		cell = (int8_t)(int)clampedCell;
+		offset = (uint16_t)(int)(fraction * g_OffsetSteps + 0.5f);
+		return(clampedCell != cellIndex);
+	}
+
+	// pack a quaternion as its largest part's index and the
+	// other three parts, with the sign chosen so the largest
+	// part is positive and can be rebuilt from the others
+	uint32_t EncodeRotation(const glm::quat& rotation)
+	{
+		float parts[4] = { rotation.x, rotation.y, rotation.z, rotation.w };
+		float length = std::sqrt(parts[0] * parts[0] + parts[1] * parts[1] + parts[2] * parts[2] + parts[3] * parts[3]);
+		if (length == 0.0f)
+		{
+			parts[3] = 1.0f;
+			length = 1.0f;
+		}
+
+		float largest = std::max(std::max(std::fabs(parts[0]), std::fabs(parts[1])),
+			std::max(std::fabs(parts[2]), std::fabs(parts[3])));
+		int index = 3;
+		for (int i = 2; i >= 0; i--)
+		{
+			if (std::fabs(parts[i]) == largest)
+			{
+				index = i;
+			}
+		}
+		float scale = 1.0f / length;
+		if (parts[index] < 0.0f)
+		{
+			scale = -scale;
+		}
+
+		uint32_t packed = (uint32_t)index << 30;
+		int shift = 20;
+		for (int i = 0; i < 4; i++)
+		{
+			if (i == index)
+			{
+				continue;
+			}
+			float range = std::min(std::max((parts[i] * scale) * g_RotationRange + 0.5f, 0.0f), 1.0f);
+			packed |= (uint32_t)(int)(range * g_RotationSteps + 0.5f) << shift;
+			shift -= 10;
+		}
+		return(packed);
+	}
+
+#ifdef SCENE_SIMD_SSE2
+	// pick the lanes of a where the mask is set and of b elsewhere
+	inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+	{
+		return(_mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)));
+	}
+
+	// round down, since truncation rounds negative values up
+	inline __m128 Floor(__m128 value)
+	{
+		__m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(value));
+		return(_mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, value), _mm_set1_ps(1.0f))));
+	}
+
+	// clamp to 0 to 1 and round to a number of steps
+	inline __m128i Quantize(__m128 value, float steps)
+	{
+		value = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+		return(_mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, _mm_set1_ps(steps)), _mm_set1_ps(0.5f))));
+	}
+#endif
+}
+
+/***********************************************************
+ *  TransformQuantizer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TransformQuantizer::TransformQuantizer()
+{
+	m_cellSize = 64.0f;
+	m_roundedScales = 0;
+	m_lastScale = glm::vec3(0.0f, 0.0f, 0.0f);
+	memset(m_lastPackedScale, 0, sizeof(m_lastPackedScale));
+	m_bLastScale = false;
+}
+
+/***********************************************************
+ *  SetCellSize()
+ *
+ *  This method is used for setting the size of the grid
+ *  cells positions are kept relative to.  The offsets step
+ *  by 1/65535 of a cell, and 256 cells fit on each axis, so a
+ *  larger cell covers a larger world less precisely.
+ ***********************************************************/
+void TransformQuantizer::SetCellSize(float cellSize)
+{
+	if (cellSize > 0.0f)
+	{
+		m_cellSize = cellSize;
+	}
+}
+
+/***********************************************************
+ *  GetCellSize()
+ *
+ *  This method is used for getting the size of the cells.
+ ***********************************************************/
+float TransformQuantizer::GetCellSize() const
+{
+	return(m_cellSize);
+}
+
+/***********************************************************
+ *  GetSharedScaleCount()
+ *
+ *  This method is used for getting the number of scales kept
+ *  in the shared table.
+ ***********************************************************/
+int TransformQuantizer::GetSharedScaleCount() const
+{
+	return((int)m_sharedScales.size());
+}
+
+/***********************************************************
+ *  GetRoundedScaleCount()
+ *
+ *  This method is used for getting the number of scales that
+ *  were rounded to logarithm steps because the shared table
+ *  was full.
+ ***********************************************************/
+int TransformQuantizer::GetRoundedScaleCount() const
+{
+	return(m_roundedScales);
+}
+
+/***********************************************************
+ *  EncodeScale()
+ *
+ *  This method is used for packing a scale.  Scales that are
+ *  powers of two or close to their logarithm steps, such as
+ *  the common scale of one, are kept as those steps.  Other
+ *  scales are kept exactly in the shared table, which the
+ *  many copies of the same object placed with the same scale
+ *  all use, until the table is full.
+ ***********************************************************/
+void TransformQuantizer::EncodeScale(const glm::vec3& scale, uint8_t* packed)
+{
+	if ((m_bLastScale == true) && (scale == m_lastScale))
+	{
+		memcpy(packed, m_lastPackedScale, sizeof(m_lastPackedScale));
+		return;
+	}
+
+	bool bExact = true;
+	int codes[3];
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float value = std::max(std::fabs(scale[axis]), 1.0e-20f);
+		int code = (int)std::floor(std::log2(value) * g_ScaleStepsPerOctave + 0.5f) + g_ScaleBias;
+		codes[axis] = std::min(std::max(code, 0), g_MaxScaleCode);
+
+		float decoded = std::exp2((codes[axis] - g_ScaleBias) / g_ScaleStepsPerOctave);
+		if ((scale[axis] <= 0.0f) || (std::fabs(decoded - scale[axis]) > g_ScaleTolerance * scale[axis]))
+		{
+			bExact = false;
+		}
+	}
+
+	if (bExact == false)
+	{
+		std::vector<int>& indexes = m_sharedScaleIndexes[GetScaleKey(scale)];
+		int sharedIndex = -1;
+		for (size_t i = 0; (i < indexes.size()) && (sharedIndex < 0); i++)
+		{
+			if (m_sharedScales[indexes[i]] == scale)
+			{
+				sharedIndex = indexes[i];
+			}
+		}
+		if ((sharedIndex < 0) && (m_sharedScales.size() < g_MaxSharedScales))
+		{
+			sharedIndex = (int)m_sharedScales.size();
+			m_sharedScales.push_back(scale);
+			indexes.push_back(sharedIndex);
+		}
+
+		if (sharedIndex >= 0)
+		{
+			codes[0] = g_SharedScale;
+			codes[1] = sharedIndex & 0xFF;
+			codes[2] = sharedIndex >> 8;
+		}
+		else
+		{
+			m_roundedScales++;
+		}
+	}
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		packed[axis] = (uint8_t)codes[axis];
+		m_lastPackedScale[axis] = packed[axis];
+	}
+	m_lastScale = scale;
+	m_bLastScale = true;
+}
+
+/***********************************************************
+ *  Encode()
+ *
+ *  This method is used for packing one transform.
+ ***********************************************************/
+TransformQuantizer::PACKED_TRANSFORM TransformQuantizer::Encode(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+{
+	PACKED_TRANSFORM packed;
+	float inverseCellSize = 1.0f / m_cellSize;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		EncodeAxis(position[axis], inverseCellSize, packed.cell[axis], packed.position[axis]);
+	}
+	packed.rotation = EncodeRotation(rotation);
+	EncodeScale(scale, packed.scale);
+	return(packed);
+}
+
+/***********************************************************
+ *  EncodeTransforms()
+ *
+ *  This method is used for packing an array of transforms.
+ *  With SSE2, the positions and rotations of four transforms
+ *  are packed together, picking the largest quaternion part
+ *  of each lane with compares and masks instead of branches.
+ *  The scales are packed one at a time in order, since the
+ *  shared table may grow between them.
+ ***********************************************************/
+void TransformQuantizer::EncodeTransforms(
+	int count,
+	const glm::vec3* positions,
+	const glm::quat* rotations,
+	const glm::vec3* scales,
+	PACKED_TRANSFORM* packed)
+{
+	int i = 0;
+#ifdef SCENE_SIMD_SSE2
+	const __m128 inverseCellSize = _mm_set1_ps(1.0f / m_cellSize);
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	const __m128 one = _mm_set1_ps(1.0f);
+	for (; i + 4 <= count; i += 4)
+	{
+		int32_t cells[3][4];
+		int32_t offsets[3][4];
+		for (int axis = 0; axis < 3; axis++)
+		{
+			__m128 scaled = _mm_mul_ps(_mm_setr_ps(
+				positions[i][axis], positions[i + 1][axis], positions[i + 2][axis], positions[i + 3][axis]),
+				inverseCellSize);
+			__m128 cellIndex = _mm_min_ps(_mm_max_ps(Floor(scaled), _mm_set1_ps(g_MinCell)), _mm_set1_ps(g_MaxCell));
+			_mm_storeu_si128((__m128i*)cells[axis], _mm_cvttps_epi32(cellIndex));
+			_mm_storeu_si128((__m128i*)offsets[axis], Quantize(_mm_sub_ps(scaled, cellIndex), g_OffsetSteps));
+		}
+
+		__m128 x = _mm_setr_ps(rotations[i].x, rotations[i + 1].x, rotations[i + 2].x, rotations[i + 3].x);
+		__m128 y = _mm_setr_ps(rotations[i].y, rotations[i + 1].y, rotations[i + 2].y, rotations[i + 3].y);
+		__m128 z = _mm_setr_ps(rotations[i].z, rotations[i + 1].z, rotations[i + 2].z, rotations[i + 3].z);
+		__m128 w = _mm_setr_ps(rotations[i].w, rotations[i + 1].w, rotations[i + 2].w, rotations[i + 3].w);
+
+		// zero quaternions are packed as no rotation
+		__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)), _mm_mul_ps(w, w)));
+		__m128 zero = _mm_cmpeq_ps(length, _mm_setzero_ps());
+		w = Select(zero, one, w);
+		length = Select(zero, one, length);
+
+		// the first of the largest parts, as in Encode()
+		__m128 absoluteX = _mm_andnot_ps(signMask, x);
+		__m128 absoluteY = _mm_andnot_ps(signMask, y);
+		__m128 absoluteZ = _mm_andnot_ps(signMask, z);
+		__m128 absoluteW = _mm_andnot_ps(signMask, w);
+		__m128 largest = _mm_max_ps(_mm_max_ps(absoluteX, absoluteY), _mm_max_ps(absoluteZ, absoluteW));
+		__m128i index = _mm_set1_epi32(3);
+		__m128 largestPart = w;
+		__m128 isLargest = _mm_cmpeq_ps(absoluteZ, largest);
+		index = _mm_castps_si128(Select(isLargest, _mm_castsi128_ps(_mm_set1_epi32(2)), _mm_castsi128_ps(index)));
+		largestPart = Select(isLargest, z, largestPart);
+		isLargest = _mm_cmpeq_ps(absoluteY, largest);
+		index = _mm_castps_si128(Select(isLargest, _mm_castsi128_ps(_mm_set1_epi32(1)), _mm_castsi128_ps(index)));
+		largestPart = Select(isLargest, y, largestPart);
+		isLargest = _mm_cmpeq_ps(absoluteX, largest);
+		index = _mm_castps_si128(Select(isLargest, _mm_setzero_ps(), _mm_castsi128_ps(index)));
+		largestPart = Select(isLargest, x, largestPart);
+
+		// the sign of the largest part flips the whole quaternion
+		__m128 scale = _mm_xor_ps(_mm_div_ps(one, length), _mm_and_ps(signMask, largestPart));
+
+		// the three parts left, in order, skipping the largest
+		__m128 first = Select(_mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_setzero_si128())), y, x);
+		__m128 second = Select(_mm_castsi128_ps(_mm_cmplt_epi32(index, _mm_set1_epi32(2))), z, y);
+		__m128 third = Select(_mm_castsi128_ps(_mm_cmplt_epi32(index, _mm_set1_epi32(3))), w, z);
+
+		const __m128 range = _mm_set1_ps(g_RotationRange);
+		const __m128 half = _mm_set1_ps(0.5f);
+		__m128i firstCode = Quantize(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(first, scale), range), half), g_RotationSteps);
+		__m128i secondCode = Quantize(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(second, scale), range), half), g_RotationSteps);
+		__m128i thirdCode = Quantize(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(third, scale), range), half), g_RotationSteps);
+		__m128i rotation = _mm_or_si128(
+			_mm_or_si128(_mm_slli_epi32(index, 30), _mm_slli_epi32(firstCode, 20)),
+			_mm_or_si128(_mm_slli_epi32(secondCode, 10), thirdCode));
+
+		uint32_t packedRotations[4];
+		_mm_storeu_si128((__m128i*)packedRotations, rotation);
+		for (int lane = 0; lane < 4; lane++)
+		{
+			PACKED_TRANSFORM& transform = packed[i + lane];
+			for (int axis = 0; axis < 3; axis++)
+			{
+				transform.cell[axis] = (int8_t)cells[axis][lane];
+				transform.position[axis] = (uint16_t)offsets[axis][lane];
+			}
+			transform.rotation = packedRotations[lane];
+			EncodeScale(scales[i + lane], transform.scale);
+		}
+	}
+#endif
+	for (; i < count; i++)
+	{
+		packed[i] = Encode(positions[i], rotations[i], scales[i]);
+	}
+}
+
+/***********************************************************
+ *  Decode()
+ *
+ *  This method is used for unpacking a transform into its
+ *  position, rotation and scale.
+ ***********************************************************/
+void TransformQuantizer::Decode(const PACKED_TRANSFORM& packed, glm::vec3& position, glm::quat& rotation, glm::vec3& scale) const
+{
+	for (int axis = 0; axis < 3; axis++)
+	{
+		position[axis] = ((float)packed.cell[axis] + packed.position[axis] * (1.0f / g_OffsetSteps)) * m_cellSize;
+	}
+
+	int index = (int)(packed.rotation >> 30);
+	float parts[4];
+	float sum = 0.0f;
+	int shift = 20;
+	for (int i = 0; i < 4; i++)
+	{
+		if (i == index)
+		{
+			continue;
+		}
+		float code = (float)((packed.rotation >> shift) & 0x3FF);
+		parts[i] = (code * (1.0f / g_RotationSteps) - 0.5f) * (1.0f / g_RotationRange);
+		sum += parts[i] * parts[i];
+		shift -= 10;
+	}
+	parts[index] = std::sqrt(std::max(1.0f - sum, 0.0f));
+	rotation = glm::quat(parts[3], parts[0], parts[1], parts[2]);
+
+	if (packed.scale[0] == g_SharedScale)
+	{
+		scale = m_sharedScales[packed.scale[1] | (packed.scale[2] << 8)];
+	}
+	else
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			scale[axis] = std::exp2((packed.scale[axis] - g_ScaleBias) / g_ScaleStepsPerOctave);
+		}
+	}
+}
+
+/***********************************************************
+ *  DecodeMatrix()
+ *
+ *  This method is used for unpacking a transform into the
+ *  same kind of matrix SetTransformations() builds, which
+ *  scales, then rotates and then translates.
+ ***********************************************************/
+glm::mat4 TransformQuantizer::DecodeMatrix(const PACKED_TRANSFORM& packed) const
+{
+	glm::vec3 position;
+	glm::quat rotation;
+	glm::vec3 scale;
+	Decode(packed, position, rotation, scale);
+
+	glm::mat3 axes = glm::mat3_cast(rotation);
+	glm::mat4 matrix;
+	matrix[0] = glm::vec4(axes[0] * scale.x, 0.0f);
+	matrix[1] = glm::vec4(axes[1] * scale.y, 0.0f);
+	matrix[2] = glm::vec4(axes[2] * scale.z, 0.0f);
+	matrix[3] = glm::vec4(position, 1.0f);
+	return(matrix);
+}
+
+/***********************************************************
+ *  MeasurePrecision()
+ *
+ *  This method is used for comparing packed transforms with
+ *  the values and matrices they were made from.  The
+ *  rotation error is the angle between the two rotations,
+ *  and the scale error is relative to the scale.
+ ***********************************************************/
+void TransformQuantizer::MeasurePrecision(
+	int count,
+	const glm::vec3* positions,
+	const glm::quat* rotations,
+	const glm::vec3* scales,
+	const glm::mat4* matrices,
+	const PACKED_TRANSFORM* packed,
+	PRECISION_REPORT& report) const
+{
+	memset(&report, 0, sizeof(report));
+	report.transforms = count;
+	report.roundedScales = m_roundedScales;
+
+	double totalPositionError = 0.0;
+	for (int i = 0; i < count; i++)
+	{
+		glm::vec3 position;
+		glm::quat rotation;
+		glm::vec3 scale;
+		Decode(packed[i], position, rotation, scale);
+
+		double positionError = glm::length(position - positions[i]);
+		totalPositionError += positionError;
+		report.maxPositionError = std::max(report.maxPositionError, positionError);
+
+		glm::quat original = glm::normalize(rotations[i]);
+		float alignment = std::min(std::fabs(glm::dot(original, rotation)), 1.0f);
+		report.maxRotationDegrees = std::max(report.maxRotationDegrees, (double)(2.0f * std::acos(alignment) * g_RadiansToDegrees));
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			double scaleError = std::fabs(scale[axis] - scales[i][axis]) / std::max(std::fabs(scales[i][axis]), 1.0e-6f);
+			report.maxScaleError = std::max(report.maxScaleError, scaleError);
+		}
+
+		glm::mat4 matrix = DecodeMatrix(packed[i]);
+		for (int column = 0; column < 4; column++)
+		{
+			for (int row = 0; row < 4; row++)
+			{
+				report.maxMatrixError = std::max(report.maxMatrixError, (double)std::fabs(matrix[column][row] - matrices[i][column][row]));
+			}
+		}
+
+		if (IsInRange(positions[i], m_cellSize) == false)
+		{
+			report.clampedPositions++;
+		}
+		if (packed[i].scale[0] == g_SharedScale)
+		{
+			report.sharedScales++;
+		}
+	}
+	report.meanPositionError = (count > 0) ? totalPositionError / count : 0.0;
+}
+
+/***********************************************************
+ *  GetEulerRotation()
+ *
+ *  This method is used for getting the rotation around the
+ *  X, Y and Z axes as a quaternion, applied the same way as
+ *  the rotation matrices of SetTransformations(), where the
+ *  rotation around Z is applied first.
+ ***********************************************************/
+glm::quat TransformQuantizer::GetEulerRotation(const glm::vec3& degrees)
+{
+	return(
+		glm::angleAxis(glm::radians(degrees.x), glm::vec3(1.0f, 0.0f, 0.0f)) *
+		glm::angleAxis(glm::radians(degrees.y), glm::vec3(0.0f, 1.0f, 0.0f)) *
+		glm::angleAxis(glm::radians(degrees.z), glm::vec3(0.0f, 0.0f, 1.0f)));
+}
+
+/***********************************************************
+ *  IsInRange()
+ *
+ *  This method is used for checking whether a position is in
+ *  the 256 cells that can be stored on each axis, which are
+ *  centered on the origin.
+ ***********************************************************/
+bool TransformQuantizer::IsInRange(const glm::vec3& position, float cellSize)
+{
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float cellIndex = std::floor(position[axis] / cellSize);
+		if ((cellIndex < g_MinCell) || (cellIndex > g_MaxCell))
+		{
+			return(false);
+		}
+	}
+	return(true);
+}
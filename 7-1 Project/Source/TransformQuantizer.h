@@ -0,0 +1,132 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformquantizer.h
+// ============
+// pack object transforms into 16 bytes of quantized values
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  TransformQuantizer
+ *
+ *  This class packs a translation, rotation and scale into
+ *  16 bytes instead of the 64 of a full matrix.  Positions
+ *  are kept as a cell of a grid and a 16 bit offset inside
+ *  it on each axis, rotations as the three smallest parts of
+ *  a unit quaternion in 10 bits each, and scales either as
+ *  8 bit steps of their base 2 logarithm or, when those are
+ *  not exact, as an index into a table of scales shared by
+ *  every transform that uses them.  Whole arrays of
+ *  transforms are packed four at a time with SSE2.
+ ***********************************************************/
+class TransformQuantizer
+{
+public:
+	// constructor
+	TransformQuantizer();
+
+	// properties for a transform packed into 16 bytes
+	struct PACKED_TRANSFORM
+	{
+		// offset inside the cell in steps of 1/65535 of the
+		// cell size
+		uint16_t position[3];
+		// cell holding the position on each axis
+		int8_t cell[3];
+		// base 2 logarithm of the scale in sixteenths, biased by
+		// 128, or 255 in the first byte followed by the index of
+		// a shared scale
+		uint8_t scale[3];
+		// index of the largest quaternion part in the top 2 bits,
+		// followed by the other three in 10 bits each
+		uint32_t rotation;
+	};
+
+	// properties for the error of packed transforms against
+	// the matrices they were made from
+	struct PRECISION_REPORT
+	{
+		int transforms;
+		double maxPositionError;
+		double meanPositionError;
+		double maxRotationDegrees;
+		double maxScaleError;
+		double maxMatrixError;
+		// transforms outside the cells that can be stored
+		int clampedPositions;
+		// scales kept in the shared table, and scales that did
+		// not fit in it and were rounded to a logarithm step
+		int sharedScales;
+		int roundedScales;
+	};
+
+private:
+	// size of the grid cells positions are kept relative to
+	float m_cellSize;
+	// scales that are not exact as logarithm steps
+	std::vector<glm::vec3> m_sharedScales;
+	std::unordered_map<uint64_t, std::vector<int> > m_sharedScaleIndexes;
+	// scales rounded because the shared table was full
+	int m_roundedScales;
+	// last scale packed, which the next transform often shares
+	glm::vec3 m_lastScale;
+	uint8_t m_lastPackedScale[3];
+	bool m_bLastScale;
+
+	// pack a scale, using the shared table when needed
+	void EncodeScale(const glm::vec3& scale, uint8_t* packed);
+
+public:
+	// set the size of the grid cells, before any transforms
+	// are packed
+	void SetCellSize(float cellSize);
+	// get the size of the grid cells
+	float GetCellSize() const;
+	// get the number of shared scales and of rounded scales
+	int GetSharedScaleCount() const;
+	int GetRoundedScaleCount() const;
+
+	// pack one transform
+	PACKED_TRANSFORM Encode(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+	// pack an array of transforms, four at a time when SSE2 is
+	// available, the same way as Encode()
+	void EncodeTransforms(
+		int count,
+		const glm::vec3* positions,
+		const glm::quat* rotations,
+		const glm::vec3* scales,
+		PACKED_TRANSFORM* packed);
+	// unpack a transform into its parts
+	void Decode(const PACKED_TRANSFORM& packed, glm::vec3& position, glm::quat& rotation, glm::vec3& scale) const;
+	// unpack a transform into the matrix that translates,
+	// rotates and then scales
+	glm::mat4 DecodeMatrix(const PACKED_TRANSFORM& packed) const;
+
+	// compare packed transforms with the matrices they were
+	// made from
+	void MeasurePrecision(
+		int count,
+		const glm::vec3* positions,
+		const glm::quat* rotations,
+		const glm::vec3* scales,
+		const glm::mat4* matrices,
+		const PACKED_TRANSFORM* packed,
+		PRECISION_REPORT& report) const;
+
+	// get the rotation around the X, Y and Z axes in degrees,
+	// in the order the scene manager applies them
+	static glm::quat GetEulerRotation(const glm::vec3& degrees);
+	// check whether a position is inside the cells that can be
+	// stored for a cell size
+	static bool IsInRange(const glm::vec3& position, float cellSize);
+};
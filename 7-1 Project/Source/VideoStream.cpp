@@ -0,0 +1,372 @@
+///////////////////////////////////////////////////////////////////////////////
+// videostream.cpp
+// ============
+// write rendered frames as a raw video stream to a file or pipe
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "VideoStream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <signal.h>
+#include <unistd.h>
+#else
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+// declaration of global variables and defines
+namespace
+{
+	// get the limited range BT.601 luma of a pixel
+	inline unsigned char GetLuma(int r, int g, int b)
+	{
+		return((unsigned char)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16));
+	}
+
+	// get the limited range BT.601 chroma of a pixel
+	inline unsigned char GetChromaU(int r, int g, int b)
+	{
+		return((unsigned char)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128));
+	}
+	inline unsigned char GetChromaV(int r, int g, int b)
+	{
+		return((unsigned char)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128));
+	}
+}
+
+/***********************************************************
+ *  VideoStream()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+VideoStream::VideoStream()
+{
+	m_pFile = NULL;
+	m_format = FORMAT_Y4M;
+	m_framesPerSecond = 30;
+	m_width = 0;
+	m_height = 0;
+	m_frames = 0;
+}
+
+/***********************************************************
+ *  ~VideoStream()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+VideoStream::~VideoStream()
+{
+	Close();
+}
+
+/***********************************************************
+ *  Open()
+ *
+ *  This method is used for opening the stream.  Writing to
+ *  standard output keeps a private copy of it for the video
+ *  and points the original at standard error, and a reader
+ *  that goes away makes writes fail instead of ending the
+ *  program.
+ ***********************************************************/
+bool VideoStream::Open(const char* target, STREAM_FORMAT format, int framesPerSecond)
+{
+	Close();
+
+	if (NULL == target)
+	{
+		return(false);
+	}
+
+	if (strcmp(target, "-") == 0)
+	{
+		std::cout.flush();
+		fflush(stdout);
+#ifndef _WIN32
+		int videoHandle = dup(STDOUT_FILENO);
+		if ((videoHandle < 0) || (dup2(STDERR_FILENO, STDOUT_FILENO) < 0))
+		{
+			return(false);
+		}
+		m_pFile = fdopen(videoHandle, "wb");
+#else
+		int videoHandle = _dup(_fileno(stdout));
+		if ((videoHandle < 0) || (_dup2(_fileno(stderr), _fileno(stdout)) < 0))
+		{
+			return(false);
+		}
+		_setmode(videoHandle, _O_BINARY);
+		m_pFile = _fdopen(videoHandle, "wb");
+#endif
+	}
+	else
+	{
+		m_pFile = fopen(target, "wb");
+	}
+
+	if (NULL == m_pFile)
+	{
+		return(false);
+	}
+
+#ifndef _WIN32
+	signal(SIGPIPE, SIG_IGN);
+#endif
+
+	m_format = format;
+	m_framesPerSecond = (framesPerSecond > 0) ? framesPerSecond : 30;
+	m_width = 0;
+	m_height = 0;
+	m_frames = 0;
+
+	return(true);
+}
+
+/***********************************************************
+ *  Close()
+ *
+ *  This method is used for flushing and closing the stream.
+ ***********************************************************/
+void VideoStream::Close()
+{
+	if (NULL != m_pFile)
+	{
+		fclose(m_pFile);
+		m_pFile = NULL;
+	}
+}
+
+/***********************************************************
+ *  IsOpen()
+ *
+ *  This method is used for checking whether the stream can
+ *  be written to.
+ ***********************************************************/
+bool VideoStream::IsOpen() const
+{
+	return(NULL != m_pFile);
+}
+
+/***********************************************************
+ *  GetFormat()
+ *
+ *  This method is used for getting the layout the frames
+ *  are written in.
+ ***********************************************************/
+VideoStream::STREAM_FORMAT VideoStream::GetFormat() const
+{
+	return(m_format);
+}
+
+/***********************************************************
+ *  GetFrameCount()
+ *
+ *  This method is used for getting the number of frames
+ *  written to the stream.
+ ***********************************************************/
+int VideoStream::GetFrameCount() const
+{
+	return(m_frames);
+}
+
+/***********************************************************
+ *  GetFramesPerSecond()
+ *
+ *  This method is used for getting the frame rate the stream
+ *  was opened with.
+ ***********************************************************/
+int VideoStream::GetFramesPerSecond() const
+{
+	return(m_framesPerSecond);
+}
+
+/***********************************************************
+ *  BeginFrames()
+ *
+ *  This method is used for writing the Y4M header with the
+ *  size of the first frame, and for checking that every
+ *  later frame has the same size.
+ ***********************************************************/
+bool VideoStream::BeginFrames(int width, int height)
+{
+	if (NULL == m_pFile)
+	{
+		return(false);
+	}
+
+	if (m_width > 0)
+	{
+		return((width == m_width) && (height == m_height));
+	}
+
+	m_width = width;
+	m_height = height;
+	if (m_format == FORMAT_Y4M)
+	{
+		fprintf(m_pFile, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg XCOLORRANGE=LIMITED\n",
+			m_width, m_height, m_framesPerSecond);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  WriteFrame()
+ *
+ *  This method is used for writing the RGBA pixels of a
+ *  frame, as they are for a raw stream or converted to Y, U
+ *  and V planes for a Y4M stream.
+ ***********************************************************/
+bool VideoStream::WriteFrame(const unsigned char* pixels, int width, int height, bool bBottomUp)
+{
+	if ((NULL == pixels) || (BeginFrames(width, height) == false))
+	{
+		return(false);
+	}
+
+	if (m_format == FORMAT_Y4M)
+	{
+		m_planes.resize(GetPlanesSize(width, height));
+		ConvertToYUV420(pixels, width, height, bBottomUp, &m_planes[0]);
+		return(WritePlanes(&m_planes[0], width, height));
+	}
+
+	size_t rowSize = (size_t)width * 4;
+	for (int y = 0; y < height; y++)
+	{
+		int sourceRow = (bBottomUp == true) ? (height - 1 - y) : y;
+		if (fwrite(pixels + rowSize * sourceRow, 1, rowSize, m_pFile) != rowSize)
+		{
+			return(false);
+		}
+	}
+
+	m_frames++;
+	return(true);
+}
+
+/***********************************************************
+ *  WritePlanes()
+ *
+ *  This method is used for writing a Y4M frame whose Y, U
+ *  and V planes are already packed one after another, such
+ *  as when they were converted on the GPU.
+ ***********************************************************/
+bool VideoStream::WritePlanes(const unsigned char* planes, int width, int height)
+{
+	if ((NULL == planes) || (m_format != FORMAT_Y4M) || (BeginFrames(width, height) == false))
+	{
+		return(false);
+	}
+
+	size_t size = GetPlanesSize(width, height);
+	if ((fputs("FRAME\n", m_pFile) < 0) ||
+		(fwrite(planes, 1, size, m_pFile) != size))
+	{
+		return(false);
+	}
+
+	m_frames++;
+	return(true);
+}
+
+/***********************************************************
+ *  GetFormat()
+ *
+ *  This method is used for getting the stream format named
+ *  by a command line option.
+ ***********************************************************/
+bool VideoStream::GetFormat(const char* name, STREAM_FORMAT& format)
+{
+	if (strcmp(name, "y4m") == 0)
+	{
+		format = FORMAT_Y4M;
+		return(true);
+	}
+	if (strcmp(name, "rgba") == 0)
+	{
+		format = FORMAT_RGBA;
+		return(true);
+	}
+	return(false);
+}
+
+/***********************************************************
+ *  GetPlanesSize()
+ *
+ *  This method is used for getting the size of a 4:2:0
+ *  frame, a full size Y plane and two half size chroma ones.
+ ***********************************************************/
+size_t VideoStream::GetPlanesSize(int width, int height)
+{
+	size_t chromaSize = (size_t)((width + 1) / 2) * ((height + 1) / 2);
+	return((size_t)width * height + chromaSize * 2);
+}
+
+/***********************************************************
+ *  ConvertToYUV420()
+ *
+ *  This method is used for converting RGBA pixels to Y, U
+ *  and V planes on the CPU.  The GPU conversion uses the same
+ *  integer math, so both give the same bytes.
+ ***********************************************************/
+void VideoStream::ConvertToYUV420(const unsigned char* pixels, int width, int height, bool bBottomUp, unsigned char* planes)
+{
+	int chromaWidth = (width + 1) / 2;
+	int chromaHeight = (height + 1) / 2;
+	unsigned char* lumaPlane = planes;
+	unsigned char* uPlane = planes + (size_t)width * height;
+	unsigned char* vPlane = uPlane + (size_t)chromaWidth * chromaHeight;
+
+	for (int y = 0; y < height; y++)
+	{
+		int sourceRow = (bBottomUp == true) ? (height - 1 - y) : y;
+		const unsigned char* source = pixels + (size_t)sourceRow * width * 4;
+		unsigned char* luma = lumaPlane + (size_t)y * width;
+		for (int x = 0; x < width; x++)
+		{
+			luma[x] = GetLuma(source[x * 4], source[x * 4 + 1], source[x * 4 + 2]);
+		}
+	}
+
+	// the last column and row repeat at odd sizes
+	for (int cy = 0; cy < chromaHeight; cy++)
+	{
+		int rows[2] = { cy * 2, std::min(cy * 2 + 1, height - 1) };
+		const unsigned char* sources[2];
+		for (int r = 0; r < 2; r++)
+		{
+			int sourceRow = (bBottomUp == true) ? (height - 1 - rows[r]) : rows[r];
+			sources[r] = pixels + (size_t)sourceRow * width * 4;
+		}
+
+		for (int cx = 0; cx < chromaWidth; cx++)
+		{
+			int columns[2] = { cx * 2, std::min(cx * 2 + 1, width - 1) };
+			int sum[3] = { 0, 0, 0 };
+			for (int r = 0; r < 2; r++)
+			{
+				for (int c = 0; c < 2; c++)
+				{
+					const unsigned char* pixel = sources[r] + columns[c] * 4;
+					sum[0] += pixel[0];
+					sum[1] += pixel[1];
+					sum[2] += pixel[2];
+				}
+			}
+
+			int red = (sum[0] + 2) >> 2;
+			int green = (sum[1] + 2) >> 2;
+			int blue = (sum[2] + 2) >> 2;
+			size_t index = (size_t)cy * chromaWidth + cx;
+			uPlane[index] = GetChromaU(red, green, blue);
+			vPlane[index] = GetChromaV(red, green, blue);
+		}
+	}
+}
@@ -0,0 +1,84 @@
+///////////////////////////////////////////////////////////////////////////////
+// videostream.h
+// ============
+// write rendered frames as a raw video stream to a file or pipe
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+/***********************************************************
+ *  VideoStream
+ *
+ *  This class writes frames one after another in the Y4M
+ *  format with 4:2:0 chroma, or as headerless RGBA, so they
+ *  can be piped straight into an external video encoder.
+ *  The stream goes to a file, a named pipe or, for "-", to
+ *  standard output, in which case the program's own messages
+ *  are moved to standard error so they do not end up in the
+ *  video.  The header is written with the first frame, once
+ *  the frame size is known.
+ ***********************************************************/
+class VideoStream
+{
+public:
+	// constructor
+	VideoStream();
+	// destructor
+	~VideoStream();
+
+	// the layouts the frames can be written in
+	enum STREAM_FORMAT
+	{
+		FORMAT_Y4M,
+		FORMAT_RGBA
+	};
+
+private:
+	// open file, pipe or standard output
+	FILE* m_pFile;
+	STREAM_FORMAT m_format;
+	int m_framesPerSecond;
+	// size of the frames, set by the first one written
+	int m_width;
+	int m_height;
+	int m_frames;
+	// buffer for frames converted on the CPU
+	std::vector<unsigned char> m_planes;
+
+	// write the stream header for the first frame's size
+	bool BeginFrames(int width, int height);
+
+public:
+	// open the stream, where "-" is standard output
+	bool Open(const char* target, STREAM_FORMAT format, int framesPerSecond);
+	// flush and close the stream
+	void Close();
+	// check whether the stream is open
+	bool IsOpen() const;
+	// get the layout the frames are written in
+	STREAM_FORMAT GetFormat() const;
+	// get the number of frames written
+	int GetFrameCount() const;
+	// get the frame rate the stream was opened with
+	int GetFramesPerSecond() const;
+
+	// write RGBA pixels, converting them for a Y4M stream
+	bool WriteFrame(const unsigned char* pixels, int width, int height, bool bBottomUp);
+	// write the Y, U and V planes of a frame already converted
+	bool WritePlanes(const unsigned char* planes, int width, int height);
+
+	// get the format named by an option, "y4m" or "rgba"
+	static bool GetFormat(const char* name, STREAM_FORMAT& format);
+	// get the size of the Y, U and V planes of a frame
+	static size_t GetPlanesSize(int width, int height);
+	// convert RGBA pixels to limited range BT.601 Y, U and V
+	// planes, averaging each 2x2 block of pixels for chroma
+	static void ConvertToYUV420(const unsigned char* pixels, int width, int height, bool bBottomUp, unsigned char* planes);
+};
@@ -8,12 +8,18 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "ViewManager.h"
+#include "SceneManager.h"
+#include "SceneEntities.h"
+#include "TiledRenderer.h"
+#include "CameraPath.h"
 
 // GLM Math Header inclusions
 #include <glm/glm.hpp>
 #include <glm/gtx/transform.hpp>
 #include <glm/gtc/type_ptr.hpp>    
 
+#include <vector>
+
 // declarations for the global variables and defines
 namespace
 {
@@ -39,6 +45,53 @@ namespace
 	// the following variable is false when orthographic projection
 	// is off and true when it is on
 	bool bOrthographicProjection = false;
+
+	// entity of the scene the cursor was last over
+	uint32_t gPickedEntity = SceneEntities::INVALID_ENTITY;
+
+	// properties for the preset cameras of keys 1 to 4
+	struct PRESET_VIEW
+	{
+		glm::vec3 position;
+		glm::vec3 front;
+		glm::vec3 up;
+		bool bOrthographic;
+	};
+
+	// front, side and top orthographic views and the default
+	// perspective view
+	const PRESET_VIEW g_PresetViews[4] =
+	{
+		{ glm::vec3(0.0f, 4.0f, 10.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f), true },
+		{ glm::vec3(10.0f, 4.0f, 0.0f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), true },
+		{ glm::vec3(0.0f, 7.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(-1.0f, 0.0f, 0.0f), true },
+		{ glm::vec3(0.0f, 5.5f, 8.0f), glm::vec3(0.0f, -0.5f, -2.0f), glm::vec3(0.0f, 1.0f, 0.0f), false }
+	};
+
+	// get the perspective or the orthographic projection for
+	// an image size
+	glm::mat4 GetProjection(bool bOrthographic, float zoom, int width, int height)
+	{
+		if (bOrthographic == false)
+		{
+			// perspective projection
+			return(glm::perspective(glm::radians(zoom), (GLfloat)width / (GLfloat)height, 0.1f, 100.0f));
+		}
+
+		// front-view orthographic projection with correct aspect ratio
+		double scale = 0.0;
+		if (width > height)
+		{
+			scale = (double)height / (double)width;
+			return(glm::ortho(-5.0f, 5.0f, -5.0f*(float)scale, 5.0f*(float)scale, 0.1f, 100.0f));
+		}
+		else if (width < height)
+		{
+			scale = (double)width / (double)height;
+			return(glm::ortho(-5.0f * (float)scale, 5.0f * (float)scale, -5.0f, 5.0f, 0.1f, 100.0f));
+		}
+		return(glm::ortho(-5.0f, 5.0f, -5.0f, 5.0f, 0.1f, 100.0f));
+	}
 }
 
 /***********************************************************
@@ -51,12 +104,17 @@ ViewManager::ViewManager(
 {
 	// initialize the member variables
 	m_pShaderManager = pShaderManager;
+	m_pRenderDevice = NULL;
+	m_pSceneManager = NULL;
 	m_pWindow = NULL;
+	m_pCameraPath = NULL;
+	m_pathFrame = 0;
+	m_bQuadView = false;
 	g_pCamera = new Camera();
 	// default camera view parameters
-	g_pCamera->Position = glm::vec3(0.0f, 5.5f, 8.0f);
-	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
-	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+	g_pCamera->Position = g_PresetViews[3].position;
+	g_pCamera->Front = g_PresetViews[3].front;
+	g_pCamera->Up = g_PresetViews[3].up;
 	g_pCamera->Zoom = 80;
 }
 
@@ -165,6 +223,9 @@ void ViewManager::ProcessKeyboardEvents()
 		return;
 	}
 
+	// where the camera was before it moved this frame
+	glm::vec3 previousPosition = g_pCamera->Position;
+
 	// process camera zooming in and out
 	if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
 	{
@@ -195,47 +256,75 @@ void ViewManager::ProcessKeyboardEvents()
 		g_pCamera->ProcessKeyboard(DOWN, gDeltaTime);
 	}
 
-	// change between different projection views
-	if (glfwGetKey(m_pWindow, GLFW_KEY_1) == GLFW_PRESS)
+	// stop the camera at the scene it runs into, sliding along
+	// it instead of flying through
+	if (NULL != m_pSceneManager)
 	{
-		// change to a multi-view orthographic projection
-		bOrthographicProjection = true;
-
-		// change the camera settings to show a front orthographic view
-		g_pCamera->Position = glm::vec3(0.0f, 4.0f, 10.0f);
-		g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-		g_pCamera->Front = glm::vec3(0.0f, 0.0f, -1.0f);
+		g_pCamera->Position = m_pSceneManager->MoveCamera(previousPosition, g_pCamera->Position);
 	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_2) == GLFW_PRESS)
-	{
-		// change to a multi-view orthographic projection
-		bOrthographicProjection = true;
 
-		// change the camera settings to show a side orthographic view
-		g_pCamera->Position = glm::vec3(10.0f, 4.0f, 0.0f);
-		g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-		g_pCamera->Front = glm::vec3(-1.0f, 0.0f, 0.0f);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_3) == GLFW_PRESS)
+	// change between the front, side and top orthographic views
+	// and the perspective view, leaving the quad view
+	for (int i = 0; i < 4; i++)
 	{
-		// change to a multi-view orthographic projection
-		bOrthographicProjection = true;
+		if (glfwGetKey(m_pWindow, GLFW_KEY_1 + i) == GLFW_PRESS)
+		{
+			m_bQuadView = false;
+			bOrthographicProjection = g_PresetViews[i].bOrthographic;
+
+			// change the camera settings to show the preset view
+			g_pCamera->Position = g_PresetViews[i].position;
+			g_pCamera->Front = g_PresetViews[i].front;
+			g_pCamera->Up = g_PresetViews[i].up;
+			if (g_PresetViews[i].bOrthographic == false)
+			{
+				g_pCamera->Zoom = 80;
+			}
+		}
+	}
 
-		// change the camera settings to show a top orthographic view
-		g_pCamera->Position = glm::vec3(0.0f, 7.0f, 0.0f);
-		g_pCamera->Up = glm::vec3(-1.0f, 0.0f, 0.0f);
-		g_pCamera->Front = glm::vec3(0.0f, -1.0f, 0.0f);
+	// show all of the views at once
+	if (glfwGetKey(m_pWindow, GLFW_KEY_5) == GLFW_PRESS)
+	{
+		m_bQuadView = true;
 	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_4) == GLFW_PRESS)
+}
+
+/***********************************************************
+ *  SetRenderDevice()
+ *
+ *  This method is used for passing the camera of each frame
+ *  to a render device instead of straight into the shader.
+ ***********************************************************/
+void ViewManager::SetRenderDevice(RenderDevice* pRenderDevice)
+{
+	m_pRenderDevice = pRenderDevice;
+}
+
+/***********************************************************
+ *  SetSceneManager()
+ *
+ *  This method is used for registering the front, side and
+ *  top views with the scene, which keeps a draw list for each
+ *  of them, and for telling it the camera of every frame.
+ ***********************************************************/
+void ViewManager::SetSceneManager(SceneManager* pSceneManager)
+{
+	m_pSceneManager = pSceneManager;
+	if (NULL == pSceneManager)
 	{
-		// change to perspective projection
-		bOrthographicProjection = false;
+		return;
+	}
 
-		// change the camera settings to show a perspective view
-		g_pCamera->Position = glm::vec3(0.0f, 5.5f, 8.0f);
-		g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
-		g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-		g_pCamera->Zoom = 80;
+	for (int i = 0; i < 4; i++)
+	{
+		const PRESET_VIEW& preset = g_PresetViews[i];
+		if (preset.bOrthographic == true)
+		{
+			pSceneManager->RegisterPresetView(
+				glm::lookAt(preset.position, preset.position + preset.front, preset.up),
+				GetProjection(true, 0.0f, WINDOW_WIDTH, WINDOW_HEIGHT));
+		}
 	}
 }
 
@@ -260,43 +349,319 @@ void ViewManager::PrepareSceneView()
 	// event queue
 	ProcessKeyboardEvents();
 
-	// get the current view matrix from the camera
-	view = g_pCamera->GetViewMatrix();
-
-	// define the current projection matrix
-	if (bOrthographicProjection == false)
+	glm::vec3 viewPosition;
+	if (m_bQuadView == true)
 	{
-		// perspective projection
-		projection = glm::perspective(glm::radians(g_pCamera->Zoom), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
+		std::vector<RenderDevice::VIEWPORT_VIEW> views;
+		GetQuadViews(WINDOW_WIDTH, WINDOW_HEIGHT, views);
+		ApplySceneViews(views);
+		viewPosition = views.back().viewPosition;
 	}
 	else
 	{
-		// front-view orthographic projection with correct aspect ratio
-		double scale = 0.0;
-		if (WINDOW_WIDTH > WINDOW_HEIGHT)
-		{
-			scale = (double)WINDOW_HEIGHT / (double)WINDOW_WIDTH;
-			projection = glm::ortho(-5.0f, 5.0f, -5.0f*(float)scale, 5.0f*(float)scale, 0.1f, 100.0f);
-		}
-		else if (WINDOW_WIDTH < WINDOW_HEIGHT)
-		{
-			scale = (double)WINDOW_WIDTH / (double)WINDOW_HEIGHT;
-			projection = glm::ortho(-5.0f * (float)scale, 5.0f * (float)scale, -5.0f, 5.0f, 0.1f, 100.0f);
-		}
-		else
+		GetSceneView(WINDOW_WIDTH, WINDOW_HEIGHT, view, projection, viewPosition);
+		ApplySceneView(view, projection, viewPosition);
+	}
+
+	// a streamed world fills in around the moving camera, and
+	// the animated entities and lights move on with the clock
+	if (NULL != m_pSceneManager)
+	{
+		m_pSceneManager->UpdateWorldStreaming(viewPosition, false);
+		m_pSceneManager->UpdateAnimation(currentFrame);
+	}
+
+	// the cursor is held in the middle of the window, so the
+	// prop under it is the one straight ahead of the camera
+	if ((NULL != m_pSceneManager) && (m_bQuadView == false))
+	{
+		glm::vec3 forward(-view[0][2], -view[1][2], -view[2][2]);
+		uint32_t entity = SceneEntities::INVALID_ENTITY;
+		float distance = 0.0f;
+		m_pSceneManager->PickEntity(viewPosition, forward, entity, distance);
+		if (entity != gPickedEntity)
 		{
-			projection = glm::ortho(-5.0f, 5.0f, -5.0f, 5.0f, 0.1f, 100.0f);
+			gPickedEntity = entity;
+			if (entity == SceneEntities::INVALID_ENTITY)
+			{
+				std::cout << "INFO: cursor is over nothing" << std::endl;
+			}
+			else
+			{
+				std::string name = m_pSceneManager->GetSceneEntities()->GetPrefabName(entity);
+				std::cout << "INFO: cursor is over " << (name.empty() ? "entity" : name.c_str())
+					<< " " << entity << " at a distance of " << distance << std::endl;
+			}
 		}
 	}
 
+	// a camera path moves on by a fixed step every frame, so
+	// recorded playback does not depend on the frame rate
+	if (NULL != m_pCameraPath)
+	{
+		m_pathFrame++;
+	}
+}
+
+/***********************************************************
+ *  SetCameraPath()
+ *
+ *  This method is used for playing back a camera path from
+ *  its first frame, or for going back to the interactive
+ *  camera when NULL is passed in.
+ ***********************************************************/
+void ViewManager::SetCameraPath(const CameraPath* pCameraPath)
+{
+	m_pCameraPath = pCameraPath;
+	m_pathFrame = (NULL != pCameraPath) ? pCameraPath->GetFirstFrame() : 0;
+}
+
+/***********************************************************
+ *  IsCameraPathFinished()
+ *
+ *  This method is used for checking whether every frame of
+ *  the camera path has been shown.
+ ***********************************************************/
+bool ViewManager::IsCameraPathFinished() const
+{
+	return((NULL != m_pCameraPath) && (m_pathFrame > m_pCameraPath->GetLastFrame()));
+}
+
+/***********************************************************
+ *  SetQuadView()
+ *
+ *  This method is used for drawing the front, side and top
+ *  views and the current camera together, one per quarter of
+ *  the window, or for going back to the current camera alone.
+ ***********************************************************/
+void ViewManager::SetQuadView(bool bQuadView)
+{
+	m_bQuadView = bQuadView;
+}
+
+/***********************************************************
+ *  ApplySceneView()
+ *
+ *  This method is used for passing a camera to the render
+ *  device, or to the shader when there is no device.
+ ***********************************************************/
+void ViewManager::ApplySceneView(
+	const glm::mat4& view,
+	const glm::mat4& projection,
+	const glm::vec3& viewPosition)
+{
+	// the scene reuses its draw list when this is a preset view
+	if (NULL != m_pSceneManager)
+	{
+		m_pSceneManager->SetSceneCamera(view, projection);
+	}
+
+	// the render device takes the camera when there is one
+	if (NULL != m_pRenderDevice)
+	{
+		m_pRenderDevice->SetView(view, projection, viewPosition);
+	}
 	// if the shader manager object is valid
-	if (NULL != m_pShaderManager)
+	else if (NULL != m_pShaderManager)
 	{
 		// set the view matrix into the shader for proper rendering
 		m_pShaderManager->setMat4Value(g_ViewName, view);
 		// set the view matrix into the shader for proper rendering
 		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
 		// set the view position of the camera into the shader for proper rendering
-		m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
+		m_pShaderManager->setVec3Value("viewPosition", viewPosition);
+	}
+}
+
+/***********************************************************
+ *  ApplySceneViews()
+ *
+ *  This method is used for passing several cameras to the
+ *  render device, which draws the scene once for all of them.
+ *  Without a device only the last camera can be shown.
+ ***********************************************************/
+void ViewManager::ApplySceneViews(const std::vector<RenderDevice::VIEWPORT_VIEW>& views)
+{
+	if (views.empty() == true)
+	{
+		return;
+	}
+
+	if (NULL != m_pRenderDevice)
+	{
+		m_pRenderDevice->SetViews(views);
+	}
+	else
+	{
+		const RenderDevice::VIEWPORT_VIEW& view = views.back();
+		ApplySceneView(view.view, view.projection, view.viewPosition);
+	}
+}
+
+/***********************************************************
+ *  GetSceneView()
+ *
+ *  This method is used for getting the view matrix, the
+ *  projection matrix and the position of the current camera
+ *  for an image of the passed in size, without touching the
+ *  shader, so renderers other than OpenGL can use them.
+ ***********************************************************/
+void ViewManager::GetSceneView(
+	int width,
+	int height,
+	glm::mat4& view,
+	glm::mat4& projection,
+	glm::vec3& viewPosition)
+{
+	// a camera path being played back takes over the camera
+	if (NULL != m_pCameraPath)
+	{
+		m_pCameraPath->GetSceneView(m_pathFrame, width, height, view, projection, viewPosition);
+		return;
+	}
+
+	// get the current view matrix from the camera
+	view = g_pCamera->GetViewMatrix();
+	viewPosition = g_pCamera->Position;
+
+	// define the current projection matrix
+	projection = GetProjection(bOrthographicProjection, g_pCamera->Zoom, width, height);
+}
+
+/***********************************************************
+ *  GetQuadViews()
+ *
+ *  This method is used for getting the cameras of the quad
+ *  view for an image size: the front, side and top preset
+ *  views across the top left, top right and bottom left
+ *  quarters, and the current camera in the bottom right one
+ *  so it can still be moved around.
+ ***********************************************************/
+void ViewManager::GetQuadViews(
+	int width,
+	int height,
+	std::vector<RenderDevice::VIEWPORT_VIEW>& views)
+{
+	int leftWidth = width / 2;
+	int topHeight = height / 2;
+
+	views.resize(4);
+	for (int i = 0; i < 4; i++)
+	{
+		RenderDevice::VIEWPORT_VIEW& quarter = views[i];
+		quarter.x = ((i % 2) == 0) ? 0 : leftWidth;
+		quarter.y = (i < 2) ? 0 : topHeight;
+		quarter.width = ((i % 2) == 0) ? leftWidth : (width - leftWidth);
+		quarter.height = (i < 2) ? topHeight : (height - topHeight);
+
+		if (i < 3)
+		{
+			const PRESET_VIEW& preset = g_PresetViews[i];
+			quarter.view = glm::lookAt(preset.position, preset.position + preset.front, preset.up);
+			quarter.projection = GetProjection(true, 0.0f, quarter.width, quarter.height);
+			quarter.viewPosition = preset.position;
+		}
+		else
+		{
+			GetSceneView(quarter.width, quarter.height, quarter.view, quarter.projection, quarter.viewPosition);
+		}
+	}
+}
+
+/***********************************************************
+ *  SaveTiledImage()
+ *
+ *  This method is used for rendering the current camera view
+ *  into an image larger than the window or the largest
+ *  framebuffer, such as for printing.  Each tile is drawn
+ *  into a small framebuffer object with its own off-center
+ *  projection, read back and written to the image file
+ *  before the next one, so only one tile is in memory.
+ ***********************************************************/
+bool ViewManager::SaveTiledImage(
+	SceneManager* pSceneManager,
+	const char* filename,
+	int width,
+	int height,
+	int tileSize)
+{
+	if (NULL == pSceneManager)
+	{
+		return(false);
+	}
+
+	// the tiles cannot be larger than the driver allows
+	GLint maxSize = 0;
+	glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxSize);
+	if ((maxSize > 0) && (tileSize > maxSize))
+	{
+		tileSize = maxSize;
+	}
+
+	TiledRenderer tiledRenderer;
+	if (tiledRenderer.Begin(filename, width, height, tileSize) == false)
+	{
+		std::cout << "Could not create tiled image:" << filename << std::endl;
+		return(false);
+	}
+
+	// a color and a depth buffer the size of one full tile
+	GLuint framebuffer = 0;
+	GLuint renderbuffers[2] = { 0, 0 };
+	glGenFramebuffers(1, &framebuffer);
+	glGenRenderbuffers(2, renderbuffers);
+	glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, tileSize, tileSize);
+	glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, tileSize, tileSize);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+
+	bool bReturn = (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+	if (bReturn == false)
+	{
+		std::cout << "Could not create the tile framebuffer" << std::endl;
+	}
+
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	// the camera is framed for the whole image, and every tile
+	// narrows its projection to a part of it
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::vec3 viewPosition;
+	GetSceneView(width, height, view, projection, viewPosition);
+	pSceneManager->UpdateWorldStreaming(viewPosition, true);
+
+	std::vector<unsigned char> pixels((size_t)tileSize * tileSize * 4);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	for (int i = 0; (i < tiledRenderer.GetTileCount()) && bReturn; i++)
+	{
+		TiledRenderer::IMAGE_TILE tile = tiledRenderer.GetTile(i);
+
+		glViewport(0, 0, tile.width, tile.height);
+		glEnable(GL_DEPTH_TEST);
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		ApplySceneView(view, tiledRenderer.GetTileProjection(projection, tile), viewPosition);
+		pSceneManager->RenderScene();
+
+		glReadPixels(0, 0, tile.width, tile.height, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+		bReturn = tiledRenderer.WriteTile(tile, &pixels[0], true);
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	glDeleteRenderbuffers(2, renderbuffers);
+	glDeleteFramebuffers(1, &framebuffer);
+
+	if (tiledRenderer.End() == false)
+	{
+		bReturn = false;
 	}
+	return(bReturn);
 }
\ No newline at end of file
@@ -10,11 +10,15 @@
 #pragma once
 
 #include "ShaderManager.h"
+#include "RenderDevice.h"
 #include "camera.h"
 
 // GLFW library
 #include "GLFW/glfw3.h" 
 
+class SceneManager;
+class CameraPath;
+
 class ViewManager
 {
 public:
@@ -30,16 +34,64 @@ public:
 private:
 	// pointer to shader manager object
 	ShaderManager* m_pShaderManager;
+	// pointer to the device the scene is drawn through
+	RenderDevice* m_pRenderDevice;
+	// pointer to the scene that is told about the camera
+	SceneManager* m_pSceneManager;
 	// active OpenGL display window
 	GLFWwindow* m_pWindow;
+	// camera path played back instead of the interactive camera
+	const CameraPath* m_pCameraPath;
+	int m_pathFrame;
+	// draw the four preset views at once instead of one camera
+	bool m_bQuadView;
 
 	// process keyboard events for interaction with the 3D scene
 	void ProcessKeyboardEvents();
+	// pass a camera to the render device or the shader
+	void ApplySceneView(
+		const glm::mat4& view,
+		const glm::mat4& projection,
+		const glm::vec3& viewPosition);
+	// pass several cameras to the render device, or the last
+	// one to the shader when there is no device
+	void ApplySceneViews(const std::vector<RenderDevice::VIEWPORT_VIEW>& views);
 
 public:
 	// create the initial OpenGL display window
 	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
 	
+	// set the device the camera is passed to, instead of the shader
+	void SetRenderDevice(RenderDevice* pRenderDevice);
+	// set the scene that keeps draw lists for the preset views
+	void SetSceneManager(SceneManager* pSceneManager);
+	// play a camera path back one frame per rendered frame
+	void SetCameraPath(const CameraPath* pCameraPath);
+	// check whether the last frame of the camera path was shown
+	bool IsCameraPathFinished() const;
+	// draw the front, side and top views and the current camera
+	// in the four quarters of the window
+	void SetQuadView(bool bQuadView);
 	// prepare the conversion from 3D object display to 2D scene display
 	void PrepareSceneView();
+	// get the view and projection of the camera for an image size
+	void GetSceneView(
+		int width,
+		int height,
+		glm::mat4& view,
+		glm::mat4& projection,
+		glm::vec3& viewPosition);
+	// get the cameras of the quad view for an image size
+	void GetQuadViews(
+		int width,
+		int height,
+		std::vector<RenderDevice::VIEWPORT_VIEW>& views);
+	// render the scene tile by tile through a framebuffer object
+	// into an image file of any size
+	bool SaveTiledImage(
+		SceneManager* pSceneManager,
+		const char* filename,
+		int width,
+		int height,
+		int tileSize);
 };
\ No newline at end of file
@@ -0,0 +1,1843 @@
+///////////////////////////////////////////////////////////////////////////////
+// vulkanrenderdevice.cpp
+// ============
+// issue the scene draw list through Vulkan into an offscreen image
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef USE_VULKAN
+
+#include "VulkanRenderDevice.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+// declaration of global variables and defines
+namespace
+{
+	// compiled shaders, read from the working directory
+	const char* g_VertexShaderFile = "VulkanScene.vert.spv";
+	const char* g_FragmentShaderFile = "VulkanScene.frag.spv";
+	// number of texture slots kept by the scene manager
+	const int g_TextureSlots = 16;
+	// number of light sources read by the shaders
+	const int g_MaxLights = 4;
+	// number of cameras drawn in one pass
+	const int g_MaxViews = 4;
+	// draws and materials the buffers first make room for
+	const int g_InitialDraws = 256;
+	const int g_InitialMaterials = 16;
+
+	// get the OpenGL projection corrected for the Vulkan clip
+	// space, whose y axis points down and whose depth goes from
+	// 0 to 1
+	glm::mat4 GetVulkanProjection(const glm::mat4& projection)
+	{
+		glm::mat4 clipCorrection(1.0f);
+		clipCorrection[1][1] = -1.0f;
+		clipCorrection[2][2] = 0.5f;
+		clipCorrection[3][2] = 0.5f;
+		return(clipCorrection * projection);
+	}
+
+	// get the time from a steady clock in milliseconds
+	double GetMilliseconds()
+	{
+		return(std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+}
+
+/***********************************************************
+ *  VulkanRenderDevice()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+VulkanRenderDevice::VulkanRenderDevice(int width, int height)
+{
+	m_width = width;
+	m_height = height;
+	m_bInitialized = false;
+
+	m_instance = VK_NULL_HANDLE;
+	m_physicalDevice = VK_NULL_HANDLE;
+	m_device = VK_NULL_HANDLE;
+	m_queue = VK_NULL_HANDLE;
+	m_queueFamily = 0;
+	memset(&m_memoryProperties, 0, sizeof(m_memoryProperties));
+	m_maxAnisotropy = 1.0f;
+
+	GPU_IMAGE emptyImage = { VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE };
+	GPU_BUFFER emptyBuffer = { VK_NULL_HANDLE, VK_NULL_HANDLE, 0, NULL };
+	m_colorTarget = emptyImage;
+	m_depthTarget = emptyImage;
+	m_readbackBuffer = emptyBuffer;
+	m_renderPass = VK_NULL_HANDLE;
+	m_framebuffer = VK_NULL_HANDLE;
+
+	m_descriptorSetLayout = VK_NULL_HANDLE;
+	m_descriptorPool = VK_NULL_HANDLE;
+	m_descriptorSet = VK_NULL_HANDLE;
+	m_pipelineLayout = VK_NULL_HANDLE;
+	m_pipeline = VK_NULL_HANDLE;
+
+	m_commandPool = VK_NULL_HANDLE;
+	m_primaryCommandBuffer = VK_NULL_HANDLE;
+	m_frameFence = VK_NULL_HANDLE;
+
+	m_vertexBuffer = emptyBuffer;
+	m_indexBuffer = emptyBuffer;
+	memset(m_meshRanges, 0, sizeof(m_meshRanges));
+
+	m_frameBuffer = emptyBuffer;
+	m_drawBuffer = emptyBuffer;
+	m_materialBuffer = emptyBuffer;
+	m_drawCapacity = 0;
+	m_materialCapacity = 0;
+	m_bRecordStale = true;
+	for (int i = 0; i < g_MaxViews; i++)
+	{
+		m_frame.views[i].view = glm::mat4(1.0f);
+		m_frame.views[i].projection = glm::mat4(1.0f);
+		m_frame.views[i].viewPosition = glm::vec4(0.0f);
+	}
+	m_frame.viewCount = 1;
+	m_viewRects.push_back(glm::ivec4(0, 0, width, height));
+	for (int i = 0; i < g_MaxLights; i++)
+	{
+		m_frame.lights[i].position = glm::vec4(0.0f);
+		m_frame.lights[i].ambientColor = glm::vec4(0.0f);
+		m_frame.lights[i].diffuseColor = glm::vec4(0.0f);
+		m_frame.lights[i].specularColor = glm::vec4(0.0f);
+	}
+	m_frame.lightCount = 0;
+	m_textures.resize(g_TextureSlots, emptyImage);
+
+	m_stats.recordMilliseconds = 0.0;
+	m_stats.gpuMilliseconds = 0.0;
+	m_stats.draws = 0;
+	m_stats.bRecorded = false;
+}
+
+/***********************************************************
+ *  ~VulkanRenderDevice()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+VulkanRenderDevice::~VulkanRenderDevice()
+{
+	if (VK_NULL_HANDLE != m_device)
+	{
+		vkDeviceWaitIdle(m_device);
+
+		for (size_t i = 0; i < m_recordThreads.size(); i++)
+		{
+			vkDestroyCommandPool(m_device, m_recordThreads[i].commandPool, NULL);
+		}
+		m_recordThreads.clear();
+
+		for (size_t i = 0; i < m_textures.size(); i++)
+		{
+			DestroyImage(m_textures[i]);
+		}
+		for (size_t i = 0; i < m_samplers.size(); i++)
+		{
+			vkDestroySampler(m_device, m_samplers[i], NULL);
+		}
+		m_samplers.clear();
+
+		DestroyBuffer(m_vertexBuffer);
+		DestroyBuffer(m_indexBuffer);
+		DestroyBuffer(m_frameBuffer);
+		DestroyBuffer(m_drawBuffer);
+		DestroyBuffer(m_materialBuffer);
+		DestroyBuffer(m_readbackBuffer);
+
+		vkDestroyFence(m_device, m_frameFence, NULL);
+		vkDestroyCommandPool(m_device, m_commandPool, NULL);
+		vkDestroyPipeline(m_device, m_pipeline, NULL);
+		vkDestroyPipelineLayout(m_device, m_pipelineLayout, NULL);
+		vkDestroyDescriptorPool(m_device, m_descriptorPool, NULL);
+		vkDestroyDescriptorSetLayout(m_device, m_descriptorSetLayout, NULL);
+		vkDestroyFramebuffer(m_device, m_framebuffer, NULL);
+		vkDestroyRenderPass(m_device, m_renderPass, NULL);
+		DestroyImage(m_colorTarget);
+		DestroyImage(m_depthTarget);
+
+		vkDestroyDevice(m_device, NULL);
+		m_device = VK_NULL_HANDLE;
+	}
+	if (VK_NULL_HANDLE != m_instance)
+	{
+		vkDestroyInstance(m_instance, NULL);
+		m_instance = VK_NULL_HANDLE;
+	}
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for creating the Vulkan device, the
+ *  offscreen targets, the pipeline and the buffers read by
+ *  the shaders.
+ ***********************************************************/
+bool VulkanRenderDevice::Initialize()
+{
+	if (m_bInitialized == true)
+	{
+		return(true);
+	}
+
+	if ((CreateInstance() == false) ||
+		(CreateDevice() == false) ||
+		(CreateTargets() == false) ||
+		(CreateSamplers() == false) ||
+		(CreatePipeline() == false))
+	{
+		return(false);
+	}
+
+	VkCommandPoolCreateInfo poolInfo = {};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	poolInfo.queueFamilyIndex = m_queueFamily;
+	if (vkCreateCommandPool(m_device, &poolInfo, NULL, &m_commandPool) != VK_SUCCESS)
+	{
+		std::cout << "ERROR: could not create the Vulkan command pool" << std::endl;
+		return(false);
+	}
+
+	VkCommandBufferAllocateInfo allocateInfo = {};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocateInfo.commandPool = m_commandPool;
+	allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocateInfo.commandBufferCount = 1;
+	if (vkAllocateCommandBuffers(m_device, &allocateInfo, &m_primaryCommandBuffer) != VK_SUCCESS)
+	{
+		std::cout << "ERROR: could not allocate the Vulkan command buffer" << std::endl;
+		return(false);
+	}
+
+	VkFenceCreateInfo fenceInfo = {};
+	fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	if (vkCreateFence(m_device, &fenceInfo, NULL, &m_frameFence) != VK_SUCCESS)
+	{
+		std::cout << "ERROR: could not create the Vulkan fence" << std::endl;
+		return(false);
+	}
+
+	// each recording thread has its own command pool, since a
+	// pool may only be used by one thread at a time
+	int threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+	for (int i = 0; i < threadCount; i++)
+	{
+		RECORD_THREAD thread;
+		thread.commandPool = VK_NULL_HANDLE;
+		thread.commandBuffer = VK_NULL_HANDLE;
+		thread.firstDraw = 0;
+		thread.lastDraw = 0;
+
+		VkCommandPoolCreateInfo threadPoolInfo = {};
+		threadPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		threadPoolInfo.queueFamilyIndex = m_queueFamily;
+		if (vkCreateCommandPool(m_device, &threadPoolInfo, NULL, &thread.commandPool) != VK_SUCCESS)
+		{
+			std::cout << "ERROR: could not create the Vulkan command pool" << std::endl;
+			return(false);
+		}
+		m_recordThreads.push_back(thread);
+
+		VkCommandBufferAllocateInfo secondaryInfo = {};
+		secondaryInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		secondaryInfo.commandPool = thread.commandPool;
+		secondaryInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+		secondaryInfo.commandBufferCount = 1;
+		if (vkAllocateCommandBuffers(m_device, &secondaryInfo, &m_recordThreads.back().commandBuffer) != VK_SUCCESS)
+		{
+			std::cout << "ERROR: could not allocate the Vulkan command buffer" << std::endl;
+			return(false);
+		}
+	}
+
+	if ((CreateBuffer(
+			sizeof(GPU_FRAME),
+			VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			m_frameBuffer) == false) ||
+		(ReserveDraws(g_InitialDraws, g_InitialMaterials) == false))
+	{
+		return(false);
+	}
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+	std::cout << "Vulkan render device: " << properties.deviceName << ", "
+		<< m_recordThreads.size() << " recording threads" << std::endl;
+
+	m_bInitialized = true;
+	return(true);
+}
+
+/***********************************************************
+ *  CreateInstance()
+ *
+ *  This method is used for creating the Vulkan instance.  No
+ *  surface extensions are needed to render offscreen.
+ ***********************************************************/
+bool VulkanRenderDevice::CreateInstance()
+{
+	VkApplicationInfo applicationInfo = {};
+	applicationInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+	applicationInfo.pApplicationName = "7-1 Project";
+	applicationInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
+	applicationInfo.pEngineName = "SceneManager";
+	applicationInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
+	// descriptor indexing is part of the core API from 1.2
+	applicationInfo.apiVersion = VK_API_VERSION_1_2;
+
+	VkInstanceCreateInfo instanceInfo = {};
+	instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+	instanceInfo.pApplicationInfo = &applicationInfo;
+	if (vkCreateInstance(&instanceInfo, NULL, &m_instance) != VK_SUCCESS)
+	{
+		std::cout << "ERROR: could not create a Vulkan 1.2 instance" << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  CreateDevice()
+ *
+ *  This method is used for choosing the first physical device
+ *  with a graphics queue and the descriptor indexing and
+ *  viewport features used by the shaders, and for creating
+ *  the logical device.
+ ***********************************************************/
+bool VulkanRenderDevice::CreateDevice()
+{
+	uint32_t deviceCount = 0;
+	vkEnumeratePhysicalDevices(m_instance, &deviceCount, NULL);
+	std::vector<VkPhysicalDevice> devices(deviceCount);
+	if (deviceCount > 0)
+	{
+		vkEnumeratePhysicalDevices(m_instance, &deviceCount, &devices[0]);
+	}
+
+	for (uint32_t i = 0; (i < deviceCount) && (VK_NULL_HANDLE == m_physicalDevice); i++)
+	{
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(devices[i], &properties);
+		if (properties.apiVersion < VK_API_VERSION_1_2)
+		{
+			continue;
+		}
+
+		VkPhysicalDeviceVulkan12Features indexingFeatures = {};
+		indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+		VkPhysicalDeviceFeatures2 features = {};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features.pNext = &indexingFeatures;
+		vkGetPhysicalDeviceFeatures2(devices[i], &features);
+		if ((indexingFeatures.runtimeDescriptorArray == VK_FALSE) ||
+			(indexingFeatures.descriptorBindingPartiallyBound == VK_FALSE) ||
+			(indexingFeatures.shaderSampledImageArrayNonUniformIndexing == VK_FALSE) ||
+			(indexingFeatures.shaderOutputViewportIndex == VK_FALSE) ||
+			(features.features.multiViewport == VK_FALSE))
+		{
+			continue;
+		}
+
+		uint32_t familyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(devices[i], &familyCount, NULL);
+		std::vector<VkQueueFamilyProperties> families(familyCount);
+		if (familyCount > 0)
+		{
+			vkGetPhysicalDeviceQueueFamilyProperties(devices[i], &familyCount, &families[0]);
+		}
+		for (uint32_t family = 0; family < familyCount; family++)
+		{
+			if ((families[family].queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0)
+			{
+				m_physicalDevice = devices[i];
+				m_queueFamily = family;
+				if (features.features.samplerAnisotropy == VK_TRUE)
+				{
+					m_maxAnisotropy = properties.limits.maxSamplerAnisotropy;
+				}
+				break;
+			}
+		}
+	}
+
+	if (VK_NULL_HANDLE == m_physicalDevice)
+	{
+		std::cout << "ERROR: no Vulkan device supports descriptor indexing and viewport arrays" << std::endl;
+		return(false);
+	}
+	vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &m_memoryProperties);
+
+	float queuePriority = 1.0f;
+	VkDeviceQueueCreateInfo queueInfo = {};
+	queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+	queueInfo.queueFamilyIndex = m_queueFamily;
+	queueInfo.queueCount = 1;
+	queueInfo.pQueuePriorities = &queuePriority;
+
+	VkPhysicalDeviceVulkan12Features enabledIndexing = {};
+	enabledIndexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+	enabledIndexing.runtimeDescriptorArray = VK_TRUE;
+	enabledIndexing.descriptorBindingPartiallyBound = VK_TRUE;
+	enabledIndexing.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+	enabledIndexing.shaderOutputViewportIndex = VK_TRUE;
+	VkPhysicalDeviceFeatures2 enabledFeatures = {};
+	enabledFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+	enabledFeatures.pNext = &enabledIndexing;
+	enabledFeatures.features.samplerAnisotropy = (m_maxAnisotropy > 1.0f) ? VK_TRUE : VK_FALSE;
+	enabledFeatures.features.multiViewport = VK_TRUE;
+
+	VkDeviceCreateInfo deviceInfo = {};
+	deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+	deviceInfo.pNext = &enabledFeatures;
+	deviceInfo.queueCreateInfoCount = 1;
+	deviceInfo.pQueueCreateInfos = &queueInfo;
+	if (vkCreateDevice(m_physicalDevice, &deviceInfo, NULL, &m_device) != VK_SUCCESS)
+	{
+		std::cout << "ERROR: could not create the Vulkan device" << std::endl;
+		return(false);
+	}
+	vkGetDeviceQueue(m_device, m_queueFamily, 0, &m_queue);
+
+	return(true);
+}
+
+/***********************************************************
+ *  CreateTargets()
+ *
+ *  This method is used for creating the offscreen color and
+ *  depth images, the render pass that draws into them and
+ *  the buffer the finished image is copied back into.
+ ***********************************************************/
+bool VulkanRenderDevice::CreateTargets()
+{
+	// one of these two depth formats is always supported
+	VkFormat depthFormat = VK_FORMAT_D32_SFLOAT;
+	VkFormatProperties formatProperties;
+	vkGetPhysicalDeviceFormatProperties(m_physicalDevice, depthFormat, &formatProperties);
+	if ((formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) == 0)
+	{
+		depthFormat = VK_FORMAT_X8_D24_UNORM_PACK32;
+	}
+
+	if ((CreateImage(
+			m_width, m_height, 1,
+			VK_FORMAT_R8G8B8A8_UNORM,
+			VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+			VK_IMAGE_ASPECT_COLOR_BIT,
+			m_colorTarget) == false) ||
+		(CreateImage(
+			m_width, m_height, 1,
+			depthFormat,
+			VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+			VK_IMAGE_ASPECT_DEPTH_BIT,
+			m_depthTarget) == false) ||
+		(CreateBuffer(
+			(VkDeviceSize)m_width * m_height * 4,
+			VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			m_readbackBuffer) == false))
+	{
+		return(false);
+	}
+
+	VkAttachmentDescription attachments[2] = {};
+	attachments[0].format = VK_FORMAT_R8G8B8A8_UNORM;
+	attachments[0].samples = VK_SAMPLE_COUNT_1_BIT;
+	attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	attachments[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	attachments[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachments[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	attachments[0].finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	attachments[1].format = depthFormat;
+	attachments[1].samples = VK_SAMPLE_COUNT_1_BIT;
+	attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	attachments[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachments[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachments[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachments[1].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	attachments[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+	VkAttachmentReference colorReference = { 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+	VkAttachmentReference depthReference = { 1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+	VkSubpassDescription subpass = {};
+	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpass.colorAttachmentCount = 1;
+	subpass.pColorAttachments = &colorReference;
+	subpass.pDepthStencilAttachment = &depthReference;
+
+	// the previous frame's copy must finish reading the color
+	// image before it is cleared, and the drawing must finish
+	// before this frame's copy reads it
+	VkSubpassDependency dependencies[2] = {};
+	dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[0].dstSubpass = 0;
+	dependencies[0].srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+	dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+	dependencies[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	dependencies[1].srcSubpass = 0;
+	dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+	VkRenderPassCreateInfo renderPassInfo = {};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderPassInfo.attachmentCount = 2;
+	renderPassInfo.pAttachments = attachments;
+	renderPassInfo.subpassCount = 1;
+	renderPassInfo.pSubpasses = &subpass;
+	renderPassInfo.dependencyCount = 2;
+	renderPassInfo.pDependencies = dependencies;
+	if (vkCreateRenderPass(m_device, &renderPassInfo, NULL, &m_renderPass) != VK_SUCCESS)
+	{
+		std::cout << "ERROR: could not create the Vulkan render pass" << std::endl;
+		return(false);
+	}
+
+	VkImageView views[2] = { m_colorTarget.view, m_depthTarget.view };
+	VkFramebufferCreateInfo framebufferInfo = {};
+	framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+	framebufferInfo.renderPass = m_renderPass;
+	framebufferInfo.attachmentCount = 2;
+	framebufferInfo.pAttachments = views;
+	framebufferInfo.width = m_width;
+	framebufferInfo.height = m_height;
+	framebufferInfo.layers = 1;
+	if (vkCreateFramebuffer(m_device, &framebufferInfo, NULL, &m_framebuffer) != VK_SUCCESS)
+	{
+		std::cout << "ERROR: could not create the Vulkan framebuffer" << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  CreateSamplers()
+ *
+ *  This method is used for creating one sampler for every
+ *  filtering preset and wrap mode, matching the settings of
+ *  the OpenGL sampler objects.
+ ***********************************************************/
+bool VulkanRenderDevice::CreateSamplers()
+{
+	for (int filter = 0; filter < TextureSamplers::FILTER_COUNT; filter++)
+	{
+		for (int wrap = 0; wrap < TextureSamplers::WRAP_COUNT; wrap++)
+		{
+			VkSamplerAddressMode addressMode = (wrap == TextureSamplers::WRAP_CLAMP) ?
+				VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE : VK_SAMPLER_ADDRESS_MODE_REPEAT;
+
+			VkSamplerCreateInfo samplerInfo = {};
+			samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+			samplerInfo.addressModeU = addressMode;
+			samplerInfo.addressModeV = addressMode;
+			samplerInfo.addressModeW = addressMode;
+			samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+			if (filter == TextureSamplers::FILTER_NEAREST)
+			{
+				samplerInfo.magFilter = VK_FILTER_NEAREST;
+				samplerInfo.minFilter = VK_FILTER_NEAREST;
+				samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+			}
+			else
+			{
+				samplerInfo.magFilter = VK_FILTER_LINEAR;
+				samplerInfo.minFilter = VK_FILTER_LINEAR;
+				samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+			}
+
+			float anisotropy = 1.0f;
+			if (filter == TextureSamplers::FILTER_ANISOTROPIC_4X)
+			{
+				anisotropy = 4.0f;
+			}
+			else if (filter == TextureSamplers::FILTER_ANISOTROPIC_16X)
+			{
+				anisotropy = 16.0f;
+			}
+			anisotropy = std::min(anisotropy, m_maxAnisotropy);
+			if (anisotropy > 1.0f)
+			{
+				samplerInfo.anisotropyEnable = VK_TRUE;
+				samplerInfo.maxAnisotropy = anisotropy;
+			}
+
+			VkSampler sampler = VK_NULL_HANDLE;
+			if (vkCreateSampler(m_device, &samplerInfo, NULL, &sampler) != VK_SUCCESS)
+			{
+				std::cout << "ERROR: could not create the Vulkan samplers" << std::endl;
+				return(false);
+			}
+			m_samplers.push_back(sampler);
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  CreateShaderModule()
+ *
+ *  This method is used for loading a compiled SPIR-V shader
+ *  from a file.
+ ***********************************************************/
+bool VulkanRenderDevice::CreateShaderModule(const char* filename, VkShaderModule& shaderModule)
+{
+	FILE* pFile = fopen(filename, "rb");
+	if (NULL == pFile)
+	{
+		std::cout << "ERROR: could not open the shader " << filename << std::endl;
+		return(false);
+	}
+
+	fseek(pFile, 0, SEEK_END);
+	long size = ftell(pFile);
+	fseek(pFile, 0, SEEK_SET);
+
+	// SPIR-V is a stream of 32 bit words
+	std::vector<uint32_t> code((size > 0) ? ((size + 3) / 4) : 0);
+	bool bReturn = (size > 0) && ((size % 4) == 0) &&
+		(fread(&code[0], 1, size, pFile) == (size_t)size);
+	fclose(pFile);
+	if (bReturn == false)
+	{
+		std::cout << "ERROR: could not read the shader " << filename << std::endl;
+		return(false);
+	}
+
+	VkShaderModuleCreateInfo moduleInfo = {};
+	moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	moduleInfo.codeSize = (size_t)size;
+	moduleInfo.pCode = &code[0];
+	if (vkCreateShaderModule(m_device, &moduleInfo, NULL, &shaderModule) != VK_SUCCESS)
+	{
+		std::cout << "ERROR: could not create the shader " << filename << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  CreatePipeline()
+ *
+ *  This method is used for creating the descriptor set read
+ *  by the shaders and the graphics pipeline, which blends by
+ *  alpha and tests depth like the OpenGL render state.
+ ***********************************************************/
+bool VulkanRenderDevice::CreatePipeline()
+{
+	VkDescriptorSetLayoutBinding bindings[5] = {};
+	bindings[0].binding = 0;
+	bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	bindings[0].descriptorCount = 1;
+	bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+	bindings[1].binding = 1;
+	bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	bindings[1].descriptorCount = 1;
+	bindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+	bindings[2].binding = 2;
+	bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	bindings[2].descriptorCount = 1;
+	bindings[2].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+	bindings[3].binding = 3;
+	bindings[3].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+	bindings[3].descriptorCount = g_TextureSlots;
+	bindings[3].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+	bindings[4].binding = 4;
+	bindings[4].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+	bindings[4].descriptorCount = (uint32_t)m_samplers.size();
+	bindings[4].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+	// texture slots that were never loaded are left unwritten
+	VkDescriptorBindingFlags bindingFlags[5] = { 0, 0, 0, VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT, 0 };
+	VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo = {};
+	flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+	flagsInfo.bindingCount = 5;
+	flagsInfo.pBindingFlags = bindingFlags;
+
+	VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutInfo.pNext = &flagsInfo;
+	layoutInfo.bindingCount = 5;
+	layoutInfo.pBindings = bindings;
+	if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, NULL, &m_descriptorSetLayout) != VK_SUCCESS)
+	{
+		std::cout << "ERROR: could not create the Vulkan descriptor set layout" << std::endl;
+		return(false);
+	}
+
+	VkDescriptorPoolSize poolSizes[4] = {};
+	poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	poolSizes[0].descriptorCount = 1;
+	poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	poolSizes[1].descriptorCount = 2;
+	poolSizes[2].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+	poolSizes[2].descriptorCount = g_TextureSlots;
+	poolSizes[3].type = VK_DESCRIPTOR_TYPE_SAMPLER;
+	poolSizes[3].descriptorCount = (uint32_t)m_samplers.size();
+
+	VkDescriptorPoolCreateInfo poolInfo = {};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.maxSets = 1;
+	poolInfo.poolSizeCount = 4;
+	poolInfo.pPoolSizes = poolSizes;
+	if (vkCreateDescriptorPool(m_device, &poolInfo, NULL, &m_descriptorPool) != VK_SUCCESS)
+	{
+		std::cout << "ERROR: could not create the Vulkan descriptor pool" << std::endl;
+		return(false);
+	}
+
+	VkDescriptorSetAllocateInfo setInfo = {};
+	setInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	setInfo.descriptorPool = m_descriptorPool;
+	setInfo.descriptorSetCount = 1;
+	setInfo.pSetLayouts = &m_descriptorSetLayout;
+	if (vkAllocateDescriptorSets(m_device, &setInfo, &m_descriptorSet) != VK_SUCCESS)
+	{
+		std::cout << "ERROR: could not allocate the Vulkan descriptor set" << std::endl;
+		return(false);
+	}
+
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = 1;
+	pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
+	if (vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, NULL, &m_pipelineLayout) != VK_SUCCESS)
+	{
+		std::cout << "ERROR: could not create the Vulkan pipeline layout" << std::endl;
+		return(false);
+	}
+
+	VkShaderModule vertexShader = VK_NULL_HANDLE;
+	VkShaderModule fragmentShader = VK_NULL_HANDLE;
+	if ((CreateShaderModule(g_VertexShaderFile, vertexShader) == false) ||
+		(CreateShaderModule(g_FragmentShaderFile, fragmentShader) == false))
+	{
+		vkDestroyShaderModule(m_device, vertexShader, NULL);
+		return(false);
+	}
+
+	VkPipelineShaderStageCreateInfo stages[2] = {};
+	stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+	stages[0].module = vertexShader;
+	stages[0].pName = "main";
+	stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+	stages[1].module = fragmentShader;
+	stages[1].pName = "main";
+
+	VkVertexInputBindingDescription vertexBinding = {};
+	vertexBinding.binding = 0;
+	vertexBinding.stride = sizeof(PrimitiveGeometry::MESH_VERTEX);
+	vertexBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+	VkVertexInputAttributeDescription vertexAttributes[3] = {};
+	vertexAttributes[0].location = 0;
+	vertexAttributes[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+	vertexAttributes[0].offset = offsetof(PrimitiveGeometry::MESH_VERTEX, position);
+	vertexAttributes[1].location = 1;
+	vertexAttributes[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+	vertexAttributes[1].offset = offsetof(PrimitiveGeometry::MESH_VERTEX, normal);
+	vertexAttributes[2].location = 2;
+	vertexAttributes[2].format = VK_FORMAT_R32G32_SFLOAT;
+	vertexAttributes[2].offset = offsetof(PrimitiveGeometry::MESH_VERTEX, uv);
+
+	VkPipelineVertexInputStateCreateInfo vertexInput = {};
+	vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+	vertexInput.vertexBindingDescriptionCount = 1;
+	vertexInput.pVertexBindingDescriptions = &vertexBinding;
+	vertexInput.vertexAttributeDescriptionCount = 3;
+	vertexInput.pVertexAttributeDescriptions = vertexAttributes;
+
+	VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+	inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+	// one viewport per camera, set with the recorded draws
+	// since they change only when the cameras are rearranged
+	VkPipelineViewportStateCreateInfo viewportState = {};
+	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewportState.viewportCount = g_MaxViews;
+	viewportState.scissorCount = g_MaxViews;
+
+	VkDynamicState dynamicStates[2] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+	VkPipelineDynamicStateCreateInfo dynamicState = {};
+	dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamicState.dynamicStateCount = 2;
+	dynamicState.pDynamicStates = dynamicStates;
+
+	VkPipelineRasterizationStateCreateInfo rasterization = {};
+	rasterization.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterization.polygonMode = VK_POLYGON_MODE_FILL;
+	rasterization.cullMode = VK_CULL_MODE_NONE;
+	rasterization.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+	rasterization.lineWidth = 1.0f;
+
+	VkPipelineMultisampleStateCreateInfo multisample = {};
+	multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+	VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+	depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+	depthStencil.depthTestEnable = VK_TRUE;
+	depthStencil.depthWriteEnable = VK_TRUE;
+	depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+
+	// the same factors as glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)
+	VkPipelineColorBlendAttachmentState blendAttachment = {};
+	blendAttachment.blendEnable = VK_TRUE;
+	blendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+	blendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	blendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+	blendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+	blendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	blendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+	blendAttachment.colorWriteMask =
+		VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+		VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+	VkPipelineColorBlendStateCreateInfo colorBlend = {};
+	colorBlend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	colorBlend.attachmentCount = 1;
+	colorBlend.pAttachments = &blendAttachment;
+
+	VkGraphicsPipelineCreateInfo pipelineInfo = {};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipelineInfo.stageCount = 2;
+	pipelineInfo.pStages = stages;
+	pipelineInfo.pVertexInputState = &vertexInput;
+	pipelineInfo.pInputAssemblyState = &inputAssembly;
+	pipelineInfo.pViewportState = &viewportState;
+	pipelineInfo.pRasterizationState = &rasterization;
+	pipelineInfo.pMultisampleState = &multisample;
+	pipelineInfo.pDepthStencilState = &depthStencil;
+	pipelineInfo.pColorBlendState = &colorBlend;
+	pipelineInfo.pDynamicState = &dynamicState;
+	pipelineInfo.layout = m_pipelineLayout;
+	pipelineInfo.renderPass = m_renderPass;
+	pipelineInfo.subpass = 0;
+	VkResult result = vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, NULL, &m_pipeline);
+
+	vkDestroyShaderModule(m_device, vertexShader, NULL);
+	vkDestroyShaderModule(m_device, fragmentShader, NULL);
+	if (result != VK_SUCCESS)
+	{
+		std::cout << "ERROR: could not create the Vulkan pipeline" << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  FindMemoryType()
+ *
+ *  This method is used for finding a memory type allowed for
+ *  a resource that has the passed in properties.
+ ***********************************************************/
+bool VulkanRenderDevice::FindMemoryType(
+	uint32_t typeBits,
+	VkMemoryPropertyFlags properties,
+	uint32_t& memoryType)
+{
+	for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; i++)
+	{
+		if (((typeBits & (1u << i)) != 0) &&
+			((m_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties))
+		{
+			memoryType = i;
+			return(true);
+		}
+	}
+
+	std::cout << "ERROR: no Vulkan memory type has the needed properties" << std::endl;
+	return(false);
+}
+
+/***********************************************************
+ *  CreateBuffer()
+ *
+ *  This method is used for creating a buffer and its memory.
+ *  Host visible buffers are mapped for as long as they exist.
+ ***********************************************************/
+bool VulkanRenderDevice::CreateBuffer(
+	VkDeviceSize size,
+	VkBufferUsageFlags usage,
+	VkMemoryPropertyFlags properties,
+	GPU_BUFFER& buffer)
+{
+	buffer.buffer = VK_NULL_HANDLE;
+	buffer.memory = VK_NULL_HANDLE;
+	buffer.size = size;
+	buffer.pMapped = NULL;
+
+	VkBufferCreateInfo bufferInfo = {};
+	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferInfo.size = size;
+	bufferInfo.usage = usage;
+	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	if (vkCreateBuffer(m_device, &bufferInfo, NULL, &buffer.buffer) != VK_SUCCESS)
+	{
+		std::cout << "ERROR: could not create a Vulkan buffer" << std::endl;
+		return(false);
+	}
+
+	VkMemoryRequirements requirements;
+	vkGetBufferMemoryRequirements(m_device, buffer.buffer, &requirements);
+	VkMemoryAllocateInfo allocateInfo = {};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocateInfo.allocationSize = requirements.size;
+	if ((FindMemoryType(requirements.memoryTypeBits, properties, allocateInfo.memoryTypeIndex) == false) ||
+		(vkAllocateMemory(m_device, &allocateInfo, NULL, &buffer.memory) != VK_SUCCESS) ||
+		(vkBindBufferMemory(m_device, buffer.buffer, buffer.memory, 0) != VK_SUCCESS))
+	{
+		std::cout << "ERROR: could not allocate Vulkan buffer memory" << std::endl;
+		DestroyBuffer(buffer);
+		return(false);
+	}
+
+	if (((properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0) &&
+		(vkMapMemory(m_device, buffer.memory, 0, size, 0, &buffer.pMapped) != VK_SUCCESS))
+	{
+		std::cout << "ERROR: could not map Vulkan buffer memory" << std::endl;
+		DestroyBuffer(buffer);
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  DestroyBuffer()
+ *
+ *  This method is used for freeing a buffer and its memory.
+ ***********************************************************/
+void VulkanRenderDevice::DestroyBuffer(GPU_BUFFER& buffer)
+{
+	if (NULL != buffer.pMapped)
+	{
+		vkUnmapMemory(m_device, buffer.memory);
+		buffer.pMapped = NULL;
+	}
+	vkDestroyBuffer(m_device, buffer.buffer, NULL);
+	vkFreeMemory(m_device, buffer.memory, NULL);
+	buffer.buffer = VK_NULL_HANDLE;
+	buffer.memory = VK_NULL_HANDLE;
+	buffer.size = 0;
+}
+
+/***********************************************************
+ *  CreateImage()
+ *
+ *  This method is used for creating a 2D image in device
+ *  local memory and a view of all its mipmap levels.
+ ***********************************************************/
+bool VulkanRenderDevice::CreateImage(
+	uint32_t width,
+	uint32_t height,
+	uint32_t mipLevels,
+	VkFormat format,
+	VkImageUsageFlags usage,
+	VkImageAspectFlags aspect,
+	GPU_IMAGE& image)
+{
+	image.image = VK_NULL_HANDLE;
+	image.memory = VK_NULL_HANDLE;
+	image.view = VK_NULL_HANDLE;
+
+	VkImageCreateInfo imageInfo = {};
+	imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageInfo.format = format;
+	imageInfo.extent.width = width;
+	imageInfo.extent.height = height;
+	imageInfo.extent.depth = 1;
+	imageInfo.mipLevels = mipLevels;
+	imageInfo.arrayLayers = 1;
+	imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageInfo.usage = usage;
+	imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	if (vkCreateImage(m_device, &imageInfo, NULL, &image.image) != VK_SUCCESS)
+	{
+		std::cout << "ERROR: could not create a Vulkan image" << std::endl;
+		return(false);
+	}
+
+	VkMemoryRequirements requirements;
+	vkGetImageMemoryRequirements(m_device, image.image, &requirements);
+	VkMemoryAllocateInfo allocateInfo = {};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocateInfo.allocationSize = requirements.size;
+	if ((FindMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, allocateInfo.memoryTypeIndex) == false) ||
+		(vkAllocateMemory(m_device, &allocateInfo, NULL, &image.memory) != VK_SUCCESS) ||
+		(vkBindImageMemory(m_device, image.image, image.memory, 0) != VK_SUCCESS))
+	{
+		std::cout << "ERROR: could not allocate Vulkan image memory" << std::endl;
+		DestroyImage(image);
+		return(false);
+	}
+
+	VkImageViewCreateInfo viewInfo = {};
+	viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	viewInfo.image = image.image;
+	viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	viewInfo.format = format;
+	viewInfo.subresourceRange.aspectMask = aspect;
+	viewInfo.subresourceRange.levelCount = mipLevels;
+	viewInfo.subresourceRange.layerCount = 1;
+	if (vkCreateImageView(m_device, &viewInfo, NULL, &image.view) != VK_SUCCESS)
+	{
+		std::cout << "ERROR: could not create a Vulkan image view" << std::endl;
+		DestroyImage(image);
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  DestroyImage()
+ *
+ *  This method is used for freeing an image, its view and
+ *  its memory.
+ ***********************************************************/
+void VulkanRenderDevice::DestroyImage(GPU_IMAGE& image)
+{
+	vkDestroyImageView(m_device, image.view, NULL);
+	vkDestroyImage(m_device, image.image, NULL);
+	vkFreeMemory(m_device, image.memory, NULL);
+	image.image = VK_NULL_HANDLE;
+	image.memory = VK_NULL_HANDLE;
+	image.view = VK_NULL_HANDLE;
+}
+
+/***********************************************************
+ *  BeginOneTimeCommands()
+ *
+ *  This method is used for starting a command buffer for
+ *  uploads that run once.
+ ***********************************************************/
+VkCommandBuffer VulkanRenderDevice::BeginOneTimeCommands()
+{
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+	VkCommandBufferAllocateInfo allocateInfo = {};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocateInfo.commandPool = m_commandPool;
+	allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocateInfo.commandBufferCount = 1;
+	if (vkAllocateCommandBuffers(m_device, &allocateInfo, &commandBuffer) != VK_SUCCESS)
+	{
+		return(VK_NULL_HANDLE);
+	}
+
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+	return(commandBuffer);
+}
+
+/***********************************************************
+ *  EndOneTimeCommands()
+ *
+ *  This method is used for submitting a command buffer from
+ *  BeginOneTimeCommands() and waiting for it to finish.
+ ***********************************************************/
+bool VulkanRenderDevice::EndOneTimeCommands(VkCommandBuffer commandBuffer)
+{
+	vkEndCommandBuffer(commandBuffer);
+
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+	bool bReturn =
+		(vkQueueSubmit(m_queue, 1, &submitInfo, VK_NULL_HANDLE) == VK_SUCCESS) &&
+		(vkQueueWaitIdle(m_queue) == VK_SUCCESS);
+
+	vkFreeCommandBuffers(m_device, m_commandPool, 1, &commandBuffer);
+	return(bReturn);
+}
+
+/***********************************************************
+ *  UploadBuffer()
+ *
+ *  This method is used for creating a device local buffer
+ *  and copying the passed in data into it through a staging
+ *  buffer.
+ ***********************************************************/
+bool VulkanRenderDevice::UploadBuffer(
+	const void* data,
+	VkDeviceSize size,
+	VkBufferUsageFlags usage,
+	GPU_BUFFER& buffer)
+{
+	GPU_BUFFER staging;
+	if (CreateBuffer(
+		size,
+		VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		staging) == false)
+	{
+		return(false);
+	}
+	memcpy(staging.pMapped, data, (size_t)size);
+
+	bool bReturn = CreateBuffer(
+		size,
+		usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		buffer);
+	if (bReturn == true)
+	{
+		VkCommandBuffer commandBuffer = BeginOneTimeCommands();
+		VkBufferCopy region = { 0, 0, size };
+		vkCmdCopyBuffer(commandBuffer, staging.buffer, buffer.buffer, 1, &region);
+		bReturn = EndOneTimeCommands(commandBuffer);
+	}
+
+	DestroyBuffer(staging);
+	return(bReturn);
+}
+
+/***********************************************************
+ *  CreateTexture()
+ *
+ *  This method is used for uploading the pixels of a scene
+ *  texture and blitting each mipmap level down from the one
+ *  above it.  The rows are uploaded bottom first, as they are
+ *  for OpenGL, so the texture coordinates match.
+ ***********************************************************/
+bool VulkanRenderDevice::CreateTexture(
+	const SceneManager::TEXTURE_IMAGE& source,
+	GPU_IMAGE& texture)
+{
+	uint32_t mipLevels = 1;
+	while ((source.width >> mipLevels) > 0 || (source.height >> mipLevels) > 0)
+	{
+		mipLevels++;
+	}
+
+	GPU_BUFFER staging;
+	if (CreateBuffer(
+		source.pixels.size(),
+		VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		staging) == false)
+	{
+		return(false);
+	}
+	memcpy(staging.pMapped, &source.pixels[0], source.pixels.size());
+
+	if (CreateImage(
+		source.width, source.height, mipLevels,
+		VK_FORMAT_R8G8B8A8_UNORM,
+		VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+		VK_IMAGE_ASPECT_COLOR_BIT,
+		texture) == false)
+	{
+		DestroyBuffer(staging);
+		return(false);
+	}
+
+	VkCommandBuffer commandBuffer = BeginOneTimeCommands();
+
+	VkImageMemoryBarrier barrier = {};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = texture.image;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.levelCount = mipLevels;
+	barrier.subresourceRange.layerCount = 1;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	vkCmdPipelineBarrier(commandBuffer,
+		VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0, 0, NULL, 0, NULL, 1, &barrier);
+
+	VkBufferImageCopy region = {};
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.layerCount = 1;
+	region.imageExtent.width = source.width;
+	region.imageExtent.height = source.height;
+	region.imageExtent.depth = 1;
+	vkCmdCopyBufferToImage(commandBuffer, staging.buffer, texture.image,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+	barrier.subresourceRange.levelCount = 1;
+	int32_t width = source.width;
+	int32_t height = source.height;
+	for (uint32_t level = 1; level < mipLevels; level++)
+	{
+		// the level above becomes the source of this blit
+		barrier.subresourceRange.baseMipLevel = level - 1;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 0, NULL, 0, NULL, 1, &barrier);
+
+		int32_t nextWidth = std::max(1, width / 2);
+		int32_t nextHeight = std::max(1, height / 2);
+		VkImageBlit blit = {};
+		blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		blit.srcSubresource.mipLevel = level - 1;
+		blit.srcSubresource.layerCount = 1;
+		blit.srcOffsets[1].x = width;
+		blit.srcOffsets[1].y = height;
+		blit.srcOffsets[1].z = 1;
+		blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		blit.dstSubresource.mipLevel = level;
+		blit.dstSubresource.layerCount = 1;
+		blit.dstOffsets[1].x = nextWidth;
+		blit.dstOffsets[1].y = nextHeight;
+		blit.dstOffsets[1].z = 1;
+		vkCmdBlitImage(commandBuffer,
+			texture.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			texture.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			1, &blit, VK_FILTER_LINEAR);
+
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			0, 0, NULL, 0, NULL, 1, &barrier);
+
+		width = nextWidth;
+		height = nextHeight;
+	}
+
+	// the smallest level was only ever written
+	barrier.subresourceRange.baseMipLevel = mipLevels - 1;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+		0, 0, NULL, 0, NULL, 1, &barrier);
+
+	bool bReturn = EndOneTimeCommands(commandBuffer);
+	DestroyBuffer(staging);
+	return(bReturn);
+}
+
+/***********************************************************
+ *  UpdateDescriptors()
+ *
+ *  This method is used for pointing the descriptor set at the
+ *  current buffers, the loaded textures and the samplers.
+ *  Command buffers using the set are recorded again after.
+ ***********************************************************/
+void VulkanRenderDevice::UpdateDescriptors()
+{
+	VkDescriptorBufferInfo bufferInfos[3] = {};
+	bufferInfos[0].buffer = m_frameBuffer.buffer;
+	bufferInfos[0].range = VK_WHOLE_SIZE;
+	bufferInfos[1].buffer = m_drawBuffer.buffer;
+	bufferInfos[1].range = VK_WHOLE_SIZE;
+	bufferInfos[2].buffer = m_materialBuffer.buffer;
+	bufferInfos[2].range = VK_WHOLE_SIZE;
+
+	std::vector<VkWriteDescriptorSet> writes;
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		VkWriteDescriptorSet write = {};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = m_descriptorSet;
+		write.dstBinding = i;
+		write.descriptorCount = 1;
+		write.descriptorType = (i == 0) ?
+			VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		write.pBufferInfo = &bufferInfos[i];
+		writes.push_back(write);
+	}
+
+	std::vector<VkDescriptorImageInfo> imageInfos(m_textures.size());
+	for (size_t slot = 0; slot < m_textures.size(); slot++)
+	{
+		if (VK_NULL_HANDLE == m_textures[slot].view)
+		{
+			continue;
+		}
+		imageInfos[slot].imageView = m_textures[slot].view;
+		imageInfos[slot].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		VkWriteDescriptorSet write = {};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = m_descriptorSet;
+		write.dstBinding = 3;
+		write.dstArrayElement = (uint32_t)slot;
+		write.descriptorCount = 1;
+		write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+		write.pImageInfo = &imageInfos[slot];
+		writes.push_back(write);
+	}
+
+	std::vector<VkDescriptorImageInfo> samplerInfos(m_samplers.size());
+	for (size_t i = 0; i < m_samplers.size(); i++)
+	{
+		samplerInfos[i].sampler = m_samplers[i];
+	}
+	VkWriteDescriptorSet samplerWrite = {};
+	samplerWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	samplerWrite.dstSet = m_descriptorSet;
+	samplerWrite.dstBinding = 4;
+	samplerWrite.descriptorCount = (uint32_t)samplerInfos.size();
+	samplerWrite.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+	samplerWrite.pImageInfo = &samplerInfos[0];
+	writes.push_back(samplerWrite);
+
+	vkUpdateDescriptorSets(m_device, (uint32_t)writes.size(), &writes[0], 0, NULL);
+	m_recordedMeshes.clear();
+	m_bRecordStale = true;
+}
+
+/***********************************************************
+ *  ReserveDraws()
+ *
+ *  This method is used for growing the host visible buffers
+ *  of draws and materials when they are too small, doubling
+ *  them so that a growing scene rarely needs it.
+ ***********************************************************/
+bool VulkanRenderDevice::ReserveDraws(int drawCount, int materialCount)
+{
+	bool bResized = false;
+	if (drawCount > m_drawCapacity)
+	{
+		m_drawCapacity = std::max(drawCount, m_drawCapacity * 2);
+		DestroyBuffer(m_drawBuffer);
+		if (CreateBuffer(
+			sizeof(GPU_DRAW) * m_drawCapacity,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			m_drawBuffer) == false)
+		{
+			m_drawCapacity = 0;
+			return(false);
+		}
+		bResized = true;
+	}
+	if (materialCount > m_materialCapacity)
+	{
+		m_materialCapacity = std::max(materialCount, m_materialCapacity * 2);
+		DestroyBuffer(m_materialBuffer);
+		if (CreateBuffer(
+			sizeof(GPU_MATERIAL) * m_materialCapacity,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			m_materialBuffer) == false)
+		{
+			m_materialCapacity = 0;
+			return(false);
+		}
+		bResized = true;
+	}
+
+	if ((bResized == true) && (VK_NULL_HANDLE != m_frameBuffer.buffer))
+	{
+		UpdateDescriptors();
+	}
+	return(true);
+}
+
+/***********************************************************
+ *  GetName()
+ *
+ *  This method is used for getting the name of the backend.
+ ***********************************************************/
+const char* VulkanRenderDevice::GetName() const
+{
+	return("Vulkan");
+}
+
+/***********************************************************
+ *  LoadScene()
+ *
+ *  This method is used for uploading the basic shape meshes
+ *  into one vertex and index buffer, and the textures kept
+ *  in memory by the scene manager into the texture array.
+ ***********************************************************/
+bool VulkanRenderDevice::LoadScene(const SceneManager* pSceneManager)
+{
+	if ((m_bInitialized == false) || (NULL == pSceneManager))
+	{
+		return(false);
+	}
+
+	vkDeviceWaitIdle(m_device);
+	DestroyBuffer(m_vertexBuffer);
+	DestroyBuffer(m_indexBuffer);
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		DestroyImage(m_textures[i]);
+	}
+	// the secondary command buffers bind the old vertex and
+	// index buffers, so they are recorded again on the next frame
+	m_recordedMeshes.clear();
+	m_bRecordStale = true;
+
+	// every part is drawn with its own index range, and the
+	// indices are offset so one vertex buffer holds them all
+	std::vector<PrimitiveGeometry::MESH_VERTEX> vertices;
+	std::vector<unsigned int> indices;
+	for (int mesh = 0; mesh < SceneManager::MESH_TYPE_COUNT; mesh++)
+	{
+		for (int part = 0; part < PrimitiveGeometry::PART_INDEX_COUNT; part++)
+		{
+			const PrimitiveGeometry::MESH_DATA& data = m_geometry.GetMeshPart(
+				(SceneManager::MESH_TYPE)mesh,
+				(PrimitiveGeometry::PART_INDEX)part);
+
+			unsigned int baseVertex = (unsigned int)vertices.size();
+			m_meshRanges[mesh][part].firstIndex = (uint32_t)indices.size();
+			m_meshRanges[mesh][part].indexCount = (uint32_t)data.indices.size();
+			vertices.insert(vertices.end(), data.vertices.begin(), data.vertices.end());
+			for (size_t i = 0; i < data.indices.size(); i++)
+			{
+				indices.push_back(baseVertex + data.indices[i]);
+			}
+		}
+	}
+
+	if ((UploadBuffer(
+			&vertices[0],
+			sizeof(PrimitiveGeometry::MESH_VERTEX) * vertices.size(),
+			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+			m_vertexBuffer) == false) ||
+		(UploadBuffer(
+			&indices[0],
+			sizeof(unsigned int) * indices.size(),
+			VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+			m_indexBuffer) == false))
+	{
+		return(false);
+	}
+
+	int textureCount = 0;
+	for (int slot = 0; slot < g_TextureSlots; slot++)
+	{
+		const SceneManager::TEXTURE_IMAGE* pImage = pSceneManager->GetTextureImage(slot);
+		if (NULL == pImage)
+		{
+			continue;
+		}
+		if (CreateTexture(*pImage, m_textures[slot]) == false)
+		{
+			return(false);
+		}
+		textureCount++;
+	}
+
+	UpdateDescriptors();
+
+	std::cout << "Vulkan scene loaded: " << vertices.size() << " vertices, "
+		<< indices.size() / 3 << " triangles, " << textureCount << " textures" << std::endl;
+	return(true);
+}
+
+/***********************************************************
+ *  SetView()
+ *
+ *  This method is used for setting the view and projection
+ *  of the next frame, drawn into the whole image.
+ ***********************************************************/
+void VulkanRenderDevice::SetView(
+	const glm::mat4& view,
+	const glm::mat4& projection,
+	const glm::vec3& viewPosition)
+{
+	m_frame.views[0].view = view;
+	m_frame.views[0].projection = GetVulkanProjection(projection);
+	m_frame.views[0].viewPosition = glm::vec4(viewPosition, 1.0f);
+	m_frame.viewCount = 1;
+	m_viewRects.assign(1, glm::ivec4(0, 0, m_width, m_height));
+}
+
+/***********************************************************
+ *  SetViews()
+ *
+ *  This method is used for setting up to four cameras for
+ *  the next frames, each drawn into its own rectangle of the
+ *  image in the same pass.
+ ***********************************************************/
+void VulkanRenderDevice::SetViews(const std::vector<VIEWPORT_VIEW>& views)
+{
+	if (views.empty() == true)
+	{
+		return;
+	}
+
+	m_frame.viewCount = std::min((int)views.size(), g_MaxViews);
+	m_viewRects.resize(m_frame.viewCount);
+	for (int i = 0; i < m_frame.viewCount; i++)
+	{
+		m_frame.views[i].view = views[i].view;
+		m_frame.views[i].projection = GetVulkanProjection(views[i].projection);
+		m_frame.views[i].viewPosition = glm::vec4(views[i].viewPosition, 1.0f);
+		m_viewRects[i] = glm::ivec4(views[i].x, views[i].y, views[i].width, views[i].height);
+	}
+}
+
+/***********************************************************
+ *  SetLights()
+ *
+ *  This method is used for setting the light sources of the
+ *  next frame.
+ ***********************************************************/
+void VulkanRenderDevice::SetLights(const std::vector<SceneManager::LIGHT_SOURCE>& lights)
+{
+	m_frame.lightCount = std::min((int)lights.size(), g_MaxLights);
+	for (int i = 0; i < m_frame.lightCount; i++)
+	{
+		m_frame.lights[i].position = glm::vec4(lights[i].position, lights[i].specularIntensity);
+		m_frame.lights[i].ambientColor = glm::vec4(lights[i].ambientColor, 0.0f);
+		m_frame.lights[i].diffuseColor = glm::vec4(lights[i].diffuseColor, 0.0f);
+		m_frame.lights[i].specularColor = glm::vec4(lights[i].specularColor, lights[i].focalStrength);
+	}
+}
+
+/***********************************************************
+ *  RecordThread()
+ *
+ *  This method is used for recording one thread's share of
+ *  the draws into its secondary command buffer.  Every draw
+ *  has one instance per camera, starting at the draw index
+ *  times the camera count, which the shaders use to find the
+ *  values of the draw and the camera.
+ ***********************************************************/
+void VulkanRenderDevice::RecordThread(
+	RECORD_THREAD& thread,
+	const std::vector<SceneManager::DRAW_COMMAND>& draws)
+{
+	vkResetCommandPool(m_device, thread.commandPool, 0);
+
+	VkCommandBufferInheritanceInfo inheritanceInfo = {};
+	inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+	inheritanceInfo.renderPass = m_renderPass;
+	inheritanceInfo.subpass = 0;
+	inheritanceInfo.framebuffer = m_framebuffer;
+
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+	beginInfo.pInheritanceInfo = &inheritanceInfo;
+	vkBeginCommandBuffer(thread.commandBuffer, &beginInfo);
+
+	VkDeviceSize offset = 0;
+	vkCmdBindPipeline(thread.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+	vkCmdBindDescriptorSets(thread.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+		m_pipelineLayout, 0, 1, &m_descriptorSet, 0, NULL);
+	vkCmdBindVertexBuffers(thread.commandBuffer, 0, 1, &m_vertexBuffer.buffer, &offset);
+	vkCmdBindIndexBuffer(thread.commandBuffer, m_indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+
+	// the pipeline has a viewport for every camera it can
+	// draw, so the unused ones repeat the first
+	VkViewport viewports[g_MaxViews];
+	VkRect2D scissors[g_MaxViews];
+	for (int i = 0; i < g_MaxViews; i++)
+	{
+		const glm::ivec4& rect = m_viewRects[(i < (int)m_viewRects.size()) ? i : 0];
+		viewports[i].x = (float)rect.x;
+		viewports[i].y = (float)rect.y;
+		viewports[i].width = (float)rect.z;
+		viewports[i].height = (float)rect.w;
+		viewports[i].minDepth = 0.0f;
+		viewports[i].maxDepth = 1.0f;
+		scissors[i].offset.x = rect.x;
+		scissors[i].offset.y = rect.y;
+		scissors[i].extent.width = (uint32_t)rect.z;
+		scissors[i].extent.height = (uint32_t)rect.w;
+	}
+	vkCmdSetViewport(thread.commandBuffer, 0, g_MaxViews, viewports);
+	vkCmdSetScissor(thread.commandBuffer, 0, g_MaxViews, scissors);
+
+	uint32_t viewCount = (uint32_t)m_viewRects.size();
+	for (int i = thread.firstDraw; i < thread.lastDraw; i++)
+	{
+		const SceneManager::DRAW_COMMAND& draw = draws[i];
+		for (int part = 0; part < PrimitiveGeometry::PART_INDEX_COUNT; part++)
+		{
+			const MESH_RANGE& range = m_meshRanges[draw.mesh][part];
+			if ((range.indexCount > 0) &&
+				(PrimitiveGeometry::IsPartDrawn(draw.mesh, (PrimitiveGeometry::PART_INDEX)part, draw.parts) == true))
+			{
+				vkCmdDrawIndexed(thread.commandBuffer, range.indexCount, viewCount, range.firstIndex, 0, (uint32_t)i * viewCount);
+			}
+		}
+	}
+
+	vkEndCommandBuffer(thread.commandBuffer);
+}
+
+/***********************************************************
+ *  RecordDraws()
+ *
+ *  This method is used for splitting the draws into one
+ *  contiguous range per thread and recording the ranges in
+ *  parallel, so the secondary buffers run in draw order.
+ ***********************************************************/
+void VulkanRenderDevice::RecordDraws(const std::vector<SceneManager::DRAW_COMMAND>& draws)
+{
+	int threadCount = (int)m_recordThreads.size();
+	int drawCount = (int)draws.size();
+	for (int i = 0; i < threadCount; i++)
+	{
+		m_recordThreads[i].firstDraw = (int)((long long)drawCount * i / threadCount);
+		m_recordThreads[i].lastDraw = (int)((long long)drawCount * (i + 1) / threadCount);
+	}
+
+	std::vector<std::thread> workers;
+	for (int i = 1; i < threadCount; i++)
+	{
+		workers.push_back(std::thread(
+			&VulkanRenderDevice::RecordThread,
+			this,
+			std::ref(m_recordThreads[i]),
+			std::cref(draws)));
+	}
+	RecordThread(m_recordThreads[0], draws);
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+
+	// remember which meshes and parts were recorded, since the
+	// rest of each draw is read from the buffers every frame
+	m_recordedMeshes.resize(draws.size());
+	for (size_t i = 0; i < draws.size(); i++)
+	{
+		m_recordedMeshes[i] = ((unsigned int)draws[i].mesh << 8) | draws[i].parts;
+	}
+	m_recordedRects = m_viewRects;
+	m_bRecordStale = false;
+}
+
+/***********************************************************
+ *  SubmitDraws()
+ *
+ *  This method is used for rendering the draw list into the
+ *  offscreen image.  The values of every draw are written to
+ *  the mapped buffers, and the secondary command buffers are
+ *  only recorded again when the meshes they draw, the
+ *  rectangles of the cameras or the buffers they use change.
+ *  The frame is waited on so the image can be read back after.
+ ***********************************************************/
+void VulkanRenderDevice::SubmitDraws(
+	const std::vector<SceneManager::DRAW_COMMAND>& draws,
+	const std::vector<SceneManager::OBJECT_MATERIAL>& materials)
+{
+	if ((m_bInitialized == false) || (VK_NULL_HANDLE == m_vertexBuffer.buffer))
+	{
+		return;
+	}
+
+	double recordStart = GetMilliseconds();
+	if (ReserveDraws((int)draws.size(), (int)materials.size()) == false)
+	{
+		return;
+	}
+
+	memcpy(m_frameBuffer.pMapped, &m_frame, sizeof(GPU_FRAME));
+
+	GPU_MATERIAL* pMaterials = (GPU_MATERIAL*)m_materialBuffer.pMapped;
+	for (size_t i = 0; i < materials.size(); i++)
+	{
+		pMaterials[i].ambientColor = glm::vec4(materials[i].ambientColor, materials[i].ambientStrength);
+		pMaterials[i].diffuseColor = glm::vec4(materials[i].diffuseColor, 0.0f);
+		pMaterials[i].specularColor = glm::vec4(materials[i].specularColor, materials[i].shininess);
+	}
+
+	bool bChanged = ((m_bRecordStale == true) ||
+		(m_recordedMeshes.size() != draws.size()) ||
+		(m_recordedRects != m_viewRects));
+	GPU_DRAW* pDraws = (GPU_DRAW*)m_drawBuffer.pMapped;
+	for (size_t i = 0; i < draws.size(); i++)
+	{
+		const SceneManager::DRAW_COMMAND& draw = draws[i];
+		GPU_DRAW& gpuDraw = pDraws[i];
+		gpuDraw.model = draw.model;
+		gpuDraw.color = draw.color;
+		gpuDraw.uvScale = draw.uvScale;
+		gpuDraw.materialIndex = draw.materialIndex;
+		gpuDraw.textureIndex = -1;
+		gpuDraw.samplerIndex = draw.samplerFilter * TextureSamplers::WRAP_COUNT + draw.samplerWrap;
+		if ((draw.bUseTexture == true) &&
+			(draw.textureSlot >= 0) && (draw.textureSlot < g_TextureSlots) &&
+			(VK_NULL_HANDLE != m_textures[draw.textureSlot].view))
+		{
+			gpuDraw.textureIndex = draw.textureSlot;
+		}
+
+		if ((bChanged == false) &&
+			(m_recordedMeshes[i] != (((unsigned int)draw.mesh << 8) | draw.parts)))
+		{
+			bChanged = true;
+		}
+	}
+
+	m_stats.bRecorded = bChanged;
+	if (bChanged == true)
+	{
+		RecordDraws(draws);
+	}
+
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkResetCommandBuffer(m_primaryCommandBuffer, 0);
+	vkBeginCommandBuffer(m_primaryCommandBuffer, &beginInfo);
+
+	VkClearValue clearValues[2] = {};
+	clearValues[0].color.float32[3] = 1.0f;
+	clearValues[1].depthStencil.depth = 1.0f;
+	VkRenderPassBeginInfo renderPassInfo = {};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassInfo.renderPass = m_renderPass;
+	renderPassInfo.framebuffer = m_framebuffer;
+	renderPassInfo.renderArea.extent.width = m_width;
+	renderPassInfo.renderArea.extent.height = m_height;
+	renderPassInfo.clearValueCount = 2;
+	renderPassInfo.pClearValues = clearValues;
+	vkCmdBeginRenderPass(m_primaryCommandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+	std::vector<VkCommandBuffer> secondaries;
+	for (size_t i = 0; i < m_recordThreads.size(); i++)
+	{
+		if (m_recordThreads[i].lastDraw > m_recordThreads[i].firstDraw)
+		{
+			secondaries.push_back(m_recordThreads[i].commandBuffer);
+		}
+	}
+	if (secondaries.empty() == false)
+	{
+		vkCmdExecuteCommands(m_primaryCommandBuffer, (uint32_t)secondaries.size(), &secondaries[0]);
+	}
+	vkCmdEndRenderPass(m_primaryCommandBuffer);
+
+	VkBufferImageCopy region = {};
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.layerCount = 1;
+	region.imageExtent.width = m_width;
+	region.imageExtent.height = m_height;
+	region.imageExtent.depth = 1;
+	vkCmdCopyImageToBuffer(m_primaryCommandBuffer, m_colorTarget.image,
+		VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_readbackBuffer.buffer, 1, &region);
+
+	VkBufferMemoryBarrier readbackBarrier = {};
+	readbackBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	readbackBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	readbackBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	readbackBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	readbackBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	readbackBarrier.buffer = m_readbackBuffer.buffer;
+	readbackBarrier.size = VK_WHOLE_SIZE;
+	vkCmdPipelineBarrier(m_primaryCommandBuffer,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+		0, 0, NULL, 1, &readbackBarrier, 0, NULL);
+
+	vkEndCommandBuffer(m_primaryCommandBuffer);
+	double submitStart = GetMilliseconds();
+
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &m_primaryCommandBuffer;
+	if (vkQueueSubmit(m_queue, 1, &submitInfo, m_frameFence) != VK_SUCCESS)
+	{
+		std::cout << "ERROR: could not submit the Vulkan frame" << std::endl;
+		return;
+	}
+	vkWaitForFences(m_device, 1, &m_frameFence, VK_TRUE, UINT64_MAX);
+	vkResetFences(m_device, 1, &m_frameFence);
+
+	m_stats.recordMilliseconds = submitStart - recordStart;
+	m_stats.gpuMilliseconds = GetMilliseconds() - submitStart;
+	m_stats.draws = (int)draws.size();
+}
+
+/***********************************************************
+ *  GetFrameStats()
+ *
+ *  This method is used for getting the timing of the last
+ *  frame and whether its command buffers were recorded.
+ ***********************************************************/
+const VulkanRenderDevice::FRAME_STATS& VulkanRenderDevice::GetFrameStats() const
+{
+	return(m_stats);
+}
+
+/***********************************************************
+ *  SaveImage()
+ *
+ *  This method is used for writing the last rendered frame to
+ *  a binary PPM file.  The rows were rendered top first.
+ ***********************************************************/
+bool VulkanRenderDevice::SaveImage(const char* filename) const
+{
+	if (NULL == m_readbackBuffer.pMapped)
+	{
+		return(false);
+	}
+
+	FILE* pFile = fopen(filename, "wb");
+	if (NULL == pFile)
+	{
+		return(false);
+	}
+
+	fprintf(pFile, "P6\n%d %d\n255\n", m_width, m_height);
+
+	const unsigned char* pixels = (const unsigned char*)m_readbackBuffer.pMapped;
+	std::vector<unsigned char> row((size_t)m_width * 3);
+	bool bReturn = true;
+	for (int y = 0; (y < m_height) && bReturn; y++)
+	{
+		const unsigned char* source = &pixels[(size_t)y * m_width * 4];
+		for (int x = 0; x < m_width; x++)
+		{
+			row[x * 3] = source[x * 4];
+			row[x * 3 + 1] = source[x * 4 + 1];
+			row[x * 3 + 2] = source[x * 4 + 2];
+		}
+		bReturn = (fwrite(&row[0], 1, row.size(), pFile) == row.size());
+	}
+
+	fclose(pFile);
+	return(bReturn);
+}
+
+#endif
@@ -0,0 +1,269 @@
+///////////////////////////////////////////////////////////////////////////////
+// vulkanrenderdevice.h
+// ============
+// issue the scene draw list through Vulkan into an offscreen image
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// the Vulkan backend is only built when the Vulkan SDK is
+// available, by defining USE_VULKAN and linking vulkan-1
+#ifdef USE_VULKAN
+
+#include "RenderDevice.h"
+#include "PrimitiveGeometry.h"
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+
+/***********************************************************
+ *  VulkanRenderDevice
+ *
+ *  This class is the Vulkan backend of the render device.
+ *  It renders into an offscreen image, so it needs no window
+ *  and runs on CPU drivers such as lavapipe.  The values of
+ *  every draw live in a storage buffer that the shaders index
+ *  with the instance index, and the textures are one array
+ *  indexed per draw, so the draw commands themselves do not
+ *  change from frame to frame.  They are recorded into
+ *  secondary command buffers by several threads at once, and
+ *  the recordings are reused until the meshes drawn by the
+ *  draw list change.  Several cameras are drawn in the same
+ *  pass by instancing every draw once per camera, with the
+ *  vertex shader choosing the viewport of its camera.
+ *
+ *  The shaders are built from VulkanScene.vert and
+ *  VulkanScene.frag with the Vulkan SDK, for example
+ *  glslangValidator -V VulkanScene.vert -o VulkanScene.vert.spv
+ ***********************************************************/
+class VulkanRenderDevice : public RenderDevice
+{
+public:
+	// constructor
+	VulkanRenderDevice(int width, int height);
+	// destructor
+	~VulkanRenderDevice();
+
+	// properties for the timing of the last frame
+	struct FRAME_STATS
+	{
+		double recordMilliseconds;
+		double gpuMilliseconds;
+		int draws;
+		bool bRecorded;
+	};
+
+private:
+	// properties of one draw as read by the shaders
+	struct GPU_DRAW
+	{
+		glm::mat4 model;
+		glm::vec4 color;
+		glm::vec2 uvScale;
+		int textureIndex;
+		int materialIndex;
+		int samplerIndex;
+		int padding[3];
+	};
+
+	// properties of one material as read by the shaders, with
+	// the ambient strength and the shininess in the w values
+	struct GPU_MATERIAL
+	{
+		glm::vec4 ambientColor;
+		glm::vec4 diffuseColor;
+		glm::vec4 specularColor;
+	};
+
+	// properties of one light as read by the shaders, with the
+	// specular intensity and focal strength in the w values
+	struct GPU_LIGHT
+	{
+		glm::vec4 position;
+		glm::vec4 ambientColor;
+		glm::vec4 diffuseColor;
+		glm::vec4 specularColor;
+	};
+
+	// properties of one camera as read by the shaders
+	struct GPU_VIEW
+	{
+		glm::mat4 view;
+		glm::mat4 projection;
+		glm::vec4 viewPosition;
+	};
+
+	// properties shared by every draw of a frame
+	struct GPU_FRAME
+	{
+		GPU_VIEW views[4];
+		GPU_LIGHT lights[4];
+		int lightCount;
+		int viewCount;
+		int padding[2];
+	};
+
+	// properties for a buffer and its memory
+	struct GPU_BUFFER
+	{
+		VkBuffer buffer;
+		VkDeviceMemory memory;
+		VkDeviceSize size;
+		// host visible buffers stay mapped while they exist
+		void* pMapped;
+	};
+
+	// properties for an image, its memory and its view
+	struct GPU_IMAGE
+	{
+		VkImage image;
+		VkDeviceMemory memory;
+		VkImageView view;
+	};
+
+	// properties for the indices of one mesh part
+	struct MESH_RANGE
+	{
+		uint32_t firstIndex;
+		uint32_t indexCount;
+	};
+
+	// properties for one thread that records draws
+	struct RECORD_THREAD
+	{
+		VkCommandPool commandPool;
+		VkCommandBuffer commandBuffer;
+		int firstDraw;
+		int lastDraw;
+	};
+
+	// width and height of the rendered image
+	int m_width;
+	int m_height;
+	bool m_bInitialized;
+
+	VkInstance m_instance;
+	VkPhysicalDevice m_physicalDevice;
+	VkDevice m_device;
+	VkQueue m_queue;
+	uint32_t m_queueFamily;
+	VkPhysicalDeviceMemoryProperties m_memoryProperties;
+	float m_maxAnisotropy;
+
+	// offscreen targets and the buffer the image is copied to
+	GPU_IMAGE m_colorTarget;
+	GPU_IMAGE m_depthTarget;
+	GPU_BUFFER m_readbackBuffer;
+	VkRenderPass m_renderPass;
+	VkFramebuffer m_framebuffer;
+
+	VkDescriptorSetLayout m_descriptorSetLayout;
+	VkDescriptorPool m_descriptorPool;
+	VkDescriptorSet m_descriptorSet;
+	VkPipelineLayout m_pipelineLayout;
+	VkPipeline m_pipeline;
+
+	VkCommandPool m_commandPool;
+	VkCommandBuffer m_primaryCommandBuffer;
+	VkFence m_frameFence;
+
+	// one vertex and index buffer holds every mesh part
+	PrimitiveGeometry m_geometry;
+	GPU_BUFFER m_vertexBuffer;
+	GPU_BUFFER m_indexBuffer;
+	MESH_RANGE m_meshRanges[SceneManager::MESH_TYPE_COUNT][PrimitiveGeometry::PART_INDEX_COUNT];
+
+	// values read by the shaders
+	GPU_BUFFER m_frameBuffer;
+	GPU_BUFFER m_drawBuffer;
+	GPU_BUFFER m_materialBuffer;
+	int m_drawCapacity;
+	int m_materialCapacity;
+	GPU_FRAME m_frame;
+	// rectangles of the cameras, as x, y, width and height
+	std::vector<glm::ivec4> m_viewRects;
+	std::vector<GPU_IMAGE> m_textures;
+	std::vector<VkSampler> m_samplers;
+
+	// secondary command buffers and the draws they were made for
+	std::vector<RECORD_THREAD> m_recordThreads;
+	std::vector<unsigned int> m_recordedMeshes;
+	std::vector<glm::ivec4> m_recordedRects;
+	// set when the buffers or descriptors the secondary command
+	// buffers were recorded with have been replaced
+	bool m_bRecordStale;
+	FRAME_STATS m_stats;
+
+	// create the Vulkan objects
+	bool CreateInstance();
+	bool CreateDevice();
+	bool CreateTargets();
+	bool CreatePipeline();
+	bool CreateSamplers();
+	bool CreateShaderModule(const char* filename, VkShaderModule& shaderModule);
+
+	// create and free buffers and images
+	bool FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties, uint32_t& memoryType);
+	bool CreateBuffer(
+		VkDeviceSize size,
+		VkBufferUsageFlags usage,
+		VkMemoryPropertyFlags properties,
+		GPU_BUFFER& buffer);
+	void DestroyBuffer(GPU_BUFFER& buffer);
+	bool CreateImage(
+		uint32_t width,
+		uint32_t height,
+		uint32_t mipLevels,
+		VkFormat format,
+		VkImageUsageFlags usage,
+		VkImageAspectFlags aspect,
+		GPU_IMAGE& image);
+	void DestroyImage(GPU_IMAGE& image);
+	// fill a device local buffer through a staging buffer
+	bool UploadBuffer(
+		const void* data,
+		VkDeviceSize size,
+		VkBufferUsageFlags usage,
+		GPU_BUFFER& buffer);
+	// create a mipmapped texture from the scene pixels
+	bool CreateTexture(const SceneManager::TEXTURE_IMAGE& source, GPU_IMAGE& texture);
+	// run one batch of commands and wait for it
+	VkCommandBuffer BeginOneTimeCommands();
+	bool EndOneTimeCommands(VkCommandBuffer commandBuffer);
+
+	// point the descriptors at the current buffers and textures
+	void UpdateDescriptors();
+	// make room for more draws or materials
+	bool ReserveDraws(int drawCount, int materialCount);
+	// record the draw commands into the secondary buffers
+	void RecordDraws(const std::vector<SceneManager::DRAW_COMMAND>& draws);
+	void RecordThread(RECORD_THREAD& thread, const std::vector<SceneManager::DRAW_COMMAND>& draws);
+
+public:
+	// create the device, targets and pipeline
+	bool Initialize();
+
+	// RenderDevice methods
+	const char* GetName() const;
+	bool LoadScene(const SceneManager* pSceneManager);
+	void SetView(
+		const glm::mat4& view,
+		const glm::mat4& projection,
+		const glm::vec3& viewPosition);
+	void SetViews(const std::vector<VIEWPORT_VIEW>& views);
+	void SetLights(const std::vector<SceneManager::LIGHT_SOURCE>& lights);
+	void SubmitDraws(
+		const std::vector<SceneManager::DRAW_COMMAND>& draws,
+		const std::vector<SceneManager::OBJECT_MATERIAL>& materials);
+
+	// get the timing of the last frame
+	const FRAME_STATS& GetFrameStats() const;
+	// write the last rendered frame to a binary PPM file
+	bool SaveImage(const char* filename) const;
+};
+
+#endif
@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////////////////////////////////
+// vulkanscene.frag
+// ============
+// fragment shader of the Vulkan render device
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+struct LightSource
+{
+	vec4 position;
+	vec4 ambientColor;
+	vec4 diffuseColor;
+	vec4 specularColor;
+};
+
+struct ViewData
+{
+	mat4 view;
+	mat4 projection;
+	vec4 viewPosition;
+};
+
+struct DrawData
+{
+	mat4 model;
+	vec4 color;
+	vec2 uvScale;
+	int textureIndex;
+	int materialIndex;
+	int samplerIndex;
+};
+
+// the ambient strength and shininess are kept in the w values
+struct Material
+{
+	vec4 ambientColor;
+	vec4 diffuseColor;
+	vec4 specularColor;
+};
+
+layout(set = 0, binding = 0) uniform FrameData
+{
+	ViewData views[4];
+	LightSource lightSources[4];
+	int lightCount;
+	int viewCount;
+} frame;
+
+layout(std430, set = 0, binding = 1) readonly buffer DrawBuffer
+{
+	DrawData draws[];
+};
+
+layout(std430, set = 0, binding = 2) readonly buffer MaterialBuffer
+{
+	Material materials[];
+};
+
+// only the slots holding loaded textures are written
+layout(set = 0, binding = 3) uniform texture2D textures[];
+layout(set = 0, binding = 4) uniform sampler samplers[];
+
+layout(location = 0) in vec3 fragmentPosition;
+layout(location = 1) in vec3 fragmentNormal;
+layout(location = 2) in vec2 fragmentTextureCoordinate;
+layout(location = 3) flat in int drawIndex;
+layout(location = 4) flat in int viewIndex;
+
+layout(location = 0) out vec4 outFragmentColor;
+
+void main()
+{
+	DrawData draw = draws[drawIndex];
+
+	vec3 baseColor = draw.color.rgb;
+	float alpha = draw.color.a;
+	if (draw.textureIndex >= 0)
+	{
+		baseColor = texture(sampler2D(
+			textures[nonuniformEXT(draw.textureIndex)],
+			samplers[nonuniformEXT(draw.samplerIndex)]),
+			fragmentTextureCoordinate).rgb;
+		alpha = 1.0;
+	}
+
+	// unset materials are black, as in the OpenGL shaders
+	Material material = Material(vec4(0.0), vec4(0.0), vec4(0.0));
+	if (draw.materialIndex >= 0)
+	{
+		material = materials[draw.materialIndex];
+	}
+
+	vec3 normal = normalize(fragmentNormal);
+	vec3 viewDirection = normalize(frame.views[viewIndex].viewPosition.xyz - fragmentPosition);
+	vec3 phong = vec3(0.0);
+	for (int i = 0; i < frame.lightCount; i++)
+	{
+		LightSource light = frame.lightSources[i];
+
+		vec3 ambient = light.ambientColor.rgb * material.ambientColor.rgb * material.ambientColor.w;
+
+		vec3 lightDirection = normalize(light.position.xyz - fragmentPosition);
+		float impact = max(dot(normal, lightDirection), 0.0);
+		vec3 diffuse = light.diffuseColor.rgb * material.diffuseColor.rgb * impact;
+
+		vec3 reflectDirection = reflect(-lightDirection, normal);
+		float specularComponent = pow(max(dot(viewDirection, reflectDirection), 0.0), light.specularColor.w);
+		vec3 specular = light.specularColor.rgb * material.specularColor.rgb *
+			(light.position.w * specularComponent);
+
+		phong += ambient + diffuse + specular;
+	}
+
+	outFragmentColor = vec4(phong * baseColor, alpha);
+}
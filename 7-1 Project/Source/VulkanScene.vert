@@ -0,0 +1,77 @@
+///////////////////////////////////////////////////////////////////////////////
+// vulkanscene.vert
+// ============
+// vertex shader of the Vulkan render device
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#version 450
+#extension GL_ARB_shader_viewport_layer_array : require
+
+struct LightSource
+{
+	vec4 position;
+	vec4 ambientColor;
+	vec4 diffuseColor;
+	vec4 specularColor;
+};
+
+struct ViewData
+{
+	mat4 view;
+	mat4 projection;
+	vec4 viewPosition;
+};
+
+struct DrawData
+{
+	mat4 model;
+	vec4 color;
+	vec2 uvScale;
+	int textureIndex;
+	int materialIndex;
+	int samplerIndex;
+};
+
+layout(set = 0, binding = 0) uniform FrameData
+{
+	ViewData views[4];
+	LightSource lightSources[4];
+	int lightCount;
+	int viewCount;
+} frame;
+
+// firstInstance of each draw is its index in this buffer
+// times the view count, with one instance for every view
+layout(std430, set = 0, binding = 1) readonly buffer DrawBuffer
+{
+	DrawData draws[];
+};
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inTextureCoordinate;
+
+layout(location = 0) out vec3 fragmentPosition;
+layout(location = 1) out vec3 fragmentNormal;
+layout(location = 2) out vec2 fragmentTextureCoordinate;
+layout(location = 3) flat out int drawIndex;
+layout(location = 4) flat out int viewIndex;
+
+void main()
+{
+	drawIndex = gl_InstanceIndex / frame.viewCount;
+	viewIndex = gl_InstanceIndex % frame.viewCount;
+	DrawData draw = draws[drawIndex];
+	ViewData view = frame.views[viewIndex];
+
+	vec4 worldPosition = draw.model * vec4(inPosition, 1.0);
+	fragmentPosition = worldPosition.xyz;
+	fragmentNormal = mat3(transpose(inverse(draw.model))) * inNormal;
+	fragmentTextureCoordinate = inTextureCoordinate * draw.uvScale;
+
+	gl_Position = view.projection * view.view * worldPosition;
+	gl_ViewportIndex = viewIndex;
+}
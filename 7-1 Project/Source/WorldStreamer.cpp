@@ -0,0 +1,657 @@
+///////////////////////////////////////////////////////////////////////////////
+// worldstreamer.cpp
+// ============
+// stream the cells of a grid world in and out around the camera
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#include "WorldStreamer.h"
+#include "SceneEntities.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// declaration of global variables and defines
+namespace
+{
+	// first bytes of the world file and of every cell file
+	const char g_WorldMagic[4] = { 'W', 'R', 'L', 'D' };
+	const char g_CellMagic[4] = { 'W', 'C', 'E', 'L' };
+	// longest prefab name stored in the world file
+	const int g_PrefabNameLength = 32;
+
+	// properties stored at the start of the world file, which
+	// is followed by the prefab names
+	struct WORLD_HEADER
+	{
+		char magic[4];
+		int columns;
+		int rows;
+		float cellSize;
+		int prefabCount;
+	};
+
+	// properties stored at the start of a cell file, which is
+	// followed by its placements
+	struct CELL_HEADER
+	{
+		char magic[4];
+		int column;
+		int row;
+		int instanceCount;
+	};
+
+	// properties stored for one placement of a cell file
+	struct CELL_RECORD
+	{
+		int prefab;
+		float position[3];
+		float yawDegrees;
+		float scale;
+	};
+
+	// get the time from a steady clock in milliseconds
+	double GetMilliseconds()
+	{
+		return(std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// get the name of the world file in a directory
+	std::string GetWorldPath(const std::string& directory)
+	{
+		return(directory + "/world.bin");
+	}
+}
+
+/***********************************************************
+ *  WorldStreamer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+WorldStreamer::WorldStreamer()
+{
+	m_settings.loadRadius = 2;
+	m_settings.loaderThreads = 2;
+	m_settings.uploadMilliseconds = 2.0;
+	m_columns = 0;
+	m_rows = 0;
+	m_cellSize = 0.0f;
+	m_origin = glm::vec2(0.0f, 0.0f);
+	m_loadingCells = 0;
+	m_bStopping = false;
+
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+/***********************************************************
+ *  ~WorldStreamer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+WorldStreamer::~WorldStreamer()
+{
+	Close(NULL);
+}
+
+/***********************************************************
+ *  Open()
+ *
+ *  This method is used for opening the world in a directory.
+ *  The prefab names of the world file are looked up in the
+ *  entities once, so the cells only hold indexes, and the
+ *  loader threads are started with nothing queued yet.
+ ***********************************************************/
+bool WorldStreamer::Open(const WORLD_SETTINGS& settings, const SceneEntities* pEntities)
+{
+	Close(NULL);
+
+	if (NULL == pEntities)
+	{
+		return(false);
+	}
+
+	std::string worldPath = GetWorldPath(settings.directory);
+	FILE* pFile = fopen(worldPath.c_str(), "rb");
+	if (NULL == pFile)
+	{
+		std::cout << "ERROR: could not open world file " << worldPath << std::endl;
+		return(false);
+	}
+
+	WORLD_HEADER header;
+	bool bReturn = (fread(&header, sizeof(header), 1, pFile) == 1) &&
+		(memcmp(header.magic, g_WorldMagic, sizeof(g_WorldMagic)) == 0) &&
+		(header.columns > 0) && (header.rows > 0) &&
+		(header.cellSize > 0.0f) && (header.prefabCount >= 0);
+
+	m_prefabs.clear();
+	for (int i = 0; (bReturn == true) && (i < header.prefabCount); i++)
+	{
+		char name[g_PrefabNameLength + 1] = { 0 };
+		bReturn = (fread(name, g_PrefabNameLength, 1, pFile) == 1);
+		if (bReturn == true)
+		{
+			m_prefabs.push_back(pEntities->FindPrefab(name));
+			if (m_prefabs.back() < 0)
+			{
+				std::cout << "No scene prefab named:" << name << std::endl;
+			}
+		}
+	}
+	fclose(pFile);
+
+	if (bReturn == false)
+	{
+		std::cout << "ERROR: " << worldPath << " is not a world file" << std::endl;
+		m_prefabs.clear();
+		return(false);
+	}
+
+	m_settings = settings;
+	m_settings.loadRadius = std::max(settings.loadRadius, 0);
+	m_columns = header.columns;
+	m_rows = header.rows;
+	m_cellSize = header.cellSize;
+	m_origin = glm::vec2(-0.5f * m_columns * m_cellSize, -0.5f * m_rows * m_cellSize);
+	m_cellStates.assign((size_t)m_columns * m_rows, CELL_UNLOADED);
+	m_cellEntities.assign((size_t)m_columns * m_rows, std::vector<uint32_t>());
+	m_bStopping = false;
+	memset(&m_stats, 0, sizeof(m_stats));
+
+	int loaderThreads = settings.loaderThreads;
+	if (loaderThreads <= 0)
+	{
+		loaderThreads = 2;
+	}
+	for (int i = 0; i < loaderThreads; i++)
+	{
+		m_workers.push_back(std::thread(&WorldStreamer::LoadCells, this));
+	}
+
+	std::cout << "INFO: streaming a " << m_columns << "x" << m_rows << " world of "
+		<< m_cellSize << " unit cells from " << settings.directory << std::endl;
+	return(true);
+}
+
+/***********************************************************
+ *  Close()
+ *
+ *  This method is used for stopping the loader threads,
+ *  dropping the cells they have not read yet, and removing
+ *  the entities of the placed cells when the entities are
+ *  passed in.
+ ***********************************************************/
+void WorldStreamer::Close(SceneEntities* pEntities)
+{
+	if (m_workers.empty() == false)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_bStopping = true;
+			m_loadQueue.clear();
+		}
+		m_workReady.notify_all();
+
+		for (size_t i = 0; i < m_workers.size(); i++)
+		{
+			m_workers[i].join();
+		}
+		m_workers.clear();
+	}
+
+	if (NULL != pEntities)
+	{
+		for (size_t cell = 0; cell < m_cellStates.size(); cell++)
+		{
+			if (m_cellStates[cell] == CELL_RESIDENT)
+			{
+				UnloadCell((int)cell, pEntities);
+			}
+		}
+	}
+
+	m_loadedCells.clear();
+	m_loadingCells = 0;
+	m_cellStates.clear();
+	m_cellEntities.clear();
+	m_prefabs.clear();
+	m_columns = 0;
+	m_rows = 0;
+}
+
+/***********************************************************
+ *  IsOpen()
+ *
+ *  This method is used for checking whether a world is open.
+ ***********************************************************/
+bool WorldStreamer::IsOpen() const
+{
+	return(m_workers.empty() == false);
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used once a frame for streaming the world
+ *  around the camera.  Cells more than one past the load
+ *  radius are removed, so a camera moving back and forth
+ *  over a cell edge does not keep loading the same cells,
+ *  and the missing cells in range are queued nearest first.
+ *  Finished cells are then placed until the time budget is
+ *  used up, unless every queued cell is waited for, such as
+ *  for a still image.
+ ***********************************************************/
+bool WorldStreamer::Update(const glm::vec3& cameraPosition, SceneEntities* pEntities, bool bFinishLoads)
+{
+	if ((IsOpen() == false) || (NULL == pEntities))
+	{
+		return(false);
+	}
+
+	bool bChanged = false;
+	int cameraColumn = (int)std::floor((cameraPosition.x - m_origin.x) / m_cellSize);
+	int cameraRow = (int)std::floor((cameraPosition.z - m_origin.y) / m_cellSize);
+	int keepRadius = m_settings.loadRadius + 1;
+
+	// remove the cells out of range, and take back those still
+	// waiting for a loader thread
+	std::vector<int> cancelledCells;
+	for (size_t cell = 0; cell < m_cellStates.size(); cell++)
+	{
+		if (GetCellDistance((int)cell, cameraColumn, cameraRow) <= keepRadius)
+		{
+			continue;
+		}
+		if (m_cellStates[cell] == CELL_RESIDENT)
+		{
+			UnloadCell((int)cell, pEntities);
+			bChanged = true;
+		}
+		else if (m_cellStates[cell] == CELL_QUEUED)
+		{
+			m_cellStates[cell] = CELL_UNLOADED;
+			cancelledCells.push_back((int)cell);
+		}
+	}
+
+	// find the cells in range that are not loaded, nearest first
+	std::vector<std::pair<int, int> > requests;
+	int firstColumn = std::max(cameraColumn - m_settings.loadRadius, 0);
+	int lastColumn = std::min(cameraColumn + m_settings.loadRadius, m_columns - 1);
+	int firstRow = std::max(cameraRow - m_settings.loadRadius, 0);
+	int lastRow = std::min(cameraRow + m_settings.loadRadius, m_rows - 1);
+	for (int row = firstRow; row <= lastRow; row++)
+	{
+		for (int column = firstColumn; column <= lastColumn; column++)
+		{
+			int cell = row * m_columns + column;
+			if (m_cellStates[cell] == CELL_UNLOADED)
+			{
+				m_cellStates[cell] = CELL_QUEUED;
+				requests.push_back(std::make_pair(GetCellDistance(cell, cameraColumn, cameraRow), cell));
+			}
+		}
+	}
+	std::sort(requests.begin(), requests.end());
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (size_t i = 0; i < cancelledCells.size(); i++)
+		{
+			std::deque<int>::iterator queued = std::find(m_loadQueue.begin(), m_loadQueue.end(), cancelledCells[i]);
+			if (queued != m_loadQueue.end())
+			{
+				m_loadQueue.erase(queued);
+			}
+		}
+		for (size_t i = 0; i < requests.size(); i++)
+		{
+			m_loadQueue.push_back(requests[i].second);
+		}
+	}
+	if (requests.empty() == false)
+	{
+		m_workReady.notify_all();
+	}
+
+	// place the finished cells, at least one a frame so the
+	// world always fills in
+	double start = GetMilliseconds();
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (bFinishLoads == true)
+	{
+		m_cellsReady.wait(lock, [this]() { return((m_loadQueue.empty() == true) && (m_loadingCells == 0)); });
+	}
+	int placedCells = 0;
+	while (m_loadedCells.empty() == false)
+	{
+		if ((bFinishLoads == false) && (placedCells > 0) &&
+			(GetMilliseconds() - start >= m_settings.uploadMilliseconds))
+		{
+			break;
+		}
+
+		LOADED_CELL loaded = std::move(m_loadedCells.front());
+		m_loadedCells.pop_front();
+		lock.unlock();
+
+		// a cell taken back while it was being read is dropped
+		if (m_cellStates[loaded.cell] == CELL_QUEUED)
+		{
+			if (loaded.bLoaded == true)
+			{
+				UploadCell(loaded, pEntities);
+				placedCells++;
+				bChanged = true;
+			}
+			else
+			{
+				m_cellStates[loaded.cell] = CELL_MISSING;
+				m_stats.failedCells++;
+			}
+		}
+		lock.lock();
+	}
+
+	m_stats.queuedCells = (int)m_loadQueue.size() + m_loadingCells + (int)m_loadedCells.size();
+	m_stats.uploadMilliseconds = GetMilliseconds() - start;
+	return(bChanged);
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the state of the
+ *  streaming after the last update.
+ ***********************************************************/
+WorldStreamer::STREAMING_STATS WorldStreamer::GetStats()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return(m_stats);
+}
+
+/***********************************************************
+ *  LoadCells()
+ *
+ *  This method is used by each loader thread for reading the
+ *  oldest queued cell and handing it back to the main thread,
+ *  until the streamer is stopped.
+ ***********************************************************/
+void WorldStreamer::LoadCells()
+{
+	while (true)
+	{
+		LOADED_CELL loaded;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_workReady.wait(lock, [this]() { return((m_loadQueue.empty() == false) || (m_bStopping == true)); });
+			if (m_bStopping == true)
+			{
+				return;
+			}
+			loaded.cell = m_loadQueue.front();
+			m_loadQueue.pop_front();
+			m_loadingCells++;
+		}
+
+		int column = loaded.cell % m_columns;
+		int row = loaded.cell / m_columns;
+		loaded.bLoaded = ReadCell(GetCellPath(m_settings.directory, column, row), column, row, loaded.instances);
+
+		// placements of prefabs the scene does not have are
+		// dropped here, off the main thread
+		size_t kept = 0;
+		for (size_t i = 0; i < loaded.instances.size(); i++)
+		{
+			int prefab = loaded.instances[i].prefab;
+			if ((prefab >= 0) && (prefab < (int)m_prefabs.size()) && (m_prefabs[prefab] >= 0))
+			{
+				loaded.instances[kept] = loaded.instances[i];
+				loaded.instances[kept].prefab = m_prefabs[prefab];
+				kept++;
+			}
+		}
+		loaded.instances.resize(kept);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_loadedCells.push_back(std::move(loaded));
+			m_loadingCells--;
+		}
+		m_cellsReady.notify_all();
+	}
+}
+
+/***********************************************************
+ *  UploadCell()
+ *
+ *  This method is used for placing a prefab instance for
+ *  every placement of a cell and keeping their handles, so
+ *  the cell can be removed again.
+ ***********************************************************/
+void WorldStreamer::UploadCell(const LOADED_CELL& loaded, SceneEntities* pEntities)
+{
+	std::vector<uint32_t>& entities = m_cellEntities[loaded.cell];
+	entities.reserve(loaded.instances.size());
+
+	SceneEntities::PREFAB_INSTANCE instance;
+	instance.materialOverride = -1;
+	instance.bColorOverride = false;
+	instance.colorOverride = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+	for (size_t i = 0; i < loaded.instances.size(); i++)
+	{
+		const CELL_INSTANCE& placement = loaded.instances[i];
+		instance.position = placement.position;
+		instance.rotation = glm::vec3(0.0f, placement.yawDegrees, 0.0f);
+		instance.scale = glm::vec3(placement.scale);
+
+		SceneEntities::ENTITY_ID entity = pEntities->InstantiatePrefab(placement.prefab, instance);
+		if (entity != SceneEntities::INVALID_ENTITY)
+		{
+			entities.push_back(entity);
+		}
+	}
+
+	m_cellStates[loaded.cell] = CELL_RESIDENT;
+	m_stats.loadedCells++;
+	m_stats.residentCells++;
+	m_stats.residentEntities += (int)entities.size();
+	m_stats.peakResidentCells = std::max(m_stats.peakResidentCells, m_stats.residentCells);
+	m_stats.peakResidentEntities = std::max(m_stats.peakResidentEntities, m_stats.residentEntities);
+}
+
+/***********************************************************
+ *  UnloadCell()
+ *
+ *  This method is used for destroying the entities of a
+ *  cell and freeing the memory of its handles.
+ ***********************************************************/
+void WorldStreamer::UnloadCell(int cell, SceneEntities* pEntities)
+{
+	std::vector<uint32_t>& entities = m_cellEntities[cell];
+	for (size_t i = 0; i < entities.size(); i++)
+	{
+		pEntities->DestroyEntity(entities[i]);
+	}
+
+	m_stats.residentCells--;
+	m_stats.residentEntities -= (int)entities.size();
+	m_stats.unloadedCells++;
+	std::vector<uint32_t>().swap(entities);
+	m_cellStates[cell] = CELL_UNLOADED;
+}
+
+/***********************************************************
+ *  GetCellDistance()
+ *
+ *  This method is used for getting how many cells away from
+ *  the camera cell a cell is, along the farther axis.
+ ***********************************************************/
+int WorldStreamer::GetCellDistance(int cell, int cameraColumn, int cameraRow) const
+{
+	int column = cell % m_columns;
+	int row = cell / m_columns;
+	return(std::max(std::abs(column - cameraColumn), std::abs(row - cameraRow)));
+}
+
+/***********************************************************
+ *  WriteWorld()
+ *
+ *  This method is used for writing the world file of a
+ *  directory, which names the size of the grid and the
+ *  prefabs its cells place.
+ ***********************************************************/
+bool WorldStreamer::WriteWorld(const char* directory, int columns, int rows, float cellSize, const std::vector<std::string>& prefabNames)
+{
+#ifdef _WIN32
+	_mkdir(directory);
+#else
+	mkdir(directory, 0755);
+#endif
+
+	std::string worldPath = GetWorldPath(directory);
+	FILE* pFile = fopen(worldPath.c_str(), "wb");
+	if (NULL == pFile)
+	{
+		return(false);
+	}
+
+	WORLD_HEADER header;
+	memcpy(header.magic, g_WorldMagic, sizeof(g_WorldMagic));
+	header.columns = columns;
+	header.rows = rows;
+	header.cellSize = cellSize;
+	header.prefabCount = (int)prefabNames.size();
+
+	bool bReturn = (fwrite(&header, sizeof(header), 1, pFile) == 1);
+	for (size_t i = 0; (bReturn == true) && (i < prefabNames.size()); i++)
+	{
+		char name[g_PrefabNameLength] = { 0 };
+		strncpy(name, prefabNames[i].c_str(), g_PrefabNameLength - 1);
+		bReturn = (fwrite(name, g_PrefabNameLength, 1, pFile) == 1);
+	}
+	bReturn = (fclose(pFile) == 0) && bReturn;
+	return(bReturn);
+}
+
+/***********************************************************
+ *  WriteCell()
+ *
+ *  This method is used for writing the placements of one
+ *  cell to its own file.
+ ***********************************************************/
+bool WorldStreamer::WriteCell(const char* directory, int column, int row, const std::vector<CELL_INSTANCE>& instances)
+{
+	std::string cellPath = GetCellPath(directory, column, row);
+	FILE* pFile = fopen(cellPath.c_str(), "wb");
+	if (NULL == pFile)
+	{
+		return(false);
+	}
+
+	CELL_HEADER header;
+	memcpy(header.magic, g_CellMagic, sizeof(g_CellMagic));
+	header.column = column;
+	header.row = row;
+	header.instanceCount = (int)instances.size();
+
+	std::vector<CELL_RECORD> records(instances.size());
+	for (size_t i = 0; i < instances.size(); i++)
+	{
+		records[i].prefab = instances[i].prefab;
+		records[i].position[0] = instances[i].position.x;
+		records[i].position[1] = instances[i].position.y;
+		records[i].position[2] = instances[i].position.z;
+		records[i].yawDegrees = instances[i].yawDegrees;
+		records[i].scale = instances[i].scale;
+	}
+
+	bool bReturn = (fwrite(&header, sizeof(header), 1, pFile) == 1) &&
+		((records.empty() == true) ||
+		(fwrite(&records[0], sizeof(CELL_RECORD), records.size(), pFile) == records.size()));
+	bReturn = (fclose(pFile) == 0) && bReturn;
+	return(bReturn);
+}
+
+/***********************************************************
+ *  ReadCell()
+ *
+ *  This method is used for reading the placements of one
+ *  cell, checking that the file belongs to that cell.
+ ***********************************************************/
+bool WorldStreamer::ReadCell(const std::string& filename, int column, int row, std::vector<CELL_INSTANCE>& instances)
+{
+	instances.clear();
+
+	FILE* pFile = fopen(filename.c_str(), "rb");
+	if (NULL == pFile)
+	{
+		return(false);
+	}
+
+	CELL_HEADER header;
+	bool bReturn = (fread(&header, sizeof(header), 1, pFile) == 1) &&
+		(memcmp(header.magic, g_CellMagic, sizeof(g_CellMagic)) == 0) &&
+		(header.column == column) && (header.row == row) && (header.instanceCount >= 0);
+
+	if ((bReturn == true) && (header.instanceCount > 0))
+	{
+		std::vector<CELL_RECORD> records(header.instanceCount);
+		bReturn = (fread(&records[0], sizeof(CELL_RECORD), records.size(), pFile) == records.size());
+		if (bReturn == true)
+		{
+			instances.resize(records.size());
+			for (size_t i = 0; i < records.size(); i++)
+			{
+				instances[i].prefab = records[i].prefab;
+				instances[i].position = glm::vec3(records[i].position[0], records[i].position[1], records[i].position[2]);
+				instances[i].yawDegrees = records[i].yawDegrees;
+				instances[i].scale = records[i].scale;
+			}
+		}
+	}
+
+	fclose(pFile);
+	return(bReturn);
+}
+
+/***********************************************************
+ *  GetCellPath()
+ *
+ *  This method is used for getting the file name of a cell
+ *  from its column and row.
+ ***********************************************************/
+std::string WorldStreamer::GetCellPath(const std::string& directory, int column, int row)
+{
+	char name[64];
+	snprintf(name, sizeof(name), "/cell_%d_%d.bin", column, row);
+	return(directory + name);
+}
+
+/***********************************************************
+ *  GetCellCenter()
+ *
+ *  This method is used for getting the center of a cell on
+ *  the floor of a grid centered on the origin, with columns
+ *  along X and rows along Z.
+ ***********************************************************/
+glm::vec3 WorldStreamer::GetCellCenter(int columns, int rows, float cellSize, int column, int row)
+{
+	return(glm::vec3(
+		(column + 0.5f - 0.5f * columns) * cellSize,
+		0.0f,
+		(row + 0.5f - 0.5f * rows) * cellSize));
+}
@@ -0,0 +1,165 @@
+///////////////////////////////////////////////////////////////////////////////
+// worldstreamer.h
+// ============
+// stream the cells of a grid world in and out around the camera
+//
+//  AUTHOR: Barbara Kendall
+//	Created for CS-330-Computational Graphics and Visualization, October 18 2026
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class SceneEntities;
+
+/***********************************************************
+ *  WorldStreamer
+ *
+ *  This class keeps only the part of a large world near the
+ *  camera in the scene entities.  The world is a grid of
+ *  square cells, each stored in its own binary file of
+ *  prefab placements.  Cells coming into range are read on
+ *  background threads, and the main thread places the
+ *  entities of a few finished cells per frame within a time
+ *  budget, so frames stay smooth while the camera moves.
+ *  Cells that fall out of range are removed again, so the
+ *  memory used depends on the load radius and not on the
+ *  size of the world.
+ ***********************************************************/
+class WorldStreamer
+{
+public:
+	// constructor
+	WorldStreamer();
+	// destructor
+	~WorldStreamer();
+
+	// properties for one prefab placed in a cell, where the
+	// prefab is an index into the names of the world file
+	struct CELL_INSTANCE
+	{
+		int prefab;
+		glm::vec3 position;
+		float yawDegrees;
+		float scale;
+	};
+
+	// properties for streaming a world
+	struct WORLD_SETTINGS
+	{
+		// directory holding the world file and the cell files
+		std::string directory;
+		// cells kept in range on every side of the camera cell
+		int loadRadius;
+		int loaderThreads;
+		// time the main thread may spend placing cells each
+		// frame, where at least one cell is always placed
+		double uploadMilliseconds;
+	};
+
+	// properties for the state of the streaming
+	struct STREAMING_STATS
+	{
+		int residentCells;
+		int queuedCells;
+		int residentEntities;
+		int peakResidentCells;
+		int peakResidentEntities;
+		// totals since the world was opened
+		int loadedCells;
+		int unloadedCells;
+		int failedCells;
+		// time spent placing cells during the last update
+		double uploadMilliseconds;
+	};
+
+private:
+	// the states a cell goes through on the main thread
+	enum CELL_STATE
+	{
+		CELL_UNLOADED,
+		CELL_QUEUED,
+		CELL_RESIDENT,
+		// the cell file could not be read, so it is not tried
+		// again
+		CELL_MISSING
+	};
+
+	// properties for a cell read by a loader thread
+	struct LOADED_CELL
+	{
+		int cell;
+		bool bLoaded;
+		std::vector<CELL_INSTANCE> instances;
+	};
+
+	WORLD_SETTINGS m_settings;
+	// size of the grid and the corner of its first cell
+	int m_columns;
+	int m_rows;
+	float m_cellSize;
+	glm::vec2 m_origin;
+	// prefabs of the scene entities for the world's names
+	std::vector<int> m_prefabs;
+	// state and handles of the placed entities of every cell,
+	// kept by the main thread
+	std::vector<unsigned char> m_cellStates;
+	std::vector<std::vector<uint32_t> > m_cellEntities;
+	// loader threads, the cells waiting for them and the cells
+	// they have finished
+	std::vector<std::thread> m_workers;
+	std::deque<int> m_loadQueue;
+	std::deque<LOADED_CELL> m_loadedCells;
+	int m_loadingCells;
+	std::mutex m_mutex;
+	std::condition_variable m_workReady;
+	std::condition_variable m_cellsReady;
+	bool m_bStopping;
+	STREAMING_STATS m_stats;
+
+	// read queued cells until the streamer is stopped
+	void LoadCells();
+	// place the entities of a finished cell
+	void UploadCell(const LOADED_CELL& loaded, SceneEntities* pEntities);
+	// remove the entities of a resident cell
+	void UnloadCell(int cell, SceneEntities* pEntities);
+	// get the grid distance of a cell from the camera cell
+	int GetCellDistance(int cell, int cameraColumn, int cameraRow) const;
+
+public:
+	// read the world file, find its prefabs in the entities
+	// and start the loader threads
+	bool Open(const WORLD_SETTINGS& settings, const SceneEntities* pEntities);
+	// stop the loader threads and remove every placed cell
+	void Close(SceneEntities* pEntities);
+	// check whether a world is open
+	bool IsOpen() const;
+
+	// queue the cells around the camera, remove those out of
+	// range and place finished cells, optionally waiting for
+	// every queued cell, returning whether the entities changed
+	bool Update(const glm::vec3& cameraPosition, SceneEntities* pEntities, bool bFinishLoads);
+	// get the state of the streaming
+	STREAMING_STATS GetStats();
+
+	// write the world file naming the grid and its prefabs,
+	// creating the directory if needed
+	static bool WriteWorld(const char* directory, int columns, int rows, float cellSize, const std::vector<std::string>& prefabNames);
+	// write the placements of one cell
+	static bool WriteCell(const char* directory, int column, int row, const std::vector<CELL_INSTANCE>& instances);
+	// read the placements of one cell
+	static bool ReadCell(const std::string& filename, int column, int row, std::vector<CELL_INSTANCE>& instances);
+	// get the file name of a cell
+	static std::string GetCellPath(const std::string& directory, int column, int row);
+	// get the center of a cell in a grid centered on the origin
+	static glm::vec3 GetCellCenter(int columns, int rows, float cellSize, int column, int row);
+};